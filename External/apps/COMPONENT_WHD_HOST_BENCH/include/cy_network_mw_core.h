@@ -0,0 +1,46 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Packet pool query used by the msgbuf RX refill path. The host benchmark
+ *  has no network stack, so only the types the driver sources need are kept.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    CY_NETWORK_PACKET_TX,
+    CY_NETWORK_PACKET_RX
+} cy_network_packet_type_t;
+
+typedef struct
+{
+    uint32_t free_packets;
+} cy_network_packet_pool_info_t;
+
+void cy_network_get_packet_pool_info(cy_network_packet_type_t type, cy_network_packet_pool_info_t *info);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
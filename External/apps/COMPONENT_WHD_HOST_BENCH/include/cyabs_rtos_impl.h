@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Single threaded RTOS types used by the host benchmark build.
+ *  The objects only keep enough state for the driver's take/give pairs to be checked.
+ */
+
+#pragma once
+
+#ifdef WHD_RTOS
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+*                 Constants
+******************************************************/
+#define CY_RTOS_MIN_STACK_SIZE      300            /**< Minimum stack size in bytes */
+#define CY_RTOS_ALIGNMENT           0x00000008UL   /**< Minimum alignment for RTOS objects */
+#define CY_RTOS_ALIGNMENT_MASK      0x00000007UL   /**< Mask for checking the alignment of
+                                                        created RTOS objects */
+
+/******************************************************
+*                   Enumerations
+******************************************************/
+
+typedef enum cy_thread_priority
+{
+    CY_RTOS_PRIORITY_MIN         = 0,
+    CY_RTOS_PRIORITY_LOW         = 1,
+    CY_RTOS_PRIORITY_BELOWNORMAL = 2,
+    CY_RTOS_PRIORITY_NORMAL      = 3,
+    CY_RTOS_PRIORITY_ABOVENORMAL = 4,
+    CY_RTOS_PRIORITY_HIGH        = 5,
+    CY_RTOS_PRIORITY_REALTIME    = 6,
+    CY_RTOS_PRIORITY_MAX         = 7
+} cy_thread_priority_t;
+
+/******************************************************
+*                 Type Definitions
+******************************************************/
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t maxcount;
+} cy_semaphore_t;
+
+typedef struct
+{
+    uint32_t lock_count;
+    bool     is_recursive;
+} cy_mutex_t;
+
+typedef void              *cy_queue_t;
+typedef void              *cy_thread_t;
+typedef uint32_t           cy_event_t;
+typedef struct
+{
+    bool running;
+} cy_timer_t;
+typedef uint32_t           cy_timer_callback_arg_t;
+typedef void              *cy_thread_arg_t;
+typedef uint32_t           cy_time_t;
+typedef long               cy_rtos_error_t;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* WHD_RTOS */
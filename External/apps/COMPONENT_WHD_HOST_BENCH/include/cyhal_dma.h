@@ -0,0 +1,28 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  On CAT4 the M2M bus protocol reaches the M2M DMA calls through cyhal_dma.h; the host
+ *  benchmark only has the M2M subset.
+ */
+
+#ifndef INCLUDED_CYHAL_DMA_H_
+#define INCLUDED_CYHAL_DMA_H_
+
+#include "cyhal_m2m.h"
+
+#endif /* INCLUDED_CYHAL_DMA_H_ */
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Subset of the CAT4 M2M DMA HAL referenced by the M2M bus protocol, provided so the host
+ *  benchmark can link it against a simulated DMA engine (whd_bench_m2m.c).
+ */
+
+#ifndef INCLUDED_CYHAL_M2M_H_
+#define INCLUDED_CYHAL_M2M_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+#include "cyhal_hw_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    CYHAL_M2M_NO_INTR             = 0,
+    CYHAL_M2M_TX_CHANNEL_INTERRUPT = 1 << 0,
+    CYHAL_M2M_RX_CHANNEL_INTERRUPT = 1 << 1,
+} cyhal_m2m_event_t;
+
+typedef void (*cyhal_m2m_event_callback_t)(void *callback_arg, cyhal_m2m_event_t event);
+
+cy_rslt_t cyhal_m2m_init(cyhal_m2m_t *obj, uint32_t rx_buffer_size);
+void cyhal_m2m_free(cyhal_m2m_t *obj);
+void cyhal_m2m_register_callback(cyhal_m2m_t *obj, cyhal_m2m_event_callback_t callback, void *callback_arg);
+cy_rslt_t cyhal_m2m_tx_send(cyhal_m2m_t *obj, void *buffer);
+void cyhal_m2m_tx_release(cyhal_m2m_t *obj);
+bool cyhal_m2m_rx_receive(cyhal_m2m_t *obj, void **packet, uint16_t **hwtag);
+bool cyhal_m2m_rx_prepare(cyhal_m2m_t *obj);
+cyhal_m2m_event_t cyhal_m2m_intr_status(cyhal_m2m_t *obj, bool *signal_txdone);
+
+void _cyhal_system_m2m_enable_irq(void);
+void _cyhal_system_m2m_disable_irq(void);
+void _cyhal_system_sw0_enable_irq(void);
+void _cyhal_system_sw0_disable_irq(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_CYHAL_M2M_H_ */
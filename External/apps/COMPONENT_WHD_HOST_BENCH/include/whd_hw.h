@@ -0,0 +1,47 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Subset of the platform WLAN hardware API referenced by the msgbuf sources,
+ *  provided so the host benchmark can link them without the device PDL.
+ */
+
+#ifndef INCLUDED_WHD_HW_H_
+#define INCLUDED_WHD_HW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    WHD_HW_DEVICE_WLAN = 0,
+    WHD_HW_DEVICE_SDIO_AND_WLAN
+} whd_hw_device_t;
+
+void *whd_hw_allocatePermanentApi(uint32_t size);
+bool whd_hw_openDeviceAccessApi(whd_hw_device_t device, void *base, uint32_t size, uint32_t flags);
+uint32_t whd_hw_generateBt2WlDbInterruptApi(uint32_t db_num, uint32_t value);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_HW_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Host port used by the WHD microbenchmarks: a 32-bit addressable heap, a
+ *  packet buffer pool and the bus/thread entry points the protocol sources
+ *  call into.
+ */
+
+#ifndef INCLUDED_WHD_BENCH_H_
+#define INCLUDED_WHD_BENCH_H_
+
+#include <stdint.h>
+#include "whd.h"
+#include "whd_network_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#define WHD_BENCH_HEAP_SIZE          (32 * 1024 * 1024)
+#define WHD_BENCH_NUM_BUFFERS        (512)
+#define WHD_BENCH_BUFFER_SIZE        (WHD_LINK_MTU)
+#define WHD_BENCH_BUFFER_HEADROOM    (64)
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Maps the benchmark heap and fills the packet buffer pool
+ *
+ * The driver still stores pointers in 32-bit fields (physaddr, event
+ * offsets), so the heap is mapped below 4GB on 64-bit hosts.
+ *
+ * @return 0 on success, -1 if the heap could not be mapped
+ */
+int whd_bench_port_init(void);
+
+/** Buffer callbacks handed to the driver through whd_driver->buffer_if */
+extern whd_buffer_funcs_t whd_bench_buffer_funcs;
+
+/** Number of packet buffers currently held by the driver or the benchmark */
+uint32_t whd_bench_buffers_in_use(void);
+
+/** Monotonic time in nanoseconds */
+uint64_t whd_bench_time_ns(void);
+
+/** Makes cy_rtos_time_get() read *clock_ms instead of the host clock, NULL to go back
+ *
+ * Only the stub RTOS honours it, not the pthreads port.
+ */
+void whd_bench_set_clock_ms(const uint32_t *clock_ms);
+
+/** Forces whd_bus_is_flow_controlled() to report the given state */
+void whd_bench_set_flow_controlled(whd_bool_t state);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_BENCH_H_ */
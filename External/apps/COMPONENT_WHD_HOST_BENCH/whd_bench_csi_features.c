@@ -0,0 +1,401 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Checks and times the WLANSense CSI feature extraction
+ *
+ *  Each stage (amplitude, phase, phase sanitisation, decimation and the
+ *  rolling window) is first checked against a fixed-point reference vector.
+ *  Then synthetic reports are run through the engine and the time per report
+ *  and the bytes in and out are printed as one JSON document. See README.md
+ *  for the build line.
+ */
+#if defined(WHD_HOST_BENCH) && defined(WHD_BENCH_CSI_FEATURES)
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "whd_bench.h"
+#include "whd_utils.h"
+#include "whd_wlansense_features.h"
+
+#ifndef COMPONENT_WLANSENSE
+#error "Build with -DCOMPONENT_WLANSENSE"
+#endif /* COMPONENT_WLANSENSE */
+
+#define WHD_BENCH_CSI_PHASE_TOL     (20)
+#define WHD_BENCH_CSI_REPORTS       (64)
+#define WHD_BENCH_CSI_MAX_LEN       (2048)
+#define WHD_BENCH_CSI_MAX_RUNS      (64)
+
+typedef struct
+{
+    int32_t i;
+    int32_t q;
+    uint16_t amp;
+    int16_t phase;          /* round(atan2(q, i) * 32768 / pi) */
+} whd_bench_csi_sample_vector_t;
+
+static const whd_bench_csi_sample_vector_t whd_bench_csi_samples[] =
+{
+    { 3, 4, 5, 9672 },
+    { 5, 12, 13, 12266 },
+    { -5, 12, 13, 20502 },
+    { -32768, -32768, 46340, -24576 },
+    { 32767, 0, 32767, 0 },
+    { 0, 1, 1, 16384 },
+    { -1, 0, 1, -32768 },
+    { 0, -1, 1, -16384 },
+    { -20000, 15000, 25000, 26056 },
+    { 100, -7, 100, -729 },
+    { 1, 1, 1, 8192 },
+    { -1, -1, 1, -24576 },
+    { 0, 0, 0, 0 },
+    { -12, -5, 13, -28650 },
+    { 30000, -1, 30000, 0 },
+};
+
+/* A bent phase and its sanitised form */
+static const int16_t whd_bench_csi_bent_in[] = { 0, 1000, 3000, 3000 };
+static const int16_t whd_bench_csi_bent_out[] = { -250, -250, 750, -250 };
+
+/* Amplitude of every kept subcarrier per report in the window check; the subcarrier index is added */
+static const uint16_t whd_bench_csi_window_amps[] = { 10, 20, 30, 40, 50, 60 };
+
+static uint8_t whd_bench_csi_reports[WHD_BENCH_CSI_REPORTS][WHD_BENCH_CSI_MAX_LEN];
+static whd_csi_features_engine_t whd_bench_csi_engine;
+static uint32_t whd_bench_csi_failures;
+
+static void whd_bench_csi_check(const char *stage, int ok, const char *fmt, long got, long expected)
+{
+    if (!ok)
+    {
+        fprintf(stderr, "%s: ", stage);
+        fprintf(stderr, fmt, got, expected);
+        fprintf(stderr, "\n");
+        whd_bench_csi_failures++;
+    }
+}
+
+static void whd_bench_csi_put16(uint8_t *p, int32_t i, int32_t q)
+{
+    p[0] = (uint8_t)i;
+    p[1] = (uint8_t)( (uint32_t)i >> 8 );
+    p[2] = (uint8_t)q;
+    p[3] = (uint8_t)( (uint32_t)q >> 8 );
+}
+
+/******************************************************
+*             Reference vectors
+******************************************************/
+
+static void whd_bench_csi_check_samples(void)
+{
+    uint32_t n;
+    int16_t phase;
+
+    for (n = 0; n < ARRAY_SIZE(whd_bench_csi_samples); n++)
+    {
+        const whd_bench_csi_sample_vector_t *v = &whd_bench_csi_samples[n];
+
+        whd_bench_csi_check("amplitude", whd_csi_amplitude(v->i, v->q) == v->amp, "got %ld, expected %ld",
+                            whd_csi_amplitude(v->i, v->q), v->amp);
+        phase = whd_csi_phase(v->i, v->q);
+        whd_bench_csi_check("phase", abs( (int16_t)(phase - v->phase) ) <= WHD_BENCH_CSI_PHASE_TOL,
+                            "got %ld, expected %ld", phase, v->phase);
+    }
+}
+
+/* Largest phase error over a sweep of the unit circle, in binary angle units */
+static uint32_t whd_bench_csi_phase_sweep(void)
+{
+    uint32_t max_err = 0;
+    uint32_t step, err;
+    int32_t i, q, expected;
+
+    for (step = 0; step < 65536; step += 7)
+    {
+        i = (int32_t)lround(20000.0 * cos(step * M_PI / 32768.0) );
+        q = (int32_t)lround(20000.0 * sin(step * M_PI / 32768.0) );
+        expected = (int32_t)lround(atan2(q, i) * 32768.0 / M_PI);
+        err = (uint32_t)abs( (int16_t)(whd_csi_phase(i, q) - expected) );
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+    }
+    return max_err;
+}
+
+static void whd_bench_csi_check_sanitize(void)
+{
+    int16_t phase[8];
+    int32_t unwrapped[8];
+    uint32_t k;
+
+    /* Pure offset and slope, wrapping several times over: nothing is left */
+    for (k = 0; k < ARRAY_SIZE(phase); k++)
+    {
+        phase[k] = (int16_t)(20000 + 12000 * (int32_t)k);
+    }
+    whd_csi_phase_sanitize(phase, unwrapped, ARRAY_SIZE(phase) );
+    for (k = 0; k < ARRAY_SIZE(phase); k++)
+    {
+        whd_bench_csi_check("sanitize linear", phase[k] == 0, "got %ld, expected %ld", phase[k], 0);
+    }
+
+    memcpy(phase, whd_bench_csi_bent_in, sizeof(whd_bench_csi_bent_in) );
+    whd_csi_phase_sanitize(phase, unwrapped, ARRAY_SIZE(whd_bench_csi_bent_in) );
+    for (k = 0; k < ARRAY_SIZE(whd_bench_csi_bent_out); k++)
+    {
+        whd_bench_csi_check("sanitize bent", phase[k] == whd_bench_csi_bent_out[k], "got %ld, expected %ld",
+                            phase[k], whd_bench_csi_bent_out[k]);
+    }
+}
+
+/* 8 subcarriers decimated by 2 into a window of 4, a vector every 3 reports. The dropped odd
+ * subcarriers carry a marker that would show up in the means. */
+static void whd_bench_csi_check_window(void)
+{
+    whd_csi_features_config_t config;
+    uint8_t report[4 + 8 * 4];
+    uint32_t r, k, vectors = 0;
+
+    memset(&config, 0, sizeof(config) );
+    config.data_offset = 4;
+    config.num_subcarriers = 8;
+    config.sample_format = WHD_CSI_SAMPLE_INT16;
+    config.decimation = 2;
+    config.window = 4;
+    config.vector_interval = 3;
+    if (whd_csi_features_engine_init(&whd_bench_csi_engine, &config) != WHD_SUCCESS)
+    {
+        whd_bench_csi_check("window", 0, "init failed %ld %ld", 0, 0);
+        return;
+    }
+
+    for (r = 0; r < ARRAY_SIZE(whd_bench_csi_window_amps); r++)
+    {
+        memset(report, 0xEE, 4);
+        for (k = 0; k < 8; k++)
+        {
+            whd_bench_csi_put16(&report[4 + k * 4], (k & 1) ? 7777 : whd_bench_csi_window_amps[r] + k / 2, 0);
+        }
+        if (whd_csi_features_engine_process(&whd_bench_csi_engine, NULL, (uint8_t)r, report,
+                                            sizeof(report) ) == WHD_FALSE)
+        {
+            continue;
+        }
+        vectors++;
+        whd_bench_csi_check("decimation", whd_bench_csi_engine.vector.num_subcarriers == 4,
+                            "got %ld subcarriers, expected %ld", whd_bench_csi_engine.vector.num_subcarriers, 4);
+        for (k = 0; k < 4; k++)
+        {
+            /* After 3 reports: 10, 20, 30, mean 20, variance 66; after 6 the window holds 30 to 60,
+             * mean 45, variance 125 */
+            long mean = (r == 2) ? 20 + (long)k : 45 + (long)k;
+            long var = (r == 2) ? 66 : 125;
+
+            whd_bench_csi_check("window mean", whd_bench_csi_engine.vector.amp_mean[k] == mean,
+                                "got %ld, expected %ld", whd_bench_csi_engine.vector.amp_mean[k], mean);
+            whd_bench_csi_check("window variance", whd_bench_csi_engine.vector.amp_var[k] == (uint32_t)var,
+                                "got %ld, expected %ld", (long)whd_bench_csi_engine.vector.amp_var[k], var);
+            whd_bench_csi_check("window phase", whd_bench_csi_engine.vector.phase[k] == 0,
+                                "got %ld, expected %ld", whd_bench_csi_engine.vector.phase[k], 0);
+        }
+    }
+    whd_bench_csi_check("window", vectors == 2, "got %ld vectors, expected %ld", (long)vectors, 2);
+
+    /* 8 bit samples */
+    config.data_offset = 0;
+    config.num_subcarriers = 0;
+    config.sample_format = WHD_CSI_SAMPLE_INT8;
+    config.decimation = 1;
+    config.window = 1;
+    config.vector_interval = 1;
+    report[0] = 3;
+    report[1] = 4;
+    report[2] = (uint8_t)-5;
+    report[3] = (uint8_t)-12;
+    (void)whd_csi_features_engine_init(&whd_bench_csi_engine, &config);
+    if (whd_csi_features_engine_process(&whd_bench_csi_engine, NULL, 0, report, 4) == WHD_TRUE)
+    {
+        whd_bench_csi_check("int8", whd_bench_csi_engine.vector.amp_mean[0] == 5, "got %ld, expected %ld",
+                            whd_bench_csi_engine.vector.amp_mean[0], 5);
+        whd_bench_csi_check("int8", whd_bench_csi_engine.vector.amp_mean[1] == 13, "got %ld, expected %ld",
+                            whd_bench_csi_engine.vector.amp_mean[1], 13);
+    }
+    else
+    {
+        whd_bench_csi_check("int8", 0, "no vector %ld %ld", 0, 0);
+    }
+}
+
+/******************************************************
+*             Throughput
+******************************************************/
+
+/* A slowly moving multipath channel with some noise, so the windows see real variance */
+static void whd_bench_csi_fill(uint32_t num_subcarriers, uint32_t data_offset)
+{
+    uint32_t seed = 12345;
+    uint32_t r, k;
+    double amp, phase;
+
+    for (r = 0; r < WHD_BENCH_CSI_REPORTS; r++)
+    {
+        memset(whd_bench_csi_reports[r], 0, data_offset);
+        for (k = 0; k < num_subcarriers; k++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            amp = 4000.0 + 1500.0 * sin(k * 0.11 + r * 0.3) + (double)( (seed >> 16) & 0xFF );
+            phase = 0.05 * k + 0.7 * sin(k * 0.05) + r * 0.9;
+            whd_bench_csi_put16(&whd_bench_csi_reports[r][data_offset + k * 4], (int32_t)(amp * cos(phase) ),
+                                (int32_t)(amp * sin(phase) ) );
+        }
+    }
+}
+
+static int whd_bench_csi_compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void whd_bench_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-s subcarriers] [-d decimation] [-w window] [-i vector_interval] [-n reports] "
+            "[-r runs]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    whd_csi_features_config_t config;
+    whd_csi_features_stats_t stats;
+    double samples[WHD_BENCH_CSI_MAX_RUNS];
+    uint32_t num_subcarriers = 256, iterations = 100000, runs = 7;
+    uint32_t data_offset = 16;
+    uint32_t i, run, len, max_err;
+    uint64_t start;
+
+    memset(&config, 0, sizeof(config) );
+    config.decimation = 4;
+    config.window = 8;
+    config.vector_interval = 8;
+    for (i = 1; i < (uint32_t)argc; i++)
+    {
+        if ( (argv[i][0] != '-') || (i + 1 >= (uint32_t)argc) )
+        {
+            whd_bench_usage(argv[0]);
+            return 2;
+        }
+        switch (argv[i][1])
+        {
+            case 's':
+                num_subcarriers = (uint32_t)strtoul(argv[++i], NULL, 0);
+                break;
+            case 'd':
+                config.decimation = (uint8_t)strtoul(argv[++i], NULL, 0);
+                break;
+            case 'w':
+                config.window = (uint8_t)strtoul(argv[++i], NULL, 0);
+                break;
+            case 'i':
+                config.vector_interval = (uint8_t)strtoul(argv[++i], NULL, 0);
+                break;
+            case 'n':
+                iterations = (uint32_t)strtoul(argv[++i], NULL, 0);
+                break;
+            case 'r':
+                runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+                break;
+            default:
+                whd_bench_usage(argv[0]);
+                return 2;
+        }
+    }
+    len = data_offset + num_subcarriers * 4;
+    if ( (len > WHD_BENCH_CSI_MAX_LEN) || (num_subcarriers == 0) || (iterations == 0) || (runs == 0) ||
+         (runs > WHD_BENCH_CSI_MAX_RUNS) )
+    {
+        whd_bench_usage(argv[0]);
+        return 2;
+    }
+
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+
+    whd_bench_csi_check_samples();
+    max_err = whd_bench_csi_phase_sweep();
+    whd_bench_csi_check("phase sweep", max_err <= WHD_BENCH_CSI_PHASE_TOL, "max error %ld, allowed %ld",
+                        (long)max_err, WHD_BENCH_CSI_PHASE_TOL);
+    whd_bench_csi_check_sanitize();
+    whd_bench_csi_check_window();
+
+    config.data_offset = (uint16_t)data_offset;
+    config.num_subcarriers = (uint16_t)num_subcarriers;
+    config.sample_format = WHD_CSI_SAMPLE_INT16;
+    if (whd_csi_features_engine_init(&whd_bench_csi_engine, &config) != WHD_SUCCESS)
+    {
+        fprintf(stderr, "engine rejected the configuration\n");
+        return 1;
+    }
+    whd_bench_csi_fill(num_subcarriers, data_offset);
+
+    /* Warm caches and branch predictors before the measured runs */
+    for (i = 0; i < iterations / 10 + 1; i++)
+    {
+        (void)whd_csi_features_engine_process(&whd_bench_csi_engine, NULL, (uint8_t)i,
+                                              whd_bench_csi_reports[i % WHD_BENCH_CSI_REPORTS], len);
+    }
+    memset(&whd_bench_csi_engine.stats, 0, sizeof(whd_bench_csi_engine.stats) );
+    for (run = 0; run < runs; run++)
+    {
+        start = whd_bench_time_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            (void)whd_csi_features_engine_process(&whd_bench_csi_engine, NULL, (uint8_t)i,
+                                                  whd_bench_csi_reports[i % WHD_BENCH_CSI_REPORTS], len);
+        }
+        samples[run] = (double)(whd_bench_time_ns() - start) / (double)iterations;
+    }
+    qsort(samples, runs, sizeof(samples[0]), whd_bench_csi_compare_double);
+    stats = whd_bench_csi_engine.stats;
+
+    printf("{\n  \"suite\": \"whd_csi_features\",\n  \"status\": \"%s\",\n  \"check_failures\": %u,\n",
+           (whd_bench_csi_failures == 0) ? "ok" : "failed", (unsigned)whd_bench_csi_failures);
+    printf("  \"phase_max_error\": %u,\n  \"subcarriers\": %u,\n  \"kept_subcarriers\": %u,\n",
+           (unsigned)max_err, (unsigned)num_subcarriers, (unsigned)whd_bench_csi_engine.kept);
+    printf("  \"decimation\": %u,\n  \"window\": %u,\n  \"vector_interval\": %u,\n  \"reports\": %u,\n",
+           (unsigned)whd_bench_csi_engine.config.decimation, (unsigned)whd_bench_csi_engine.config.window,
+           (unsigned)whd_bench_csi_engine.config.vector_interval, (unsigned)stats.reports);
+    printf("  \"vectors\": %u,\n  \"bytes_in\": %u,\n  \"bytes_out\": %u,\n  \"reduction\": %.1f,\n",
+           (unsigned)stats.vectors, (unsigned)stats.bytes_in, (unsigned)stats.bytes_out,
+           (stats.bytes_out > 0) ? (double)stats.bytes_in / (double)stats.bytes_out : 0.0);
+    printf("  \"ns_per_report_min\": %.1f,\n  \"ns_per_report_median\": %.1f,\n  \"ns_per_report_max\": %.1f\n}\n",
+           samples[0], samples[runs / 2], samples[runs - 1]);
+
+    return (whd_bench_csi_failures == 0) ? 0 : 1;
+}
+
+#endif /* WHD_HOST_BENCH && WHD_BENCH_CSI_FEATURES */
@@ -0,0 +1,517 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Runs the M2M bus protocol against a simulated M2M DMA engine
+ *
+ *  The cyhal_m2m calls are answered by an RX ring that the simulated WLAN core fills with frames
+ *  while it has buffers posted, and by a TX-done indication the scenarios raise. A receive loop
+ *  shaped like the WHD thread's calls the bus through its function table. Each scenario checks
+ *  the frames, refills and TX-done writes it expects and the results are printed as one JSON
+ *  document. See README.md for the build line.
+ */
+#if defined(WHD_HOST_BENCH) && defined(WHD_BENCH_M2M)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "whd_bench.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_wifi_api.h"
+#include "whd_buffer_api.h"
+#include "whd_chip.h"
+#include "whd_chip_constants.h"
+#include "whd_resource_if.h"
+#include "whd_sdpcm.h"
+#include "whd_thread.h"
+#include "bus_protocols/whd_bus.h"
+#include "bus_protocols/whd_bus_common.h"
+#include "bus_protocols/whd_bus_m2m_protocol.h"
+#include "bus_protocols/whd_bus_protocol_interface.h"
+#include "cyhal_m2m.h"
+
+#if (CYBSP_WIFI_INTERFACE_TYPE != CYBSP_M2M_INTERFACE)
+#error "Build with -DCYBSP_WIFI_INTERFACE_TYPE=CYBSP_M2M_INTERFACE"
+#endif
+
+/* Must match the protocol's batch, 8 unless overridden on the build line */
+#ifndef WHD_BUS_M2M_RX_BATCH
+#define WHD_BUS_M2M_RX_BATCH         (8)
+#endif
+
+#define WHD_BENCH_M2M_RING_SIZE     (2 * WHD_BUS_M2M_RX_BATCH)
+#define WHD_BENCH_M2M_FRAME_SIZE    (128)
+#define WHD_BENCH_M2M_MAX_ROUNDS    (64)
+#define WHD_BENCH_M2M_PMU_BASE      (0x18012000)
+
+/* The simulated DMA engine */
+typedef struct
+{
+    uint32_t posted;            /* RX descriptors holding a buffer */
+    uint32_t landed;            /* Frames received into them and not yet taken off the ring */
+    uint32_t queued;            /* Frames the WLAN core still has to send */
+    uint32_t prepare_fails;     /* Refills still to be failed */
+    bool txdone;                /* TX done indication not yet read */
+    bool irq;                   /* Interrupt raised and not yet serviced */
+
+    uint32_t intr_reads;
+    uint32_t prepares;
+    uint32_t prepare_failed;
+    uint32_t credits;
+    uint32_t txdone_writes;
+} whd_bench_m2m_dma_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t rounds;
+    uint32_t frames;
+    uint32_t expected_frames;
+    uint32_t intr_reads;
+    uint32_t prepares;
+    uint32_t expected_prepares;
+    uint32_t prepare_failed;
+    uint32_t txdone_writes;
+    uint32_t expected_txdone_writes;
+    int pass;
+} whd_bench_m2m_result_t;
+
+static whd_bench_m2m_dma_t whd_bench_m2m_dma;
+static uint16_t whd_bench_m2m_hwtag[2];
+
+/******************************************************
+*             Simulated M2M DMA engine
+******************************************************/
+
+/* The WLAN core sends what it has queued into the buffers posted on the RX ring */
+static void whd_bench_m2m_device_step(void)
+{
+    whd_bench_m2m_dma_t *dma = &whd_bench_m2m_dma;
+    uint32_t n = (dma->queued < dma->posted) ? dma->queued : dma->posted;
+
+    if (n != 0)
+    {
+        dma->queued -= n;
+        dma->posted -= n;
+        dma->landed += n;
+        dma->irq = true;
+    }
+}
+
+cy_rslt_t cyhal_m2m_init(cyhal_m2m_t *obj, uint32_t rx_buffer_size)
+{
+    (void)obj;
+    (void)rx_buffer_size;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_m2m_free(cyhal_m2m_t *obj)
+{
+    (void)obj;
+}
+
+void cyhal_m2m_register_callback(cyhal_m2m_t *obj, cyhal_m2m_event_callback_t callback, void *callback_arg)
+{
+    (void)obj;
+    (void)callback;
+    (void)callback_arg;
+}
+
+cy_rslt_t cyhal_m2m_tx_send(cyhal_m2m_t *obj, void *buffer)
+{
+    (void)obj;
+    (void)buffer;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_m2m_tx_release(cyhal_m2m_t *obj)
+{
+    (void)obj;
+}
+
+bool cyhal_m2m_rx_receive(cyhal_m2m_t *obj, void **packet, uint16_t **hwtag)
+{
+    whd_buffer_t buffer;
+
+    (void)obj;
+    if ( (whd_bench_m2m_dma.landed == 0) ||
+         (whd_bench_buffer_funcs.whd_host_buffer_get(&buffer, WHD_NETWORK_RX, WHD_BENCH_M2M_FRAME_SIZE,
+                                                     0) != WHD_SUCCESS) )
+    {
+        return false;
+    }
+    whd_bench_m2m_dma.landed--;
+
+    /* The engine hands the frame over past its buffer header, which read_frame puts back */
+    whd_bench_buffer_funcs.whd_buffer_add_remove_at_front(&buffer, (int32_t)sizeof(whd_buffer_header_t) );
+    *packet = buffer;
+    *hwtag = whd_bench_m2m_hwtag;
+    return true;
+}
+
+bool cyhal_m2m_rx_prepare(cyhal_m2m_t *obj)
+{
+    (void)obj;
+    whd_bench_m2m_dma.prepares++;
+    if (whd_bench_m2m_dma.prepare_fails != 0)
+    {
+        whd_bench_m2m_dma.prepare_fails--;
+        whd_bench_m2m_dma.prepare_failed++;
+        return false;
+    }
+    whd_bench_m2m_dma.posted = WHD_BENCH_M2M_RING_SIZE - whd_bench_m2m_dma.landed;
+    return true;
+}
+
+cyhal_m2m_event_t cyhal_m2m_intr_status(cyhal_m2m_t *obj, bool *signal_txdone)
+{
+    cyhal_m2m_event_t event = CYHAL_M2M_NO_INTR;
+
+    (void)obj;
+    whd_bench_m2m_dma.intr_reads++;
+    *signal_txdone = whd_bench_m2m_dma.txdone;
+    if (whd_bench_m2m_dma.txdone)
+    {
+        event = CYHAL_M2M_TX_CHANNEL_INTERRUPT;
+        whd_bench_m2m_dma.txdone = false;
+    }
+    return event;
+}
+
+void _cyhal_system_m2m_enable_irq(void)
+{
+}
+
+void _cyhal_system_m2m_disable_irq(void)
+{
+}
+
+void _cyhal_system_sw0_enable_irq(void)
+{
+}
+
+void _cyhal_system_sw0_disable_irq(void)
+{
+}
+
+/******************************************************
+*             Driver hooks outside the bus protocol
+******************************************************/
+
+uint32_t get_whd_var(whd_driver_t whd_driver, chip_var_t var)
+{
+    (void)whd_driver;
+    return (var == PMU_BASE_ADDRESS) ? WHD_BENCH_M2M_PMU_BASE : 0;
+}
+
+whd_result_t whd_bus_write_backplane_value(whd_driver_t whd_driver, uint32_t address, uint8_t register_length,
+                                           uint32_t value)
+{
+    (void)whd_driver;
+    (void)register_length;
+    (void)value;
+
+    /* The only backplane write outside boot is the TX done software interrupt */
+    if (address == WHD_BENCH_M2M_PMU_BASE + 0x1c)
+    {
+        whd_bench_m2m_dma.txdone_writes++;
+    }
+    return WHD_SUCCESS;
+}
+
+void whd_sdpcm_update_credit(whd_driver_t whd_driver, uint8_t *data)
+{
+    (void)whd_driver;
+    (void)data;
+    whd_bench_m2m_dma.credits++;
+}
+
+void whd_thread_notify_irq(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+}
+
+void whd_delayed_bus_release_schedule_update(whd_driver_t whd_driver, whd_bool_t is_scheduled)
+{
+    (void)whd_driver;
+    (void)is_scheduled;
+}
+
+uint32_t whd_chip_set_chip_id(whd_driver_t whd_driver, uint16_t id)
+{
+    (void)whd_driver;
+    (void)id;
+    return WHD_SUCCESS;
+}
+
+/* Boot and teardown are not simulated */
+whd_result_t whd_allow_wlan_bus_to_sleep(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+    return WHD_UNSUPPORTED;
+}
+
+void whd_bus_set_resource_download_halt(whd_driver_t whd_driver, whd_bool_t halt)
+{
+    (void)whd_driver;
+    (void)halt;
+}
+
+whd_result_t whd_bus_write_wifi_firmware_image(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+    return WHD_UNSUPPORTED;
+}
+
+whd_result_t whd_disable_device_core(whd_driver_t whd_driver, device_core_t core_id, wlan_core_flag_t core_flag)
+{
+    (void)whd_driver;
+    (void)core_id;
+    (void)core_flag;
+    return WHD_UNSUPPORTED;
+}
+
+whd_result_t whd_reset_device_core(whd_driver_t whd_driver, device_core_t core_id, wlan_core_flag_t core_flag)
+{
+    (void)whd_driver;
+    (void)core_id;
+    (void)core_flag;
+    return WHD_UNSUPPORTED;
+}
+
+whd_result_t whd_wlan_armcore_run(whd_driver_t whd_driver, device_core_t core_id, wlan_core_flag_t core_flag)
+{
+    (void)whd_driver;
+    (void)core_id;
+    (void)core_flag;
+    return WHD_UNSUPPORTED;
+}
+
+uint32_t whd_resource_read(whd_driver_t whd_driver, whd_resource_type_t type, uint32_t offset, uint32_t size,
+                           uint32_t *size_out, void *buffer)
+{
+    (void)whd_driver;
+    (void)type;
+    (void)offset;
+    (void)size;
+    (void)buffer;
+    *size_out = 0;
+    return WHD_UNSUPPORTED;
+}
+
+uint32_t whd_resource_size(whd_driver_t whd_driver, whd_resource_type_t resource, uint32_t *size_out)
+{
+    (void)whd_driver;
+    (void)resource;
+    *size_out = 0;
+    return WHD_UNSUPPORTED;
+}
+
+/******************************************************
+*             Receive loop
+******************************************************/
+
+/* One pass of the WHD thread loop: receive while woken or past the bound, then sleep */
+static uint32_t whd_bench_m2m_round(whd_driver_t whd_driver, uint32_t rx_bound, int *rx_over_bound)
+{
+    whd_bus_info_t *bus_if = whd_driver->bus_if;
+    cy_semaphore_t transceive_semaphore;
+    whd_buffer_t buffer;
+    uint32_t status, rx_cnt = 0, frames = 0;
+
+    whd_bench_m2m_device_step();
+    if (whd_bench_m2m_dma.irq || *rx_over_bound)
+    {
+        whd_bench_m2m_dma.irq = false;
+        status = bus_if->whd_bus_packet_available_to_read_fptr(whd_driver);
+        if ( ( (status != 0) && (status != WHD_BUS_FAIL) ) || *rx_over_bound )
+        {
+            *rx_over_bound = 0;
+            do
+            {
+                rx_cnt++;
+                if (bus_if->whd_bus_read_frame_fptr(whd_driver, &buffer) != WHD_SUCCESS)
+                {
+                    break;
+                }
+                frames++;
+                whd_bench_buffer_funcs.whd_buffer_release(buffer, WHD_NETWORK_RX);
+            } while (rx_cnt < rx_bound);
+        }
+    }
+    if (rx_cnt >= rx_bound)
+    {
+        *rx_over_bound = 1;
+        return frames;
+    }
+
+    /* Nothing gives the semaphore, so the sleep returns at once */
+    cy_rtos_semaphore_init(&transceive_semaphore, 1, 0);
+    bus_if->whd_bus_wait_for_wlan_event_fptr(whd_driver, &transceive_semaphore);
+    return frames;
+}
+
+/* Runs rounds until the device has sent everything and a round finds nothing left */
+static void whd_bench_m2m_run(whd_driver_t whd_driver, uint32_t rx_bound, whd_bench_m2m_result_t *result)
+{
+    int rx_over_bound = 0;
+    uint32_t frames;
+
+    while (result->rounds < WHD_BENCH_M2M_MAX_ROUNDS)
+    {
+        frames = whd_bench_m2m_round(whd_driver, rx_bound, &rx_over_bound);
+        result->rounds++;
+        result->frames += frames;
+        if ( (frames == 0) && !rx_over_bound && (whd_bench_m2m_dma.queued == 0) &&
+             (whd_bench_m2m_dma.landed == 0) )
+        {
+            break;
+        }
+    }
+}
+
+static void whd_bench_m2m_start(whd_driver_t whd_driver, cyhal_m2m_t *m2m_obj, const char *name,
+                                whd_bench_m2m_result_t *result)
+{
+    whd_m2m_config_t config;
+
+    memset(&config, 0, sizeof(config) );
+    memset(&whd_bench_m2m_dma, 0, sizeof(whd_bench_m2m_dma) );
+    memset(result, 0, sizeof(*result) );
+    result->name = name;
+
+    whd_bus_m2m_attach(whd_driver, &config, m2m_obj);
+    /* Stands in for the priming refill at init, which follows the boot that is not simulated */
+    whd_bench_m2m_dma.posted = WHD_BENCH_M2M_RING_SIZE;
+}
+
+static void whd_bench_m2m_finish(whd_driver_t whd_driver, whd_bench_m2m_result_t *result)
+{
+    result->intr_reads = whd_bench_m2m_dma.intr_reads;
+    result->prepares = whd_bench_m2m_dma.prepares;
+    result->prepare_failed = whd_bench_m2m_dma.prepare_failed;
+    result->txdone_writes = whd_bench_m2m_dma.txdone_writes;
+    result->pass = (result->frames == result->expected_frames) &&
+                   (result->prepares == result->expected_prepares) &&
+                   (result->txdone_writes == result->expected_txdone_writes) &&
+                   (whd_bench_m2m_dma.credits == result->frames) && (whd_bench_buffers_in_use() == 0);
+    whd_bus_m2m_detach(whd_driver);
+}
+
+/******************************************************
+*             Scenarios
+******************************************************/
+
+/* 20 queued frames under a 12 frame RX bound: drains of 8, 8 and 4, each followed by one refill */
+static void whd_bench_m2m_rx_batch(whd_driver_t whd_driver, cyhal_m2m_t *m2m_obj, whd_bench_m2m_result_t *result)
+{
+    whd_bench_m2m_start(whd_driver, m2m_obj, "rx_batch", result);
+    whd_bench_m2m_dma.queued = 20;
+    result->expected_frames = 20;
+    result->expected_prepares = 3;
+    whd_bench_m2m_run(whd_driver, 12, result);
+    whd_bench_m2m_finish(whd_driver, result);
+}
+
+/* A TX done in each of two rounds is written to the WLAN core once per round */
+static void whd_bench_m2m_txdone(whd_driver_t whd_driver, cyhal_m2m_t *m2m_obj, whd_bench_m2m_result_t *result)
+{
+    uint32_t i;
+
+    whd_bench_m2m_start(whd_driver, m2m_obj, "txdone", result);
+    result->expected_frames = 8;
+    result->expected_prepares = 2;
+    result->expected_txdone_writes = 2;
+    for (i = 0; i < 2; i++)
+    {
+        whd_bench_m2m_dma.queued = 4;
+        whd_bench_m2m_dma.txdone = true;
+        whd_bench_m2m_run(whd_driver, WHD_THREAD_RX_BOUND, result);
+    }
+    whd_bench_m2m_finish(whd_driver, result);
+}
+
+/* The ring is emptied and its refills fail five times, so the next frames can only land once the
+ * sleeping thread has retried the refill. The refills after the two drains of the first ring, the
+ * one after the empty drain and the one before the first sleep fail; the second sleep's fails too
+ * and the third's posts the buffers. The second ring's two drains are refilled. */
+static void whd_bench_m2m_refill_retry(whd_driver_t whd_driver, cyhal_m2m_t *m2m_obj,
+                                       whd_bench_m2m_result_t *result)
+{
+    whd_bench_m2m_start(whd_driver, m2m_obj, "refill_retry", result);
+    whd_bench_m2m_dma.queued = 2 * WHD_BENCH_M2M_RING_SIZE;
+    whd_bench_m2m_dma.prepare_fails = 5;
+    result->expected_frames = 2 * WHD_BENCH_M2M_RING_SIZE;
+    result->expected_prepares = 8;
+    whd_bench_m2m_run(whd_driver, WHD_THREAD_RX_BOUND, result);
+    whd_bench_m2m_finish(whd_driver, result);
+}
+
+int main(int argc, char *argv[])
+{
+    struct whd_driver *whd_driver;
+    cyhal_m2m_t m2m_obj;
+    whd_bench_m2m_result_t results[3];
+    uint32_t i;
+    int failed = 0;
+
+    if (argc > 1)
+    {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 2;
+    }
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+    whd_driver = whd_mem_calloc(1, sizeof(*whd_driver) );
+    if (whd_driver == NULL)
+    {
+        return 1;
+    }
+    whd_driver->buffer_if = &whd_bench_buffer_funcs;
+    memset(&m2m_obj, 0, sizeof(m2m_obj) );
+
+    whd_bench_m2m_rx_batch(whd_driver, &m2m_obj, &results[0]);
+    whd_bench_m2m_txdone(whd_driver, &m2m_obj, &results[1]);
+    whd_bench_m2m_refill_retry(whd_driver, &m2m_obj, &results[2]);
+
+    printf("{\n  \"suite\": \"whd_bus_m2m\",\n  \"rx_batch\": %u,\n  \"ring_size\": %u,\n  \"scenarios\": [\n",
+           (unsigned)WHD_BUS_M2M_RX_BATCH, (unsigned)WHD_BENCH_M2M_RING_SIZE);
+    for (i = 0; i < ARRAY_SIZE(results); i++)
+    {
+        printf("    { \"name\": \"%s\", \"pass\": %s, \"rounds\": %u, \"frames\": %u, \"intr_reads\": %u, "
+               "\"refills\": %u, \"refill_failed\": %u, \"txdone_writes\": %u }%s\n",
+               results[i].name, results[i].pass ? "true" : "false", (unsigned)results[i].rounds,
+               (unsigned)results[i].frames, (unsigned)results[i].intr_reads, (unsigned)results[i].prepares,
+               (unsigned)results[i].prepare_failed, (unsigned)results[i].txdone_writes,
+               (i + 1 < ARRAY_SIZE(results) ) ? "," : "");
+        if (!results[i].pass)
+        {
+            failed = 1;
+        }
+    }
+    printf("  ]\n}\n");
+
+    return failed;
+}
+
+#endif /* WHD_HOST_BENCH && WHD_BENCH_M2M */
@@ -0,0 +1,1110 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Microbenchmarks for the WHD per-packet data structures
+ *
+ *  Runs each case against the real protocol sources and prints one JSON
+ *  document with the per-operation cost, so results can be diffed between
+ *  builds. See README.md for how to build the SDPCM and msgbuf variants.
+ */
+#ifdef WHD_HOST_BENCH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "whd_bench.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_endian.h"
+#include "whd_buffer_api.h"
+#include "whd_proto.h"
+#ifndef PROTO_MSGBUF
+#include "whd_sdpcm.h"
+#include "whd_cdc_bdc.h"
+#else
+#include "whd_msgbuf.h"
+#include "whd_flowring.h"
+#include "whd_commonring.h"
+#include "whd_ring.h"
+#endif /* PROTO_MSGBUF */
+
+/******************************************************
+*                    Constants
+******************************************************/
+#define WHD_BENCH_DEFAULT_ITERATIONS    (200000)
+#define WHD_BENCH_DEFAULT_RUNS          (7)
+#define WHD_BENCH_MAX_RUNS              (31)
+
+#define WHD_BENCH_SDPCM_BATCH           (32)
+#define WHD_BENCH_SDPCM_PAYLOAD         (1500)
+#define WHD_BENCH_EVENT_DATA_LEN        (256)
+#define WHD_BENCH_FLOWRING_COUNT        (8)
+#define WHD_BENCH_PKTID_ENTRIES         (256)
+#define WHD_BENCH_RING_DEPTH            (256)
+#define WHD_BENCH_RING_ITEM_LEN         (48)
+#define WHD_BENCH_RING_BATCH            (32)
+#define WHD_BENCH_RING_TXFLOW_BATCH     (128)
+
+#define WHD_BENCH_ETHER_TYPE_BRCM       (0x886C)
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct whd_bench_ctx
+{
+    struct whd_driver *whd_driver;
+    struct whd_interface *ifp;
+    uint8_t ies[512];
+    uint32_t ies_len;
+#ifndef PROTO_MSGBUF
+    struct whd_proto proto;
+    whd_cdc_bdc_info_t cdc_bdc_info;
+    uint8_t event_packet[sizeof(bdc_header_t) + sizeof(whd_event_t) + WHD_BENCH_EVENT_DATA_LEN];
+    uint32_t event_hits;
+    whd_buffer_t tx_batch[WHD_BENCH_SDPCM_BATCH];
+#else
+    struct whd_flowring *flow;
+    uint8_t macs[WHD_BENCH_FLOWRING_COUNT][ETHER_ADDR_LEN];
+    struct whd_msgbuf_pktids *pktids;
+    whd_buffer_t pktid_buffer;
+    struct whd_commonring ring;
+    uint8_t *ring_buf;
+    uint32_t ring_bells;
+    struct whd_ring_idx_block idx_block;
+    uint8_t *idx_buf;
+    struct whd_ringbuf idx_rings[2];    /* An H2D ring and a D2H ring with their indices in idx_block */
+    uint8_t *idx_ring_bufs[2];
+    uint32_t idx_host_seq;              /* Next item the host submits */
+    uint32_t idx_dev_seq;               /* Next item the device expects */
+    uint32_t idx_done_seq;              /* Next completion the host expects */
+#endif /* PROTO_MSGBUF */
+    volatile uintptr_t sink;
+} whd_bench_ctx_t;
+
+/** One benchmark case
+ *
+ * run() performs the measured work and returns the number of operations it
+ * completed. setup() and teardown() are not timed.
+ */
+typedef struct
+{
+    const char *name;
+    const char *description;
+    int (*setup)(whd_bench_ctx_t *ctx);
+    uint32_t (*run)(whd_bench_ctx_t *ctx, uint32_t iterations);
+    void (*teardown)(whd_bench_ctx_t *ctx);
+} whd_bench_case_t;
+
+typedef struct
+{
+    uint64_t ops;
+    double ns_per_op_min;
+    double ns_per_op_median;
+    double ns_per_op_max;
+    int status;
+    int32_t buffers_leaked;
+} whd_bench_result_t;
+
+/******************************************************
+*             Common cases
+******************************************************/
+
+/* A typical AP beacon body: RSNX is last, so lookups walk every element */
+static void whd_bench_build_ies(whd_bench_ctx_t *ctx)
+{
+    static const uint8_t ies[] =
+    {
+        DOT11_IE_ID_SSID, 8, 'w', 'h', 'd', '-', 'b', 'e', 'n', 'c',
+        DOT11_IE_ID_SUPPORTED_RATES, 8, 0x82, 0x84, 0x8b, 0x96, 0x0c, 0x12, 0x18, 0x24,
+        DOT11_IE_ID_DSSS_PARAMETER_SET, 1, 6,
+        DOT11_IE_ID_TIM, 4, 0, 1, 0, 0,
+        DOT11_IE_ID_COUNTRY, 6, 'U', 'S', ' ', 1, 11, 30,
+        DOT11_IE_ID_EXTENDED_SUPPORTED_RATES, 4, 0x30, 0x48, 0x60, 0x6c,
+        DOT11_IE_ID_HT_CAPABILITIES, 26, 0xef, 0x01, 0x1b, 0xff, 0xff, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0,
+        DOT11_IE_ID_HT_OPERATION, 22, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        DOT11_IE_ID_RSN, 20, 1, 0, 0x00, 0x0f, 0xac, 4, 1, 0, 0x00, 0x0f, 0xac, 4, 1, 0, 0x00, 0x0f, 0xac, 8, 0xc0, 0,
+        DOT11_IE_ID_EXTENDED_CAPABILITIES, 8, 0x04, 0, 0, 0x02, 0, 0, 0, 0x40,
+        DOT11_IE_ID_VENDOR_SPECIFIC, 24, 0x00, 0x50, 0xf2, 2, 1, 1, 0, 0, 3, 0xa4, 0, 0, 0x27, 0xa4, 0, 0,
+        0x42, 0x43, 0x5e, 0, 0x62, 0x32, 0x2f, 0,
+        DOT11_IE_ID_VENDOR_SPECIFIC, 7, 0x00, 0x10, 0x18, 2, 0, 0x1c, 0,
+        DOT11_IE_ID_MOBILITY_DOMAIN, 3, 0x34, 0x12, 0x01,
+        DOT11_IE_ID_RSNX, 1, 0x20,
+    };
+
+    memcpy(ctx->ies, ies, sizeof(ies) );
+    ctx->ies_len = sizeof(ies);
+}
+
+static int whd_bench_tlv_setup(whd_bench_ctx_t *ctx)
+{
+    whd_bench_build_ies(ctx);
+    return 0;
+}
+
+static uint32_t whd_bench_tlv_find_last(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        ctx->sink += (uintptr_t)whd_parse_tlvs( (const whd_tlv8_header_t *)ctx->ies, ctx->ies_len,
+                                                DOT11_IE_ID_RSNX );
+    }
+    return iterations;
+}
+
+static uint32_t whd_bench_tlv_find_missing(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        ctx->sink += (uintptr_t)whd_parse_tlvs( (const whd_tlv8_header_t *)ctx->ies, ctx->ies_len,
+                                                DOT11_IE_ID_BSS_LOAD );
+    }
+    return iterations;
+}
+
+#ifndef PROTO_MSGBUF
+/******************************************************
+*             SDPCM / BCDC cases
+******************************************************/
+
+static int whd_bench_sdpcm_setup(whd_bench_ctx_t *ctx)
+{
+    uint32_t i;
+
+    if (whd_sdpcm_init(ctx->whd_driver) != WHD_SUCCESS)
+    {
+        return -1;
+    }
+    for (i = 0; i < WHD_BENCH_SDPCM_BATCH; i++)
+    {
+        if (whd_host_buffer_get(ctx->whd_driver, &ctx->tx_batch[i], WHD_NETWORK_TX,
+                                (uint16_t)(WHD_BENCH_SDPCM_PAYLOAD + sizeof(whd_buffer_header_t) ), 0) != WHD_SUCCESS)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Each operation is one whd_send_to_bus() plus the matching whd_sdpcm_get_packet_to_send() */
+static uint32_t whd_bench_sdpcm_run(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    whd_sdpcm_info_t *sdpcm_info = &ctx->whd_driver->sdpcm_info;
+    whd_buffer_t buffer;
+    uint32_t done = 0;
+    uint32_t i;
+
+    while (done < iterations)
+    {
+        for (i = 0; i < WHD_BENCH_SDPCM_BATCH; i++)
+        {
+            if (whd_send_to_bus(ctx->whd_driver, ctx->tx_batch[i], DATA_HEADER, (uint8_t)(i & 0x7) ) != WHD_SUCCESS)
+            {
+                return 0;
+            }
+        }
+        for (i = 0; i < WHD_BENCH_SDPCM_BATCH; i++)
+        {
+            /* Keep the credit window open; the bus never returns credits here */
+            sdpcm_info->tx_max = (uint8_t)(sdpcm_info->tx_seq + WHD_BENCH_SDPCM_BATCH);
+            if (whd_sdpcm_get_packet_to_send(ctx->whd_driver, &buffer) != WHD_SUCCESS)
+            {
+                return 0;
+            }
+            ctx->tx_batch[i] = buffer;
+        }
+        done += WHD_BENCH_SDPCM_BATCH;
+    }
+    return done;
+}
+
+static void whd_bench_sdpcm_teardown(whd_bench_ctx_t *ctx)
+{
+    uint32_t i;
+
+    whd_sdpcm_quit(ctx->whd_driver);
+    for (i = 0; i < WHD_BENCH_SDPCM_BATCH; i++)
+    {
+        if (ctx->tx_batch[i] != NULL)
+        {
+            (void)whd_buffer_release(ctx->whd_driver, ctx->tx_batch[i], WHD_NETWORK_TX);
+            ctx->tx_batch[i] = NULL;
+        }
+    }
+}
+
+static void *whd_bench_event_handler(whd_interface_t ifp, const whd_event_header_t *event_header,
+                                     const uint8_t *event_data, void *handler_user_data)
+{
+    whd_bench_ctx_t *ctx = (whd_bench_ctx_t *)handler_user_data;
+
+    (void)ifp;
+    (void)event_header;
+    ctx->sink += event_data[0];
+    ctx->event_hits++;
+    return handler_user_data;
+}
+
+static int whd_bench_event_setup(whd_bench_ctx_t *ctx)
+{
+    static const whd_event_num_t other_events[] =
+    { WLC_E_LINK, WLC_E_DEAUTH_IND, WLC_E_DISASSOC_IND, WLC_E_PSK_SUP, WLC_E_SET_SSID, WLC_E_AUTH };
+    whd_cdc_bdc_info_t *cdc_bdc_info = &ctx->cdc_bdc_info;
+    bdc_header_t *bdc_header = (bdc_header_t *)ctx->event_packet;
+    whd_event_t *event = (whd_event_t *)&bdc_header[1];
+    uint8_t *data = (uint8_t *)&event[1];
+    uint32_t i;
+    uint32_t j;
+
+    memset(cdc_bdc_info, 0, sizeof(*cdc_bdc_info) );
+    if (whd_lock_init(&cdc_bdc_info->event_list_mutex, "event_list", WHD_LOCK_BLOCKING) != WHD_SUCCESS)
+    {
+        return -1;
+    }
+
+    /* Fill every handler slot; the escan handler is registered last so the scan walks the whole list */
+    for (i = 0; i < WHD_EVENT_HANDLER_LIST_SIZE; i++)
+    {
+        event_list_elem_t *elem = &cdc_bdc_info->whd_event_list[i];
+
+        for (j = 0; j < sizeof(other_events) / sizeof(other_events[0]); j++)
+        {
+            elem->events[j] = other_events[j];
+        }
+        if (i == WHD_EVENT_HANDLER_LIST_SIZE - 1)
+        {
+            elem->events[j++] = WLC_E_ESCAN_RESULT;
+        }
+        elem->events[j] = WLC_E_NONE;
+        elem->handler = whd_bench_event_handler;
+        elem->handler_user_data = ctx;
+        elem->ifidx = 0;
+        elem->event_set = WHD_TRUE;
+    }
+
+    ctx->proto.pd = cdc_bdc_info;
+    ctx->whd_driver->proto = &ctx->proto;
+
+    memset(ctx->event_packet, 0, sizeof(ctx->event_packet) );
+    bdc_header->data_offset = 0;
+    event->eth.ethertype = hton16(WHD_BENCH_ETHER_TYPE_BRCM);
+    event->eth_evt_hdr.oui[0] = 0x00;
+    event->eth_evt_hdr.oui[1] = 0x10;
+    event->eth_evt_hdr.oui[2] = 0x18;
+    event->whd_event.event_type = hton32(WLC_E_ESCAN_RESULT);
+    event->whd_event.status = hton32(WLC_E_STATUS_PARTIAL);
+    event->whd_event.datalen = hton32(WHD_BENCH_EVENT_DATA_LEN);
+    event->whd_event.ifidx = 0;
+    event->whd_event.bsscfgidx = 0;
+    for (i = 0; i < WHD_BENCH_EVENT_DATA_LEN; i++)
+    {
+        data[i] = (uint8_t)i;
+    }
+    ctx->event_hits = 0;
+    return 0;
+}
+
+/* Each operation is one event packet copied into a fresh RX buffer and dispatched */
+static uint32_t whd_bench_event_run(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    whd_buffer_t buffer;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        if (whd_host_buffer_get(ctx->whd_driver, &buffer, WHD_NETWORK_RX, sizeof(ctx->event_packet), 0) !=
+            WHD_SUCCESS)
+        {
+            return 0;
+        }
+        memcpy(whd_buffer_get_current_piece_data_pointer(ctx->whd_driver, buffer), ctx->event_packet,
+               sizeof(ctx->event_packet) );
+        whd_process_bdc_event(ctx->whd_driver, buffer, sizeof(ctx->event_packet) );
+    }
+    return (ctx->event_hits >= iterations) ? iterations : 0;
+}
+
+static void whd_bench_event_teardown(whd_bench_ctx_t *ctx)
+{
+    (void)whd_lock_deinit(&ctx->cdc_bdc_info.event_list_mutex);
+    ctx->whd_driver->proto = NULL;
+}
+
+#else /* PROTO_MSGBUF */
+/******************************************************
+*             msgbuf cases
+******************************************************/
+
+static int whd_bench_flowring_setup(whd_bench_ctx_t *ctx)
+{
+    uint32_t i;
+
+    ctx->flow = whd_flowring_attach(ctx->whd_driver, 2 * WHD_BENCH_FLOWRING_COUNT);
+    if (ctx->flow == NULL)
+    {
+        return -1;
+    }
+
+    /* Interface 1 acts as an AP so its flows are hashed on the peer address */
+    ctx->flow->addr_mode[1] = ADDR_DIRECT;
+    for (i = 0; i < WHD_BENCH_FLOWRING_COUNT; i++)
+    {
+        ctx->macs[i][0] = 0x02;
+        ctx->macs[i][1] = 0x00;
+        ctx->macs[i][2] = 0x5e;
+        ctx->macs[i][3] = 0x10;
+        ctx->macs[i][4] = (uint8_t)(i * 37);
+        ctx->macs[i][5] = (uint8_t)(i * 11 + 1);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (whd_flowring_create(ctx->flow, ctx->macs[0], (uint8_t)(i * 2), 0) == WHD_FLOWRING_INVALID_ID)
+        {
+            return -1;
+        }
+    }
+    for (i = 0; i < WHD_BENCH_FLOWRING_COUNT / 2; i++)
+    {
+        if (whd_flowring_create(ctx->flow, ctx->macs[i], 0, 1) == WHD_FLOWRING_INVALID_ID)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void whd_bench_flowring_remove(struct whd_flowring *flow, uint32_t flowid)
+{
+    struct whd_flowring_ring *ring = flow->rings[flowid];
+
+    flow->hash[ring->hash_id].ifidx = WHD_FLOWRING_INVALID_IFIDX;
+    whd_mem_memset(flow->hash[ring->hash_id].mac, 0, ETHER_ADDR_LEN);
+    (void)whd_msgbuf_txflow_deinit(&ring->txflow_queue);
+    whd_mem_free(ring);
+    flow->rings[flowid] = NULL;
+}
+
+static void whd_bench_flowring_teardown(whd_bench_ctx_t *ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < ctx->flow->nrofrings; i++)
+    {
+        if (ctx->flow->rings[i] != NULL)
+        {
+            whd_bench_flowring_remove(ctx->flow, i);
+        }
+    }
+    whd_mem_free(ctx->flow->rings);
+    whd_mem_free(ctx->flow);
+    ctx->flow = NULL;
+}
+
+static uint32_t whd_bench_flowring_lookup_sta(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        ctx->sink += whd_flowring_lookup(ctx->flow, ctx->macs[0], (uint8_t)(i & 0x7), 0);
+    }
+    return iterations;
+}
+
+static uint32_t whd_bench_flowring_lookup_ap(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        ctx->sink += whd_flowring_lookup(ctx->flow, ctx->macs[i % (WHD_BENCH_FLOWRING_COUNT / 2)], 0, 1);
+    }
+    return iterations;
+}
+
+static uint32_t whd_bench_flowring_lookup_miss(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        ctx->sink += whd_flowring_lookup(ctx->flow,
+                                         ctx->macs[WHD_BENCH_FLOWRING_COUNT / 2 +
+                                                   i % (WHD_BENCH_FLOWRING_COUNT / 2)], 0, 1);
+    }
+    return iterations;
+}
+
+/* Each operation creates a flow for a new peer and removes it again */
+static uint32_t whd_bench_flowring_create(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t flowid;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        flowid = whd_flowring_create(ctx->flow, ctx->macs[WHD_BENCH_FLOWRING_COUNT - 1], 0, 1);
+        if ( (flowid == WHD_FLOWRING_INVALID_ID) || (flowid >= ctx->flow->nrofrings) )
+        {
+            return 0;
+        }
+        whd_bench_flowring_remove(ctx->flow, flowid);
+    }
+    return iterations;
+}
+
+static int whd_bench_pktid_setup_common(whd_bench_ctx_t *ctx, uint32_t prefill)
+{
+    uint32_t physaddr;
+    uint32_t idx;
+    uint32_t i;
+
+    ctx->pktids = whd_msgbuf_init_pktids(WHD_BENCH_PKTID_ENTRIES);
+    if (ctx->pktids == NULL)
+    {
+        return -1;
+    }
+    if (whd_lock_init(&ctx->pktids->pktid_mutex, "tx_pktids", WHD_LOCK_SHORT) != WHD_SUCCESS)
+    {
+        return -1;
+    }
+    if (whd_host_buffer_get(ctx->whd_driver, &ctx->pktid_buffer, WHD_NETWORK_TX, WHD_BENCH_SDPCM_PAYLOAD, 0) !=
+        WHD_SUCCESS)
+    {
+        return -1;
+    }
+
+    /* Occupy the IDs right after the allocation cursor, as outstanding TX does */
+    for (i = 0; i < prefill; i++)
+    {
+        if (whd_msgbuf_alloc_pktid(ctx->whd_driver, ctx->pktids, ctx->pktid_buffer, 0, &physaddr, &idx) !=
+            WHD_SUCCESS)
+        {
+            return -1;
+        }
+    }
+    ctx->pktids->last_allocated_idx = 0;
+    return 0;
+}
+
+static int whd_bench_pktid_setup(whd_bench_ctx_t *ctx)
+{
+    return whd_bench_pktid_setup_common(ctx, 0);
+}
+
+static int whd_bench_pktid_loaded_setup(whd_bench_ctx_t *ctx)
+{
+    return whd_bench_pktid_setup_common(ctx, WHD_BENCH_PKTID_ENTRIES * 3 / 4);
+}
+
+/* Each operation is one whd_msgbuf_alloc_pktid() and the whd_msgbuf_get_pktid() that frees it */
+static uint32_t whd_bench_pktid_run(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint32_t physaddr;
+    uint32_t idx;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        if (whd_msgbuf_alloc_pktid(ctx->whd_driver, ctx->pktids, ctx->pktid_buffer, WHD_ETHERNET_SIZE,
+                                   &physaddr, &idx) != WHD_SUCCESS)
+        {
+            return 0;
+        }
+        /* Free it, then pin the cursor so every allocation walks the occupied run */
+        ctx->sink += (uintptr_t)whd_msgbuf_get_pktid(ctx->whd_driver, ctx->pktids, idx);
+        ctx->pktids->last_allocated_idx = 0;
+    }
+    return iterations;
+}
+
+static void whd_bench_pktid_teardown(whd_bench_ctx_t *ctx)
+{
+    (void)whd_lock_deinit(&ctx->pktids->pktid_mutex);
+    whd_mem_free(ctx->pktids->array);
+    whd_mem_free(ctx->pktids);
+    ctx->pktids = NULL;
+    (void)whd_buffer_release(ctx->whd_driver, ctx->pktid_buffer, WHD_NETWORK_TX);
+    ctx->pktid_buffer = NULL;
+}
+
+static int whd_bench_ring_bell(void *ctx)
+{
+    ( (whd_bench_ctx_t *)ctx )->ring_bells++;
+    return 0;
+}
+
+/* The device is assumed to keep up: reading the read index finds everything consumed */
+static int whd_bench_ring_update_rptr(void *ctx)
+{
+    struct whd_commonring *ring = &( (whd_bench_ctx_t *)ctx )->ring;
+
+    ring->r_ptr = ring->w_ptr;
+    return 0;
+}
+
+static int whd_bench_ring_noop(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+
+static int whd_bench_ring_setup(whd_bench_ctx_t *ctx)
+{
+    memset(&ctx->ring, 0, sizeof(ctx->ring) );
+    ctx->ring_buf = whd_mem_malloc(WHD_BENCH_RING_DEPTH * WHD_BENCH_RING_ITEM_LEN);
+    if (ctx->ring_buf == NULL)
+    {
+        return -1;
+    }
+    whd_commonring_register_cb(&ctx->ring, whd_bench_ring_bell, whd_bench_ring_update_rptr,
+                               whd_bench_ring_noop, whd_bench_ring_noop, whd_bench_ring_noop, ctx);
+    if (whd_commonring_config(&ctx->ring, WHD_BENCH_RING_DEPTH, WHD_BENCH_RING_ITEM_LEN, ctx->ring_buf) !=
+        WHD_SUCCESS)
+    {
+        return -1;
+    }
+    ctx->ring_bells = 0;
+    return 0;
+}
+
+/* Each operation reserves one item and completes it, ringing the doorbell every time */
+static uint32_t whd_bench_ring_single(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint8_t *item;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        item = whd_commonring_reserve_for_write(&ctx->ring);
+        if (item == NULL)
+        {
+            return 0;
+        }
+        item[0] = (uint8_t)i;
+        (void)whd_commonring_write_complete(&ctx->ring);
+    }
+    return iterations;
+}
+
+/* Each operation reserves one item; completion is batched as in whd_msgbuf_txflow() */
+static uint32_t whd_bench_ring_batched(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    uint8_t *item;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        if (!whd_commonring_write_available(&ctx->ring) )
+        {
+            return 0;
+        }
+        item = whd_commonring_reserve_for_write(&ctx->ring);
+        if (item == NULL)
+        {
+            return 0;
+        }
+        item[0] = (uint8_t)i;
+        if ( (i % WHD_BENCH_RING_BATCH) == (WHD_BENCH_RING_BATCH - 1) )
+        {
+            (void)whd_commonring_write_complete(&ctx->ring);
+        }
+    }
+    (void)whd_commonring_write_complete(&ctx->ring);
+    return iterations;
+}
+
+/* Each operation reserves one item and completes it under the TX flowring doorbell policy; the
+ * batch is flushed every WHD_BENCH_RING_TXFLOW_BATCH items as at the end of whd_msgbuf_txflow() */
+static uint32_t whd_bench_ring_coalesced(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    static const struct whd_commonring_db_policy policy =
+    { WHD_MSGBUF_TX_FLUSH_CNT1, WHD_MSGBUF_TX_FLUSH_CNT2, WHD_MSGBUF_TX_FLUSH_DELAY_MS };
+    uint8_t *item;
+    uint32_t i;
+
+    whd_commonring_set_db_policy(&ctx->ring, &policy);
+    for (i = 0; i < iterations; i++)
+    {
+        item = whd_commonring_reserve_for_write(&ctx->ring);
+        if (item == NULL)
+        {
+            return 0;
+        }
+        item[0] = (uint8_t)i;
+        (void)whd_commonring_write_complete(&ctx->ring);
+        if ( (i % WHD_BENCH_RING_TXFLOW_BATCH) == (WHD_BENCH_RING_TXFLOW_BATCH - 1) )
+        {
+            (void)whd_commonring_flush(&ctx->ring);
+        }
+    }
+    (void)whd_commonring_flush(&ctx->ring);
+    return iterations;
+}
+
+static void whd_bench_ring_teardown(whd_bench_ctx_t *ctx)
+{
+    (void)whd_lock_deinit(&ctx->ring.lock);
+    whd_mem_free(ctx->ring_buf);
+    ctx->ring_buf = NULL;
+}
+
+/* The ring callbacks of whd_ring.c, going through whd_driver read_ptr and write_ptr */
+static int whd_bench_idx_ring_bell(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+
+static int whd_bench_idx_update_rptr(void *ctx)
+{
+    struct whd_ringbuf *ring = (struct whd_ringbuf *)ctx;
+
+    ring->commonring.r_ptr = ring->whd_drv->read_ptr(ring->whd_drv, ring->r_idx_addr);
+    return 0;
+}
+
+static int whd_bench_idx_update_wptr(void *ctx)
+{
+    struct whd_ringbuf *ring = (struct whd_ringbuf *)ctx;
+
+    ring->commonring.w_ptr = ring->whd_drv->read_ptr(ring->whd_drv, ring->w_idx_addr);
+    return 0;
+}
+
+static int whd_bench_idx_write_rptr(void *ctx)
+{
+    struct whd_ringbuf *ring = (struct whd_ringbuf *)ctx;
+
+    ring->whd_drv->write_ptr(ring->whd_drv, ring->r_idx_addr, ring->commonring.r_ptr);
+    return 0;
+}
+
+static int whd_bench_idx_write_wptr(void *ctx)
+{
+    struct whd_ringbuf *ring = (struct whd_ringbuf *)ctx;
+
+    ring->whd_drv->write_ptr(ring->whd_drv, ring->w_idx_addr, ring->commonring.w_ptr);
+    return 0;
+}
+
+static int whd_bench_idx_setup(whd_bench_ctx_t *ctx, uint8_t idx_sz)
+{
+    struct whd_driver *drv = ctx->whd_driver;
+    uint32_t size = whd_ring_idx_block_size(idx_sz, WHD_NROF_H2D_COMMON_MSGRINGS, WHD_NROF_D2H_COMMON_MSGRINGS);
+    uint32_t i;
+
+    ctx->idx_buf = whd_mem_malloc(size);
+    if ( (ctx->idx_buf == NULL) ||
+         (whd_ring_idx_block_init(&ctx->idx_block, ctx->idx_buf, idx_sz, WHD_NROF_H2D_COMMON_MSGRINGS,
+                                  WHD_NROF_D2H_COMMON_MSGRINGS) != WHD_SUCCESS) )
+    {
+        return -1;
+    }
+    memset(ctx->idx_buf, 0, size);
+    drv->read_ptr = (idx_sz == sizeof(uint16_t) ) ? whd_ring_idx_read16 : whd_ring_idx_read32;
+    drv->write_ptr = (idx_sz == sizeof(uint16_t) ) ? whd_ring_idx_write16 : whd_ring_idx_write32;
+
+    memset(ctx->idx_rings, 0, sizeof(ctx->idx_rings) );
+    ctx->idx_rings[0].w_idx_addr = whd_ring_idx_addr(&ctx->idx_block, WHD_RING_IDX_H2D_W,
+                                                     WHD_H2D_MSGRING_CONTROL_SUBMIT);
+    ctx->idx_rings[0].r_idx_addr = whd_ring_idx_addr(&ctx->idx_block, WHD_RING_IDX_H2D_R,
+                                                     WHD_H2D_MSGRING_CONTROL_SUBMIT);
+    ctx->idx_rings[1].w_idx_addr = whd_ring_idx_addr(&ctx->idx_block, WHD_RING_IDX_D2H_W,
+                                                     WHD_D2H_MSGRING_CONTROL_COMPLETE -
+                                                     WHD_NROF_H2D_COMMON_MSGRINGS);
+    ctx->idx_rings[1].r_idx_addr = whd_ring_idx_addr(&ctx->idx_block, WHD_RING_IDX_D2H_R,
+                                                     WHD_D2H_MSGRING_CONTROL_COMPLETE -
+                                                     WHD_NROF_H2D_COMMON_MSGRINGS);
+    for (i = 0; i < ARRAY_SIZE(ctx->idx_rings); i++)
+    {
+        ctx->idx_ring_bufs[i] = whd_mem_malloc(WHD_BENCH_RING_DEPTH * WHD_BENCH_RING_ITEM_LEN);
+        if (ctx->idx_ring_bufs[i] == NULL)
+        {
+            return -1;
+        }
+        ctx->idx_rings[i].whd_drv = drv;
+        whd_commonring_register_cb(&ctx->idx_rings[i].commonring, whd_bench_idx_ring_bell,
+                                   whd_bench_idx_update_rptr, whd_bench_idx_update_wptr,
+                                   whd_bench_idx_write_rptr, whd_bench_idx_write_wptr, &ctx->idx_rings[i]);
+        if (whd_commonring_config(&ctx->idx_rings[i].commonring, WHD_BENCH_RING_DEPTH, WHD_BENCH_RING_ITEM_LEN,
+                                  ctx->idx_ring_bufs[i]) != WHD_SUCCESS)
+        {
+            return -1;
+        }
+    }
+    ctx->idx_host_seq = 0;
+    ctx->idx_dev_seq = 0;
+    ctx->idx_done_seq = 0;
+    return 0;
+}
+
+static int whd_bench_idx_setup16(whd_bench_ctx_t *ctx)
+{
+    return whd_bench_idx_setup(ctx, sizeof(uint16_t) );
+}
+
+static int whd_bench_idx_setup32(whd_bench_ctx_t *ctx)
+{
+    return whd_bench_idx_setup(ctx, sizeof(uint32_t) );
+}
+
+/* The simulated device: consumes what the host published on the H2D ring, checks it and
+ * answers every item with a completion on the D2H ring, moving its own indices in the block the
+ * way its DMA engine would. Returns -1 if an item is not the one expected. */
+static int whd_bench_idx_device(whd_bench_ctx_t *ctx)
+{
+    struct whd_driver *drv = ctx->whd_driver;
+    struct whd_ringbuf *h2d = &ctx->idx_rings[0];
+    struct whd_ringbuf *d2h = &ctx->idx_rings[1];
+    uint16_t h2d_w = drv->read_ptr(drv, h2d->w_idx_addr);
+    uint16_t h2d_r = drv->read_ptr(drv, h2d->r_idx_addr);
+    uint16_t d2h_w = drv->read_ptr(drv, d2h->w_idx_addr);
+    uint16_t d2h_r = drv->read_ptr(drv, d2h->r_idx_addr);
+    uint32_t seq;
+
+    while (h2d_r != h2d_w)
+    {
+        if ( (uint16_t)( (d2h_w + 1) % WHD_BENCH_RING_DEPTH ) == d2h_r )
+        {
+            break;
+        }
+        memcpy(&seq, ctx->idx_ring_bufs[0] + h2d_r * WHD_BENCH_RING_ITEM_LEN, sizeof(seq) );
+        if (seq != ctx->idx_dev_seq)
+        {
+            return -1;
+        }
+        memcpy(ctx->idx_ring_bufs[1] + d2h_w * WHD_BENCH_RING_ITEM_LEN, &seq, sizeof(seq) );
+        ctx->idx_dev_seq++;
+        h2d_r = (uint16_t)( (h2d_r + 1) % WHD_BENCH_RING_DEPTH );
+        d2h_w = (uint16_t)( (d2h_w + 1) % WHD_BENCH_RING_DEPTH );
+    }
+    drv->write_ptr(drv, h2d->r_idx_addr, h2d_r);
+    drv->write_ptr(drv, d2h->w_idx_addr, d2h_w);
+    return 0;
+}
+
+/* Reads every completion the device published; returns -1 if one is out of order */
+static int whd_bench_idx_host_complete(whd_bench_ctx_t *ctx)
+{
+    struct whd_commonring *d2h = &ctx->idx_rings[1].commonring;
+    uint8_t *item;
+    uint16_t n_items;
+    uint16_t i;
+    uint32_t seq;
+
+    while ( (item = whd_commonring_get_read_ptr(d2h, &n_items) ) != NULL )
+    {
+        for (i = 0; i < n_items; i++)
+        {
+            memcpy(&seq, item + i * WHD_BENCH_RING_ITEM_LEN, sizeof(seq) );
+            if (seq != ctx->idx_done_seq)
+            {
+                return -1;
+            }
+            ctx->idx_done_seq++;
+        }
+        (void)whd_commonring_read_complete(d2h, n_items);
+    }
+    return 0;
+}
+
+/* Each operation submits one item, lets the device run and reads back its completion, every
+ * index read and write going to the shared block */
+static uint32_t whd_bench_idx_run(whd_bench_ctx_t *ctx, uint32_t iterations)
+{
+    struct whd_commonring *h2d = &ctx->idx_rings[0].commonring;
+    uint8_t *item;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        item = whd_commonring_reserve_for_write(h2d);
+        if (item == NULL)
+        {
+            return 0;
+        }
+        memcpy(item, &ctx->idx_host_seq, sizeof(ctx->idx_host_seq) );
+        ctx->idx_host_seq++;
+        (void)whd_commonring_write_complete(h2d);
+
+        if ( (whd_bench_idx_device(ctx) != 0) || (whd_bench_idx_host_complete(ctx) != 0) )
+        {
+            return 0;
+        }
+    }
+    /* Every item made it through the device and back */
+    if ( (ctx->idx_dev_seq != ctx->idx_host_seq) || (ctx->idx_done_seq != ctx->idx_host_seq) )
+    {
+        return 0;
+    }
+    return iterations;
+}
+
+static void whd_bench_idx_teardown(whd_bench_ctx_t *ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < ARRAY_SIZE(ctx->idx_rings); i++)
+    {
+        if (ctx->idx_rings[i].commonring.inited)
+        {
+            (void)whd_lock_deinit(&ctx->idx_rings[i].commonring.lock);
+        }
+        whd_mem_free(ctx->idx_ring_bufs[i]);
+        ctx->idx_ring_bufs[i] = NULL;
+    }
+    whd_mem_free(ctx->idx_buf);
+    ctx->idx_buf = NULL;
+}
+#endif /* PROTO_MSGBUF */
+
+/******************************************************
+*             Case table
+******************************************************/
+
+static const whd_bench_case_t whd_bench_cases[] =
+{
+    { "tlv_parse_last", "whd_parse_tlvs() for the last IE of a beacon body",
+      whd_bench_tlv_setup, whd_bench_tlv_find_last, NULL },
+    { "tlv_parse_missing", "whd_parse_tlvs() for an IE that is not present",
+      whd_bench_tlv_setup, whd_bench_tlv_find_missing, NULL },
+#ifndef PROTO_MSGBUF
+    { "sdpcm_enqueue_dequeue", "whd_send_to_bus() + whd_sdpcm_get_packet_to_send(), batches of 32 over all ACs",
+      whd_bench_sdpcm_setup, whd_bench_sdpcm_run, whd_bench_sdpcm_teardown },
+    { "bdc_event_dispatch", "whd_process_bdc_event() for an escan result with all handler slots in use",
+      whd_bench_event_setup, whd_bench_event_run, whd_bench_event_teardown },
+#else
+    { "flowring_lookup_sta", "whd_flowring_lookup() on a STA interface across all priorities",
+      whd_bench_flowring_setup, whd_bench_flowring_lookup_sta, whd_bench_flowring_teardown },
+    { "flowring_lookup_ap", "whd_flowring_lookup() hit on an AP interface with 4 peers",
+      whd_bench_flowring_setup, whd_bench_flowring_lookup_ap, whd_bench_flowring_teardown },
+    { "flowring_lookup_miss", "whd_flowring_lookup() miss on an AP interface",
+      whd_bench_flowring_setup, whd_bench_flowring_lookup_miss, whd_bench_flowring_teardown },
+    { "flowring_create_delete", "whd_flowring_create() for a new AP peer and removal of the ring",
+      whd_bench_flowring_setup, whd_bench_flowring_create, whd_bench_flowring_teardown },
+    { "pktid_alloc_free", "whd_msgbuf_alloc_pktid() + whd_msgbuf_get_pktid() on an empty table",
+      whd_bench_pktid_setup, whd_bench_pktid_run, whd_bench_pktid_teardown },
+    { "pktid_alloc_free_loaded", "whd_msgbuf_alloc_pktid() + whd_msgbuf_get_pktid() with 75% of IDs in use",
+      whd_bench_pktid_loaded_setup, whd_bench_pktid_run, whd_bench_pktid_teardown },
+    { "commonring_reserve_complete", "whd_commonring_reserve_for_write() + write_complete() per item",
+      whd_bench_ring_setup, whd_bench_ring_single, whd_bench_ring_teardown },
+    { "commonring_reserve_batched", "whd_commonring_reserve_for_write() with write_complete() every 32 items",
+      whd_bench_ring_setup, whd_bench_ring_batched, whd_bench_ring_teardown },
+    { "commonring_reserve_coalesced", "whd_commonring_write_complete() per item under the TX flowring doorbell policy",
+      whd_bench_ring_setup, whd_bench_ring_coalesced, whd_bench_ring_teardown },
+    { "commonring_host_idx16", "H2D submit and D2H completion through 2 byte ring indices in host memory",
+      whd_bench_idx_setup16, whd_bench_idx_run, whd_bench_idx_teardown },
+    { "commonring_host_idx32", "H2D submit and D2H completion through 4 byte ring indices in host memory",
+      whd_bench_idx_setup32, whd_bench_idx_run, whd_bench_idx_teardown },
+#endif /* PROTO_MSGBUF */
+};
+
+/******************************************************
+*             Harness
+******************************************************/
+
+static int whd_bench_compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void whd_bench_run_case(whd_bench_ctx_t *ctx, const whd_bench_case_t *bench, uint32_t iterations,
+                               uint32_t runs, whd_bench_result_t *result)
+{
+    double samples[WHD_BENCH_MAX_RUNS];
+    uint32_t buffers_before;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t ops;
+    uint32_t run;
+
+    memset(result, 0, sizeof(*result) );
+    buffers_before = whd_bench_buffers_in_use();
+
+    if ( (bench->setup != NULL) && (bench->setup(ctx) != 0) )
+    {
+        result->status = -1;
+        return;
+    }
+
+    /* Warm caches and branch predictors before the measured runs */
+    (void)bench->run(ctx, iterations / 10 + 1);
+
+    for (run = 0; run < runs; run++)
+    {
+        start = whd_bench_time_ns();
+        ops = bench->run(ctx, iterations);
+        elapsed = whd_bench_time_ns() - start;
+        if (ops == 0)
+        {
+            result->status = -1;
+            break;
+        }
+        samples[run] = (double)elapsed / (double)ops;
+        result->ops += ops;
+    }
+
+    if (bench->teardown != NULL)
+    {
+        bench->teardown(ctx);
+    }
+    result->buffers_leaked = (int32_t)(whd_bench_buffers_in_use() - buffers_before);
+
+    if (result->status == 0)
+    {
+        qsort(samples, runs, sizeof(samples[0]), whd_bench_compare_double);
+        result->ns_per_op_min = samples[0];
+        result->ns_per_op_median = samples[runs / 2];
+        result->ns_per_op_max = samples[runs - 1];
+    }
+}
+
+static void whd_bench_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-n iterations] [-r runs] [-f name-filter] [-o output.json]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    whd_bench_ctx_t *ctx;
+    whd_bench_result_t result;
+    const char *filter = NULL;
+    const char *out_path = NULL;
+    uint32_t iterations = WHD_BENCH_DEFAULT_ITERATIONS;
+    uint32_t runs = WHD_BENCH_DEFAULT_RUNS;
+    uint32_t i;
+    int first = 1;
+    int failed = 0;
+    FILE *out = stdout;
+
+    for (i = 1; i < (uint32_t)argc; i++)
+    {
+        if ( (strcmp(argv[i], "-n") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            iterations = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-r") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-f") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            filter = argv[++i];
+        }
+        else if ( (strcmp(argv[i], "-o") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            out_path = argv[++i];
+        }
+        else
+        {
+            whd_bench_usage(argv[0]);
+            return 2;
+        }
+    }
+    if ( (iterations == 0) || (runs == 0) || (runs > WHD_BENCH_MAX_RUNS) )
+    {
+        whd_bench_usage(argv[0]);
+        return 2;
+    }
+
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+
+    ctx = whd_mem_calloc(1, sizeof(*ctx) );
+    if (ctx == NULL)
+    {
+        return 1;
+    }
+    ctx->whd_driver = whd_mem_calloc(1, sizeof(*ctx->whd_driver) );
+    ctx->ifp = whd_mem_calloc(1, sizeof(*ctx->ifp) );
+    if ( (ctx->whd_driver == NULL) || (ctx->ifp == NULL) )
+    {
+        return 1;
+    }
+    ctx->whd_driver->buffer_if = &whd_bench_buffer_funcs;
+    ctx->whd_driver->aligned_addr = whd_mem_malloc(WHD_LINK_MTU);
+    ctx->ifp->whd_driver = ctx->whd_driver;
+    ctx->whd_driver->iflist[0] = ctx->ifp;
+
+    if (out_path != NULL)
+    {
+        out = fopen(out_path, "w");
+        if (out == NULL)
+        {
+            perror(out_path);
+            return 1;
+        }
+    }
+
+    fprintf(out, "{\n  \"suite\": \"whd_host_bench\",\n");
+#ifndef PROTO_MSGBUF
+    fprintf(out, "  \"proto\": \"sdpcm\",\n");
+#else
+    fprintf(out, "  \"proto\": \"msgbuf\",\n");
+#endif /* PROTO_MSGBUF */
+    fprintf(out, "  \"iterations\": %u,\n  \"runs\": %u,\n  \"results\": [", (unsigned)iterations, (unsigned)runs);
+
+    for (i = 0; i < sizeof(whd_bench_cases) / sizeof(whd_bench_cases[0]); i++)
+    {
+        const whd_bench_case_t *bench = &whd_bench_cases[i];
+
+        if ( (filter != NULL) && (strstr(bench->name, filter) == NULL) )
+        {
+            continue;
+        }
+
+        whd_bench_run_case(ctx, bench, iterations, runs, &result);
+        if ( (result.status != 0) || (result.buffers_leaked != 0) )
+        {
+            failed = 1;
+        }
+
+        fprintf(out, "%s\n    {\n      \"name\": \"%s\",\n      \"description\": \"%s\",\n", first ? "" : ",",
+                bench->name, bench->description);
+        fprintf(out, "      \"status\": \"%s\",\n      \"ops\": %llu,\n", (result.status == 0) ? "ok" : "error",
+                (unsigned long long)result.ops);
+        fprintf(out, "      \"ns_per_op_min\": %.3f,\n      \"ns_per_op_median\": %.3f,\n"
+                "      \"ns_per_op_max\": %.3f,\n", result.ns_per_op_min, result.ns_per_op_median,
+                result.ns_per_op_max);
+        fprintf(out, "      \"ops_per_sec\": %.0f,\n      \"buffers_leaked\": %d\n    }",
+                (result.ns_per_op_median > 0.0) ? 1e9 / result.ns_per_op_median : 0.0, (int)result.buffers_leaked);
+        first = 0;
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return failed;
+}
+
+#endif /* WHD_HOST_BENCH */
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Runs the OCI D3 idle time engine against a simulated bus activity trace
+ *
+ *  The doorbell and mailbox exchange with the WLAN core is simulated: a D3 inform goes out once
+ *  the bus has been idle for the engine's idle time, the D3 ack comes back a fixed time later
+ *  and every resume from D3 costs a fixed time. The adaptive idle time and the fixed one used
+ *  before are run over the same trace and compared in one JSON document. See README.md for the
+ *  build line and the trace format.
+ */
+#if defined(WHD_HOST_BENCH) && defined(WHD_BENCH_OCI_D3)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "whd_bench.h"
+#include "whd_utils.h"
+#include "whd_oci_d3.h"
+
+#define WHD_BENCH_D3_MAX_SEGMENTS   (256)
+
+typedef struct
+{
+    uint32_t duration_ms;
+    uint32_t gap_ms;            /* Time between bus activity, 0 for none */
+} whd_bench_d3_segment_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t activity;
+    uint32_t d3_informs;
+    uint32_t d3_entries;
+    uint32_t short_stays;
+    uint32_t d3_ms;
+    uint32_t resume_ms;
+    uint32_t idle_ms;
+} whd_bench_d3_result_t;
+
+/* Interactive traffic, periodic keep alives, a bursty transfer, keep alives again and idle */
+static const whd_bench_d3_segment_t whd_bench_d3_default_trace[] =
+{
+    { 10000, 100 }, { 60000, 3000 }, { 5000, 60 }, { 30000, 3000 }, { 20000, 0 },
+};
+
+static whd_bench_d3_segment_t whd_bench_d3_trace[WHD_BENCH_D3_MAX_SEGMENTS];
+
+/******************************************************
+*             Simulated link
+******************************************************/
+
+/* Replays the trace; between two activities the link is either kept up or informed, acked and
+ * suspended, after which the second activity pays for a resume */
+static void whd_bench_d3_run(whd_oci_d3_engine_t *engine, uint32_t num_segments, uint32_t ack_ms,
+                             uint32_t resume_ms, whd_bench_d3_result_t *result)
+{
+    uint32_t seg, t, seg_start = 0;
+    uint32_t last_ms = 0;
+    uint32_t inform_ms, d3_enter_ms, d3_ms;
+
+    whd_oci_d3_engine_activity(engine, 0);
+    for (seg = 0; seg < num_segments; seg++)
+    {
+        for (t = whd_bench_d3_trace[seg].gap_ms;
+             (whd_bench_d3_trace[seg].gap_ms != 0) && (t <= whd_bench_d3_trace[seg].duration_ms);
+             t += whd_bench_d3_trace[seg].gap_ms)
+        {
+            result->activity++;
+            inform_ms = last_ms + whd_oci_d3_engine_idle_ms(engine);
+            if (seg_start + t < inform_ms)
+            {
+                whd_oci_d3_engine_activity(engine, seg_start + t);
+                last_ms = seg_start + t;
+                continue;
+            }
+
+            /* An ack still on its way when the bus is needed again leaves no time in D3 */
+            result->d3_informs++;
+            result->d3_entries++;
+            d3_enter_ms = inform_ms + ack_ms;
+            d3_ms = (seg_start + t > d3_enter_ms) ? (seg_start + t - d3_enter_ms) : 0;
+            result->d3_ms += d3_ms;
+            result->resume_ms += resume_ms;
+            whd_oci_d3_engine_resumed(engine, seg_start + t + resume_ms, d3_ms, resume_ms);
+            last_ms = seg_start + t + resume_ms;
+        }
+        seg_start += whd_bench_d3_trace[seg].duration_ms;
+    }
+
+    /* The trailing idle time ends in D3 unless the trace stops first */
+    inform_ms = last_ms + whd_oci_d3_engine_idle_ms(engine);
+    if (seg_start > inform_ms + ack_ms)
+    {
+        result->d3_informs++;
+        result->d3_entries++;
+        result->d3_ms += seg_start - (inform_ms + ack_ms);
+    }
+
+    result->short_stays = engine->short_stays;
+    result->idle_ms = whd_oci_d3_engine_idle_ms(engine);
+}
+
+/******************************************************
+*             Trace
+******************************************************/
+
+/* One segment per line: duration_ms gap_ms; '#' starts a comment */
+static int whd_bench_d3_load(const char *path, uint32_t *num_segments)
+{
+    FILE *f = fopen(path, "r");
+    char line[128];
+    unsigned int duration, gap;
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    *num_segments = 0;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if ( (line[0] == '#') || (line[0] == '\n') )
+        {
+            continue;
+        }
+        if ( (sscanf(line, "%u %u", &duration, &gap) != 2) || (*num_segments == WHD_BENCH_D3_MAX_SEGMENTS) )
+        {
+            fprintf(stderr, "%s: bad or too many segments at \"%s\"\n", path, line);
+            fclose(f);
+            return -1;
+        }
+        whd_bench_d3_trace[*num_segments].duration_ms = duration;
+        whd_bench_d3_trace[*num_segments].gap_ms = gap;
+        (*num_segments)++;
+    }
+    fclose(f);
+    return 0;
+}
+
+static void whd_bench_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-a ack_ms] [-c resume_ms] [-m min_idle_ms] [-x max_idle_ms] [trace.txt]\n"
+            "  without a trace a built-in interactive/keep alive/burst scenario is run\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    whd_oci_d3_config_t config;
+    whd_oci_d3_config_t fixed;
+    whd_oci_d3_engine_t engine;
+    whd_bench_d3_result_t results[2];
+    const char *path = NULL;
+    uint32_t num_segments, i;
+    uint32_t ack_ms = 2, resume_ms = 5;
+
+    memset(&config, 0, sizeof(config) );
+    for (i = 1; i < (uint32_t)argc; i++)
+    {
+        if ( (strcmp(argv[i], "-a") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            ack_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-c") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            resume_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-m") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            config.min_idle_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-x") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            config.max_idle_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (argv[i][0] != '-') && (path == NULL) )
+        {
+            path = argv[i];
+        }
+        else
+        {
+            whd_bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (path != NULL)
+    {
+        if (whd_bench_d3_load(path, &num_segments) != 0)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        num_segments = ARRAY_SIZE(whd_bench_d3_default_trace);
+        memcpy(whd_bench_d3_trace, whd_bench_d3_default_trace, sizeof(whd_bench_d3_default_trace) );
+    }
+
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+
+    memset(results, 0, sizeof(results) );
+    results[0].name = "fixed";
+    results[1].name = "adaptive";
+
+    /* The fixed idle time is the adaptive engine pinned at its highest idle time */
+    memset(&fixed, 0, sizeof(fixed) );
+    fixed.max_idle_ms = (config.max_idle_ms != 0) ? config.max_idle_ms : WHD_OCI_D3_DEFAULT_MAX_IDLE_MS;
+    fixed.min_idle_ms = fixed.max_idle_ms;
+    if ( (whd_oci_d3_engine_init(&engine, &fixed) != WHD_SUCCESS) )
+    {
+        fprintf(stderr, "bad idle time\n");
+        return 1;
+    }
+    whd_bench_d3_run(&engine, num_segments, ack_ms, resume_ms, &results[0]);
+
+    if (whd_oci_d3_engine_init(&engine, &config) != WHD_SUCCESS)
+    {
+        fprintf(stderr, "min_idle_ms is above max_idle_ms\n");
+        return 1;
+    }
+    whd_bench_d3_run(&engine, num_segments, ack_ms, resume_ms, &results[1]);
+
+    printf("{\n  \"suite\": \"whd_oci_d3\",\n  \"trace\": \"%s\",\n", (path != NULL) ? path : "built-in");
+    printf("  \"ack_ms\": %u,\n  \"resume_ms\": %u,\n  \"policies\": [\n", (unsigned)ack_ms, (unsigned)resume_ms);
+    for (i = 0; i < ARRAY_SIZE(results); i++)
+    {
+        printf("    { \"name\": \"%s\", \"activity\": %u, \"d3_informs\": %u, \"d3_entries\": %u, "
+               "\"short_stays\": %u, \"d3_ms\": %u, \"resume_ms\": %u, \"idle_ms\": %u }%s\n",
+               results[i].name, (unsigned)results[i].activity, (unsigned)results[i].d3_informs,
+               (unsigned)results[i].d3_entries, (unsigned)results[i].short_stays, (unsigned)results[i].d3_ms,
+               (unsigned)results[i].resume_ms, (unsigned)results[i].idle_ms,
+               (i + 1 < ARRAY_SIZE(results)) ? "," : "");
+    }
+    printf("  ]\n}\n");
+
+    return 0;
+}
+
+#endif /* WHD_HOST_BENCH && WHD_BENCH_OCI_D3 */
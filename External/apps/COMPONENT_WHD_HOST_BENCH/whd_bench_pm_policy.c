@@ -0,0 +1,456 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Runs the adaptive power save policy against a simulated traffic trace
+ *
+ *  The policy's sampling work item is run on a simulated clock, the packet
+ *  counts come from the trace and the PM ioctls are recorded instead of sent.
+ *  The mode changes and the time spent in each level are printed as one JSON
+ *  document. See README.md for the build line and the trace format.
+ *
+ *  Built with WHD_POSIX it instead runs the sampling work item on a real worker
+ *  thread pool and deinitialises the policy while a sample is in flight.
+ */
+#if defined(WHD_HOST_BENCH) && defined(WHD_BENCH_PM_POLICY)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "whd_bench.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_pm_policy.h"
+
+#ifndef WHD_PM_POLICY
+#error "Build with -DWHD_PM_POLICY"
+#endif /* WHD_PM_POLICY */
+
+#define WHD_BENCH_PM_MAX_SEGMENTS   (256)
+#define WHD_BENCH_PM_MAX_CHANGES    (512)
+
+typedef struct
+{
+    uint32_t duration_ms;
+    uint32_t pps;
+    uint32_t queue_depth;
+} whd_bench_pm_segment_t;
+
+typedef struct
+{
+    uint32_t time_ms;
+    uint32_t pm_mode;
+    uint32_t sleep_ret_ms;
+} whd_bench_pm_change_t;
+
+static whd_bench_pm_change_t whd_bench_pm_changes[WHD_BENCH_PM_MAX_CHANGES];
+static uint32_t whd_bench_pm_num_changes;
+static uint32_t whd_bench_pm_ioctls;
+static uint32_t whd_bench_pm_now_ms;
+
+#ifdef WHD_POSIX
+#define WHD_BENCH_PM_THREADS        (2)
+#define WHD_BENCH_PM_SAMPLE_MS      (10)
+#define WHD_BENCH_PM_IOCTL_MS       (5)
+#define WHD_BENCH_PM_WAIT_MS        (2000)
+
+/* Once set, every PM ioctl takes WHD_BENCH_PM_IOCTL_MS and fails, so the policy retries it on
+ * each sample and a sample is in flight for half of every period */
+static volatile whd_bool_t whd_bench_pm_slow_ioctls;
+static volatile uint32_t whd_bench_pm_in_flight;
+#else
+/* Idle, light interactive traffic, a bulk transfer with a short stall, a slow link with a
+ * backlog and idle again */
+static const whd_bench_pm_segment_t whd_bench_pm_default_trace[] =
+{
+    { 5000, 0, 0 }, { 3000, 8, 0 }, { 200, 0, 0 }, { 3000, 8, 0 }, { 4000, 800, 4 }, { 300, 0, 0 },
+    { 4000, 800, 4 }, { 500, 30, 0 }, { 2000, 100, 24 }, { 8000, 0, 0 },
+};
+
+static whd_bench_pm_segment_t whd_bench_pm_trace[WHD_BENCH_PM_MAX_SEGMENTS];
+static cy_worker_thread_work_t *whd_bench_pm_work;
+#endif /* WHD_POSIX */
+
+/******************************************************
+*             Driver hooks outside the policy
+******************************************************/
+
+static whd_result_t whd_bench_pm_record(uint32_t pm_mode, uint32_t sleep_ret_ms)
+{
+#ifdef WHD_POSIX
+    if (whd_bench_pm_slow_ioctls == WHD_TRUE)
+    {
+        (void)__atomic_add_fetch(&whd_bench_pm_in_flight, 1, __ATOMIC_SEQ_CST);
+        (void)__atomic_add_fetch(&whd_bench_pm_ioctls, 1, __ATOMIC_SEQ_CST);
+        (void)cy_rtos_delay_milliseconds(WHD_BENCH_PM_IOCTL_MS);
+        (void)__atomic_sub_fetch(&whd_bench_pm_in_flight, 1, __ATOMIC_SEQ_CST);
+        return WHD_IOCTL_FAIL;
+    }
+#endif /* WHD_POSIX */
+    whd_bench_pm_ioctls++;
+    if (whd_bench_pm_num_changes < WHD_BENCH_PM_MAX_CHANGES)
+    {
+        whd_bench_pm_changes[whd_bench_pm_num_changes].time_ms = whd_bench_pm_now_ms;
+        whd_bench_pm_changes[whd_bench_pm_num_changes].pm_mode = pm_mode;
+        whd_bench_pm_changes[whd_bench_pm_num_changes].sleep_ret_ms = sleep_ret_ms;
+        whd_bench_pm_num_changes++;
+    }
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_wifi_enable_powersave(whd_interface_t ifp)
+{
+    (void)ifp;
+    return whd_bench_pm_record(PM1_POWERSAVE_MODE, 0);
+}
+
+whd_result_t whd_wifi_enable_powersave_with_throughput(whd_interface_t ifp, uint16_t return_to_sleep_delay_ms)
+{
+    (void)ifp;
+    return whd_bench_pm_record(PM2_POWERSAVE_MODE, return_to_sleep_delay_ms);
+}
+
+whd_result_t whd_wifi_disable_powersave(whd_interface_t ifp)
+{
+    (void)ifp;
+    return whd_bench_pm_record(NO_POWERSAVE_MODE, 0);
+}
+
+#ifndef WHD_POSIX
+void cy_worker_thread_work_init(cy_worker_thread_work_t *work, cy_worker_thread_func_t *work_func, void *arg)
+{
+    memset(work, 0, sizeof(*work) );
+    work->work_func = work_func;
+    work->arg = arg;
+}
+
+cy_rslt_t cy_worker_thread_work_enqueue_delayed(cy_worker_thread_info_t *worker_info, cy_worker_thread_work_t *work,
+                                                cy_time_t delay_ms, uint32_t period_ms)
+{
+    (void)worker_info;
+    (void)delay_ms;
+    work->period_ms = period_ms;
+    whd_bench_pm_work = work;
+    return CY_RSLT_SUCCESS;
+}
+
+bool cy_worker_thread_work_cancel(cy_worker_thread_info_t *worker_info, cy_worker_thread_work_t *work)
+{
+    (void)worker_info;
+    if (whd_bench_pm_work != work)
+    {
+        return false;
+    }
+    whd_bench_pm_work = NULL;
+    return true;
+}
+
+/* Runs at once, like the inline threads of the stub RTOS */
+cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t *worker_info, cy_worker_thread_func_t *work_func, void *arg)
+{
+    (void)worker_info;
+    work_func(arg);
+    return CY_RSLT_SUCCESS;
+}
+#endif /* WHD_POSIX */
+
+#ifdef WHD_POSIX
+
+/******************************************************
+*             Deinit with a sample in flight
+******************************************************/
+
+/* Exits 0 if whd_pm_policy_deinit() waited for the sample that was in flight */
+int main(void)
+{
+    struct whd_driver *whd_driver;
+    struct whd_interface *ifp;
+    cy_worker_thread_params_t params;
+    cy_worker_thread_info_t worker;
+    whd_pm_policy_config_t config;
+    uint32_t in_flight_at_deinit = 0;
+    uint32_t in_flight_after, ioctls_after, ioctls_later;
+    uint32_t waited;
+    int failed;
+
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+    whd_driver = whd_mem_calloc(1, sizeof(*whd_driver) );
+    ifp = whd_mem_calloc(1, sizeof(*ifp) );
+    if ( (whd_driver == NULL) || (ifp == NULL) )
+    {
+        return 1;
+    }
+    ifp->whd_driver = whd_driver;
+    whd_driver->iflist[0] = ifp;
+
+    memset(&params, 0, sizeof(params) );
+    params.priority = CY_RTOS_PRIORITY_NORMAL;
+    params.stack_size = 16 * 1024;
+    params.num_threads = WHD_BENCH_PM_THREADS;
+    if (cy_worker_thread_create(&worker, &params) != CY_RSLT_SUCCESS)
+    {
+        fprintf(stderr, "could not create the worker\n");
+        return 1;
+    }
+
+    /* Any packet in a sample moves to level 1, which is never left */
+    memset(&config, 0, sizeof(config) );
+    config.sample_ms = WHD_BENCH_PM_SAMPLE_MS;
+    config.up_samples = 1;
+    config.num_levels = 2;
+    config.levels[0].pm_mode = PM1_POWERSAVE_MODE;
+    config.levels[1].pm_mode = PM2_POWERSAVE_MODE;
+    config.levels[1].pm2_sleep_ret_ms = 20;
+    config.levels[1].enter_pps = 1;
+    if (whd_pm_policy_start(ifp, &config, &worker) != WHD_SUCCESS)
+    {
+        fprintf(stderr, "policy did not start\n");
+        return 1;
+    }
+    /* Level 0 was applied by the start, from here on only the retries are counted */
+    whd_bench_pm_ioctls = 0;
+    whd_bench_pm_slow_ioctls = WHD_TRUE;
+
+    /* Traffic until the policy moves up and starts retrying the PM ioctl */
+    for (waited = 0; (waited < WHD_BENCH_PM_WAIT_MS) &&
+         (__atomic_load_n(&whd_bench_pm_ioctls, __ATOMIC_SEQ_CST) == 0); waited++)
+    {
+        WHD_PM_POLICY_TX(whd_driver, 0);
+        (void)cy_rtos_delay_milliseconds(1);
+    }
+    /* Then deinit as soon as a retry is running on the worker */
+    for (; waited < WHD_BENCH_PM_WAIT_MS; waited++)
+    {
+        in_flight_at_deinit = __atomic_load_n(&whd_bench_pm_in_flight, __ATOMIC_SEQ_CST);
+        if (in_flight_at_deinit != 0)
+        {
+            break;
+        }
+        (void)cy_rtos_delay_milliseconds(1);
+    }
+    whd_pm_policy_deinit(whd_driver);
+    in_flight_after = __atomic_load_n(&whd_bench_pm_in_flight, __ATOMIC_SEQ_CST);
+    ioctls_after = __atomic_load_n(&whd_bench_pm_ioctls, __ATOMIC_SEQ_CST);
+    (void)cy_rtos_delay_milliseconds(5 * WHD_BENCH_PM_SAMPLE_MS);
+    ioctls_later = __atomic_load_n(&whd_bench_pm_ioctls, __ATOMIC_SEQ_CST);
+    (void)cy_worker_thread_delete(&worker);
+
+    failed = (in_flight_at_deinit == 0) || (whd_driver->pm_policy != NULL) || (in_flight_after != 0) ||
+             (ioctls_later != ioctls_after);
+    printf("{\n  \"suite\": \"whd_pm_policy\",\n  \"scenario\": \"deinit_in_flight\",\n");
+    printf("  \"threads\": %u,\n  \"in_flight_at_deinit\": %u,\n  \"in_flight_after_deinit\": %u,\n",
+           (unsigned)WHD_BENCH_PM_THREADS, (unsigned)in_flight_at_deinit, (unsigned)in_flight_after);
+    printf("  \"ioctls_after_deinit\": %u,\n  \"status\": \"%s\"\n}\n", (unsigned)(ioctls_later - ioctls_after),
+           failed ? "fail" : "ok");
+
+    return failed;
+}
+
+#else /* WHD_POSIX */
+
+/******************************************************
+*             Trace
+******************************************************/
+
+/* One segment per line: duration_ms packets_per_second [tx_queue_depth]; '#' starts a comment */
+static int whd_bench_pm_load(const char *path, uint32_t *num_segments)
+{
+    FILE *f = fopen(path, "r");
+    char line[128];
+    unsigned int duration, pps, depth;
+    int fields;
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    *num_segments = 0;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if ( (line[0] == '#') || (line[0] == '\n') )
+        {
+            continue;
+        }
+        depth = 0;
+        fields = sscanf(line, "%u %u %u", &duration, &pps, &depth);
+        if ( (fields < 2) || (*num_segments == WHD_BENCH_PM_MAX_SEGMENTS) )
+        {
+            fprintf(stderr, "%s: bad or too many segments at \"%s\"\n", path, line);
+            fclose(f);
+            return -1;
+        }
+        whd_bench_pm_trace[*num_segments].duration_ms = duration;
+        whd_bench_pm_trace[*num_segments].pps = pps;
+        whd_bench_pm_trace[*num_segments].queue_depth = depth;
+        (*num_segments)++;
+    }
+    fclose(f);
+    return 0;
+}
+
+static void whd_bench_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-s sample_ms] [-u up_samples] [-d down_samples] [trace.txt]\n"
+            "  without a trace a built-in idle/interactive/bulk scenario is run\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *const mode_name[] = { "PM0", "PM1", "PM2" };
+    struct whd_driver *whd_driver;
+    struct whd_interface *ifp;
+    whd_pm_policy_config_t config;
+    whd_pm_policy_stats_t stats;
+    cy_worker_thread_info_t worker;
+    const char *path = NULL;
+    const char *sep = "";
+    uint32_t num_segments, seg, t, i;
+    uint32_t sample_ms, packets, carry = 0;
+    whd_result_t result;
+
+    memset(&config, 0, sizeof(config) );
+    for (i = 1; i < (uint32_t)argc; i++)
+    {
+        if ( (strcmp(argv[i], "-s") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            config.sample_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-u") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            config.up_samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (strcmp(argv[i], "-d") == 0) && (i + 1 < (uint32_t)argc) )
+        {
+            config.down_samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( (argv[i][0] != '-') && (path == NULL) )
+        {
+            path = argv[i];
+        }
+        else
+        {
+            whd_bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (path != NULL)
+    {
+        if (whd_bench_pm_load(path, &num_segments) != 0)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        num_segments = ARRAY_SIZE(whd_bench_pm_default_trace);
+        memcpy(whd_bench_pm_trace, whd_bench_pm_default_trace, sizeof(whd_bench_pm_default_trace) );
+    }
+
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+    whd_driver = whd_mem_calloc(1, sizeof(*whd_driver) );
+    ifp = whd_mem_calloc(1, sizeof(*ifp) );
+    if ( (whd_driver == NULL) || (ifp == NULL) )
+    {
+        return 1;
+    }
+    ifp->whd_driver = whd_driver;
+    whd_driver->iflist[0] = ifp;
+
+    /* One simulated thread, which runs the sampling work item below */
+    memset(&worker, 0, sizeof(worker) );
+    worker.num_threads = 1;
+    worker.state = CY_WORKER_THREAD_VALID;
+
+    whd_bench_set_clock_ms(&whd_bench_pm_now_ms);
+    result = whd_pm_policy_start(ifp, &config, &worker);
+    if ( (result != WHD_SUCCESS) || (whd_bench_pm_work == NULL) )
+    {
+        fprintf(stderr, "policy did not start: %u\n", (unsigned)result);
+        return 1;
+    }
+    sample_ms = whd_bench_pm_work->period_ms;
+
+    /* Each sample period gets the trace's packets for it, half each way */
+    for (seg = 0; seg < num_segments; seg++)
+    {
+        for (t = 0; t < whd_bench_pm_trace[seg].duration_ms; t += sample_ms)
+        {
+            carry += whd_bench_pm_trace[seg].pps * sample_ms;
+            packets = carry / 1000;
+            carry %= 1000;
+            for (i = 0; i < packets; i++)
+            {
+                if ( (i & 1) == 0 )
+                {
+                    WHD_PM_POLICY_TX(whd_driver, whd_bench_pm_trace[seg].queue_depth);
+                }
+                else
+                {
+                    WHD_PM_POLICY_RX(whd_driver);
+                }
+            }
+            whd_bench_pm_now_ms += sample_ms;
+            whd_bench_pm_work->work_func(whd_bench_pm_work->arg);
+        }
+    }
+
+    (void)whd_pm_policy_get_stats(whd_driver, &stats);
+    (void)whd_pm_policy_stop(whd_driver);
+
+    printf("{\n  \"suite\": \"whd_pm_policy\",\n  \"trace\": \"%s\",\n", (path != NULL) ? path : "built-in");
+    printf("  \"duration_ms\": %u,\n  \"sample_ms\": %u,\n  \"samples\": %u,\n  \"transitions\": %u,\n",
+           (unsigned)whd_bench_pm_now_ms, (unsigned)sample_ms, (unsigned)stats.samples,
+           (unsigned)stats.transitions);
+    printf("  \"pm_ioctls\": %u,\n  \"apply_failed\": %u,\n  \"levels\": [\n", (unsigned)whd_bench_pm_ioctls,
+           (unsigned)stats.apply_failed);
+    for (i = 0; i < WHD_PM_POLICY_MAX_LEVELS; i++)
+    {
+        if ( (stats.entered[i] == 0) && (stats.time_in_level_ms[i] == 0) )
+        {
+            continue;
+        }
+        printf("%s    { \"level\": %u, \"entered\": %u, \"time_ms\": %u }", sep, (unsigned)i,
+               (unsigned)stats.entered[i], (unsigned)stats.time_in_level_ms[i]);
+        sep = ",\n";
+    }
+    printf("\n  ],\n  \"changes\": [\n");
+    for (i = 0; i < whd_bench_pm_num_changes; i++)
+    {
+        printf("    { \"time_ms\": %u, \"mode\": \"%s\", \"sleep_ret_ms\": %u }%s\n",
+               (unsigned)whd_bench_pm_changes[i].time_ms, mode_name[whd_bench_pm_changes[i].pm_mode],
+               (unsigned)whd_bench_pm_changes[i].sleep_ret_ms, (i + 1 < whd_bench_pm_num_changes) ? "," : "");
+    }
+    printf("  ]\n}\n");
+
+    whd_pm_policy_deinit(whd_driver);
+    return 0;
+}
+
+#endif /* WHD_POSIX */
+
+#endif /* WHD_HOST_BENCH && WHD_BENCH_PM_POLICY */
@@ -0,0 +1,584 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Host port for the WHD microbenchmarks
+ *
+ *  Provides the RTOS, memory, buffer and bus hooks that the protocol sources
+ *  link against. Everything runs on the calling thread, so semaphores only
+ *  track their count and timers never fire.
+ */
+#ifdef WHD_HOST_BENCH
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "cyabs_rtos.h"
+#include "whd_bench.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_buffer_api.h"
+#include "whd_thread.h"
+#include "whd_network_if.h"
+#include "bus_protocols/whd_bus_protocol_interface.h"
+#ifdef PROTO_MSGBUF
+#include "whd_ring.h"
+#include "whd_hw.h"
+#include "cy_network_mw_core.h"
+#endif /* PROTO_MSGBUF */
+
+/******************************************************
+*                    Constants
+******************************************************/
+#define WHD_BENCH_HEAP_MIN_SHIFT     (4)
+#define WHD_BENCH_HEAP_NUM_CLASSES   (17)      /* 16 bytes .. 1 MB */
+#define WHD_BENCH_HEAP_NO_CLASS      (0xFFFFFFFF)
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct whd_bench_block
+{
+    struct whd_bench_block *next_free;
+    uint32_t size_class;
+    uint32_t reserved;
+} whd_bench_block_t;
+
+typedef struct whd_bench_buffer
+{
+    struct whd_bench_buffer *next_free;
+    uint16_t offset;
+    uint16_t size;
+    uint8_t data[WHD_BENCH_BUFFER_HEADROOM + WHD_BENCH_BUFFER_SIZE];
+} whd_bench_buffer_t;
+
+/******************************************************
+*               Variable Definitions
+******************************************************/
+static uint8_t *heap_base;
+static size_t heap_offset;
+static whd_bench_block_t *heap_free_list[WHD_BENCH_HEAP_NUM_CLASSES];
+
+static whd_bench_buffer_t *buffer_free_list;
+static uint32_t buffers_in_use;
+
+static whd_bool_t bus_flow_controlled = WHD_FALSE;
+static const uint32_t *bench_clock_ms = NULL;
+
+/******************************************************
+*             Memory
+******************************************************/
+
+static uint32_t whd_bench_size_class(size_t size)
+{
+    uint32_t size_class = 0;
+
+    while ( ( (size_t)1 << (size_class + WHD_BENCH_HEAP_MIN_SHIFT) ) < size )
+    {
+        size_class++;
+    }
+    return (size_class < WHD_BENCH_HEAP_NUM_CLASSES) ? size_class : WHD_BENCH_HEAP_NO_CLASS;
+}
+
+void *whd_mem_malloc(size_t size)
+{
+    whd_bench_block_t *block;
+    uint32_t size_class = whd_bench_size_class(size);
+    size_t block_size;
+
+    if ( (size_class != WHD_BENCH_HEAP_NO_CLASS) && (heap_free_list[size_class] != NULL) )
+    {
+        block = heap_free_list[size_class];
+        heap_free_list[size_class] = block->next_free;
+        return &block[1];
+    }
+
+    block_size = (size_class != WHD_BENCH_HEAP_NO_CLASS) ?
+                 ( (size_t)1 << (size_class + WHD_BENCH_HEAP_MIN_SHIFT) ) : ( (size + 15) & ~(size_t)15 );
+    block_size += sizeof(whd_bench_block_t);
+    if ( (heap_base == NULL) || (heap_offset + block_size > WHD_BENCH_HEAP_SIZE) )
+    {
+        return NULL;
+    }
+
+    block = (whd_bench_block_t *)(heap_base + heap_offset);
+    heap_offset += block_size;
+    block->next_free = NULL;
+    block->size_class = size_class;
+    return &block[1];
+}
+
+void *whd_mem_calloc(size_t nitems, size_t size)
+{
+    void *ptr = whd_mem_malloc(nitems * size);
+
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, nitems * size);
+    }
+    return ptr;
+}
+
+void whd_mem_free(void *ptr)
+{
+    whd_bench_block_t *block;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    /* Oversized blocks are not recycled; they are only used during setup */
+    block = (whd_bench_block_t *)ptr - 1;
+    if (block->size_class != WHD_BENCH_HEAP_NO_CLASS)
+    {
+        block->next_free = heap_free_list[block->size_class];
+        heap_free_list[block->size_class] = block;
+    }
+}
+
+void whd_mem_memcpy(void *dest, const void *src, size_t len)
+{
+    memcpy(dest, src, len);
+}
+
+void whd_mem_memset(void *buf, int val, size_t len)
+{
+    memset(buf, val, len);
+}
+
+/******************************************************
+*             Packet buffers
+******************************************************/
+
+static whd_result_t whd_bench_host_buffer_get(whd_buffer_t *buffer, whd_buffer_dir_t direction, uint16_t size,
+                                              uint32_t timeout_ms)
+{
+    whd_bench_buffer_t *buf = buffer_free_list;
+
+    (void)direction;
+    (void)timeout_ms;
+
+    if ( (buf == NULL) || (size > WHD_BENCH_BUFFER_SIZE) )
+    {
+        *buffer = NULL;
+        return WHD_BUFFER_UNAVAILABLE_PERMANENT;
+    }
+
+    buffer_free_list = buf->next_free;
+    buf->next_free = NULL;
+    buf->offset = WHD_BENCH_BUFFER_HEADROOM;
+    buf->size = size;
+    buffers_in_use++;
+
+    *buffer = buf;
+    return WHD_SUCCESS;
+}
+
+static void whd_bench_buffer_release(whd_buffer_t buffer, whd_buffer_dir_t direction)
+{
+    whd_bench_buffer_t *buf = (whd_bench_buffer_t *)buffer;
+
+    (void)direction;
+
+    buf->next_free = buffer_free_list;
+    buffer_free_list = buf;
+    buffers_in_use--;
+}
+
+static uint8_t *whd_bench_buffer_get_current_piece_data_pointer(whd_buffer_t buffer)
+{
+    whd_bench_buffer_t *buf = (whd_bench_buffer_t *)buffer;
+
+    return &buf->data[buf->offset];
+}
+
+static uint16_t whd_bench_buffer_get_current_piece_size(whd_buffer_t buffer)
+{
+    return ( (whd_bench_buffer_t *)buffer )->size;
+}
+
+static whd_result_t whd_bench_buffer_set_size(whd_buffer_t buffer, uint16_t size)
+{
+    whd_bench_buffer_t *buf = (whd_bench_buffer_t *)buffer;
+
+    if (buf->offset + size > sizeof(buf->data) )
+    {
+        return WHD_BUFFER_SIZE_SET_ERROR;
+    }
+    buf->size = size;
+    return WHD_SUCCESS;
+}
+
+static whd_result_t whd_bench_buffer_add_remove_at_front(whd_buffer_t *buffer, int32_t add_remove_amount)
+{
+    whd_bench_buffer_t *buf = (whd_bench_buffer_t *)*buffer;
+    int32_t offset = (int32_t)buf->offset + add_remove_amount;
+
+    if ( (offset < 0) || (offset > (int32_t)(buf->offset + buf->size) ) )
+    {
+        return WHD_BUFFER_POINTER_MOVE_ERROR;
+    }
+    buf->offset = (uint16_t)offset;
+    buf->size = (uint16_t)(buf->size - add_remove_amount);
+    return WHD_SUCCESS;
+}
+
+whd_buffer_funcs_t whd_bench_buffer_funcs =
+{
+    .whd_host_buffer_get = whd_bench_host_buffer_get,
+    .whd_buffer_release = whd_bench_buffer_release,
+    .whd_buffer_get_current_piece_data_pointer = whd_bench_buffer_get_current_piece_data_pointer,
+    .whd_buffer_get_current_piece_size = whd_bench_buffer_get_current_piece_size,
+    .whd_buffer_set_size = whd_bench_buffer_set_size,
+    .whd_buffer_add_remove_at_front = whd_bench_buffer_add_remove_at_front,
+};
+
+uint32_t whd_bench_buffers_in_use(void)
+{
+    return buffers_in_use;
+}
+
+int whd_bench_port_init(void)
+{
+    whd_bench_buffer_t *buf;
+    uint32_t i;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_32BIT
+    flags |= MAP_32BIT;
+#endif
+    heap_base = mmap(NULL, WHD_BENCH_HEAP_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (heap_base == MAP_FAILED)
+    {
+        heap_base = NULL;
+        return -1;
+    }
+    heap_offset = 0;
+
+    for (i = 0; i < WHD_BENCH_NUM_BUFFERS; i++)
+    {
+        buf = whd_mem_malloc(sizeof(*buf) );
+        if (buf == NULL)
+        {
+            return -1;
+        }
+        buf->next_free = buffer_free_list;
+        buffer_free_list = buf;
+    }
+    buffers_in_use = 0;
+
+    return 0;
+}
+
+void whd_bench_set_clock_ms(const uint32_t *clock_ms)
+{
+    bench_clock_ms = clock_ms;
+}
+
+uint64_t whd_bench_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/******************************************************
+*             RTOS
+******************************************************/
+
+/* Built with WHD_POSIX the real pthreads port in External/rtos/COMPONENT_POSIX is linked instead */
+#ifndef WHD_POSIX
+cy_rslt_t cy_rtos_semaphore_init(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount)
+{
+    semaphore->count = initcount;
+    semaphore->maxcount = maxcount;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_semaphore_get(cy_semaphore_t *semaphore, cy_time_t timeout_ms)
+{
+    (void)timeout_ms;
+
+    /* Nothing else can give the semaphore, so an empty one would block forever */
+    if (semaphore->count == 0)
+    {
+        return CY_RTOS_TIMEOUT;
+    }
+    semaphore->count--;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_semaphore_set(cy_semaphore_t *semaphore)
+{
+    if (semaphore->count < semaphore->maxcount)
+    {
+        semaphore->count++;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_semaphore_get_count(cy_semaphore_t *semaphore, size_t *count)
+{
+    *count = semaphore->count;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_semaphore_deinit(cy_semaphore_t *semaphore)
+{
+    semaphore->count = 0;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_mutex_init(cy_mutex_t *mutex, bool recursive)
+{
+    mutex->lock_count = 0;
+    mutex->is_recursive = recursive;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_mutex_get(cy_mutex_t *mutex, cy_time_t timeout_ms)
+{
+    (void)timeout_ms;
+
+    /* Single threaded, a held mutex can only be released by its owner */
+    if ( (mutex->lock_count != 0) && !mutex->is_recursive )
+    {
+        return CY_RTOS_TIMEOUT;
+    }
+    mutex->lock_count++;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_mutex_set(cy_mutex_t *mutex)
+{
+    if (mutex->lock_count == 0)
+    {
+        return CY_RTOS_GENERAL_ERROR;
+    }
+    mutex->lock_count--;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_mutex_deinit(cy_mutex_t *mutex)
+{
+    mutex->lock_count = 0;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_scheduler_suspend(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_scheduler_resume(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_time_get(cy_time_t *tval)
+{
+    if (bench_clock_ms != NULL)
+    {
+        *tval = (cy_time_t)*bench_clock_ms;
+        return CY_RSLT_SUCCESS;
+    }
+    *tval = (cy_time_t)(whd_bench_time_ns() / 1000000ULL);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    struct timespec ts = { .tv_sec = num_ms / 1000, .tv_nsec = (long)(num_ms % 1000) * 1000000L };
+
+    nanosleep(&ts, NULL);
+    return CY_RSLT_SUCCESS;
+}
+
+/* Threads run to completion inside create; the WHD thread returns once its
+ * quit flag is set, which the replay bus does at the end of a trace */
+cy_rslt_t cy_rtos_thread_create(cy_thread_t *thread, cy_thread_entry_fn_t entry_function, const char *name,
+                                void *stack, uint32_t stack_size, cy_thread_priority_t priority, cy_thread_arg_t arg)
+{
+    (void)name;
+    (void)stack;
+    (void)stack_size;
+    (void)priority;
+    *thread = (cy_thread_t)entry_function;
+    entry_function(arg);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_thread_exit(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_thread_join(cy_thread_t *thread)
+{
+    (void)thread;
+    return CY_RSLT_SUCCESS;
+}
+
+/* There is only ever the calling thread */
+cy_rslt_t cy_rtos_thread_get_handle(cy_thread_t *thread)
+{
+    *thread = NULL;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_timer_init(cy_timer_t *timer, cy_timer_trigger_type_t type,
+                             cy_timer_callback_t fun, cy_timer_callback_arg_t arg)
+{
+    (void)type;
+    (void)fun;
+    (void)arg;
+    timer->running = false;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_timer_start(cy_timer_t *timer, cy_time_t num_ms)
+{
+    (void)num_ms;
+    timer->running = true;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_timer_stop(cy_timer_t *timer)
+{
+    timer->running = false;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_timer_is_running(cy_timer_t *timer, bool *state)
+{
+    *state = timer->running;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_timer_deinit(cy_timer_t *timer)
+{
+    timer->running = false;
+    return CY_RSLT_SUCCESS;
+}
+
+#endif /* WHD_POSIX */
+
+/******************************************************
+*             Bus, thread and network hooks
+******************************************************/
+
+void whd_bench_set_flow_controlled(whd_bool_t state)
+{
+    bus_flow_controlled = state;
+}
+
+whd_bool_t whd_bus_is_flow_controlled(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+    return bus_flow_controlled;
+}
+
+whd_result_t whd_bus_set_flow_control(whd_driver_t whd_driver, uint8_t value)
+{
+    (void)whd_driver;
+    bus_flow_controlled = (value != 0) ? WHD_TRUE : WHD_FALSE;
+    return WHD_SUCCESS;
+}
+
+#ifndef WHD_BENCH_REPLAY
+void whd_thread_notify(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+}
+
+#endif /* WHD_BENCH_REPLAY */
+
+whd_result_t whd_network_process_ethernet_data(whd_interface_t ifp, whd_buffer_t buffer)
+{
+    return whd_buffer_release(ifp->whd_driver, buffer, WHD_NETWORK_RX);
+}
+
+whd_result_t whd_network_process_ethernet_data_ext(whd_interface_t ifp, whd_buffer_t buffer, uint32_t rx_flags)
+{
+    (void)rx_flags;
+    return whd_buffer_release(ifp->whd_driver, buffer, WHD_NETWORK_RX);
+}
+
+void whd_network_tx_flow_control(whd_driver_t whd_driver, uint8_t bsscfgidx, whd_bool_t stop)
+{
+    (void)whd_driver;
+    (void)bsscfgidx;
+    (void)stop;
+}
+
+void whd_network_rx_round_end(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+}
+
+#ifdef PROTO_MSGBUF
+whd_interface_t whd_get_interface(whd_driver_t whd_driver, uint8_t ifidx)
+{
+    return (ifidx < WHD_INTERFACE_MAX) ? whd_driver->iflist[ifidx] : NULL;
+}
+
+void whd_bus_handle_mb_data(whd_driver_t whd_driver, uint32_t d2h_mb_data)
+{
+    (void)whd_driver;
+    (void)d2h_mb_data;
+}
+
+void whd_delayed_bus_release_schedule_update(whd_driver_t whd_driver, whd_bool_t is_scheduled)
+{
+    (void)whd_driver;
+    (void)is_scheduled;
+}
+
+void *whd_hw_allocatePermanentApi(uint32_t size)
+{
+    return whd_mem_malloc(size);
+}
+
+bool whd_hw_openDeviceAccessApi(whd_hw_device_t device, void *base, uint32_t size, uint32_t flags)
+{
+    (void)device;
+    (void)base;
+    (void)size;
+    (void)flags;
+    return true;
+}
+
+uint32_t whd_hw_generateBt2WlDbInterruptApi(uint32_t db_num, uint32_t value)
+{
+    (void)db_num;
+    (void)value;
+    return 0;
+}
+
+void cy_network_get_packet_pool_info(cy_network_packet_type_t type, cy_network_packet_pool_info_t *info)
+{
+    (void)type;
+    info->free_packets = WHD_BENCH_NUM_BUFFERS - buffers_in_use;
+}
+#endif /* PROTO_MSGBUF */
+
+#endif /* WHD_HOST_BENCH */
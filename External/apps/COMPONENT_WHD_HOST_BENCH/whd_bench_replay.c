@@ -0,0 +1,203 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Replays a recorded bus trace through the WHD thread on the host
+ *
+ *  The trace replaces the bus, and whd_thread_init() runs the real WHD thread
+ *  loop, SDPCM and CDC/BDC code against it until the trace is consumed. The
+ *  result is printed as one JSON document. See README.md for the build line.
+ */
+#if defined(WHD_HOST_BENCH) && defined(WHD_BENCH_REPLAY)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "whd_bench.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_proto.h"
+#include "whd_thread.h"
+#include "whd_cdc_bdc.h"
+#include "whd_events_int.h"
+#include "bus_protocols/whd_bus_trace.h"
+
+#define WHD_BENCH_THREAD_STACK_SIZE (16 * 1024)
+
+#ifdef PROTO_MSGBUF
+#error "Bus replay needs the SDPCM build: msgbuf moves its data through shared memory, not the bus"
+#endif /* PROTO_MSGBUF */
+
+/******************************************************
+*             Driver hooks outside the replayed sources
+******************************************************/
+
+whd_result_t whd_ensure_wlan_bus_is_up(whd_driver_t whd_driver)
+{
+    (void)whd_driver;
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_set_error_handler_locally(whd_driver_t whd_driver, const uint8_t *error_nums,
+                                           whd_error_handler_t handler_func,
+                                           void *handler_user_data, uint16_t *error_index)
+{
+    (void)whd_driver;
+    (void)error_nums;
+    (void)handler_func;
+    (void)handler_user_data;
+    (void)error_index;
+    return WHD_SUCCESS;
+}
+
+/******************************************************
+*             Replay
+******************************************************/
+
+static uint8_t *whd_bench_load(const char *path, uint32_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long size;
+
+    if (f == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    if ( (fseek(f, 0, SEEK_END) == 0) && ( (size = ftell(f) ) > 0 ) && (fseek(f, 0, SEEK_SET) == 0) )
+    {
+        data = malloc( (size_t)size );
+        if ( (data != NULL) && (fread(data, 1, (size_t)size, f) != (size_t)size) )
+        {
+            free(data);
+            data = NULL;
+        }
+        *len = (uint32_t)size;
+    }
+    fclose(f);
+    return data;
+}
+
+static void whd_bench_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-t] trace.bin\n"
+            "  -t  keep the recorded timing between bus calls\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    struct whd_driver *whd_driver;
+    struct whd_interface *ifp;
+    struct whd_proto *proto;
+    whd_bus_trace_stats_t stats;
+    uint32_t flags = WHD_BUS_TRACE_REPLAY_QUIT_AT_END;
+    const char *path = NULL;
+    uint8_t *trace;
+    uint32_t len = 0;
+    uint64_t start, elapsed;
+    int32_t leaked;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0)
+        {
+            flags |= WHD_BUS_TRACE_REPLAY_TIMED;
+        }
+        else if ( (argv[i][0] != '-') && (path == NULL) )
+        {
+            path = argv[i];
+        }
+        else
+        {
+            whd_bench_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (path == NULL)
+    {
+        whd_bench_usage(argv[0]);
+        return 2;
+    }
+
+    trace = whd_bench_load(path, &len);
+    if (trace == NULL)
+    {
+        return 1;
+    }
+    if (whd_bench_port_init() != 0)
+    {
+        fprintf(stderr, "failed to set up the benchmark heap\n");
+        return 1;
+    }
+
+    whd_driver = whd_mem_calloc(1, sizeof(*whd_driver) );
+    ifp = whd_mem_calloc(1, sizeof(*ifp) );
+    proto = whd_mem_calloc(1, sizeof(*proto) );
+    if ( (whd_driver == NULL) || (ifp == NULL) || (proto == NULL) )
+    {
+        return 1;
+    }
+    whd_driver->buffer_if = &whd_bench_buffer_funcs;
+    whd_driver->aligned_addr = whd_mem_malloc(WHD_LINK_MTU);
+    whd_driver->proto = proto;
+    whd_driver->internal_info.whd_wlan_status.state = WLAN_UP;
+    whd_driver->thread_info.thread_stack_size = WHD_BENCH_THREAD_STACK_SIZE;
+    whd_driver->thread_info.thread_priority = CY_RTOS_PRIORITY_HIGH;
+    ifp->whd_driver = whd_driver;
+    whd_driver->iflist[0] = ifp;
+
+    if ( (whd_cdc_bdc_info_init(whd_driver) != WHD_SUCCESS) ||
+         (whd_bus_trace_replay_start(whd_driver, trace, len, flags) != WHD_SUCCESS) )
+    {
+        fprintf(stderr, "%s: not a usable SDPCM bus trace\n", path);
+        return 1;
+    }
+
+    /* Runs the WHD thread loop to the end of the trace */
+    start = whd_bench_time_ns();
+    if (whd_thread_init(whd_driver) != WHD_SUCCESS)
+    {
+        fprintf(stderr, "WHD thread failed to start\n");
+        return 1;
+    }
+    /* Returns at once with the inline thread; waits for the real one under WHD_POSIX */
+    (void)cy_rtos_join_thread(&whd_driver->thread_info.whd_thread);
+    elapsed = whd_bench_time_ns() - start;
+
+    (void)whd_bus_trace_get_stats(whd_driver, &stats);
+    (void)whd_bus_trace_replay_stop(whd_driver);
+    leaked = (int32_t)whd_bench_buffers_in_use();
+
+    printf("{\n  \"suite\": \"whd_bus_replay\",\n  \"trace\": \"%s\",\n", path);
+    printf("  \"records\": %u,\n  \"bytes\": %u,\n  \"frames\": %u,\n", (unsigned)stats.records,
+           (unsigned)stats.bytes, (unsigned)stats.frames);
+    printf("  \"skipped\": %u,\n  \"mismatches\": %u,\n  \"rx_no_buffer\": %u,\n", (unsigned)stats.skipped,
+           (unsigned)stats.mismatches, (unsigned)stats.rx_no_buffer);
+    printf("  \"rx_total\": %u,\n  \"tx_total\": %u,\n", (unsigned)whd_driver->whd_stats.rx_total,
+           (unsigned)whd_driver->whd_stats.tx_total);
+    printf("  \"elapsed_ns\": %llu,\n  \"ns_per_frame\": %.1f,\n", (unsigned long long)elapsed,
+           (stats.frames != 0) ? (double)elapsed / stats.frames : 0.0);
+    printf("  \"buffers_leaked\": %d\n}\n", (int)leaked);
+
+    free(trace);
+    return (leaked != 0) ? 1 : 0;
+}
+
+#endif /* defined(WHD_HOST_BENCH) && defined(WHD_BENCH_REPLAY) */
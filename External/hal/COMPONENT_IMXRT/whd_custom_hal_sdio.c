@@ -57,6 +57,10 @@ extern uint16_t whd_host_buffer_get_current_piece_size(whd_buffer_t buffer);
 extern whd_result_t whd_host_buffer_set_size(whd_buffer_t buffer, uint16_t size);
 extern whd_result_t whd_host_buffer_add_remove_at_front(whd_buffer_t* buffer, int32_t add_remove_amount);
 extern void whd_host_network_process_ethernet_data(whd_interface_t interface, whd_buffer_t buffer);
+#ifdef WHD_NETWORK_RX_CSUM_GOOD
+extern void whd_host_network_process_ethernet_data_ext(whd_interface_t interface, whd_buffer_t buffer, uint32_t rx_flags);
+extern void whd_host_network_rx_round_end(whd_interface_t interface);
+#endif
 
 static whd_init_config_t init_config_default =
 {
@@ -79,6 +83,10 @@ static whd_buffer_funcs_t buffer_if_default =
 static whd_netif_funcs_t netif_if_default =
 {
     .whd_network_process_ethernet_data = whd_host_network_process_ethernet_data,
+#ifdef WHD_NETWORK_RX_CSUM_GOOD
+    .whd_network_process_ethernet_data_ext = whd_host_network_process_ethernet_data_ext,
+    .whd_network_rx_round_end = whd_host_network_rx_round_end,
+#endif
 };
 
 #if !defined(COMPONENT_WIFI_INTERFACE_M2M)
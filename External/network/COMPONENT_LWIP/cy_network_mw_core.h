@@ -48,6 +48,9 @@
 #include "cy_result.h"
 #include "cy_nw_helper.h"
 #include "whd.h"
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+#include "cy_worker_thread.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -162,6 +165,12 @@ typedef enum
 
 #define CY_MAC_ADDR_LEN                        (6U)         /**< MAC address length */
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+#define CY_NETWORK_OFFLOAD_SYNC_ARP_HOSTIP     (1U << 0)    /**< IPv4 address in the ARP offload agent host IP list (arp_hostip) */
+#define CY_NETWORK_OFFLOAD_SYNC_INET_V4        (1U << 1)    /**< IPv4 address in the offload manager table (ol_inet_v4)        */
+#define CY_NETWORK_OFFLOAD_SYNC_INET_V6        (1U << 2)    /**< Valid IPv6 addresses in the offload manager table, for ND offload */
+#endif /* WHD_NETWORK_OFFLOAD_SYNC */
+
 /** \} group_lwip_network_interface_integration_macros */
 
 /**
@@ -227,6 +236,42 @@ typedef struct whd_network_static_ip_addr
     whd_nw_ip_address_t gateway; /**< Default gateway for network traffic */
 } whd_network_static_ip_addr_t;
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+/**
+ * Offload address synchronisation counters
+ */
+typedef struct
+{
+    uint32_t syncs;                 /**< Address checks run after a netif change */
+    uint32_t unchanged;             /**< Checks that found the firmware tables already up to date */
+    uint32_t updates;               /**< Offload table update requests sent to the firmware */
+    uint32_t updates_saved;         /**< Requests a clear and full re-add on every check would have sent on top */
+    uint32_t failures;              /**< Update requests that failed; they are retried on the next check */
+    uint32_t ipv4_entries;          /**< IPv4 table entries programmed now */
+    uint32_t ipv6_entries;          /**< IPv6 table entries programmed now */
+    uint32_t arp_replies_offloaded; /**< ARP requests answered by the firmware since the sync started, i.e. host wakeups avoided */
+} whd_network_offload_sync_stats_t;
+#endif /* WHD_NETWORK_OFFLOAD_SYNC */
+
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+/**
+ * Checksum offload state and counters of a Wi-Fi interface
+ */
+typedef struct
+{
+    uint32_t toe_ol;                /**< Checksums the firmware makes, TOE_TX_CSUM_OL and TOE_RX_CSUM_OL bits */
+    uint32_t tx_firmware;           /**< TCP frames sent for the firmware to checksum */
+    uint32_t tx_on_copy;            /**< TCP frames checksummed by the host while copied for WHD */
+    uint32_t rx_firmware;           /**< TCP frames received with the checksum checked by the firmware */
+    uint32_t rx_verified;           /**< TCP frames received whose checksum the host checked before lwIP */
+    uint32_t rx_bad;                /**< TCP frames dropped for a bad checksum, or because it could not be checked (IP fragments) */
+#ifdef WHD_NETWORK_GRO
+    uint32_t gro_merged;            /**< TCP segments merged into one received before them */
+    uint32_t gro_chains;            /**< Segments with others merged into them passed to lwIP */
+#endif
+} whd_network_csum_offload_stats_t;
+#endif /* WHD_NETWORK_CSUM_OFFLOAD */
+
 /** \} group_lwip_network_interface_integration_structures */
 
 /**
@@ -318,6 +363,18 @@ cy_rslt_t whd_network_ip_down(whd_network_interface_context *iface_context);
  */
 cy_rslt_t whd_network_dhcp_renew(whd_network_interface_context *iface_context);
 
+/**
+ * Gets the stack use of the DHCP server thread started for the AP interface by \ref whd_network_ip_up
+ *
+ * The RTOS port has to track stack use for this to succeed (see CY_RTOS_HIGH_WATER in cyabs_rtos.h).
+ *
+ * @param[out] stack_size     Size of the thread stack in bytes
+ * @param[out] max_used       Deepest stack use seen so far in bytes
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise, also while the server is not running.
+ */
+cy_rslt_t whd_network_dhcp_server_get_stack_usage(uint32_t *stack_size, uint32_t *max_used);
+
 /**
  * IP change callback function prototype
  * Callback function which can be registered to receive IP address changes
@@ -454,6 +511,75 @@ cy_rslt_t whd_network_up(whd_interface_t interface, whd_network_hw_interface_typ
  */
 void whd_network_down(whd_interface_t interface, whd_network_hw_interface_type_t iface_type);
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+/**
+ * Keeps the firmware ARP and ND offload address tables in step with the lwIP addresses of an interface
+ *
+ * Any address change on the netif schedules a check on the worker thread, which compares the
+ * current addresses with what it last programmed and sends only the additions and removals.
+ * Taking the interface down with \ref whd_network_ip_down removes the entries. While the sync
+ * runs, the application should not edit the tables it manages itself.
+ *
+ * @param[in] iface_context   Wi-Fi interface context created with \ref whd_network_add_nw_interface
+ * @param[in] tables          CY_NETWORK_OFFLOAD_SYNC_* tables to manage
+ * @param[in] worker          Worker thread that issues the iovars; they cannot be sent from the lwIP thread
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_network_offload_sync_start(whd_network_interface_context *iface_context, uint32_t tables, cy_worker_thread_info_t *worker);
+
+/**
+ * Stops the offload address synchronisation and removes the entries it programmed
+ *
+ * @param[in] iface_context   Interface context passed to \ref whd_network_offload_sync_start
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if the sync is not running.
+ */
+cy_rslt_t whd_network_offload_sync_stop(whd_network_interface_context *iface_context);
+
+/**
+ * Gets the offload address synchronisation counters
+ *
+ * Reads the firmware ARP offload statistics when the ARP host IP list is managed. The firmware
+ * has no matching counter for ND offload.
+ *
+ * @param[in]  iface_context  Interface context passed to \ref whd_network_offload_sync_start
+ * @param[out] stats          Receives the counters
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if the sync is not running.
+ */
+cy_rslt_t whd_network_offload_sync_get_stats(whd_network_interface_context *iface_context, whd_network_offload_sync_stats_t *stats);
+#endif /* WHD_NETWORK_OFFLOAD_SYNC */
+
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+/**
+ * Gets the checksum offload state and counters of a Wi-Fi interface
+ *
+ * With WHD_NETWORK_CSUM_OFFLOAD, lwIP does not make the TCP checksums of the Wi-Fi interfaces
+ * (LWIP_CHECKSUM_CTRL_PER_NETIF must be enabled). When the interface is added, the firmware TCP/IP
+ * offload engine is enabled for transmit checksums if the firmware has one. IPv4 TCP frames are
+ * then checksummed by the firmware. Otherwise, and for IPv6, the host makes the checksum while it
+ * copies the frame for WHD.
+ *
+ * The firmware is also asked to check received checksums. When it does, lwIP stops checking the
+ * TCP checksums of the interface. TCP frames that WHD does not report with WHD_NETWORK_RX_CSUM_GOOD
+ * are then checked by the host before they are passed to lwIP, and dropped if bad. IP fragments
+ * of TCP segments cannot be checked and are dropped too. The rx_* counters stay at 0 while lwIP
+ * checks the checksums.
+ *
+ * With WHD_NETWORK_GRO as well, the host always checks received TCP checksums. The in-order TCP
+ * segments of a flow received in one WHD receive round are merged, up to WHD_NETWORK_GRO_MAX_SEGS
+ * (8 by default), and passed to lwIP as one segment. lwIP then acknowledges fewer segments.
+ * Merging needs WHD to call whd_host_network_rx_round_end() and cannot be used with IP forwarding.
+ *
+ * @param[in]  iface_context  Wi-Fi interface context created with \ref whd_network_add_nw_interface
+ * @param[out] stats          Receives the state and counters
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG for a bad argument or an Ethernet interface.
+ */
+cy_rslt_t whd_network_csum_offload_get_stats(whd_network_interface_context *iface_context, whd_network_csum_offload_stats_t *stats);
+#endif /* WHD_NETWORK_CSUM_OFFLOAD */
+
 /** \} group_lwip_network_interface_integration_functions */
 
 
@@ -74,10 +74,6 @@
 #define ULONG_MAX_STR                           "4294967295"
 #define ULONG_MIN_STR                           "0000000000"
 
-#ifndef DHCP_IP_ADDRESS_CACHE_MAX
-#define DHCP_IP_ADDRESS_CACHE_MAX               (5)
-#endif
-
 #define DHCP_SERVER_RECEIVE_TIMEOUT             (500)
 #define ALLOCATE_PACKET_TIMEOUT                 (2000)
 
@@ -126,7 +122,6 @@ static const uint8_t lease_time_option_buff[]      = { DHCP_LEASETIME_OPTION_COD
 static const uint8_t dhcp_magic_cookie[]           = { 0x63, 0x82, 0x53, 0x63 };
 static const cy_lwip_mac_addr_t empty_cache        = { .octet = {0} };
 typedef struct netbuf cy_lwip_packet_t;
-static cy_mutex_t dhcp_mutex;
 
 /******************************************************
  *                   Enumerations
@@ -166,8 +161,8 @@ typedef struct
  ******************************************************/
 
 static const uint8_t* find_option (const dhcp_header_t* request, uint8_t option_num);
-static bool get_client_ip_address_from_cache (const cy_lwip_mac_addr_t* client_mac_address, cy_lwip_ip_address_t* client_ip_address);
-static cy_rslt_t add_client_to_cache (const cy_lwip_mac_addr_t* client_mac_address, const cy_lwip_ip_address_t* client_ip_address);
+static bool get_client_ip_address_from_cache (cy_lwip_dhcp_server_t* server, const cy_lwip_mac_addr_t* client_mac_address, cy_lwip_ip_address_t* client_ip_address);
+static cy_rslt_t add_client_to_cache (cy_lwip_dhcp_server_t* server, const cy_lwip_mac_addr_t* client_mac_address, const cy_lwip_ip_address_t* client_ip_address);
 static void ipv4_to_string (char* buffer, uint32_t ipv4_address);
 static void cy_dhcp_thread_func (cy_thread_arg_t thread_input);
 static cy_rslt_t udp_create_socket(cy_lwip_udp_socket_t *socket, uint16_t port, whd_network_interface_context *iface_context);
@@ -178,18 +173,14 @@ static cy_rslt_t packet_set_data_end(cy_lwip_packet_t *packet, uint8_t* data_end
 static cy_rslt_t packet_delete(cy_lwip_packet_t* packet);
 static cy_rslt_t packet_create_udp(cy_lwip_packet_t** packet, uint8_t** data, uint16_t* available_space);
 static cy_rslt_t internal_packet_create(cy_lwip_packet_t** packet, uint16_t content_length, uint8_t** data, uint16_t* available_space);
-static cy_rslt_t cy_udp_send(cy_lwip_udp_socket_t* socket, const cy_lwip_ip_address_t* address, uint16_t port, cy_lwip_packet_t* packet);
-static cy_rslt_t internal_udp_send(struct netconn* handler, cy_lwip_packet_t* packet, whd_network_hw_interface_type_t type, uint8_t index);
+static cy_rslt_t cy_udp_send(cy_lwip_dhcp_server_t* server, const cy_lwip_ip_address_t* address, uint16_t port, cy_lwip_packet_t* packet);
+static cy_rslt_t internal_udp_send(cy_mutex_t* mutex, struct netconn* handler, cy_lwip_packet_t* packet, whd_network_hw_interface_type_t type, uint8_t index);
 static void cy_ip_to_lwip(ip_addr_t *dest, const cy_lwip_ip_address_t *src);
 
 /******************************************************
  *               Variable Definitions
  ******************************************************/
 
-static cy_lwip_mac_addr_t             cached_mac_addresses[DHCP_IP_ADDRESS_CACHE_MAX];
-static cy_lwip_ip_address_t           cached_ip_addresses [DHCP_IP_ADDRESS_CACHE_MAX];
-static struct netif *net_interface    = NULL;
-static bool is_dhcp_server_started    = false;
 /******************************************************
  *               Function Definitions
  ******************************************************/
@@ -203,18 +194,18 @@ cy_rslt_t whd_lwip_dhcp_server_start(cy_lwip_dhcp_server_t* server, whd_network_
     cy_rslt_t result;
 
     WPRINT_WHD_DEBUG(("%s(): START \n", __FUNCTION__ ));
-    if(is_dhcp_server_started)
-    {
-        return CY_RSLT_SUCCESS;
-    }
-
     if((server == NULL) || (iface_context->iface_type != CY_NETWORK_WIFI_AP_INTERFACE))
     {
         WPRINT_WHD_ERROR(("Error DHCP bad arguments. iface_context->iface_type:[%d] \n", iface_context->iface_type));
         return CY_RSLT_NETWORK_BAD_ARG;
     }
 
-    if (cy_rtos_init_mutex(&dhcp_mutex) != CY_RSLT_SUCCESS)
+    if(server->started)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    if (cy_rtos_init_mutex(&server->mutex) != CY_RSLT_SUCCESS)
     {
         WPRINT_WHD_ERROR(("Unable to acquire DHCP mutex \n"));
         return CY_RSLT_NETWORK_DHCP_MUTEX_ERROR;
@@ -228,8 +219,8 @@ cy_rslt_t whd_lwip_dhcp_server_start(cy_lwip_dhcp_server_t* server, whd_network_
     }
 
     /* Clear the cache */
-    memset(cached_mac_addresses, 0, sizeof(cached_mac_addresses));
-    memset(cached_ip_addresses,  0, sizeof(cached_ip_addresses));
+    memset(server->cached_mac_addresses, 0, sizeof(server->cached_mac_addresses));
+    memset(server->cached_ip_addresses,  0, sizeof(server->cached_ip_addresses));
 
     /* Initialize the server quit flag - done here if a quit is requested before the thread runs */
     server->quit = false;
@@ -245,11 +236,11 @@ cy_rslt_t whd_lwip_dhcp_server_start(cy_lwip_dhcp_server_t* server, whd_network_
 exit:
     if(result != CY_RSLT_SUCCESS)
     {
-        cy_rtos_deinit_mutex(&dhcp_mutex);
+        cy_rtos_deinit_mutex(&server->mutex);
     }
     else
     {
-        is_dhcp_server_started = true;
+        server->started = true;
     }
 
     WPRINT_WHD_DEBUG(("%s(): STOP \n", __FUNCTION__ ));
@@ -261,14 +252,14 @@ cy_rslt_t whd_lwip_dhcp_server_stop(cy_lwip_dhcp_server_t* server)
     cy_rslt_t res = CY_RSLT_SUCCESS;
 
     WPRINT_WHD_DEBUG(("%s(): START \n", __FUNCTION__ ));
-    if(!is_dhcp_server_started)
+    if(server == NULL)
     {
-        return CY_RSLT_SUCCESS;
+        return CY_RSLT_NETWORK_BAD_ARG;
     }
 
-    if(server == NULL)
+    if(!server->started)
     {
-        return CY_RSLT_NETWORK_BAD_ARG;
+        return CY_RSLT_SUCCESS;
     }
 
     server->quit = true;
@@ -276,13 +267,28 @@ cy_rslt_t whd_lwip_dhcp_server_stop(cy_lwip_dhcp_server_t* server)
     cy_rtos_join_thread(&server->thread);
     /* Delete DHCP socket */
     res = udp_delete_socket(&server->socket);
-    cy_rtos_deinit_mutex(&dhcp_mutex);
-    is_dhcp_server_started = false;
+    cy_rtos_deinit_mutex(&server->mutex);
+    server->started = false;
 
     WPRINT_WHD_DEBUG(("%s(): STOP \n", __FUNCTION__ ));
     return res;
 }
 
+cy_rslt_t whd_lwip_dhcp_server_get_stack_usage(cy_lwip_dhcp_server_t *server, uint32_t *stack_size, uint32_t *max_used)
+{
+    if((server == NULL) || (stack_size == NULL) || (max_used == NULL))
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    if(!server->started)
+    {
+        return CY_RSLT_NETWORK_ERROR_STARTING_DHCP;
+    }
+
+    return cy_rtos_thread_get_stack_usage(&server->thread, stack_size, max_used);
+}
+
 /**
  *  Implements a very simple DHCP server.
  *
@@ -305,6 +311,7 @@ static void cy_dhcp_thread_func(cy_thread_arg_t thread_input)
     uint32_t                     server_ip_addr_htobe;
     char                         *option_ptr;
     cy_lwip_dhcp_server_t        *server                      = (cy_lwip_dhcp_server_t*)thread_input;
+    struct netif                 *net_interface;
     uint8_t                      subnet_mask_option_buff[]    = { DHCP_SUBNETMASK_OPTION_CODE, 4, 0, 0, 0, 0 };
     uint8_t                      server_ip_addr_option_buff[] = { DHCP_SERVER_IDENTIFIER_OPTION_CODE, 4, 0, 0, 0, 0 };
     uint8_t                      wpad_option_buff[ 2 + sizeof(WPAD_SAMPLE_URL)-1 ] = { DHCP_WPAD_OPTION_CODE, sizeof(WPAD_SAMPLE_URL)-1 };
@@ -421,7 +428,7 @@ static void cy_dhcp_thread_func(cy_thread_arg_t thread_input)
                 memcpy( &client_mac_address, request_header->client_hardware_addr, sizeof( client_mac_address ) );
 
                 /* Check whether the device is already cached */
-                if (!get_client_ip_address_from_cache( &client_mac_address, &client_ip_address ))
+                if (!get_client_ip_address_from_cache( server, &client_mac_address, &client_ip_address ))
                 {
                     /* Address not found in cache. Use the next available IP address */
                     client_ip_address.version = CY_LWIP_IP_VER_V4;
@@ -455,7 +462,7 @@ static void cy_dhcp_thread_func(cy_thread_arg_t thread_input)
 
                 /* Send OFFER reply packet */
                 packet_set_data_end(transmit_packet, (uint8_t*) option_ptr);
-                if (cy_udp_send(&server->socket, &broadcast_addr, IPPORT_DHCPC, transmit_packet) != CY_RSLT_SUCCESS)
+                if (cy_udp_send(server, &broadcast_addr, IPPORT_DHCPC, transmit_packet) != CY_RSLT_SUCCESS)
                 {
                     packet_delete(transmit_packet);
                 }
@@ -522,7 +529,7 @@ static void cy_dhcp_thread_func(cy_thread_arg_t thread_input)
                 option_ptr = (char *) &reply_header->options;
 
                 /* Check if device is cached. If it is, give the previous IP address. Otherwise, give the next available IP address */
-                if ( !get_client_ip_address_from_cache( &client_mac_address, &given_ip_address ) )
+                if ( !get_client_ip_address_from_cache( server, &client_mac_address, &given_ip_address ) )
                 {
                     /* Address not found in cache. Use the next available IP address */
                     next_avail_ip_address_used = true;
@@ -571,7 +578,7 @@ static void cy_dhcp_thread_func(cy_thread_arg_t thread_input)
                     }
 
                     /* Cache the client */
-                    add_client_to_cache( &client_mac_address, &given_ip_address );
+                    add_client_to_cache( server, &client_mac_address, &given_ip_address );
                 }
 
                 option_ptr[0] = (char) DHCP_END_OPTION_CODE; /* End options */
@@ -579,7 +586,7 @@ static void cy_dhcp_thread_func(cy_thread_arg_t thread_input)
 
                 /* Send the reply packet */
                 packet_set_data_end( transmit_packet, (uint8_t*) option_ptr );
-                if (cy_udp_send( &server->socket, &broadcast_addr, IPPORT_DHCPC, transmit_packet ) != CY_RSLT_SUCCESS)
+                if (cy_udp_send( server, &broadcast_addr, IPPORT_DHCPC, transmit_packet ) != CY_RSLT_SUCCESS)
                 {
                     packet_delete( transmit_packet );
                 }
@@ -627,21 +634,22 @@ static const uint8_t* find_option( const dhcp_header_t* request, uint8_t option_
 /**
  *  Searches the cache for a given MAC address to find the matching IP address
  *
+ * @param[in]  server             : DHCP server whose cache is searched
  * @param[in]  client_mac_address : MAC address to search for
  * @param[out] client_ip_address  : Receives any IP address which is found
  *
  * @return true if found; false otherwise
  */
-static bool get_client_ip_address_from_cache( const cy_lwip_mac_addr_t* client_mac_address, cy_lwip_ip_address_t* client_ip_address )
+static bool get_client_ip_address_from_cache( cy_lwip_dhcp_server_t* server, const cy_lwip_mac_addr_t* client_mac_address, cy_lwip_ip_address_t* client_ip_address )
 {
     uint32_t a;
 
     /* Check whether the device is already cached */
     for ( a = 0; a < DHCP_IP_ADDRESS_CACHE_MAX; a++ )
     {
-        if ( memcmp( &cached_mac_addresses[ a ], client_mac_address, sizeof( *client_mac_address ) ) == 0 )
+        if ( memcmp( &server->cached_mac_addresses[ a ], client_mac_address, sizeof( *client_mac_address ) ) == 0 )
         {
-            *client_ip_address = cached_ip_addresses[ a ];
+            *client_ip_address = server->cached_ip_addresses[ a ];
             return true;
         }
     }
@@ -652,12 +660,13 @@ static bool get_client_ip_address_from_cache( const cy_lwip_mac_addr_t* client_m
 /**
  *  Adds the MAC and IP addresses of a client to cache
  *
+ * @param[in] server             : DHCP server whose cache is updated
  * @param[in] client_mac_address : MAC address of the client to store
  * @param[in] client_ip_address  : IP address of the client to store
  *
  * @return CY_RSLT_SUCCESS
  */
-static cy_rslt_t add_client_to_cache( const cy_lwip_mac_addr_t* client_mac_address, const cy_lwip_ip_address_t* client_ip_address )
+static cy_rslt_t add_client_to_cache( cy_lwip_dhcp_server_t* server, const cy_lwip_mac_addr_t* client_mac_address, const cy_lwip_ip_address_t* client_ip_address )
 {
     uint32_t a;
     uint32_t first_empty_slot;
@@ -667,13 +676,13 @@ static cy_rslt_t add_client_to_cache( const cy_lwip_mac_addr_t* client_mac_addre
     for ( a = 0, first_empty_slot = DHCP_IP_ADDRESS_CACHE_MAX, cached_slot = DHCP_IP_ADDRESS_CACHE_MAX; a < DHCP_IP_ADDRESS_CACHE_MAX; a++ )
     {
         /* Check for the matching MAC address */
-        if ( memcmp( &cached_mac_addresses[ a ], client_mac_address, sizeof( *client_mac_address ) ) == 0 )
+        if ( memcmp( &server->cached_mac_addresses[ a ], client_mac_address, sizeof( *client_mac_address ) ) == 0 )
         {
             /* Cached device found */
             cached_slot = a;
             break;
         }
-        else if ( first_empty_slot == DHCP_IP_ADDRESS_CACHE_MAX && memcmp( &cached_mac_addresses[ a ], &empty_cache, sizeof(cy_lwip_mac_addr_t) ) == 0 )
+        else if ( first_empty_slot == DHCP_IP_ADDRESS_CACHE_MAX && memcmp( &server->cached_mac_addresses[ a ], &empty_cache, sizeof(cy_lwip_mac_addr_t) ) == 0 )
         {
             /* Device not found in cache. Return the first empty slot */
             first_empty_slot = a;
@@ -683,19 +692,19 @@ static cy_rslt_t add_client_to_cache( const cy_lwip_mac_addr_t* client_mac_addre
     if ( cached_slot != DHCP_IP_ADDRESS_CACHE_MAX )
     {
         /* Update the IP address of the cached device */
-        cached_ip_addresses[cached_slot] = *client_ip_address;
+        server->cached_ip_addresses[cached_slot] = *client_ip_address;
     }
     else if ( first_empty_slot != DHCP_IP_ADDRESS_CACHE_MAX )
     {
         /* Add device to the first empty slot */
-        cached_mac_addresses[ first_empty_slot ] = *client_mac_address;
-        cached_ip_addresses [ first_empty_slot ] = *client_ip_address;
+        server->cached_mac_addresses[ first_empty_slot ] = *client_mac_address;
+        server->cached_ip_addresses [ first_empty_slot ] = *client_ip_address;
     }
     else
     {
         /* Cache is full. Add the device to slot 0 */
-        cached_mac_addresses[ 0 ] = *client_mac_address;
-        cached_ip_addresses [ 0 ] = *client_ip_address;
+        server->cached_mac_addresses[ 0 ] = *client_mac_address;
+        server->cached_ip_addresses [ 0 ] = *client_ip_address;
     }
 
     return CY_RSLT_SUCCESS;
@@ -896,13 +905,14 @@ static cy_rslt_t packet_delete(cy_lwip_packet_t* packet)
     return CY_RSLT_SUCCESS;
 }
 
-static cy_rslt_t cy_udp_send(cy_lwip_udp_socket_t* socket, const cy_lwip_ip_address_t* address, uint16_t port, cy_lwip_packet_t* packet)
+static cy_rslt_t cy_udp_send(cy_lwip_dhcp_server_t* server, const cy_lwip_ip_address_t* address, uint16_t port, cy_lwip_packet_t* packet)
 {
+    cy_lwip_udp_socket_t* socket = &server->socket;
     ip_addr_t temp;
     err_t status;
     cy_rslt_t result;
 
-    if((socket == NULL) || (address == NULL) || (packet == NULL))
+    if((address == NULL) || (packet == NULL))
     {
         return CY_RSLT_NETWORK_BAD_ARG;
     }
@@ -924,7 +934,7 @@ static cy_rslt_t cy_udp_send(cy_lwip_udp_socket_t* socket, const cy_lwip_ip_addr
     packet->p->len = packet->p->tot_len;
 
     /* Send the packet via the UDP socket */
-    result = internal_udp_send(socket->conn_handler, packet, (whd_network_hw_interface_type_t)socket->type, socket->index);
+    result = internal_udp_send(&server->mutex, socket->conn_handler, packet, (whd_network_hw_interface_type_t)socket->type, socket->index);
     if ( result != CY_RSLT_SUCCESS )
     {
         /* Call the wifi-mw-core network activity function to resume the network stack */
@@ -955,11 +965,11 @@ void cy_ip_to_lwip(ip_addr_t *dest, const cy_lwip_ip_address_t *src)
     }
 }
 
-static cy_rslt_t internal_udp_send(struct netconn* handler, cy_lwip_packet_t* packet,
+static cy_rslt_t internal_udp_send(cy_mutex_t* mutex, struct netconn* handler, cy_lwip_packet_t* packet,
         whd_network_hw_interface_type_t type, uint8_t index)
 {
     err_t status;
-    if(cy_rtos_get_mutex(&dhcp_mutex, CY_DHCP_MAX_MUTEX_WAIT_TIME_MS) != CY_RSLT_SUCCESS)
+    if(cy_rtos_get_mutex(mutex, CY_DHCP_MAX_MUTEX_WAIT_TIME_MS) != CY_RSLT_SUCCESS)
     {
         return CY_RSLT_NETWORK_DHCP_WAIT_TIMEOUT;
     }
@@ -973,7 +983,7 @@ static cy_rslt_t internal_udp_send(struct netconn* handler, cy_lwip_packet_t* pa
     /* Send a packet */
     packet->p->len = packet->p->tot_len;
     status = netconn_send( handler, packet );
-    if (cy_rtos_set_mutex(&dhcp_mutex) != CY_RSLT_SUCCESS)
+    if (cy_rtos_set_mutex(mutex) != CY_RSLT_SUCCESS)
     {
         return CY_RSLT_NETWORK_DHCP_MUTEX_ERROR;
     }
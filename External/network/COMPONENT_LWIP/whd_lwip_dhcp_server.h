@@ -73,6 +73,11 @@ ALWAYS_INLINE_PRE static inline ALWAYS_INLINE uint32_t htobe32(uint32_t v)
  *                    Constants
  ******************************************************/
 
+/** Number of clients whose MAC and IP addresses the DHCP server remembers */
+#ifndef DHCP_IP_ADDRESS_CACHE_MAX
+#define DHCP_IP_ADDRESS_CACHE_MAX               (5)
+#endif
+
 /******************************************************
  *                   Enumerations
  ******************************************************/
@@ -124,11 +129,19 @@ struct cy_lwip_udp_socket_struct
     uint8_t                          index;
 };
 
+/**
+ * DHCP server instance. Holds all the server's state, so several servers can run at once;
+ * zero it before the first whd_lwip_dhcp_server_start().
+ */
 typedef struct
 {
     cy_thread_t                  thread;
     cy_lwip_udp_socket_t         socket;
     volatile bool                quit;
+    bool                         started;
+    cy_mutex_t                   mutex;
+    cy_lwip_mac_addr_t           cached_mac_addresses[DHCP_IP_ADDRESS_CACHE_MAX];
+    cy_lwip_ip_address_t         cached_ip_addresses [DHCP_IP_ADDRESS_CACHE_MAX];
 } cy_lwip_dhcp_server_t;
 
 /******************************************************
@@ -168,6 +181,19 @@ cy_rslt_t whd_lwip_dhcp_server_start(cy_lwip_dhcp_server_t* server, whd_network_
  */
 cy_rslt_t whd_lwip_dhcp_server_stop(cy_lwip_dhcp_server_t *server);
 
+/**
+ *  Get the stack use of a running DHCP server thread.
+ *
+ *  The RTOS port has to track stack use for this to succeed (see CY_RTOS_HIGH_WATER in cyabs_rtos.h).
+ *
+ * @param[in]  server      Structure workspace for the DHCP server instance - as used with @ref cy_lwip_dhcp_server_t.
+ * @param[out] stack_size  Size of the thread stack in bytes.
+ * @param[out] max_used    Deepest stack use seen so far in bytes.
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_dhcp_server_get_stack_usage(cy_lwip_dhcp_server_t *server, uint32_t *stack_size, uint32_t *max_used);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,626 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *  Packet filter allow-list derived from the lwIP sockets
+ */
+#ifdef WHD_NETWORK_LWIP
+#ifdef WHD_NETWORK_PKT_FILTER
+
+#include <string.h>
+#include "lwipopts.h"
+#include "lwip/netif.h"
+#include "lwip/tcpip.h"
+#include "lwip/udp.h"
+#if LWIP_TCP
+#include "lwip/priv/tcp_priv.h"
+#endif
+#include "whd_debug.h"
+#include "whd_wifi_api.h"
+#include "whd_wlioctl.h"
+#include "whd_lwip_pkt_filter.h"
+
+/******************************************************
+ *                      Macros
+ ******************************************************/
+
+/* Filter patterns start at the EtherType; only the unicast filter looks at the destination MAC */
+#define PKT_FILTER_ETHERTYPE_OFFSET       (12)
+#define PKT_FILTER_PATTERN_MAX            (46)
+
+#define PKT_FILTER_ETHERTYPE_IPV4         (0x0800)
+#define PKT_FILTER_ETHERTYPE_ARP          (0x0806)
+#define PKT_FILTER_ETHERTYPE_IPV6         (0x86DD)
+#define PKT_FILTER_ETHERTYPE_EAPOL        (0x888E)
+
+#define PKT_FILTER_IP_PROTO_IGMP          (2)
+#define PKT_FILTER_IP_PROTO_TCP           (6)
+#define PKT_FILTER_IP_PROTO_UDP           (17)
+#define PKT_FILTER_IP_PROTO_ICMPV6        (58)
+
+#define PKT_FILTER_DHCP_CLIENT_PORT       (68)
+
+/* A PCB bound to the any-type address receives both IPv4 and IPv6 */
+#if LWIP_IPV6
+#define PKT_FILTER_ADD_PORT(set, ipaddr, kind4, kind6, port) \
+    do { \
+        if(!IP_IS_V6_VAL(ipaddr)) { pkt_filter_set_add((set), (kind4), (port)); } \
+        if(!IP_IS_V4_VAL(ipaddr)) { pkt_filter_set_add((set), (kind6), (port)); } \
+    } while(0)
+#else
+#define PKT_FILTER_ADD_PORT(set, ipaddr, kind4, kind6, port) \
+    pkt_filter_set_add((set), (kind4), (port))
+#endif
+
+/******************************************************
+ *                    Structures
+ ******************************************************/
+
+typedef struct
+{
+    whd_lwip_pkt_filter_kind_t kind;
+    uint16_t                   port;
+} pkt_filter_entry_t;
+
+/* Filters the PCBs call for; one more than fits, to tell an overflow */
+typedef struct
+{
+    pkt_filter_entry_t entry[WHD_LWIP_PKT_FILTER_MAX + 1];
+    uint32_t           count;
+    uint32_t           max;
+} pkt_filter_set_t;
+
+typedef struct
+{
+    bool                               running;
+    whd_network_interface_context     *iface;
+    whd_lwip_pkt_filter_config_t       config;
+    cy_worker_thread_info_t           *worker;
+    cy_worker_thread_work_t            scan_work;
+    cy_worker_thread_work_t            refresh_work;
+    pkt_filter_entry_t                 installed[WHD_LWIP_PKT_FILTER_MAX];
+    uint8_t                            installed_id[WHD_LWIP_PKT_FILTER_MAX];
+    whd_lwip_pkt_filter_stats_t        stats;
+} pkt_filter_state_t;
+
+/******************************************************
+ *               Variable Definitions
+ ******************************************************/
+
+static pkt_filter_state_t pkt_filter;
+static pkt_filter_set_t   pkt_filter_wanted;
+static cy_mutex_t         pkt_filter_mutex;
+static bool               pkt_filter_mutex_inited = false;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+static void pkt_filter_set_add(pkt_filter_set_t *set, whd_lwip_pkt_filter_kind_t kind, uint16_t port)
+{
+    for(uint32_t i = 0; i < set->count; i++)
+    {
+        if((set->entry[i].kind == kind) && (set->entry[i].port == port))
+        {
+            return;
+        }
+    }
+    if(set->count <= set->max)
+    {
+        set->entry[set->count].kind = kind;
+        set->entry[set->count].port = port;
+        set->count++;
+    }
+}
+
+/* Called with the TCP/IP core lock held */
+static void pkt_filter_collect(struct netif *netif, bool strict_unicast, pkt_filter_set_t *set)
+{
+    u8_t netif_idx = netif_get_index(netif);
+
+    /* The essentials go first so that they are installed first and removed last */
+    if(!strict_unicast)
+    {
+        pkt_filter_set_add(set, WHD_LWIP_PKT_FILTER_UNICAST, 0);
+    }
+#if LWIP_IPV4
+    pkt_filter_set_add(set, WHD_LWIP_PKT_FILTER_ARP, 0);
+    pkt_filter_set_add(set, WHD_LWIP_PKT_FILTER_UDP4, PKT_FILTER_DHCP_CLIENT_PORT);
+#if LWIP_IGMP
+    pkt_filter_set_add(set, WHD_LWIP_PKT_FILTER_IGMP, 0);
+#endif
+#endif
+#if LWIP_IPV6
+    pkt_filter_set_add(set, WHD_LWIP_PKT_FILTER_ICMPV6, 0);
+#endif
+    if(strict_unicast)
+    {
+        pkt_filter_set_add(set, WHD_LWIP_PKT_FILTER_EAPOL, 0);
+    }
+
+#if LWIP_UDP
+    for(struct udp_pcb *pcb = udp_pcbs; pcb != NULL; pcb = pcb->next)
+    {
+        if((pcb->local_port == 0) || ((pcb->netif_idx != NETIF_NO_INDEX) && (pcb->netif_idx != netif_idx)))
+        {
+            continue;
+        }
+        PKT_FILTER_ADD_PORT(set, pcb->local_ip, WHD_LWIP_PKT_FILTER_UDP4, WHD_LWIP_PKT_FILTER_UDP6, pcb->local_port);
+    }
+#endif
+
+#if LWIP_TCP
+    if(strict_unicast)
+    {
+        for(struct tcp_pcb_listen *lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next)
+        {
+            if((lpcb->netif_idx != NETIF_NO_INDEX) && (lpcb->netif_idx != netif_idx))
+            {
+                continue;
+            }
+            PKT_FILTER_ADD_PORT(set, lpcb->local_ip, WHD_LWIP_PKT_FILTER_TCP4, WHD_LWIP_PKT_FILTER_TCP6, lpcb->local_port);
+        }
+        for(struct tcp_pcb *pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next)
+        {
+            PKT_FILTER_ADD_PORT(set, pcb->local_ip, WHD_LWIP_PKT_FILTER_TCP4, WHD_LWIP_PKT_FILTER_TCP6, pcb->local_port);
+        }
+    }
+#endif
+}
+
+/* Builds the mask and pattern of a filter; returns their length */
+static uint16_t pkt_filter_pattern(const pkt_filter_entry_t *entry, uint16_t *offset, uint8_t *mask, uint8_t *pattern)
+{
+    uint16_t ethertype;
+    uint16_t size;
+
+    memset(mask, 0, PKT_FILTER_PATTERN_MAX);
+    memset(pattern, 0, PKT_FILTER_PATTERN_MAX);
+
+    if(entry->kind == WHD_LWIP_PKT_FILTER_UNICAST)
+    {
+        /* Group bit of the destination MAC address clear */
+        *offset = 0;
+        mask[0] = 0x01;
+        return 1;
+    }
+
+    *offset = PKT_FILTER_ETHERTYPE_OFFSET;
+    switch(entry->kind)
+    {
+        case WHD_LWIP_PKT_FILTER_ARP:
+            ethertype = PKT_FILTER_ETHERTYPE_ARP;
+            size = 2;
+            break;
+        case WHD_LWIP_PKT_FILTER_EAPOL:
+            ethertype = PKT_FILTER_ETHERTYPE_EAPOL;
+            size = 2;
+            break;
+        case WHD_LWIP_PKT_FILTER_IGMP:
+            /* IGMP carries the router alert option, so only the IP version is checked */
+            ethertype = PKT_FILTER_ETHERTYPE_IPV4;
+            mask[2] = 0xF0;
+            pattern[2] = 0x40;
+            mask[11] = 0xFF;
+            pattern[11] = PKT_FILTER_IP_PROTO_IGMP;
+            size = 12;
+            break;
+        case WHD_LWIP_PKT_FILTER_UDP4:
+        case WHD_LWIP_PKT_FILTER_TCP4:
+            /* Version 4 with a 20 byte header, protocol, destination port */
+            ethertype = PKT_FILTER_ETHERTYPE_IPV4;
+            mask[2] = 0xFF;
+            pattern[2] = 0x45;
+            mask[11] = 0xFF;
+            pattern[11] = (entry->kind == WHD_LWIP_PKT_FILTER_UDP4) ? PKT_FILTER_IP_PROTO_UDP : PKT_FILTER_IP_PROTO_TCP;
+            mask[24] = 0xFF;
+            mask[25] = 0xFF;
+            pattern[24] = (uint8_t)(entry->port >> 8);
+            pattern[25] = (uint8_t)(entry->port & 0xFF);
+            size = 26;
+            break;
+        case WHD_LWIP_PKT_FILTER_ICMPV6:
+            ethertype = PKT_FILTER_ETHERTYPE_IPV6;
+            mask[8] = 0xFF;
+            pattern[8] = PKT_FILTER_IP_PROTO_ICMPV6;
+            size = 9;
+            break;
+        case WHD_LWIP_PKT_FILTER_UDP6:
+        case WHD_LWIP_PKT_FILTER_TCP6:
+        default:
+            /* Next header straight after the fixed header, destination port */
+            ethertype = PKT_FILTER_ETHERTYPE_IPV6;
+            mask[8] = 0xFF;
+            pattern[8] = (entry->kind == WHD_LWIP_PKT_FILTER_UDP6) ? PKT_FILTER_IP_PROTO_UDP : PKT_FILTER_IP_PROTO_TCP;
+            mask[44] = 0xFF;
+            mask[45] = 0xFF;
+            pattern[44] = (uint8_t)(entry->port >> 8);
+            pattern[45] = (uint8_t)(entry->port & 0xFF);
+            size = 46;
+            break;
+    }
+    mask[0] = 0xFF;
+    mask[1] = 0xFF;
+    pattern[0] = (uint8_t)(ethertype >> 8);
+    pattern[1] = (uint8_t)(ethertype & 0xFF);
+    return size;
+}
+
+static bool pkt_filter_id_used(uint8_t id)
+{
+    for(uint32_t i = 0; i < pkt_filter.stats.num_filters; i++)
+    {
+        if(pkt_filter.installed_id[i] == id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static whd_result_t pkt_filter_install(whd_interface_t ifp, const pkt_filter_entry_t *entry)
+{
+    uint8_t mask[PKT_FILTER_PATTERN_MAX];
+    uint8_t pattern[PKT_FILTER_PATTERN_MAX];
+    whd_packet_filter_t settings;
+    whd_result_t result;
+    uint8_t id = WHD_LWIP_PKT_FILTER_BASE_ID;
+
+    while(pkt_filter_id_used(id))
+    {
+        id++;
+    }
+
+    memset(&settings, 0, sizeof(settings));
+    settings.id = id;
+    settings.rule = WHD_PACKET_FILTER_RULE_POSITIVE_MATCHING;
+    settings.mask_size = pkt_filter_pattern(entry, &settings.offset, mask, pattern);
+    settings.mask = mask;
+    settings.pattern = pattern;
+
+    result = whd_pf_add_packet_filter(ifp, &settings);
+    if((result == WHD_SUCCESS) && pkt_filter.stats.filtering)
+    {
+        result = whd_pf_enable_packet_filter(ifp, id);
+        if(result != WHD_SUCCESS)
+        {
+            (void)whd_pf_remove_packet_filter(ifp, id);
+        }
+    }
+    if(result != WHD_SUCCESS)
+    {
+        WPRINT_WHD_ERROR(("%s: Unable to install filter kind %d port %u\n", __func__, (int)entry->kind, entry->port));
+        pkt_filter.stats.failures++;
+        return result;
+    }
+
+    pkt_filter.installed[pkt_filter.stats.num_filters] = *entry;
+    pkt_filter.installed_id[pkt_filter.stats.num_filters] = id;
+    pkt_filter.stats.num_filters++;
+    pkt_filter.stats.added++;
+    return WHD_SUCCESS;
+}
+
+static void pkt_filter_uninstall(whd_interface_t ifp, uint32_t index)
+{
+    if(whd_pf_remove_packet_filter(ifp, pkt_filter.installed_id[index]) != WHD_SUCCESS)
+    {
+        pkt_filter.stats.failures++;
+    }
+    pkt_filter.stats.num_filters--;
+    memmove(&pkt_filter.installed[index], &pkt_filter.installed[index + 1],
+            (pkt_filter.stats.num_filters - index) * sizeof(pkt_filter.installed[0]));
+    memmove(&pkt_filter.installed_id[index], &pkt_filter.installed_id[index + 1],
+            (pkt_filter.stats.num_filters - index) * sizeof(pkt_filter.installed_id[0]));
+    pkt_filter.stats.removed++;
+}
+
+/* Removes every filter, the port filters first, and leaves the engine in discard-on-match mode */
+static void pkt_filter_suspend(whd_interface_t ifp)
+{
+    while(pkt_filter.stats.num_filters > 0)
+    {
+        pkt_filter_uninstall(ifp, pkt_filter.stats.num_filters - 1);
+    }
+    if(pkt_filter.stats.filtering)
+    {
+        if(whd_pf_set_packet_filter_mode(ifp, WHD_PACKET_FILTER_MODE_DISCARD_ON_MATCH) != WHD_SUCCESS)
+        {
+            pkt_filter.stats.failures++;
+        }
+        pkt_filter.stats.filtering = false;
+    }
+}
+
+static bool pkt_filter_set_has(const pkt_filter_set_t *set, const pkt_filter_entry_t *entry)
+{
+    for(uint32_t i = 0; i < set->count; i++)
+    {
+        if((set->entry[i].kind == entry->kind) && (set->entry[i].port == entry->port))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool pkt_filter_is_installed(const pkt_filter_entry_t *entry)
+{
+    for(uint32_t i = 0; i < pkt_filter.stats.num_filters; i++)
+    {
+        if((pkt_filter.installed[i].kind == entry->kind) && (pkt_filter.installed[i].port == entry->port))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The filters are added disabled while the engine discards on match, where they would block
+ * exactly the traffic they are meant to let through; they are enabled once the mode is switched */
+static whd_result_t pkt_filter_start_filtering(whd_interface_t ifp)
+{
+    whd_result_t result;
+
+    result = whd_pf_set_packet_filter_mode(ifp, WHD_PACKET_FILTER_MODE_FORWARD_ON_MATCH);
+    if(result != WHD_SUCCESS)
+    {
+        pkt_filter.stats.failures++;
+        return result;
+    }
+    pkt_filter.stats.filtering = true;
+
+    for(uint32_t i = 0; i < pkt_filter.stats.num_filters; i++)
+    {
+        result = whd_pf_enable_packet_filter(ifp, pkt_filter.installed_id[i]);
+        if(result != WHD_SUCCESS)
+        {
+            pkt_filter.stats.failures++;
+            return result;
+        }
+    }
+    return WHD_SUCCESS;
+}
+
+/* Called with pkt_filter_mutex held */
+static void pkt_filter_scan(void)
+{
+    whd_interface_t ifp = (whd_interface_t)pkt_filter.iface->hw_interface;
+    pkt_filter_set_t *wanted = &pkt_filter_wanted;
+    uint32_t added = pkt_filter.stats.added;
+    uint32_t removed = pkt_filter.stats.removed;
+    whd_result_t result = WHD_SUCCESS;
+    uint32_t i;
+
+    memset(wanted, 0, sizeof(*wanted));
+    wanted->max = pkt_filter.config.max_filters;
+    PROTECTED_FUNC_CALL(pkt_filter_collect((struct netif *)pkt_filter.iface->nw_interface, pkt_filter.config.strict_unicast, wanted));
+    pkt_filter.stats.scans++;
+
+    if(wanted->count > wanted->max)
+    {
+        /* Dropping the ports that do not fit would cut the application off, so filter nothing */
+        pkt_filter.stats.overflows++;
+        pkt_filter_suspend(ifp);
+    }
+    else
+    {
+        /* New filters go in before stale ones come out, so nothing wanted is discarded meanwhile */
+        for(i = 0; (i < wanted->count) && (result == WHD_SUCCESS); i++)
+        {
+            if(!pkt_filter_is_installed(&wanted->entry[i]))
+            {
+                result = pkt_filter_install(ifp, &wanted->entry[i]);
+                if(result != WHD_SUCCESS)
+                {
+                    /* Most likely the firmware is out of filters: do not ask for more than it took */
+                    pkt_filter.config.max_filters = (pkt_filter.stats.num_filters > 0) ? pkt_filter.stats.num_filters : 1;
+                }
+            }
+        }
+
+        if(result == WHD_SUCCESS)
+        {
+            i = pkt_filter.stats.num_filters;
+            while(i > 0)
+            {
+                i--;
+                if(!pkt_filter_set_has(wanted, &pkt_filter.installed[i]))
+                {
+                    pkt_filter_uninstall(ifp, i);
+                }
+            }
+            if(!pkt_filter.stats.filtering)
+            {
+                result = pkt_filter_start_filtering(ifp);
+            }
+        }
+
+        if(result != WHD_SUCCESS)
+        {
+            /* Filtering with part of the allow-list would discard wanted traffic */
+            pkt_filter_suspend(ifp);
+        }
+    }
+
+    if((pkt_filter.stats.added != added) || (pkt_filter.stats.removed != removed))
+    {
+        pkt_filter.stats.changes++;
+    }
+}
+
+static void pkt_filter_work(void *arg)
+{
+    UNUSED_VARIABLE(arg);
+
+    cy_rtos_get_mutex(&pkt_filter_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(pkt_filter.running)
+    {
+        pkt_filter_scan();
+    }
+    cy_rtos_set_mutex(&pkt_filter_mutex);
+}
+
+cy_rslt_t whd_lwip_pkt_filter_start(whd_network_interface_context *iface_context, const whd_lwip_pkt_filter_config_t *config,
+                                    cy_worker_thread_info_t *worker)
+{
+    cy_rslt_t result;
+
+    if((iface_context == NULL) || (iface_context->hw_interface == NULL) || (iface_context->nw_interface == NULL) ||
+       (iface_context->iface_type == CY_NETWORK_ETH_INTERFACE) || (worker == NULL))
+    {
+        WPRINT_WHD_ERROR(("%s: Invalid arguments \n", __func__));
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    if(!pkt_filter_mutex_inited)
+    {
+        if(cy_rtos_init_mutex(&pkt_filter_mutex) != CY_RSLT_SUCCESS)
+        {
+            WPRINT_WHD_ERROR(("%s: Unable to create the mutex \n", __func__));
+            return CY_RSLT_NETWORK_ERROR_RTOS;
+        }
+        pkt_filter_mutex_inited = true;
+    }
+
+    cy_rtos_get_mutex(&pkt_filter_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(pkt_filter.running)
+    {
+        cy_rtos_set_mutex(&pkt_filter_mutex);
+        WPRINT_WHD_ERROR(("%s: Already running \n", __func__));
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    memset(&pkt_filter, 0, sizeof(pkt_filter));
+    if(config != NULL)
+    {
+        pkt_filter.config = *config;
+    }
+    if(pkt_filter.config.scan_ms == 0)
+    {
+        pkt_filter.config.scan_ms = WHD_LWIP_PKT_FILTER_DEFAULT_SCAN_MS;
+    }
+    if((pkt_filter.config.max_filters == 0) || (pkt_filter.config.max_filters > WHD_LWIP_PKT_FILTER_MAX))
+    {
+        pkt_filter.config.max_filters = WHD_LWIP_PKT_FILTER_MAX;
+    }
+    pkt_filter.iface = iface_context;
+    pkt_filter.worker = worker;
+    cy_worker_thread_work_init(&pkt_filter.scan_work, pkt_filter_work, NULL);
+    cy_worker_thread_work_init(&pkt_filter.refresh_work, pkt_filter_work, NULL);
+
+    result = cy_worker_thread_work_enqueue_delayed(worker, &pkt_filter.scan_work, 0, pkt_filter.config.scan_ms);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        pkt_filter.running = true;
+    }
+    cy_rtos_set_mutex(&pkt_filter_mutex);
+
+    return result;
+}
+
+cy_rslt_t whd_lwip_pkt_filter_stop(void)
+{
+    if(!pkt_filter_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&pkt_filter_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(!pkt_filter.running)
+    {
+        cy_rtos_set_mutex(&pkt_filter_mutex);
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    pkt_filter.running = false;
+    (void)cy_worker_thread_work_cancel(pkt_filter.worker, &pkt_filter.scan_work);
+    (void)cy_worker_thread_work_cancel(pkt_filter.worker, &pkt_filter.refresh_work);
+    pkt_filter_suspend((whd_interface_t)pkt_filter.iface->hw_interface);
+    cy_rtos_set_mutex(&pkt_filter_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_lwip_pkt_filter_refresh(void)
+{
+    if(!pkt_filter.running)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    return cy_worker_thread_work_enqueue(pkt_filter.worker, &pkt_filter.refresh_work);
+}
+
+cy_rslt_t whd_lwip_pkt_filter_get_stats(whd_lwip_pkt_filter_stats_t *stats, whd_lwip_pkt_filter_entry_stats_t *entries,
+                                        uint32_t max_entries, uint32_t *num_entries)
+{
+    whd_interface_t ifp;
+    whd_pkt_filter_stats_t filter_stats;
+    uint32_t filled = 0;
+
+    if((stats == NULL) || !pkt_filter_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&pkt_filter_mutex, CY_RTOS_NEVER_TIMEOUT);
+    *stats = pkt_filter.stats;
+    if((entries != NULL) && (pkt_filter.iface != NULL))
+    {
+        ifp = (whd_interface_t)pkt_filter.iface->hw_interface;
+        for(uint32_t i = 0; (i < pkt_filter.stats.num_filters) && (filled < max_entries); i++)
+        {
+            memset(&entries[filled], 0, sizeof(entries[filled]));
+            entries[filled].id = pkt_filter.installed_id[i];
+            entries[filled].kind = pkt_filter.installed[i].kind;
+            entries[filled].port = pkt_filter.installed[i].port;
+            memset(&filter_stats, 0, sizeof(filter_stats));
+            if(whd_pf_get_packet_filter_stats(ifp, pkt_filter.installed_id[i], &filter_stats) == WHD_SUCCESS)
+            {
+                entries[filled].matched = filter_stats.num_pkts_matched;
+                entries[filled].forwarded = filter_stats.num_pkts_forwarded;
+                entries[filled].discarded = filter_stats.num_pkts_discarded;
+            }
+            filled++;
+        }
+    }
+    cy_rtos_set_mutex(&pkt_filter_mutex);
+
+    if(num_entries != NULL)
+    {
+        *num_entries = filled;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+#endif /* WHD_NETWORK_PKT_FILTER */
+#endif /* WHD_NETWORK_LWIP */
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *  Packet filter allow-list derived from the lwIP sockets
+ *
+ *  Without packet filters every broadcast and multicast frame on the network (mDNS, SSDP,
+ *  NetBIOS, ...) is passed up the bus and wakes the host. This module keeps an allow-list of
+ *  firmware packet filters in step with what lwIP can actually receive and puts the filter engine
+ *  in forward-on-match mode, so the firmware discards everything else:
+ *
+ *  - all unicast frames (unless strict_unicast is set),
+ *  - ARP, the DHCP client port, IGMP and ICMPv6 (neighbour discovery),
+ *  - IPv4/IPv6 UDP to the local port of every bound UDP PCB,
+ *  - with strict_unicast, EAPOL and IPv4/IPv6 TCP to the local port of every listening and
+ *    connected TCP PCB.
+ *
+ *  lwIP has no notification for sockets being bound or closed, so a work item rescans the PCB
+ *  lists every scan_ms and adds or removes only the filters that changed. Call
+ *  whd_lwip_pkt_filter_refresh() after opening a listening socket to have it covered straight
+ *  away. The IPv4 port filters assume a 20 byte IP header, so packets with IP options do not
+ *  match them.
+ *
+ *  The filter mode applies to every filter on the interface: the application should not install
+ *  filters of its own while the module runs.
+ */
+#ifdef WHD_NETWORK_LWIP
+#pragma once
+
+#ifdef WHD_NETWORK_PKT_FILTER
+
+#include "cy_network_mw_core.h"
+#include "cy_worker_thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+ *                    Constants
+ ******************************************************/
+
+/** Most filters the module installs at once. More ports than this suspend the filtering. */
+#ifndef WHD_LWIP_PKT_FILTER_MAX
+#define WHD_LWIP_PKT_FILTER_MAX                 (16)
+#endif
+
+/** First firmware filter id used by the module; ids up to WHD_LWIP_PKT_FILTER_BASE_ID + WHD_LWIP_PKT_FILTER_MAX - 1 are taken */
+#ifndef WHD_LWIP_PKT_FILTER_BASE_ID
+#define WHD_LWIP_PKT_FILTER_BASE_ID             (200)
+#endif
+
+/** Default time between two scans of the PCB lists */
+#ifndef WHD_LWIP_PKT_FILTER_DEFAULT_SCAN_MS
+#define WHD_LWIP_PKT_FILTER_DEFAULT_SCAN_MS     (1000)
+#endif
+
+/******************************************************
+ *                   Enumerations
+ ******************************************************/
+
+/**
+ * Traffic a filter lets through
+ */
+typedef enum
+{
+    WHD_LWIP_PKT_FILTER_UNICAST = 0,    /**< Frames to a unicast MAC address */
+    WHD_LWIP_PKT_FILTER_ARP,            /**< ARP */
+    WHD_LWIP_PKT_FILTER_EAPOL,          /**< EAPOL, strict_unicast only */
+    WHD_LWIP_PKT_FILTER_IGMP,           /**< IGMP */
+    WHD_LWIP_PKT_FILTER_ICMPV6,         /**< ICMPv6, which carries neighbour and router discovery */
+    WHD_LWIP_PKT_FILTER_UDP4,           /**< IPv4 UDP to a port */
+    WHD_LWIP_PKT_FILTER_UDP6,           /**< IPv6 UDP to a port */
+    WHD_LWIP_PKT_FILTER_TCP4,           /**< IPv4 TCP to a port, strict_unicast only */
+    WHD_LWIP_PKT_FILTER_TCP6            /**< IPv6 TCP to a port, strict_unicast only */
+} whd_lwip_pkt_filter_kind_t;
+
+/******************************************************
+ *                    Structures
+ ******************************************************/
+
+/**
+ * Packet filter module settings
+ */
+typedef struct
+{
+    uint32_t scan_ms;                   /**< Time between two scans, 0 for WHD_LWIP_PKT_FILTER_DEFAULT_SCAN_MS */
+    uint32_t max_filters;               /**< Filters the firmware can hold, 0 or above WHD_LWIP_PKT_FILTER_MAX for WHD_LWIP_PKT_FILTER_MAX; lowered to what it took if it refuses one */
+    bool     strict_unicast;            /**< Also filter unicast frames by TCP/UDP port */
+} whd_lwip_pkt_filter_config_t;
+
+/**
+ * Packet filter module counters
+ */
+typedef struct
+{
+    bool     filtering;                 /**< The filter engine is in forward-on-match mode with the allow-list installed */
+    uint32_t num_filters;               /**< Filters installed now */
+    uint32_t scans;                     /**< PCB list scans */
+    uint32_t changes;                   /**< Scans that added or removed filters */
+    uint32_t added;                     /**< Filters added */
+    uint32_t removed;                   /**< Filters removed */
+    uint32_t failures;                  /**< Filter iovars that failed; the filtering is suspended until a scan succeeds */
+    uint32_t overflows;                 /**< Scans that found more ports than filters; the filtering is suspended meanwhile */
+} whd_lwip_pkt_filter_stats_t;
+
+/**
+ * Statistics of one installed filter
+ */
+typedef struct
+{
+    uint8_t                    id;          /**< Firmware filter id */
+    whd_lwip_pkt_filter_kind_t kind;        /**< Traffic let through */
+    uint16_t                   port;        /**< Destination port for the TCP/UDP kinds, 0 otherwise */
+    uint32_t                   matched;     /**< Packets that matched the filter */
+    uint32_t                   forwarded;   /**< Packets forwarded to the host */
+    uint32_t                   discarded;   /**< Packets discarded */
+} whd_lwip_pkt_filter_entry_stats_t;
+
+/******************************************************
+ *               Function Declarations
+ ******************************************************/
+
+/**
+ *  Start deriving the packet filters of an interface from the lwIP PCBs.
+ *
+ *  The first scan runs on the worker thread straight away.
+ *
+ * @param[in] iface_context  Wi-Fi interface the filters are installed on, normally the STA.
+ * @param[in] config         Settings, NULL for the defaults.
+ * @param[in] worker         Worker thread that scans the PCBs and sends the filter iovars.
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_pkt_filter_start(whd_network_interface_context *iface_context, const whd_lwip_pkt_filter_config_t *config,
+                                    cy_worker_thread_info_t *worker);
+
+/**
+ *  Stop the module, remove its filters and put the filter engine back in discard-on-match mode.
+ *
+ *  A scan already running on the worker thread is waited for.
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if the module is not running.
+ */
+cy_rslt_t whd_lwip_pkt_filter_stop(void);
+
+/**
+ *  Scan the PCBs now, e.g. after opening a listening socket.
+ *
+ * @return CY_RSLT_SUCCESS if the scan was queued; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_pkt_filter_refresh(void);
+
+/**
+ *  Get the module counters and the per-filter statistics.
+ *
+ *  The per-filter statistics are read from the firmware, one iovar per filter.
+ *
+ * @param[out] stats        Module counters.
+ * @param[out] entries      Per-filter statistics, may be NULL.
+ * @param[in]  max_entries  Size of entries.
+ * @param[out] num_entries  Entries filled in, may be NULL.
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_pkt_filter_get_stats(whd_lwip_pkt_filter_stats_t *stats, whd_lwip_pkt_filter_entry_stats_t *entries,
+                                        uint32_t max_entries, uint32_t *num_entries);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* WHD_NETWORK_PKT_FILTER */
+#endif /* WHD_NETWORK_LWIP */
@@ -0,0 +1,623 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *  TCP keepalive offload for long-lived lwIP connections
+ */
+#ifdef WHD_NETWORK_LWIP
+#ifdef WHD_NETWORK_TKO
+
+#include <stddef.h>
+#include <string.h>
+#include "lwipopts.h"
+#include "lwip/netif.h"
+#include "lwip/tcpip.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip.h"
+#include "lwip/priv/tcp_priv.h"
+#include "whd_debug.h"
+#include "whd_wifi_api.h"
+#include "whd_wlioctl.h"
+#include "whd_lwip_tko.h"
+
+#if !LWIP_TCP || !LWIP_IPV4
+#error "WHD_NETWORK_TKO needs LWIP_TCP and LWIP_IPV4"
+#endif
+
+/******************************************************
+ *                      Macros
+ ******************************************************/
+
+#define TKO_IP_HDR_LEN              (20)
+#define TKO_TCP_HDR_LEN             (20)
+#define TKO_SEGMENT_LEN             (TKO_IP_HDR_LEN + TKO_TCP_HDR_LEN)
+#define TKO_PSEUDO_HDR_LEN          (12)
+#define TKO_TCP_FLAG_ACK            (0x10)
+#define TKO_IP_FLAG_DF              (0x40)
+
+/* Fixed part, local and remote IPv4 address, keepalive request and expected response */
+#define TKO_CONNECT_LEN             (offsetof(wl_tko_connect_t, data) + (2 * IPV4_ADDR_LEN) + (2 * TKO_SEGMENT_LEN))
+
+#if LWIP_IPV6
+#define TKO_PCB_IS_IPV4(pcb)        IP_IS_V4_VAL((pcb)->remote_ip)
+#else
+#define TKO_PCB_IS_IPV4(pcb)        (1)
+#endif
+
+/* Window field of a segment from the peer, lwIP keeps it unscaled */
+#if LWIP_WND_SCALE
+#define TKO_PEER_WND(pcb)           TCPWND_MIN16((pcb)->snd_wnd >> (pcb)->snd_scale)
+#else
+#define TKO_PEER_WND(pcb)           TCPWND_MIN16((pcb)->snd_wnd)
+#endif
+
+/******************************************************
+ *                    Structures
+ ******************************************************/
+
+typedef struct
+{
+    uint16_t local_port;
+    uint16_t remote_port;
+} tko_designation_t;
+
+/* A connection as it was handed to the firmware */
+typedef struct
+{
+    struct tcp_pcb *pcb;
+    uint32_t        local_ip;           /* Network byte order */
+    uint32_t        remote_ip;          /* Network byte order */
+    uint16_t        local_port;
+    uint16_t        remote_port;
+    uint32_t        snd_nxt;
+    uint32_t        rcv_nxt;
+    uint16_t        rcv_wnd;            /* Window field lwIP sends */
+    uint16_t        peer_wnd;           /* Window field the peer sends */
+    uint8_t         ttl;
+} tko_conn_t;
+
+/* Sequence numbers the firmware reports on resume */
+typedef struct
+{
+    bool     valid;
+    uint32_t local_seq;
+    uint32_t remote_seq;
+} tko_fw_seq_t;
+
+typedef union
+{
+    whd_tko_connect_t connect;
+    uint8_t           raw[TKO_CONNECT_LEN];
+} tko_connect_buf_t;
+
+typedef struct
+{
+    bool                               running;
+    whd_network_interface_context     *iface;
+    whd_tko_retry_t                    retry;
+    tko_designation_t                  designated[WHD_LWIP_TKO_MAX_DESIGNATED];
+    uint32_t                           num_designated;
+    tko_conn_t                         conn[MAX_TKO_CONN];
+    whd_lwip_tko_stats_t               stats;
+} tko_state_t;
+
+/******************************************************
+ *               Variable Definitions
+ ******************************************************/
+
+static tko_state_t tko;
+static cy_mutex_t  tko_mutex;
+static bool        tko_mutex_inited = false;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+static void tko_put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void tko_put32(uint8_t *p, uint32_t value)
+{
+    tko_put16(p, (uint16_t)(value >> 16));
+    tko_put16(p + 2, (uint16_t)value);
+}
+
+/* An IPv4 TCP segment with ACK set and no payload, checksums included */
+static void tko_build_segment(uint8_t *seg, uint32_t src_ip, uint32_t dst_ip, uint16_t src_port, uint16_t dst_port,
+                              uint32_t seq, uint32_t ack, uint16_t wnd, uint8_t ttl)
+{
+    uint8_t pseudo[TKO_PSEUDO_HDR_LEN + TKO_TCP_HDR_LEN];
+    uint8_t *tcp = seg + TKO_IP_HDR_LEN;
+    u16_t chksum;
+
+    memset(seg, 0, TKO_SEGMENT_LEN);
+    seg[0] = 0x45;
+    tko_put16(&seg[2], TKO_SEGMENT_LEN);
+    seg[6] = TKO_IP_FLAG_DF;
+    seg[8] = ttl;
+    seg[9] = IP_PROTO_TCP;
+    memcpy(&seg[12], &src_ip, sizeof(src_ip));
+    memcpy(&seg[16], &dst_ip, sizeof(dst_ip));
+    chksum = inet_chksum(seg, TKO_IP_HDR_LEN);
+    memcpy(&seg[10], &chksum, sizeof(chksum));
+
+    tko_put16(&tcp[0], src_port);
+    tko_put16(&tcp[2], dst_port);
+    tko_put32(&tcp[4], seq);
+    tko_put32(&tcp[8], ack);
+    tcp[12] = (TKO_TCP_HDR_LEN / 4) << 4;
+    tcp[13] = TKO_TCP_FLAG_ACK;
+    tko_put16(&tcp[14], wnd);
+
+    /* Source and destination address, zero, protocol and TCP length, then the TCP header */
+    memcpy(&pseudo[0], &seg[12], 2 * IPV4_ADDR_LEN);
+    pseudo[8] = 0;
+    pseudo[9] = IP_PROTO_TCP;
+    tko_put16(&pseudo[10], TKO_TCP_HDR_LEN);
+    memcpy(&pseudo[TKO_PSEUDO_HDR_LEN], tcp, TKO_TCP_HDR_LEN);
+    chksum = inet_chksum(pseudo, sizeof(pseudo));
+    memcpy(&tcp[16], &chksum, sizeof(chksum));
+}
+
+static void tko_fill_connect(uint8_t index, const tko_conn_t *conn, tko_connect_buf_t *buf)
+{
+    whd_tko_connect_t *connect = &buf->connect;
+    uint8_t *data = connect->data;
+
+    memset(buf, 0, sizeof(*buf));
+    connect->index = index;
+    connect->ip_addr_type = 0;
+    connect->local_port = conn->local_port;
+    connect->remote_port = conn->remote_port;
+    connect->local_seq = conn->snd_nxt;
+    connect->remote_seq = conn->rcv_nxt;
+    connect->request_len = TKO_SEGMENT_LEN;
+    connect->response_len = TKO_SEGMENT_LEN;
+    memcpy(&data[0], &conn->local_ip, IPV4_ADDR_LEN);
+    memcpy(&data[IPV4_ADDR_LEN], &conn->remote_ip, IPV4_ADDR_LEN);
+    data += 2 * IPV4_ADDR_LEN;
+
+    /* The probe repeats the last byte already acknowledged, which the peer answers with a bare ACK */
+    tko_build_segment(data, conn->local_ip, conn->remote_ip, conn->local_port, conn->remote_port,
+                      conn->snd_nxt - 1, conn->rcv_nxt, conn->rcv_wnd, conn->ttl);
+    tko_build_segment(data + TKO_SEGMENT_LEN, conn->remote_ip, conn->local_ip, conn->remote_port, conn->local_port,
+                      conn->rcv_nxt, conn->snd_nxt, conn->peer_wnd, conn->ttl);
+}
+
+static bool tko_is_designated(uint16_t local_port, uint16_t remote_port)
+{
+    for(uint32_t i = 0; i < tko.num_designated; i++)
+    {
+        if(((tko.designated[i].local_port == 0) || (tko.designated[i].local_port == local_port)) &&
+           ((tko.designated[i].remote_port == 0) || (tko.designated[i].remote_port == remote_port)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Called with the TCP/IP core lock held */
+static void tko_collect(struct netif *netif, uint32_t *count)
+{
+    tko_conn_t *conn;
+
+    *count = 0;
+    for(struct tcp_pcb *pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next)
+    {
+        if(!tko_is_designated(pcb->local_port, pcb->remote_port))
+        {
+            continue;
+        }
+        if(!TKO_PCB_IS_IPV4(pcb))
+        {
+            tko.stats.not_ipv4++;
+            continue;
+        }
+        if(!ip4_addr_cmp(ip_2_ip4(&pcb->local_ip), netif_ip4_addr(netif)))
+        {
+            continue;
+        }
+        /* The firmware only probes; anything still to be sent or acknowledged needs lwIP */
+        if((pcb->state != ESTABLISHED) || (pcb->unsent != NULL) || (pcb->unacked != NULL) ||
+#if TCP_QUEUE_OOSEQ
+           (pcb->ooseq != NULL) ||
+#endif
+           (pcb->refused_data != NULL))
+        {
+            tko.stats.not_idle++;
+            continue;
+        }
+        if(*count >= tko.stats.max_connections)
+        {
+            tko.stats.over_limit++;
+            continue;
+        }
+
+        conn = &tko.conn[*count];
+        conn->pcb = pcb;
+        conn->local_ip = ip4_addr_get_u32(ip_2_ip4(&pcb->local_ip));
+        conn->remote_ip = ip4_addr_get_u32(ip_2_ip4(&pcb->remote_ip));
+        conn->local_port = pcb->local_port;
+        conn->remote_port = pcb->remote_port;
+        conn->snd_nxt = pcb->snd_nxt;
+        conn->rcv_nxt = pcb->rcv_nxt;
+        conn->rcv_wnd = TCPWND_MIN16(RCV_WND_SCALE(pcb, pcb->rcv_ann_wnd));
+        conn->peer_wnd = TKO_PEER_WND(pcb);
+        conn->ttl = pcb->ttl;
+        (*count)++;
+    }
+}
+
+/* Called with the TCP/IP core lock held. The PCB may have been freed and its memory reused. */
+static struct tcp_pcb *tko_find_pcb(const tko_conn_t *conn)
+{
+    for(struct tcp_pcb *pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next)
+    {
+        if((pcb == conn->pcb) && (pcb->local_port == conn->local_port) && (pcb->remote_port == conn->remote_port) &&
+           TKO_PCB_IS_IPV4(pcb) && (ip4_addr_get_u32(ip_2_ip4(&pcb->remote_ip)) == conn->remote_ip))
+        {
+            return pcb;
+        }
+    }
+    return NULL;
+}
+
+/* Called with the TCP/IP core lock held */
+static void tko_reclaim(const whd_tko_status_t *status, const tko_fw_seq_t *fw)
+{
+    const tko_conn_t *conn;
+    struct tcp_pcb *pcb;
+    uint8_t state;
+
+    for(uint32_t i = 0; i < tko.stats.num_offloaded; i++)
+    {
+        conn = &tko.conn[i];
+        pcb = tko_find_pcb(conn);
+        if(pcb == NULL)
+        {
+            continue;
+        }
+        if((pcb->state != ESTABLISHED) || (pcb->snd_nxt != conn->snd_nxt) || (pcb->rcv_nxt != conn->rcv_nxt) ||
+           (pcb->unsent != NULL) || (pcb->unacked != NULL))
+        {
+            tko.stats.changed++;
+            continue;
+        }
+
+        state = (i < status->count) ? status->status[i] : TKO_STATUS_UNAVAILABLE;
+        if(state == TKO_STATUS_NO_RESPONSE)
+        {
+            /* The peer is gone; tell the application now rather than after lwIP's own keepalives */
+            tko.stats.lost++;
+            tcp_abort(pcb);
+            continue;
+        }
+
+        if(fw[i].valid && (TCP_SEQ_GT(fw[i].remote_seq, pcb->rcv_nxt) || TCP_SEQ_GT(fw[i].local_seq, pcb->snd_nxt)))
+        {
+            if(TCP_SEQ_GT(fw[i].remote_seq, pcb->rcv_nxt))
+            {
+                pcb->rcv_nxt = fw[i].remote_seq;
+                if(TCP_SEQ_LT(pcb->rcv_ann_right_edge, pcb->rcv_nxt))
+                {
+                    pcb->rcv_ann_right_edge = pcb->rcv_nxt;
+                }
+            }
+            if(TCP_SEQ_GT(fw[i].local_seq, pcb->snd_nxt))
+            {
+                pcb->snd_nxt = fw[i].local_seq;
+                pcb->snd_lbb = fw[i].local_seq;
+                pcb->lastack = fw[i].local_seq;
+            }
+            tko.stats.resynced++;
+        }
+
+        if(state == TKO_STATUS_NORMAL)
+        {
+            /* The firmware kept the connection alive: restart lwIP's idle time */
+            pcb->tmr = tcp_ticks;
+            pcb->keep_cnt_sent = 0;
+        }
+    }
+}
+
+/* Called with tko_mutex held */
+static void tko_resume(void)
+{
+    whd_interface_t ifp = (whd_interface_t)tko.iface->hw_interface;
+    tko_fw_seq_t fw[MAX_TKO_CONN];
+    tko_connect_buf_t buf;
+    whd_tko_status_t status;
+
+    memset(fw, 0, sizeof(fw));
+    memset(&status, 0, sizeof(status));
+    if(tko.stats.num_offloaded > 0)
+    {
+        /* The status is gone once the offload is disabled */
+        if(whd_tko_get_status(ifp, &status) != WHD_SUCCESS)
+        {
+            tko.stats.failures++;
+            status.count = 0;
+        }
+        for(uint32_t i = 0; i < tko.stats.num_offloaded; i++)
+        {
+            if(whd_tko_get_FW_connect(ifp, (uint8_t)i, &buf.connect, sizeof(buf)) == WHD_SUCCESS)
+            {
+                fw[i].valid = true;
+                fw[i].local_seq = buf.connect.local_seq;
+                fw[i].remote_seq = buf.connect.remote_seq;
+            }
+            else
+            {
+                tko.stats.failures++;
+            }
+        }
+        if(whd_tko_toggle(ifp, WHD_FALSE) != WHD_SUCCESS)
+        {
+            tko.stats.failures++;
+        }
+        PROTECTED_FUNC_CALL(tko_reclaim(&status, fw));
+    }
+    tko.stats.suspended = false;
+}
+
+cy_rslt_t whd_lwip_tko_start(whd_network_interface_context *iface_context, const whd_lwip_tko_config_t *config)
+{
+    whd_interface_t ifp;
+    uint8_t max = 0;
+
+    if((iface_context == NULL) || (iface_context->hw_interface == NULL) || (iface_context->nw_interface == NULL) ||
+       (iface_context->iface_type != CY_NETWORK_WIFI_STA_INTERFACE))
+    {
+        WPRINT_WHD_ERROR(("%s: Invalid arguments \n", __func__));
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    if(!tko_mutex_inited)
+    {
+        if(cy_rtos_init_mutex(&tko_mutex) != CY_RSLT_SUCCESS)
+        {
+            WPRINT_WHD_ERROR(("%s: Unable to create the mutex \n", __func__));
+            return CY_RSLT_NETWORK_ERROR_RTOS;
+        }
+        tko_mutex_inited = true;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(tko.running)
+    {
+        cy_rtos_set_mutex(&tko_mutex);
+        WPRINT_WHD_ERROR(("%s: Already running \n", __func__));
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    ifp = (whd_interface_t)iface_context->hw_interface;
+    if((whd_tko_max_assoc(ifp, &max) != WHD_SUCCESS) || (max == 0))
+    {
+        cy_rtos_set_mutex(&tko_mutex);
+        WPRINT_WHD_ERROR(("%s: TCP keepalive offload not supported by the firmware \n", __func__));
+        return CY_RSLT_NETWORK_NOT_SUPPORTED;
+    }
+
+    memset(&tko, 0, sizeof(tko));
+    if(config != NULL)
+    {
+        tko.retry.tko_interval = config->interval_s;
+        tko.retry.tko_retry_interval = config->retry_interval_s;
+        tko.retry.tko_retry_count = config->retry_count;
+    }
+    tko.iface = iface_context;
+    tko.stats.max_connections = (max < MAX_TKO_CONN) ? max : MAX_TKO_CONN;
+    tko.running = true;
+    cy_rtos_set_mutex(&tko_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_lwip_tko_stop(void)
+{
+    if(!tko_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(!tko.running)
+    {
+        cy_rtos_set_mutex(&tko_mutex);
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    if(tko.stats.suspended)
+    {
+        tko_resume();
+    }
+    tko.running = false;
+    tko.num_designated = 0;
+    cy_rtos_set_mutex(&tko_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_lwip_tko_add(uint16_t local_port, uint16_t remote_port)
+{
+    cy_rslt_t result = CY_RSLT_NETWORK_BAD_ARG;
+
+    if(((local_port == 0) && (remote_port == 0)) || !tko_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(tko.running && (tko.num_designated < WHD_LWIP_TKO_MAX_DESIGNATED))
+    {
+        tko.designated[tko.num_designated].local_port = local_port;
+        tko.designated[tko.num_designated].remote_port = remote_port;
+        tko.num_designated++;
+        result = CY_RSLT_SUCCESS;
+    }
+    cy_rtos_set_mutex(&tko_mutex);
+
+    return result;
+}
+
+cy_rslt_t whd_lwip_tko_remove(uint16_t local_port, uint16_t remote_port)
+{
+    cy_rslt_t result = CY_RSLT_NETWORK_BAD_ARG;
+
+    if(!tko_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    for(uint32_t i = 0; i < tko.num_designated; i++)
+    {
+        if((tko.designated[i].local_port == local_port) && (tko.designated[i].remote_port == remote_port))
+        {
+            tko.num_designated--;
+            tko.designated[i] = tko.designated[tko.num_designated];
+            result = CY_RSLT_SUCCESS;
+            break;
+        }
+    }
+    cy_rtos_set_mutex(&tko_mutex);
+
+    return result;
+}
+
+cy_rslt_t whd_lwip_tko_suspend(uint32_t *num_offloaded)
+{
+    whd_interface_t ifp;
+    tko_connect_buf_t buf;
+    whd_result_t result = WHD_SUCCESS;
+    uint32_t count = 0;
+
+    if(num_offloaded != NULL)
+    {
+        *num_offloaded = 0;
+    }
+    if(!tko_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(!tko.running || tko.stats.suspended)
+    {
+        cy_rtos_set_mutex(&tko_mutex);
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    ifp = (whd_interface_t)tko.iface->hw_interface;
+    PROTECTED_FUNC_CALL(tko_collect((struct netif *)tko.iface->nw_interface, &count));
+
+    if(count > 0)
+    {
+        /* Start from an empty table, which also ends any automatic offload */
+        result = whd_tko_toggle(ifp, WHD_FALSE);
+        if(result == WHD_SUCCESS)
+        {
+            result = whd_tko_param(ifp, &tko.retry, 1);
+        }
+        for(uint32_t i = 0; (i < count) && (result == WHD_SUCCESS); i++)
+        {
+            tko_fill_connect((uint8_t)i, &tko.conn[i], &buf);
+            result = whd_tko_set_FW_connect(ifp, &buf.connect, sizeof(buf));
+        }
+        if(result == WHD_SUCCESS)
+        {
+            result = whd_tko_toggle(ifp, WHD_TRUE);
+        }
+        if(result != WHD_SUCCESS)
+        {
+            /* lwIP keeps the connections alive itself */
+            tko.stats.failures++;
+            (void)whd_tko_toggle(ifp, WHD_FALSE);
+            cy_rtos_set_mutex(&tko_mutex);
+            WPRINT_WHD_ERROR(("%s: Unable to offload %lu connections \n", __func__, (unsigned long)count));
+            return (cy_rslt_t)result;
+        }
+        tko.stats.suspends++;
+    }
+
+    tko.stats.num_offloaded = count;
+    tko.stats.offloaded += count;
+    tko.stats.suspended = true;
+    cy_rtos_set_mutex(&tko_mutex);
+
+    if(num_offloaded != NULL)
+    {
+        *num_offloaded = count;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_lwip_tko_resume(void)
+{
+    if(!tko_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(!tko.running || !tko.stats.suspended)
+    {
+        cy_rtos_set_mutex(&tko_mutex);
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    tko_resume();
+    cy_rtos_set_mutex(&tko_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_lwip_tko_get_stats(whd_lwip_tko_stats_t *stats)
+{
+    if((stats == NULL) || !tko_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+
+    cy_rtos_get_mutex(&tko_mutex, CY_RTOS_NEVER_TIMEOUT);
+    *stats = tko.stats;
+    cy_rtos_set_mutex(&tko_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+#endif /* WHD_NETWORK_TKO */
+#endif /* WHD_NETWORK_LWIP */
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *  TCP keepalive offload for long-lived lwIP connections
+ *
+ *  An always-connected client (MQTT and the like) has to send a TCP keepalive every few tens of
+ *  seconds, and every one of them wakes the host. The firmware can send them instead, but it
+ *  needs the exact addresses, ports and sequence numbers of each connection. This module takes
+ *  them from the lwIP PCBs:
+ *
+ *  - the application designates its long-lived connections by port with whd_lwip_tko_add(),
+ *  - whd_lwip_tko_suspend(), called just before the host goes to sleep, snapshots every
+ *    designated connection that is idle (established, nothing unsent or unacknowledged) and
+ *    programs up to the firmware's connection limit, then enables the offload,
+ *  - whd_lwip_tko_resume(), called on wake, reads back the per-connection status, disables the
+ *    offload and brings lwIP back in step: a connection the peer stopped answering is aborted,
+ *    sequence numbers the firmware moved on are adopted and the keepalive timers of healthy
+ *    connections are restarted so lwIP does not send a keepalive of its own straight away.
+ *
+ *  Only IPv4 connections are offloaded. The application must not send on an offloaded
+ *  connection between suspend and resume; one that changed meanwhile is left as lwIP has it.
+ *  The manually programmed connections replace any the firmware set up automatically.
+ */
+#ifdef WHD_NETWORK_LWIP
+#pragma once
+
+#ifdef WHD_NETWORK_TKO
+
+#include "cy_network_mw_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+ *                    Constants
+ ******************************************************/
+
+/** Most connections that can be designated with whd_lwip_tko_add() */
+#ifndef WHD_LWIP_TKO_MAX_DESIGNATED
+#define WHD_LWIP_TKO_MAX_DESIGNATED             (8)
+#endif
+
+/******************************************************
+ *                    Structures
+ ******************************************************/
+
+/**
+ * Keepalive timing used by the firmware; zero fields take the WHD defaults
+ */
+typedef struct
+{
+    uint16_t interval_s;                /**< Time between two keepalives */
+    uint16_t retry_interval_s;          /**< Time between two retries of an unanswered keepalive */
+    uint16_t retry_count;               /**< Unanswered retries before the connection is reported lost */
+} whd_lwip_tko_config_t;
+
+/**
+ * TCP keepalive offload counters
+ */
+typedef struct
+{
+    bool     suspended;                 /**< Between whd_lwip_tko_suspend() and whd_lwip_tko_resume() */
+    uint32_t max_connections;           /**< Connections the firmware can keep alive */
+    uint32_t num_offloaded;             /**< Connections offloaded by the last suspend */
+    uint32_t suspends;                  /**< Calls to whd_lwip_tko_suspend() that enabled the offload */
+    uint32_t offloaded;                 /**< Connections offloaded, summed over all suspends */
+    uint32_t not_idle;                  /**< Designated connections left to lwIP because they had data in flight */
+    uint32_t not_ipv4;                  /**< Designated connections left to lwIP because they are not IPv4 */
+    uint32_t over_limit;                /**< Designated connections beyond max_connections */
+    uint32_t resynced;                  /**< Connections whose sequence numbers were taken from the firmware */
+    uint32_t lost;                      /**< Connections aborted on resume because the peer stopped answering */
+    uint32_t changed;                   /**< Connections lwIP used while offloaded, left untouched on resume */
+    uint32_t failures;                  /**< Offload iovars that failed */
+} whd_lwip_tko_stats_t;
+
+/******************************************************
+ *               Function Declarations
+ ******************************************************/
+
+/**
+ *  Start managing TCP keepalive offload on an interface.
+ *
+ * @param[in] iface_context  Wi-Fi STA interface the connections run over.
+ * @param[in] config         Keepalive timing, NULL for the defaults.
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_tko_start(whd_network_interface_context *iface_context, const whd_lwip_tko_config_t *config);
+
+/**
+ *  Stop the module, resuming first if the offload is enabled. The designations are dropped.
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if the module is not running.
+ */
+cy_rslt_t whd_lwip_tko_stop(void);
+
+/**
+ *  Designate the TCP connections with the given ports as long-lived.
+ *
+ *  A zero port matches any, so a remote port of 8883 designates every MQTT over TLS connection.
+ *
+ * @param[in] local_port   Local port, 0 for any.
+ * @param[in] remote_port  Remote port, 0 for any.
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if both ports are 0 or the
+ *         table is full.
+ */
+cy_rslt_t whd_lwip_tko_add(uint16_t local_port, uint16_t remote_port);
+
+/**
+ *  Remove a designation made with whd_lwip_tko_add().
+ *
+ * @param[in] local_port   Local port passed to whd_lwip_tko_add().
+ * @param[in] remote_port  Remote port passed to whd_lwip_tko_add().
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if there is no such designation.
+ */
+cy_rslt_t whd_lwip_tko_remove(uint16_t local_port, uint16_t remote_port);
+
+/**
+ *  Hand the idle designated connections to the firmware; call just before the host sleeps.
+ *
+ *  Issues iovars, so it cannot be called from the TCP/IP thread or with the core lock held.
+ *
+ * @param[out] num_offloaded  Connections handed over, may be NULL. With none the offload stays
+ *                            disabled, but whd_lwip_tko_resume() is still expected.
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_tko_suspend(uint32_t *num_offloaded);
+
+/**
+ *  Take the connections back from the firmware; call on wake, before sending on them.
+ *
+ * @return CY_RSLT_SUCCESS if successful; CY_RSLT_NETWORK_BAD_ARG if not suspended.
+ */
+cy_rslt_t whd_lwip_tko_resume(void);
+
+/**
+ *  Get the module counters.
+ *
+ * @param[out] stats  Module counters.
+ *
+ * @return CY_RSLT_SUCCESS if successful; failure code otherwise.
+ */
+cy_rslt_t whd_lwip_tko_get_stats(whd_lwip_tko_stats_t *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* WHD_NETWORK_TKO */
+#endif /* WHD_NETWORK_LWIP */
@@ -181,6 +181,29 @@ whd_result_t whd_host_buffer_add_remove_at_front(whd_buffer_t* buffer, int32_t a
  */
 void whd_host_network_process_ethernet_data(whd_interface_t interface, whd_buffer_t buffer);
 
+/** Called by WHD to pass received data to the network stack, with what the device reported about it
+ *
+ *  Same as \ref whd_host_network_process_ethernet_data. With WHD_NETWORK_CSUM_OFFLOAD, a TCP frame
+ *  flagged WHD_NETWORK_RX_CSUM_GOOD is not checked again.
+ *
+ *  @param interface : The interface on which the packet was received.
+ *  @param buffer    : Handle of the packet which has just been received. Responsibility for
+ *                    releasing this buffer is transferred from WHD at this point.
+ *  @param rx_flags  : WHD_NETWORK_RX_* flags
+ *
+ */
+void whd_host_network_process_ethernet_data_ext(whd_interface_t interface, whd_buffer_t buffer, uint32_t rx_flags);
+
+/** Called by WHD after each round of received packets
+ *
+ *  With WHD_NETWORK_GRO, TCP segments held back to be merged are passed to lwIP here at the latest.
+ *  Segments are only held back once this has been called for the interface.
+ *
+ *  @param interface : The interface concerned.
+ *
+ */
+void whd_host_network_rx_round_end(whd_interface_t interface);
+
 
 #ifdef __cplusplus
 }
@@ -64,11 +64,40 @@
 #include "whd_network_types.h"
 #include "whd_buffer_api.h"
 
-#ifdef COMPONENT_4390X
+#if defined(COMPONENT_4390X) || defined(WHD_NETWORK_OFFLOAD_SYNC) || defined(WHD_NETWORK_CSUM_OFFLOAD)
 #include "whd_wlioctl.h"
 #endif
 #endif
 
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+#include "lwip/prot/ethernet.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/ip6.h"
+#include "lwip/prot/tcp.h"
+#endif
+
+#if defined(WHD_NETWORK_OFFLOAD_SYNC) && !defined(CYBSP_WIFI_CAPABLE)
+#error "WHD_NETWORK_OFFLOAD_SYNC needs CYBSP_WIFI_CAPABLE"
+#endif
+
+#if defined(WHD_NETWORK_CSUM_OFFLOAD) && !defined(CYBSP_WIFI_CAPABLE)
+#error "WHD_NETWORK_CSUM_OFFLOAD needs CYBSP_WIFI_CAPABLE"
+#endif
+
+#if defined(WHD_NETWORK_CSUM_OFFLOAD) && !LWIP_CHECKSUM_CTRL_PER_NETIF
+#error "WHD_NETWORK_CSUM_OFFLOAD needs LWIP_CHECKSUM_CTRL_PER_NETIF in lwipopts.h"
+#endif
+
+#if defined(WHD_NETWORK_GRO) && !defined(WHD_NETWORK_CSUM_OFFLOAD)
+#error "WHD_NETWORK_GRO needs WHD_NETWORK_CSUM_OFFLOAD"
+#endif
+
+/* A merged segment is bigger than the MTU and cannot be forwarded */
+#if defined(WHD_NETWORK_GRO) && (IP_FORWARD || LWIP_IPV6_FORWARD)
+#error "WHD_NETWORK_GRO cannot be used with IP_FORWARD or LWIP_IPV6_FORWARD"
+#endif
+
 /* While using lwIP/sockets errno is required. Since IAR and ARMC6 doesn't define errno variable, the following definition is required for building it successfully. */
 #if !( (defined(__GNUC__) && !defined(__ARMCC_VERSION)) )
 int errno;
@@ -153,6 +182,103 @@ static cy_mutex_t *cy_prng_mutex_ptr;
 
 #endif
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+/* Offload features enabled for the synced addresses in the offload manager tables */
+#ifndef WHD_NETWORK_OFFLOAD_SYNC_V4_FEATURES
+#define WHD_NETWORK_OFFLOAD_SYNC_V4_FEATURES     (WL_OL_ARP)
+#endif
+#ifndef WHD_NETWORK_OFFLOAD_SYNC_V6_FEATURES
+#define WHD_NETWORK_OFFLOAD_SYNC_V6_FEATURES     (WL_OL_ND)
+#endif
+
+#define OFFLOAD_SYNC_ALL_TABLES                  (CY_NETWORK_OFFLOAD_SYNC_ARP_HOSTIP | CY_NETWORK_OFFLOAD_SYNC_INET_V4 | \
+                                                  CY_NETWORK_OFFLOAD_SYNC_INET_V6)
+#if LWIP_IPV6
+#define OFFLOAD_SYNC_MAX_IPV6                    (LWIP_IPV6_NUM_ADDRESSES)
+#else
+#define OFFLOAD_SYNC_MAX_IPV6                    (1)
+#endif
+
+/* Addresses of a netif that are worth offloading */
+typedef struct
+{
+    uint32_t ipv4;                                  /* 0 for none */
+    uint32_t ipv6_count;
+    uint32_t ipv6[OFFLOAD_SYNC_MAX_IPV6][4];        /* Valid (preferred or deprecated) addresses */
+} offload_sync_addrs_t;
+
+typedef struct
+{
+    bool                              enabled;
+    uint32_t                          tables;       /* CY_NETWORK_OFFLOAD_SYNC_* */
+    whd_network_interface_context    *iface;
+    cy_worker_thread_info_t          *worker;
+    cy_worker_thread_work_t           work;
+    uint32_t                          arp_hostip;   /* What was last programmed in each table */
+    uint32_t                          inet_v4;
+    offload_sync_addrs_t              inet_v6;
+    uint32_t                          arp_service_base;
+    whd_network_offload_sync_stats_t  stats;
+} offload_sync_t;
+
+/* Indexed like the interfaces; the mutex is taken by the worker and application threads, never in the tcpip thread */
+static offload_sync_t offload_sync[CY_IFACE_MAX_HANDLE];
+static cy_mutex_t offload_sync_mutex;
+static bool offload_sync_mutex_inited = false;
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+NETIF_DECLARE_EXT_CALLBACK(offload_sync_netif_callback)
+static bool offload_sync_callback_added = false;
+#endif
+#endif /* WHD_NETWORK_OFFLOAD_SYNC */
+
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+#ifndef WHD_NETWORK_GRO_MAX_SEGS
+#define WHD_NETWORK_GRO_MAX_SEGS                  (8)
+#endif
+
+/* Where the TCP segment of a frame is */
+typedef struct
+{
+    uint16_t ip_offset;
+    uint16_t tcp_offset;
+    uint16_t tcp_len;
+    bool     ipv4;
+} csum_offload_tcp_t;
+
+typedef enum
+{
+    CSUM_OFFLOAD_RX_OTHER,              /* Not TCP, lwIP checks it */
+    CSUM_OFFLOAD_RX_TCP,                /* TCP segment found */
+    CSUM_OFFLOAD_RX_TCP_UNCHECKABLE     /* TCP, but the segment cannot be checked, e.g. an IP fragment */
+} csum_offload_rx_t;
+
+#ifdef WHD_NETWORK_GRO
+/* Segment held back for the next ones of its flow to be merged into; used in the WHD thread only */
+typedef struct
+{
+    struct pbuf        *held;
+    csum_offload_tcp_t  tcp;
+    uint16_t            hdr_len;        /* Up to the end of the TCP options */
+    uint16_t            segs;           /* Segments in held, itself included */
+    uint32_t            next_seq;       /* Sequence number that continues held, host order */
+    bool                rounds;         /* WHD reports the end of its receive rounds */
+} csum_offload_gro_t;
+#endif /* WHD_NETWORK_GRO */
+
+typedef struct
+{
+    whd_network_csum_offload_stats_t stats;
+    bool                rx_verify;      /* lwIP does not check received TCP checksums, the glue does */
+#ifdef WHD_NETWORK_GRO
+    csum_offload_gro_t  gro;
+#endif
+} csum_offload_t;
+
+/* Indexed like the interfaces. The TX counters are written in the tcpip thread and the RX ones in
+ * the WHD thread; the application reads them without a lock. */
+static csum_offload_t csum_offload[CY_IFACE_MAX_HANDLE];
+#endif /* WHD_NETWORK_CSUM_OFFLOAD */
+
 /******************************************************
  *               Static Function Declarations
  ******************************************************/
@@ -164,6 +290,16 @@ static void internal_ip_change_callback (struct netif *netif);
 static bool is_interface_added(uint8_t interface_index);
 static cy_rslt_t is_interface_valid(whd_network_interface_context *iface);
 static bool is_network_up(uint8_t interface_index);
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+static void offload_sync_request(struct netif *netif);
+static void offload_sync_now(uint8_t interface_index);
+#endif
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+static void csum_offload_input(struct netif *iface, struct pbuf *p, uint32_t rx_flags);
+#endif
+#ifdef WHD_NETWORK_GRO
+static void csum_offload_gro_flush(csum_offload_t *co, struct netif *iface);
+#endif
 
 #if LWIP_IPV4
 static void ping_prepare_echo(struct icmp_packet *iecho, uint16_t len, uint16_t *ping_seq_num);
@@ -337,6 +473,17 @@ bool whd_nw_ntoa_ipv6 (whd_nw_ip_address_t *addr, char *ip_str)
     sprintf(ip_str, "%0x:%0x:%0x:%0x", (unsigned int)NW_HTONL(addr->ip.v6[0]), (unsigned int)NW_HTONL(addr->ip.v6[1]), (unsigned int)NW_HTONL(addr->ip.v6[2]), (unsigned int)NW_HTONL(addr->ip.v6[3]));
     return 0;
 }
+/* Passes a packet to lwIP, or drops it if the interface is not set up or lwIP does not take it */
+static void wifi_input(struct netif *net_interface, struct pbuf *p)
+{
+    WPRINT_WHD_DEBUG(("Send data up to LwIP \n"));
+    if (net_interface->input == NULL || net_interface->input(p, net_interface) != ERR_OK)
+    {
+        WPRINT_WHD_ERROR(("Drop packet before lwip \n"));
+        whd_host_buffer_release(p, WHD_NETWORK_RX) ;
+    }
+}
+
 /*
  * This function takes packets from the radio driver and passes them into the
  * lwIP stack. If the stack is not initialized, or if the lwIP stack does not
@@ -345,6 +492,12 @@ bool whd_nw_ntoa_ipv6 (whd_nw_ip_address_t *addr, char *ip_str)
  * handler and should be freed by the EAPOL handler.
  */
 void whd_host_network_process_ethernet_data(whd_interface_t iface, whd_buffer_t buf)
+{
+    whd_host_network_process_ethernet_data_ext(iface, buf, 0);
+}
+
+/* Same, with the WHD_NETWORK_RX_* flags of the packet */
+void whd_host_network_process_ethernet_data_ext(whd_interface_t iface, whd_buffer_t buf, uint32_t rx_flags)
 {
     uint8_t *data = whd_buffer_get_current_piece_data_pointer(iface->whd_driver, buf);
     uint16_t ethertype;
@@ -390,28 +543,693 @@ void whd_host_network_process_ethernet_data(whd_interface_t iface, whd_buffer_t
             activity_callback(false);
         }
 
-        WPRINT_WHD_DEBUG(("Send data up to LwIP \n"));
-        /* If the interface is not yet set up, drop the packet */
-        if (net_interface->input == NULL || net_interface->input(buf, net_interface) != ERR_OK)
-        {
-            WPRINT_WHD_ERROR(("Drop packet before lwip \n"));
-            whd_host_buffer_release(buf, WHD_NETWORK_RX) ;
-        }
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+        csum_offload_input(net_interface, buf, rx_flags);
+#else
+        (void)rx_flags;
+        wifi_input(net_interface, buf);
+#endif
     }
     WPRINT_WHD_DEBUG(("%s(): END \n", __FUNCTION__ ));
 }
 
+/*
+ * Called by WHD after each round of received packets. Segments held back to be merged are
+ * passed to lwIP here at the latest.
+ */
+void whd_host_network_rx_round_end(whd_interface_t iface)
+{
+#ifdef WHD_NETWORK_GRO
+    struct netif *net_interface;
+    whd_network_interface_context *if_ctx;
+    csum_offload_t *co;
+
+    if (iface->role == WHD_STA_ROLE)
+    {
+        net_interface = &sta_ip_handle;
+    }
+    else if (iface->role == WHD_AP_ROLE)
+    {
+        net_interface = &ap_ip_handle;
+    }
+    else
+    {
+        return;
+    }
+    if_ctx = (whd_network_interface_context *)net_interface->state;
+    if (if_ctx == NULL)
+    {
+        return;
+    }
+    co = &csum_offload[if_ctx->iface_type & 3];
+    csum_offload_gro_flush(co, net_interface);
+    co->gro.rounds = true;
+#else
+    (void)iface;
+#endif
+}
+
 /* Create a duplicate pbuf of the input pbuf */
 static struct pbuf *pbuf_dup(const struct pbuf *orig)
 {
     struct pbuf *p = pbuf_alloc(PBUF_LINK, orig->tot_len, PBUF_RAM);
     if (p != NULL)
     {
-        pbuf_copy(p, orig);
-        p->flags = orig->flags;
+        pbuf_copy(p, orig);
+        p->flags = orig->flags;
+    }
+    return p;
+}
+
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+/*
+ * lwIP does not make the TCP checksums of the Wi-Fi interfaces. IPv4 TCP frames get the pseudo
+ * header sum in their checksum field for the firmware to complete, as Linux hands them to the
+ * dongle with CHECKSUM_PARTIAL. Without firmware support, and for IPv6, the checksum is summed
+ * while wifioutput copies the frame, so the segment is read once instead of twice.
+ *
+ * On receive, lwIP can only stop checking TCP checksums for a whole interface. It stops when the
+ * firmware checks them, or when GRO merges segments, and the glue checks the TCP frames that do
+ * not come with WHD_NETWORK_RX_CSUM_GOOD.
+ */
+
+/* Finds the TCP segment of an Ethernet frame; false if it is not an unfragmented TCP frame.
+ * lwIP builds the Ethernet, IP and TCP headers in the first pbuf, so only that one is read. */
+static bool csum_offload_find_tcp(const struct pbuf *p, csum_offload_tcp_t *tcp)
+{
+    const uint8_t *frame = (const uint8_t *)p->payload;
+    uint16_t len = p->len;
+    uint16_t offset = SIZEOF_ETH_HDR;
+    uint16_t ethertype;
+    uint16_t ip_hlen;
+    uint16_t ip_len;
+
+    if(len < SIZEOF_ETH_HDR)
+    {
+        return false;
+    }
+    ethertype = (uint16_t)(frame[12] << 8 | frame[13]);
+    if(ethertype == ETHTYPE_VLAN)
+    {
+        if(len < SIZEOF_ETH_HDR + SIZEOF_VLAN_HDR)
+        {
+            return false;
+        }
+        ethertype = (uint16_t)(frame[16] << 8 | frame[17]);
+        offset += SIZEOF_VLAN_HDR;
+    }
+
+    if((ethertype == ETHTYPE_IP) && (len >= offset + IP_HLEN))
+    {
+        ip_hlen = (uint16_t)((frame[offset] & 0x0f) * 4);
+        ip_len = (uint16_t)(frame[offset + 2] << 8 | frame[offset + 3]);
+        if((frame[offset + 9] != IP_PROTO_TCP) || ((frame[offset + 6] & 0x3f) != 0) || (frame[offset + 7] != 0) ||
+           (ip_hlen < IP_HLEN) || (ip_len < ip_hlen + TCP_HLEN) || (offset + ip_len > p->tot_len))
+        {
+            return false;
+        }
+        tcp->ipv4 = true;
+        tcp->tcp_len = (uint16_t)(ip_len - ip_hlen);
+    }
+    else if((ethertype == ETHTYPE_IPV6) && (len >= offset + IP6_HLEN))
+    {
+        /* lwIP puts no extension header in front of TCP */
+        ip_hlen = IP6_HLEN;
+        ip_len = (uint16_t)(frame[offset + 4] << 8 | frame[offset + 5]);
+        if((frame[offset + 6] != IP_PROTO_TCP) || (ip_len < TCP_HLEN) || (offset + IP6_HLEN + ip_len > p->tot_len))
+        {
+            return false;
+        }
+        tcp->ipv4 = false;
+        tcp->tcp_len = ip_len;
+    }
+    else
+    {
+        return false;
+    }
+    tcp->ip_offset = offset;
+    tcp->tcp_offset = (uint16_t)(offset + ip_hlen);
+    return (len >= tcp->tcp_offset + TCP_HLEN);
+}
+
+/* Adds the 16 bit words of a block to a one's complement sum; an odd last byte is padded with zero */
+static uint32_t csum_offload_add(uint32_t acc, const uint8_t *data, uint16_t len)
+{
+    uint16_t word;
+    uint8_t last[2] = { 0, 0 };
+
+    for(; len >= 2; len -= 2, data += 2)
+    {
+        memcpy(&word, data, sizeof(word));
+        acc += word;
+    }
+    if(len != 0)
+    {
+        last[0] = *data;
+        memcpy(&word, last, sizeof(word));
+        acc += word;
+    }
+    return acc;
+}
+
+static uint16_t csum_offload_fold(uint32_t acc)
+{
+    acc = (acc >> 16) + (acc & 0xffffUL);
+    acc += acc >> 16;
+    return (uint16_t)acc;
+}
+
+/* Copies a block and returns the one's complement sum of its 16 bit words, in host order */
+static uint32_t csum_offload_copy(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+    uint32_t acc = 0;
+    uint32_t word;
+    uint16_t half;
+    uint8_t last[2] = { 0, 0 };
+
+    /* At most 16383 words, each adding less than 2^17: the sum cannot overflow */
+    for(; len >= 4; len -= 4, src += 4, dst += 4)
+    {
+        memcpy(&word, src, sizeof(word));
+        memcpy(dst, &word, sizeof(word));
+        acc += (word & 0xffffUL) + (word >> 16);
+    }
+    if(len >= 2)
+    {
+        memcpy(&half, src, sizeof(half));
+        memcpy(dst, &half, sizeof(half));
+        acc += half;
+        len -= 2;
+        src += 2;
+        dst += 2;
+    }
+    if(len != 0)
+    {
+        /* An odd last byte is the high order byte of a word padded with zero */
+        *dst = *src;
+        last[0] = *src;
+        memcpy(&half, last, sizeof(half));
+        acc += half;
+    }
+    return acc;
+}
+
+/* Sum of the IPv4 or IPv6 pseudo header */
+static uint32_t csum_offload_pseudo(const uint8_t *frame, const csum_offload_tcp_t *tcp)
+{
+    uint32_t acc;
+
+    if(tcp->ipv4)
+    {
+        acc = csum_offload_add(0, frame + tcp->ip_offset + 12, 2 * sizeof(uint32_t));
+    }
+    else
+    {
+        acc = csum_offload_add(0, frame + tcp->ip_offset + 8, 2 * 4 * sizeof(uint32_t));
+    }
+    return acc + lwip_htons(IP_PROTO_TCP) + lwip_htons(tcp->tcp_len);
+}
+
+/* pbuf_dup that also makes the TCP checksum, or prepares the frame for the firmware to make it */
+static struct pbuf *csum_offload_dup(whd_network_csum_offload_stats_t *stats, const struct pbuf *orig)
+{
+    const struct pbuf *q;
+    const uint8_t *src;
+    struct pbuf *p;
+    uint8_t *dst;
+    csum_offload_tcp_t tcp;
+    uint16_t hdr_len;
+    uint16_t sum_end;
+    uint16_t done;
+    uint16_t skip;
+    uint16_t piece;
+    uint16_t n;
+    uint16_t sum;
+    uint32_t acc;
+
+    if(!csum_offload_find_tcp(orig, &tcp))
+    {
+        return pbuf_dup(orig);
+    }
+
+    if(tcp.ipv4 && ((stats->toe_ol & TOE_TX_CSUM_OL) != 0))
+    {
+        p = pbuf_dup(orig);
+        if(p != NULL)
+        {
+            dst = (uint8_t *)p->payload;
+            sum = csum_offload_fold(csum_offload_pseudo(dst, &tcp));
+            memcpy(dst + tcp.tcp_offset + 16, &sum, sizeof(sum));
+            stats->tx_firmware++;
+        }
+        return p;
+    }
+
+    p = pbuf_alloc(PBUF_LINK, orig->tot_len, PBUF_RAM);
+    if(p == NULL)
+    {
+        return NULL;
+    }
+    p->flags = orig->flags;
+    dst = (uint8_t *)p->payload;
+
+    /* The headers up to the end of the fixed TCP header, with the checksum field cleared */
+    hdr_len = (uint16_t)(tcp.tcp_offset + TCP_HLEN);
+    memcpy(dst, orig->payload, hdr_len);
+    dst[tcp.tcp_offset + 16] = 0;
+    dst[tcp.tcp_offset + 17] = 0;
+    acc = csum_offload_add(csum_offload_pseudo(dst, &tcp), dst + tcp.tcp_offset, TCP_HLEN);
+
+    /* The rest of the frame. A piece starting at an odd offset into the segment has its sum
+     * byte swapped; anything after the segment is copied without being summed. */
+    sum_end = (uint16_t)(tcp.tcp_offset + tcp.tcp_len);
+    done = hdr_len;
+    for(q = orig, skip = hdr_len; q != NULL; q = q->next, skip = 0)
+    {
+        if(q->len <= skip)
+        {
+            continue;
+        }
+        src = (const uint8_t *)q->payload + skip;
+        piece = (uint16_t)(q->len - skip);
+        n = (done < sum_end) ? (uint16_t)LWIP_MIN(piece, sum_end - done) : 0;
+        sum = csum_offload_fold(csum_offload_copy(dst + done, src, n));
+        if(((done - tcp.tcp_offset) & 1) != 0)
+        {
+            sum = (uint16_t)((sum << 8) | (sum >> 8));
+        }
+        acc += sum;
+        if(piece > n)
+        {
+            memcpy(dst + done + n, src + n, piece - n);
+        }
+        done = (uint16_t)(done + piece);
+    }
+
+    sum = (uint16_t)~csum_offload_fold(acc);
+    memcpy(dst + tcp.tcp_offset + 16, &sum, sizeof(sum));
+    stats->tx_on_copy++;
+    return p;
+}
+
+/* Finds the TCP segment of a received frame. WHD receives a frame into one pbuf, so only that one
+ * is read. IPv6 extension headers are skipped, as lwIP does. */
+static csum_offload_rx_t csum_offload_rx_find_tcp(const struct pbuf *p, csum_offload_tcp_t *tcp)
+{
+    const uint8_t *frame = (const uint8_t *)p->payload;
+    uint16_t len = p->len;
+    uint16_t offset = SIZEOF_ETH_HDR;
+    uint16_t ethertype;
+    uint16_t ip_hlen;
+    uint16_t ip_len;
+    uint8_t nexth;
+
+    if(len < SIZEOF_ETH_HDR)
+    {
+        return CSUM_OFFLOAD_RX_OTHER;
+    }
+    ethertype = (uint16_t)(frame[12] << 8 | frame[13]);
+    if(ethertype == ETHTYPE_VLAN)
+    {
+        if(len < SIZEOF_ETH_HDR + SIZEOF_VLAN_HDR)
+        {
+            return CSUM_OFFLOAD_RX_OTHER;
+        }
+        ethertype = (uint16_t)(frame[16] << 8 | frame[17]);
+        offset += SIZEOF_VLAN_HDR;
+    }
+
+    if(ethertype == ETHTYPE_IP)
+    {
+        if((len < offset + IP_HLEN) || (frame[offset + 9] != IP_PROTO_TCP))
+        {
+            return CSUM_OFFLOAD_RX_OTHER;
+        }
+        ip_hlen = (uint16_t)((frame[offset] & 0x0f) * 4);
+        ip_len = (uint16_t)(frame[offset + 2] << 8 | frame[offset + 3]);
+        if(((frame[offset + 6] & 0x3f) != 0) || (frame[offset + 7] != 0) ||
+           (ip_hlen < IP_HLEN) || (ip_len < ip_hlen + TCP_HLEN) || (offset + ip_len > p->tot_len))
+        {
+            return CSUM_OFFLOAD_RX_TCP_UNCHECKABLE;
+        }
+        tcp->ipv4 = true;
+        tcp->tcp_len = (uint16_t)(ip_len - ip_hlen);
+    }
+    else if(ethertype == ETHTYPE_IPV6)
+    {
+        if(len < offset + IP6_HLEN)
+        {
+            return CSUM_OFFLOAD_RX_OTHER;
+        }
+        ip_hlen = IP6_HLEN;
+        ip_len = (uint16_t)(frame[offset + 4] << 8 | frame[offset + 5]);
+        nexth = frame[offset + 6];
+        while(nexth != IP6_NEXTH_TCP)
+        {
+            if((nexth != IP6_NEXTH_HOPBYHOP) && (nexth != IP6_NEXTH_ROUTING) &&
+               (nexth != IP6_NEXTH_DESTOPTS) && (nexth != IP6_NEXTH_FRAGMENT))
+            {
+                return CSUM_OFFLOAD_RX_OTHER;
+            }
+            if(len < offset + ip_hlen + 8)
+            {
+                return CSUM_OFFLOAD_RX_TCP_UNCHECKABLE;
+            }
+            if(nexth == IP6_NEXTH_FRAGMENT)
+            {
+                /* The fragmentable part may hold TCP */
+                nexth = frame[offset + ip_hlen];
+                return ((nexth == IP6_NEXTH_TCP) || (nexth == IP6_NEXTH_HOPBYHOP) || (nexth == IP6_NEXTH_ROUTING) ||
+                        (nexth == IP6_NEXTH_DESTOPTS) || (nexth == IP6_NEXTH_FRAGMENT)) ?
+                       CSUM_OFFLOAD_RX_TCP_UNCHECKABLE : CSUM_OFFLOAD_RX_OTHER;
+            }
+            nexth = frame[offset + ip_hlen];
+            ip_hlen = (uint16_t)(ip_hlen + (frame[offset + ip_hlen + 1] + 1) * 8);
+        }
+        if((ip_len < ip_hlen - IP6_HLEN + TCP_HLEN) || (offset + IP6_HLEN + ip_len > p->tot_len))
+        {
+            return CSUM_OFFLOAD_RX_TCP_UNCHECKABLE;
+        }
+        tcp->ipv4 = false;
+        tcp->tcp_len = (uint16_t)(ip_len - (ip_hlen - IP6_HLEN));
+    }
+    else
+    {
+        return CSUM_OFFLOAD_RX_OTHER;
+    }
+    tcp->ip_offset = offset;
+    tcp->tcp_offset = (uint16_t)(offset + ip_hlen);
+    return (len >= tcp->tcp_offset + TCP_HLEN) ? CSUM_OFFLOAD_RX_TCP : CSUM_OFFLOAD_RX_TCP_UNCHECKABLE;
+}
+
+/* Checks the TCP checksum of a received segment in place */
+static bool csum_offload_rx_check(const struct pbuf *p, const csum_offload_tcp_t *tcp)
+{
+    const struct pbuf *q;
+    uint32_t acc = csum_offload_pseudo((const uint8_t *)p->payload, tcp);
+    uint16_t skip = tcp->tcp_offset;
+    uint16_t left = tcp->tcp_len;
+    uint16_t done = 0;
+    uint16_t n;
+    uint16_t sum;
+
+    for(q = p; (q != NULL) && (left != 0); q = q->next)
+    {
+        if(q->len <= skip)
+        {
+            skip = (uint16_t)(skip - q->len);
+            continue;
+        }
+        n = (uint16_t)LWIP_MIN(q->len - skip, left);
+        sum = csum_offload_fold(csum_offload_add(0, (const uint8_t *)q->payload + skip, n));
+        if((done & 1) != 0)
+        {
+            sum = (uint16_t)((sum << 8) | (sum >> 8));
+        }
+        acc += sum;
+        done = (uint16_t)(done + n);
+        left = (uint16_t)(left - n);
+        skip = 0;
+    }
+    return (left == 0) && (csum_offload_fold(acc) == 0xffff);
+}
+
+#ifdef WHD_NETWORK_GRO
+/*
+ * GRO merges the in-order TCP segments of a flow received in one WHD receive round into the first
+ * of them, as a pbuf chain that lwIP takes as one segment. lwIP then runs its TCP input, and makes
+ * its delayed ACK, once per merged segment instead of once per segment. The sender sees fewer ACKs
+ * for the same data; lwIP still sends a window update when the application takes the data
+ * (tcp_recved), so the sender is not held up.
+ *
+ * Only a plain ACK with data is merged. Anything else passes the held segment to lwIP first, so
+ * lwIP sees the frames of an interface in the order they came.
+ */
+
+/* Payload of a segment GRO can merge, 0 if it cannot be merged */
+static uint16_t csum_offload_gro_payload(const struct pbuf *p, const csum_offload_tcp_t *tcp, uint32_t rx_flags,
+                                         uint16_t *hdr_len)
+{
+    const uint8_t *frame = (const uint8_t *)p->payload;
+    uint16_t th_len = (uint16_t)((frame[tcp->tcp_offset + 12] >> 4) * 4);
+
+    if(((frame[tcp->tcp_offset + 13] & ~TCP_PSH) != TCP_ACK) || (th_len < TCP_HLEN) || (th_len >= tcp->tcp_len) ||
+       (tcp->tcp_offset + th_len > p->len) || (tcp->tcp_offset + tcp->tcp_len != p->tot_len))
+    {
+        return 0;
+    }
+    if(tcp->ipv4)
+    {
+        /* The IPv4 header is rewritten when segments are merged, so a bad one must not get a good checksum */
+        if((tcp->tcp_offset != tcp->ip_offset + IP_HLEN) ||
+           (((rx_flags & WHD_NETWORK_RX_CSUM_GOOD) == 0) &&
+            (csum_offload_fold(csum_offload_add(0, frame + tcp->ip_offset, IP_HLEN)) != 0xffff)))
+        {
+            return 0;
+        }
+    }
+    else if(tcp->tcp_offset != tcp->ip_offset + IP6_HLEN)
+    {
+        return 0;
+    }
+    *hdr_len = (uint16_t)(tcp->tcp_offset + th_len);
+    return (uint16_t)(tcp->tcp_len - th_len);
+}
+
+/* Whether a segment continues the held one: same link header, addresses, ports, ACK and options,
+ * and the next sequence number. The window is left out; the merged segment takes the newest. */
+static bool csum_offload_gro_same_flow(const csum_offload_gro_t *gro, const uint8_t *frame, const csum_offload_tcp_t *tcp,
+                                       uint16_t hdr_len)
+{
+    const uint8_t *held = (const uint8_t *)gro->held->payload;
+    uint16_t ip = tcp->ip_offset;
+    uint16_t th = tcp->tcp_offset;
+    uint32_t seq;
+
+    if((hdr_len != gro->hdr_len) || (th != gro->tcp.tcp_offset) || (tcp->ipv4 != gro->tcp.ipv4) ||
+       (memcmp(frame, held, ip) != 0))
+    {
+        return false;
+    }
+    if(tcp->ipv4)
+    {
+        /* TOS, DF, TTL and addresses */
+        if((frame[ip + 1] != held[ip + 1]) || (frame[ip + 6] != held[ip + 6]) || (frame[ip + 8] != held[ip + 8]) ||
+           (memcmp(frame + ip + 12, held + ip + 12, 2 * sizeof(uint32_t)) != 0))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        /* Traffic class, flow label, hop limit and addresses */
+        if((memcmp(frame + ip, held + ip, sizeof(uint32_t)) != 0) || (frame[ip + 7] != held[ip + 7]) ||
+           (memcmp(frame + ip + 8, held + ip + 8, 2 * 4 * sizeof(uint32_t)) != 0))
+        {
+            return false;
+        }
+    }
+    /* Ports, ACK number, header length and options */
+    if((memcmp(frame + th, held + th, 4) != 0) || (memcmp(frame + th + 8, held + th + 8, 5) != 0) ||
+       (memcmp(frame + th + TCP_HLEN, held + th + TCP_HLEN, hdr_len - th - TCP_HLEN) != 0))
+    {
+        return false;
+    }
+    memcpy(&seq, frame + th + 4, sizeof(seq));
+    return (lwip_ntohl(seq) == gro->next_seq);
+}
+
+/* Passes the held segment to lwIP, with its IP length set to what was merged into it */
+static void csum_offload_gro_flush(csum_offload_t *co, struct netif *iface)
+{
+    csum_offload_gro_t *gro = &co->gro;
+    struct pbuf *p = gro->held;
+    uint8_t *frame;
+    uint16_t ip;
+    uint16_t len;
+    uint16_t sum;
+
+    if(p == NULL)
+    {
+        return;
+    }
+    gro->held = NULL;
+    if(gro->segs > 1)
+    {
+        frame = (uint8_t *)p->payload;
+        ip = gro->tcp.ip_offset;
+        if(gro->tcp.ipv4)
+        {
+            len = lwip_htons((uint16_t)(p->tot_len - ip));
+            memcpy(frame + ip + 2, &len, sizeof(len));
+            frame[ip + 10] = 0;
+            frame[ip + 11] = 0;
+            sum = (uint16_t)~csum_offload_fold(csum_offload_add(0, frame + ip, IP_HLEN));
+            memcpy(frame + ip + 10, &sum, sizeof(sum));
+        }
+        else
+        {
+            len = lwip_htons((uint16_t)(p->tot_len - ip - IP6_HLEN));
+            memcpy(frame + ip + 4, &len, sizeof(len));
+        }
+        co->stats.gro_chains++;
+    }
+    wifi_input(iface, p);
+}
+
+/* Merges a checked TCP segment into the held one, holds it, or passes it to lwIP */
+static void csum_offload_gro(csum_offload_t *co, struct netif *iface, struct pbuf *p, const csum_offload_tcp_t *tcp,
+                             uint32_t rx_flags)
+{
+    csum_offload_gro_t *gro = &co->gro;
+    uint8_t *frame = (uint8_t *)p->payload;
+    uint8_t *held;
+    uint16_t th = tcp->tcp_offset;
+    uint16_t hdr_len = 0;
+    uint16_t payload;
+    uint32_t seq;
+    bool psh;
+
+    /* Until WHD is known to end its rounds, a held segment might never be passed on */
+    payload = gro->rounds ? csum_offload_gro_payload(p, tcp, rx_flags, &hdr_len) : 0;
+    if(payload == 0)
+    {
+        csum_offload_gro_flush(co, iface);
+        wifi_input(iface, p);
+        return;
+    }
+    psh = ((frame[th + 13] & TCP_PSH) != 0);
+
+    if((gro->held != NULL) && ((uint32_t)gro->held->tot_len + payload <= 0xffff) &&
+       csum_offload_gro_same_flow(gro, frame, tcp, hdr_len))
+    {
+        held = (uint8_t *)gro->held->payload;
+        memcpy(held + th + 14, frame + th + 14, sizeof(uint16_t));
+        held[th + 13] |= (uint8_t)(frame[th + 13] & TCP_PSH);
+        pbuf_header(p, (s16_t)(-hdr_len));
+        pbuf_cat(gro->held, p);
+        gro->segs++;
+        gro->next_seq += payload;
+        co->stats.gro_merged++;
+        if(psh || (gro->segs >= WHD_NETWORK_GRO_MAX_SEGS))
+        {
+            csum_offload_gro_flush(co, iface);
+        }
+        return;
+    }
+
+    csum_offload_gro_flush(co, iface);
+    if(psh)
+    {
+        wifi_input(iface, p);
+        return;
+    }
+    memcpy(&seq, frame + th + 4, sizeof(seq));
+    gro->held = p;
+    gro->tcp = *tcp;
+    gro->hdr_len = hdr_len;
+    gro->segs = 1;
+    gro->next_seq = lwip_ntohl(seq) + payload;
+}
+#endif /* WHD_NETWORK_GRO */
+
+/* Checks the TCP checksum of a received frame unless the firmware did, then passes the frame on */
+static void csum_offload_input(struct netif *iface, struct pbuf *p, uint32_t rx_flags)
+{
+    whd_network_interface_context *if_ctx = (whd_network_interface_context *)iface->state;
+    csum_offload_t *co;
+    csum_offload_tcp_t tcp;
+    csum_offload_rx_t kind;
+
+    if(if_ctx == NULL)
+    {
+        wifi_input(iface, p);
+        return;
+    }
+    co = &csum_offload[if_ctx->iface_type & 3];
+    if(!co->rx_verify)
+    {
+        wifi_input(iface, p);
+        return;
+    }
+
+    kind = csum_offload_rx_find_tcp(p, &tcp);
+    if((kind == CSUM_OFFLOAD_RX_TCP) && ((rx_flags & WHD_NETWORK_RX_CSUM_GOOD) != 0))
+    {
+        co->stats.rx_firmware++;
+    }
+    else if((kind == CSUM_OFFLOAD_RX_TCP) && csum_offload_rx_check(p, &tcp))
+    {
+        co->stats.rx_verified++;
+    }
+    else if(kind != CSUM_OFFLOAD_RX_OTHER)
+    {
+        /* lwIP would not check it either */
+        co->stats.rx_bad++;
+        whd_host_buffer_release(p, WHD_NETWORK_RX);
+        return;
+    }
+
+#ifdef WHD_NETWORK_GRO
+    if(kind == CSUM_OFFLOAD_RX_TCP)
+    {
+        csum_offload_gro(co, iface, p, &tcp, rx_flags);
+        return;
+    }
+    csum_offload_gro_flush(co, iface);
+#endif
+    wifi_input(iface, p);
+}
+
+/* Takes the TCP checksums of a Wi-Fi interface away from lwIP */
+static void csum_offload_init(struct netif *iface, whd_network_interface_context *if_ctx)
+{
+    csum_offload_t *co = &csum_offload[if_ctx->iface_type & 3];
+    whd_network_csum_offload_stats_t *stats = &co->stats;
+    whd_interface_t whd_iface = (whd_interface_t)if_ctx->hw_interface;
+
+    /* Firmware that cannot check received checksums may still make transmit ones */
+    memset(co, 0, sizeof(*co));
+    if(((whd_toe_set(whd_iface, TOE_TX_CSUM_OL | TOE_RX_CSUM_OL) != WHD_SUCCESS) &&
+        (whd_toe_set(whd_iface, TOE_TX_CSUM_OL) != WHD_SUCCESS)) ||
+       (whd_toe_get(whd_iface, &stats->toe_ol) != WHD_SUCCESS))
+    {
+        stats->toe_ol = 0;
+    }
+    WPRINT_WHD_INFO(("TCP checksums made by the %s\n", ((stats->toe_ol & TOE_TX_CSUM_OL) != 0) ? "firmware" : "host on copy"));
+
+#ifdef WHD_NETWORK_GRO
+    co->rx_verify = true;
+#else
+    co->rx_verify = ((stats->toe_ol & TOE_RX_CSUM_OL) != 0);
+#endif
+    WPRINT_WHD_INFO(("Received TCP checksums checked by %s\n", co->rx_verify ? "the firmware or the glue" : "lwIP"));
+
+    if(co->rx_verify)
+    {
+        NETIF_SET_CHECKSUM_CTRL(iface, NETIF_CHECKSUM_ENABLE_ALL & ~(NETIF_CHECKSUM_GEN_TCP | NETIF_CHECKSUM_CHECK_TCP));
+    }
+    else
+    {
+        NETIF_SET_CHECKSUM_CTRL(iface, NETIF_CHECKSUM_ENABLE_ALL & ~NETIF_CHECKSUM_GEN_TCP);
+    }
+}
+
+/* Drops what a removed Wi-Fi interface still holds and forgets its offload state */
+static void csum_offload_deinit(whd_network_interface_context *if_ctx)
+{
+    csum_offload_t *co = &csum_offload[if_ctx->iface_type & 3];
+
+#ifdef WHD_NETWORK_GRO
+    /* The netif is gone, so the segment cannot be passed on any more */
+    if(co->gro.held != NULL)
+    {
+        whd_host_buffer_release(co->gro.held, WHD_NETWORK_RX);
     }
-    return p;
+#endif
+    memset(co, 0, sizeof(*co));
 }
+#endif /* WHD_NETWORK_CSUM_OFFLOAD */
 
 /*
  * This function takes the packets from the lwIP stack and sends them down to the radio.
@@ -433,7 +1251,11 @@ static err_t wifioutput(struct netif *iface, struct pbuf *p)
         return ERR_INPROGRESS ;
     }
 
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+    struct pbuf *whd_buf = csum_offload_dup(&csum_offload[if_ctx->iface_type & 3].stats, p);
+#else
     struct pbuf *whd_buf = pbuf_dup(p);
+#endif
     if (whd_buf == NULL)
     {
         WPRINT_WHD_ERROR(("failed to allocate buffer for outgoing packet\n"));
@@ -620,6 +1442,10 @@ static err_t wifiinit(struct netif *iface)
     netif_set_igmp_mac_filter(iface, igmp_filter) ;
 #endif
 
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+    csum_offload_init(iface, if_ctx);
+#endif
+
 
 #if LWIP_IPV6 == 1
     /*
@@ -722,6 +1548,17 @@ cy_rslt_t whd_network_deinit( void )
         connectivity_lib_init--;
         if(connectivity_lib_init == 0)
         {
+#if defined(WHD_NETWORK_OFFLOAD_SYNC) && LWIP_NETIF_EXT_STATUS_CALLBACK
+            if(offload_sync_callback_added)
+            {
+                if (activity_callback)
+                {
+                    activity_callback(true);
+                }
+                PROTECTED_FUNC_CALL(netif_remove_ext_callback(&offload_sync_netif_callback));
+                offload_sync_callback_added = false;
+            }
+#endif
         }
     }
 
@@ -959,10 +1796,20 @@ cy_rslt_t whd_network_remove_nw_interface(whd_network_interface_context *iface_c
         return CY_RSLT_NETWORK_ERROR_REMOVING_INTERFACE;
     }
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+    (void)whd_network_offload_sync_stop(iface_context);
+#endif
+
     /* Remove the status callback */
     netif_set_remove_callback(LWIP_IP_HANDLE(interface_index), internal_ip_change_callback);
     /* Remove the interface */
     netifapi_netif_remove(LWIP_IP_HANDLE(interface_index));
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+    if(iface_context->iface_type == CY_NETWORK_WIFI_STA_INTERFACE || iface_context->iface_type == CY_NETWORK_WIFI_AP_INTERFACE)
+    {
+        csum_offload_deinit(iface_context);
+    }
+#endif
     if(iface_context->iface_type == CY_NETWORK_WIFI_STA_INTERFACE || iface_context->iface_type == CY_NETWORK_ETH_INTERFACE)
     {
         is_dhcp_client_required = false;
@@ -985,6 +1832,21 @@ cy_rslt_t whd_network_remove_nw_interface(whd_network_interface_context *iface_c
     }
 #endif
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+    /* offload_sync_mutex is initialized when the sync is first started; the sync of each
+     * interface was stopped above, so deinitialize it once no Wi-Fi interface is left.
+     */
+    if (!ip_networking_inited[CY_NETWORK_WIFI_STA_INTERFACE] &&
+        !ip_networking_inited[CY_NETWORK_WIFI_AP_INTERFACE])
+    {
+        if (offload_sync_mutex_inited)
+        {
+            cy_rtos_deinit_mutex(&offload_sync_mutex);
+            offload_sync_mutex_inited = false;
+        }
+    }
+#endif
+
     /* Clear interface details from database */
     for (int i = 0; i < CY_IFACE_MAX_HANDLE; i++)
     {
@@ -1226,6 +2088,10 @@ cy_rslt_t whd_network_ip_up(whd_network_interface_context *iface)
 
     SET_IP_UP(interface_index, true);
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+    offload_sync_now(interface_index);
+#endif
+
     WPRINT_WHD_DEBUG(("%s(): END \n", __FUNCTION__ ));
     return result;
 }
@@ -1322,6 +2188,11 @@ cy_rslt_t whd_network_ip_down(whd_network_interface_context *iface)
     */
     netifapi_netif_set_down(LWIP_IP_HANDLE(interface_index));
 
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+    /* A down netif has no addresses to offload, so this removes the entries */
+    offload_sync_now(interface_index);
+#endif
+
     /* TO DO : clear all ARP cache */
 
     /** TO DO:
@@ -1624,6 +2495,18 @@ cy_rslt_t whd_network_dhcp_renew(whd_network_interface_context *iface)
 #endif
 }
 
+cy_rslt_t whd_network_dhcp_server_get_stack_usage(uint32_t *stack_size, uint32_t *max_used)
+{
+#if LWIP_IPV4
+    /* The server the AP interface runs; fails while it is not started */
+    return whd_lwip_dhcp_server_get_stack_usage(&internal_dhcp_server, stack_size, max_used);
+#else
+    UNUSED_VARIABLE(stack_size);
+    UNUSED_VARIABLE(max_used);
+    return CY_RSLT_NETWORK_NOT_SUPPORTED;
+#endif
+}
+
 /**
  * Remove all ARP table entries of the specified netif.
  * @param netif Points to a network interface
@@ -1848,6 +2731,10 @@ err_t ping_recv(int socket_hnd, whd_nw_ip_address_t* address, uint16_t *ping_seq
 void internal_ip_change_callback (struct netif *netif)
 {
     WPRINT_WHD_INFO(("IP change callback triggered\n"));
+#if defined(WHD_NETWORK_OFFLOAD_SYNC) && !LWIP_NETIF_EXT_STATUS_CALLBACK
+    /* Without the extended callback only IPv4 changes and up/down are seen here */
+    offload_sync_request(netif);
+#endif
     /* Notify ECM about IP address change */
     if(ip_change_callback != NULL)
     {
@@ -2160,6 +3047,410 @@ cy_rslt_t cy_prng_add_entropy( const void* buffer, uint32_t buffer_length )
     return CY_RSLT_SUCCESS;
 }
 #endif
+
+#ifdef WHD_NETWORK_OFFLOAD_SYNC
+/*
+ * Offload address synchronisation
+ *
+ * The lwIP callbacks run in the tcpip thread with the core lock held, where the iovars cannot
+ * be sent, so they only queue the interface's work item. The work item copies the addresses
+ * under the core lock and sends the difference against what it last programmed.
+ */
+
+/* Called with the TCP/IP core lock held */
+static void offload_sync_snapshot(struct netif *netif, offload_sync_addrs_t *addrs)
+{
+    memset(addrs, 0, sizeof(*addrs));
+    if(!netif_is_up(netif))
+    {
+        return;
+    }
+#if LWIP_IPV4
+    addrs->ipv4 = ip4_addr_get_u32(netif_ip4_addr(netif));
+#endif
+#if LWIP_IPV6
+    for(int i = 0; i < LWIP_IPV6_NUM_ADDRESSES; i++)
+    {
+        /* Tentative addresses are still in DAD and must not be answered for */
+        if(ip6_addr_isvalid(netif_ip6_addr_state(netif, i)))
+        {
+            memcpy(addrs->ipv6[addrs->ipv6_count], netif_ip6_addr(netif, i)->addr, sizeof(addrs->ipv6[0]));
+            addrs->ipv6_count++;
+        }
+    }
+#endif
+}
+
+static bool offload_sync_has_ipv6(const offload_sync_addrs_t *addrs, const uint32_t *ipv6)
+{
+    for(uint32_t i = 0; i < addrs->ipv6_count; i++)
+    {
+        if(memcmp(addrs->ipv6[i], ipv6, sizeof(addrs->ipv6[0])) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Sends the additions and removals that bring the firmware tables to the given addresses.
+ * Failed requests leave the table as it was and are retried on the next check. */
+static void offload_sync_apply(offload_sync_t *sync, const offload_sync_addrs_t *want)
+{
+    whd_interface_t ifp = (whd_interface_t)sync->iface->hw_interface;
+    uint32_t sent = 0;
+    uint32_t full = 0;
+    uint32_t i;
+
+    sync->stats.syncs++;
+
+    if(sync->tables & CY_NETWORK_OFFLOAD_SYNC_ARP_HOSTIP)
+    {
+        /* A full reprogram is a clear followed by an add */
+        full += (want->ipv4 != 0) ? 2 : 1;
+        if(sync->arp_hostip != want->ipv4)
+        {
+            if(sync->arp_hostip != 0)
+            {
+                sent++;
+                if(whd_arp_hostip_list_clear(ifp) == WHD_SUCCESS)
+                {
+                    sync->arp_hostip = 0;
+                }
+                else
+                {
+                    sync->stats.failures++;
+                }
+            }
+            if((sync->arp_hostip == 0) && (want->ipv4 != 0))
+            {
+                /* The list is edited in place by the add */
+                uint32_t host_ip = want->ipv4;
+
+                sent++;
+                if(whd_arp_hostip_list_add(ifp, &host_ip, 1) == WHD_SUCCESS)
+                {
+                    sync->arp_hostip = want->ipv4;
+                }
+                else
+                {
+                    sync->stats.failures++;
+                }
+            }
+        }
+    }
+
+    if(sync->tables & CY_NETWORK_OFFLOAD_SYNC_INET_V4)
+    {
+        full += ((sync->inet_v4 != 0) ? 1 : 0) + ((want->ipv4 != 0) ? 1 : 0);
+        if(sync->inet_v4 != want->ipv4)
+        {
+            if(sync->inet_v4 != 0)
+            {
+                sent++;
+                if(whd_wifi_offload_ipv4_update(ifp, WHD_NETWORK_OFFLOAD_SYNC_V4_FEATURES, sync->inet_v4, WHD_FALSE) == WHD_SUCCESS)
+                {
+                    sync->inet_v4 = 0;
+                }
+                else
+                {
+                    sync->stats.failures++;
+                }
+            }
+            if((sync->inet_v4 == 0) && (want->ipv4 != 0))
+            {
+                sent++;
+                if(whd_wifi_offload_ipv4_update(ifp, WHD_NETWORK_OFFLOAD_SYNC_V4_FEATURES, want->ipv4, WHD_TRUE) == WHD_SUCCESS)
+                {
+                    sync->inet_v4 = want->ipv4;
+                }
+                else
+                {
+                    sync->stats.failures++;
+                }
+            }
+        }
+    }
+
+    if(sync->tables & CY_NETWORK_OFFLOAD_SYNC_INET_V6)
+    {
+        full += sync->inet_v6.ipv6_count + want->ipv6_count;
+        i = 0;
+        while(i < sync->inet_v6.ipv6_count)
+        {
+            if(offload_sync_has_ipv6(want, sync->inet_v6.ipv6[i]))
+            {
+                i++;
+                continue;
+            }
+            sent++;
+            if(whd_wifi_offload_ipv6_update(ifp, WHD_NETWORK_OFFLOAD_SYNC_V6_FEATURES, sync->inet_v6.ipv6[i], 0, WHD_FALSE) == WHD_SUCCESS)
+            {
+                sync->inet_v6.ipv6_count--;
+                memmove(sync->inet_v6.ipv6[i], sync->inet_v6.ipv6[i + 1], (sync->inet_v6.ipv6_count - i) * sizeof(sync->inet_v6.ipv6[0]));
+            }
+            else
+            {
+                sync->stats.failures++;
+                i++;
+            }
+        }
+        for(i = 0; i < want->ipv6_count; i++)
+        {
+            if(offload_sync_has_ipv6(&sync->inet_v6, want->ipv6[i]))
+            {
+                continue;
+            }
+            /* Removals that failed above can leave the table full */
+            if(sync->inet_v6.ipv6_count == OFFLOAD_SYNC_MAX_IPV6)
+            {
+                sync->stats.failures++;
+                continue;
+            }
+            sent++;
+            if(whd_wifi_offload_ipv6_update(ifp, WHD_NETWORK_OFFLOAD_SYNC_V6_FEATURES, (uint32_t *)want->ipv6[i], 0, WHD_TRUE) == WHD_SUCCESS)
+            {
+                memcpy(sync->inet_v6.ipv6[sync->inet_v6.ipv6_count], want->ipv6[i], sizeof(want->ipv6[0]));
+                sync->inet_v6.ipv6_count++;
+            }
+            else
+            {
+                sync->stats.failures++;
+            }
+        }
+    }
+
+    if(sent == 0)
+    {
+        sync->stats.unchanged++;
+    }
+    sync->stats.updates += sent;
+    if(full > sent)
+    {
+        sync->stats.updates_saved += full - sent;
+    }
+    sync->stats.ipv4_entries = ((sync->arp_hostip != 0) ? 1 : 0) + ((sync->inet_v4 != 0) ? 1 : 0);
+    sync->stats.ipv6_entries = sync->inet_v6.ipv6_count;
+}
+
+/* Called with offload_sync_mutex held */
+static void offload_sync_run(offload_sync_t *sync)
+{
+    offload_sync_addrs_t want;
+
+    /*
+     * If LPA is enabled, invoke the activity callback to resume the network stack
+     * before invoking the lwIP APIs that require the TCP core lock.
+     */
+    if (activity_callback)
+    {
+        activity_callback(true);
+    }
+    PROTECTED_FUNC_CALL(offload_sync_snapshot((struct netif *)sync->iface->nw_interface, &want));
+
+    offload_sync_apply(sync, &want);
+}
+
+static void offload_sync_work(void *arg)
+{
+    offload_sync_t *sync = (offload_sync_t *)arg;
+
+    cy_rtos_get_mutex(&offload_sync_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(sync->enabled)
+    {
+        offload_sync_run(sync);
+    }
+    cy_rtos_set_mutex(&offload_sync_mutex);
+}
+
+/* Runs in the tcpip thread */
+static void offload_sync_request(struct netif *netif)
+{
+    for(int i = 0; i < CY_IFACE_MAX_HANDLE; i++)
+    {
+        if(offload_sync[i].enabled && (offload_sync[i].iface->nw_interface == netif))
+        {
+            if(cy_worker_thread_work_enqueue(offload_sync[i].worker, &offload_sync[i].work) != CY_RSLT_SUCCESS)
+            {
+                WPRINT_WHD_ERROR(("%s: Unable to queue the offload sync \n", __func__));
+            }
+        }
+    }
+}
+
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+static void offload_sync_ext_callback(struct netif *netif, netif_nsc_reason_t reason, const netif_ext_callback_args_t *args)
+{
+    UNUSED_VARIABLE(args);
+    if(reason & (LWIP_NSC_STATUS_CHANGED | LWIP_NSC_IPV4_ADDRESS_CHANGED | LWIP_NSC_IPV4_SETTINGS_CHANGED |
+                 LWIP_NSC_IPV6_SET | LWIP_NSC_IPV6_ADDR_STATE_CHANGED))
+    {
+        offload_sync_request(netif);
+    }
+}
+#endif
+
+/* Brings the tables in step straight away, from the application thread */
+static void offload_sync_now(uint8_t interface_index)
+{
+    if(!offload_sync_mutex_inited)
+    {
+        return;
+    }
+    cy_rtos_get_mutex(&offload_sync_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(offload_sync[interface_index & 3].enabled)
+    {
+        offload_sync_run(&offload_sync[interface_index & 3]);
+    }
+    cy_rtos_set_mutex(&offload_sync_mutex);
+}
+
+cy_rslt_t whd_network_offload_sync_start(whd_network_interface_context *iface_context, uint32_t tables, cy_worker_thread_info_t *worker)
+{
+    offload_sync_t *sync;
+    whd_arp_stats_t arp_stats;
+    uint8_t interface_index;
+
+    WPRINT_WHD_DEBUG(("%s(): START \n", __FUNCTION__ ));
+    if((is_interface_valid(iface_context) != CY_RSLT_SUCCESS) || (iface_context->iface_type == CY_NETWORK_ETH_INTERFACE) ||
+       (tables == 0) || ((tables & ~OFFLOAD_SYNC_ALL_TABLES) != 0) || (worker == NULL))
+    {
+        WPRINT_WHD_ERROR(("%s: Invalid arguments \n", __func__));
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    interface_index = (uint8_t)iface_context->iface_type;
+    sync = &offload_sync[interface_index & 3];
+
+    if(!offload_sync_mutex_inited)
+    {
+        if(cy_rtos_init_mutex(&offload_sync_mutex) != CY_RSLT_SUCCESS)
+        {
+            WPRINT_WHD_ERROR(("%s: Unable to create the mutex \n", __func__));
+            return CY_RSLT_NETWORK_ERROR_RTOS;
+        }
+        offload_sync_mutex_inited = true;
+    }
+
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+    if(!offload_sync_callback_added)
+    {
+        if (activity_callback)
+        {
+            activity_callback(true);
+        }
+        PROTECTED_FUNC_CALL(netif_add_ext_callback(&offload_sync_netif_callback, offload_sync_ext_callback));
+        offload_sync_callback_added = true;
+    }
+#endif
+
+    cy_rtos_get_mutex(&offload_sync_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(sync->enabled)
+    {
+        cy_rtos_set_mutex(&offload_sync_mutex);
+        WPRINT_WHD_ERROR(("%s: Already running \n", __func__));
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    memset(sync, 0, sizeof(*sync));
+    sync->tables = tables;
+    sync->iface = iface_context;
+    sync->worker = worker;
+    cy_worker_thread_work_init(&sync->work, offload_sync_work, sync);
+
+    if(tables & CY_NETWORK_OFFLOAD_SYNC_ARP_HOSTIP)
+    {
+        /* The list is owned by the sync from now on; the offload manager tables cannot be read back */
+        (void)whd_arp_hostip_list_clear((whd_interface_t)iface_context->hw_interface);
+        memset(&arp_stats, 0, sizeof(arp_stats));
+        if(whd_arp_stats_get((whd_interface_t)iface_context->hw_interface, &arp_stats) == WHD_SUCCESS)
+        {
+            sync->arp_service_base = arp_stats.stats.peer_service;
+        }
+    }
+
+    sync->enabled = true;
+    offload_sync_run(sync);
+    cy_rtos_set_mutex(&offload_sync_mutex);
+
+    WPRINT_WHD_DEBUG(("%s(): END \n", __FUNCTION__ ));
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_network_offload_sync_stop(whd_network_interface_context *iface_context)
+{
+    offload_sync_t *sync;
+    offload_sync_addrs_t none;
+
+    if((iface_context == NULL) || !offload_sync_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    sync = &offload_sync[iface_context->iface_type & 3];
+
+    cy_rtos_get_mutex(&offload_sync_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(!sync->enabled || (sync->iface != iface_context))
+    {
+        cy_rtos_set_mutex(&offload_sync_mutex);
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    sync->enabled = false;
+    (void)cy_worker_thread_work_cancel(sync->worker, &sync->work);
+
+    memset(&none, 0, sizeof(none));
+    offload_sync_apply(sync, &none);
+    cy_rtos_set_mutex(&offload_sync_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t whd_network_offload_sync_get_stats(whd_network_interface_context *iface_context, whd_network_offload_sync_stats_t *stats)
+{
+    offload_sync_t *sync;
+    whd_arp_stats_t arp_stats;
+    bool read_arp_stats;
+    uint32_t arp_service_base;
+
+    if((iface_context == NULL) || (stats == NULL) || !offload_sync_mutex_inited)
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    sync = &offload_sync[iface_context->iface_type & 3];
+
+    cy_rtos_get_mutex(&offload_sync_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if(!sync->enabled || (sync->iface != iface_context))
+    {
+        cy_rtos_set_mutex(&offload_sync_mutex);
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    *stats = sync->stats;
+    read_arp_stats = ((sync->tables & CY_NETWORK_OFFLOAD_SYNC_ARP_HOSTIP) != 0);
+    arp_service_base = sync->arp_service_base;
+    cy_rtos_set_mutex(&offload_sync_mutex);
+
+    if(read_arp_stats)
+    {
+        memset(&arp_stats, 0, sizeof(arp_stats));
+        if(whd_arp_stats_get((whd_interface_t)iface_context->hw_interface, &arp_stats) == WHD_SUCCESS)
+        {
+            stats->arp_replies_offloaded = arp_stats.stats.peer_service - arp_service_base;
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+#endif /* WHD_NETWORK_OFFLOAD_SYNC */
+
+#ifdef WHD_NETWORK_CSUM_OFFLOAD
+cy_rslt_t whd_network_csum_offload_get_stats(whd_network_interface_context *iface_context, whd_network_csum_offload_stats_t *stats)
+{
+    if((iface_context == NULL) || (stats == NULL) || (iface_context->iface_type == CY_NETWORK_ETH_INTERFACE))
+    {
+        return CY_RSLT_NETWORK_BAD_ARG;
+    }
+    *stats = csum_offload[iface_context->iface_type & 3].stats;
+    return CY_RSLT_SUCCESS;
+}
+#endif /* WHD_NETWORK_CSUM_OFFLOAD */
+
 /*
  * This is a pseudo random number generator for being used by the mbedtls library
  * Ideally, platform specific TRNG functionality should be used for this purpose
@@ -6,7 +6,7 @@
  * threads and deferring work to a worker thread.
  ***************************************************************************************************
  * \copyright
- * Copyright 2018-2022 Cypress Semiconductor Corporation (an Infineon company) or
+ * Copyright 2018-2025 Cypress Semiconductor Corporation (an Infineon company) or
  * an affiliate of Cypress Semiconductor Corporation
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -36,11 +36,18 @@ extern "C"
 {
 #endif
 
+// Work item state, a pending item is either on the queue or, if also delayed, on the timer list
+#define CY_WORKER_WORK_PENDING      (0x01u)
+#define CY_WORKER_WORK_DELAYED      (0x02u)
+
 // Info for dispatching a function call
+// A plain call sets work_func, a work item sets work. With neither set, a NULL arg terminates
+// the thread and a non NULL arg only wakes it to look at the timer list.
 typedef struct
 {
     cy_worker_thread_func_t* work_func;
     void*                    arg;
+    cy_worker_thread_work_t* work;
 } cy_worker_dispatch_info_t;
 
 // Info for dispatching a function call
@@ -61,12 +68,158 @@ void cyhal_system_critical_section_exit(uint32_t old_state)
     __set_PRIMASK(old_state);  /**< Restore PRIMASK bit*/
 }
 
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_timer_insert
+//
+/* Adds an item to the timer list, behind items with the same expiry.
+ * Must be called in a critical section.
+ * @return  true if the item is now the earliest
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_timer_insert(cy_worker_thread_info_t* worker,
+                                          cy_worker_thread_work_t* work)
+{
+    cy_worker_thread_work_t** link = &worker->delayed;
+
+    while ((*link != NULL) && ((int32_t)((*link)->expiry - work->expiry) <= 0))
+    {
+        link = &(*link)->next;
+    }
+    work->next   = *link;
+    *link        = work;
+    work->flags |= CY_WORKER_WORK_DELAYED;
+
+    return (link == &worker->delayed);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_timer_remove
+//
+/* Removes an item from the timer list. Must be called in a critical section. */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_timer_remove(cy_worker_thread_info_t* worker,
+                                          cy_worker_thread_work_t* work)
+{
+    cy_worker_thread_work_t** link = &worker->delayed;
+
+    while ((*link != NULL) && (*link != work))
+    {
+        link = &(*link)->next;
+    }
+    if (*link != NULL)
+    {
+        *link = work->next;
+    }
+    work->next   = NULL;
+    work->flags &= (uint8_t) ~CY_WORKER_WORK_DELAYED;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_timeout
+//
+/* Time until the earliest delayed item is due. Must be called in a critical section. */
+//--------------------------------------------------------------------------------------------------
+static cy_time_t cy_worker_thread_timeout(cy_worker_thread_info_t* worker, cy_time_t now)
+{
+    int32_t remaining;
+
+    if (worker->delayed == NULL)
+    {
+        return CY_RTOS_NEVER_TIMEOUT;
+    }
+    remaining = (int32_t)(worker->delayed->expiry - now);
+    return (remaining > 0) ? (cy_time_t)remaining : 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run
+//
+/* Runs one work function and accounts for its run time. */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run(cy_worker_thread_info_t* worker,
+                                 cy_worker_thread_func_t* work_func, void* arg)
+{
+    cy_time_t start = 0;
+    cy_time_t end   = 0;
+    uint32_t  elapsed;
+
+    (void)cy_rtos_time_get(&start);
+    work_func(arg);
+    (void)cy_rtos_time_get(&end);
+    elapsed = (uint32_t)(end - start);
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    worker->stats.executed++;
+    worker->stats.run_time_total_ms += elapsed;
+    if (elapsed > worker->stats.run_time_max_ms)
+    {
+        worker->stats.run_time_max_ms = elapsed;
+    }
+    cyhal_system_critical_section_exit(state);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run_timers
+//
+/* Runs the delayed items that are due. A periodic item is put back on the list before it runs,
+ * so that it can cancel itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run_timers(cy_worker_thread_info_t* worker)
+{
+    cy_worker_thread_work_t* work;
+    cy_worker_thread_func_t* work_func;
+    void*                    arg;
+    cy_time_t                now;
+    uint32_t                 state;
+
+    while (1)
+    {
+        now = 0;
+        (void)cy_rtos_time_get(&now);
+
+        state = cyhal_system_critical_section_enter();
+        work  = worker->delayed;
+        if ((work == NULL) || ((int32_t)(work->expiry - now) > 0))
+        {
+            cyhal_system_critical_section_exit(state);
+            break;
+        }
+        cy_worker_thread_timer_remove(worker, work);
+        worker->stats.timers_expired++;
+        if (work->period_ms != 0)
+        {
+            work->expiry += work->period_ms;
+            if ((int32_t)(work->expiry - now) <= 0)
+            {
+                // Overran by more than a period, skip the missed runs
+                work->expiry = now + work->period_ms;
+            }
+            (void)cy_worker_thread_timer_insert(worker, work);
+        }
+        else
+        {
+            work->flags = 0;
+        }
+        work_func = work->work_func;
+        arg       = work->arg;
+        cyhal_system_critical_section_exit(state);
+
+        cy_worker_thread_run(worker, work_func, arg);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_worker_thread_func
 //
 /* Worker Thread to dispatch the events that added to the event queue.
- * It will wait indefinitely for a item to be queued and will terminate
- * when the NULL work function is queued by delete. It will process all
+ * It will wait for a item to be queued, or until the earliest delayed item is due, and will
+ * terminate when the NULL work function is queued by delete. It will process all
  * events before the terminating event.
  * @param   arg : pointer to @ref cy_worker_thread_info_t
  */
@@ -76,26 +229,105 @@ static void cy_worker_thread_func(cy_thread_arg_t arg)
     cy_rslt_t                 result;
     cy_worker_dispatch_info_t dispatch_info;
     cy_worker_thread_info_t*  worker = (cy_worker_thread_info_t*)arg;
+    cy_worker_thread_work_t*  work;
+    cy_time_t                 now;
+    cy_time_t                 timeout;
+    uint32_t                  state;
 
     while (1)
     {
-        result = cy_rtos_queue_get(&worker->event_queue, &dispatch_info, CY_RTOS_NEVER_TIMEOUT);
+        now = 0;
+        (void)cy_rtos_time_get(&now);
+        state   = cyhal_system_critical_section_enter();
+        timeout = cy_worker_thread_timeout(worker, now);
+        cyhal_system_critical_section_exit(state);
+
+        result = cy_rtos_queue_get(&worker->event_queue, &dispatch_info, timeout);
         if (result == CY_RSLT_SUCCESS)
         {
             if (dispatch_info.work_func != NULL)
             {
-                dispatch_info.work_func(dispatch_info.arg);
+                cy_worker_thread_run(worker, dispatch_info.work_func, dispatch_info.arg);
             }
-            else
+            else if (dispatch_info.work != NULL)
+            {
+                // Skipped if it was cancelled, or cancelled and delayed, since it was queued
+                work  = dispatch_info.work;
+                state = cyhal_system_critical_section_enter();
+                if (work->flags == CY_WORKER_WORK_PENDING)
+                {
+                    work->flags = 0;
+                    cyhal_system_critical_section_exit(state);
+                    cy_worker_thread_run(worker, work->work_func, work->arg);
+                }
+                else
+                {
+                    cyhal_system_critical_section_exit(state);
+                }
+            }
+            else if (dispatch_info.arg == NULL)
             {
                 break;
             }
         }
+        cy_worker_thread_run_timers(worker);
     }
     cy_rtos_thread_exit();
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_put
+//
+/* Puts an entry on the queue, keeping delete from tearing the queue down meanwhile. */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_put(cy_worker_thread_info_t* worker_info,
+                                      const cy_worker_dispatch_info_t* dispatch_info)
+{
+    size_t depth = 0;
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if ((worker_info->state != CY_WORKER_THREAD_VALID) &&
+        (worker_info->state != CY_WORKER_THREAD_ENQUEUING))
+    {
+        cyhal_system_critical_section_exit(state);
+        return CY_WORKER_THREAD_ERR_THREAD_INVALID;
+    }
+    worker_info->enqueue_count++;
+    worker_info->state = CY_WORKER_THREAD_ENQUEUING;
+    cyhal_system_critical_section_exit(state);
+
+    // Queue an event to be run by the worker thread
+    cy_rslt_t result = cy_rtos_queue_put(&worker_info->event_queue, dispatch_info, 0);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        (void)cy_rtos_queue_count(&worker_info->event_queue, &depth);
+    }
+
+    state = cyhal_system_critical_section_enter();
+    if (result == CY_RSLT_SUCCESS)
+    {
+        worker_info->stats.enqueued++;
+        if (depth > worker_info->stats.queue_depth_max)
+        {
+            worker_info->stats.queue_depth_max = (uint32_t)depth;
+        }
+    }
+    else
+    {
+        worker_info->stats.queue_full++;
+    }
+    worker_info->enqueue_count--;
+    if (worker_info->enqueue_count == 0)
+    {
+        worker_info->state = CY_WORKER_THREAD_VALID;
+    }
+    cyhal_system_critical_section_exit(state);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_worker_thread_create
 //--------------------------------------------------------------------------------------------------
@@ -111,6 +343,11 @@ cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
     {
         __asm("    bkpt    1");
     }
+    uint32_t num_threads = (params->num_threads != 0) ? params->num_threads : 1;
+    if((num_threads > CY_WORKER_THREAD_MAX_THREADS) || ((num_threads > 1) && (params->stack != NULL)))
+    {
+        __asm("    bkpt    1");
+    }
 
     // Start with a clean structure
     memset(new_worker, 0, sizeof(cy_worker_thread_info_t));
@@ -123,20 +360,35 @@ cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
     if (result == CY_RSLT_SUCCESS)
     {
         new_worker->state = CY_WORKER_THREAD_VALID;
-        result            = cy_rtos_thread_create(&new_worker->thread,
-                                                  cy_worker_thread_func,
-                                                  (params->name != NULL)
-                                                  ? params->name
-                                                  : CY_WORKER_THREAD_DEFAULT_NAME,
-                                                  params->stack,
-                                                  params->stack_size,
-                                                  params->priority,
-                                                  (cy_thread_arg_t)new_worker);
+        while ((result == CY_RSLT_SUCCESS) && (new_worker->num_threads < num_threads))
+        {
+            result = cy_rtos_thread_create(&new_worker->thread[new_worker->num_threads],
+                                           cy_worker_thread_func,
+                                           (params->name != NULL)
+                                           ? params->name
+                                           : CY_WORKER_THREAD_DEFAULT_NAME,
+                                           params->stack,
+                                           params->stack_size,
+                                           params->priority,
+                                           (cy_thread_arg_t)new_worker);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                new_worker->num_threads++;
+            }
+        }
 
         if (result != CY_RSLT_SUCCESS)
         {
-            new_worker->state = CY_WORKER_THREAD_INVALID;
-            cy_rtos_queue_deinit(&new_worker->event_queue);
+            if (new_worker->num_threads != 0)
+            {
+                // Stop the part of the pool that did start
+                (void)cy_worker_thread_delete(new_worker);
+            }
+            else
+            {
+                new_worker->state = CY_WORKER_THREAD_INVALID;
+                cy_rtos_queue_deinit(&new_worker->event_queue);
+            }
         }
     }
     return result;
@@ -161,7 +413,7 @@ cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker)
             // allow NULL as a valid value for the work function.
             old_worker->state = CY_WORKER_THREAD_TERMINATING;
             cyhal_system_critical_section_exit(state);
-            cy_worker_dispatch_info_t dispatch_info = { NULL, NULL };
+            cy_worker_dispatch_info_t dispatch_info = { NULL, NULL, NULL };
             result = cy_rtos_queue_put(&old_worker->event_queue, &dispatch_info, 0);
             if (result != CY_RSLT_SUCCESS)
             {
@@ -172,15 +424,25 @@ cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker)
 
                 return result;
             }
+            // One more for each other thread of the pool, they are draining the queue by now
+            for (uint32_t i = 1; i < old_worker->num_threads; i++)
+            {
+                (void)cy_rtos_queue_put(&old_worker->event_queue, &dispatch_info,
+                                        CY_RTOS_NEVER_TIMEOUT);
+            }
+            state = cyhal_system_critical_section_enter();
         }
 
         if (old_worker->state != CY_WORKER_THREAD_JOIN_COMPLETE)
         {
             cyhal_system_critical_section_exit(state);
-            result = cy_rtos_thread_join(&old_worker->thread);
-            if (result != CY_RSLT_SUCCESS)
+            for (uint32_t i = 0; i < old_worker->num_threads; i++)
             {
-                return result;
+                result = cy_rtos_thread_join(&old_worker->thread[i]);
+                if (result != CY_RSLT_SUCCESS)
+                {
+                    return result;
+                }
             }
             state = cyhal_system_critical_section_enter();
             old_worker->state = CY_WORKER_THREAD_JOIN_COMPLETE;
@@ -196,6 +458,15 @@ cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker)
             }
             state = cyhal_system_critical_section_enter();
             old_worker->state = CY_WORKER_THREAD_INVALID;
+
+            // Drop the delayed items that never came due
+            while (old_worker->delayed != NULL)
+            {
+                cy_worker_thread_work_t* work = old_worker->delayed;
+                old_worker->delayed = work->next;
+                work->next  = NULL;
+                work->flags = 0;
+            }
         }
     }
 
@@ -215,6 +486,82 @@ cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
         __asm("    bkpt    1");
     }
 
+    cy_worker_dispatch_info_t dispatch_info = { work_func, arg, NULL };
+    return cy_worker_thread_put(worker_info, &dispatch_info);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_init
+//--------------------------------------------------------------------------------------------------
+void cy_worker_thread_work_init(cy_worker_thread_work_t* work, cy_worker_thread_func_t* work_func,
+                                void* arg)
+{
+    if(work == NULL || work_func == NULL)
+    {
+        __asm("    bkpt    1");
+    }
+
+    memset(work, 0, sizeof(cy_worker_thread_work_t));
+    work->work_func = work_func;
+    work->arg       = arg;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_enqueue
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_work_enqueue(cy_worker_thread_info_t* worker_info,
+                                        cy_worker_thread_work_t* work)
+{
+    if(worker_info == NULL || work == NULL || work->work_func == NULL)
+    {
+        __asm("    bkpt    1");
+    }
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if ((work->flags & CY_WORKER_WORK_PENDING) != 0)
+    {
+        worker_info->stats.coalesced++;
+        cyhal_system_critical_section_exit(state);
+        return CY_RSLT_SUCCESS;
+    }
+    work->flags = CY_WORKER_WORK_PENDING;
+    cyhal_system_critical_section_exit(state);
+
+    cy_worker_dispatch_info_t dispatch_info = { NULL, NULL, work };
+    cy_rslt_t result = cy_worker_thread_put(worker_info, &dispatch_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        state = cyhal_system_critical_section_enter();
+        work->flags = 0;
+        cyhal_system_critical_section_exit(state);
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_enqueue_delayed
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_work_enqueue_delayed(cy_worker_thread_info_t* worker_info,
+                                                cy_worker_thread_work_t* work,
+                                                cy_time_t delay_ms, uint32_t period_ms)
+{
+    cy_time_t now = 0;
+    bool      earliest;
+
+    if(worker_info == NULL || work == NULL || work->work_func == NULL)
+    {
+        __asm("    bkpt    1");
+    }
+    if ((delay_ms == 0) && (period_ms == 0))
+    {
+        return cy_worker_thread_work_enqueue(worker_info, work);
+    }
+
+    (void)cy_rtos_time_get(&now);
+
     uint32_t state = cyhal_system_critical_section_enter();
     if ((worker_info->state != CY_WORKER_THREAD_VALID) &&
         (worker_info->state != CY_WORKER_THREAD_ENQUEUING))
@@ -222,23 +569,91 @@ cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
         cyhal_system_critical_section_exit(state);
         return CY_WORKER_THREAD_ERR_THREAD_INVALID;
     }
-    worker_info->enqueue_count++;
-    worker_info->state = CY_WORKER_THREAD_ENQUEUING;
+    if ((work->flags & CY_WORKER_WORK_PENDING) != 0)
+    {
+        worker_info->stats.coalesced++;
+        cyhal_system_critical_section_exit(state);
+        return CY_RSLT_SUCCESS;
+    }
+    work->expiry    = now + delay_ms;
+    work->period_ms = period_ms;
+    work->flags     = CY_WORKER_WORK_PENDING;
+    earliest        = cy_worker_thread_timer_insert(worker_info, work);
     cyhal_system_critical_section_exit(state);
 
-    cy_worker_dispatch_info_t dispatch_info = { work_func, arg };
-    // Queue an event to be run by the worker thread
-    cy_rslt_t result = cy_rtos_queue_put(&worker_info->event_queue, &dispatch_info, 0);
+    if (earliest)
+    {
+        // Wake a thread so that it waits for the new expiry. If the queue is full the threads
+        // are busy, and look at the timer list after every entry anyway.
+        cy_worker_dispatch_info_t dispatch_info = { NULL, worker_info, NULL };
+        (void)cy_worker_thread_put(worker_info, &dispatch_info);
+    }
+    return CY_RSLT_SUCCESS;
+}
 
-    state = cyhal_system_critical_section_enter();
-    worker_info->enqueue_count--;
-    if (worker_info->enqueue_count == 0)
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_cancel
+//--------------------------------------------------------------------------------------------------
+bool cy_worker_thread_work_cancel(cy_worker_thread_info_t* worker_info,
+                                  cy_worker_thread_work_t* work)
+{
+    bool was_pending;
+
+    if(worker_info == NULL || work == NULL)
     {
-        worker_info->state = CY_WORKER_THREAD_VALID;
+        __asm("    bkpt    1");
     }
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    was_pending = ((work->flags & CY_WORKER_WORK_PENDING) != 0);
+    if ((work->flags & CY_WORKER_WORK_DELAYED) != 0)
+    {
+        cy_worker_thread_timer_remove(worker_info, work);
+    }
+    work->flags = 0;
     cyhal_system_critical_section_exit(state);
 
-    return result;
+    return was_pending;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_stats
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_get_stats(cy_worker_thread_info_t* worker_info,
+                                     cy_worker_thread_stats_t* stats, bool reset)
+{
+    if ((worker_info == NULL) || (stats == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    *stats = worker_info->stats;
+    if (reset)
+    {
+        memset(&worker_info->stats, 0, sizeof(worker_info->stats));
+    }
+    cyhal_system_critical_section_exit(state);
+
+    // Measured from the stacks themselves, outside the critical section
+    stats->stack_size     = 0;
+    stats->stack_used_max = 0;
+    for (uint32_t i = 0; i < worker_info->num_threads; i++)
+    {
+        uint32_t size, used;
+        if (cy_rtos_thread_get_stack_usage(&worker_info->thread[i], &size, &used) == CY_RSLT_SUCCESS)
+        {
+            stats->stack_size = size;
+            if (used > stats->stack_used_max)
+            {
+                stats->stack_used_max = used;
+            }
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
 }
 
 
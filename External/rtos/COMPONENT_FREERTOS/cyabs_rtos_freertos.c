@@ -80,6 +80,7 @@ typedef struct
     SemaphoreHandle_t sema;
     uint32_t          magic;
     void*             memptr;
+    uint32_t          stack_size;
 } cy_task_wrapper_t;
 
 cy_time_t convert_ms_to_ticks(cy_time_t timeout_ms)
@@ -165,6 +166,7 @@ cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_
             }
             wrapper->magic  = TASK_IDENT;
             wrapper->memptr = ident;
+            wrapper->stack_size = (uint32_t)(stack_size_rtos * sizeof(StackType_t));
             if(!(((uint32_t)wrapper & CY_RTOS_ALIGNMENT_MASK) == 0UL))
             {
             	__asm("    bkpt    1");
@@ -436,6 +438,42 @@ cy_rslt_t cy_rtos_thread_get_name(cy_thread_t* thread, const char** thread_name)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_get_stack_usage
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_get_stack_usage(cy_thread_t* thread, uint32_t* stack_size,
+                                         uint32_t* max_used)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (*thread == NULL) || (stack_size == NULL) || (max_used == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        #if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+        cy_task_wrapper_t* wrapper = ((cy_task_wrapper_t*)*thread);
+        if (wrapper->magic != TASK_IDENT)
+        {
+            // Not created by cy_rtos_thread_create(), so the stack size is not known
+            status = CY_RTOS_BAD_PARAM;
+        }
+        else
+        {
+            uint32_t unused =
+                (uint32_t)uxTaskGetStackHighWaterMark(*thread) * (uint32_t)sizeof(StackType_t);
+            *stack_size = wrapper->stack_size;
+            *max_used   = (unused < wrapper->stack_size) ? (wrapper->stack_size - unused) : 0;
+            status      = CY_RSLT_SUCCESS;
+        }
+        #else
+        status = CY_RTOS_UNSUPPORTED;
+        #endif
+    }
+    return status;
+}
+
+
 //==================================================================================================
 // Scheduler
 //==================================================================================================
@@ -965,6 +1003,37 @@ cy_rslt_t cy_rtos_event_deinit(cy_event_t* event)
 // Queues
 //==================================================================================================
 
+#if defined(CY_RTOS_HIGH_WATER) && (configUSE_TRACE_FACILITY == 1)
+// Records the depth reached by a put in the queue number, which is otherwise only used by trace
+// tools
+static void cy_rtos_queue_note_depth(QueueHandle_t queue)
+{
+    UBaseType_t depth;
+    if (is_in_isr())
+    {
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        depth = uxQueueMessagesWaitingFromISR(queue);
+        if (depth > uxQueueGetQueueNumber(queue))
+        {
+            vQueueSetQueueNumber(queue, depth);
+        }
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+    }
+    else
+    {
+        taskENTER_CRITICAL();
+        depth = uxQueueMessagesWaiting(queue);
+        if (depth > uxQueueGetQueueNumber(queue))
+        {
+            vQueueSetQueueNumber(queue, depth);
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+
+#endif /* defined(CY_RTOS_HIGH_WATER) && (configUSE_TRACE_FACILITY == 1) */
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_init
 //--------------------------------------------------------------------------------------------------
@@ -1028,6 +1097,9 @@ cy_rslt_t cy_rtos_queue_put(cy_queue_t* queue, const void* item_ptr, cy_time_t t
         }
         else
         {
+            #if defined(CY_RTOS_HIGH_WATER) && (configUSE_TRACE_FACILITY == 1)
+            cy_rtos_queue_note_depth(*queue);
+            #endif
             status = CY_RSLT_SUCCESS;
         }
     }
@@ -1129,6 +1201,29 @@ cy_rslt_t cy_rtos_queue_space(cy_queue_t* queue, size_t* num_spaces)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_get_high_water
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_get_high_water(cy_queue_t* queue, size_t* high_water)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (high_water == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        #if defined(CY_RTOS_HIGH_WATER) && (configUSE_TRACE_FACILITY == 1)
+        *high_water = uxQueueGetQueueNumber(*queue);
+        status      = CY_RSLT_SUCCESS;
+        #else
+        status = CY_RTOS_UNSUPPORTED;
+        #endif
+    }
+    return status;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // cy_rtos_queue_reset
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,666 @@
+/***********************************************************************************************//**
+ * \file cy_worker_thread.c
+ *
+ * \brief
+ * Provides implementation for functions that allow creating/deleting worker
+ * threads and deferring work to a worker thread.
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2018-2025 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+#ifdef WHD_POSIX
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cy_worker_thread.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+// Work item state, a pending item is either on the queue or, if also delayed, on the timer list
+#define CY_WORKER_WORK_PENDING      (0x01u)
+#define CY_WORKER_WORK_DELAYED      (0x02u)
+
+// Info for dispatching a function call
+// A plain call sets work_func, a work item sets work. With neither set, a NULL arg terminates
+// the thread and a non NULL arg only wakes it to look at the timer list.
+typedef struct
+{
+    cy_worker_thread_func_t* work_func;
+    void*                    arg;
+    cy_worker_thread_work_t* work;
+} cy_worker_dispatch_info_t;
+
+//--------------------------------------------------------------------------------------------------
+// cyhal_system_critical_section_enter
+//
+/* There are no interrupts to mask on the host. The worker state is instead guarded by the
+ * process wide lock behind cy_rtos_scheduler_suspend(), which nests like PRIMASK does.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    (void)cy_rtos_scheduler_suspend();
+    return 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cyhal_system_critical_section_exit
+//--------------------------------------------------------------------------------------------------
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    (void)old_state;
+    (void)cy_rtos_scheduler_resume();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_timer_insert
+//
+/* Adds an item to the timer list, behind items with the same expiry.
+ * Must be called in a critical section.
+ * @return  true if the item is now the earliest
+ */
+//--------------------------------------------------------------------------------------------------
+static bool cy_worker_thread_timer_insert(cy_worker_thread_info_t* worker,
+                                          cy_worker_thread_work_t* work)
+{
+    cy_worker_thread_work_t** link = &worker->delayed;
+
+    while ((*link != NULL) && ((int32_t)((*link)->expiry - work->expiry) <= 0))
+    {
+        link = &(*link)->next;
+    }
+    work->next   = *link;
+    *link        = work;
+    work->flags |= CY_WORKER_WORK_DELAYED;
+
+    return (link == &worker->delayed);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_timer_remove
+//
+/* Removes an item from the timer list. Must be called in a critical section. */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_timer_remove(cy_worker_thread_info_t* worker,
+                                          cy_worker_thread_work_t* work)
+{
+    cy_worker_thread_work_t** link = &worker->delayed;
+
+    while ((*link != NULL) && (*link != work))
+    {
+        link = &(*link)->next;
+    }
+    if (*link != NULL)
+    {
+        *link = work->next;
+    }
+    work->next   = NULL;
+    work->flags &= (uint8_t) ~CY_WORKER_WORK_DELAYED;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_timeout
+//
+/* Time until the earliest delayed item is due. Must be called in a critical section. */
+//--------------------------------------------------------------------------------------------------
+static cy_time_t cy_worker_thread_timeout(cy_worker_thread_info_t* worker, cy_time_t now)
+{
+    int32_t remaining;
+
+    if (worker->delayed == NULL)
+    {
+        return CY_RTOS_NEVER_TIMEOUT;
+    }
+    remaining = (int32_t)(worker->delayed->expiry - now);
+    return (remaining > 0) ? (cy_time_t)remaining : 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run
+//
+/* Runs one work function and accounts for its run time. */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run(cy_worker_thread_info_t* worker,
+                                 cy_worker_thread_func_t* work_func, void* arg)
+{
+    cy_time_t start = 0;
+    cy_time_t end   = 0;
+    uint32_t  elapsed;
+
+    (void)cy_rtos_time_get(&start);
+    work_func(arg);
+    (void)cy_rtos_time_get(&end);
+    elapsed = (uint32_t)(end - start);
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    worker->stats.executed++;
+    worker->stats.run_time_total_ms += elapsed;
+    if (elapsed > worker->stats.run_time_max_ms)
+    {
+        worker->stats.run_time_max_ms = elapsed;
+    }
+    cyhal_system_critical_section_exit(state);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_run_timers
+//
+/* Runs the delayed items that are due. A periodic item is put back on the list before it runs,
+ * so that it can cancel itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_run_timers(cy_worker_thread_info_t* worker)
+{
+    cy_worker_thread_work_t* work;
+    cy_worker_thread_func_t* work_func;
+    void*                    arg;
+    cy_time_t                now;
+    uint32_t                 state;
+
+    while (1)
+    {
+        now = 0;
+        (void)cy_rtos_time_get(&now);
+
+        state = cyhal_system_critical_section_enter();
+        work  = worker->delayed;
+        if ((work == NULL) || ((int32_t)(work->expiry - now) > 0))
+        {
+            cyhal_system_critical_section_exit(state);
+            break;
+        }
+        cy_worker_thread_timer_remove(worker, work);
+        worker->stats.timers_expired++;
+        if (work->period_ms != 0)
+        {
+            work->expiry += work->period_ms;
+            if ((int32_t)(work->expiry - now) <= 0)
+            {
+                // Overran by more than a period, skip the missed runs
+                work->expiry = now + work->period_ms;
+            }
+            (void)cy_worker_thread_timer_insert(worker, work);
+        }
+        else
+        {
+            work->flags = 0;
+        }
+        work_func = work->work_func;
+        arg       = work->arg;
+        cyhal_system_critical_section_exit(state);
+
+        cy_worker_thread_run(worker, work_func, arg);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_func
+//
+/* Worker Thread to dispatch the events that added to the event queue.
+ * It will wait for a item to be queued, or until the earliest delayed item is due, and will
+ * terminate when the NULL work function is queued by delete. It will process all
+ * events before the terminating event.
+ * @param   arg : pointer to @ref cy_worker_thread_info_t
+ */
+//--------------------------------------------------------------------------------------------------
+static void cy_worker_thread_func(cy_thread_arg_t arg)
+{
+    cy_rslt_t                 result;
+    cy_worker_dispatch_info_t dispatch_info;
+    cy_worker_thread_info_t*  worker = (cy_worker_thread_info_t*)arg;
+    cy_worker_thread_work_t*  work;
+    cy_time_t                 now;
+    cy_time_t                 timeout;
+    uint32_t                  state;
+
+    while (1)
+    {
+        now = 0;
+        (void)cy_rtos_time_get(&now);
+        state   = cyhal_system_critical_section_enter();
+        timeout = cy_worker_thread_timeout(worker, now);
+        cyhal_system_critical_section_exit(state);
+
+        result = cy_rtos_queue_get(&worker->event_queue, &dispatch_info, timeout);
+        if (result == CY_RSLT_SUCCESS)
+        {
+            if (dispatch_info.work_func != NULL)
+            {
+                cy_worker_thread_run(worker, dispatch_info.work_func, dispatch_info.arg);
+            }
+            else if (dispatch_info.work != NULL)
+            {
+                // Skipped if it was cancelled, or cancelled and delayed, since it was queued
+                work  = dispatch_info.work;
+                state = cyhal_system_critical_section_enter();
+                if (work->flags == CY_WORKER_WORK_PENDING)
+                {
+                    work->flags = 0;
+                    cyhal_system_critical_section_exit(state);
+                    cy_worker_thread_run(worker, work->work_func, work->arg);
+                }
+                else
+                {
+                    cyhal_system_critical_section_exit(state);
+                }
+            }
+            else if (dispatch_info.arg == NULL)
+            {
+                break;
+            }
+        }
+        cy_worker_thread_run_timers(worker);
+    }
+    cy_rtos_thread_exit();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_put
+//
+/* Puts an entry on the queue, keeping delete from tearing the queue down meanwhile. */
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_worker_thread_put(cy_worker_thread_info_t* worker_info,
+                                      const cy_worker_dispatch_info_t* dispatch_info)
+{
+    size_t depth = 0;
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if ((worker_info->state != CY_WORKER_THREAD_VALID) &&
+        (worker_info->state != CY_WORKER_THREAD_ENQUEUING))
+    {
+        cyhal_system_critical_section_exit(state);
+        return CY_WORKER_THREAD_ERR_THREAD_INVALID;
+    }
+    worker_info->enqueue_count++;
+    worker_info->state = CY_WORKER_THREAD_ENQUEUING;
+    cyhal_system_critical_section_exit(state);
+
+    // Queue an event to be run by the worker thread
+    cy_rslt_t result = cy_rtos_queue_put(&worker_info->event_queue, dispatch_info, 0);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        (void)cy_rtos_queue_count(&worker_info->event_queue, &depth);
+    }
+
+    state = cyhal_system_critical_section_enter();
+    if (result == CY_RSLT_SUCCESS)
+    {
+        worker_info->stats.enqueued++;
+        if (depth > worker_info->stats.queue_depth_max)
+        {
+            worker_info->stats.queue_depth_max = (uint32_t)depth;
+        }
+    }
+    else
+    {
+        worker_info->stats.queue_full++;
+    }
+    worker_info->enqueue_count--;
+    if (worker_info->enqueue_count == 0)
+    {
+        worker_info->state = CY_WORKER_THREAD_VALID;
+    }
+    cyhal_system_critical_section_exit(state);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_create
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
+                                  const cy_worker_thread_params_t* params)
+{
+    // Param check
+    if ((params == NULL) || (new_worker == NULL) ||
+        ((params->stack != NULL) && (params->stack_size == 0)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    uint32_t num_threads = (params->num_threads != 0) ? params->num_threads : 1;
+    if ((num_threads > CY_WORKER_THREAD_MAX_THREADS) || ((num_threads > 1) && (params->stack != NULL)))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    // Start with a clean structure
+    memset(new_worker, 0, sizeof(cy_worker_thread_info_t));
+
+    cy_rslt_t result = cy_rtos_queue_init(&new_worker->event_queue,
+                                          (params->num_entries != 0)
+                                          ? params->num_entries
+                                          : CY_WORKER_DEFAULT_ENTRIES,
+                                          sizeof(cy_worker_dispatch_info_t));
+    if (result == CY_RSLT_SUCCESS)
+    {
+        new_worker->state = CY_WORKER_THREAD_VALID;
+        while ((result == CY_RSLT_SUCCESS) && (new_worker->num_threads < num_threads))
+        {
+            result = cy_rtos_thread_create(&new_worker->thread[new_worker->num_threads],
+                                           cy_worker_thread_func,
+                                           (params->name != NULL)
+                                           ? params->name
+                                           : CY_WORKER_THREAD_DEFAULT_NAME,
+                                           params->stack,
+                                           params->stack_size,
+                                           params->priority,
+                                           (cy_thread_arg_t)new_worker);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                new_worker->num_threads++;
+            }
+        }
+
+        if (result != CY_RSLT_SUCCESS)
+        {
+            if (new_worker->num_threads != 0)
+            {
+                // Stop the part of the pool that did start
+                (void)cy_worker_thread_delete(new_worker);
+            }
+            else
+            {
+                new_worker->state = CY_WORKER_THREAD_INVALID;
+                cy_rtos_queue_deinit(&new_worker->event_queue);
+            }
+        }
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_delete
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if (old_worker->state != CY_WORKER_THREAD_INVALID)
+    {
+        // Don't allow terminating while cy_rtos_put_queue is running
+        if (old_worker->state == CY_WORKER_THREAD_VALID)
+        {
+            // A terminating event is queued that will break the while loop
+            // Note that this is ok because thread enqueue function will not
+            // allow NULL as a valid value for the work function.
+            old_worker->state = CY_WORKER_THREAD_TERMINATING;
+            cyhal_system_critical_section_exit(state);
+            cy_worker_dispatch_info_t dispatch_info = { NULL, NULL, NULL };
+            result = cy_rtos_queue_put(&old_worker->event_queue, &dispatch_info, 0);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                // Could not enqueue termination task, return to valid state
+                state = cyhal_system_critical_section_enter();
+                old_worker->state = CY_WORKER_THREAD_VALID;
+                cyhal_system_critical_section_exit(state);
+
+                return result;
+            }
+            // One more for each other thread of the pool, they are draining the queue by now
+            for (uint32_t i = 1; i < old_worker->num_threads; i++)
+            {
+                (void)cy_rtos_queue_put(&old_worker->event_queue, &dispatch_info,
+                                        CY_RTOS_NEVER_TIMEOUT);
+            }
+            state = cyhal_system_critical_section_enter();
+        }
+
+        if (old_worker->state != CY_WORKER_THREAD_JOIN_COMPLETE)
+        {
+            cyhal_system_critical_section_exit(state);
+            for (uint32_t i = 0; i < old_worker->num_threads; i++)
+            {
+                result = cy_rtos_thread_join(&old_worker->thread[i]);
+                if (result != CY_RSLT_SUCCESS)
+                {
+                    return result;
+                }
+            }
+            state = cyhal_system_critical_section_enter();
+            old_worker->state = CY_WORKER_THREAD_JOIN_COMPLETE;
+        }
+
+        if (old_worker->state != CY_WORKER_THREAD_INVALID)
+        {
+            cyhal_system_critical_section_exit(state);
+            result = cy_rtos_queue_deinit(&old_worker->event_queue);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                return result;
+            }
+            state = cyhal_system_critical_section_enter();
+            old_worker->state = CY_WORKER_THREAD_INVALID;
+
+            // Drop the delayed items that never came due
+            while (old_worker->delayed != NULL)
+            {
+                cy_worker_thread_work_t* work = old_worker->delayed;
+                old_worker->delayed = work->next;
+                work->next  = NULL;
+                work->flags = 0;
+            }
+        }
+    }
+
+    cyhal_system_critical_section_exit(state);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_enqueue
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
+                                   cy_worker_thread_func_t* work_func, void* arg)
+{
+    if ((worker_info == NULL) || (work_func == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    cy_worker_dispatch_info_t dispatch_info = { work_func, arg, NULL };
+    return cy_worker_thread_put(worker_info, &dispatch_info);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_init
+//--------------------------------------------------------------------------------------------------
+void cy_worker_thread_work_init(cy_worker_thread_work_t* work, cy_worker_thread_func_t* work_func,
+                                void* arg)
+{
+    if ((work == NULL) || (work_func == NULL))
+    {
+        return;
+    }
+
+    memset(work, 0, sizeof(cy_worker_thread_work_t));
+    work->work_func = work_func;
+    work->arg       = arg;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_enqueue
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_work_enqueue(cy_worker_thread_info_t* worker_info,
+                                        cy_worker_thread_work_t* work)
+{
+    if ((worker_info == NULL) || (work == NULL) || (work->work_func == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if ((work->flags & CY_WORKER_WORK_PENDING) != 0)
+    {
+        worker_info->stats.coalesced++;
+        cyhal_system_critical_section_exit(state);
+        return CY_RSLT_SUCCESS;
+    }
+    work->flags = CY_WORKER_WORK_PENDING;
+    cyhal_system_critical_section_exit(state);
+
+    cy_worker_dispatch_info_t dispatch_info = { NULL, NULL, work };
+    cy_rslt_t result = cy_worker_thread_put(worker_info, &dispatch_info);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        state = cyhal_system_critical_section_enter();
+        work->flags = 0;
+        cyhal_system_critical_section_exit(state);
+    }
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_enqueue_delayed
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_work_enqueue_delayed(cy_worker_thread_info_t* worker_info,
+                                                cy_worker_thread_work_t* work,
+                                                cy_time_t delay_ms, uint32_t period_ms)
+{
+    cy_time_t now = 0;
+    bool      earliest;
+
+    if ((worker_info == NULL) || (work == NULL) || (work->work_func == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    if ((delay_ms == 0) && (period_ms == 0))
+    {
+        return cy_worker_thread_work_enqueue(worker_info, work);
+    }
+
+    (void)cy_rtos_time_get(&now);
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    if ((worker_info->state != CY_WORKER_THREAD_VALID) &&
+        (worker_info->state != CY_WORKER_THREAD_ENQUEUING))
+    {
+        cyhal_system_critical_section_exit(state);
+        return CY_WORKER_THREAD_ERR_THREAD_INVALID;
+    }
+    if ((work->flags & CY_WORKER_WORK_PENDING) != 0)
+    {
+        worker_info->stats.coalesced++;
+        cyhal_system_critical_section_exit(state);
+        return CY_RSLT_SUCCESS;
+    }
+    work->expiry    = now + delay_ms;
+    work->period_ms = period_ms;
+    work->flags     = CY_WORKER_WORK_PENDING;
+    earliest        = cy_worker_thread_timer_insert(worker_info, work);
+    cyhal_system_critical_section_exit(state);
+
+    if (earliest)
+    {
+        // Wake a thread so that it waits for the new expiry. If the queue is full the threads
+        // are busy, and look at the timer list after every entry anyway.
+        cy_worker_dispatch_info_t dispatch_info = { NULL, worker_info, NULL };
+        (void)cy_worker_thread_put(worker_info, &dispatch_info);
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_work_cancel
+//--------------------------------------------------------------------------------------------------
+bool cy_worker_thread_work_cancel(cy_worker_thread_info_t* worker_info,
+                                  cy_worker_thread_work_t* work)
+{
+    bool was_pending;
+
+    if ((worker_info == NULL) || (work == NULL))
+    {
+        return false;
+    }
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    was_pending = ((work->flags & CY_WORKER_WORK_PENDING) != 0);
+    if ((work->flags & CY_WORKER_WORK_DELAYED) != 0)
+    {
+        cy_worker_thread_timer_remove(worker_info, work);
+    }
+    work->flags = 0;
+    cyhal_system_critical_section_exit(state);
+
+    return was_pending;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_worker_thread_get_stats
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_worker_thread_get_stats(cy_worker_thread_info_t* worker_info,
+                                     cy_worker_thread_stats_t* stats, bool reset)
+{
+    if ((worker_info == NULL) || (stats == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    uint32_t state = cyhal_system_critical_section_enter();
+    *stats = worker_info->stats;
+    if (reset)
+    {
+        memset(&worker_info->stats, 0, sizeof(worker_info->stats));
+    }
+    cyhal_system_critical_section_exit(state);
+
+    // Measured from the stacks themselves, outside the critical section
+    stats->stack_size     = 0;
+    stats->stack_used_max = 0;
+    for (uint32_t i = 0; i < worker_info->num_threads; i++)
+    {
+        uint32_t size, used;
+        if (cy_rtos_thread_get_stack_usage(&worker_info->thread[i], &size, &used) == CY_RSLT_SUCCESS)
+        {
+            stats->stack_size = size;
+            if (used > stats->stack_used_max)
+            {
+                stats->stack_used_max = used;
+            }
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* WHD_POSIX */
\ No newline at end of file
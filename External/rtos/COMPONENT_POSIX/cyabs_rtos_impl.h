@@ -0,0 +1,93 @@
+/***********************************************************************************************//**
+ * \file cyabs_rtos_impl.h
+ *
+ * \brief
+ * Internal definitions for the POSIX (pthreads) RTOS abstraction layer
+ *
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2025 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#pragma once
+
+#ifdef WHD_RTOS
+
+#include <stdint.h>
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+*                 Constants
+******************************************************/
+#define CY_RTOS_MIN_STACK_SIZE      300            /**< Minimum stack size in bytes */
+#define CY_RTOS_ALIGNMENT           0x00000008UL   /**< Minimum alignment for RTOS objects */
+#define CY_RTOS_ALIGNMENT_MASK      0x00000007UL   /**< Mask for checking the alignment of
+                                                        created RTOS objects */
+
+/******************************************************
+*                   Enumerations
+******************************************************/
+
+/* Mapped onto the SCHED_FIFO range when the process may use it, ignored otherwise */
+typedef enum cy_thread_priority
+{
+    CY_RTOS_PRIORITY_MIN         = 0,
+    CY_RTOS_PRIORITY_LOW         = 1,
+    CY_RTOS_PRIORITY_BELOWNORMAL = 2,
+    CY_RTOS_PRIORITY_NORMAL      = 3,
+    CY_RTOS_PRIORITY_ABOVENORMAL = 4,
+    CY_RTOS_PRIORITY_HIGH        = 5,
+    CY_RTOS_PRIORITY_REALTIME    = 6,
+    CY_RTOS_PRIORITY_MAX         = 7
+} cy_thread_priority_t;
+
+/******************************************************
+*                 Type Definitions
+******************************************************/
+
+/* Every object is a handle to state allocated by its init function, as with FreeRTOS */
+typedef struct cy_posix_mutex     *cy_mutex_t;
+typedef struct cy_posix_semaphore *cy_semaphore_t;
+typedef struct cy_posix_queue     *cy_queue_t;
+typedef struct cy_posix_thread    *cy_thread_t;
+typedef struct cy_posix_event     *cy_event_t;
+typedef struct cy_posix_timer     *cy_timer_t;
+typedef uint32_t                   cy_timer_callback_arg_t;
+typedef void*                      cy_thread_arg_t;
+typedef uint32_t                   cy_time_t;
+typedef int                        cy_rtos_error_t;
+
+/** Marks the calling thread as running in interrupt context, or back in thread context.
+ *
+ * A simulated bus calls this around its interrupt handler so that the driver's ISR paths
+ * are exercised: blocking calls with a timeout are rejected and queue operations do not
+ * block, as they would on the target.
+ *
+ * @param[in] in_isr  true on handler entry, false on exit
+ */
+void cy_rtos_posix_set_isr_context(bool in_isr);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* WHD_RTOS */
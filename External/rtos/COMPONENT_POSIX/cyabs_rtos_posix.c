@@ -0,0 +1,1727 @@
+/***********************************************************************************************//**
+ * \file cyabs_rtos_posix.c
+ *
+ * \brief
+ * Implementation for the POSIX (pthreads) abstraction
+ *
+ * Lets the WHD core run as an ordinary Linux process against a simulated bus. Objects are
+ * built from pthread mutexes and condition variables waiting on CLOCK_MONOTONIC, so timeouts
+ * are unaffected by wall clock changes. Timers run their callbacks on a single service thread,
+ * like the FreeRTOS timer daemon.
+ *
+ * Differences from a target RTOS that callers can observe:
+ * - Thread priorities are only applied when built with CY_RTOS_POSIX_SCHED_FIFO and the process
+ *   is allowed to use SCHED_FIFO; otherwise every thread runs at the default policy.
+ * - A caller supplied stack is not used. The thread gets a host sized stack of at least
+ *   stack_size bytes, since host library calls need more than the target budgets.
+ * - cy_rtos_scheduler_suspend() cannot stop other threads. It takes a process wide lock that
+ *   is shared with the worker thread critical sections.
+ * - With CY_RTOS_HIGH_WATER each thread runs on a pattern filled stack allocated here, of at
+ *   least CY_POSIX_STACK_FILL_MIN_SIZE bytes. The usage reported for it is what the thread used
+ *   on the host, including the TLS block the C library keeps at the top of the stack.
+ *
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2025 Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#ifdef WHD_POSIX
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <cy_result.h>
+#include "cyabs_rtos.h"
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(CY_RTOS_HIGH_WATER)
+#include <unistd.h>
+#endif
+
+#define CY_POSIX_NAME_LEN           (16)
+#define CY_POSIX_NS_PER_MS          (1000000ULL)
+#define CY_POSIX_NS_PER_SEC         (1000000000ULL)
+
+#if defined(CY_RTOS_HIGH_WATER)
+#define CY_POSIX_STACK_FILL_BYTE    (0xA5)
+#if !defined(CY_POSIX_STACK_FILL_MIN_SIZE)
+#define CY_POSIX_STACK_FILL_MIN_SIZE (256U * 1024U)
+#endif
+#endif
+
+struct cy_posix_thread
+{
+    pthread_t               handle;
+    cy_thread_entry_fn_t    entry;
+    cy_thread_arg_t         arg;
+    char                    name[CY_POSIX_NAME_LEN];
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    uint32_t                notify_count;
+    cy_thread_state_t       state;
+    bool                    adopted;    /* Wraps a thread not created through this layer */
+    uint32_t                stack_size;
+    void*                   stack_mem;  /* Pattern filled stack, with CY_RTOS_HIGH_WATER */
+    size_t                  stack_mem_size;
+};
+
+struct cy_posix_mutex
+{
+    pthread_mutex_t         handle;
+    bool                    is_recursive;
+};
+
+struct cy_posix_semaphore
+{
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    uint32_t                count;
+    uint32_t                maxcount;
+};
+
+struct cy_posix_event
+{
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    uint32_t                bits;
+};
+
+struct cy_posix_queue
+{
+    pthread_mutex_t         lock;
+    pthread_cond_t          not_empty;
+    pthread_cond_t          not_full;
+    uint8_t*                data;
+    size_t                  length;
+    size_t                  itemsize;
+    size_t                  head;
+    size_t                  count;
+    size_t                  high_water;
+};
+
+struct cy_posix_timer
+{
+    cy_timer_callback_t     cb;
+    cy_timer_callback_arg_t arg;
+    cy_timer_trigger_type_t type;
+    uint64_t                period_ns;
+    uint64_t                expiry_ns;
+    bool                    active;
+    struct cy_posix_timer*  next;
+};
+
+static __thread int                     _cy_rtos_last_error;
+static __thread bool                    _cy_rtos_in_isr;
+static __thread struct cy_posix_thread* _cy_rtos_self;
+
+static pthread_once_t  _cy_rtos_thread_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t   _cy_rtos_thread_key;
+
+
+//==================================================================================================
+// Helpers
+//==================================================================================================
+
+static bool is_in_isr(void)
+{
+    return _cy_rtos_in_isr;
+}
+
+
+static uint64_t cy_posix_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * CY_POSIX_NS_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+
+static void cy_posix_to_timespec(uint64_t ns, struct timespec* ts)
+{
+    ts->tv_sec  = (time_t)(ns / CY_POSIX_NS_PER_SEC);
+    ts->tv_nsec = (long)(ns % CY_POSIX_NS_PER_SEC);
+}
+
+
+static cy_rslt_t cy_posix_error(int err)
+{
+    _cy_rtos_last_error = err;
+    return (err == ENOMEM) ? CY_RTOS_NO_MEMORY : CY_RTOS_GENERAL_ERROR;
+}
+
+
+// Initializes a mutex and condition variable pair; the condition waits on CLOCK_MONOTONIC
+static int cy_posix_sync_init(pthread_mutex_t* lock, pthread_cond_t* cond)
+{
+    pthread_condattr_t attr;
+    int err = pthread_mutex_init(lock, NULL);
+    if (err == 0)
+    {
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        err = pthread_cond_init(cond, &attr);
+        pthread_condattr_destroy(&attr);
+        if (err != 0)
+        {
+            pthread_mutex_destroy(lock);
+        }
+    }
+    return err;
+}
+
+
+// Waits on cond until signalled or the absolute deadline passes. A zero deadline never expires.
+// Returns ETIMEDOUT once the deadline has passed.
+static int cy_posix_cond_wait(pthread_cond_t* cond, pthread_mutex_t* lock, uint64_t deadline_ns)
+{
+    struct timespec ts;
+    if (deadline_ns == 0)
+    {
+        return pthread_cond_wait(cond, lock);
+    }
+    cy_posix_to_timespec(deadline_ns, &ts);
+    return pthread_cond_timedwait(cond, lock, &ts);
+}
+
+
+// Converts a relative timeout into a deadline for cy_posix_cond_wait()
+static uint64_t cy_posix_deadline(cy_time_t timeout_ms)
+{
+    return (timeout_ms == CY_RTOS_NEVER_TIMEOUT)
+           ? 0
+           : cy_posix_now_ns() + ((uint64_t)timeout_ms * CY_POSIX_NS_PER_MS);
+}
+
+
+//==================================================================================================
+// Error Converter
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_last_error
+//--------------------------------------------------------------------------------------------------
+cy_rtos_error_t cy_rtos_last_error(void)
+{
+    return _cy_rtos_last_error;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_posix_set_isr_context
+//--------------------------------------------------------------------------------------------------
+void cy_rtos_posix_set_isr_context(bool in_isr)
+{
+    _cy_rtos_in_isr = in_isr;
+}
+
+
+//==================================================================================================
+// Threads
+//==================================================================================================
+
+// Frees the wrapper of a thread that was adopted by cy_posix_thread_self() when it exits
+static void cy_posix_thread_key_destroy(void* value)
+{
+    struct cy_posix_thread* wrapper = (struct cy_posix_thread*)value;
+    if ((wrapper != NULL) && wrapper->adopted)
+    {
+        pthread_cond_destroy(&wrapper->cond);
+        pthread_mutex_destroy(&wrapper->lock);
+        free(wrapper);
+    }
+}
+
+
+static void cy_posix_thread_key_init(void)
+{
+    (void)pthread_key_create(&_cy_rtos_thread_key, cy_posix_thread_key_destroy);
+}
+
+
+// Returns the wrapper of the calling thread. Threads not created by cy_rtos_thread_create()
+// (e.g. main) get one on first use so they can be notified and compared like any other.
+static struct cy_posix_thread* cy_posix_thread_self(void)
+{
+    if (_cy_rtos_self == NULL)
+    {
+        struct cy_posix_thread* wrapper = (struct cy_posix_thread*)calloc(1, sizeof(*wrapper));
+        if ((wrapper == NULL) || (cy_posix_sync_init(&wrapper->lock, &wrapper->cond) != 0))
+        {
+            free(wrapper);
+            return NULL;
+        }
+        wrapper->handle  = pthread_self();
+        wrapper->state   = CY_THREAD_STATE_RUNNING;
+        wrapper->adopted = true;
+        (void)pthread_getname_np(wrapper->handle, wrapper->name, sizeof(wrapper->name));
+        pthread_once(&_cy_rtos_thread_key_once, cy_posix_thread_key_init);
+        (void)pthread_setspecific(_cy_rtos_thread_key, wrapper);
+        _cy_rtos_self = wrapper;
+    }
+    return _cy_rtos_self;
+}
+
+
+static void cy_posix_thread_set_state(struct cy_posix_thread* wrapper, cy_thread_state_t state)
+{
+    pthread_mutex_lock(&wrapper->lock);
+    wrapper->state = state;
+    pthread_mutex_unlock(&wrapper->lock);
+}
+
+
+static void* cy_posix_thread_entry(void* arg)
+{
+    struct cy_posix_thread* wrapper = (struct cy_posix_thread*)arg;
+
+    _cy_rtos_self = wrapper;
+    cy_posix_thread_set_state(wrapper, CY_THREAD_STATE_RUNNING);
+    wrapper->entry(wrapper->arg);
+    // The entry function returned without calling cy_rtos_thread_exit()
+    cy_posix_thread_set_state(wrapper, CY_THREAD_STATE_TERMINATED);
+    return NULL;
+}
+
+
+#if defined(CY_RTOS_POSIX_SCHED_FIFO)
+// Requests SCHED_FIFO with the abstraction priority spread over the policy's range
+static void cy_posix_thread_set_priority(pthread_attr_t* attr, cy_thread_priority_t priority)
+{
+    struct sched_param param;
+    int min = sched_get_priority_min(SCHED_FIFO);
+    int max = sched_get_priority_max(SCHED_FIFO);
+
+    param.sched_priority = min + (((max - min) * (int)priority) / (int)CY_RTOS_PRIORITY_MAX);
+    pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(attr, SCHED_FIFO);
+    pthread_attr_setschedparam(attr, &param);
+}
+
+
+#endif /* defined(CY_RTOS_POSIX_SCHED_FIFO) */
+
+#if defined(CY_RTOS_HIGH_WATER)
+// Gives the thread a stack of its own filled with a pattern, so that its use can be measured
+static int cy_posix_thread_fill_stack(struct cy_posix_thread* wrapper, pthread_attr_t* attr,
+                                      uint32_t stack_size)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (stack_size > CY_POSIX_STACK_FILL_MIN_SIZE)
+        ? stack_size
+        : CY_POSIX_STACK_FILL_MIN_SIZE;
+
+    size = (size + page - 1) & ~(page - 1);
+    if (posix_memalign(&wrapper->stack_mem, page, size) != 0)
+    {
+        wrapper->stack_mem = NULL;
+        return ENOMEM;
+    }
+    memset(wrapper->stack_mem, CY_POSIX_STACK_FILL_BYTE, size);
+    wrapper->stack_mem_size = size;
+    return pthread_attr_setstack(attr, wrapper->stack_mem, size);
+}
+
+
+#endif /* defined(CY_RTOS_HIGH_WATER) */
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_create
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_create(cy_thread_t* thread, cy_thread_entry_fn_t entry_function,
+                                const char* name, void* stack, uint32_t stack_size,
+                                cy_thread_priority_t priority, cy_thread_arg_t arg)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (entry_function == NULL) || (stack_size < CY_RTOS_MIN_STACK_SIZE))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if ((stack != NULL) && (0 != (((uintptr_t)stack) & CY_RTOS_ALIGNMENT_MASK)))
+    {
+        status = CY_RTOS_ALIGNMENT_ERROR;
+    }
+    else
+    {
+        struct cy_posix_thread* wrapper = (struct cy_posix_thread*)calloc(1, sizeof(*wrapper));
+        pthread_attr_t attr;
+        size_t default_size = 0;
+        int err;
+
+        if (wrapper == NULL)
+        {
+            return CY_RTOS_NO_MEMORY;
+        }
+        err = cy_posix_sync_init(&wrapper->lock, &wrapper->cond);
+        if (err != 0)
+        {
+            free(wrapper);
+            return cy_posix_error(err);
+        }
+        wrapper->entry = entry_function;
+        wrapper->arg   = arg;
+        wrapper->state = CY_THREAD_STATE_READY;
+        wrapper->stack_size = stack_size;
+        if (name != NULL)
+        {
+            strncpy(wrapper->name, name, sizeof(wrapper->name) - 1);
+        }
+
+        pthread_attr_init(&attr);
+        #if defined(CY_RTOS_HIGH_WATER)
+        (void)default_size;
+        err = cy_posix_thread_fill_stack(wrapper, &attr, stack_size);
+        if (err != 0)
+        {
+            pthread_attr_destroy(&attr);
+            pthread_cond_destroy(&wrapper->cond);
+            pthread_mutex_destroy(&wrapper->lock);
+            free(wrapper->stack_mem);
+            free(wrapper);
+            return cy_posix_error(err);
+        }
+        #else
+        pthread_attr_getstacksize(&attr, &default_size);
+        if (stack_size > default_size)
+        {
+            pthread_attr_setstacksize(&attr, stack_size);
+        }
+        #endif
+        #if defined(CY_RTOS_POSIX_SCHED_FIFO)
+        cy_posix_thread_set_priority(&attr, priority);
+        err = pthread_create(&wrapper->handle, &attr, cy_posix_thread_entry, wrapper);
+        if (err == EPERM)
+        {
+            // Not allowed to use a realtime policy, run at the default one
+            pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+            err = pthread_create(&wrapper->handle, &attr, cy_posix_thread_entry, wrapper);
+        }
+        #else
+        (void)priority;
+        err = pthread_create(&wrapper->handle, &attr, cy_posix_thread_entry, wrapper);
+        #endif
+        pthread_attr_destroy(&attr);
+
+        if (err != 0)
+        {
+            pthread_cond_destroy(&wrapper->cond);
+            pthread_mutex_destroy(&wrapper->lock);
+            free(wrapper->stack_mem);
+            free(wrapper);
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            if (wrapper->name[0] != '\0')
+            {
+                (void)pthread_setname_np(wrapper->handle, wrapper->name);
+            }
+            *thread = wrapper;
+            status  = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_exit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_exit(void)
+{
+    struct cy_posix_thread* wrapper = _cy_rtos_self;
+    if ((wrapper != NULL) && !wrapper->adopted)
+    {
+        cy_posix_thread_set_state(wrapper, CY_THREAD_STATE_TERMINATED);
+    }
+    // Resources are released by cy_rtos_thread_join(), as on the other RTOSes
+    pthread_exit(NULL);
+}
+
+
+// Releases a thread created by cy_rtos_thread_create() once it has been joined
+static void cy_posix_thread_free(struct cy_posix_thread* wrapper)
+{
+    pthread_cond_destroy(&wrapper->cond);
+    pthread_mutex_destroy(&wrapper->lock);
+    free(wrapper->stack_mem);
+    free(wrapper);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_terminate
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_terminate(cy_thread_t* thread)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (*thread == NULL) || (*thread)->adopted ||
+        pthread_equal((*thread)->handle, pthread_self()))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        // The thread stops at its next cancellation point, which every blocking call here is
+        int err = pthread_cancel((*thread)->handle);
+        if ((err == 0) || (err == ESRCH))
+        {
+            err = pthread_join((*thread)->handle, NULL);
+        }
+        if (err != 0)
+        {
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            cy_posix_thread_free(*thread);
+            *thread = NULL;
+            status  = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_is_running
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_is_running(cy_thread_t* thread, bool* running)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (*thread == NULL) || (running == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        cy_thread_state_t state;
+        (void)cy_rtos_thread_get_state(thread, &state);
+        *running = (state == CY_THREAD_STATE_RUNNING);
+        status   = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_get_state
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_get_state(cy_thread_t* thread, cy_thread_state_t* state)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (*thread == NULL) || (state == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*thread)->lock);
+        *state = (*thread)->state;
+        pthread_mutex_unlock(&(*thread)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_join
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_join(cy_thread_t* thread)
+{
+    cy_rslt_t status = CY_RSLT_SUCCESS;
+    if ((thread == NULL) || ((*thread != NULL) && (*thread)->adopted))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else if (*thread != NULL)
+    {
+        int err = pthread_join((*thread)->handle, NULL);
+        if (err != 0)
+        {
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            cy_posix_thread_free(*thread);
+            *thread = NULL;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_get_handle
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_get_handle(cy_thread_t* thread)
+{
+    cy_rslt_t status = CY_RSLT_SUCCESS;
+
+    if (thread == NULL)
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        *thread = cy_posix_thread_self();
+        if (*thread == NULL)
+        {
+            status = CY_RTOS_NO_MEMORY;
+        }
+    }
+
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_wait_notification
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_wait_notification(cy_time_t timeout_ms)
+{
+    struct cy_posix_thread* self = cy_posix_thread_self();
+    uint64_t deadline = cy_posix_deadline(timeout_ms);
+    cy_rslt_t status  = CY_RSLT_SUCCESS;
+
+    if (self == NULL)
+    {
+        return CY_RTOS_NO_MEMORY;
+    }
+
+    pthread_mutex_lock(&self->lock);
+    self->state = CY_THREAD_STATE_BLOCKED;
+    while (self->notify_count == 0)
+    {
+        if ((timeout_ms == 0) ||
+            (cy_posix_cond_wait(&self->cond, &self->lock, deadline) == ETIMEDOUT))
+        {
+            status = CY_RTOS_TIMEOUT;
+            break;
+        }
+    }
+    // Like ulTaskNotifyTake(pdTRUE, ...), any number of notifications is consumed at once
+    self->notify_count = 0;
+    self->state        = CY_THREAD_STATE_RUNNING;
+    pthread_mutex_unlock(&self->lock);
+
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_set_notification
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_set_notification(cy_thread_t* thread)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (*thread == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*thread)->lock);
+        (*thread)->notify_count++;
+        pthread_cond_signal(&(*thread)->cond);
+        pthread_mutex_unlock(&(*thread)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_get_name
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_get_name(cy_thread_t* thread, const char** thread_name)
+{
+    if ((thread == NULL) || (*thread == NULL) || (thread_name == NULL))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+    *thread_name = (*thread)->name;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_thread_get_stack_usage
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_thread_get_stack_usage(cy_thread_t* thread, uint32_t* stack_size,
+                                         uint32_t* max_used)
+{
+    cy_rslt_t status;
+    if ((thread == NULL) || (*thread == NULL) || (*thread)->adopted || (stack_size == NULL) ||
+        (max_used == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        #if defined(CY_RTOS_HIGH_WATER)
+        // The stack grows down, so the pattern survives at its low end
+        const uint8_t* stack = (const uint8_t*)(*thread)->stack_mem;
+        size_t unused = 0;
+        while ((unused < (*thread)->stack_mem_size) && (stack[unused] == CY_POSIX_STACK_FILL_BYTE))
+        {
+            unused++;
+        }
+        *stack_size = (*thread)->stack_size;
+        *max_used   = (uint32_t)((*thread)->stack_mem_size - unused);
+        status      = CY_RSLT_SUCCESS;
+        #else
+        status = CY_RTOS_UNSUPPORTED;
+        #endif
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Scheduler
+//==================================================================================================
+static pthread_mutex_t _cy_rtos_scheduler_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static __thread uint16_t _cy_rtos_suspend_count = 0;
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_scheduler_suspend
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_scheduler_suspend(void)
+{
+    pthread_mutex_lock(&_cy_rtos_scheduler_lock);
+    ++_cy_rtos_suspend_count;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_scheduler_resume
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_scheduler_resume(void)
+{
+    cy_rslt_t status;
+    if (_cy_rtos_suspend_count > 0)
+    {
+        --_cy_rtos_suspend_count;
+        pthread_mutex_unlock(&_cy_rtos_scheduler_lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    else
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Mutexes
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mutex_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mutex_init(cy_mutex_t* mutex, bool recursive)
+{
+    cy_rslt_t status;
+    if (mutex == NULL)
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_mutex* m = (struct cy_posix_mutex*)malloc(sizeof(*m));
+        pthread_mutexattr_t attr;
+        int err;
+
+        if (m == NULL)
+        {
+            return CY_RTOS_NO_MEMORY;
+        }
+        // A non-recursive mutex reports relocking and foreign unlocks instead of deadlocking
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, recursive ? PTHREAD_MUTEX_RECURSIVE :
+                                  PTHREAD_MUTEX_ERRORCHECK);
+        err = pthread_mutex_init(&m->handle, &attr);
+        pthread_mutexattr_destroy(&attr);
+        if (err != 0)
+        {
+            free(m);
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            m->is_recursive = recursive;
+            *mutex = m;
+            status = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mutex_get
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mutex_get(cy_mutex_t* mutex, cy_time_t timeout_ms)
+{
+    cy_rslt_t status;
+    // Mutexes cannot be taken from an interrupt on the target either
+    if ((mutex == NULL) || (*mutex == NULL) || is_in_isr())
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        int err;
+        if (timeout_ms == CY_RTOS_NEVER_TIMEOUT)
+        {
+            err = pthread_mutex_lock(&(*mutex)->handle);
+        }
+        else if (timeout_ms == 0)
+        {
+            err = pthread_mutex_trylock(&(*mutex)->handle);
+        }
+        else
+        {
+            // pthread_mutex_timedlock() only takes a CLOCK_REALTIME deadline
+            struct timespec ts;
+            uint64_t deadline;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            deadline = ((uint64_t)ts.tv_sec * CY_POSIX_NS_PER_SEC) + (uint64_t)ts.tv_nsec +
+                       ((uint64_t)timeout_ms * CY_POSIX_NS_PER_MS);
+            cy_posix_to_timespec(deadline, &ts);
+            err = pthread_mutex_timedlock(&(*mutex)->handle, &ts);
+        }
+
+        if (err == 0)
+        {
+            status = CY_RSLT_SUCCESS;
+        }
+        else if ((err == ETIMEDOUT) || (err == EBUSY))
+        {
+            status = CY_RTOS_TIMEOUT;
+        }
+        else
+        {
+            status = cy_posix_error(err);
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mutex_set
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mutex_set(cy_mutex_t* mutex)
+{
+    cy_rslt_t status;
+    if ((mutex == NULL) || (*mutex == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        int err = pthread_mutex_unlock(&(*mutex)->handle);
+        status = (err == 0) ? CY_RSLT_SUCCESS : cy_posix_error(err);
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_mutex_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_mutex_deinit(cy_mutex_t* mutex)
+{
+    cy_rslt_t status;
+    if ((mutex == NULL) || (*mutex == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_destroy(&(*mutex)->handle);
+        free(*mutex);
+        *mutex = NULL;
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Semaphores
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_semaphore_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_semaphore_init(cy_semaphore_t* semaphore, uint32_t maxcount, uint32_t initcount)
+{
+    cy_rslt_t status;
+    if ((semaphore == NULL) || (maxcount == 0) || (initcount > maxcount))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_semaphore* sem = (struct cy_posix_semaphore*)malloc(sizeof(*sem));
+        int err;
+
+        if (sem == NULL)
+        {
+            return CY_RTOS_NO_MEMORY;
+        }
+        err = cy_posix_sync_init(&sem->lock, &sem->cond);
+        if (err != 0)
+        {
+            free(sem);
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            sem->count    = initcount;
+            sem->maxcount = maxcount;
+            *semaphore    = sem;
+            status        = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_semaphore_get
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_semaphore_get(cy_semaphore_t* semaphore, cy_time_t timeout_ms)
+{
+    cy_rslt_t status = CY_RSLT_SUCCESS;
+    // An interrupt handler cannot block, so only a zero timeout is accepted there
+    if ((semaphore == NULL) || (*semaphore == NULL) || (is_in_isr() && (timeout_ms != 0)))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_semaphore* sem = *semaphore;
+        uint64_t deadline = cy_posix_deadline(timeout_ms);
+
+        pthread_mutex_lock(&sem->lock);
+        while (sem->count == 0)
+        {
+            if ((timeout_ms == 0) ||
+                (cy_posix_cond_wait(&sem->cond, &sem->lock, deadline) == ETIMEDOUT))
+            {
+                status = CY_RTOS_TIMEOUT;
+                break;
+            }
+        }
+        if (status == CY_RSLT_SUCCESS)
+        {
+            sem->count--;
+        }
+        pthread_mutex_unlock(&sem->lock);
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_semaphore_set
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_semaphore_set(cy_semaphore_t* semaphore)
+{
+    cy_rslt_t status;
+    if ((semaphore == NULL) || (*semaphore == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_semaphore* sem = *semaphore;
+
+        pthread_mutex_lock(&sem->lock);
+        if (sem->count < sem->maxcount)
+        {
+            sem->count++;
+            pthread_cond_signal(&sem->cond);
+            status = CY_RSLT_SUCCESS;
+        }
+        else
+        {
+            // Giving a full semaphore fails, as xSemaphoreGive() does
+            status = CY_RTOS_GENERAL_ERROR;
+        }
+        pthread_mutex_unlock(&sem->lock);
+    }
+
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_semaphore_get_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_semaphore_get_count(cy_semaphore_t* semaphore, size_t* count)
+{
+    cy_rslt_t status;
+    if ((semaphore == NULL) || (*semaphore == NULL) || (count == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*semaphore)->lock);
+        *count = (*semaphore)->count;
+        pthread_mutex_unlock(&(*semaphore)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_semaphore_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_semaphore_deinit(cy_semaphore_t* semaphore)
+{
+    cy_rslt_t status;
+    if ((semaphore == NULL) || (*semaphore == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_cond_destroy(&(*semaphore)->cond);
+        pthread_mutex_destroy(&(*semaphore)->lock);
+        free(*semaphore);
+        *semaphore = NULL;
+        status     = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Events
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_init_event
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_event_init(cy_event_t* event)
+{
+    cy_rslt_t status;
+    if (event == NULL)
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_event* ev = (struct cy_posix_event*)malloc(sizeof(*ev));
+        int err;
+
+        if (ev == NULL)
+        {
+            return CY_RTOS_NO_MEMORY;
+        }
+        err = cy_posix_sync_init(&ev->lock, &ev->cond);
+        if (err != 0)
+        {
+            free(ev);
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            ev->bits = 0;
+            *event   = ev;
+            status   = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_event_setbits
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_event_setbits(cy_event_t* event, uint32_t bits)
+{
+    cy_rslt_t status;
+    if ((event == NULL) || (*event == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*event)->lock);
+        (*event)->bits |= bits;
+        // Waiters may be waiting on different bits, so wake all of them
+        pthread_cond_broadcast(&(*event)->cond);
+        pthread_mutex_unlock(&(*event)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_event_clearbits
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_event_clearbits(cy_event_t* event, uint32_t bits)
+{
+    cy_rslt_t status;
+    if ((event == NULL) || (*event == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*event)->lock);
+        (*event)->bits &= ~bits;
+        pthread_mutex_unlock(&(*event)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_event_getbits
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_event_getbits(cy_event_t* event, uint32_t* bits)
+{
+    cy_rslt_t status;
+    if ((event == NULL) || (*event == NULL) || (bits == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*event)->lock);
+        *bits = (*event)->bits;
+        pthread_mutex_unlock(&(*event)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_event_waitbits
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_event_waitbits(cy_event_t* event, uint32_t* bits, bool clear, bool all,
+                                 cy_time_t timeout_ms)
+{
+    cy_rslt_t status = CY_RSLT_SUCCESS;
+    if ((event == NULL) || (*event == NULL) || (bits == NULL) ||
+        (is_in_isr() && (timeout_ms != 0)))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_event* ev = *event;
+        uint64_t deadline = cy_posix_deadline(timeout_ms);
+        uint32_t bitsVal  = *bits;
+
+        pthread_mutex_lock(&ev->lock);
+        while (!(((ev->bits & bitsVal) == bitsVal) || (((ev->bits & bitsVal) != 0) && !all)))
+        {
+            if ((timeout_ms == 0) ||
+                (cy_posix_cond_wait(&ev->cond, &ev->lock, deadline) == ETIMEDOUT))
+            {
+                status = CY_RTOS_TIMEOUT;
+                break;
+            }
+        }
+        // As xEventGroupWaitBits(), report the bits before any are cleared
+        *bits = ev->bits;
+        if ((status == CY_RSLT_SUCCESS) && clear)
+        {
+            ev->bits &= ~bitsVal;
+        }
+        pthread_mutex_unlock(&ev->lock);
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_event_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_event_deinit(cy_event_t* event)
+{
+    cy_rslt_t status;
+    if ((event == NULL) || (*event == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_cond_destroy(&(*event)->cond);
+        pthread_mutex_destroy(&(*event)->lock);
+        free(*event);
+        *event = NULL;
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Queues
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_init(cy_queue_t* queue, size_t length, size_t itemsize)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (length == 0) || (itemsize == 0))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_queue* q = (struct cy_posix_queue*)calloc(1, sizeof(*q));
+        int err;
+
+        if (q == NULL)
+        {
+            return CY_RTOS_NO_MEMORY;
+        }
+        q->data = (uint8_t*)malloc(length * itemsize);
+        if (q->data == NULL)
+        {
+            free(q);
+            return CY_RTOS_NO_MEMORY;
+        }
+        err = cy_posix_sync_init(&q->lock, &q->not_empty);
+        if (err == 0)
+        {
+            pthread_condattr_t attr;
+            pthread_condattr_init(&attr);
+            pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+            err = pthread_cond_init(&q->not_full, &attr);
+            pthread_condattr_destroy(&attr);
+            if (err != 0)
+            {
+                pthread_cond_destroy(&q->not_empty);
+                pthread_mutex_destroy(&q->lock);
+            }
+        }
+        if (err != 0)
+        {
+            free(q->data);
+            free(q);
+            status = cy_posix_error(err);
+        }
+        else
+        {
+            q->length   = length;
+            q->itemsize = itemsize;
+            *queue      = q;
+            status      = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_put
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_put(cy_queue_t* queue, const void* item_ptr, cy_time_t timeout_ms)
+{
+    cy_rslt_t status = CY_RSLT_SUCCESS;
+    if ((queue == NULL) || (*queue == NULL) || (item_ptr == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_queue* q = *queue;
+        // From an interrupt the timeout is ignored, as xQueueSendToBackFromISR() has none
+        cy_time_t timeout = is_in_isr() ? 0 : timeout_ms;
+        uint64_t deadline = cy_posix_deadline(timeout);
+
+        pthread_mutex_lock(&q->lock);
+        while (q->count == q->length)
+        {
+            if ((timeout == 0) ||
+                (cy_posix_cond_wait(&q->not_full, &q->lock, deadline) == ETIMEDOUT))
+            {
+                status = CY_RTOS_GENERAL_ERROR;
+                break;
+            }
+        }
+        if (status == CY_RSLT_SUCCESS)
+        {
+            size_t tail = (q->head + q->count) % q->length;
+            memcpy(&q->data[tail * q->itemsize], item_ptr, q->itemsize);
+            q->count++;
+            if (q->count > q->high_water)
+            {
+                q->high_water = q->count;
+            }
+            pthread_cond_signal(&q->not_empty);
+        }
+        pthread_mutex_unlock(&q->lock);
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_get
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_get(cy_queue_t* queue, void* item_ptr, cy_time_t timeout_ms)
+{
+    cy_rslt_t status = CY_RSLT_SUCCESS;
+    if ((queue == NULL) || (*queue == NULL) || (item_ptr == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_queue* q = *queue;
+        cy_time_t timeout = is_in_isr() ? 0 : timeout_ms;
+        uint64_t deadline = cy_posix_deadline(timeout);
+
+        pthread_mutex_lock(&q->lock);
+        while (q->count == 0)
+        {
+            if ((timeout == 0) ||
+                (cy_posix_cond_wait(&q->not_empty, &q->lock, deadline) == ETIMEDOUT))
+            {
+                status = CY_RTOS_GENERAL_ERROR;
+                break;
+            }
+        }
+        if (status == CY_RSLT_SUCCESS)
+        {
+            memcpy(item_ptr, &q->data[q->head * q->itemsize], q->itemsize);
+            q->head = (q->head + 1) % q->length;
+            q->count--;
+            pthread_cond_signal(&q->not_full);
+        }
+        pthread_mutex_unlock(&q->lock);
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_count
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_count(cy_queue_t* queue, size_t* num_waiting)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (*queue == NULL) || (num_waiting == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*queue)->lock);
+        *num_waiting = (*queue)->count;
+        pthread_mutex_unlock(&(*queue)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_space
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_space(cy_queue_t* queue, size_t* num_spaces)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (*queue == NULL) || (num_spaces == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*queue)->lock);
+        *num_spaces = (*queue)->length - (*queue)->count;
+        pthread_mutex_unlock(&(*queue)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_get_high_water
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_get_high_water(cy_queue_t* queue, size_t* high_water)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (*queue == NULL) || (high_water == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*queue)->lock);
+        *high_water = (*queue)->high_water;
+        pthread_mutex_unlock(&(*queue)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_reset
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_reset(cy_queue_t* queue)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (*queue == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&(*queue)->lock);
+        (*queue)->head  = 0;
+        (*queue)->count = 0;
+        pthread_cond_broadcast(&(*queue)->not_full);
+        pthread_mutex_unlock(&(*queue)->lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_queue_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_queue_deinit(cy_queue_t* queue)
+{
+    cy_rslt_t status;
+    if ((queue == NULL) || (*queue == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_cond_destroy(&(*queue)->not_full);
+        pthread_cond_destroy(&(*queue)->not_empty);
+        pthread_mutex_destroy(&(*queue)->lock);
+        free((*queue)->data);
+        free(*queue);
+        *queue = NULL;
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Timers
+//==================================================================================================
+
+// Active timers, sorted by expiry, and the single thread that fires them
+static pthread_once_t         _cy_rtos_timer_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t        _cy_rtos_timer_lock;
+static pthread_cond_t         _cy_rtos_timer_cond;
+static pthread_t              _cy_rtos_timer_thread;
+static int                    _cy_rtos_timer_init_err;
+static struct cy_posix_timer* _cy_rtos_timer_list;
+static struct cy_posix_timer* _cy_rtos_timer_firing;
+
+
+static void cy_posix_timer_remove(struct cy_posix_timer* timer)
+{
+    struct cy_posix_timer** link = &_cy_rtos_timer_list;
+    while (*link != NULL)
+    {
+        if (*link == timer)
+        {
+            *link = timer->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    timer->next   = NULL;
+    timer->active = false;
+}
+
+
+static void cy_posix_timer_insert(struct cy_posix_timer* timer)
+{
+    struct cy_posix_timer** link = &_cy_rtos_timer_list;
+    while ((*link != NULL) && ((*link)->expiry_ns <= timer->expiry_ns))
+    {
+        link = &(*link)->next;
+    }
+    timer->next   = *link;
+    timer->active = true;
+    *link         = timer;
+}
+
+
+static void* cy_posix_timer_service(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&_cy_rtos_timer_lock);
+    while (1)
+    {
+        struct cy_posix_timer* timer = _cy_rtos_timer_list;
+        if (timer == NULL)
+        {
+            pthread_cond_wait(&_cy_rtos_timer_cond, &_cy_rtos_timer_lock);
+        }
+        else if (cy_posix_now_ns() < timer->expiry_ns)
+        {
+            (void)cy_posix_cond_wait(&_cy_rtos_timer_cond, &_cy_rtos_timer_lock,
+                                     timer->expiry_ns);
+        }
+        else
+        {
+            cy_timer_callback_t     cb  = timer->cb;
+            cy_timer_callback_arg_t cb_arg = timer->arg;
+
+            cy_posix_timer_remove(timer);
+            if (timer->type == CY_TIMER_TYPE_PERIODIC)
+            {
+                timer->expiry_ns += timer->period_ns;
+                cy_posix_timer_insert(timer);
+            }
+            // Run the callback unlocked so it can restart or stop timers
+            _cy_rtos_timer_firing = timer;
+            pthread_mutex_unlock(&_cy_rtos_timer_lock);
+            cb(cb_arg);
+            pthread_mutex_lock(&_cy_rtos_timer_lock);
+            _cy_rtos_timer_firing = NULL;
+            pthread_cond_broadcast(&_cy_rtos_timer_cond);
+        }
+    }
+    return NULL;
+}
+
+
+static void cy_posix_timer_service_init(void)
+{
+    int err = cy_posix_sync_init(&_cy_rtos_timer_lock, &_cy_rtos_timer_cond);
+    if (err == 0)
+    {
+        err = pthread_create(&_cy_rtos_timer_thread, NULL, cy_posix_timer_service, NULL);
+        if (err == 0)
+        {
+            (void)pthread_setname_np(_cy_rtos_timer_thread, "CYTimer");
+            (void)pthread_detach(_cy_rtos_timer_thread);
+        }
+    }
+    _cy_rtos_timer_init_err = err;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_timer_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_timer_init(cy_timer_t* timer, cy_timer_trigger_type_t type,
+                             cy_timer_callback_t fun, cy_timer_callback_arg_t arg)
+{
+    cy_rslt_t status;
+    if ((timer == NULL) || (fun == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_timer* t;
+
+        pthread_once(&_cy_rtos_timer_once, cy_posix_timer_service_init);
+        if (_cy_rtos_timer_init_err != 0)
+        {
+            return cy_posix_error(_cy_rtos_timer_init_err);
+        }
+        t = (struct cy_posix_timer*)calloc(1, sizeof(*t));
+        if (t == NULL)
+        {
+            status = CY_RTOS_NO_MEMORY;
+        }
+        else
+        {
+            t->cb   = fun;
+            t->arg  = arg;
+            t->type = type;
+            *timer  = t;
+            status  = CY_RSLT_SUCCESS;
+        }
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_timer_start
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_timer_start(cy_timer_t* timer, cy_time_t num_ms)
+{
+    cy_rslt_t status;
+    if ((timer == NULL) || (*timer == NULL) ||
+        ((num_ms == 0) && ((*timer)->type == CY_TIMER_TYPE_PERIODIC)))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        struct cy_posix_timer* t = *timer;
+
+        pthread_mutex_lock(&_cy_rtos_timer_lock);
+        // Restarting an active timer moves its expiry, as xTimerChangePeriod() does
+        cy_posix_timer_remove(t);
+        t->period_ns = (uint64_t)num_ms * CY_POSIX_NS_PER_MS;
+        t->expiry_ns = cy_posix_now_ns() + t->period_ns;
+        cy_posix_timer_insert(t);
+        pthread_cond_broadcast(&_cy_rtos_timer_cond);
+        pthread_mutex_unlock(&_cy_rtos_timer_lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_timer_stop
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_timer_stop(cy_timer_t* timer)
+{
+    cy_rslt_t status;
+    if ((timer == NULL) || (*timer == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&_cy_rtos_timer_lock);
+        cy_posix_timer_remove(*timer);
+        pthread_mutex_unlock(&_cy_rtos_timer_lock);
+        status = CY_RSLT_SUCCESS;
+    }
+
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_timer_is_running
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_timer_is_running(cy_timer_t* timer, bool* state)
+{
+    cy_rslt_t status;
+    if ((timer == NULL) || (*timer == NULL) || (state == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&_cy_rtos_timer_lock);
+        *state = (*timer)->active;
+        pthread_mutex_unlock(&_cy_rtos_timer_lock);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_timer_deinit
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_timer_deinit(cy_timer_t* timer)
+{
+    cy_rslt_t status;
+    if ((timer == NULL) || (*timer == NULL))
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        pthread_mutex_lock(&_cy_rtos_timer_lock);
+        cy_posix_timer_remove(*timer);
+        // Wait for a callback already running on the service thread, unless that is the caller
+        while ((_cy_rtos_timer_firing == *timer) &&
+               !pthread_equal(pthread_self(), _cy_rtos_timer_thread))
+        {
+            pthread_cond_wait(&_cy_rtos_timer_cond, &_cy_rtos_timer_lock);
+        }
+        pthread_mutex_unlock(&_cy_rtos_timer_lock);
+        free(*timer);
+        *timer = NULL;
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//==================================================================================================
+// Time
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_time_get
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_time_get(cy_time_t* tval)
+{
+    cy_rslt_t status;
+    if (tval == NULL)
+    {
+        status = CY_RTOS_BAD_PARAM;
+    }
+    else
+    {
+        *tval  = (cy_time_t)(cy_posix_now_ns() / CY_POSIX_NS_PER_MS);
+        status = CY_RSLT_SUCCESS;
+    }
+    return status;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_rtos_delay_milliseconds
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    struct timespec ts;
+    cy_posix_to_timespec(cy_posix_now_ns() + ((uint64_t)num_ms * CY_POSIX_NS_PER_MS), &ts);
+    // Absolute sleep so a signal does not stretch the delay when it restarts
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+
+#endif /* WHD_POSIX */
@@ -3,11 +3,11 @@
  *
  * \brief
  * Defines the interface for the worker thread utility. Provides prototypes for
- * functions that allow creating/deleting worker threads and queueing work to
- * a worker thread.
+ * functions that allow creating/deleting worker threads and queueing immediate,
+ * delayed and periodic work to a worker thread.
  ***************************************************************************************************
  * \copyright
- * Copyright 2018-2022 Cypress Semiconductor Corporation (an Infineon company) or
+ * Copyright 2018-2025 Cypress Semiconductor Corporation (an Infineon company) or
  * an affiliate of Cypress Semiconductor Corporation
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -34,6 +34,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "cy_result.h"
 #include "cyabs_rtos.h"
@@ -45,12 +46,26 @@ extern "C" {
  * This utility can be used to delegate work that is not timing critical. For example,
  * scheduling work in interrupt handlers to keep handler execution times low or if some
  * work needs to be done at a different priority.
+ *
+ * Besides plain function calls, work can be described by a \ref cy_worker_thread_work_t
+ * embedded in the caller's own state. Such an item is queued at most once while it is pending,
+ * so repeated requests for the same refresh are merged into one run, and it can be delayed or
+ * made periodic. Delayed items are kept in one list per worker ordered by expiry. The worker
+ * threads wait on their queue with a timeout set to the earliest expiry, so no RTOS timer is
+ * used.
+ *
+ * A worker can run a pool of threads that share one queue. Items then run concurrently, and a
+ * work function must not assume it is serialised with other work.
  */
 
 /**< Default worker thread name */
 #define CY_WORKER_THREAD_DEFAULT_NAME               "CYWorker"
 /** Default number of work items in the queue */
 #define CY_WORKER_DEFAULT_ENTRIES                   (16)
+/** Largest pool of threads a worker can run */
+#ifndef CY_WORKER_THREAD_MAX_THREADS
+#define CY_WORKER_THREAD_MAX_THREADS                (4)
+#endif
 
 /** Additional work cannot be enqueued because the worker thread has been terminated.
  * This can occur if \ref cy_worker_thread_create was not called or \ref cy_worker_thread_delete was
@@ -62,6 +77,34 @@ extern "C" {
 /** Worker thread function call prototype  */
 typedef void (cy_worker_thread_func_t)(void* arg);
 
+/** Work item. Embed it in the state it works on and set it up with
+ * \ref cy_worker_thread_work_init. The fields are private to the worker thread utility.
+ */
+typedef struct cy_worker_thread_work
+{
+    cy_worker_thread_func_t*      work_func;  /**< Function to run                          */
+    void*                         arg;        /**< Argument passed to work_func             */
+    struct cy_worker_thread_work* next;       /**< Next item in the delayed list            */
+    cy_time_t                     expiry;     /**< Time the delayed item is due             */
+    uint32_t                      period_ms;  /**< Reload of a periodic item, 0 if one-shot */
+    volatile uint8_t              flags;      /**< Pending and delayed state                */
+} cy_worker_thread_work_t;
+
+/** Worker thread statistics */
+typedef struct
+{
+    uint32_t enqueued;          /**< Entries put on the queue                                   */
+    uint32_t coalesced;         /**< Requests merged into an item that was already pending      */
+    uint32_t queue_full;        /**< Requests rejected because the queue was full               */
+    uint32_t queue_depth_max;   /**< Most entries waiting in the queue at once                  */
+    uint32_t executed;          /**< Work functions run, plain calls and items                  */
+    uint32_t timers_expired;    /**< Delayed and periodic items that came due                   */
+    uint32_t run_time_max_ms;   /**< Longest single work function                               */
+    uint32_t run_time_total_ms; /**< Time spent in work functions                               */
+    uint32_t stack_size;        /**< Stack size of each thread, 0 if the port cannot measure it */
+    uint32_t stack_used_max;    /**< Most stack used by any thread of the pool, not reset       */
+} cy_worker_thread_stats_t;
+
 /** Thread state enumeration */
 typedef enum
 {
@@ -85,6 +128,9 @@ typedef struct
     uint32_t             num_entries;  /**< Maximum number of enteries the worker thread can queue.
                                             If set to 0, \ref CY_WORKER_DEFAULT_ENTRIES
                                             will be used.       */
+    uint32_t             num_threads;  /**< Number of threads sharing the queue, at most
+                                            \ref CY_WORKER_THREAD_MAX_THREADS. 0 means 1.
+                                            With more than one thread \ref stack must be NULL. */
 } cy_worker_thread_params_t;
 
 /** Worker Thread Information. */
@@ -92,8 +138,11 @@ typedef struct
 {
     cy_queue_t               event_queue;    /**< Event Queue for this thread */
     uint32_t                 enqueue_count;  /**< Number of conccurent enqueue requests */
-    cy_thread_t              thread;         /**< Thread object               */
+    cy_thread_t              thread[CY_WORKER_THREAD_MAX_THREADS]; /**< Thread objects */
+    uint32_t                 num_threads;    /**< Number of threads in the pool */
     cy_worker_thread_state_t state;          /**< State of the worker thread  */
+    cy_worker_thread_work_t* delayed;        /**< Delayed items, earliest first */
+    cy_worker_thread_stats_t stats;          /**< Statistics                  */
 } cy_worker_thread_info_t;
 
 /** Create worker thread to handle running callbacks in a separate thread.
@@ -112,8 +161,9 @@ cy_rslt_t cy_worker_thread_create(cy_worker_thread_info_t* new_worker,
 
 /** Delete worker thread.
  *
- * @note This function will wait for the thread to complete all pending work in the
- * queue and exit before returning.
+ * @note This function will wait for the threads to complete all pending work in the
+ * queue and exit before returning. Delayed and periodic items that have not come due are
+ * dropped.
  *
  * @param[in] old_worker    pointer to cy_worker_thread_info_t structure to be deleted.
  *
@@ -138,6 +188,70 @@ cy_rslt_t cy_worker_thread_delete(cy_worker_thread_info_t* old_worker);
 cy_rslt_t cy_worker_thread_enqueue(cy_worker_thread_info_t* worker_info,
                                    cy_worker_thread_func_t* work_func, void* arg);
 
+/** Set up a work item.
+ *
+ * @param[out] work          work item to initialise
+ * @param[in]  work_func     function to run
+ * @param[in]  arg           opaque arg to be used in function call
+ */
+void cy_worker_thread_work_init(cy_worker_thread_work_t* work, cy_worker_thread_func_t* work_func,
+                                void* arg);
+
+/** Queue a work item on a worker thread.
+ *
+ * If the item is already pending, queued or delayed, the request is merged into it and the
+ * function runs once. The item is no longer pending once its function starts, so a request made
+ * while it runs queues another run. May be called from an interrupt handler.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run the item
+ * @param[in] work           item initialised with \ref cy_worker_thread_work_init
+ *
+ * @return The status of the queueing of work. A merged request returns CY_RSLT_SUCCESS.
+ */
+cy_rslt_t cy_worker_thread_work_enqueue(cy_worker_thread_info_t* worker_info,
+                                        cy_worker_thread_work_t* work);
+
+/** Queue a work item to run after a delay, and optionally every period after that.
+ *
+ * A request for an item that is already pending is merged into it and does not move its
+ * expiry. May be called from an interrupt handler.
+ *
+ * @param[in] worker_info    pointer to worker_thread used to run the item
+ * @param[in] work           item initialised with \ref cy_worker_thread_work_init
+ * @param[in] delay_ms       time until the first run
+ * @param[in] period_ms      time between later runs, 0 to run once
+ *
+ * @return The status of the queueing of work.
+ */
+cy_rslt_t cy_worker_thread_work_enqueue_delayed(cy_worker_thread_info_t* worker_info,
+                                                cy_worker_thread_work_t* work,
+                                                cy_time_t delay_ms, uint32_t period_ms);
+
+/** Cancel a pending work item.
+ *
+ * A delayed or periodic item is removed from the worker. An item already on the queue is
+ * skipped when the worker reaches it, so it must stay valid until then. Cancelling does not
+ * wait for a run that has already started.
+ *
+ * @param[in] worker_info    pointer to worker_thread the item was queued on
+ * @param[in] work           item to cancel
+ *
+ * @return true if the item was pending.
+ */
+bool cy_worker_thread_work_cancel(cy_worker_thread_info_t* worker_info,
+                                  cy_worker_thread_work_t* work);
+
+/** Get the statistics of a worker thread.
+ *
+ * @param[in]  worker_info   pointer to worker_thread
+ * @param[out] stats         filled with a copy of the statistics
+ * @param[in]  reset         clear the statistics after copying them
+ *
+ * @return The status of the request.
+ */
+cy_rslt_t cy_worker_thread_get_stats(cy_worker_thread_info_t* worker_info,
+                                     cy_worker_thread_stats_t* stats, bool reset);
+
 /** @} */
 
 #ifdef __cplusplus
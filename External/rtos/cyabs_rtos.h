@@ -29,7 +29,7 @@
 
 #pragma once
 
-#ifdef WHD_FREERTOS
+#if defined(WHD_FREERTOS) || defined(WHD_POSIX)
 
 #include "cyabs_rtos_impl.h"
 #include "cy_result.h"
@@ -344,6 +344,26 @@ extern cy_rslt_t cy_rtos_thread_set_notification(cy_thread_t* thread);
 extern cy_rslt_t cy_rtos_thread_get_name(cy_thread_t* thread, const char** thread_name);
 
 
+/** Get the stack usage of a thread
+ *
+ * This function reports the most stack the target thread has used since it was created, so
+ * that stack sizes can be set from measurements rather than guesses. The figure comes from a
+ * fill pattern written over the stack when the thread is created and is only available when
+ * the port fills stacks: on FreeRTOS when INCLUDE_uxTaskGetStackHighWaterMark is set (the
+ * kernel then fills every new stack itself), on the POSIX port when built with
+ * CY_RTOS_HIGH_WATER.
+ *
+ * @param[in]  thread        Handle of a thread created with \ref cy_rtos_thread_create
+ * @param[out] stack_size    Size of the stack the thread was created with, in bytes
+ * @param[out] max_used      Most of the stack the thread has used so far, in bytes
+ *
+ * @returns The status of the request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM,
+ *          \ref CY_RTOS_UNSUPPORTED]
+ */
+extern cy_rslt_t cy_rtos_thread_get_stack_usage(cy_thread_t* thread, uint32_t* stack_size,
+                                                uint32_t* max_used);
+
+
 /** \} group_abstraction_rtos_threads */
 
 
@@ -693,6 +713,21 @@ extern cy_rslt_t cy_rtos_queue_count(cy_queue_t* queue, size_t* num_waiting);
  */
 extern cy_rslt_t cy_rtos_queue_space(cy_queue_t* queue, size_t* num_spaces);
 
+/** Return the most items the queue has held at once.
+ *
+ * This function returns the peak depth of the queue since it was created, so that queue
+ * lengths can be set from measurements. The FreeRTOS port only tracks it when built with
+ * CY_RTOS_HIGH_WATER and configUSE_TRACE_FACILITY, as it keeps the peak in the queue number;
+ * a queue whose number is set by other code reports that number instead.
+ *
+ * @param[in]  queue       Pointer to the queue handle
+ * @param[out] high_water  Pointer to the return count
+ *
+ * @return The status of the request. [\ref CY_RSLT_SUCCESS, \ref CY_RTOS_BAD_PARAM,
+ *         \ref CY_RTOS_UNSUPPORTED]
+ */
+extern cy_rslt_t cy_rtos_queue_get_high_water(cy_queue_t* queue, size_t* high_water);
+
 /** Reset the queue.
  *
  * This function sets the queue to empty.
@@ -1424,4 +1459,4 @@ extern cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms);
 } // extern "C"
 #endif
 
-#endif /* WHD_FREERTOS*/
\ No newline at end of file
+#endif /* defined(WHD_FREERTOS) || defined(WHD_POSIX) */
\ No newline at end of file
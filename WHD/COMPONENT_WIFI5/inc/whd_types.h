@@ -1342,6 +1342,15 @@ typedef enum
     WHD_PACKET_FILTER_RULE_NEGATIVE_MATCHING  = 1  /**< Specifies that a filter should NOT match a given pattern */
 } whd_packet_filter_rule_t;
 
+/**
+ * Enumeration of packet filter modes
+ */
+typedef enum
+{
+    WHD_PACKET_FILTER_MODE_DISCARD_ON_MATCH  = 0, /**< Packets matching an enabled filter are discarded, all others are forwarded */
+    WHD_PACKET_FILTER_MODE_FORWARD_ON_MATCH  = 1  /**< Packets matching an enabled filter are forwarded, all others are discarded */
+} whd_packet_filter_mode_t;
+
 /**
  * Structure describing a packet filter list item
  */
@@ -1352,6 +1352,13 @@ whd_result_t whd_pf_get_packet_filter_mask_and_pattern(whd_interface_t ifp, uint
  */
 whd_result_t whd_wifi_clear_packet_filter_stats(whd_interface_t ifp, uint32_t filter_id);
 
+/** Choose whether the enabled filters select the packets to forward or to discard
+ * @param[in]    ifp        : pointer to handle instance of whd interface
+ * @param[in]    mode       : @ref whd_packet_filter_mode_t, applies to all filters
+ * @return whd_result_t
+ */
+whd_result_t whd_pf_set_packet_filter_mode(whd_interface_t ifp, whd_packet_filter_mode_t mode);
+
 /** Return the stats associated with a filter
  * @param[in]    ifp        : pointer to handle instance of whd interface
  * @param[in]    filter_id  : which filter
@@ -1392,6 +1399,18 @@ whd_result_t whd_tko_max_assoc(whd_interface_t ifp, uint8_t *max);
 whd_result_t whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *whd_connect,
                                     uint16_t buflen);
 
+/** Program a TCP connection for keepalive offload
+ *
+ *  The connection takes effect the next time the offload is enabled with whd_tko_toggle().
+ *
+ * @param[in]    ifp          : Pointer to handle instance of whd interface
+ * @param[in]    whd_connect  : tko_connect structure with the index, sequence numbers, addresses
+ *                              and the keepalive request and response packets
+ * @param[in]    buflen       : Size of the whd_connect buffer
+ * @return whd_result_t
+ */
+whd_result_t whd_tko_set_FW_connect(whd_interface_t ifp, const whd_tko_connect_t *whd_connect, uint16_t buflen);
+
 /** Return the stats associated with a filter
  * @param[in]    ifp        : Pointer to handle instance of whd interface
  * @param[in]    enable     : Enable/Disable TCP Keepalive offload
@@ -1399,6 +1418,24 @@ whd_result_t whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_
  */
 whd_result_t whd_tko_toggle(whd_interface_t ifp, whd_bool_t enable);
 
+/** Enables the firmware TCP/IP checksum offload engine
+ *
+ *  Selects the offloaded checksums with toe_ol and turns the engine on with toe, or turns it
+ *  off if ol_flags is 0. Firmware built without the engine fails the iovars.
+ *
+ * @param[in]    ifp        : Pointer to handle instance of whd interface
+ * @param[in]    ol_flags   : TOE_TX_CSUM_OL and TOE_RX_CSUM_OL bits
+ * @return whd_result_t
+ */
+whd_result_t whd_toe_set(whd_interface_t ifp, uint32_t ol_flags);
+
+/** Reads the checksums the firmware offload engine computes
+ * @param[in]    ifp        : Pointer to handle instance of whd interface
+ * @param[out]   ol_flags   : TOE_TX_CSUM_OL and TOE_RX_CSUM_OL bits, 0 if the engine is off
+ * @return whd_result_t
+ */
+whd_result_t whd_toe_get(whd_interface_t ifp, uint32_t *ol_flags);
+
 /** Return the stats associated with a filter
  * @param[in]     ifp        : Pointer to handle instance of whd interface
  * @param[in]     whd_filter : wl_filter structure buffer from Firmware
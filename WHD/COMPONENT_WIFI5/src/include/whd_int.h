@@ -137,6 +137,9 @@ struct whd_driver
 
     struct whd_ram_shared_info *ram_shared;
     struct whd_msgbuf *msgbuf;
+#ifdef PROTO_MSGBUF
+    struct dma_pool *dma_pool;
+#endif /* PROTO_MSGBUF */
     uint16_t (*read_ptr)(struct whd_driver *whd_driver, uint32_t mem_offset);
     void (*write_ptr)(struct whd_driver *whd_driver, uint32_t mem_offset, uint16_t value);
     cy_semaphore_t host_suspend_mutex;
@@ -86,8 +86,25 @@ extern "C"
 #define WHD_MSGBUF_PKT_FLAGS_FRAME_MASK 0x07
 #define WHD_MSGBUF_PKT_FLAGS_PRIO_SHIFT 5
 
+/* Doorbell policy of the TX flowrings: the first doorbell of a whd_msgbuf_txflow() batch goes
+ * out after CNT1 packets, later ones every CNT2 packets or once a packet has waited DELAY_MS.
+ * The batch end rings for the rest.
+ */
+#ifndef WHD_MSGBUF_TX_FLUSH_CNT1
 #define WHD_MSGBUF_TX_FLUSH_CNT1                32
+#endif
+#ifndef WHD_MSGBUF_TX_FLUSH_CNT2
 #define WHD_MSGBUF_TX_FLUSH_CNT2                96
+#endif
+#ifndef WHD_MSGBUF_TX_FLUSH_DELAY_MS
+#define WHD_MSGBUF_TX_FLUSH_DELAY_MS            2
+#endif
+/* Doorbell policy of the RX post ring: one doorbell per RX buffer refill, unless it posts more
+ * than this many buffers. The control submit ring rings for every message.
+ */
+#ifndef WHD_MSGBUF_RXPOST_FLUSH_CNT
+#define WHD_MSGBUF_RXPOST_FLUSH_CNT             32
+#endif
 
 #define WHD_MSGBUF_DELAY_TXWORKER_THRS  96
 #define WHD_MSGBUF_TRICKLE_TXWORKER_THRS        32
@@ -408,6 +425,7 @@ extern whd_result_t whd_msgbuf_txflow_dequeue(whd_driver_t whd_driver, whd_buffe
 extern whd_result_t whd_msgbuf_txflow_init(whd_msgbuftx_info_t *msgtx_info);
 extern whd_result_t whd_msgbuf_info_init(whd_driver_t whd_driver);
 extern void whd_msgbuf_info_deinit(whd_driver_t whd_driver);
+extern void whd_msgbuf_print_db_stats(struct whd_driver *drvr, whd_bool_t reset_after_print);
 
 #ifdef __cplusplus
 } /* extern "C" */
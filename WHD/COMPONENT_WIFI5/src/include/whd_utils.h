@@ -56,8 +56,9 @@ extern "C" {
 #define ARRAY_SIZE(a)                                 (sizeof(a) / sizeof(a[0]) )
 
 #ifdef PROTO_MSGBUF
-uint32_t whd_dmapool_init(uint32_t memory_size);
-void* whd_dmapool_alloc( int size);
+uint32_t whd_dmapool_init(whd_driver_t whd_driver, uint32_t memory_size);
+void* whd_dmapool_alloc(whd_driver_t whd_driver, int size);
+void whd_dmapool_reset(whd_driver_t whd_driver);
 #endif
 
 /** Searches for a specific WiFi Information Element in a byte array
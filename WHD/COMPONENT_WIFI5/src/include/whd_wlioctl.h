@@ -1213,6 +1213,8 @@ typedef struct eventmsgs_ext
 #define IOVAR_STR_ARP_STATS              "arp_stats"
 #define IOVAR_STR_ARP_STATS_CLEAR        "arp_stats_clear"
 #define IOVAR_STR_TKO                    "tko"
+#define IOVAR_STR_TOE                    "toe"
+#define IOVAR_STR_TOE_OL                 "toe_ol"
 #define IOVAR_STR_ROAM_TIME_THRESH       "roam_time_thresh"
 
 #define IOVAR_WNM_MAXIDLE                "wnm_maxidle"
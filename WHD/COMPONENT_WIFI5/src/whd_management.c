@@ -178,7 +178,7 @@ whd_result_t whd_init(whd_driver_t *whd_driver_ptr, whd_init_config_t *whd_init_
 #ifdef PROTO_MSGBUF
         /* Initialize pool for WLAN M2M DMA to access, WHD has to request pool memory
            and open the access for WLAN through APIs(Secure Call in BTFW)*/
-        whd_dmapool_init(DMA_ALLOC_SIZE);
+        whd_dmapool_init(whd_drv, DMA_ALLOC_SIZE);
 #endif
 
         whd_drv->bus_gspi_32bit = WHD_FALSE;
@@ -233,6 +233,10 @@ whd_result_t whd_deinit(whd_interface_t ifp)
         whd_mem_free(c->buf);
     }
 
+#ifdef PROTO_MSGBUF
+    whd_dmapool_reset(whd_driver);
+#endif
+
     whd_internal_info_deinit(whd_driver);
     whd_bus_common_info_deinit(whd_driver);
     whd_mem_free(whd_driver);
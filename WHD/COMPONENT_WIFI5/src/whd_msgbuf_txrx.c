@@ -46,6 +46,14 @@ static const uint8_t dscp_to_wmm_qos[] =
   7, 7, 7, 7, 7, 7, 7,                                          /* 57 - 63 */
 };
 
+/* Doorbell policy per ring type: control messages are rung at once, RX buffer posts once per
+ * refill and TX packets once per batch, see WHD_MSGBUF_TX_FLUSH_CNT1 */
+static const struct whd_commonring_db_policy control_db_policy = { 1, 1, 0 };
+static const struct whd_commonring_db_policy rxpost_db_policy =
+{ WHD_MSGBUF_RXPOST_FLUSH_CNT, WHD_MSGBUF_RXPOST_FLUSH_CNT, 0 };
+static const struct whd_commonring_db_policy flowring_db_policy =
+{ WHD_MSGBUF_TX_FLUSH_CNT1, WHD_MSGBUF_TX_FLUSH_CNT2, WHD_MSGBUF_TX_FLUSH_DELAY_MS };
+
 static void whd_msgbuf_update_rxbufpost_count(struct whd_msgbuf *msgbuf, uint16_t rxcnt);
 static void whd_msgbuf_rxbuf_ioctlresp_post(struct whd_msgbuf *msgbuf);
 static void whd_msgbuf_set_next_buffer_in_queue(whd_driver_t whd_driver, whd_buffer_t buffer, whd_buffer_t prev_buffer);
@@ -1135,7 +1143,6 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
     void *ret_ptr;
     struct msgbuf_tx_msghdr *tx_msghdr;
     uint32_t address;
-    uint32_t count;
     uint32_t physaddr;
     uint32_t pktid;
     whd_buffer_t skb;
@@ -1151,7 +1158,6 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
 
     //whd_commonring_lock(commonring);	//to be fixed
 
-    count = WHD_MSGBUF_TX_FLUSH_CNT2 - WHD_MSGBUF_TX_FLUSH_CNT1;
     while (whd_flowring_qlen(flow, flowid) )
     {
         result = whd_msgbuf_txflow_dequeue(drvr, &skb, flowid);
@@ -1181,7 +1187,6 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
         }
         WPRINT_WHD_DATA_LOG( ("Wcd:> Sending pkt 0x%08lX\n", (unsigned long)skb) );
         WHD_STATS_INCREMENT_VARIABLE(drvr, tx_total);
-        count++;
 
         tx_msghdr = (struct msgbuf_tx_msghdr *)ret_ptr;
 
@@ -1199,15 +1204,12 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
         tx_msghdr->metadata_buf_len = 0;
         tx_msghdr->metadata_buf_addr.high_addr = 0;
         tx_msghdr->metadata_buf_addr.low_addr = 0;
-        if (count >= WHD_MSGBUF_TX_FLUSH_CNT2)
-        {
-            whd_commonring_write_complete(commonring);
-            count = 0;
-        }
-    }
 
-    if (count)
+        /* The ring's doorbell policy decides whether this packet is published yet */
         whd_commonring_write_complete(commonring);
+    }
+
+    whd_commonring_flush(commonring);
     //whd_commonring_unlock(commonring);	//to be fixed
 
     return WHD_SUCCESS;
@@ -1383,7 +1385,7 @@ whd_msgbuf_flowring_create_worker(struct whd_msgbuf *msgbuf, struct whd_msgbuf_w
     flowid = work->flowid;
     flow_sz = WHD_H2D_TXFLOWRING_MAX_ITEM * WHD_H2D_TXFLOWRING_ITEMSIZE;
 
-    msgbuf->flowring_handle[flowid] = (uint32_t)whd_dmapool_alloc(flow_sz);
+    msgbuf->flowring_handle[flowid] = (uint32_t)whd_dmapool_alloc(msgbuf->drvr, flow_sz);
 
     if (!(msgbuf->flowring_handle[flowid]) )
     {
@@ -1637,6 +1639,7 @@ whd_msgbuf_rxbuf_data_fill(struct whd_msgbuf *msgbuf)
         msgbuf->rxbufpost += retcount;
         fillbufs -= retcount;
     }
+    whd_commonring_flush(msgbuf->commonrings[WHD_H2D_MSGRING_RXPOST_SUBMIT]);
 }
 
 static void whd_msgbuf_update_rxbufpost_count(struct whd_msgbuf *msgbuf, uint16_t rxcnt)
@@ -1854,6 +1857,8 @@ static whd_result_t whd_msgbuf_attach(struct whd_driver *whd_driver)
     /* hook the commonrings in the main msgbuf structure. */
     for (i = 0; i < WHD_NROF_COMMON_MSGRINGS; i++)
         msgbuf->commonrings[i] = &whd_driver->ram_shared->commonrings[i]->commonring;
+    whd_commonring_set_db_policy(msgbuf->commonrings[WHD_H2D_MSGRING_CONTROL_SUBMIT], &control_db_policy);
+    whd_commonring_set_db_policy(msgbuf->commonrings[WHD_H2D_MSGRING_RXPOST_SUBMIT], &rxpost_db_policy);
 
     WPRINT_WHD_DEBUG( ("msgbuf commonring pointer is 0x%lx \n", (uint32_t)msgbuf->commonrings) );
 
@@ -1873,7 +1878,10 @@ static whd_result_t whd_msgbuf_attach(struct whd_driver *whd_driver)
     }
 
     for (i = 0; i < whd_driver->ram_shared->max_flowrings; i++)
+    {
         flowrings[i] = &whd_driver->ram_shared->flowrings[i].commonring;
+        whd_commonring_set_db_policy(flowrings[i], &flowring_db_policy);
+    }
 
     msgbuf->flowrings = flowrings;
     msgbuf->rx_dataoffset = whd_driver->ram_shared->rx_dataoffset;
@@ -2059,4 +2067,43 @@ whd_result_t whd_msgbuf_info_init(whd_driver_t whd_driver)
     return WHD_SUCCESS;
 }
 
+static void whd_msgbuf_print_ring_db_stats(const char *name, const struct whd_commonring_db_stats *stats)
+{
+    uint32_t per_100 = (stats->items != 0) ? (stats->doorbells * 100) / stats->items : 0;
+
+    WPRINT_MACRO( ("%s: items:%" PRIu32 ", doorbells:%" PRIu32 " (%" PRIu32 " per 100 items), threshold:%" PRIu32
+                   ", deadline:%" PRIu32 ", flush:%" PRIu32 "\n",
+                   name, stats->items, stats->doorbells, per_100, stats->threshold_bells, stats->deadline_bells,
+                   stats->flush_bells) );
+}
+
+void whd_msgbuf_print_db_stats(struct whd_driver *drvr, whd_bool_t reset_after_print)
+{
+    struct whd_msgbuf *msgbuf = drvr->msgbuf;
+    struct whd_commonring_db_stats stats;
+    struct whd_commonring_db_stats flowring_stats;
+    uint16_t i;
+
+    if (msgbuf == NULL)
+        return;
+
+    WPRINT_MACRO( ("Doorbell Stats.. \n") );
+    whd_commonring_get_db_stats(msgbuf->commonrings[WHD_H2D_MSGRING_CONTROL_SUBMIT], &stats, reset_after_print);
+    whd_msgbuf_print_ring_db_stats("control", &stats);
+    whd_commonring_get_db_stats(msgbuf->commonrings[WHD_H2D_MSGRING_RXPOST_SUBMIT], &stats, reset_after_print);
+    whd_msgbuf_print_ring_db_stats("rxpost", &stats);
+
+    memset(&flowring_stats, 0, sizeof(flowring_stats) );
+    for (i = 0; i < msgbuf->max_flowrings; i++)
+    {
+        whd_commonring_get_db_stats(msgbuf->flowrings[i], &stats, reset_after_print);
+        flowring_stats.items += stats.items;
+        flowring_stats.doorbells += stats.doorbells;
+        flowring_stats.threshold_bells += stats.threshold_bells;
+        flowring_stats.deadline_bells += stats.deadline_bells;
+        flowring_stats.flush_bells += stats.flush_bells;
+    }
+    whd_msgbuf_print_ring_db_stats("flowrings", &flowring_stats);
+}
+
 #endif /* PROTO_MSGBUF */
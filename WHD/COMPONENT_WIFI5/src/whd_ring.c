@@ -290,7 +290,7 @@ static struct whd_ringbuf *whd_allocate_ring_and_handle(whd_driver_t whd_driver,
     size = whd_ring_max_item[ring_id] * ring_itemsize_array[ring_id];
 
     WPRINT_WHD_DEBUG( ("Allocate Ring Handle: %s\n", __func__) );
-    ring_handle = whd_dmapool_alloc(size);
+    ring_handle = whd_dmapool_alloc(whd_driver, size);
 
     if(ring_handle == NULL)
         return NULL;
@@ -38,44 +38,92 @@
 #define WPA_OUI_TYPE1                     "\x00\x50\xF2\x01"   /** WPA OUI */
 
 #ifdef PROTO_MSGBUF
+/* Pool memory is permanent and cannot be given back, so pools released by whd_deinit() stay on
+ * this list and are handed to the next driver that needs one of at least their size. The list and
+ * the owner fields are shared by every driver, so they are only read and changed with the
+ * scheduler suspended; pool memory is allocated and opened outside that section. */
 typedef struct dma_pool
 {
+    struct dma_pool *next;
+    whd_driver_t owner;     /* NULL while the pool is free for another driver */
     int offset;
     int poolsize;
     uint8_t big_buffer[0];
 }dma_pool;
 
-dma_pool *pool_mem;
+static dma_pool *dma_pool_list;
 
-uint32_t whd_dmapool_init(uint32_t memory_size)
+uint32_t whd_dmapool_init(whd_driver_t whd_driver, uint32_t memory_size)
 {
-    WPRINT_WHD_DEBUG(("WHD allocating %lu bytes for DMA pool\n", memory_size));
-    pool_mem = (dma_pool*)whd_hw_allocatePermanentApi(memory_size);
+    dma_pool *pool;
 
-    if (pool_mem == NULL)
-      return -1;
+    if (whd_driver->dma_pool != NULL)
+        return 0;
 
-    pool_mem->offset = 0;
-    pool_mem->poolsize = memory_size - (sizeof(dma_pool));
+    cy_rtos_scheduler_suspend();
+    for (pool = dma_pool_list; pool != NULL; pool = pool->next)
+    {
+        if ((pool->owner == NULL) && (pool->poolsize >= (int)(memory_size - sizeof(dma_pool))))
+            break;
+    }
+    if (pool != NULL)
+        pool->owner = whd_driver;
+    cy_rtos_scheduler_resume();
+
+    if (pool == NULL)
+    {
+        WPRINT_WHD_DEBUG(("WHD allocating %lu bytes for DMA pool\n", memory_size));
+        pool = (dma_pool*)whd_hw_allocatePermanentApi(memory_size);
+
+        if (pool == NULL)
+          return -1;
 
-    if (!whd_hw_openDeviceAccessApi(WHD_HW_DEVICE_WLAN, pool_mem->big_buffer, pool_mem->poolsize, 0 ))
-       return -1;
+        pool->poolsize = memory_size - (sizeof(dma_pool));
+
+        if (!whd_hw_openDeviceAccessApi(WHD_HW_DEVICE_WLAN, pool->big_buffer, pool->poolsize, 0 ))
+           return -1;
+
+        pool->owner = whd_driver;
+        cy_rtos_scheduler_suspend();
+        pool->next = dma_pool_list;
+        dma_pool_list = pool;
+        cy_rtos_scheduler_resume();
+    }
+
+    pool->offset = 0;
+    whd_driver->dma_pool = pool;
 
     return 0;
 }
 
-void* whd_dmapool_alloc( int size)
+void* whd_dmapool_alloc(whd_driver_t whd_driver, int size)
 {
+    dma_pool *pool = whd_driver->dma_pool;
     uint8_t* allocbuf;
 
-    if ((pool_mem->offset + size) >= pool_mem->poolsize)
+    if ((pool == NULL) || ((pool->offset + size) >= pool->poolsize))
      return NULL;
 
-    allocbuf = pool_mem->big_buffer + pool_mem->offset;
-    pool_mem->offset += size;
+    allocbuf = pool->big_buffer + pool->offset;
+    pool->offset += size;
 
     return allocbuf;
 }
+
+void whd_dmapool_reset(whd_driver_t whd_driver)
+{
+    dma_pool *pool = whd_driver->dma_pool;
+
+    if (pool == NULL)
+        return;
+
+    /* Free is not available; rewind the pool and leave it for the next driver */
+    pool->offset = 0;
+    cy_rtos_scheduler_suspend();
+    pool->owner = NULL;
+    cy_rtos_scheduler_resume();
+    whd_driver->dma_pool = NULL;
+}
 #endif
 
 /******************************************************
@@ -5347,6 +5347,13 @@ whd_wifi_clear_packet_filter_stats(whd_interface_t ifp, uint32_t filter_id)
     RETURN_WITH_ASSERT(whd_wifi_set_iovar_value(ifp, IOVAR_STR_PKT_FILTER_CLEAR_STATS, (uint32_t)filter_id) );
 }
 
+whd_result_t
+whd_pf_set_packet_filter_mode(whd_interface_t ifp, whd_packet_filter_mode_t mode)
+{
+    CHECK_IFP_NULL(ifp);
+    RETURN_WITH_ASSERT(whd_wifi_set_iovar_value(ifp, IOVAR_STR_PKT_FILTER_MODE, (uint32_t)mode) );
+}
+
 whd_result_t
 whd_pf_get_packet_filter_mask_and_pattern(whd_interface_t ifp, uint8_t filter_id, uint32_t max_size, uint8_t *mask,
                                           uint8_t *pattern, uint32_t *size_out)
@@ -5629,16 +5636,21 @@ whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *wh
         return result;
     }
     tko = (wl_tko_t *)whd_buffer_get_current_piece_data_pointer(whd_driver, response);
+    if (tko == NULL)
+    {
+        CHECK_RETURN(whd_buffer_release(whd_driver, response, WHD_NETWORK_TX) );
+        return WHD_BUFFER_ALLOC_FAIL;
+    }
     tko->subcmd_id = dtoh16(tko->subcmd_id);
     tko->len = dtoh16(tko->len);
 
     if (tko->subcmd_id  != WL_TKO_SUBCMD_CONNECT)
     {
         WPRINT_WHD_ERROR( ("%s: IOVAR returned garbage!\n", __func__) );
-        return WHD_BADARG;
+        result = WHD_BADARG;
     }
     connect = (wl_tko_connect_t *)tko->data;
-    if (tko->len >= sizeof(*connect) )
+    if ( (result == WHD_SUCCESS) && (tko->len >= sizeof(*connect) ) )
     {
         connect->local_port = dtoh16(connect->local_port);
         connect->remote_port = dtoh16(connect->remote_port);
@@ -5647,9 +5659,9 @@ whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *wh
         if (connect->ip_addr_type != 0)
         {
             WPRINT_WHD_ERROR( ("%s: Address type not IPV4\n", __func__) );
-            return WHD_BADARG;
+            result = WHD_BADARG;
         }
-        if (connect->ip_addr_type == 0)
+        else
         {
             /* IPv4 */
             uint16_t mylen;
@@ -5657,18 +5669,85 @@ whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *wh
             if (buflen < mylen)
             {
                 WPRINT_WHD_ERROR( ("%s: Buf len (%d) too small , need %d\n", __func__, buflen, mylen) );
-                return WHD_BADARG;
+                result = WHD_BADARG;
+            }
+            else
+            {
+                /*
+                 * Assumes whd_tko_connect_t and wl_tko_connect_t are the same.
+                 * If/when they become different (due to different FW versions, etc) than
+                 * this may have to be copied field by field instead.
+                 */
+                memcpy(whd_connect, connect, MIN_OF(mylen, buflen) );
             }
-
-            /*
-             * Assumes whd_tko_connect_t and wl_tko_connect_t are the same.
-             * If/when they become different (due to different FW versions, etc) than
-             * this may have to be copied field by field instead.
-             */
-            memcpy(whd_connect, connect, MIN_OF(mylen, buflen) );
         }
     }
-    return WHD_SUCCESS;
+    CHECK_RETURN(whd_buffer_release(whd_driver, response, WHD_NETWORK_TX) );
+    return result;
+}
+
+/* Exercise SET of wl_tko_connect_t IOVAR */
+/* Program one TCP connection into the index given in whd_connect */
+whd_result_t
+whd_tko_set_FW_connect(whd_interface_t ifp, const whd_tko_connect_t *whd_connect, uint16_t buflen)
+{
+    uint32_t len = 0;
+    uint16_t connect_len;
+    uint8_t *data = NULL;
+    wl_tko_t *tko = NULL;
+    wl_tko_connect_t *connect = NULL;
+    whd_buffer_t buffer;
+    whd_driver_t whd_driver;
+    whd_result_t result;
+    CHECK_IFP_NULL(ifp);
+
+    whd_driver = ifp->whd_driver;
+    CHECK_DRIVER_NULL(whd_driver);
+
+    if (whd_connect == NULL)
+    {
+        return WHD_BADARG;
+    }
+    connect_len = (uint16_t)(offsetof(wl_tko_connect_t, data) +
+                             (whd_connect->ip_addr_type == 0 ? 2 * IPV4_ADDR_LEN : 2 * IPV6_ADDR_LEN) +
+                             whd_connect->request_len + whd_connect->response_len);
+    if ( (buflen < connect_len) ||
+         (TKO_DATA_OFFSET + connect_len > WHD_PAYLOAD_MTU - strlen(IOVAR_STR_TKO) - 1) )
+    {
+        WPRINT_WHD_ERROR( ("%s: Bad connect length %d, buffer %d\n", __func__, connect_len, buflen) );
+        return WHD_BADARG;
+    }
+
+    len = (uint32_t)(TKO_DATA_OFFSET + connect_len);
+    data = (uint8_t * )whd_proto_get_iovar_buffer(whd_driver, &buffer, (uint16_t)len, IOVAR_STR_TKO);
+    CHECK_IOCTL_BUFFER(data);
+
+    tko = (wl_tko_t *)data;
+
+    tko->subcmd_id = WL_TKO_SUBCMD_CONNECT;
+    tko->len = TKO_DATA_OFFSET;
+
+    connect = (wl_tko_connect_t *)tko->data;
+    whd_mem_memcpy(connect, whd_connect, connect_len);
+    connect->local_port = htod16(connect->local_port);
+    connect->remote_port = htod16(connect->remote_port);
+    connect->local_seq = htod32(connect->local_seq);
+    connect->remote_seq = htod32(connect->remote_seq);
+    connect->request_len = htod16(connect->request_len);
+    connect->response_len = htod16(connect->response_len);
+
+    tko->len += connect_len;
+
+    tko->subcmd_id = htod16(tko->subcmd_id);
+    tko->len = htod16(tko->len);
+
+    /* invoke SET iovar */
+    result = whd_proto_set_iovar(ifp, buffer, NULL);
+    if (result != WHD_SUCCESS)
+    {
+        WPRINT_WHD_ERROR( ("%s: tko connect %d FAILED\n", __func__, whd_connect->index) );
+    }
+    return result;
 }
 
 whd_result_t
@@ -5716,6 +5795,49 @@ whd_tko_toggle(whd_interface_t ifp, whd_bool_t enable)
     return result;
 }
 
+whd_result_t
+whd_toe_set(whd_interface_t ifp, uint32_t ol_flags)
+{
+    whd_result_t result;
+    CHECK_IFP_NULL(ifp);
+
+    if (ol_flags != 0)
+    {
+        result = whd_wifi_set_iovar_value(ifp, IOVAR_STR_TOE_OL, ol_flags);
+        if (result != WHD_SUCCESS)
+        {
+            WPRINT_WHD_INFO( ("%s: toe_ol 0x%" PRIx32 " not supported\n", __func__, ol_flags) );
+            return result;
+        }
+    }
+    result = whd_wifi_set_iovar_value(ifp, IOVAR_STR_TOE, (ol_flags != 0) ? 1 : 0);
+    if (result != WHD_SUCCESS)
+    {
+        WPRINT_WHD_INFO( ("%s: toe %s FAILED\n", __func__, (ol_flags != 0) ? "enable" : "disable") );
+    }
+    return result;
+}
+
+whd_result_t
+whd_toe_get(whd_interface_t ifp, uint32_t *ol_flags)
+{
+    uint32_t enabled = 0;
+    whd_result_t result;
+    CHECK_IFP_NULL(ifp);
+
+    if (ol_flags == NULL)
+    {
+        return WHD_BADARG;
+    }
+    *ol_flags = 0;
+    result = whd_wifi_get_iovar_value(ifp, IOVAR_STR_TOE, &enabled);
+    if ( (result != WHD_SUCCESS) || (enabled == 0) )
+    {
+        return result;
+    }
+    return whd_wifi_get_iovar_value(ifp, IOVAR_STR_TOE_OL, ol_flags);
+}
+
 static whd_result_t
 whd_tko_autoenab(whd_interface_t ifp, whd_bool_t enable)
 {
@@ -71,6 +71,17 @@ typedef struct whd_bus_funcs whd_sdio_funcs_t;
  */
 typedef struct whd_bus_funcs whd_spi_funcs_t;
 
+#ifdef WHD_MEM_ARENA
+/**
+ * One size class of the memory arena: num_blocks blocks of block_size bytes each
+ */
+typedef struct whd_mem_arena_class
+{
+    uint32_t block_size; /**< Largest allocation served by this class, in bytes */
+    uint32_t num_blocks; /**< Number of blocks carved for this class */
+} whd_mem_arena_class_t;
+#endif /* WHD_MEM_ARENA */
+
 /**
  * Structure for storing WHD init configurations
  */
@@ -80,6 +91,15 @@ typedef struct whd_init_config
     uint32_t thread_stack_size; /**< Size of the WHD thread stack  */
     uint32_t thread_priority;   /**< Priority to be set to WHD Thread */
     whd_country_code_t country; /**< Variable to strore country code information */
+#ifdef WHD_MEM_ARENA
+    void *mem_arena;            /**< Memory all driver allocations are carved from. Only one driver
+                                     can use the arena at a time; whd_init() of another fails with
+                                     WHD_UNSUPPORTED until the first has been deinitialised */
+    uint32_t mem_arena_size;    /**< Size of mem_arena in bytes */
+    const whd_mem_arena_class_t *mem_arena_classes; /**< Size classes in increasing block size,
+                                                         NULL for the default classes */
+    uint32_t mem_arena_num_classes; /**< Number of entries in mem_arena_classes */
+#endif /* WHD_MEM_ARENA */
 } whd_init_config_t;
 
 #ifdef __cplusplus
@@ -196,6 +196,11 @@ struct whd_buffer_funcs
  *  @{
  */
 
+/** rx_flags of whd_network_process_ethernet_data_ext(): the device checked the frame's IP and TCP/UDP
+ *  checksums and found them good. Without it nothing is known and the stack checks them itself.
+ */
+#define WHD_NETWORK_RX_CSUM_GOOD (0x0001)
+
 /**
  * Contains functions which allows WHD to pass received data to the network stack, to send an ethernet frame to WHD, etc
  */
@@ -229,6 +234,46 @@ struct whd_netif_funcs
      *
      */
     void (*whd_network_process_ethernet_data)(whd_interface_t ifp, whd_buffer_t buffer);
+
+    /** Optional; called by WHD to stop or resume transmission on one interface
+     *
+     *  WHD queues the packets of each interface separately. When one of an interface's queues
+     *  fills, WHD asks the network stack to stop calling whd_network_send_ethernet_data() for that
+     *  interface, and to resume once its queues have drained. Other interfaces are not affected.
+     *
+     *  It is called from the context of whatever thread filled or drained the queue and must not block.
+     *  The same state may be reported more than once; the last call gives the current state.
+     *
+     *  @param interface  The interface concerned.
+     *  @param stop       WHD_TRUE to stop sending, WHD_FALSE to resume.
+     *
+     */
+    void (*whd_network_tx_flow_control)(whd_interface_t ifp, whd_bool_t stop);
+
+    /** Optional; called by WHD instead of whd_network_process_ethernet_data() when provided
+     *
+     *  Same as whd_network_process_ethernet_data(), with what the device reported about the packet.
+     *
+     *  @param interface  The interface on which the packet was received.
+     *  @param buffer     Handle of the packet which has just been received. Responsibility for
+     *                    releasing this buffer is transferred from WHD at this point.
+     *  @param rx_flags   WHD_NETWORK_RX_* flags.
+     *
+     */
+    void (*whd_network_process_ethernet_data_ext)(whd_interface_t ifp, whd_buffer_t buffer, uint32_t rx_flags);
+
+    /** Optional; called by WHD for every interface after each round of packets it received
+     *
+     *  The WHD thread receives packets in rounds of a bounded number. A network stack
+     *  that holds received packets back, for instance to merge TCP segments, must pass them
+     *  on here at the latest.
+     *
+     *  It is called in the context of the WHD thread.
+     *
+     *  @param interface  The interface concerned.
+     *
+     */
+    void (*whd_network_rx_round_end)(whd_interface_t ifp);
 };
 
 /** To send an ethernet frame to WHD (called by the Network Stack)
@@ -887,6 +887,41 @@ typedef struct whd_scan_result
 } whd_scan_result_t;
 #pragma pack()
 
+#define WHD_SCAN_OPCLASS_BITMAP_LEN    (32)  /**< Bytes needed for a bitmap of all 256 operating classes */
+
+/**
+ * Compact scan result, as reported by whd_wifi_scan_compact()
+ *
+ * The record is variable length. data[] holds ssid_length bytes of SSID followed by
+ * opclass_bitmap_len bytes of a bitmap of the supported operating classes, in which bit (n % 8)
+ * of byte (n / 8) is set if operating class n is supported. Trailing zero bytes of the bitmap
+ * are left out. record_length covers the whole record, so it can be kept by copying
+ * record_length bytes.
+ */
+#pragma pack(1)
+typedef struct whd_scan_compact_result
+{
+    uint16_t record_length;             /**< Length of the whole record in bytes, including data[]                     */
+    whd_mac_t BSSID;                    /**< Basic Service Set Identification (i.e. MAC address of Access Point)       */
+    int16_t signal_strength;            /**< Receive Signal Strength Indication in dBm. <-90=Very poor, >-30=Excellent */
+    uint32_t max_data_rate;             /**< Maximum data rate in kilobits/s                                           */
+    whd_security_t security;            /**< Security type                                                             */
+    uint8_t bss_type;                   /**< Network type, a whd_bss_type_t                                            */
+    uint8_t channel;                    /**< Radio channel that the AP beacon was received on                          */
+    uint8_t band;                       /**< Radio band, a whd_802_11_band_t                                           */
+    uint8_t ccode[2];                   /**< Two letter ISO country code from AP                                       */
+    uint8_t flags;                      /**< whd_scan_result_flag_t flags                                              */
+    uint8_t current_operating_class;    /**< Current operating class (Information Element)                             */
+    uint8_t ssid_length;                /**< Length of the SSID at the start of data[]                                 */
+    uint8_t opclass_bitmap_len;         /**< Length of the operating class bitmap following the SSID                   */
+    uint8_t data[1];                    /**< SSID, then operating class bitmap                                         */
+} whd_scan_compact_result_t;
+#pragma pack()
+
+/** Largest possible whd_scan_compact_result_t, e.g. for a buffer that has to hold any record */
+#define WHD_SCAN_COMPACT_RESULT_MAX_LEN \
+    (sizeof(whd_scan_compact_result_t) - 1 + SSID_NAME_SIZE + WHD_SCAN_OPCLASS_BITMAP_LEN)
+
 /**
  * Structure to store scan result parameters for each AP
  */
@@ -1405,6 +1440,15 @@ typedef enum
     WHD_PACKET_FILTER_RULE_NEGATIVE_MATCHING  = 1  /**< Specifies that a filter should NOT match a given pattern */
 } whd_packet_filter_rule_t;
 
+/**
+ * Enumeration of packet filter modes
+ */
+typedef enum
+{
+    WHD_PACKET_FILTER_MODE_DISCARD_ON_MATCH  = 0, /**< Packets matching an enabled filter are discarded, all others are forwarded */
+    WHD_PACKET_FILTER_MODE_FORWARD_ON_MATCH  = 1  /**< Packets matching an enabled filter are forwarded, all others are discarded */
+} whd_packet_filter_mode_t;
+
 /**
  * Structure describing a packet filter list item
  */
@@ -298,6 +298,63 @@ extern whd_result_t whd_wifi_scan(whd_interface_t ifp,
                               whd_scan_result_t *result_ptr,
                               void *user_data);
 
+/** Compact scan result callback function pointer type
+ *
+ * @param result       The result, NULL once the scan has completed or been aborted. Only valid during the call;
+ *                     copy result->record_length bytes to keep it.
+ * @param ie_ptr       The Information Elements of the Beacon/Probe Response, NULL when result is NULL.
+ *                     Only valid during the call.
+ * @param ie_len       Length of the Information Elements
+ * @param user_data    User provided data
+ * @param status       Status of scan process
+ */
+typedef void (*whd_scan_compact_result_callback_t)(const whd_scan_compact_result_t *result, const uint8_t *ie_ptr,
+                                                   uint32_t ie_len, void *user_data, whd_scan_status_t status);
+
+/** Initiates a scan to search for 802.11 networks, reporting compact results.
+ *
+ *  Behaves as whd_wifi_scan(), but each BSS is reported as a variable length whd_scan_compact_result_t
+ *  built on the stack of the WHD thread, with the operating classes as a bitmap and the Information
+ *  Elements passed by reference only. The application keeps what it needs, which makes it possible
+ *  to collect hundreds of BSSs on parts with little RAM.
+ *
+ *  @param   ifp                       Pointer to handle instance of whd interface
+ *  @param   scan_type                 As for whd_wifi_scan()
+ *  @param   bss_type                  As for whd_wifi_scan()
+ *  @param   optional_ssid             As for whd_wifi_scan()
+ *  @param   optional_mac              As for whd_wifi_scan()
+ *  @param   optional_channel_list     As for whd_wifi_scan()
+ *  @param   optional_extended_params  As for whd_wifi_scan()
+ *  @param   callback                  The callback function which will receive each result.
+ *  @param   user_data                 user specific data that will be passed directly to the callback function
+ *
+ *  @note - The callback is called from the context of the WHD thread, with the same restrictions as for
+ *          whd_wifi_scan().
+ *        - The callback is always called a last time with a NULL result. A compact scan cannot be
+ *          restarted before that; WHD_PENDING is returned.
+ *
+ *  @return WHD_SUCCESS or Error code
+ */
+extern whd_result_t whd_wifi_scan_compact(whd_interface_t ifp,
+                                          whd_scan_type_t scan_type,
+                                          whd_bss_type_t bss_type,
+                                          const whd_ssid_t *optional_ssid,
+                                          const whd_mac_t *optional_mac,
+                                          const uint16_t *optional_channel_list,
+                                          const whd_scan_extended_params_t *optional_extended_params,
+                                          whd_scan_compact_result_callback_t callback,
+                                          void *user_data);
+
+/** Checks whether a compact scan result lists an operating class as supported
+ *
+ *  @param   result                    Compact scan result
+ *  @param   operating_class           Operating class to look for
+ *
+ *  @return WHD_TRUE if the BSS supports the operating class
+ */
+extern whd_bool_t whd_scan_compact_result_has_opclass(const whd_scan_compact_result_t *result,
+                                                      uint8_t operating_class);
+
 /** Abort a previously issued scan
  *
  *  @param   ifp           Pointer to handle instance of whd interface
@@ -1395,6 +1452,13 @@ whd_result_t whd_pf_get_packet_filter_mask_and_pattern(whd_interface_t ifp, uint
  */
 whd_result_t whd_wifi_clear_packet_filter_stats(whd_interface_t ifp, uint32_t filter_id);
 
+/** Choose whether the enabled filters select the packets to forward or to discard
+ * @param[in]    ifp        : pointer to handle instance of whd interface
+ * @param[in]    mode       : @ref whd_packet_filter_mode_t, applies to all filters
+ * @return whd_result_t
+ */
+whd_result_t whd_pf_set_packet_filter_mode(whd_interface_t ifp, whd_packet_filter_mode_t mode);
+
 /** Return the stats associated with a filter
  * @param[in]    ifp        : pointer to handle instance of whd interface
  * @param[in]    filter_id  : which filter
@@ -1435,6 +1499,18 @@ whd_result_t whd_tko_max_assoc(whd_interface_t ifp, uint8_t *max);
 whd_result_t whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *whd_connect,
                                     uint16_t buflen);
 
+/** Program a TCP connection for keepalive offload
+ *
+ *  The connection takes effect the next time the offload is enabled with whd_tko_toggle().
+ *
+ * @param[in]    ifp          : Pointer to handle instance of whd interface
+ * @param[in]    whd_connect  : tko_connect structure with the index, sequence numbers, addresses
+ *                              and the keepalive request and response packets
+ * @param[in]    buflen       : Size of the whd_connect buffer
+ * @return whd_result_t
+ */
+whd_result_t whd_tko_set_FW_connect(whd_interface_t ifp, const whd_tko_connect_t *whd_connect, uint16_t buflen);
+
 /** Return the stats associated with a filter
  * @param[in]    ifp        : Pointer to handle instance of whd interface
  * @param[in]    enable     : Enable/Disable TCP Keepalive offload
@@ -1442,6 +1518,24 @@ whd_result_t whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_
  */
 whd_result_t whd_tko_toggle(whd_interface_t ifp, whd_bool_t enable);
 
+/** Enables the firmware TCP/IP checksum offload engine
+ *
+ *  Selects the offloaded checksums with toe_ol and turns the engine on with toe, or turns it
+ *  off if ol_flags is 0. Firmware built without the engine fails the iovars.
+ *
+ * @param[in]    ifp        : Pointer to handle instance of whd interface
+ * @param[in]    ol_flags   : TOE_TX_CSUM_OL and TOE_RX_CSUM_OL bits
+ * @return whd_result_t
+ */
+whd_result_t whd_toe_set(whd_interface_t ifp, uint32_t ol_flags);
+
+/** Reads the checksums the firmware offload engine computes
+ * @param[in]    ifp        : Pointer to handle instance of whd interface
+ * @param[out]   ol_flags   : TOE_TX_CSUM_OL and TOE_RX_CSUM_OL bits, 0 if the engine is off
+ * @return whd_result_t
+ */
+whd_result_t whd_toe_get(whd_interface_t ifp, uint32_t *ol_flags);
+
 
 /* @} */
 
@@ -26,29 +26,25 @@
 #include "whd_types_int.h"
 
 
-/******************************************************
-*             Static variables
-******************************************************/
-static whd_bool_t IsWlansenseStart = WHD_FALSE;
-
-
 /******************************************************
 *             Function definitions
 ******************************************************/
+static whd_bool_t
+whd_wlansense_capture_started(whd_driver_t whd_driver)
+{
+    return ( (whd_driver != NULL) && (whd_driver->wlansense != NULL) ) ?
+           whd_driver->wlansense->capture_started : WHD_FALSE;
+}
+
 whd_result_t
-whd_wlansense_register_callback(void* user_data, whd_csi_data_sendup csi_data_cb_func, whd_csi_cfg_t *csi_cfg)
+whd_wlansense_register_callback(whd_driver_t whd_driver, void* user_data, whd_csi_data_sendup csi_data_cb_func,
+                                whd_csi_cfg_t *csi_cfg)
 {
-    whd_interface_t csi_ifp = whd_wlansense_get_interface();
+    whd_interface_t csi_ifp = whd_wlansense_get_interface(whd_driver);
     CHECK_IFP_NULL(csi_ifp);
 
     whd_csi_info_t csi_info;
 
-    if (!csi_data_cb_func)
-    {
-        WPRINT_WHD_ERROR(("The wlansense callback function is not provided!\n"));
-        return WHD_BADARG;
-    }
-
     if (!csi_cfg)
     {
         WPRINT_WHD_ERROR(("The wlansense CSI_Cfg Struct is not provided!\n"));
@@ -58,9 +54,9 @@ whd_wlansense_register_callback(void* user_data, whd_csi_data_sendup csi_data_cb
     /* Check if the handler isn't registered, then register it. */
     if (csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY] == WHD_EVENT_NOT_REGISTERED)
     {
-        CHECK_RETURN (whd_wlansense_register_handler(user_data));
+        CHECK_RETURN (whd_wlansense_register_handler(whd_driver, user_data));
     }
-    csi_info = whd_mem_malloc(sizeof(*csi_info));
+    csi_info = whd_mem_calloc(1, sizeof(*csi_info));
 
     /* Allocating memory for whd_csi_info structure pointer */
     if (!csi_info) {
@@ -77,18 +73,16 @@ whd_wlansense_register_callback(void* user_data, whd_csi_data_sendup csi_data_cb
 }
 
 whd_result_t
-whd_wlansense_start_capture(whd_csi_cfg_t *csi_cfg)
+whd_wlansense_start_capture(whd_driver_t whd_driver, whd_csi_cfg_t *csi_cfg)
 {
-    if (IsWlansenseStart)
+    if (whd_wlansense_capture_started(whd_driver) )
     {
         WPRINT_WHD_ERROR(("The wlansense capture already started!\n"));
         return WHD_SUCCESS;
     }
 
-    whd_interface_t csi_ifp = whd_wlansense_get_interface();
+    whd_interface_t csi_ifp = whd_wlansense_get_interface(whd_driver);
     CHECK_IFP_NULL(csi_ifp);
-    whd_driver_t whd_driver = csi_ifp->whd_driver;
-    CHECK_DRIVER_NULL(whd_driver);
     whd_interface_t prim_ifp = whd_get_primary_interface(whd_driver);
     CHECK_IFP_NULL(prim_ifp);
 
@@ -114,23 +108,21 @@ whd_wlansense_start_capture(whd_csi_cfg_t *csi_cfg)
     CHECK_IOCTL_BUFFER (csi_iovar);
     whd_mem_memcpy(csi_iovar, (uint32_t *)csi_cfg, sizeof(wlc_csi_cfg_t) );
     result = whd_proto_set_iovar(prim_ifp, buffer, 0);
-    IsWlansenseStart = WHD_TRUE;
+    whd_driver->wlansense->capture_started = WHD_TRUE;
     return result;
 }
 
 whd_result_t
-whd_wlansense_stop_capture(void)
+whd_wlansense_stop_capture(whd_driver_t whd_driver)
 {
-    if (!IsWlansenseStart)
+    if (!whd_wlansense_capture_started(whd_driver) )
     {
         WPRINT_WHD_ERROR(("The wlansense capture already stopped!\n"));
         return WHD_SUCCESS;
     }
 
-    whd_interface_t csi_ifp = whd_wlansense_get_interface();
+    whd_interface_t csi_ifp = whd_wlansense_get_interface(whd_driver);
     CHECK_IFP_NULL(csi_ifp);
-    whd_driver_t whd_driver = csi_ifp->whd_driver;
-    CHECK_DRIVER_NULL(whd_driver);
     whd_interface_t prim_ifp = whd_get_primary_interface(whd_driver);
     CHECK_IFP_NULL(prim_ifp);
 
@@ -156,13 +148,57 @@ whd_wlansense_stop_capture(void)
     CHECK_IOCTL_BUFFER (csi_iovar);
     whd_mem_memcpy(csi_iovar, (uint32_t *)&csi_cfg_params, sizeof(wlc_csi_cfg_t) );
     result = whd_proto_set_iovar(prim_ifp, buffer, 0);
-    IsWlansenseStart = WHD_FALSE;
+    whd_driver->wlansense->capture_started = WHD_FALSE;
     return result;
 }
 
-whd_result_t whd_wlansense_get_info(whd_csi_cfg_t *csi_cfg)
+whd_result_t whd_wlansense_get_info(whd_driver_t whd_driver, whd_csi_cfg_t *csi_cfg)
+{
+    return whd_wlansense_get_config(whd_driver, csi_cfg);
+}
+
+whd_result_t whd_wlansense_get_stats(whd_driver_t whd_driver, whd_csi_reasm_stats_t *stats)
+{
+    return whd_wlansense_get_reasm_stats(whd_driver, stats);
+}
+
+whd_result_t
+whd_wlansense_set_ring(whd_driver_t whd_driver, uint8_t *buf, uint32_t slot_size, uint32_t num_slots,
+                       whd_csi_report_notify notify, void *user_data)
+{
+    if (whd_wlansense_capture_started(whd_driver) )
+    {
+        WPRINT_WHD_ERROR(("The wlansense ring cannot be changed while the capture runs!\n"));
+        return WHD_BADARG;
+    }
+    return whd_wlansense_ring_attach(whd_driver, buf, slot_size, num_slots, notify, user_data);
+}
+
+whd_result_t whd_wlansense_acquire_report(whd_driver_t whd_driver, whd_csi_report_t *report)
+{
+    return whd_wlansense_ring_acquire(whd_driver, report);
+}
+
+whd_result_t whd_wlansense_release_report(whd_driver_t whd_driver, const whd_csi_report_t *report)
+{
+    return whd_wlansense_ring_release(whd_driver, report);
+}
+
+whd_result_t
+whd_wlansense_set_features(whd_driver_t whd_driver, const whd_csi_features_config_t *config,
+                           whd_csi_features_cb features_cb, void *user_data)
+{
+    if (whd_wlansense_capture_started(whd_driver) )
+    {
+        WPRINT_WHD_ERROR(("The wlansense features cannot be changed while the capture runs!\n"));
+        return WHD_BADARG;
+    }
+    return whd_wlansense_features_attach(whd_driver, config, features_cb, user_data);
+}
+
+whd_result_t whd_wlansense_get_feature_stats(whd_driver_t whd_driver, whd_csi_features_stats_t *stats)
 {
-    return whd_wlansense_get_config(csi_cfg);
+    return whd_wlansense_features_get_stats(whd_driver, stats);
 }
 
 #endif /* defined(COMPONENT_WLANSENSE) */
@@ -68,35 +68,114 @@ typedef struct wlc_csi_cfg whd_csi_cfg_t;
 
 /** Called before user starts CSI capture. Registers the callback function to sendup CSI data
  *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
  * @param user_data:            A pointer value which will be passed to the event handler function (NULL is allowed).
- * @param csi_data_cb_func:     Pointer to callback function that should be used to sendup CSI data
+ * @param csi_data_cb_func:     Pointer to callback function that should be used to sendup CSI data. May be NULL when
+ *                              the reports are taken from a ring set with whd_wlansense_set_ring().
  * @param csi_cfg:              Pointer to the CSI_Cfg struct provided by user to get the default parameters from WHD
  *
  * @return whd_result_t:        WHD_SUCCESS or Error code.
  */
-extern whd_result_t whd_wlansense_register_callback(void* user_data, whd_csi_data_sendup csi_data_cb_func, whd_csi_cfg_t *csi_cfg);
+extern whd_result_t whd_wlansense_register_callback(whd_driver_t whd_driver, void* user_data,
+                                                    whd_csi_data_sendup csi_data_cb_func, whd_csi_cfg_t *csi_cfg);
 
 /** Called when user enters csi,enable cmd. Registers the event handler
  *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
  * @param csi_cfg:              Pointer to the CSI_Cfg struct which will be sent to FW
  *
  * @return whd_result_t:        WHD_SUCCESS or Error code.
  */
-extern whd_result_t whd_wlansense_start_capture(whd_csi_cfg_t *csi_cfg);
+extern whd_result_t whd_wlansense_start_capture(whd_driver_t whd_driver, whd_csi_cfg_t *csi_cfg);
 
 /** Called when user enters csi,disable cmd. Deregisters the event handler
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
  *
  * @return whd_result_t:        WHD_SUCCESS or Error code.
  */
-extern whd_result_t whd_wlansense_stop_capture(void);
+extern whd_result_t whd_wlansense_stop_capture(whd_driver_t whd_driver);
 
 /** Dumps the wlc_csi_cfg_t struct from FW.
  *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
  * @param csi_cfg:              Pointer to the CSI_Cfg struct provided by user to get the current parameters from WHD
  *
  * @return whd_result_t:        WHD_SUCCESS or Error code.
  */
-extern whd_result_t whd_wlansense_get_info(whd_csi_cfg_t *csi_cfg);
+extern whd_result_t whd_wlansense_get_info(whd_driver_t whd_driver, whd_csi_cfg_t *csi_cfg);
+
+/** Gets the CSI fragment reassembly counters: reports sent up and reports dropped for lost,
+ *  duplicate or inconsistent fragments.
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
+ * @param stats:                Pointer to the counters provided by user
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_get_stats(whd_driver_t whd_driver, whd_csi_reasm_stats_t *stats);
+
+/** Has CSI reports written straight into a ring of application memory instead of being sent up
+ *  through the callback. Call before whd_wlansense_start_capture().
+ *
+ *  The WHD thread never waits for the consumer: a report that finds every slot in use is dropped
+ *  and counted as an overrun. One thread takes reports with whd_wlansense_acquire_report() and
+ *  hands each back with whd_wlansense_release_report(), in any order.
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
+ * @param buf:                  num_slots * slot_size bytes provided by user, NULL to remove the ring
+ * @param slot_size:            Bytes per slot, at most 65535; WHD_CSI_MAX_REPORT_SIZE holds any report
+ * @param num_slots:            Number of slots
+ * @param notify:               Optional callback on the WHD thread for each queued report; it must not block
+ * @param user_data:            Passed to notify
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_set_ring(whd_driver_t whd_driver, uint8_t *buf, uint32_t slot_size,
+                                           uint32_t num_slots, whd_csi_report_notify notify, void *user_data);
+
+/** Takes the oldest completed CSI report from the ring; report->data stays valid until released.
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
+ * @param report:               Pointer to the report provided by user
+ *
+ * @return whd_result_t:        WHD_SUCCESS, WHD_NO_PACKET_TO_RECEIVE if no report is ready, or Error code.
+ */
+extern whd_result_t whd_wlansense_acquire_report(whd_driver_t whd_driver, whd_csi_report_t *report);
+
+/** Hands the slot of an acquired CSI report back to the ring.
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
+ * @param report:               Report filled in by whd_wlansense_acquire_report()
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_release_report(whd_driver_t whd_driver, const whd_csi_report_t *report);
+
+/** Extracts features from every CSI report on the WHD thread: fixed-point amplitude and sanitised
+ *  phase per kept subcarrier and the rolling mean and variance of the amplitudes. Call before
+ *  whd_wlansense_start_capture().
+ *
+ *  Unless config->send_raw is set the raw reports are no longer sent up, only the feature vectors.
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
+ * @param config:               Report layout and feature settings provided by user, NULL to stop extracting features
+ * @param features_cb:          Callback for each feature vector; it must not block
+ * @param user_data:            Passed to features_cb
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_set_features(whd_driver_t whd_driver, const whd_csi_features_config_t *config,
+                                               whd_csi_features_cb features_cb, void *user_data);
+
+/** Gets the feature extraction counters: reports processed, vectors made and the bytes in and out.
+ *
+ * @param whd_driver:           Instance of the driver the WLANSense interface was created on
+ * @param stats:                Pointer to the counters provided by user
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_get_feature_stats(whd_driver_t whd_driver, whd_csi_features_stats_t *stats);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -22,6 +22,7 @@
 #if defined(COMPONENT_WLANSENSE)
 #include "whd_wlansense_core.h"
 #include "whd_wlansense_api.h"
+#include "whd_wlansense_features.h"
 #include "whd_utils.h"
 #include "whd_proto.h"
 #include "whd_buffer_api.h"
@@ -32,15 +33,19 @@
 ******************************************************/
 #define NETLINK_USER 31 // not yet used by now
 #define CSI_GRP  22 // not yet used by now
-#define CSI_DATA_BUFFER_SIZE 2048
+#define CSI_DATA_BUFFER_SIZE WHD_CSI_MAX_REPORT_SIZE
+
+/* Orders the report and slot state writes against the ring index the other side polls */
+#if !defined (__IAR_SYSTEMS_ICC__)
+#define CSI_RING_BARRIER()  __asm__ __volatile__ ("" : : : "memory")
+#else
+#define CSI_RING_BARRIER()
+#endif
 
 
 /******************************************************
 *             Static Variables
 ******************************************************/
-static whd_interface_t s_prim_ifp;
-static whd_interface_t s_csi_ifp;
-static whd_mac_t wlansense_mac_addr;
 static const whd_event_num_t vif_event[] = { WLC_E_IF, WLC_E_NONE };
 static const whd_event_num_t csi_events[] =
 { WLC_E_CSI_ENABLE, WLC_E_CSI_DATA, WLC_E_CSI_DISABLE, WLC_E_NONE };
@@ -61,33 +66,40 @@ static const whd_event_num_t csi_events[] =
  */
 static void *whd_wlansense_events_handler(whd_interface_t ifp, const whd_event_header_t *event_header,const uint8_t *event_data, void *handler_user_data);
 
-static whd_result_t whd_wlansense_attach_and_handshake(whd_csi_info_t csi_info);
-static whd_result_t whd_wlansense_process_csi_data(whd_csi_info_t csi_info, const uint8_t *event_data, uint32_t datalen);
-static whd_result_t whd_wlansense_detach_and_release_uart(whd_csi_info_t csi_info);
+static whd_result_t whd_wlansense_attach_and_handshake(struct whd_wlansense *ws, whd_csi_info_t csi_info);
+static whd_result_t whd_wlansense_process_csi_data(struct whd_wlansense *ws, whd_csi_info_t csi_info,
+                                                   const whd_mac_t *source, const uint8_t *event_data,
+                                                   uint32_t datalen);
+static whd_result_t whd_wlansense_detach_and_release_uart(struct whd_wlansense *ws, whd_csi_info_t csi_info);
 
 
 /******************************************************
 *             Function definitions
 ******************************************************/
 whd_interface_t
-whd_wlansense_get_interface(void)
+whd_wlansense_get_interface(whd_driver_t whd_driver)
 {
-    return s_csi_ifp;
+    if ( (whd_driver == NULL) || (whd_driver->wlansense == NULL) )
+    {
+        return NULL;
+    }
+    return whd_driver->wlansense->csi_ifp;
 }
 
 whd_result_t
-whd_wlansense_register_handler(void* user_data)
+whd_wlansense_register_handler(whd_driver_t whd_driver, void* user_data)
 {
+    whd_interface_t csi_ifp = whd_wlansense_get_interface(whd_driver);
     uint16_t event_entry = 0xFF;
 
-    CHECK_IFP_NULL(s_csi_ifp);
-    if (s_csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY] != WHD_EVENT_NOT_REGISTERED)
+    CHECK_IFP_NULL(csi_ifp);
+    if (csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY] != WHD_EVENT_NOT_REGISTERED)
     {
-        whd_wifi_deregister_event_handler(s_csi_ifp, s_csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY]);
-        s_csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY] = WHD_EVENT_NOT_REGISTERED;
+        whd_wifi_deregister_event_handler(csi_ifp, csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY]);
+        csi_ifp->event_reg_list[WHD_CSI_EVENT_ENTRY] = WHD_EVENT_NOT_REGISTERED;
     }
 
-    CHECK_RETURN (whd_management_set_event_handler(s_csi_ifp, csi_events,
+    CHECK_RETURN (whd_management_set_event_handler(csi_ifp, csi_events,
                 whd_wlansense_events_handler, user_data, &event_entry));
     return WHD_SUCCESS;
 }
@@ -96,16 +108,21 @@ static void
 *whd_wlansense_events_handler(whd_interface_t ifp, const whd_event_header_t *event_header,
                 const uint8_t *event_data, void *handler_user_data)
 {
+    struct whd_wlansense *ws;
     whd_csi_info_t csi_info;
 
     /* Note: The interface returned by registered event is always primary */
     /* But Wlansense event need to work on the Wlansense interface */
-    /* So unsed the ifp parameter and use the pre-stored csi_ifp */
-    UNUSED_PARAMETER(ifp);
+    /* So only take the driver from ifp and use its csi_ifp */
     UNUSED_PARAMETER(handler_user_data);
 
-    CHECK_IFP_NULL(s_csi_ifp);
-    csi_info = s_csi_ifp->csi_info;
+    CHECK_IFP_NULL(ifp);
+    ws = ifp->whd_driver->wlansense;
+    if ( (ws == NULL) || (ws->csi_ifp == NULL) )
+    {
+        return NULL;
+    }
+    csi_info = ws->csi_ifp->csi_info;
     if (csi_info == NULL)
     {
         WPRINT_WHD_ERROR(("%s: The wlansense info struct is not provided!\n", __func__));
@@ -115,13 +132,13 @@ static void
     switch (event_header->event_type)
     {
         case WLC_E_CSI_ENABLE:
-            whd_wlansense_attach_and_handshake(csi_info);
+            whd_wlansense_attach_and_handshake(ws, csi_info);
             break;
         case WLC_E_CSI_DATA:
-            whd_wlansense_process_csi_data(csi_info, event_data, event_header->datalen);
+            whd_wlansense_process_csi_data(ws, csi_info, &event_header->addr, event_data, event_header->datalen);
             break;
         case WLC_E_CSI_DISABLE:
-            whd_wlansense_detach_and_release_uart(csi_info);
+            whd_wlansense_detach_and_release_uart(ws, csi_info);
             break;
         default:
             WPRINT_WHD_ERROR(("Event type is not registered !"));
@@ -129,11 +146,65 @@ static void
     return 0;
 }
 
+/* Ends a report without sending it up; a ring slot it was written to becomes free again */
+static void
+whd_wlansense_reasm_drop(struct whd_wlansense *ws, struct whd_csi_reasm_slot *slot)
+{
+    if ( (slot->ring_slot >= 0) && (ws->ring.slots != NULL) )
+    {
+        ws->ring.slots[slot->ring_slot].state = WHD_CSI_SLOT_FREE;
+    }
+    slot->ring_slot = -1;
+    slot->buf = NULL;
+    slot->in_use = WHD_FALSE;
+}
+
+static void
+whd_wlansense_free_buffers(struct whd_wlansense *ws, whd_csi_info_t csi_info)
+{
+    uint32_t i;
+
+    for (i = 0; i < WHD_CSI_REASM_SLOTS; i++)
+    {
+        whd_wlansense_reasm_drop(ws, &csi_info->reasm[i]);
+        if (csi_info->reasm[i].heap_buf != NULL)
+        {
+            whd_mem_free(csi_info->reasm[i].heap_buf);
+            csi_info->reasm[i].heap_buf = NULL;
+        }
+    }
+    if (csi_info->data != NULL)
+    {
+        whd_mem_free(csi_info->data);
+        csi_info->data = NULL;
+    }
+}
+
 whd_result_t
-whd_wlansense_attach_and_handshake(whd_csi_info_t csi_info)
+whd_wlansense_attach_and_handshake(struct whd_wlansense *ws, whd_csi_info_t csi_info)
 {
-    /* Allocating memory for csi_info data buffer for CSI message */
-    csi_info->data = whd_mem_malloc(CSI_DATA_BUFFER_SIZE * sizeof(char));
+    uint32_t i;
+
+    /* Allocating memory for csi_info data buffer and, without a ring, the reassembly buffers for CSI message */
+    if (csi_info->data == NULL)
+    {
+        csi_info->data = whd_mem_malloc(CSI_DATA_BUFFER_SIZE * sizeof(char));
+        for (i = 0; i < WHD_CSI_REASM_SLOTS; i++)
+        {
+            csi_info->reasm[i].in_use = WHD_FALSE;
+            csi_info->reasm[i].ring_slot = -1;
+            if (ws->ring.buf != NULL)
+            {
+                continue;
+            }
+            csi_info->reasm[i].heap_buf = whd_mem_malloc(CSI_DATA_BUFFER_SIZE * sizeof(char));
+            if (csi_info->reasm[i].heap_buf == NULL)
+            {
+                whd_wlansense_free_buffers(ws, csi_info);
+                break;
+            }
+        }
+    }
     if (csi_info->data == NULL) {
         WPRINT_WHD_ERROR(("%s: Failed to allocate buffer for CSI message \n", __func__));
         return WHD_BUFFER_ALLOC_FAIL;
@@ -141,44 +212,504 @@ whd_wlansense_attach_and_handshake(whd_csi_info_t csi_info)
 
     /* HandShake byte */
     char *data = "b";
-    csi_info->csi_data_cb_func(data, 1);
+    if (csi_info->csi_data_cb_func != NULL)
+    {
+        csi_info->csi_data_cb_func(data, 1);
+    }
     return WHD_SUCCESS;
 }
 
+/* Picks where a new report is written: the next free ring slot when a ring is set, else the
+ * slot's own buffer. With every ring slot in use the report is discarded as it arrives. */
+static void
+whd_wlansense_reasm_start(struct whd_wlansense *ws, struct whd_csi_reasm_slot *slot)
+{
+    struct whd_csi_ring *ring = &ws->ring;
+    uint32_t i;
+    uint32_t idx;
+
+    slot->ring_slot = -1;
+    if (ring->buf == NULL)
+    {
+        if (slot->heap_buf == NULL)
+        {
+            /* The ring was removed after the capture was enabled */
+            slot->heap_buf = whd_mem_malloc(CSI_DATA_BUFFER_SIZE * sizeof(char) );
+        }
+        slot->buf = slot->heap_buf;
+        slot->capacity = (slot->heap_buf != NULL) ? CSI_DATA_BUFFER_SIZE : 0;
+        return;
+    }
+
+    slot->buf = NULL;
+    slot->capacity = 0;
+    for (i = 0; i < ring->num_slots; i++)
+    {
+        idx = (ring->next_slot + i) % ring->num_slots;
+        if (ring->slots[idx].state == WHD_CSI_SLOT_FREE)
+        {
+            ring->slots[idx].state = WHD_CSI_SLOT_FILLING;
+            ring->next_slot = (idx + 1) % ring->num_slots;
+            slot->ring_slot = (int32_t)idx;
+            slot->buf = (char *)ring->buf + idx * ring->slot_size;
+            slot->capacity = ring->slot_size;
+            return;
+        }
+    }
+    ring->stats.overruns++;
+}
+
+/* Queues a completed report for the consumer */
+static void
+whd_wlansense_ring_put(struct whd_wlansense *ws, const struct whd_csi_reasm_slot *slot)
+{
+    struct whd_csi_ring *ring = &ws->ring;
+    struct whd_csi_ring_slot_info *info = &ring->slots[slot->ring_slot];
+    uint32_t wr = ring->ready_wr;
+    uint32_t depth;
+
+    info->len = slot->len;
+    info->sequence_num = slot->sequence_num;
+    whd_mem_memcpy(&info->source, &slot->source, sizeof(whd_mac_t) );
+    ring->ready[wr % ring->num_slots] = (uint32_t)slot->ring_slot;
+    CSI_RING_BARRIER();
+    info->state = WHD_CSI_SLOT_READY;
+    CSI_RING_BARRIER();
+    ring->ready_wr = wr + 1;
+
+    ring->stats.queued++;
+    depth = wr + 1 - ring->ready_rd;
+    if (depth > ring->stats.max_ready)
+    {
+        ring->stats.max_ready = depth;
+    }
+    if (ring->notify != NULL)
+    {
+        ring->notify(ring->notify_user_data);
+    }
+}
+
+/* Runs a completed report through the feature extraction; returns whether the raw report is
+ * still to be sent up */
+static whd_bool_t
+whd_wlansense_features_run(struct whd_wlansense *ws, const struct whd_csi_reasm_slot *slot, const char *report)
+{
+    whd_csi_features_engine_t *engine = ws->features;
+
+    if (engine == NULL)
+    {
+        return WHD_TRUE;
+    }
+    if ( (whd_csi_features_engine_process(engine, &slot->source, slot->sequence_num, (const uint8_t *)report,
+                                          slot->len) == WHD_TRUE) && (ws->features_cb != NULL) )
+    {
+        ws->features_cb(&engine->vector, ws->features_user_data);
+    }
+    return engine->config.send_raw;
+}
+
+/* Finds the report a fragment belongs to, or starts one: in a free slot, one that timed out or,
+ * failing that, the oldest */
+static struct whd_csi_reasm_slot *
+whd_wlansense_reasm_slot(struct whd_wlansense *ws, whd_csi_info_t csi_info, const whd_mac_t *source,
+                         uint8_t sequence_num, uint32_t now_ms)
+{
+    struct whd_csi_reasm_slot *slot;
+    struct whd_csi_reasm_slot *free_slot = NULL;
+    struct whd_csi_reasm_slot *oldest = NULL;
+    uint32_t i;
+
+    for (i = 0; i < WHD_CSI_REASM_SLOTS; i++)
+    {
+        slot = &csi_info->reasm[i];
+        if ( (slot->in_use == WHD_TRUE) && (now_ms - slot->start_ms > WHD_CSI_REASM_TIMEOUT_MS) )
+        {
+            csi_info->reasm_stats.timeouts++;
+            whd_wlansense_reasm_drop(ws, slot);
+        }
+        if (slot->in_use == WHD_FALSE)
+        {
+            if (free_slot == NULL)
+            {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if ( (slot->sequence_num == sequence_num) &&
+             (memcmp(&slot->source, source, sizeof(whd_mac_t) ) == 0) )
+        {
+            return slot;
+        }
+        if ( (oldest == NULL) || (now_ms - slot->start_ms > now_ms - oldest->start_ms) )
+        {
+            oldest = slot;
+        }
+    }
+
+    if (free_slot == NULL)
+    {
+        csi_info->reasm_stats.evicted++;
+        whd_wlansense_reasm_drop(ws, oldest);
+        free_slot = oldest;
+    }
+    whd_wlansense_reasm_start(ws, free_slot);
+    free_slot->in_use = WHD_TRUE;
+    free_slot->in_order = WHD_TRUE;
+    free_slot->sequence_num = sequence_num;
+    free_slot->total_fragments = 0;
+    free_slot->received = 0;
+    whd_mem_memcpy(&free_slot->source, source, sizeof(whd_mac_t) );
+    free_slot->bitmap = 0;
+    free_slot->start_ms = now_ms;
+    free_slot->len = 0;
+    return free_slot;
+}
+
 whd_result_t
-whd_wlansense_process_csi_data(whd_csi_info_t csi_info, const uint8_t *event_data, uint32_t datalen)
+whd_wlansense_process_csi_data(struct whd_wlansense *ws, whd_csi_info_t csi_info, const whd_mac_t *source,
+                               const uint8_t *event_data, uint32_t datalen)
 {
-    struct wlc_csi_fragment_hdr *frag_hdr = (struct wlc_csi_fragment_hdr *)event_data;
-    char *data = csi_info->data;
-    static char *last;
-    int hdrlen = sizeof(struct wlc_csi_fragment_hdr);
-    datalen = datalen -hdrlen;
+    const struct wlc_csi_fragment_hdr *frag_hdr = (const struct wlc_csi_fragment_hdr *)event_data;
+    whd_csi_reasm_stats_t *stats = &csi_info->reasm_stats;
+    struct whd_csi_reasm_slot *slot;
+    uint32_t hdrlen = sizeof(struct wlc_csi_fragment_hdr);
+    uint32_t frag_bit;
+    uint32_t len;
+    uint32_t i;
+    cy_time_t now;
+    char *report;
+    char *scratch;
+
+    if (csi_info->data == NULL)
+    {
+        return WHD_BADARG;
+    }
+    if ( (datalen < hdrlen) || (frag_hdr->total_fragments == 0) ||
+         (frag_hdr->total_fragments > WHD_CSI_MAX_FRAGMENTS) || (frag_hdr->fragment_num >= frag_hdr->total_fragments) )
+    {
+        stats->corrupt++;
+        return WHD_BADARG;
+    }
+    stats->fragments++;
+    datalen = datalen - hdrlen;
     event_data = event_data + hdrlen;
-    /* TODO: Handle sequence number, fragment number mismatches. Check header version. */
-    if (frag_hdr->fragment_num == 0) {
-        last = data;
+    (void)cy_rtos_get_time(&now);
+
+    slot = whd_wlansense_reasm_slot(ws, csi_info, source, frag_hdr->sequence_num, (uint32_t)now);
+    if ( (slot->total_fragments != 0) &&
+         ( (slot->total_fragments != frag_hdr->total_fragments) || (slot->hdr_version != frag_hdr->hdr_version) ) )
+    {
+        /* A damaged header, or the sequence number wrapped onto a stale report: drop it and start over */
+        stats->corrupt++;
+        whd_wlansense_reasm_drop(ws, slot);
+        slot = whd_wlansense_reasm_slot(ws, csi_info, source, frag_hdr->sequence_num, (uint32_t)now);
+    }
+    if (slot->total_fragments == 0)
+    {
+        slot->total_fragments = frag_hdr->total_fragments;
+        slot->hdr_version = frag_hdr->hdr_version;
     }
-    whd_mem_memcpy(last, event_data, datalen);
-    last = last + datalen;
+
+    frag_bit = 1UL << frag_hdr->fragment_num;
+    if ( (slot->bitmap & frag_bit) != 0 )
+    {
+        stats->duplicates++;
+        return WHD_SUCCESS;
+    }
+    if ( (slot->buf != NULL) && (slot->len + datalen > slot->capacity) )
+    {
+        stats->oversize++;
+        whd_wlansense_reasm_drop(ws, slot);
+        return WHD_BADARG;
+    }
+    if (slot->buf != NULL)
+    {
+        whd_mem_memcpy(slot->buf + slot->len, event_data, datalen);
+    }
+    slot->frag_offset[frag_hdr->fragment_num] = (uint16_t)slot->len;
+    slot->frag_len[frag_hdr->fragment_num] = (uint16_t)datalen;
+    slot->len += datalen;
+    if (frag_hdr->fragment_num != slot->received)
+    {
+        slot->in_order = WHD_FALSE;
+    }
+    slot->received++;
+    slot->bitmap |= frag_bit;
+    if (slot->received < slot->total_fragments)
+    {
+        return WHD_SUCCESS;
+    }
+
     /* Handling the last frame */
-    if (frag_hdr->fragment_num == (frag_hdr->total_fragments - 1)) {
-        csi_info->csi_data_cb_func(data,(last - data));
-        last = data;
+    if (slot->buf == NULL)
+    {
+        /* No ring slot was free for it; counted as an overrun when it started */
+        whd_wlansense_reasm_drop(ws, slot);
+        return WHD_SUCCESS;
+    }
+    report = slot->buf;
+    if (slot->in_order == WHD_FALSE)
+    {
+        scratch = (slot->ring_slot >= 0) ? ws->ring.scratch : csi_info->data;
+        len = 0;
+        for (i = 0; i < slot->total_fragments; i++)
+        {
+            whd_mem_memcpy(scratch + len, slot->buf + slot->frag_offset[i], slot->frag_len[i]);
+            len += slot->frag_len[i];
+        }
+        report = scratch;
+        stats->reordered++;
+    }
+    stats->reports++;
+    if (whd_wlansense_features_run(ws, slot, report) == WHD_FALSE)
+    {
+        whd_wlansense_reasm_drop(ws, slot);
+        return WHD_SUCCESS;
+    }
+    if (slot->ring_slot >= 0)
+    {
+        if (report != slot->buf)
+        {
+            whd_mem_memcpy(slot->buf, report, slot->len);
+        }
+        whd_wlansense_ring_put(ws, slot);
+        slot->ring_slot = -1;
+        slot->in_use = WHD_FALSE;
+        return WHD_SUCCESS;
+    }
+    slot->in_use = WHD_FALSE;
+    if (csi_info->csi_data_cb_func != NULL)
+    {
+        csi_info->csi_data_cb_func(report, slot->len);
     }
     return WHD_SUCCESS;
 }
 
 whd_result_t
-whd_wlansense_detach_and_release_uart(whd_csi_info_t csi_info)
+whd_wlansense_detach_and_release_uart(struct whd_wlansense *ws, whd_csi_info_t csi_info)
 {
     /* TODO: Send some signal that would indicate the script that disable event is being received */
     char *data = "BYE";
-    csi_info->csi_data_cb_func(data, 3);
-    whd_mem_free(csi_info->data);
+    if (csi_info->csi_data_cb_func != NULL)
+    {
+        csi_info->csi_data_cb_func(data, 3);
+    }
+    whd_wlansense_free_buffers(ws, csi_info);
+    if ( (ws->csi_ifp != NULL) && (ws->csi_ifp->csi_info == csi_info) )
+    {
+        ws->csi_ifp->csi_info = NULL;
+    }
     whd_mem_free(csi_info);
     return WHD_SUCCESS;
 }
 
+whd_result_t
+whd_wlansense_get_reasm_stats(whd_driver_t whd_driver, whd_csi_reasm_stats_t *stats)
+{
+    whd_interface_t csi_ifp = whd_wlansense_get_interface(whd_driver);
+
+    CHECK_IFP_NULL(csi_ifp);
+    if ( (stats == NULL) || (csi_ifp->csi_info == NULL) )
+    {
+        return WHD_BADARG;
+    }
+    whd_mem_memcpy(stats, &csi_ifp->csi_info->reasm_stats, sizeof(*stats) );
+    return WHD_SUCCESS;
+}
+
+static void
+whd_wlansense_ring_free(struct whd_csi_ring *ring)
+{
+    if (ring->slots != NULL)
+    {
+        whd_mem_free(ring->slots);
+    }
+    if (ring->ready != NULL)
+    {
+        whd_mem_free(ring->ready);
+    }
+    if (ring->scratch != NULL)
+    {
+        whd_mem_free(ring->scratch);
+    }
+    whd_mem_memset(ring, 0, sizeof(*ring) );
+}
+
+whd_result_t
+whd_wlansense_ring_attach(whd_driver_t whd_driver, uint8_t *buf, uint32_t slot_size, uint32_t num_slots,
+                          whd_csi_report_notify notify, void *user_data)
+{
+    struct whd_wlansense *ws;
+    struct whd_csi_ring *ring;
+    uint32_t i;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    ws = whd_driver->wlansense;
+    if ( (ws == NULL) || ( (buf != NULL) && ( (slot_size == 0) || (slot_size > 0xFFFF) || (num_slots == 0) ) ) )
+    {
+        return WHD_BADARG;
+    }
+    ring = &ws->ring;
+
+    /* Reports in progress may point into the old ring */
+    if ( (ws->csi_ifp != NULL) && (ws->csi_ifp->csi_info != NULL) )
+    {
+        for (i = 0; i < WHD_CSI_REASM_SLOTS; i++)
+        {
+            whd_wlansense_reasm_drop(ws, &ws->csi_ifp->csi_info->reasm[i]);
+        }
+    }
+    whd_wlansense_ring_free(ring);
+    if (buf == NULL)
+    {
+        return WHD_SUCCESS;
+    }
+
+    ring->slots = whd_mem_calloc(num_slots, sizeof(struct whd_csi_ring_slot_info) );
+    ring->ready = whd_mem_calloc(num_slots, sizeof(uint32_t) );
+    ring->scratch = whd_mem_malloc(slot_size);
+    if ( (ring->slots == NULL) || (ring->ready == NULL) || (ring->scratch == NULL) )
+    {
+        whd_wlansense_ring_free(ring);
+        return WHD_BUFFER_ALLOC_FAIL;
+    }
+    ring->slot_size = slot_size;
+    ring->num_slots = num_slots;
+    ring->notify = notify;
+    ring->notify_user_data = user_data;
+    ring->buf = buf;
+    return WHD_SUCCESS;
+}
+
+whd_result_t
+whd_wlansense_ring_acquire(whd_driver_t whd_driver, whd_csi_report_t *report)
+{
+    struct whd_csi_ring *ring;
+    struct whd_csi_ring_slot_info *info;
+    uint32_t rd;
+    uint32_t idx;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    if ( (report == NULL) || (whd_driver->wlansense == NULL) || (whd_driver->wlansense->ring.buf == NULL) )
+    {
+        return WHD_BADARG;
+    }
+    ring = &whd_driver->wlansense->ring;
+    rd = ring->ready_rd;
+    if (rd == ring->ready_wr)
+    {
+        return WHD_NO_PACKET_TO_RECEIVE;
+    }
+    CSI_RING_BARRIER();
+    idx = ring->ready[rd % ring->num_slots];
+    info = &ring->slots[idx];
+    info->state = WHD_CSI_SLOT_HELD;
+    report->data = ring->buf + idx * ring->slot_size;
+    report->len = info->len;
+    whd_mem_memcpy(&report->source, &info->source, sizeof(whd_mac_t) );
+    report->sequence_num = info->sequence_num;
+    report->slot = idx;
+    CSI_RING_BARRIER();
+    ring->ready_rd = rd + 1;
+    ring->stats.acquired++;
+    return WHD_SUCCESS;
+}
+
+whd_result_t
+whd_wlansense_ring_release(whd_driver_t whd_driver, const whd_csi_report_t *report)
+{
+    struct whd_csi_ring *ring;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    if (whd_driver->wlansense == NULL)
+    {
+        return WHD_BADARG;
+    }
+    ring = &whd_driver->wlansense->ring;
+    if ( (report == NULL) || (ring->buf == NULL) || (report->slot >= ring->num_slots) ||
+         (ring->slots[report->slot].state != WHD_CSI_SLOT_HELD) )
+    {
+        return WHD_BADARG;
+    }
+    CSI_RING_BARRIER();
+    ring->slots[report->slot].state = WHD_CSI_SLOT_FREE;
+    return WHD_SUCCESS;
+}
+
+whd_result_t
+whd_wlansense_get_ring_stats(whd_driver_t whd_driver, whd_csi_ring_stats_t *stats)
+{
+    CHECK_DRIVER_NULL(whd_driver);
+    if ( (stats == NULL) || (whd_driver->wlansense == NULL) || (whd_driver->wlansense->ring.buf == NULL) )
+    {
+        return WHD_BADARG;
+    }
+    whd_mem_memcpy(stats, &whd_driver->wlansense->ring.stats, sizeof(*stats) );
+    return WHD_SUCCESS;
+}
+
+whd_result_t
+whd_wlansense_features_attach(whd_driver_t whd_driver, const whd_csi_features_config_t *config,
+                              whd_csi_features_cb features_cb, void *user_data)
+{
+    struct whd_wlansense *ws;
+    whd_csi_features_engine_t *engine;
+    whd_result_t result;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    ws = whd_driver->wlansense;
+    if (ws == NULL)
+    {
+        return WHD_BADARG;
+    }
+    engine = ws->features;
+
+    if (config == NULL)
+    {
+        ws->features = NULL;
+        ws->features_cb = NULL;
+        if (engine != NULL)
+        {
+            whd_mem_free(engine);
+        }
+        return WHD_SUCCESS;
+    }
+
+    if (engine == NULL)
+    {
+        engine = whd_mem_malloc(sizeof(*engine) );
+        if (engine == NULL)
+        {
+            return WHD_BUFFER_ALLOC_FAIL;
+        }
+    }
+    result = whd_csi_features_engine_init(engine, config);
+    if (result != WHD_SUCCESS)
+    {
+        if (ws->features == NULL)
+        {
+            whd_mem_free(engine);
+        }
+        return result;
+    }
+    ws->features_cb = features_cb;
+    ws->features_user_data = user_data;
+    ws->features = engine;
+    return WHD_SUCCESS;
+}
+
+whd_result_t
+whd_wlansense_features_get_stats(whd_driver_t whd_driver, whd_csi_features_stats_t *stats)
+{
+    CHECK_DRIVER_NULL(whd_driver);
+    if ( (stats == NULL) || (whd_driver->wlansense == NULL) || (whd_driver->wlansense->features == NULL) )
+    {
+        return WHD_BADARG;
+    }
+    whd_mem_memcpy(stats, &whd_driver->wlansense->features->stats, sizeof(*stats) );
+    return WHD_SUCCESS;
+}
+
 void
 whd_wlansense_init_cfg_params(wlc_csi_cfg_t *csi_cfg)
 {
@@ -222,15 +753,16 @@ static void
 *whd_wlansense_handle_vif_event(whd_interface_t ifp, const whd_event_header_t *event_header,
                                     const uint8_t *event_data, void *handler_user_data)
 {
+    struct whd_wlansense *ws = (struct whd_wlansense *)handler_user_data;
     whd_interface_t prim_ifp = ifp;
     wl_vif_event_t *vif_evt = (wl_vif_event_t *)event_data;
     whd_result_t result;
 
     if (prim_ifp == NULL)
     {
-        if (s_prim_ifp != NULL)
+        if (ws->prim_ifp != NULL)
         {
-            prim_ifp = s_prim_ifp;
+            prim_ifp = ws->prim_ifp;
         }
         else
         {
@@ -242,17 +774,12 @@ static void
     if ((event_header->event_type == WLC_E_IF) && (vif_evt->action == WHD_IF_E_ADD))
     {
         WPRINT_WHD_INFO(("VIF ADD - idx[%d], bsscfgidx[%d], role[%d]\n", vif_evt->ifidx, vif_evt->bsscfgidx, vif_evt->role));
-        s_csi_ifp = whd_mem_malloc(sizeof(whd_interface_t));
         result = whd_add_interface(prim_ifp->whd_driver, vif_evt->bsscfgidx, vif_evt->ifidx, "wlansense0",
-                                  (whd_mac_t *)handler_user_data, &s_csi_ifp);
+                                  &ws->mac_addr, &ws->csi_ifp);
         if (result == WHD_SUCCESS)
         {
             WPRINT_WHD_INFO(("WLANSENSE0 interface created!!! \n"));
-            s_csi_ifp->role = vif_evt->role;
-        }
-        else
-        {
-            whd_mem_free (s_csi_ifp);
+            ws->csi_ifp->role = vif_evt->role;
         }
     }
     else
@@ -265,6 +792,7 @@ static void
 
 whd_result_t whd_wlansense_create_interface (whd_driver_t whd_driver)
 {
+    struct whd_wlansense *ws;
     whd_interface_t prim_ifp;
     whd_result_t result;
     whd_buffer_t buffer;
@@ -274,13 +802,22 @@ whd_result_t whd_wlansense_create_interface (whd_driver_t whd_driver)
     CHECK_DRIVER_NULL(whd_driver);
     prim_ifp = whd_get_primary_interface(whd_driver);
     CHECK_IFP_NULL(prim_ifp);
-    s_prim_ifp = prim_ifp;
+    if (whd_driver->wlansense == NULL)
+    {
+        whd_driver->wlansense = whd_mem_calloc(1, sizeof(struct whd_wlansense) );
+        if (whd_driver->wlansense == NULL)
+        {
+            return WHD_MALLOC_FAILURE;
+        }
+    }
+    ws = whd_driver->wlansense;
+    ws->prim_ifp = prim_ifp;
 
     /* Register for virtual interface events */
     CHECK_RETURN(whd_management_set_event_handler(prim_ifp, vif_event, whd_wlansense_handle_vif_event,
-                                                                 &wlansense_mac_addr, &event_entry));
+                                                                 ws, &event_entry));
 
-    if ( (result = whd_wifi_get_mac_address(prim_ifp, &wlansense_mac_addr) ) != WHD_SUCCESS )
+    if ( (result = whd_wifi_get_mac_address(prim_ifp, &ws->mac_addr) ) != WHD_SUCCESS )
     {
         WPRINT_WHD_INFO ((" Get STA MAC address failed result=%" PRIu32 "\n", result));
         return result;
@@ -290,25 +827,50 @@ whd_result_t whd_wlansense_create_interface (whd_driver_t whd_driver)
         WPRINT_WHD_INFO ((" Get STA MAC address success\n"));
     }
 
-    if (wlansense_mac_addr.octet[0] & (0x02))
+    if (ws->mac_addr.octet[0] & (0x02))
     {
-        wlansense_mac_addr.octet[0] &= (uint8_t) ~(0x02);
+        ws->mac_addr.octet[0] &= (uint8_t) ~(0x02);
     }
     else
     {
-        wlansense_mac_addr.octet[0] |= (0x02);
+        ws->mac_addr.octet[0] |= (0x02);
     }
 
     csi_intf_req = (wl_wlan_sense_if_t *)whd_proto_get_iovar_buffer(whd_driver, &buffer, sizeof(wl_wlan_sense_if_t), IOVAR_STR_CSI_IFADD);
     CHECK_IOCTL_BUFFER(csi_intf_req);
-    whd_mem_memcpy(&csi_intf_req->csi_macaddr, &wlansense_mac_addr, sizeof(whd_mac_t) );
+    whd_mem_memcpy(&csi_intf_req->csi_macaddr, &ws->mac_addr, sizeof(whd_mac_t) );
     result = whd_proto_set_iovar(prim_ifp, buffer, NULL);
 
     return result;
 }
 
+void
+whd_wlansense_deinit(whd_driver_t whd_driver)
+{
+    struct whd_wlansense *ws = whd_driver->wlansense;
+
+    if (ws == NULL)
+    {
+        return;
+    }
+    /* The interfaces themselves are freed with the driver's interface list */
+    if ( (ws->csi_ifp != NULL) && (ws->csi_ifp->csi_info != NULL) )
+    {
+        whd_wlansense_free_buffers(ws, ws->csi_ifp->csi_info);
+        whd_mem_free(ws->csi_ifp->csi_info);
+        ws->csi_ifp->csi_info = NULL;
+    }
+    whd_wlansense_ring_free(&ws->ring);
+    if (ws->features != NULL)
+    {
+        whd_mem_free(ws->features);
+    }
+    whd_mem_free(ws);
+    whd_driver->wlansense = NULL;
+}
+
 whd_result_t
-whd_wlansense_get_config(wlc_csi_cfg_t *csi_cfg)
+whd_wlansense_get_config(whd_driver_t whd_driver, wlc_csi_cfg_t *csi_cfg)
 {
     uint8_t buffer[WLC_IOCTL_MEDLEN];
     uint32_t i;
@@ -316,8 +878,13 @@ whd_wlansense_get_config(wlc_csi_cfg_t *csi_cfg)
     wlc_csi_cfg_t *csi_cfg_buf;
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
-    CHECK_IFP_NULL(s_prim_ifp);
-    CHECK_RETURN(whd_wifi_get_iovar_buffer(s_prim_ifp, IOVAR_STR_CSI, buffer, WLC_IOCTL_MEDLEN));
+    CHECK_DRIVER_NULL(whd_driver);
+    if (whd_driver->wlansense == NULL)
+    {
+        return WHD_BADARG;
+    }
+    CHECK_IFP_NULL(whd_driver->wlansense->prim_ifp);
+    CHECK_RETURN(whd_wifi_get_iovar_buffer(whd_driver->wlansense->prim_ifp, IOVAR_STR_CSI, buffer, WLC_IOCTL_MEDLEN));
     csi_cfg_buf = (wlc_csi_cfg_t *)buffer;
     whd_mem_memcpy(csi_cfg, csi_cfg_buf, sizeof(wlc_csi_cfg_t));
 
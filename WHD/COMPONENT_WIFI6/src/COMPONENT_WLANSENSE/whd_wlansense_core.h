@@ -30,6 +30,7 @@ extern "C"
 
 #include "whd.h"
 #include "whd_wlioctl.h"
+#include "whd_wlansense_features.h"
 
 
 #define WHD_IF_E_ADD              1
@@ -45,6 +46,63 @@ struct wlc_csi_fragment_hdr {
     uint8_t total_fragments;
 };
 
+/* Reports reassembled at the same time, e.g. from several transmitters */
+#ifndef WHD_CSI_REASM_SLOTS
+#define WHD_CSI_REASM_SLOTS         (2)
+#endif
+
+/* An incomplete report is dropped once its first fragment is this old */
+#ifndef WHD_CSI_REASM_TIMEOUT_MS
+#define WHD_CSI_REASM_TIMEOUT_MS    (100)
+#endif
+
+/* Most fragments in one report, one bit each in the fragment bitmap */
+#define WHD_CSI_MAX_FRAGMENTS       (32)
+
+/* Largest report the driver reassembles into its own buffers; size ring slots to at least this */
+#define WHD_CSI_MAX_REPORT_SIZE     (2048)
+
+/* CSI ring slot states. The WHD thread moves a slot from FREE to FILLING to READY, the consumer
+ * from READY to HELD on acquire and back to FREE on release. */
+#define WHD_CSI_SLOT_FREE           (0)
+#define WHD_CSI_SLOT_FILLING        (1)
+#define WHD_CSI_SLOT_READY          (2)
+#define WHD_CSI_SLOT_HELD           (3)
+
+/** CSI fragment reassembly counters */
+typedef struct whd_csi_reasm_stats
+{
+    uint32_t fragments;         /**< Fragments received */
+    uint32_t reports;           /**< Complete reports sent up */
+    uint32_t reordered;         /**< Reports sent up whose fragments arrived out of order */
+    uint32_t duplicates;        /**< Fragments received twice; the copy is ignored */
+    uint32_t timeouts;          /**< Incomplete reports dropped after WHD_CSI_REASM_TIMEOUT_MS */
+    uint32_t evicted;           /**< Incomplete reports dropped to make room for a newer one */
+    uint32_t corrupt;           /**< Fragments or reports dropped for inconsistent headers */
+    uint32_t oversize;          /**< Reports dropped for not fitting the report buffer */
+} whd_csi_reasm_stats_t;
+
+/* One report being reassembled, keyed by sequence number and source. Fragments are stored in
+ * arrival order; frag_offset/frag_len locate each one. */
+struct whd_csi_reasm_slot {
+    whd_bool_t in_use;
+    whd_bool_t in_order;        /* Every fragment so far arrived in fragment_num order */
+    uint8_t sequence_num;
+    uint8_t hdr_version;
+    uint8_t total_fragments;
+    uint8_t received;
+    whd_mac_t source;
+    uint32_t bitmap;            /* Bit n set once fragment n is stored */
+    uint32_t start_ms;
+    uint32_t len;
+    uint16_t frag_offset[WHD_CSI_MAX_FRAGMENTS];
+    uint16_t frag_len[WHD_CSI_MAX_FRAGMENTS];
+    char *buf;                  /* Where the report is written: heap_buf, a ring slot, or NULL to discard it */
+    uint32_t capacity;
+    int32_t ring_slot;          /* Ring slot behind buf, -1 for none */
+    char *heap_buf;             /* Used when no ring is set */
+};
+
 /** Callback for CSI data that is called when CSI data is processed and is ready to be sent to upper layer
  *
  * @param data: Pointer to CSI data
@@ -53,31 +111,98 @@ struct wlc_csi_fragment_hdr {
  */
 typedef void (*whd_csi_data_sendup)(char* data, uint32_t len);
 
+/** Callback run on the WHD thread when a report is added to the CSI ring; it must not block
+ *
+ * @param user_data: Pointer given with the ring
+ *
+ */
+typedef void (*whd_csi_report_notify)(void *user_data);
+
+/** A completed CSI report held in a ring slot */
+typedef struct whd_csi_report
+{
+    uint8_t *data;              /**< Report in the ring slot */
+    uint32_t len;               /**< Report length */
+    whd_mac_t source;           /**< Address the report came from */
+    uint8_t sequence_num;       /**< Firmware sequence number */
+    uint32_t slot;              /**< Ring slot, handed back with whd_wlansense_release_report() */
+} whd_csi_report_t;
+
+/** CSI ring counters */
+typedef struct whd_csi_ring_stats
+{
+    uint32_t queued;            /**< Reports placed in the ring */
+    uint32_t acquired;          /**< Reports taken by the consumer */
+    uint32_t overruns;          /**< Reports dropped because every slot was filling, ready or held */
+    uint32_t max_ready;         /**< Most reports waiting for the consumer at once */
+} whd_csi_ring_stats_t;
+
+struct whd_csi_ring_slot_info {
+    volatile uint8_t state;     /* WHD_CSI_SLOT_* */
+    uint8_t sequence_num;
+    whd_mac_t source;
+    uint32_t len;
+};
+
+/* Single producer (WHD thread), single consumer ring over application memory. Completed reports
+ * are queued by slot index in ready[]; a slot is reused once its state is back to FREE. */
+struct whd_csi_ring {
+    uint8_t *buf;               /* num_slots * slot_size bytes, NULL when no ring is set */
+    uint32_t slot_size;
+    uint32_t num_slots;
+    uint32_t next_slot;         /* Where the WHD thread starts looking for a free slot */
+    struct whd_csi_ring_slot_info *slots;
+    uint32_t *ready;            /* num_slots entries */
+    volatile uint32_t ready_wr; /* Advanced by the WHD thread only */
+    volatile uint32_t ready_rd; /* Advanced by the consumer only */
+    char *scratch;              /* slot_size bytes for putting reordered fragments back in order */
+    whd_csi_report_notify notify;
+    void *notify_user_data;
+    whd_csi_ring_stats_t stats;
+};
+
 struct whd_csi_info {
-    char *data;
+    char *data;                 /* Reports whose fragments arrived out of order are put back in order here */
     whd_csi_data_sendup csi_data_cb_func;
+    struct whd_csi_reasm_slot reasm[WHD_CSI_REASM_SLOTS];
+    whd_csi_reasm_stats_t reasm_stats;
 };
 
 typedef struct whd_csi_info *whd_csi_info_t;
 
+/* WLANSense state of one driver, allocated by whd_wlansense_create_interface() */
+struct whd_wlansense {
+    whd_interface_t prim_ifp;
+    whd_interface_t csi_ifp;
+    whd_mac_t mac_addr;         /* Address the wlansense interface is created with */
+    whd_bool_t capture_started;
+    struct whd_csi_ring ring;
+    whd_csi_features_engine_t *features;
+    whd_csi_features_cb features_cb;
+    void *features_user_data;
+};
+
 
 /******************************************************
 *             Function declarations
 ******************************************************/
 
 /** Get Wlansense interface instatnce
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
  *
  * @return whd_interface_t:     The pointer to Wlansense interface instatnce.
  */
-extern whd_interface_t whd_wlansense_get_interface(void);
+extern whd_interface_t whd_wlansense_get_interface(whd_driver_t whd_driver);
 
 /** Handler attach function that would attach the handler function.
  *
+ * @param whd_driver:           Pointer to handle instance of the driver.
  * @param user_data:            A pointer value which will be passed to the event handler function (NULL is allowed).
  *
  * @return whd_result_t:        WHD_SUCCESS or Error code.
  */
-extern whd_result_t whd_wlansense_register_handler(void* user_data);
+extern whd_result_t whd_wlansense_register_handler(whd_driver_t whd_driver, void* user_data);
 
 /** Initializes CSI_Cfg struct with default parameters.
  *
@@ -103,13 +228,93 @@ extern void whd_wlansense_validate_cfg_params(wlc_csi_cfg_t *csi_cfg);
  */
 extern whd_result_t whd_wlansense_create_interface(whd_driver_t whd_driver);
 
+/** Frees the WLANSense state of a driver, called from whd_deinit().
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ *
+ * @return void:                No error code returns.
+ */
+extern void whd_wlansense_deinit(whd_driver_t whd_driver);
+
 /** Dumps the wlc_csi_cfg_t struct from FW.
  *
- * @param ifp:                  Pointer to handle instance of csi_cfg parameters.
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param csi_cfg:              Pointer to handle instance of csi_cfg parameters.
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_get_config(whd_driver_t whd_driver, wlc_csi_cfg_t *csi_cfg);
+
+/** Copies the CSI fragment reassembly counters.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param stats:                Pointer to the counters to fill in.
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_get_reasm_stats(whd_driver_t whd_driver, whd_csi_reasm_stats_t *stats);
+
+/** Sets or removes the ring CSI reports are written to. Only while no capture runs.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param buf:                  num_slots * slot_size bytes of application memory, NULL to remove the ring.
+ * @param slot_size:            Bytes per slot; reports that do not fit are dropped.
+ * @param num_slots:            Number of slots.
+ * @param notify:               Called on the WHD thread for every queued report (NULL is allowed).
+ * @param user_data:            Passed to notify.
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_ring_attach(whd_driver_t whd_driver, uint8_t *buf, uint32_t slot_size,
+                                              uint32_t num_slots, whd_csi_report_notify notify, void *user_data);
+
+/** Takes the oldest completed report from the ring.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param report:               Pointer to the report to fill in.
+ *
+ * @return whd_result_t:        WHD_SUCCESS, WHD_NO_PACKET_TO_RECEIVE if none is ready or Error code.
+ */
+extern whd_result_t whd_wlansense_ring_acquire(whd_driver_t whd_driver, whd_csi_report_t *report);
+
+/** Hands a report's slot back to the ring.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param report:               Report filled in by whd_wlansense_ring_acquire().
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_ring_release(whd_driver_t whd_driver, const whd_csi_report_t *report);
+
+/** Copies the CSI ring counters.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param stats:                Pointer to the counters to fill in.
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_get_ring_stats(whd_driver_t whd_driver, whd_csi_ring_stats_t *stats);
+
+/** Sets or removes the feature extraction run on every completed CSI report. Only while no capture runs.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param config:               Layout and feature settings, NULL to stop extracting features.
+ * @param features_cb:          Called on the WHD thread with each feature vector (NULL is allowed).
+ * @param user_data:            Passed to features_cb.
+ *
+ * @return whd_result_t:        WHD_SUCCESS or Error code.
+ */
+extern whd_result_t whd_wlansense_features_attach(whd_driver_t whd_driver, const whd_csi_features_config_t *config,
+                                                  whd_csi_features_cb features_cb, void *user_data);
+
+/** Copies the feature extraction counters.
+ *
+ * @param whd_driver:           Pointer to handle instance of the driver.
+ * @param stats:                Pointer to the counters to fill in.
  *
  * @return whd_result_t:        WHD_SUCCESS or Error code.
  */
-extern whd_result_t whd_wlansense_get_config(wlc_csi_cfg_t *csi_cfg);
+extern whd_result_t whd_wlansense_features_get_stats(whd_driver_t whd_driver, whd_csi_features_stats_t *stats);
 
 
 #ifdef __cplusplus
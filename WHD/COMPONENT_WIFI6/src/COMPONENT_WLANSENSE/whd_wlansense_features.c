@@ -0,0 +1,291 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file whd_wlansense_features.c
+ *  Turns CSI reports into compact feature vectors.
+ */
+
+#if defined(COMPONENT_WLANSENSE)
+#include "whd_wlansense_features.h"
+#include "whd_debug.h"
+#include "whd_utils.h"
+
+
+/******************************************************
+*                   Constants
+******************************************************/
+#define CSI_PHASE_QUARTER       (16384)
+#define CSI_PHASE_EIGHTH        (8192)
+
+/* atan(z) ~= pi/4 * z + z * (1 - z) * (0.2447 + 0.0663 * z) on [0, 1], the coefficients in
+ * binary angle units; about 0.0015 rad worst case */
+#define CSI_ATAN_C0             (2552)
+#define CSI_ATAN_C1             (691)
+
+/* Array bytes of one feature vector per kept subcarrier: mean, variance and phase */
+#define CSI_FEATURE_BYTES       (sizeof(uint16_t) + sizeof(uint32_t) + sizeof(int16_t) )
+
+
+/******************************************************
+*             Function definitions
+******************************************************/
+uint16_t
+whd_csi_amplitude(int32_t i, int32_t q)
+{
+    uint32_t ai = (uint32_t)( (i < 0) ? -i : i );
+    uint32_t aq = (uint32_t)( (q < 0) ? -q : q );
+    uint32_t value = ai * ai + aq * aq;
+    uint32_t big = (ai > aq) ? ai : aq;
+    uint32_t root;
+
+    if (value == 0)
+    {
+        return 0;
+    }
+
+    /* max + 3/8 min is within 7% of the magnitude, two Newton steps take it to within one */
+    root = big + ( (3 * (ai + aq - big) ) >> 3 );
+    root = (root + value / root) >> 1;
+    root = (root + value / root) >> 1;
+    while (root * root > value)
+    {
+        root--;
+    }
+    while ( (root + 1) * (root + 1) <= value )
+    {
+        root++;
+    }
+    return (uint16_t)root;
+}
+
+int16_t
+whd_csi_phase(int32_t i, int32_t q)
+{
+    uint32_t ai = (uint32_t)( (i < 0) ? -i : i );
+    uint32_t aq = (uint32_t)( (q < 0) ? -q : q );
+    int32_t z, t, angle;
+
+    if ( (ai == 0) && (aq == 0) )
+    {
+        return 0;
+    }
+
+    /* Fold into the first octant, z = min / max in Q15 */
+    z = (int32_t)( ( (aq <= ai) ? (aq << 15) / ai : (ai << 15) / aq ) );
+    t = (z * (32768 - z) ) >> 15;
+    angle = ( (z * CSI_PHASE_EIGHTH) >> 15 ) + ( (t * (CSI_ATAN_C0 + ( (CSI_ATAN_C1 * z) >> 15 ) ) ) >> 15 );
+    if (aq > ai)
+    {
+        angle = CSI_PHASE_QUARTER - angle;
+    }
+    if (i < 0)
+    {
+        angle = WHD_CSI_PHASE_PI - angle;
+    }
+    if (q < 0)
+    {
+        angle = -angle;
+    }
+    return (int16_t)angle;
+}
+
+void
+whd_csi_phase_sanitize(int16_t *phase, int32_t *unwrapped, uint32_t num)
+{
+    int32_t mean = 0;
+    int32_t span, k;
+
+    if (num == 0)
+    {
+        return;
+    }
+
+    /* Steps between neighbours are taken as the shortest way round, which int16_t wraps to */
+    unwrapped[0] = phase[0];
+    mean = phase[0];
+    for (k = 1; k < (int32_t)num; k++)
+    {
+        unwrapped[k] = unwrapped[k - 1] + (int16_t)(phase[k] - phase[k - 1]);
+        mean += unwrapped[k];
+    }
+    mean /= (int32_t)num;
+
+    /* Subtract slope * (k - centre) with slope = span / (num - 1), kept in integers by doubling */
+    span = (num > 1) ? (unwrapped[num - 1] - unwrapped[0]) : 0;
+    for (k = 0; k < (int32_t)num; k++)
+    {
+        int32_t offset = (num > 1) ? (span * (2 * k - ( (int32_t)num - 1 ) ) ) / (2 * ( (int32_t)num - 1 ) ) : 0;
+        phase[k] = (int16_t)(unwrapped[k] - mean - offset);
+    }
+}
+
+static void
+whd_csi_features_reset(whd_csi_features_engine_t *engine)
+{
+    whd_mem_memset(engine->hist, 0, sizeof(engine->hist) );
+    whd_mem_memset(engine->sum, 0, sizeof(engine->sum) );
+    whd_mem_memset(engine->sum_sq, 0, sizeof(engine->sum_sq) );
+    engine->fill = 0;
+    engine->pos = 0;
+    engine->since_vector = 0;
+}
+
+whd_result_t
+whd_csi_features_engine_init(whd_csi_features_engine_t *engine, const whd_csi_features_config_t *config)
+{
+    if ( (engine == NULL) || (config == NULL) )
+    {
+        return WHD_BADARG;
+    }
+    if ( (config->sample_format > WHD_CSI_SAMPLE_INT8) || (config->window > WHD_CSI_FEATURES_MAX_WINDOW) )
+    {
+        WPRINT_WHD_ERROR(("%s: Unsupported sample format %u or window %u\n", __func__,
+                          config->sample_format, config->window));
+        return WHD_BADARG;
+    }
+
+    whd_mem_memset(engine, 0, sizeof(*engine) );
+    engine->config = *config;
+    if (engine->config.decimation == 0)
+    {
+        engine->config.decimation = 1;
+    }
+    if (engine->config.window == 0)
+    {
+        engine->config.window = WHD_CSI_FEATURES_MAX_WINDOW;
+    }
+    if (engine->config.vector_interval == 0)
+    {
+        engine->config.vector_interval = 1;
+    }
+    engine->vector.amp_mean = engine->amp_mean;
+    engine->vector.amp_var = engine->amp_var;
+    engine->vector.phase = engine->phase;
+    return WHD_SUCCESS;
+}
+
+whd_bool_t
+whd_csi_features_engine_process(whd_csi_features_engine_t *engine, const whd_mac_t *source, uint8_t sequence_num,
+                                const uint8_t *report, uint32_t len)
+{
+    const whd_csi_features_config_t *config = &engine->config;
+    uint32_t sample_size = (config->sample_format == WHD_CSI_SAMPLE_INT16) ? 4 : 2;
+    uint32_t num_subcarriers, stride, kept, k;
+    uint32_t window = config->window;
+    uint64_t motion = 0;
+    const uint8_t *sample;
+    int32_t i, q;
+
+    if (len < config->data_offset)
+    {
+        engine->stats.short_reports++;
+        return WHD_FALSE;
+    }
+    num_subcarriers = config->num_subcarriers;
+    if (num_subcarriers == 0)
+    {
+        num_subcarriers = (len - config->data_offset) / sample_size;
+    }
+    if ( (num_subcarriers == 0) || (len - config->data_offset < num_subcarriers * sample_size) )
+    {
+        engine->stats.short_reports++;
+        return WHD_FALSE;
+    }
+    kept = (num_subcarriers + config->decimation - 1) / config->decimation;
+    if (kept > WHD_CSI_FEATURES_MAX_SUBCARRIERS)
+    {
+        kept = WHD_CSI_FEATURES_MAX_SUBCARRIERS;
+    }
+    if (kept != engine->kept)
+    {
+        /* A different bandwidth; the old windows do not line up with the new subcarriers */
+        if (engine->kept != 0)
+        {
+            engine->stats.resets++;
+        }
+        whd_csi_features_reset(engine);
+        engine->kept = (uint16_t)kept;
+    }
+
+    engine->stats.reports++;
+    engine->stats.bytes_in += num_subcarriers * sample_size;
+    stride = config->decimation * sample_size;
+    sample = report + config->data_offset;
+    for (k = 0; k < kept; k++, sample += stride)
+    {
+        uint16_t amp;
+
+        if (config->sample_format == WHD_CSI_SAMPLE_INT16)
+        {
+            i = (int16_t)(sample[0] | (sample[1] << 8) );
+            q = (int16_t)(sample[2] | (sample[3] << 8) );
+        }
+        else
+        {
+            i = (int8_t)sample[0];
+            q = (int8_t)sample[1];
+        }
+        amp = whd_csi_amplitude(i, q);
+        engine->phase[k] = whd_csi_phase(i, q);
+
+        if (engine->fill == window)
+        {
+            uint16_t old = engine->hist[k][engine->pos];
+            engine->sum[k] -= old;
+            engine->sum_sq[k] -= (uint64_t)old * old;
+        }
+        engine->hist[k][engine->pos] = amp;
+        engine->sum[k] += amp;
+        engine->sum_sq[k] += (uint64_t)amp * amp;
+    }
+    if (engine->fill < window)
+    {
+        engine->fill++;
+    }
+    engine->pos = (uint16_t)( (engine->pos + 1) % window );
+
+    if (++engine->since_vector < config->vector_interval)
+    {
+        return WHD_FALSE;
+    }
+    engine->since_vector = 0;
+
+    for (k = 0; k < kept; k++)
+    {
+        uint64_t n = engine->fill;
+        uint64_t sum = engine->sum[k];
+
+        engine->amp_mean[k] = (uint16_t)( (sum + n / 2) / n );
+        engine->amp_var[k] = (uint32_t)( (engine->sum_sq[k] * n - sum * sum) / (n * n) );
+        motion += engine->amp_var[k];
+    }
+    whd_csi_phase_sanitize(engine->phase, engine->unwrapped, kept);
+
+    if (source != NULL)
+    {
+        engine->vector.source = *source;
+    }
+    engine->vector.sequence_num = sequence_num;
+    engine->vector.num_subcarriers = (uint16_t)kept;
+    engine->vector.window_fill = engine->fill;
+    engine->vector.motion = (uint32_t)(motion / kept);
+    engine->stats.vectors++;
+    engine->stats.bytes_out += kept * (uint32_t)CSI_FEATURE_BYTES;
+    return WHD_TRUE;
+}
+
+#endif /* defined(COMPONENT_WLANSENSE) */
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file whd_wlansense_features.h
+ *  Turns CSI reports into compact feature vectors.
+ *
+ *  Every complex sample of the kept subcarriers is converted to an amplitude and a phase in
+ *  fixed point. The phase is unwrapped across the subcarriers and its linear part (timing and
+ *  frequency offset) removed. The amplitudes feed a rolling window per subcarrier, from which
+ *  the mean and variance are taken. One feature vector is made every vector_interval reports.
+ *
+ *  The driver does not know the layout of the firmware's report, so the offset of the CSI
+ *  matrix and the sample format are part of the configuration.
+ *
+ *  The engine has no driver state and can be fed recorded reports on the host.
+ */
+
+#if defined(COMPONENT_WLANSENSE)
+#ifndef INCLUDED_WHD_WLANSENSE_FEATURES_H
+#define INCLUDED_WHD_WLANSENSE_FEATURES_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "whd.h"
+#include "whd_types.h"
+
+
+/* Most subcarriers kept after decimation; further ones are ignored */
+#ifndef WHD_CSI_FEATURES_MAX_SUBCARRIERS
+#define WHD_CSI_FEATURES_MAX_SUBCARRIERS    (64)
+#endif
+
+/* Longest rolling window, in reports */
+#ifndef WHD_CSI_FEATURES_MAX_WINDOW
+#define WHD_CSI_FEATURES_MAX_WINDOW         (16)
+#endif
+
+/* Sample formats: I then Q, little endian, signed */
+#define WHD_CSI_SAMPLE_INT16                (0)
+#define WHD_CSI_SAMPLE_INT8                 (1)
+
+/* Phases are binary angles: a full turn is 65536, so 32768 is pi and they wrap as int16_t */
+#define WHD_CSI_PHASE_PI                    (32768)
+
+/** CSI feature extraction settings */
+typedef struct whd_csi_features_config
+{
+    uint16_t data_offset;       /**< Bytes of report header before the CSI matrix */
+    uint16_t num_subcarriers;   /**< Subcarriers in the matrix, 0 for as many as the report holds */
+    uint8_t sample_format;      /**< WHD_CSI_SAMPLE_* */
+    uint8_t decimation;         /**< Keep every n-th subcarrier, 0 or 1 for all */
+    uint8_t window;             /**< Reports in the rolling window, 1 to WHD_CSI_FEATURES_MAX_WINDOW; 0 for the maximum */
+    uint8_t vector_interval;    /**< Reports per feature vector, 0 or 1 for one per report */
+    whd_bool_t send_raw;        /**< Still send the raw reports up through the callback or ring */
+} whd_csi_features_config_t;
+
+/** A feature vector. The arrays belong to the engine and are valid until the next report. */
+typedef struct whd_csi_features
+{
+    whd_mac_t source;           /**< Address of the newest report */
+    uint8_t sequence_num;       /**< Sequence number of the newest report */
+    uint16_t num_subcarriers;   /**< Entries in each array */
+    uint16_t window_fill;       /**< Reports the statistics cover, up to the window */
+    uint32_t motion;            /**< Mean of the amplitude variances, a rough motion score */
+    const uint16_t *amp_mean;   /**< Mean amplitude per kept subcarrier */
+    const uint32_t *amp_var;    /**< Amplitude variance per kept subcarrier */
+    const int16_t *phase;       /**< Sanitised phase of the newest report per kept subcarrier */
+} whd_csi_features_t;
+
+/** Callback run on the WHD thread with each feature vector; it must not block
+ *
+ * @param features: Feature vector
+ * @param user_data: Pointer given with the configuration
+ *
+ */
+typedef void (*whd_csi_features_cb)(const whd_csi_features_t *features, void *user_data);
+
+/** CSI feature extraction counters */
+typedef struct whd_csi_features_stats
+{
+    uint32_t reports;           /**< Reports processed */
+    uint32_t vectors;           /**< Feature vectors made */
+    uint32_t short_reports;     /**< Reports too short for the configured layout, ignored */
+    uint32_t resets;            /**< Windows restarted because the subcarrier count changed */
+    uint32_t bytes_in;          /**< CSI matrix bytes processed */
+    uint32_t bytes_out;         /**< Feature vector bytes made */
+} whd_csi_features_stats_t;
+
+typedef struct whd_csi_features_engine
+{
+    whd_csi_features_config_t config;
+    uint16_t kept;              /* Subcarriers kept from the current layout */
+    uint16_t fill;
+    uint16_t pos;               /* Window entry the next report overwrites */
+    uint8_t since_vector;
+    uint16_t hist[WHD_CSI_FEATURES_MAX_SUBCARRIERS][WHD_CSI_FEATURES_MAX_WINDOW];
+    uint32_t sum[WHD_CSI_FEATURES_MAX_SUBCARRIERS];
+    uint64_t sum_sq[WHD_CSI_FEATURES_MAX_SUBCARRIERS];
+    int32_t unwrapped[WHD_CSI_FEATURES_MAX_SUBCARRIERS];
+    uint16_t amp_mean[WHD_CSI_FEATURES_MAX_SUBCARRIERS];
+    uint32_t amp_var[WHD_CSI_FEATURES_MAX_SUBCARRIERS];
+    int16_t phase[WHD_CSI_FEATURES_MAX_SUBCARRIERS];
+    whd_csi_features_t vector;
+    whd_csi_features_stats_t stats;
+} whd_csi_features_engine_t;
+
+
+/******************************************************
+*             Function declarations
+******************************************************/
+
+/** Magnitude of a complex sample, rounded down.
+ *
+ * @param i:                    In-phase part, a 16 bit sample
+ * @param q:                    Quadrature part, a 16 bit sample
+ *
+ * @return uint16_t:            sqrt(i * i + q * q)
+ */
+extern uint16_t whd_csi_amplitude(int32_t i, int32_t q);
+
+/** Angle of a complex sample, within about 20 units (0.002 rad).
+ *
+ * @param i:                    In-phase part, a 16 bit sample
+ * @param q:                    Quadrature part, a 16 bit sample
+ *
+ * @return int16_t:             atan2(q, i) as a binary angle, 0 for a zero sample
+ */
+extern int16_t whd_csi_phase(int32_t i, int32_t q);
+
+/** Unwraps phases across evenly spaced subcarriers and removes their linear fit through the end
+ *  points and the mean, leaving the shape of the channel.
+ *
+ * @param phase:                Binary angles, sanitised in place
+ * @param unwrapped:            num entries of scratch
+ * @param num:                  Number of subcarriers
+ *
+ * @return void:                No error code returns.
+ */
+extern void whd_csi_phase_sanitize(int16_t *phase, int32_t *unwrapped, uint32_t num);
+
+/** Starts an engine with empty windows.
+ *
+ * @param engine:               Engine state
+ * @param config:               Layout and feature settings; zero fields take their defaults
+ *
+ * @return whd_result_t:        WHD_SUCCESS, or WHD_BADARG for an unknown sample format or too long a window.
+ */
+extern whd_result_t whd_csi_features_engine_init(whd_csi_features_engine_t *engine,
+                                                 const whd_csi_features_config_t *config);
+
+/** Feeds one complete report to the engine.
+ *
+ * @param engine:               Engine state
+ * @param source:               Address the report came from
+ * @param sequence_num:         Firmware sequence number of the report
+ * @param report:               The report
+ * @param len:                  Report length
+ *
+ * @return whd_bool_t:          WHD_TRUE when engine->vector holds a new feature vector.
+ */
+extern whd_bool_t whd_csi_features_engine_process(whd_csi_features_engine_t *engine, const whd_mac_t *source,
+                                                  uint8_t sequence_num, const uint8_t *report, uint32_t len);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* ifndef INCLUDED_WHD_WLANSENSE_FEATURES_H */
+#endif /* defined(COMPONENT_WLANSENSE) */
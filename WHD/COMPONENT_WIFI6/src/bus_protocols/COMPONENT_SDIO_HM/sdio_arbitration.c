@@ -57,8 +57,11 @@ struct ip_session {
 };
 typedef struct ip_session ip_session_t;
 
-static bool sdio_arb_query_ip_session(ip_addr_t *local_ip, ip_addr_t *remote_ip,
+static bool sdio_arb_query_ip_session(sdio_arb_t arb, ip_addr_t *local_ip, ip_addr_t *remote_ip,
                          uint16_t sport, uint16_t dport, uint16_t icmp_hash, uint8_t tos, bool update_time);
+#ifdef SDIO_HM_TRACK_SESSION
+static cy_rslt_t sdio_arb_network_timer_init(sdio_arb_t arb);
+#endif
 
 struct arp_request {
     uint8_t shwaddr[MAC_ADDR_LEN];
@@ -69,17 +72,15 @@ struct arp_request {
 };
 typedef struct arp_request arp_request_t;
 
-cy_timer_t sdio_arb_timer;
-cy_mutex_t sdio_arb_mutex;
-
-ip_session_t *g_ip_session = NULL;
-int ip_session_number = 0;
-arp_request_t g_arp_rq[ARP_TABLE_LIST_NUM] = {0};
-struct eth_addr local_eth_addr;
-int g_whitelist_port[WHITE_LIST_PORT_MAX] = {0};
-int g_whitelist_port_num = 0;
-
-int sdio_arb_inited = 0;
+struct sdio_arb_info {
+    cy_timer_t timer;
+    cy_mutex_t mutex;
+    ip_session_t *ip_session;
+    int ip_session_number;
+    arp_request_t arp_rq[ARP_TABLE_LIST_NUM];
+    int whitelist_port[WHITE_LIST_PORT_MAX];
+    int whitelist_port_num;
+};
 
 static bool is_eth_multicast(uint8_t *dest)
 {
@@ -89,24 +90,24 @@ static bool is_eth_multicast(uint8_t *dest)
     return false;
 }
 
-cy_rslt_t sdio_arb_mutex_init()
+static cy_rslt_t sdio_arb_mutex_init(sdio_arb_t arb)
 {
-    return cy_rtos_mutex_init(&sdio_arb_mutex, 1);
+    return cy_rtos_mutex_init(&arb->mutex, 1);
 }
 
-cy_rslt_t sdio_arb_mutex_deinit()
+static cy_rslt_t sdio_arb_mutex_deinit(sdio_arb_t arb)
 {
-    return cy_rtos_mutex_deinit(&sdio_arb_mutex);
+    return cy_rtos_mutex_deinit(&arb->mutex);
 }
 
-static cy_rslt_t sdio_arb_mutex_lock()
+static cy_rslt_t sdio_arb_mutex_lock(sdio_arb_t arb)
 {
-    return cy_rtos_mutex_get(&sdio_arb_mutex, CY_RTOS_NEVER_TIMEOUT);
+    return cy_rtos_mutex_get(&arb->mutex, CY_RTOS_NEVER_TIMEOUT);
 }
 
-static cy_rslt_t sdio_arb_mutex_unlock()
+static cy_rslt_t sdio_arb_mutex_unlock(sdio_arb_t arb)
 {
-    return cy_rtos_mutex_set(&sdio_arb_mutex);
+    return cy_rtos_mutex_set(&arb->mutex);
 }
 
 char *ip4addr_ntoa_r(const ip4_addr_t *addr, char *buf, int buflen)
@@ -173,16 +174,16 @@ static uint32_t ghash_key(ip_addr_t *sip, ip_addr_t *dip, uint16_t sport, uint16
     return hash_key;
 }
 
-int sdio_arb_add_ip_session(ip_addr_t *local_ip, ip_addr_t *remote_ip,
+static int sdio_arb_add_ip_session(sdio_arb_t arb, ip_addr_t *local_ip, ip_addr_t *remote_ip,
                         uint16_t sport, uint16_t dport, uint16_t icmp_hash, uint8_t tos)
 {
     ip_session_t *ip_ses;
     cy_time_t cur_time;
 
-    if (sdio_arb_query_ip_session(local_ip, remote_ip, sport, dport, icmp_hash, tos, 1)) {
+    if (sdio_arb_query_ip_session(arb, local_ip, remote_ip, sport, dport, icmp_hash, tos, 1)) {
         return 0;
     }
-    if (ip_session_number > SESSION_NUMBER_MAX) {
+    if (arb->ip_session_number > SESSION_NUMBER_MAX) {
         return -1;
     }
     ip_ses = whd_mem_malloc(sizeof(ip_session_t));
@@ -199,28 +200,28 @@ int sdio_arb_add_ip_session(ip_addr_t *local_ip, ip_addr_t *remote_ip,
     ip_ses->time = cur_time;
     ip_ses->hash_key = ghash_key(local_ip, remote_ip, sport, dport, icmp_hash, tos);
     ip_ses->next = NULL;
-    sdio_arb_mutex_lock();
+    sdio_arb_mutex_lock(arb);
 
-    if (g_ip_session == NULL) {
-        g_ip_session = ip_ses;
+    if (arb->ip_session == NULL) {
+        arb->ip_session = ip_ses;
     } else {
-        ip_ses->next = g_ip_session;
-        g_ip_session = ip_ses;
+        ip_ses->next = arb->ip_session;
+        arb->ip_session = ip_ses;
     }
-    ip_session_number += 1;
+    arb->ip_session_number += 1;
 
-    PRINT_HM_DEBUG(("snet session number:%d.\n", ip_session_number));
-    sdio_arb_mutex_unlock();
+    PRINT_HM_DEBUG(("snet session number:%d.\n", arb->ip_session_number));
+    sdio_arb_mutex_unlock(arb);
     return 0;
 }
 
-int sdio_arb_del_ip_session(ip_session_t *del_ip_ses)
+static int sdio_arb_del_ip_session(sdio_arb_t arb, ip_session_t *del_ip_ses)
 {
     ip_session_t *ip_ses, *pre_ip_ses;
     bool find_session = false;
 
-    sdio_arb_mutex_lock();
-    pre_ip_ses = ip_ses = g_ip_session;
+    sdio_arb_mutex_lock(arb);
+    pre_ip_ses = ip_ses = arb->ip_session;
 
     while(ip_ses) {
         if (ip_ses->hash_key == del_ip_ses->hash_key)	{
@@ -231,21 +232,21 @@ int sdio_arb_del_ip_session(ip_session_t *del_ip_ses)
         ip_ses = ip_ses->next;
     }
     if (find_session) {
-        if (ip_ses == g_ip_session) {
-            g_ip_session = ip_ses->next;
+        if (ip_ses == arb->ip_session) {
+            arb->ip_session = ip_ses->next;
         } else {
             pre_ip_ses->next = ip_ses->next;
         }
 
         ip_ses->next = NULL;
-        free(ip_ses);
-        ip_session_number -= 1;
+        whd_mem_free(ip_ses);
+        arb->ip_session_number -= 1;
     }
-    sdio_arb_mutex_unlock();
+    sdio_arb_mutex_unlock(arb);
     return 0;
 }
 
-static bool sdio_arb_query_ip_session(ip_addr_t *local_ip, ip_addr_t *remote_ip,
+static bool sdio_arb_query_ip_session(sdio_arb_t arb, ip_addr_t *local_ip, ip_addr_t *remote_ip,
                          uint16_t sport, uint16_t dport, uint16_t icmp_hash, uint8_t tos, bool update_time)
 {
     ip_session_t *ip_ses;
@@ -254,8 +255,8 @@ static bool sdio_arb_query_ip_session(ip_addr_t *local_ip, ip_addr_t *remote_ip,
     uint32_t hash_key = 0;
 
     hash_key = ghash_key(local_ip, remote_ip, sport, dport, icmp_hash, tos);
-    sdio_arb_mutex_lock();
-    ip_ses = g_ip_session;
+    sdio_arb_mutex_lock(arb);
+    ip_ses = arb->ip_session;
 
     while(ip_ses) {
         if (ip_ses->hash_key == hash_key) {
@@ -269,30 +270,30 @@ static bool sdio_arb_query_ip_session(ip_addr_t *local_ip, ip_addr_t *remote_ip,
              /* For ICMP packet, remove the IP session immediately, otherwise it will affect ping from the device,
                 as the session is cached until the session got deleted,
                 ICMP will be forwarded to Linux hosts(though ICMP intiated by Device). So delete ICMP session immedaitely */
-                sdio_arb_del_ip_session(ip_ses);
+                sdio_arb_del_ip_session(arb, ip_ses);
             }
             break;
         }
         ip_ses = ip_ses->next;
     }
-    sdio_arb_mutex_unlock();
+    sdio_arb_mutex_unlock(arb);
     return is_present;
 }
 
-void sdio_arb_print_ip_session()
+void sdio_arb_print_ip_session(sdio_arb_t arb)
 {
-    PRINT_HM_DEBUG(("=== current ip session number:%d ===\n", ip_session_number));
+    PRINT_HM_DEBUG(("=== current ip session number:%d ===\n", arb->ip_session_number));
     ip_session_t *ip_ses;
-    sdio_arb_mutex_lock();
-    ip_ses = g_ip_session;
+    sdio_arb_mutex_lock(arb);
+    ip_ses = arb->ip_session;
     while(ip_ses) {
         ip_ses = ip_ses->next;
     }
 
-    sdio_arb_mutex_unlock();
+    sdio_arb_mutex_unlock(arb);
 }
 
-void sdio_arb_update_arp_table(void)
+static void sdio_arb_update_arp_table(sdio_arb_t arb)
 {
     cy_time_t cur_time;
     int i;
@@ -301,15 +302,15 @@ void sdio_arb_update_arp_table(void)
 
     for (i = 0; i < ARP_TABLE_LIST_NUM; i ++)
     {
-        if (g_arp_rq[i].time && cur_time - g_arp_rq[i].time > SESSION_TIMEOUT) {
-            PRINT_HM_DEBUG(("[%s:%d] Clear ARP request dipaddr:%s\n", __func__, __LINE__, ip4addr_ntoa(&g_arp_rq[i].dipaddr)));
-            whd_mem_memset(&g_arp_rq[i], 0x0, sizeof(arp_request_t));
+        if (arb->arp_rq[i].time && cur_time - arb->arp_rq[i].time > SESSION_TIMEOUT) {
+            PRINT_HM_DEBUG(("[%s:%d] Clear ARP request dipaddr:%s\n", __func__, __LINE__, ip4addr_ntoa(&arb->arp_rq[i].dipaddr)));
+            whd_mem_memset(&arb->arp_rq[i], 0x0, sizeof(arp_request_t));
         }
     }
 
 }
 
-int sdio_arb_query_arp_request(struct etharp_hdr *arp)
+static int sdio_arb_query_arp_request(sdio_arb_t arb, struct etharp_hdr *arp)
 {
     int i;
     bool is_find = false;
@@ -321,14 +322,14 @@ int sdio_arb_query_arp_request(struct etharp_hdr *arp)
     PRINT_HM_DEBUG(("arp->dhwaddr:%02x:%02x:%02x:%02x:%02x:%02x\n",
         arp->dhwaddr.addr[0],arp->dhwaddr.addr[1],arp->dhwaddr.addr[2],arp->dhwaddr.addr[3],arp->dhwaddr.addr[4],arp->dhwaddr.addr[5]));
     PRINT_HM_DEBUG(("arp->dipaddr:%s\n", ip4addr_ntoa((ip4_addr_t *)&arp->dipaddr.addrw)));
-    sdio_arb_mutex_lock();
+    sdio_arb_mutex_lock(arb);
     if (hton16(arp->opcode) == ARP_REQUEST) {
         for (i = 0; i < ARP_TABLE_LIST_NUM; i ++) {
-            if ((g_arp_rq[i].time) &&
-                !memcmp(&g_arp_rq[i].shwaddr, (uint8_t *)&arp->shwaddr.addr, MAC_ADDR_LEN) &&
-                ip4_addr_cmp(&g_arp_rq[i].sipaddr, (ip4_addr_t *)&arp->sipaddr.addrw) &&
-                !memcmp(&g_arp_rq[i].dhwaddr, (uint8_t *)&arp->dhwaddr.addr, MAC_ADDR_LEN) &&
-                ip4_addr_cmp(&g_arp_rq[i].dipaddr, (ip4_addr_t *)&arp->dipaddr.addrw)) {
+            if ((arb->arp_rq[i].time) &&
+                !memcmp(&arb->arp_rq[i].shwaddr, (uint8_t *)&arp->shwaddr.addr, MAC_ADDR_LEN) &&
+                ip4_addr_cmp(&arb->arp_rq[i].sipaddr, (ip4_addr_t *)&arp->sipaddr.addrw) &&
+                !memcmp(&arb->arp_rq[i].dhwaddr, (uint8_t *)&arp->dhwaddr.addr, MAC_ADDR_LEN) &&
+                ip4_addr_cmp(&arb->arp_rq[i].dipaddr, (ip4_addr_t *)&arp->dipaddr.addrw)) {
                 is_find = true;
                 break;
             }
@@ -336,14 +337,14 @@ int sdio_arb_query_arp_request(struct etharp_hdr *arp)
     } else if (hton16(arp->opcode) == ARP_REPLY) {
 
         for (i = 0; i < ARP_TABLE_LIST_NUM; i ++) {
-            if (g_arp_rq[i].time &&
-                ip4_addr_cmp(&g_arp_rq[i].dipaddr, (ip4_addr_t *)&arp->sipaddr.addrw) &&
-                ip4_addr_cmp(&g_arp_rq[i].sipaddr, (ip4_addr_t *)&arp->dipaddr.addrw) &&
-                !memcmp(&g_arp_rq[i].shwaddr, (uint8_t *)&arp->dhwaddr.addr, MAC_ADDR_LEN)) {
+            if (arb->arp_rq[i].time &&
+                ip4_addr_cmp(&arb->arp_rq[i].dipaddr, (ip4_addr_t *)&arp->sipaddr.addrw) &&
+                ip4_addr_cmp(&arb->arp_rq[i].sipaddr, (ip4_addr_t *)&arp->dipaddr.addrw) &&
+                !memcmp(&arb->arp_rq[i].shwaddr, (uint8_t *)&arp->dhwaddr.addr, MAC_ADDR_LEN)) {
                 is_find = true;
                 /* arp have replay, del it */
-                PRINT_HM_DEBUG(("[%s:%d] Find arp quest: dipaddr:%s opcode:%d\n", __func__, __LINE__, ip4addr_ntoa(&g_arp_rq[i].dipaddr), hton16(arp->opcode)));
-                whd_mem_memset(&g_arp_rq[i], 0x0, sizeof(arp_request_t));
+                PRINT_HM_DEBUG(("[%s:%d] Find arp quest: dipaddr:%s opcode:%d\n", __func__, __LINE__, ip4addr_ntoa(&arb->arp_rq[i].dipaddr), hton16(arp->opcode)));
+                whd_mem_memset(&arb->arp_rq[i], 0x0, sizeof(arp_request_t));
                 break;
             }
         }
@@ -352,17 +353,17 @@ int sdio_arb_query_arp_request(struct etharp_hdr *arp)
         /* Clear the timedout ARP entries, if the ARP arb table entries reached max
            if SDIO_HM_TRACK_SESSION is defined, then arb timer take care of clear the table */
         if (i == ARP_TABLE_LIST_NUM) {
-            sdio_arb_update_arp_table();
+            sdio_arb_update_arp_table(arb);
         }
 #endif /* SDIO_HM_TRACK_SESSION */
 
     }
-    sdio_arb_mutex_unlock();
+    sdio_arb_mutex_unlock(arb);
 
     return is_find;
 }
 
-int sdio_arb_add_arp_request(struct etharp_hdr *arp)
+static int sdio_arb_add_arp_request(sdio_arb_t arb, struct etharp_hdr *arp)
 {
     int i = 0;
     bool is_add = false;
@@ -371,69 +372,98 @@ int sdio_arb_add_arp_request(struct etharp_hdr *arp)
     if (hton16(arp->opcode) != ARP_REQUEST) {
         return -1;
     }
-    if (sdio_arb_query_arp_request(arp)) {
+    if (sdio_arb_query_arp_request(arb, arp)) {
         return 0;
     }
-    sdio_arb_mutex_lock();
+    sdio_arb_mutex_lock(arb);
 
     for (i = 0; i < ARP_TABLE_LIST_NUM; i ++) {
-        if (g_arp_rq[i].time == 0) {
+        if (arb->arp_rq[i].time == 0) {
             is_add = true;
             break;
         }
     }
     if (is_add) {
-        whd_mem_memcpy(&g_arp_rq[i].shwaddr, (uint8_t *)&arp->shwaddr, MAC_ADDR_LEN);
-        ip4_addr_set(&g_arp_rq[i].sipaddr, (ip4_addr_t *)arp->sipaddr.addrw);
-        whd_mem_memcpy(&g_arp_rq[i].dhwaddr, (uint8_t *)&arp->dhwaddr, MAC_ADDR_LEN);
-        ip4_addr_set(&g_arp_rq[i].dipaddr, (ip4_addr_t *)arp->dipaddr.addrw);
+        whd_mem_memcpy(&arb->arp_rq[i].shwaddr, (uint8_t *)&arp->shwaddr, MAC_ADDR_LEN);
+        ip4_addr_set(&arb->arp_rq[i].sipaddr, (ip4_addr_t *)arp->sipaddr.addrw);
+        whd_mem_memcpy(&arb->arp_rq[i].dhwaddr, (uint8_t *)&arp->dhwaddr, MAC_ADDR_LEN);
+        ip4_addr_set(&arb->arp_rq[i].dipaddr, (ip4_addr_t *)arp->dipaddr.addrw);
         cy_rtos_get_time(&cur_time);
-        g_arp_rq[i].time = cur_time;
-        PRINT_HM_DEBUG(("[%s:%d] Add ARP request[%d] target ip:%s time:%u\n", __func__, __LINE__, i, ip4addr_ntoa(&g_arp_rq[i].dipaddr),
-            g_arp_rq[i].time));
+        arb->arp_rq[i].time = cur_time;
+        PRINT_HM_DEBUG(("[%s:%d] Add ARP request[%d] target ip:%s time:%u\n", __func__, __LINE__, i, ip4addr_ntoa(&arb->arp_rq[i].dipaddr),
+            arb->arp_rq[i].time));
     } else {
         HM_INFO_MSG(("[%s:%d] ARP request list is full\n", __func__, __LINE__));
     }
-    sdio_arb_mutex_unlock();
+    sdio_arb_mutex_unlock(arb);
     return 0;
 }
 
-void sdio_arb_network_init()
+cy_rslt_t sdio_arb_network_init(sdio_arb_t *arb_out)
 {
-    if (sdio_arb_inited) {
+    sdio_arb_t arb;
+    cy_rslt_t result;
+
+    if (*arb_out != NULL) {
         HM_INFO_MSG(("WARING: SNET have inited\n"));
-        return ;
+        return CY_RSLT_SUCCESS;
+    }
+    arb = (sdio_arb_t)whd_mem_malloc(sizeof(*arb));
+    if (!arb) {
+        PRINT_HM_ERROR(("[%s:%d] malloc buffer failed\n", __func__, __LINE__));
+        return CY_RTOS_NO_MEMORY;
+    }
+    whd_mem_memset(arb, 0, sizeof(*arb));
+
+    result = sdio_arb_mutex_init(arb);
+    if (result != CY_RSLT_SUCCESS) {
+        whd_mem_free(arb);
+        return result;
     }
-    sdio_arb_mutex_init();
 #ifdef SDIO_HM_TRACK_SESSION
-    sdio_arb_network_timer_init();
+    result = sdio_arb_network_timer_init(arb);
+    if (result != CY_RSLT_SUCCESS) {
+        sdio_arb_mutex_deinit(arb);
+        whd_mem_free(arb);
+        return result;
+    }
 #endif
-    sdio_arb_inited = 1;
+    *arb_out = arb;
+    return CY_RSLT_SUCCESS;
 }
 
-void sdio_arb_network_deinit()
+void sdio_arb_network_deinit(sdio_arb_t arb)
 {
-    if (sdio_arb_inited) {
+    ip_session_t *ip_ses;
+
+    if (arb == NULL) {
+        return;
+    }
 #ifdef SDIO_HM_TRACK_SESSION
-        sdio_arb_network_timer_stop();
-        cy_rtos_deinit_timer(&sdio_arb_timer);
+    sdio_arb_network_timer_stop(arb);
+    cy_rtos_deinit_timer(&arb->timer);
 #endif
-        sdio_arb_mutex_deinit();
+    while (arb->ip_session) {
+        ip_ses = arb->ip_session;
+        arb->ip_session = ip_ses->next;
+        whd_mem_free(ip_ses);
     }
-    sdio_arb_inited = 0;
+    sdio_arb_mutex_deinit(arb);
+    whd_mem_free(arb);
 }
 
 #ifdef SDIO_HM_TRACK_SESSION
 static void *sdio_arb_timer_callback(void* arg)
 {
+    sdio_arb_t arb = (sdio_arb_t)arg;
     ip_session_t *ip_ses, *pre_ip_ses;
     cy_time_t cur_time;
     bool del_session;
 
     cy_rtos_get_time(&cur_time);
 
-    sdio_arb_mutex_lock();
-    ip_ses = pre_ip_ses = g_ip_session;
+    sdio_arb_mutex_lock(arb);
+    ip_ses = pre_ip_ses = arb->ip_session;
 
     while (ip_ses) {
         del_session = 0;
@@ -442,106 +472,106 @@ static void *sdio_arb_timer_callback(void* arg)
             del_session = 1;
         }
         if (del_session) {
-            if (g_ip_session == ip_ses) {
-                g_ip_session = ip_ses->next;
-                pre_ip_ses = g_ip_session;
-                free(ip_ses);
-                ip_ses = g_ip_session;
+            if (arb->ip_session == ip_ses) {
+                arb->ip_session = ip_ses->next;
+                pre_ip_ses = arb->ip_session;
+                whd_mem_free(ip_ses);
+                ip_ses = arb->ip_session;
             } else {
                 pre_ip_ses->next = ip_ses->next;
-                free(ip_ses);
+                whd_mem_free(ip_ses);
                 ip_ses = pre_ip_ses->next;
             }
 
-            ip_session_number -= 1;
+            arb->ip_session_number -= 1;
         } else {
             pre_ip_ses = ip_ses;
             ip_ses = ip_ses->next;
         }
     }
-    sdio_arb_update_arp_table();
-    sdio_arb_mutex_unlock();
+    sdio_arb_update_arp_table(arb);
+    sdio_arb_mutex_unlock(arb);
 
     return NULL;
 }
 
-cy_rslt_t sdio_arb_network_timer_init()
+static cy_rslt_t sdio_arb_network_timer_init(sdio_arb_t arb)
 {
-    return cy_rtos_init_timer(&sdio_arb_timer, CY_TIMER_TYPE_PERIODIC,
-                        (cy_timer_callback_t)sdio_arb_timer_callback, (cy_timer_callback_arg_t)NULL);
+    return cy_rtos_init_timer(&arb->timer, CY_TIMER_TYPE_PERIODIC,
+                        (cy_timer_callback_t)sdio_arb_timer_callback, (cy_timer_callback_arg_t)arb);
 }
 
-void sdio_arb_network_timer_start()
+void sdio_arb_network_timer_start(sdio_arb_t arb)
 {
     bool arb_timer_state;
-    (void)cy_rtos_is_running_timer(&sdio_arb_timer, &arb_timer_state);
+    (void)cy_rtos_is_running_timer(&arb->timer, &arb_timer_state);
 
     if(!arb_timer_state)
-        cy_rtos_start_timer(&sdio_arb_timer, 5000);
+        cy_rtos_start_timer(&arb->timer, 5000);
 }
 
-void sdio_arb_network_timer_stop()
+void sdio_arb_network_timer_stop(sdio_arb_t arb)
 {
     bool arb_timer_running;
-    (void)cy_rtos_is_running_timer(&sdio_arb_timer, &arb_timer_running);
+    (void)cy_rtos_is_running_timer(&arb->timer, &arb_timer_running);
 
     if(arb_timer_running)
-        cy_rtos_stop_timer(&sdio_arb_timer);
+        cy_rtos_stop_timer(&arb->timer);
 }
 #endif /* SDIO_HM_TRACK_SESSION */
 
-static int is_in_whitelist_port(uint16_t port)
+static int is_in_whitelist_port(sdio_arb_t arb, uint16_t port)
 {
     int i;
-    if (g_whitelist_port_num == 0) {
+    if (arb->whitelist_port_num == 0) {
         return 0;
     }
-    for (i = 0; i < g_whitelist_port_num; i ++) {
-        if (g_whitelist_port[i] == port) {
+    for (i = 0; i < arb->whitelist_port_num; i ++) {
+        if (arb->whitelist_port[i] == port) {
             return 1;
         }
     }
     return 0;
 }
 
-int sdio_arb_add_whitelist_port(uint16_t port)
+int sdio_arb_add_whitelist_port(sdio_arb_t arb, uint16_t port)
 {
     int i = 0;
-    if (g_whitelist_port_num >= WHITE_LIST_PORT_MAX) {
+    if (arb->whitelist_port_num >= WHITE_LIST_PORT_MAX) {
         PRINT_HM_ERROR(("Add failed, up to %d can be set.\n", WHITE_LIST_PORT_MAX));
         return -1;
     }
-    for (i = 0; i < g_whitelist_port_num; i ++) {
-        if (g_whitelist_port[i] == port) {
+    for (i = 0; i < arb->whitelist_port_num; i ++) {
+        if (arb->whitelist_port[i] == port) {
             HM_INFO_MSG(("Port %d has add, return\n", port));
             return 0;
         }
     }
-    g_whitelist_port[g_whitelist_port_num++] = port;
-    HM_INFO_MSG(("Added white list port %d for Hosted Mode, list number:%d\n", port, g_whitelist_port_num));
+    arb->whitelist_port[arb->whitelist_port_num++] = port;
+    HM_INFO_MSG(("Added white list port %d for Hosted Mode, list number:%d\n", port, arb->whitelist_port_num));
     return 0;
 }
 
 /* if port == 0, clear all white port */
-int sdio_arb_del_whitelist_port(uint16_t port)
+int sdio_arb_del_whitelist_port(sdio_arb_t arb, uint16_t port)
 {
     int i = 0;
     if (port == 0) {
         HM_INFO_MSG(("Clear White list port\n"));
-        whd_mem_memset(g_whitelist_port, 0, sizeof(g_whitelist_port));
-        g_whitelist_port_num = 0;
+        whd_mem_memset(arb->whitelist_port, 0, sizeof(arb->whitelist_port));
+        arb->whitelist_port_num = 0;
         return 0;
     }
-    for (i = 0; i < g_whitelist_port_num; i ++) {
-        if (g_whitelist_port[i] == port) {
-            if (i != g_whitelist_port_num - 1) {
-                g_whitelist_port[i] = g_whitelist_port[g_whitelist_port_num - 1];
-                g_whitelist_port[g_whitelist_port_num - 1] = 0;
+    for (i = 0; i < arb->whitelist_port_num; i ++) {
+        if (arb->whitelist_port[i] == port) {
+            if (i != arb->whitelist_port_num - 1) {
+                arb->whitelist_port[i] = arb->whitelist_port[arb->whitelist_port_num - 1];
+                arb->whitelist_port[arb->whitelist_port_num - 1] = 0;
             } else {
-                g_whitelist_port[i] = 0;
+                arb->whitelist_port[i] = 0;
             }
-            g_whitelist_port_num -= 1;
-            HM_INFO_MSG(("Del white list port %d, list number:%d\n", port, g_whitelist_port_num));
+            arb->whitelist_port_num -= 1;
+            HM_INFO_MSG(("Del white list port %d, list number:%d\n", port, arb->whitelist_port_num));
             return 0;
         }
     }
@@ -549,21 +579,21 @@ int sdio_arb_del_whitelist_port(uint16_t port)
     return -1;
 }
 
-int sdio_arb_get_whitelist_port_num(void)
+int sdio_arb_get_whitelist_port_num(sdio_arb_t arb)
 {
-    return g_whitelist_port_num;
+    return arb->whitelist_port_num;
 }
 
-uint16_t sdio_arb_get_whitelist_port(int index)
+uint16_t sdio_arb_get_whitelist_port(sdio_arb_t arb, int index)
 {
-    if (index >= g_whitelist_port_num) {
+    if (index >= arb->whitelist_port_num) {
         return 0;
     }
-    return g_whitelist_port[index];
+    return arb->whitelist_port[index];
 }
 
 // return 0 send to bus, other drop it.
-int sdio_arb_eth_packet_send_handle(uint8_t *eth_packet, int *packet_len)
+int sdio_arb_eth_packet_send_handle(sdio_arb_t arb, uint8_t *eth_packet, int *packet_len)
 {
     uint8_t *pdata;
     struct eth_hdr *ethhdr;
@@ -590,7 +620,7 @@ int sdio_arb_eth_packet_send_handle(uint8_t *eth_packet, int *packet_len)
     *packet_len = ETHERNET_HEADER_LEN;
     PRINT_HM_DEBUG(("%s Enter...\n", __func__));
 
-    if (!sdio_arb_inited) {
+    if (!arb) {
         PRINT_HM_ERROR(("SNET Module not initialized, error.\n"));
         return -1;
     }
@@ -638,7 +668,7 @@ int sdio_arb_eth_packet_send_handle(uint8_t *eth_packet, int *packet_len)
     {
         arphdr = (struct etharp_hdr *)(pdata + ETHERNET_HEADER_LEN);
         *packet_len += ARP_PACKET_SIZE;
-        sdio_arb_add_arp_request(arphdr);
+        sdio_arb_add_arp_request(arb, arphdr);
         result = 0;
         is_unsupport = true;
     } else {
@@ -647,7 +677,7 @@ int sdio_arb_eth_packet_send_handle(uint8_t *eth_packet, int *packet_len)
     }
 
     if (!is_unsupport) {
-        result = sdio_arb_add_ip_session(&local_ip, &remote_ip, sport, dport, icmp_hash, tos);
+        result = sdio_arb_add_ip_session(arb, &local_ip, &remote_ip, sport, dport, icmp_hash, tos);
     }
     PRINT_HM_DEBUG(("%s Exit...\n", __func__));
 
@@ -655,7 +685,7 @@ int sdio_arb_eth_packet_send_handle(uint8_t *eth_packet, int *packet_len)
 }
 
 // return 1 - transfer to device, 0 -transfer to host
-bool sdio_arb_eth_packet_recv_handle(uint8_t *eth_packet)
+bool sdio_arb_eth_packet_recv_handle(sdio_arb_t arb, uint8_t *eth_packet)
 {
     uint8_t *pdata;
     struct eth_hdr *ethhdr;
@@ -678,7 +708,7 @@ bool sdio_arb_eth_packet_recv_handle(uint8_t *eth_packet)
     ether_type = ntoh16(ethhdr->type);
     PRINT_HM_DEBUG(("%s Enter...\n", __func__));
 
-    if (!sdio_arb_inited) {
+    if (!arb) {
         PRINT_HM_ERROR(("SNET Module not initialized, error.\n"));
         return -1;
     }
@@ -724,11 +754,11 @@ bool sdio_arb_eth_packet_recv_handle(uint8_t *eth_packet)
         PRINT_HM_DEBUG(("[%s:%d] recieve IPv4 packet Local IP:%s ", __func__, __LINE__, ip4addr_ntoa((const ip4_addr_t *) &iphdr->src.addr)));
         PRINT_HM_DEBUG(("Remote IP:%s.\n", ip4addr_ntoa((const ip4_addr_t *) &iphdr->dest.addr)));
         PRINT_HM_DEBUG(("Source port %d, Dest Port %d, tos:%d is_frag_more:%d\n", sport, dport, tos, is_frag_more));
-        if (dport && is_in_whitelist_port(dport)) {
+        if (dport && is_in_whitelist_port(arb, dport)) {
             is_find_session = 1;
             PRINT_HM_DEBUG(("Dest port %d is in port white list, transfer the data\n"));
         } else {
-            is_find_session = sdio_arb_query_ip_session(&remote_ip, &local_ip, dport, sport, icmp_hash, tos, 1);
+            is_find_session = sdio_arb_query_ip_session(arb, &remote_ip, &local_ip, dport, sport, icmp_hash, tos, 1);
         }
     }
     else if (ether_type == ETHTYPE_ARP)
@@ -736,7 +766,7 @@ bool sdio_arb_eth_packet_recv_handle(uint8_t *eth_packet)
         arphdr = (struct etharp_hdr *)(pdata + ETHERNET_HEADER_LEN);
         if (hton16(arphdr->opcode) == ARP_REPLY)
         {
-            is_find_session = sdio_arb_query_arp_request(arphdr);
+            is_find_session = sdio_arb_query_arp_request(arb, arphdr);
         }
     }
     else
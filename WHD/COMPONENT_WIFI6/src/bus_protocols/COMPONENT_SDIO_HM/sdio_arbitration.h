@@ -211,90 +211,109 @@ struct icmp_echo_hdr {
 #define IP_SET_TYPE(ipaddr, iptype)     do { if((ipaddr) != NULL) { IP_SET_TYPE_VAL(*(ipaddr), iptype); }}while(0)
 #define IP_GET_TYPE(ipaddr)             ((ipaddr)->type)
 
+/**
+ * Arbitration state of one SDIO hosted mode instance: the IP sessions and ARP
+ * requests the host started, and the whitelist ports.
+ */
+typedef struct sdio_arb_info *sdio_arb_t;
+
 /**
  * Init, malloc resoures.
  *
- * @return None
+ * @param[out]  arb  : set to the new arbitration state; left as is if not NULL already
+ *
+ * @return CY_RSLT_SUCCESS or failure code.
  */
-void sdio_arb_network_init();
+cy_rslt_t sdio_arb_network_init(sdio_arb_t *arb);
 
 /**
  * Deinit, free resoures.
  *
+ * @param[in]   arb  : arbitration state from sdio_arb_network_init()
+ *
  * @return None.
  */
-void sdio_arb_network_deinit();
+void sdio_arb_network_deinit(sdio_arb_t arb);
 
 #ifdef SDIO_HM_TRACK_SESSION
 /**
  * Initialize arb timer for tracking ip sessions.
  *
+ * @param[in]   arb  : arbitration state
+ *
  * @return None
  */
-void sdio_arb_network_timer_start();
+void sdio_arb_network_timer_start(sdio_arb_t arb);
 /**
  * De-initialize arb timer for tracking ip sessions.
  *
+ * @param[in]   arb  : arbitration state
+ *
  * @return None
  */
-void sdio_arb_network_timer_stop();
+void sdio_arb_network_timer_stop(sdio_arb_t arb);
 #endif /* SDIO_HM_TRACK_SESSION */
 
 /**
  * Process received packets from WiFi chip and determine where the packet is forwarded.
  *
+ * @param[in]   arb         : arbitration state
  * @param[in]   eth_packet  : the pointer address of the ethernet packet buffer
  *
  * @return 0 - forward to host side; 1 - forward to local network.
  */
-bool sdio_arb_eth_packet_recv_handle(uint8_t *eth_packet);
+bool sdio_arb_eth_packet_recv_handle(sdio_arb_t arb, uint8_t *eth_packet);
 
 /**
  * Process received packets from Host side and determine whether the packet is forwarded.
  *
+ * @param[in]   arb         : arbitration state
  * @param[in]   eth_packet  : Pointer address of the ethernet packet buffer
  * @param[out]  packet_len  : the length of the packet.
  *
  * @return 0  if the packet can forward to whd. failure code otherwise.
  */
-int sdio_arb_eth_packet_send_handle(uint8_t *eth_packet, int *packet_len);
+int sdio_arb_eth_packet_send_handle(sdio_arb_t arb, uint8_t *eth_packet, int *packet_len);
 
 /**
  * Add the whitelist port. If the TCP/UDP session destination port is in the whitelist port,
  * the session data will be transmitted to Host. Up to 16 can be set.
  *
+ * @param[in]   arb   : arbitration state
  * @param[in]   port  : the port need to add whitelist
  *
  * @return 0 success. failure code otherwise.
  */
-int sdio_arb_add_whitelist_port(uint16_t port);
+int sdio_arb_add_whitelist_port(sdio_arb_t arb, uint16_t port);
 
 /**
  * Del the whitelist port. If the port is 0, will clear
  * all whitelist port.
  *
+ * @param[in]   arb   : arbitration state
  * @param[in]   port  : the port need to del whitelist
  *
  * @return 0 success. failure code otherwise.
 */
-int sdio_arb_del_whitelist_port(uint16_t port);
+int sdio_arb_del_whitelist_port(sdio_arb_t arb, uint16_t port);
 
 /**
  * Get current whitelist port number.
  *
- * @param[in]   None
+ * @param[in]   arb   : arbitration state
  *
  * @return the nubmer of whitelist port.
 */
-int sdio_arb_get_whitelist_port_num(void);
+int sdio_arb_get_whitelist_port_num(sdio_arb_t arb);
 
 /**
  * Get index whitelist port.
  *
+ * @param[in]   arb   : arbitration state
  * @param[in]   index: the index of whitelist port.
  *
  * @return the port of whitelist port[index].
 */
-uint16_t sdio_arb_get_whitelist_port(int index);
+uint16_t sdio_arb_get_whitelist_port(sdio_arb_t arb, int index);
 
 #endif /* _SDIO_ARBITRATION_H_ */
@@ -31,6 +31,7 @@
 #include "whd_utils.h"
 #include "whd_network_if.h"
 #include "whd_buffer_api.h"
+#include "whd_debug.h"
 #include "sdio_hosted_support.h"
 #include "sdio_arbitration.h"
 
@@ -298,7 +299,7 @@ static void sdio_hm_process_ethernet_data(whd_interface_t ifp, whd_buffer_t buff
     uint16_t data_len = whd_buffer_get_current_piece_size(ifp->whd_driver, buffer);
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
-    if (!sdio_hm->sdio_instance.is_ready || sdio_arb_eth_packet_recv_handle(data))
+    if (!sdio_hm->sdio_instance.is_ready || sdio_arb_eth_packet_recv_handle(sdio_hm->arb, data))
     {
         /* forward buffer to internal network stack */
         cy_network_process_ethernet_data(ifp, buffer);
@@ -354,7 +355,7 @@ static void sdio_hm_wcm_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t
     {
         case CY_WCM_EVENT_CONNECTED:
 #ifdef SDIO_HM_TRACK_SESSION
-            sdio_arb_network_timer_start();
+            sdio_arb_network_timer_start(sdio_hm->arb);
 #endif /* SDIO_HM_TRACK_SESSION */
             nw->type = NW_EVENT_CONNECTED;
             break;
@@ -363,13 +364,13 @@ static void sdio_hm_wcm_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t
             break;
         case CY_WCM_EVENT_RECONNECTED:
 #ifdef SDIO_HM_TRACK_SESSION
-            sdio_arb_network_timer_start();
+            sdio_arb_network_timer_start(sdio_hm->arb);
 #endif /* SDIO_HM_TRACK_SESSION */
             nw->type = NW_EVENT_RECONNECTED;
             break;
         case CY_WCM_EVENT_DISCONNECTED:
 #ifdef SDIO_HM_TRACK_SESSION
-            sdio_arb_network_timer_stop();
+            sdio_arb_network_timer_stop(sdio_hm->arb);
 #endif /* SDIO_HM_TRACK_SESSION */
             nw->type = NW_EVENT_DISCONNECTED;
             nw->u.reason = event_data->reason;
@@ -791,7 +792,7 @@ static bool sdio_hm_syspm_callback(cyhal_syspm_callback_state_t state, cyhal_sys
 #ifdef SDIO_HM_TRACK_SESSION
                 if (cy_wcm_is_connected_to_ap() == WHD_TRUE)
                 {
-                    sdio_arb_network_timer_stop();
+                    sdio_arb_network_timer_stop(sdio_hm->arb);
                 }
 #endif /* SDIO_HM_TRACK_SESSION */
                 (void)sdiod_preSleep();
@@ -803,7 +804,7 @@ static bool sdio_hm_syspm_callback(cyhal_syspm_callback_state_t state, cyhal_sys
 #ifdef SDIO_HM_TRACK_SESSION
                 if (cy_wcm_is_connected_to_ap() == WHD_TRUE)
                 {
-                    sdio_arb_network_timer_start();
+                    sdio_arb_network_timer_start(sdio_hm->arb);
                 }
 #endif /* SDIO_HM_TRACK_SESSION */
                 (void)sdiod_postSleep();
@@ -827,7 +828,7 @@ static bool sdio_hm_syspm_callback(cyhal_syspm_callback_state_t state, cyhal_sys
 }
 #endif /* defined(COMPONENT_CAT5) && !defined(SDIOHM_DISABLE_PDS) */
 
-static cy_rslt_t sdio_hm_configure(sdio_handler_t *sdio_hm)
+static cy_rslt_t sdio_hm_configure(sdio_handler_t *sdio_hm, whd_driver_t whd_driver)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
     sdio_handler_t sdio_driver_tmp = NULL;
@@ -835,7 +836,7 @@ static cy_rslt_t sdio_hm_configure(sdio_handler_t *sdio_hm)
     sdio_driver_tmp = (sdio_handler_t)whd_mem_malloc(sizeof(struct sdio_handler));
     whd_mem_memset(sdio_driver_tmp, 0, sizeof(struct sdio_handler) );
 
-    sdio_driver_tmp->_sdio_dma_desc = (sdiod_dma_descs_buf_t*)whd_dmapool_alloc(SDIO_F2_DMA_BUFFER_SIZE);
+    sdio_driver_tmp->_sdio_dma_desc = (sdiod_dma_descs_buf_t*)whd_dmapool_alloc(whd_driver, SDIO_F2_DMA_BUFFER_SIZE);
 
     if (sdio_driver_tmp->_sdio_dma_desc == NULL) {
         PRINT_HM_ERROR(("whd_dmapool_alloc failed: %ld\n", result));
@@ -901,8 +902,8 @@ static cy_rslt_t sdio_hm_init_tx(sdio_handler_t sdio_hm)
     txi->tx_seq = 0;
 
     /* init snet for arbitration */
-    sdio_arb_network_init();
-    sdio_arb_add_whitelist_port(5001);
+    CHK_RET(sdio_arb_network_init(&sdio_hm->arb));
+    sdio_arb_add_whitelist_port(sdio_hm->arb, 5001);
 
     whd->network_if->whd_network_process_ethernet_data = sdio_hm_process_ethernet_data;
 
@@ -933,7 +934,7 @@ static cy_rslt_t sdio_hm_init_rx(sdio_handler_t sdio_hm)
 
 cy_rslt_t sdio_hm_init(void)
 {
-    CHK_RET(sdio_hm_configure(&sdio_hm));
+    CHK_RET(sdio_hm_configure(&sdio_hm, whd_ifs[CY_WCM_INTERFACE_TYPE_STA]->whd_driver));
 
     CY_ASSERT(NULL != sdio_hm);
 
@@ -1047,7 +1048,7 @@ static void sdio_hm_proc_data(sdio_handler_t sdio_hm, uint8_t *data, uint16_t da
     memcpy(packet, data, data_len);
 
     /* create hash value */
-    ret = sdio_arb_eth_packet_send_handle(data, (int *)&data_len);
+    ret = sdio_arb_eth_packet_send_handle(sdio_hm->arb, data, (int *)&data_len);
     if (ret)
     {
         PRINT_HM_DEBUG(("invaild packet %d\n", ret));
@@ -1203,6 +1204,21 @@ sdio_handler_t sdio_hm_get_sdio_handler()
     return sdio_hm;
 }
 
+void sdio_hm_print_resource_usage(void)
+{
+    if (sdio_hm == NULL)
+        return;
+
+    /* Only reported when the RTOS port tracks it, see CY_RTOS_HIGH_WATER */
+    whd_print_thread_stack_usage("SDIO task", &sdio_hm->thread);
+
+    if (sdio_hm->sdio_cmd == NULL)
+        return;
+
+    whd_print_thread_stack_usage("SDIO command task", &sdio_hm->sdio_cmd->thread);
+    whd_print_queue_usage("SDIO command", &sdio_hm->sdio_cmd->msgq, SDIO_CMD_QUEUE_LEN);
+}
+
 #if defined(SDIO_HM_TEST)
 static void sdio_hm_tp_start(void)
 {
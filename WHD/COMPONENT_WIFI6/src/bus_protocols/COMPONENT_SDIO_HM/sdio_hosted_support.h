@@ -128,6 +128,7 @@ struct sdio_handler
     sdio_tx_info_t tx_info;
     sdio_rx_info_t rx_info;
     sdio_command_t sdio_cmd;
+    struct sdio_arb_info *arb;
     bool sdio_thread_active;
     bool sdio_rx_timer_active;
     cyhal_gpio_t host_pwr_ctrl_gpio;
@@ -254,6 +255,7 @@ cy_rslt_t sdio_hm_reinit(void);
 cy_rslt_t sdio_hm_deinit(sdio_handler_t sdio_hm);
 cy_rslt_t sdio_hm_shutd_evt_to_host(void);
 sdio_handler_t sdio_hm_get_sdio_handler();
+void sdio_hm_print_resource_usage(void);
 cy_rslt_t sdio_hm_set_host_power_control_gpio(cyhal_gpio_t gpio);
 
 #endif /* _SDIO_HOSTED_SUPPORT_H_ */
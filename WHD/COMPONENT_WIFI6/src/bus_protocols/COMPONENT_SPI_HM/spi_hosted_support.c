@@ -18,6 +18,7 @@
 #if defined(COMPONENT_SPI_HM)
 
 #include "spi_hosted_support.h"
+#include "whd_debug.h"
 
 /******************************************************************************
 * MACROS/Preprocessors
@@ -149,6 +150,17 @@ cy_rslt_t spi_hm_deinit (void)
     return WHD_SUCCESS;
 }
 
+void spi_hm_print_resource_usage (void)
+{
+    spi_hm_handler_t spi_handler = spi_hm_get_main_handler();
+
+    if (spi_handler == NULL)
+        return;
+
+    /* Only reported when the RTOS port tracks it, see CY_RTOS_HIGH_WATER */
+    whd_print_thread_stack_usage("SPI task", &spi_handler->spi_task);
+}
+
 static uint32_t spi_hm_pyld_send (spi_hm_handler_t spi_hm_send, const uint8_t *tx_buffer, size_t tx_buffer_length)
 {
     cyhal_spi_t *obj = &spi_hm_send->spi_hm_obj;
@@ -135,6 +135,7 @@ typedef struct spi_hm_handler *spi_hm_handler_t;
 cy_rslt_t spi_hm_init (void);
 cy_rslt_t spi_hm_deinit (void);
 spi_hm_handler_t spi_hm_get_main_handler (void);
+void spi_hm_print_resource_usage (void);
 uint32_t spi_hm_proto_send (spi_hm_handler_t spi_hm_send, spi_hm_sw_hdr_t *spi_proto_hdr);
 uint32_t spi_hm_proto_recv (spi_hm_handler_t spi_hm_recv, spi_hm_sw_hdr_t *spi_proto_hdr);
 bool spi_hm_atcmd_is_data_ready (void);
@@ -26,6 +26,7 @@
 #include "cybsp.h"
 #if defined(COMPONENT_WIFI_INTERFACE_OCI)
 #include "whd_oci.h"
+#include "whd_oci_d3.h"
 #include "bus_protocols/whd_bus.h"
 
 #include "whd_chip_constants.h"
@@ -73,6 +74,12 @@
 struct whd_bus_priv
 {
     whd_oci_config_t oci_config;
+    whd_bus_oci_stats_t stats;
+    whd_oci_d3_engine_t d3_engine;
+    uint32_t d3_inform_ms;          /* When the pending D3 inform was sent */
+    uint32_t d3_enter_ms;           /* When the bus was suspended for D3 */
+    whd_bool_t d3_inform_pending;
+    whd_bool_t in_d3;
 };
 
 /******************************************************
@@ -129,6 +136,7 @@ static whd_result_t whd_bus_oci_blhs(whd_driver_t whd_driver, whd_bus_blhs_stage
 static whd_result_t whd_bus_oci_download_resource(whd_driver_t whd_driver, whd_resource_type_t resource,
                                                   whd_bool_t direct_resource, uint32_t address, uint32_t image_size);
 static whd_result_t whd_bus_oci_write_wifi_nvram_image(whd_driver_t whd_driver);
+static uint32_t whd_bus_oci_now_ms(void);
 
 whd_bool_t whd_ensure_wlan_is_up(whd_driver_t whd_driver);
 whd_result_t whd_oci_bus_write_wifi_firmware_image(whd_driver_t whd_driver);
@@ -149,6 +157,7 @@ whd_result_t whd_bus_oci_attach(whd_driver_t whd_driver, whd_oci_config_t *whd_o
     whd_mem_memset(whd_driver->bus_priv, 0, sizeof(struct whd_bus_priv) );
 
     whd_driver->bus_priv->oci_config = *whd_oci_config;
+    CHECK_RETURN(whd_oci_d3_engine_init(&whd_driver->bus_priv->d3_engine, NULL) );
 
 #ifndef PROTO_MSGBUF
     whd_driver->proto_type = WHD_PROTO_BCDC;
@@ -213,6 +222,7 @@ static BOOL32 whd_bus_oci_gci_interrupt_handler(void * callback_arg, uint32_t db
 
     if(db_status_mask & (GCI_H2D_SET_BIT_DB1 | GCI_H2D_SET_BIT_DB0))
     {
+        whd_driver->bus_priv->stats.interrupts++;
         /* call thread notify to wake up WHD thread */
         whd_thread_notify_irq(whd_driver);
     }
@@ -318,6 +328,9 @@ static whd_result_t whd_bus_oci_read_frame(whd_driver_t whd_driver, whd_buffer_t
 static whd_result_t whd_bus_oci_write_backplane_value(whd_driver_t whd_driver, uint32_t address,
                                                       uint8_t register_length, uint32_t value)
 {
+    whd_driver->bus_priv->stats.tx_transfers++;
+    whd_driver->bus_priv->stats.tx_bytes += register_length;
+
     if (register_length == 4)
     {
 #ifdef PROTO_MSGBUF
@@ -349,6 +362,9 @@ static whd_result_t whd_bus_oci_write_backplane_value(whd_driver_t whd_driver, u
 static whd_result_t whd_bus_oci_read_backplane_value(whd_driver_t whd_driver, uint32_t address,
                                                      uint8_t register_length, /*@out@*/ uint8_t *value)
 {
+    whd_driver->bus_priv->stats.rx_transfers++;
+    whd_driver->bus_priv->stats.rx_bytes += register_length;
+
     if (register_length == 4)
     {
 #ifdef PROTO_MSGBUF
@@ -402,10 +418,14 @@ static whd_result_t whd_bus_oci_transfer_bytes(whd_driver_t whd_driver, whd_bus_
 
     if (direction == BUS_WRITE)
     {
+        whd_driver->bus_priv->stats.tx_transfers++;
+        whd_driver->bus_priv->stats.tx_bytes += size;
         whd_mem_memcpy((void *)address, (const void *)data, size);
     }
     else
     {
+        whd_driver->bus_priv->stats.rx_transfers++;
+        whd_driver->bus_priv->stats.rx_bytes += size;
         whd_mem_memcpy((void *)data, (const void *)address, size);
     }
 
@@ -438,11 +458,18 @@ static uint8_t whd_bus_oci_backplane_read_padd_size(whd_driver_t whd_driver)
 #if defined(COMPONENT_CAT5) && !defined(WHD_DISABLE_PDS)
 static whd_result_t whd_bus_oci_sleep_allow_decider(whd_driver_t whd_driver, cy_semaphore_t *transceive_semaphore, uint32_t timeout_ms)
 {
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
     whd_result_t result = 0;
 
     if (whd_driver->ack_d2h_suspend == WHD_TRUE)
     {
         CHECK_RETURN(whd_bus_suspend(whd_driver));
+        if (bus_priv->in_d3 == WHD_FALSE)
+        {
+            bus_priv->in_d3 = WHD_TRUE;
+            bus_priv->d3_enter_ms = whd_bus_oci_now_ms();
+            bus_priv->stats.d3_entries++;
+        }
         whd_driver->pds_sleep_allow = WHD_TRUE;
         WPRINT_WHD_DEBUG(("***SLEEP ALLOW*** \n"));
         whd_pds_unlock_sleep(whd_driver);
@@ -461,6 +488,9 @@ static whd_result_t whd_bus_oci_sleep_allow_decider(whd_driver_t whd_driver, cy_
     if (result == CY_RTOS_TIMEOUT)
     {
         CHECK_RETURN(whd_msgbuf_send_mbdata(whd_driver, WHD_H2D_HOST_D3_INFORM));
+        bus_priv->d3_inform_ms = whd_bus_oci_now_ms();
+        bus_priv->d3_inform_pending = WHD_TRUE;
+        bus_priv->stats.d3_informs++;
     }
 
     return result;
@@ -473,15 +503,21 @@ static whd_result_t whd_bus_oci_wait_for_wlan_event(whd_driver_t whd_driver, cy_
     uint32_t timeout_ms = 0;
 
 #if defined(COMPONENT_CAT5) && !defined(WHD_DISABLE_PDS)
-    timeout_ms = WHD_MSGBUF_SLP_DETECT_TIME;
+    timeout_ms = whd_oci_d3_engine_idle_ms(&whd_driver->bus_priv->d3_engine);
 
     result = whd_bus_oci_sleep_allow_decider(whd_driver, transceive_semaphore, timeout_ms);
     if (result == CY_RTOS_TIMEOUT)
     {
-        /* Here the timeout indiactes, no activity detected for this time(WHD_MSGBUF_SLP_DETECT_TIME),
+        /* Here the timeout indiactes, no activity detected for the idle time,
            so D3 suspend is done and now wait on infinite timeout for any interrupt reception/activity */
         result = cy_rtos_get_semaphore(transceive_semaphore, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
     }
+
+    /* Activity while suspended is judged when the bus resumes */
+    if ( (result == WHD_SUCCESS) && (whd_driver->bus_priv->in_d3 == WHD_FALSE) )
+    {
+        whd_oci_d3_engine_activity(&whd_driver->bus_priv->d3_engine, whd_bus_oci_now_ms() );
+    }
 #else
     uint32_t delayed_release_timeout_ms = 0;
     delayed_release_timeout_ms = whd_bus_handle_delayed_release(whd_driver);
@@ -498,6 +534,11 @@ static whd_result_t whd_bus_oci_wait_for_wlan_event(whd_driver_t whd_driver, cy_
                                                                           WHD_THREAD_POLL_TIMEOUT), WHD_FALSE);
 #endif /* defined(COMPONENT_CAT5) && !defined(WHD_DISABLE_PDS) */
 
+    if (result == WHD_SUCCESS)
+    {
+        whd_driver->bus_priv->stats.wakeups++;
+    }
+
     return result;
 }
 
@@ -514,17 +555,105 @@ static uint32_t whd_bus_oci_get_max_transfer_size(whd_driver_t whd_driver)
 
 static void whd_bus_oci_init_stats(whd_driver_t whd_driver)
 {
-    /* To be implemented */
+    whd_mem_memset(&whd_driver->bus_priv->stats, 0, sizeof(whd_bus_oci_stats_t) );
 }
 
 static whd_result_t whd_bus_oci_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
 {
-    /* To be implemented */
-    UNUSED_VARIABLE(reset_after_print);
-    WPRINT_MACRO( ("Bus stats not available\n") );
+    whd_bus_oci_stats_t stats;
+
+    CHECK_RETURN(whd_bus_oci_get_stats(whd_driver, &stats) );
+
+    WPRINT_MACRO( ("Bus Stats.. \n"
+                   "doorbells:%" PRIu32 ", interrupts:%" PRIu32 ", wakeups:%" PRIu32 "\n"
+                   "d3_informs:%" PRIu32 ", d3_entries:%" PRIu32 ", d3_short_stays:%" PRIu32 ", d3_ms:%" PRIu32
+                   ", idle_ms:%" PRIu32 "\n"
+                   "suspend_ms:%" PRIu32 ", suspend_ms_max:%" PRIu32 ", resumes:%" PRIu32 ", resume_ms:%" PRIu32
+                   ", resume_ms_max:%" PRIu32 "\n"
+                   "tx_transfers:%" PRIu32 ", tx_bytes:%" PRIu32 ", rx_transfers:%" PRIu32 ", rx_bytes:%" PRIu32 "\n",
+                   stats.doorbells, stats.interrupts, stats.wakeups,
+                   stats.d3_informs, stats.d3_entries, stats.d3_short_stays, stats.d3_ms, stats.idle_ms,
+                   stats.suspend_ms, stats.suspend_ms_max, stats.resumes, stats.resume_ms, stats.resume_ms_max,
+                   stats.tx_transfers, stats.tx_bytes, stats.rx_transfers, stats.rx_bytes) );
+#ifdef PROTO_MSGBUF
+    whd_msgbuf_print_db_stats(whd_driver, reset_after_print);
+#endif /* PROTO_MSGBUF */
+
+    if (reset_after_print == WHD_TRUE)
+    {
+        whd_mem_memset(&whd_driver->bus_priv->stats, 0, sizeof(whd_bus_oci_stats_t) );
+    }
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_bus_oci_get_stats(whd_driver_t whd_driver, whd_bus_oci_stats_t *stats)
+{
+    CHECK_DRIVER_NULL(whd_driver);
+    if ( (stats == NULL) || (whd_driver->bus_priv == NULL) )
+    {
+        return WHD_BADARG;
+    }
+
+    *stats = whd_driver->bus_priv->stats;
+    stats->idle_ms = whd_oci_d3_engine_idle_ms(&whd_driver->bus_priv->d3_engine);
+
     return WHD_SUCCESS;
 }
 
+static uint32_t whd_bus_oci_now_ms(void)
+{
+    cy_time_t now = 0;
+
+    (void)cy_rtos_time_get(&now);
+    return (uint32_t)now;
+}
+
+void whd_bus_oci_note_doorbell(whd_driver_t whd_driver)
+{
+    whd_driver->bus_priv->stats.doorbells++;
+}
+
+void whd_bus_oci_note_d3_ack(whd_driver_t whd_driver)
+{
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
+    uint32_t elapsed;
+
+    if (bus_priv->d3_inform_pending == WHD_FALSE)
+    {
+        return;
+    }
+    bus_priv->d3_inform_pending = WHD_FALSE;
+
+    elapsed = whd_bus_oci_now_ms() - bus_priv->d3_inform_ms;
+    bus_priv->stats.suspend_ms += elapsed;
+    bus_priv->stats.suspend_ms_max = MAX_OF(bus_priv->stats.suspend_ms_max, elapsed);
+}
+
+void whd_bus_oci_note_resume(whd_driver_t whd_driver, uint32_t start_ms)
+{
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
+    uint32_t now_ms = whd_bus_oci_now_ms();
+    uint32_t resume_ms = now_ms - start_ms;
+    uint32_t d3_ms = 0;
+    uint32_t short_stays = bus_priv->d3_engine.short_stays;
+
+    bus_priv->stats.resumes++;
+    bus_priv->stats.resume_ms += resume_ms;
+    bus_priv->stats.resume_ms_max = MAX_OF(bus_priv->stats.resume_ms_max, resume_ms);
+
+    /* An inform the WLAN core did not ack before the bus was needed again is dropped */
+    bus_priv->d3_inform_pending = WHD_FALSE;
+
+    if (bus_priv->in_d3 == WHD_TRUE)
+    {
+        bus_priv->in_d3 = WHD_FALSE;
+        d3_ms = start_ms - bus_priv->d3_enter_ms;
+        bus_priv->stats.d3_ms += d3_ms;
+    }
+    whd_oci_d3_engine_resumed(&bus_priv->d3_engine, now_ms, d3_ms, resume_ms);
+    bus_priv->stats.d3_short_stays += bus_priv->d3_engine.short_stays - short_stays;
+}
+
 static whd_result_t whd_bus_oci_reinit_stats(whd_driver_t whd_driver, whd_bool_t wake_from_firmware)
 {
     UNUSED_PARAMETER(wake_from_firmware);
@@ -45,6 +45,30 @@ extern "C" {
 #define REG8(address)     (*(volatile uint8_t *)(address) )
 #endif
 
+/******************************************************
+*             Structures
+******************************************************/
+typedef struct
+{
+    uint32_t doorbells;         /* Number of H2D doorbells rung */
+    uint32_t interrupts;        /* Number of D2H doorbell interrupts */
+    uint32_t wakeups;           /* Number of times the WHD thread woke up for bus activity */
+    uint32_t d3_informs;        /* Number of D3 informs sent after the bus went idle */
+    uint32_t d3_entries;        /* Number of times the bus was suspended after a D3 ack */
+    uint32_t d3_short_stays;    /* Number of D3 stays too short to pay for their resume */
+    uint32_t d3_ms;             /* Time spent in D3 */
+    uint32_t suspend_ms;        /* Time from D3 inform to D3 ack, summed */
+    uint32_t suspend_ms_max;
+    uint32_t resumes;           /* Number of resumes from D3 */
+    uint32_t resume_ms;         /* Time spent resuming, summed */
+    uint32_t resume_ms_max;
+    uint32_t tx_transfers;      /* Number of backplane writes */
+    uint32_t tx_bytes;
+    uint32_t rx_transfers;      /* Number of backplane reads */
+    uint32_t rx_bytes;
+    uint32_t idle_ms;           /* Idle time before the next D3 inform */
+} whd_bus_oci_stats_t;
+
 /******************************************************
 *             Function declarations
 ******************************************************/
@@ -52,6 +76,24 @@ extern void whd_delayed_bus_release_schedule_update(whd_driver_t whd_driver, whd
 #define DELAYED_BUS_RELEASE_SCHEDULE(whd_driver, schedule) \
     do {  whd_delayed_bus_release_schedule_update(whd_driver, schedule); } while (0)
 
+/** Counts an H2D doorbell */
+extern void whd_bus_oci_note_doorbell(whd_driver_t whd_driver);
+
+/** Records the D3 ack for the pending D3 inform */
+extern void whd_bus_oci_note_d3_ack(whd_driver_t whd_driver);
+
+/** Records the end of a resume from D3 that started at start_ms */
+extern void whd_bus_oci_note_resume(whd_driver_t whd_driver, uint32_t start_ms);
+
+/** Copies the OCI bus statistics
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param stats       : Receives the statistics
+ *
+ * @return WHD_SUCCESS or error code
+ */
+extern whd_result_t whd_bus_oci_get_stats(whd_driver_t whd_driver, whd_bus_oci_stats_t *stats);
+
 
 /******************************************************
 *             Global variables
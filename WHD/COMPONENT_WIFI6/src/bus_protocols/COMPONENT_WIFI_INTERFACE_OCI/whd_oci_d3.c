@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Adaptive idle time before the OCI bus asks for D3
+ */
+
+#if defined(COMPONENT_WIFI_INTERFACE_OCI)
+
+#include "whd_oci_d3.h"
+#include "whd_types_int.h"
+#include "whd_utils.h"
+
+/******************************************************
+*             Function definitions
+******************************************************/
+
+/* Averages with a weight of 1/8 for the new sample; the first sample is taken as is */
+static void whd_oci_d3_average(uint32_t *avg_x8, uint32_t sample)
+{
+    if (*avg_x8 == 0)
+    {
+        *avg_x8 = sample * 8;
+    }
+    else
+    {
+        *avg_x8 = *avg_x8 - (*avg_x8 / 8) + sample;
+    }
+}
+
+static void whd_oci_d3_clamp(whd_oci_d3_engine_t *engine)
+{
+    const whd_oci_d3_config_t *cfg = &engine->config;
+    uint32_t floor_ms = cfg->min_idle_ms;
+
+    floor_ms = MAX_OF(floor_ms, cfg->gap_factor * (engine->gap_avg_x8 / 8) );
+    floor_ms = MAX_OF(floor_ms, cfg->break_even_factor * (engine->resume_avg_x8 / 8) );
+    floor_ms = MIN_OF(floor_ms, cfg->max_idle_ms);
+
+    engine->idle_ms = MIN_OF(MAX_OF(engine->idle_ms, floor_ms), cfg->max_idle_ms);
+}
+
+whd_result_t whd_oci_d3_engine_init(whd_oci_d3_engine_t *engine, const whd_oci_d3_config_t *config)
+{
+    whd_oci_d3_config_t *cfg;
+
+    if (engine == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    whd_mem_memset(engine, 0, sizeof(*engine) );
+    cfg = &engine->config;
+    if (config != NULL)
+    {
+        whd_mem_memcpy(cfg, config, sizeof(*cfg) );
+    }
+    if (cfg->min_idle_ms == 0)
+    {
+        cfg->min_idle_ms = WHD_OCI_D3_DEFAULT_MIN_IDLE_MS;
+    }
+    if (cfg->max_idle_ms == 0)
+    {
+        cfg->max_idle_ms = WHD_OCI_D3_DEFAULT_MAX_IDLE_MS;
+    }
+    if (cfg->break_even_factor == 0)
+    {
+        cfg->break_even_factor = WHD_OCI_D3_DEFAULT_BREAK_EVEN_FACTOR;
+    }
+    if (cfg->gap_factor == 0)
+    {
+        cfg->gap_factor = WHD_OCI_D3_DEFAULT_GAP_FACTOR;
+    }
+    if (cfg->min_idle_ms > cfg->max_idle_ms)
+    {
+        return WHD_BADARG;
+    }
+
+    engine->idle_ms = cfg->max_idle_ms;
+
+    return WHD_SUCCESS;
+}
+
+void whd_oci_d3_engine_activity(whd_oci_d3_engine_t *engine, uint32_t now_ms)
+{
+    uint32_t gap = now_ms - engine->last_activity_ms;
+
+    /* A gap that outlasted the idle time ended in D3 and is judged by the resume instead */
+    if ( (engine->have_activity == WHD_TRUE) && (gap < engine->idle_ms) )
+    {
+        whd_oci_d3_average(&engine->gap_avg_x8, gap);
+        whd_oci_d3_clamp(engine);
+    }
+    engine->last_activity_ms = now_ms;
+    engine->have_activity = WHD_TRUE;
+}
+
+void whd_oci_d3_engine_resumed(whd_oci_d3_engine_t *engine, uint32_t now_ms, uint32_t d3_ms, uint32_t resume_ms)
+{
+    uint32_t break_even_ms;
+
+    /* The clock ticks in ms, so a resume that read as 0 still cost something */
+    whd_oci_d3_average(&engine->resume_avg_x8, MAX_OF(resume_ms, 1) );
+    break_even_ms = engine->config.break_even_factor * (engine->resume_avg_x8 / 8);
+
+    if (d3_ms < break_even_ms)
+    {
+        engine->short_stays++;
+        engine->idle_ms += (engine->idle_ms / 2) + 1;
+    }
+    else
+    {
+        engine->long_stays++;
+        engine->idle_ms -= engine->idle_ms / 8;
+    }
+    whd_oci_d3_clamp(engine);
+
+    /* The wake up is the start of the next burst */
+    engine->last_activity_ms = now_ms;
+    engine->have_activity = WHD_TRUE;
+}
+
+uint32_t whd_oci_d3_engine_idle_ms(const whd_oci_d3_engine_t *engine)
+{
+    return engine->idle_ms;
+}
+
+#endif /* COMPONENT_WIFI_INTERFACE_OCI */
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Idle time before the OCI bus asks the WLAN core for D3
+ *
+ *  The WHD thread sends WHD_H2D_HOST_D3_INFORM once the bus has been idle for the engine's
+ *  idle time. The engine starts at max_idle_ms and moves it with what it measures:
+ *
+ *  - gaps between bus activity that ended before the idle time ran out. The idle time is kept
+ *    above gap_factor times their average, so the link is not suspended between the packets
+ *    of a burst;
+ *  - the time the link spent in D3 before it had to resume, and the cost of that resume. A stay
+ *    shorter than break_even_factor average resume costs did not pay for itself and raises the
+ *    idle time by half. A longer stay lowers it by an eighth. The idle time is also kept above
+ *    break_even_factor resume costs.
+ *
+ *  The engine has no driver state and works on times passed in, so it can be fed a simulated
+ *  activity trace on the host.
+ */
+
+#ifndef INCLUDED_WHD_OCI_D3_H_
+#define INCLUDED_WHD_OCI_D3_H_
+
+#include "whd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#ifndef WHD_OCI_D3_DEFAULT_MIN_IDLE_MS
+#define WHD_OCI_D3_DEFAULT_MIN_IDLE_MS          (50)
+#endif
+
+/* Same as WHD_MSGBUF_SLP_DETECT_TIME, the fixed idle time used before */
+#ifndef WHD_OCI_D3_DEFAULT_MAX_IDLE_MS
+#define WHD_OCI_D3_DEFAULT_MAX_IDLE_MS          (2000)
+#endif
+
+#ifndef WHD_OCI_D3_DEFAULT_BREAK_EVEN_FACTOR
+#define WHD_OCI_D3_DEFAULT_BREAK_EVEN_FACTOR    (4)
+#endif
+
+#ifndef WHD_OCI_D3_DEFAULT_GAP_FACTOR
+#define WHD_OCI_D3_DEFAULT_GAP_FACTOR           (2)
+#endif
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct
+{
+    uint32_t min_idle_ms;           /* Lowest idle time */
+    uint32_t max_idle_ms;           /* Highest idle time, also the starting one */
+    uint32_t break_even_factor;     /* Resume costs a D3 stay must last to pay for itself */
+    uint32_t gap_factor;            /* Average activity gaps the idle time stays above */
+} whd_oci_d3_config_t;
+
+typedef struct
+{
+    whd_oci_d3_config_t config;
+    uint32_t idle_ms;               /* Current idle time */
+    uint32_t gap_avg_x8;            /* Average activity gap, times 8 */
+    uint32_t resume_avg_x8;         /* Average resume cost, times 8 */
+    uint32_t last_activity_ms;
+    whd_bool_t have_activity;
+    uint32_t short_stays;           /* D3 stays that did not pay for themselves */
+    uint32_t long_stays;
+} whd_oci_d3_engine_t;
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Starts the engine at the highest idle time
+ *
+ * @param engine  : Engine state
+ * @param config  : Limits and factors, NULL for the defaults. Zero fields take their defaults.
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if min_idle_ms is above max_idle_ms
+ */
+whd_result_t whd_oci_d3_engine_init(whd_oci_d3_engine_t *engine, const whd_oci_d3_config_t *config);
+
+/** Notes bus activity while the link is up
+ *
+ * @param engine  : Engine state
+ * @param now_ms  : Time of the activity
+ */
+void whd_oci_d3_engine_activity(whd_oci_d3_engine_t *engine, uint32_t now_ms);
+
+/** Notes a resume from D3
+ *
+ * @param engine     : Engine state
+ * @param now_ms     : Time the resume finished
+ * @param d3_ms      : Time the link spent in D3
+ * @param resume_ms  : Time the resume took
+ */
+void whd_oci_d3_engine_resumed(whd_oci_d3_engine_t *engine, uint32_t now_ms, uint32_t d3_ms, uint32_t resume_ms);
+
+/** Idle time to wait before the next D3 inform */
+uint32_t whd_oci_d3_engine_idle_ms(const whd_oci_d3_engine_t *engine);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_OCI_D3_H_ */
@@ -66,13 +66,47 @@
 
 #define WHD_THREAD_POLL_TIMEOUT      (CY_RTOS_NEVER_TIMEOUT)
 
+/* Most received descriptors taken off the RX ring per drain */
+#ifndef WHD_BUS_M2M_RX_BATCH
+#define WHD_BUS_M2M_RX_BATCH         (8)
+#endif
+
+/* How long the WHD thread sleeps before retrying a failed RX refill */
+#ifndef WHD_BUS_M2M_RX_REFILL_RETRY_MS
+#define WHD_BUS_M2M_RX_REFILL_RETRY_MS (10)
+#endif
+
 /******************************************************
 *             Structures
 ******************************************************/
+typedef struct
+{
+    uint32_t intr_reads;        /* DMA interrupt status reads */
+    uint32_t rx_drains;         /* Walks of the RX ring */
+    uint32_t rx_frames;         /* Descriptors received */
+    uint32_t rx_empty;          /* Availability checks that found nothing */
+    uint32_t rx_refills;        /* RX ring refills */
+    uint32_t rx_refill_fails;   /* Refills the DMA engine could not complete */
+    uint32_t txdone_requests;   /* TX done indications from the DMA engine */
+    uint32_t txdone_signals;    /* SW interrupts written to the WLAN core for them */
+} whd_bus_m2m_stats_t;
+
 struct whd_bus_priv
 {
     whd_m2m_config_t m2m_config;
     cyhal_m2m_t *m2m_obj;
+
+    /* Frames taken off the RX ring and not yet handed to the WHD thread */
+    void *rx_frames[WHD_BUS_M2M_RX_BATCH];
+    uint16_t *rx_hwtags[WHD_BUS_M2M_RX_BATCH];
+    uint8_t rx_next;
+    uint8_t rx_count;
+    /* The last refill failed, so the ring may be short of buffers */
+    whd_bool_t rx_refill_pending;
+
+    /* The WLAN core is told about TX done once per poll round */
+    whd_bool_t txdone_pending;
+    whd_bus_m2m_stats_t stats;
 };
 
 /******************************************************
@@ -91,6 +125,7 @@ static whd_result_t whd_bus_m2m_send_buffer(whd_driver_t whd_driver, whd_buffer_
 
 static whd_bool_t whd_bus_m2m_wake_interrupt_present(whd_driver_t whd_driver);
 static uint32_t whd_bus_m2m_packet_available_to_read(whd_driver_t whd_driver);
+static void whd_bus_m2m_rx_refill(struct whd_bus_priv *bus_priv);
 static whd_result_t whd_bus_m2m_read_frame(whd_driver_t whd_driver, whd_buffer_t *buffer);
 
 static whd_result_t whd_bus_m2m_write_backplane_value(whd_driver_t whd_driver, uint32_t address,
@@ -124,6 +159,8 @@ static whd_result_t whd_bus_m2m_download_resource(whd_driver_t whd_driver, whd_r
                                                   whd_bool_t direct_resource, uint32_t address, uint32_t image_size);
 static whd_result_t whd_bus_m2m_write_wifi_nvram_image(whd_driver_t whd_driver);
 static whd_result_t whd_bus_m2m_set_backplane_window(whd_driver_t whd_driver, uint32_t addr, uint32_t *curaddr);
+static void whd_bus_m2m_service_dma(whd_driver_t whd_driver);
+static whd_result_t whd_bus_m2m_signal_txdone(whd_driver_t whd_driver);
 
 static whd_result_t boot_wlan(whd_driver_t whd_driver);
 whd_bool_t whd_ensure_wlan_is_up(whd_driver_t whd_driver);
@@ -229,6 +266,8 @@ static whd_result_t whd_bus_m2m_init(whd_driver_t whd_driver)
     {
         cyhal_m2m_init(whd_driver->bus_priv->m2m_obj, M2M_DMA_RX_BUFFER_SIZE);
         cyhal_m2m_register_callback(whd_driver->bus_priv->m2m_obj, whd_bus_m2m_irq_handler, whd_driver);
+        /* Later refills happen after received descriptors are drained, or until one succeeds */
+        whd_bus_m2m_rx_refill(whd_driver->bus_priv);
     }
 
     return result;
@@ -282,56 +321,135 @@ static whd_bool_t whd_bus_m2m_wake_interrupt_present(whd_driver_t whd_driver)
     return WHD_FALSE;
 }
 
-static uint32_t whd_bus_m2m_packet_available_to_read(whd_driver_t whd_driver)
+static void whd_bus_m2m_rx_refill(struct whd_bus_priv *bus_priv)
 {
-    return 1;
+    bus_priv->stats.rx_refills++;
+    if (cyhal_m2m_rx_prepare(bus_priv->m2m_obj) )
+    {
+        bus_priv->rx_refill_pending = WHD_FALSE;
+    }
+    else
+    {
+        /* Retried on every service until it succeeds, drained frames or not */
+        bus_priv->stats.rx_refill_fails++;
+        bus_priv->rx_refill_pending = WHD_TRUE;
+    }
 }
 
-static whd_result_t whd_bus_m2m_read_frame(whd_driver_t whd_driver, whd_buffer_t *buffer)
+/* Reads the DMA interrupt status once, reclaims sent TX descriptors and takes up to
+ * WHD_BUS_M2M_RX_BATCH completed descriptors off the RX ring, refilling it once afterwards.
+ * A refill that failed is retried here even when nothing was drained. */
+static void whd_bus_m2m_service_dma(whd_driver_t whd_driver)
 {
-    whd_result_t result = WHD_SUCCESS;
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
     cyhal_m2m_event_t m2m_event;
     uint16_t *hwtag;
-    void *packet = NULL;
-    bool signal_txdone;
-
-    cyhal_m2m_rx_prepare(whd_driver->bus_priv->m2m_obj);
+    void *packet;
+    bool signal_txdone = false;
 
-    m2m_event = cyhal_m2m_intr_status(whd_driver->bus_priv->m2m_obj, &signal_txdone);
+    m2m_event = cyhal_m2m_intr_status(bus_priv->m2m_obj, &signal_txdone);
+    bus_priv->stats.intr_reads++;
     if (signal_txdone)
     {
-        /* Signal WLAN core there is a TX done by setting wlancr4 SW interrupt 0 */
-        CHECK_RETURN(whd_bus_write_backplane_value(whd_driver, GET_C_VAR(whd_driver, PMU_BASE_ADDRESS) + 0x1c,
-                                                   (uint8_t)4, ARMCR4_SW_INT0) );
+        bus_priv->stats.txdone_requests++;
+        bus_priv->txdone_pending = WHD_TRUE;
     }
 
     /* Handle DMA interrupts */
     if ( (m2m_event & CYHAL_M2M_TX_CHANNEL_INTERRUPT) != 0 )
     {
-        cyhal_m2m_tx_release(whd_driver->bus_priv->m2m_obj);
+        cyhal_m2m_tx_release(bus_priv->m2m_obj);
     }
 
-    /* Handle DMA receive interrupt */
-    cyhal_m2m_rx_receive(whd_driver->bus_priv->m2m_obj, &packet, &hwtag);
-    if (packet == NULL)
+    /* Only called once the frames of the previous drain have been read */
+    bus_priv->rx_next = 0;
+    bus_priv->rx_count = 0;
+    bus_priv->stats.rx_drains++;
+    while (bus_priv->rx_count < WHD_BUS_M2M_RX_BATCH)
     {
-        result = WHD_NO_PACKET_TO_RECEIVE;
+        packet = NULL;
+        cyhal_m2m_rx_receive(bus_priv->m2m_obj, &packet, &hwtag);
+        if (packet == NULL)
+        {
+            break;
+        }
+        bus_priv->rx_frames[bus_priv->rx_count] = packet;
+        bus_priv->rx_hwtags[bus_priv->rx_count] = hwtag;
+        bus_priv->rx_count++;
     }
-    else
+    bus_priv->stats.rx_frames += bus_priv->rx_count;
+    if ( (bus_priv->rx_count != 0) || (bus_priv->rx_refill_pending == WHD_TRUE) )
     {
-        *buffer = packet;
+        whd_bus_m2m_rx_refill(bus_priv);
+    }
+}
 
-        /* move the data pointer 12 bytes(sizeof(wwd_buffer_header_t))
-         * back to the start of the pakcet
-         */
-        whd_buffer_add_remove_at_front(whd_driver, buffer, -(int)sizeof(whd_buffer_header_t) );
+static whd_result_t whd_bus_m2m_signal_txdone(whd_driver_t whd_driver)
+{
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
 
-        whd_sdpcm_update_credit(whd_driver, (uint8_t *)hwtag);
+    if (bus_priv->txdone_pending == WHD_FALSE)
+    {
+        return WHD_SUCCESS;
     }
+    bus_priv->txdone_pending = WHD_FALSE;
+    bus_priv->stats.txdone_signals++;
 
-    cyhal_m2m_rx_prepare(whd_driver->bus_priv->m2m_obj);
+    /* Signal WLAN core there is a TX done by setting wlancr4 SW interrupt 0 */
+    return whd_bus_write_backplane_value(whd_driver, GET_C_VAR(whd_driver, PMU_BASE_ADDRESS) + 0x1c,
+                                         (uint8_t)4, ARMCR4_SW_INT0);
+}
 
-    return result;
+static uint32_t whd_bus_m2m_packet_available_to_read(whd_driver_t whd_driver)
+{
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
+
+    /* A TX done still pending here was left by a round cut short by the RX bound */
+    if (whd_bus_m2m_signal_txdone(whd_driver) != WHD_SUCCESS)
+    {
+        return WHD_BUS_FAIL;
+    }
+
+    if (bus_priv->rx_next == bus_priv->rx_count)
+    {
+        whd_bus_m2m_service_dma(whd_driver);
+    }
+    if (bus_priv->rx_next == bus_priv->rx_count)
+    {
+        bus_priv->stats.rx_empty++;
+        return (whd_bus_m2m_signal_txdone(whd_driver) == WHD_SUCCESS) ? 0 : WHD_BUS_FAIL;
+    }
+    return (uint32_t)(bus_priv->rx_count - bus_priv->rx_next);
+}
+
+static whd_result_t whd_bus_m2m_read_frame(whd_driver_t whd_driver, whd_buffer_t *buffer)
+{
+    struct whd_bus_priv *bus_priv = whd_driver->bus_priv;
+    uint16_t *hwtag;
+
+    if (bus_priv->rx_next == bus_priv->rx_count)
+    {
+        whd_bus_m2m_service_dma(whd_driver);
+        if (bus_priv->rx_count == 0)
+        {
+            /* End of the poll round */
+            CHECK_RETURN(whd_bus_m2m_signal_txdone(whd_driver) );
+            return WHD_NO_PACKET_TO_RECEIVE;
+        }
+    }
+
+    *buffer = bus_priv->rx_frames[bus_priv->rx_next];
+    hwtag = bus_priv->rx_hwtags[bus_priv->rx_next];
+    bus_priv->rx_next++;
+
+    /* move the data pointer 12 bytes(sizeof(wwd_buffer_header_t))
+     * back to the start of the pakcet
+     */
+    whd_buffer_add_remove_at_front(whd_driver, buffer, -(int)sizeof(whd_buffer_header_t) );
+
+    whd_sdpcm_update_credit(whd_driver, (uint8_t *)hwtag);
+
+    return WHD_SUCCESS;
 }
 
 static whd_result_t whd_bus_m2m_write_backplane_value(whd_driver_t whd_driver, uint32_t address,
@@ -466,6 +584,16 @@ static whd_result_t whd_bus_m2m_wait_for_wlan_event(whd_driver_t whd_driver, cy_
     uint32_t timeout_ms;
 
     timeout_ms = CY_RTOS_NEVER_TIMEOUT;
+    CHECK_RETURN(whd_bus_m2m_signal_txdone(whd_driver) );
+    if (whd_driver->bus_priv->rx_refill_pending == WHD_TRUE)
+    {
+        /* A ring left without buffers raises no RX interrupt, so keep retrying */
+        whd_bus_m2m_rx_refill(whd_driver->bus_priv);
+        if (whd_driver->bus_priv->rx_refill_pending == WHD_TRUE)
+        {
+            timeout_ms = WHD_BUS_M2M_RX_REFILL_RETRY_MS;
+        }
+    }
     whd_bus_m2m_irq_enable(whd_driver, WHD_TRUE);
     result = cy_rtos_get_semaphore(transceive_semaphore, timeout_ms, WHD_FALSE);
 
@@ -485,14 +613,25 @@ static uint32_t whd_bus_m2m_get_max_transfer_size(whd_driver_t whd_driver)
 
 static void whd_bus_m2m_init_stats(whd_driver_t whd_driver)
 {
-    /* To be implemented */
+    whd_mem_memset(&whd_driver->bus_priv->stats, 0, sizeof(whd_bus_m2m_stats_t) );
 }
 
 static whd_result_t whd_bus_m2m_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
 {
-    /* To be implemented */
-    UNUSED_VARIABLE(reset_after_print);
-    WPRINT_MACRO( ("Bus stats not available\n") );
+    whd_bus_m2m_stats_t *stats = &whd_driver->bus_priv->stats;
+
+    WPRINT_MACRO( ("Bus Stats.. \n"
+                   "intr_reads:%" PRIu32 ", rx_drains:%" PRIu32 ", rx_frames:%" PRIu32 ", rx_empty:%" PRIu32
+                   ", rx_refills:%" PRIu32 ", rx_refill_fails:%" PRIu32 "\n"
+                   "txdone_requests:%" PRIu32 ", txdone_signals:%" PRIu32 "\n",
+                   stats->intr_reads, stats->rx_drains, stats->rx_frames, stats->rx_empty, stats->rx_refills,
+                   stats->rx_refill_fails,
+                   stats->txdone_requests, stats->txdone_signals) );
+
+    if (reset_after_print == WHD_TRUE)
+    {
+        whd_mem_memset(stats, 0, sizeof(whd_bus_m2m_stats_t) );
+    }
     return WHD_SUCCESS;
 }
 
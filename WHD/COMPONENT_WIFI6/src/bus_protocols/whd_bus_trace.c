@@ -0,0 +1,1034 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Bus transaction record and replay
+ *
+ *  The recorder keeps its own copy of whd_bus_info_t whose entries forward to
+ *  the bus that was attached and then log the call. Bus drivers also call the
+ *  generic whd_bus_* wrappers from inside their own functions (for example
+ *  send_buffer going through transfer_bytes); such calls are recorded with
+ *  WHD_BUS_TRACE_REC_NESTED and ignored by replay, since the replayed outer
+ *  call never issues them.
+ */
+
+#ifdef WHD_BUS_TRACE
+
+#include "cyabs_rtos.h"
+#include "whd_bus_trace.h"
+#include "whd_bus.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_buffer_api.h"
+#include "whd_debug.h"
+
+/******************************************************
+*             Constants
+******************************************************/
+#define WHD_BUS_TRACE_TRACKED       (0x80)  /* Internal: call owns the nesting depth */
+
+/******************************************************
+*             Structures
+******************************************************/
+
+struct whd_bus_trace
+{
+    whd_bus_info_t bus_if;              /* Installed as whd_driver->bus_if */
+    whd_bus_info_t *orig_bus_if;
+    whd_bool_t replay;
+    cy_semaphore_t lock;
+    whd_bus_trace_stats_t stats;
+
+    /* Recording */
+    whd_bus_trace_config_t config;
+    uint32_t last_time;
+    cy_thread_t owner;
+    uint32_t depth;
+
+    /* Replay */
+    const uint8_t *trace;
+    uint32_t len;
+    uint32_t pos;
+    uint32_t flags;
+    whd_bus_trace_file_header_t header;
+    uint64_t trace_time_us;
+    cy_time_t start_time;
+};
+
+/******************************************************
+*             Static Function Declarations
+******************************************************/
+
+static void whd_bus_trace_lock(struct whd_bus_trace *trace);
+static void whd_bus_trace_unlock(struct whd_bus_trace *trace);
+
+/******************************************************
+*             Recording
+******************************************************/
+
+static uint32_t whd_bus_trace_now(struct whd_bus_trace *trace)
+{
+    cy_time_t now;
+
+    if (trace->config.get_time_us != NULL)
+    {
+        return trace->config.get_time_us();
+    }
+    (void)cy_rtos_get_time(&now);
+    return (uint32_t)now;
+}
+
+/* Works out whether the calling thread is already inside a recorded bus call */
+static uint8_t whd_bus_trace_enter(struct whd_bus_trace *trace)
+{
+    cy_thread_t self = NULL;
+    uint8_t state = 0;
+
+    (void)cy_rtos_get_thread_handle(&self);
+
+    whd_bus_trace_lock(trace);
+    if (trace->depth == 0)
+    {
+        trace->owner = self;
+        trace->depth = 1;
+        state = WHD_BUS_TRACE_TRACKED;
+    }
+    else if (trace->owner == self)
+    {
+        trace->depth++;
+        state = WHD_BUS_TRACE_TRACKED | WHD_BUS_TRACE_REC_NESTED;
+    }
+    whd_bus_trace_unlock(trace);
+
+    return state;
+}
+
+static void whd_bus_trace_exit(struct whd_bus_trace *trace, uint8_t state)
+{
+    if ( (state & WHD_BUS_TRACE_TRACKED) == 0 )
+    {
+        return;
+    }
+    whd_bus_trace_lock(trace);
+    trace->depth--;
+    whd_bus_trace_unlock(trace);
+}
+
+static void whd_bus_trace_emit(struct whd_bus_trace *trace, uint8_t op, uint8_t state,
+                               const void *payload, uint16_t payload_len, const uint8_t *data, uint32_t data_len)
+{
+    whd_bus_trace_record_t rec;
+    uint32_t now;
+    int err = 0;
+
+    rec.op = op;
+    rec.flags = (uint8_t)(state & WHD_BUS_TRACE_REC_NESTED);
+    if (data_len > (uint32_t)(0xFFFF - payload_len) )
+    {
+        data_len = (uint32_t)(0xFFFF - payload_len);
+        rec.flags |= WHD_BUS_TRACE_REC_TRUNCATED;
+    }
+    rec.len = (uint16_t)(payload_len + data_len);
+
+    whd_bus_trace_lock(trace);
+    now = whd_bus_trace_now(trace);
+    rec.delta = now - trace->last_time;
+    trace->last_time = now;
+
+    err |= trace->config.write(trace->config.ctx, (const uint8_t *)&rec, sizeof(rec) );
+    err |= trace->config.write(trace->config.ctx, (const uint8_t *)payload, payload_len);
+    if (data_len != 0)
+    {
+        err |= trace->config.write(trace->config.ctx, data, data_len);
+    }
+
+    if (err != 0)
+    {
+        trace->stats.sink_errors++;
+    }
+    else
+    {
+        trace->stats.records++;
+        trace->stats.bytes += sizeof(rec) + rec.len;
+        if ( (op == WHD_BUS_TRACE_OP_READ_FRAME) && (data_len != 0) )
+        {
+            trace->stats.frames++;
+        }
+    }
+    whd_bus_trace_unlock(trace);
+}
+
+static void whd_bus_trace_put_value(struct whd_bus_trace *trace, uint8_t op, uint8_t state,
+                                    whd_result_t result, uint32_t value)
+{
+    whd_bus_trace_value_t rec = { .result = result, .value = value };
+
+    whd_bus_trace_emit(trace, op, state, &rec, sizeof(rec), NULL, 0);
+}
+
+static void whd_bus_trace_put_access(struct whd_bus_trace *trace, uint8_t op, uint8_t state, whd_result_t result,
+                                     uint8_t function, uint32_t address, uint8_t length, uint32_t value)
+{
+    whd_bus_trace_access_t rec =
+    { .result = result, .address = address, .value = value, .function = function, .length = length };
+
+    whd_bus_trace_emit(trace, op, state, &rec, sizeof(rec), NULL, 0);
+}
+
+static uint32_t whd_bus_trace_read_value(const uint8_t *value, uint8_t length)
+{
+    uint32_t v = 0;
+
+    whd_mem_memcpy(&v, value, (length < sizeof(v) ) ? length : sizeof(v) );
+    return v;
+}
+
+static whd_result_t whd_bus_trace_rec_ack_interrupt(whd_driver_t whd_driver, uint32_t intstatus)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_ack_interrupt_fptr(whd_driver, intstatus);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_ACK_INTERRUPT, state, result, intstatus);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_send_buffer(whd_driver_t whd_driver, whd_buffer_t buffer)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t snap[WHD_BUS_TRACE_TX_SNAP_MAX];
+    uint16_t size = whd_buffer_get_current_piece_size(whd_driver, buffer);
+    uint16_t snap_len = (size < trace->config.tx_snap_len) ? size : trace->config.tx_snap_len;
+    whd_bus_trace_value_t rec;
+    uint8_t state;
+
+    /* The bus releases the buffer, so take the copy first */
+    if (snap_len != 0)
+    {
+        whd_mem_memcpy(snap, whd_buffer_get_current_piece_data_pointer(whd_driver, buffer), snap_len);
+    }
+
+    state = whd_bus_trace_enter(trace);
+    rec.result = trace->orig_bus_if->whd_bus_send_buffer_fptr(whd_driver, buffer);
+    rec.value = size;
+    whd_bus_trace_emit(trace, WHD_BUS_TRACE_OP_SEND_BUFFER, state, &rec, sizeof(rec), snap, snap_len);
+    whd_bus_trace_exit(trace, state);
+    return rec.result;
+}
+
+static whd_bool_t whd_bus_trace_rec_wake_interrupt_present(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_bool_t present = trace->orig_bus_if->whd_bus_wake_interrupt_present_fptr(whd_driver);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_WAKE_INTERRUPT_PRESENT, state, WHD_SUCCESS, present);
+    whd_bus_trace_exit(trace, state);
+    return present;
+}
+
+static uint32_t whd_bus_trace_rec_packet_available_to_read(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    uint32_t status = trace->orig_bus_if->whd_bus_packet_available_to_read_fptr(whd_driver);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_PACKET_AVAILABLE, state, WHD_SUCCESS, status);
+    whd_bus_trace_exit(trace, state);
+    return status;
+}
+
+static whd_result_t whd_bus_trace_rec_read_frame(whd_driver_t whd_driver, whd_buffer_t *buffer)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_bus_trace_value_t rec = { 0 };
+    const uint8_t *data = NULL;
+
+    rec.result = trace->orig_bus_if->whd_bus_read_frame_fptr(whd_driver, buffer);
+    if ( (rec.result == WHD_SUCCESS) && (*buffer != NULL) )
+    {
+        data = whd_buffer_get_current_piece_data_pointer(whd_driver, *buffer);
+        rec.value = whd_buffer_get_current_piece_size(whd_driver, *buffer);
+    }
+    whd_bus_trace_emit(trace, WHD_BUS_TRACE_OP_READ_FRAME, state, &rec, sizeof(rec), data, rec.value);
+    whd_bus_trace_exit(trace, state);
+    return rec.result;
+}
+
+static whd_result_t whd_bus_trace_rec_write_backplane_value(whd_driver_t whd_driver, uint32_t address,
+                                                            uint8_t register_length, uint32_t value)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_write_backplane_value_fptr(whd_driver, address,
+                                                                                register_length, value);
+
+    whd_bus_trace_put_access(trace, WHD_BUS_TRACE_OP_WRITE_BACKPLANE, state, result, BACKPLANE_FUNCTION, address,
+                             register_length, value);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_read_backplane_value(whd_driver_t whd_driver, uint32_t address,
+                                                           uint8_t register_length, uint8_t *value)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_read_backplane_value_fptr(whd_driver, address,
+                                                                               register_length, value);
+
+    whd_bus_trace_put_access(trace, WHD_BUS_TRACE_OP_READ_BACKPLANE, state, result, BACKPLANE_FUNCTION, address,
+                             register_length, whd_bus_trace_read_value(value, register_length) );
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_write_register_value(whd_driver_t whd_driver, whd_bus_function_t function,
+                                                           uint32_t address, uint8_t value_length, uint32_t value)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_write_register_value_fptr(whd_driver, function, address,
+                                                                               value_length, value);
+
+    whd_bus_trace_put_access(trace, WHD_BUS_TRACE_OP_WRITE_REGISTER, state, result, (uint8_t)function, address,
+                             value_length, value);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_read_register_value(whd_driver_t whd_driver, whd_bus_function_t function,
+                                                          uint32_t address, uint8_t value_length, uint8_t *value)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_read_register_value_fptr(whd_driver, function, address,
+                                                                              value_length, value);
+
+    whd_bus_trace_put_access(trace, WHD_BUS_TRACE_OP_READ_REGISTER, state, result, (uint8_t)function, address,
+                             value_length, whd_bus_trace_read_value(value, value_length) );
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_transfer_bytes(whd_driver_t whd_driver, whd_bus_transfer_direction_t direction,
+                                                     whd_bus_function_t function, uint32_t address, uint16_t size,
+                                                     whd_transfer_bytes_packet_t *data)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_bus_trace_transfer_t rec =
+    { .address = address, .size = size, .function = (uint8_t)function, .direction = (uint8_t)direction };
+
+    rec.result = trace->orig_bus_if->whd_bus_transfer_bytes_fptr(whd_driver, direction, function, address, size, data);
+
+    /* Only reads carry data: writes are either frames already seen by send_buffer or firmware downloads */
+    whd_bus_trace_emit(trace, WHD_BUS_TRACE_OP_TRANSFER_BYTES, state, &rec, sizeof(rec), (const uint8_t *)data->data,
+                       (direction == BUS_READ) ? size : 0);
+    whd_bus_trace_exit(trace, state);
+    return rec.result;
+}
+
+static whd_result_t whd_bus_trace_rec_poke_wlan(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_poke_wlan_fptr(whd_driver);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_POKE_WLAN, state, result, 0);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_wakeup(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_wakeup_fptr(whd_driver);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_WAKEUP, state, result, 0);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+static whd_result_t whd_bus_trace_rec_sleep(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_sleep_fptr(whd_driver);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_SLEEP, state, result, 0);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+/* The interrupt is only visible as the flag the ISR leaves behind, so it is
+ * sampled when the WHD thread wakes up rather than logged from the ISR */
+static whd_result_t whd_bus_trace_rec_wait_for_wlan_event(whd_driver_t whd_driver,
+                                                          cy_semaphore_t *transceive_semaphore)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    uint8_t state = whd_bus_trace_enter(trace);
+    whd_result_t result = trace->orig_bus_if->whd_bus_wait_for_wlan_event_fptr(whd_driver, transceive_semaphore);
+
+    whd_bus_trace_put_value(trace, WHD_BUS_TRACE_OP_WAIT_FOR_EVENT, state, result,
+                            whd_driver->thread_info.bus_interrupt);
+    whd_bus_trace_exit(trace, state);
+    return result;
+}
+
+whd_result_t whd_bus_trace_record_start(whd_driver_t whd_driver, const whd_bus_trace_config_t *config)
+{
+    struct whd_bus_trace *trace;
+    whd_bus_info_t *orig;
+    whd_bus_trace_file_header_t header;
+
+    if ( (whd_driver == NULL) || (config == NULL) || (config->write == NULL) ||
+         (config->tx_snap_len > WHD_BUS_TRACE_TX_SNAP_MAX) )
+    {
+        return WHD_BADARG;
+    }
+    if ( (whd_driver->bus_if == NULL) || (whd_driver->bus_trace != NULL) )
+    {
+        WPRINT_WHD_ERROR( ("%s: no bus attached or trace already active\n", __func__) );
+        return WHD_BADARG;
+    }
+    orig = whd_driver->bus_if;
+
+    trace = (struct whd_bus_trace *)whd_mem_calloc(1, sizeof(struct whd_bus_trace) );
+    if (trace == NULL)
+    {
+        WPRINT_WHD_ERROR( ("Memory allocation failed for whd_bus_trace in %s\n", __FUNCTION__) );
+        return WHD_MALLOC_FAILURE;
+    }
+    if ( (cy_rtos_init_semaphore(&trace->lock, 1, 0) != WHD_SUCCESS) ||
+         (cy_rtos_set_semaphore(&trace->lock, WHD_FALSE) != WHD_SUCCESS) )
+    {
+        whd_mem_free(trace);
+        return WHD_SEMAPHORE_ERROR;
+    }
+    trace->config = *config;
+    trace->orig_bus_if = orig;
+
+    whd_mem_memset(&header, 0, sizeof(header) );
+    header.magic = WHD_BUS_TRACE_MAGIC;
+    header.version = WHD_BUS_TRACE_VERSION;
+#ifdef PROTO_MSGBUF
+    header.flags |= WHD_BUS_TRACE_HDR_MSGBUF;
+#endif /* PROTO_MSGBUF */
+    if ( (orig->whd_bus_use_status_report_scheme_fptr != NULL) &&
+         (orig->whd_bus_use_status_report_scheme_fptr(whd_driver) == WHD_TRUE) )
+    {
+        header.flags |= WHD_BUS_TRACE_HDR_STATUS_REPORT;
+    }
+    header.time_unit_us = (config->get_time_us != NULL) ? 1 : 1000;
+    if (orig->whd_bus_get_max_transfer_size_fptr != NULL)
+    {
+        header.max_transfer_size = orig->whd_bus_get_max_transfer_size_fptr(whd_driver);
+    }
+    if (orig->whd_bus_backplane_read_padd_size_fptr != NULL)
+    {
+        header.backplane_read_padd_size = orig->whd_bus_backplane_read_padd_size_fptr(whd_driver);
+    }
+    if (config->write(config->ctx, (const uint8_t *)&header, sizeof(header) ) != 0)
+    {
+        (void)cy_rtos_deinit_semaphore(&trace->lock);
+        whd_mem_free(trace);
+        return WHD_BADARG;
+    }
+    trace->stats.bytes = sizeof(header);
+    trace->last_time = whd_bus_trace_now(trace);
+
+    /* Calls that are not recorded go straight to the real bus */
+    trace->bus_if = *orig;
+    trace->bus_if.whd_bus_ack_interrupt_fptr = whd_bus_trace_rec_ack_interrupt;
+    trace->bus_if.whd_bus_send_buffer_fptr = whd_bus_trace_rec_send_buffer;
+    trace->bus_if.whd_bus_wake_interrupt_present_fptr = whd_bus_trace_rec_wake_interrupt_present;
+    trace->bus_if.whd_bus_packet_available_to_read_fptr = whd_bus_trace_rec_packet_available_to_read;
+    trace->bus_if.whd_bus_read_frame_fptr = whd_bus_trace_rec_read_frame;
+    trace->bus_if.whd_bus_write_backplane_value_fptr = whd_bus_trace_rec_write_backplane_value;
+    trace->bus_if.whd_bus_read_backplane_value_fptr = whd_bus_trace_rec_read_backplane_value;
+    trace->bus_if.whd_bus_write_register_value_fptr = whd_bus_trace_rec_write_register_value;
+    trace->bus_if.whd_bus_read_register_value_fptr = whd_bus_trace_rec_read_register_value;
+    trace->bus_if.whd_bus_transfer_bytes_fptr = whd_bus_trace_rec_transfer_bytes;
+    trace->bus_if.whd_bus_poke_wlan_fptr = whd_bus_trace_rec_poke_wlan;
+    trace->bus_if.whd_bus_wakeup_fptr = whd_bus_trace_rec_wakeup;
+    trace->bus_if.whd_bus_sleep_fptr = whd_bus_trace_rec_sleep;
+    trace->bus_if.whd_bus_wait_for_wlan_event_fptr = whd_bus_trace_rec_wait_for_wlan_event;
+
+    whd_driver->bus_trace = trace;
+    whd_driver->bus_if = &trace->bus_if;
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_bus_trace_record_stop(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace;
+
+    if ( (whd_driver == NULL) || (whd_driver->bus_trace == NULL) || (whd_driver->bus_trace->replay == WHD_TRUE) )
+    {
+        return WHD_BADARG;
+    }
+    trace = whd_driver->bus_trace;
+
+    whd_driver->bus_if = trace->orig_bus_if;
+    whd_driver->bus_trace = NULL;
+    (void)cy_rtos_deinit_semaphore(&trace->lock);
+    whd_mem_free(trace);
+
+    return WHD_SUCCESS;
+}
+
+/******************************************************
+*             Replay
+******************************************************/
+
+/* Finds the next record for op, passing over nested records and, within the
+ * resync window, records the upper layers did not ask for this time */
+static const uint8_t *whd_bus_trace_next(whd_driver_t whd_driver, whd_bus_trace_op_t op, uint16_t *len)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    const whd_bus_trace_record_t *rec;
+    const uint8_t *payload = NULL;
+    uint32_t pos, seen = 0, skipped = 0, records = 0;
+    uint64_t time_us = 0;
+    cy_time_t now;
+    uint32_t target;
+
+    whd_bus_trace_lock(trace);
+    pos = trace->pos;
+    while ( (pos + sizeof(whd_bus_trace_record_t) <= trace->len) && (seen < WHD_BUS_TRACE_RESYNC_WINDOW) )
+    {
+        rec = (const whd_bus_trace_record_t *)(trace->trace + pos);
+        if (pos + sizeof(*rec) + rec->len > trace->len)
+        {
+            /* Truncated capture, treat the partial record as the end */
+            pos = trace->len;
+            break;
+        }
+        time_us += (uint64_t)rec->delta * trace->header.time_unit_us;
+        records++;
+        pos += sizeof(*rec) + rec->len;
+
+        if ( (rec->flags & WHD_BUS_TRACE_REC_NESTED) != 0 )
+        {
+            continue;
+        }
+        if (rec->op == op)
+        {
+            payload = (const uint8_t *)(rec + 1);
+            *len = rec->len;
+            break;
+        }
+        seen++;
+        skipped++;
+    }
+
+    if ( (payload != NULL) || (pos >= trace->len) )
+    {
+        trace->stats.records += records;
+        trace->stats.bytes += pos - trace->pos;
+        trace->stats.skipped += skipped;
+        trace->trace_time_us += time_us;
+        trace->pos = pos;
+    }
+    else
+    {
+        trace->stats.mismatches++;
+    }
+    target = trace->start_time + (uint32_t)(trace->trace_time_us / 1000);
+    whd_bus_trace_unlock(trace);
+
+    if ( (payload != NULL) && ( (trace->flags & WHD_BUS_TRACE_REPLAY_TIMED) != 0 ) )
+    {
+        (void)cy_rtos_get_time(&now);
+        if ( (int32_t)(target - now) > 0 )
+        {
+            (void)cy_rtos_delay_milliseconds(target - now);
+        }
+    }
+
+    return payload;
+}
+
+static const whd_bus_trace_value_t *whd_bus_trace_next_value(whd_driver_t whd_driver, whd_bus_trace_op_t op)
+{
+    uint16_t len = 0;
+    const uint8_t *payload = whd_bus_trace_next(whd_driver, op, &len);
+
+    return ( (payload != NULL) && (len >= sizeof(whd_bus_trace_value_t) ) ) ?
+           (const whd_bus_trace_value_t *)payload : NULL;
+}
+
+static const whd_bus_trace_access_t *whd_bus_trace_next_access(whd_driver_t whd_driver, whd_bus_trace_op_t op,
+                                                               uint32_t address)
+{
+    uint16_t len = 0;
+    const uint8_t *payload = whd_bus_trace_next(whd_driver, op, &len);
+    const whd_bus_trace_access_t *rec;
+
+    if ( (payload == NULL) || (len < sizeof(whd_bus_trace_access_t) ) )
+    {
+        return NULL;
+    }
+    rec = (const whd_bus_trace_access_t *)payload;
+    if (rec->address != address)
+    {
+        whd_driver->bus_trace->stats.mismatches++;
+    }
+    return rec;
+}
+
+static whd_result_t whd_bus_trace_replay_success(whd_driver_t whd_driver)
+{
+    UNUSED_PARAMETER(whd_driver);
+    return WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_ack_interrupt(whd_driver_t whd_driver, uint32_t intstatus)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_ACK_INTERRUPT);
+
+    UNUSED_PARAMETER(intstatus);
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_send_buffer(whd_driver_t whd_driver, whd_buffer_t buffer)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_SEND_BUFFER);
+    whd_result_t result = (rec != NULL) ? rec->result : WHD_SUCCESS;
+
+    if ( (rec != NULL) && (rec->value != whd_buffer_get_current_piece_size(whd_driver, buffer) ) )
+    {
+        whd_driver->bus_trace->stats.mismatches++;
+    }
+    CHECK_RETURN(whd_buffer_release(whd_driver, buffer, WHD_NETWORK_TX) );
+    return result;
+}
+
+static whd_bool_t whd_bus_trace_replay_wake_interrupt_present(whd_driver_t whd_driver)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver,
+                                                                WHD_BUS_TRACE_OP_WAKE_INTERRUPT_PRESENT);
+
+    return ( (rec != NULL) && (rec->value != 0) ) ? WHD_TRUE : WHD_FALSE;
+}
+
+static uint32_t whd_bus_trace_replay_packet_available_to_read(whd_driver_t whd_driver)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_PACKET_AVAILABLE);
+
+    return (rec != NULL) ? rec->value : 0;
+}
+
+static whd_result_t whd_bus_trace_replay_read_frame(whd_driver_t whd_driver, whd_buffer_t *buffer)
+{
+    uint16_t len = 0;
+    const uint8_t *payload = whd_bus_trace_next(whd_driver, WHD_BUS_TRACE_OP_READ_FRAME, &len);
+    const whd_bus_trace_value_t *rec = (const whd_bus_trace_value_t *)payload;
+    uint16_t data_len;
+    uint16_t size;
+
+    *buffer = NULL;
+    if ( (payload == NULL) || (len < sizeof(*rec) ) )
+    {
+        return WHD_NO_PACKET_TO_RECEIVE;
+    }
+    data_len = (uint16_t)(len - sizeof(*rec) );
+    if ( (rec->result != WHD_SUCCESS) || (data_len == 0) )
+    {
+        return rec->result;
+    }
+
+    if (whd_host_buffer_get(whd_driver, buffer, WHD_NETWORK_RX, (uint16_t)rec->value, WHD_RX_BUF_TIMEOUT) !=
+        WHD_SUCCESS)
+    {
+        whd_driver->bus_trace->stats.rx_no_buffer++;
+        *buffer = NULL;
+        return WHD_RX_BUFFER_ALLOC_FAIL;
+    }
+    size = whd_buffer_get_current_piece_size(whd_driver, *buffer);
+    whd_mem_memcpy(whd_buffer_get_current_piece_data_pointer(whd_driver, *buffer), payload + sizeof(*rec),
+                   (data_len < size) ? data_len : size);
+    whd_driver->bus_trace->stats.frames++;
+
+    return WHD_SUCCESS;
+}
+
+#ifndef PROTO_MSGBUF
+static whd_result_t whd_bus_trace_replay_set_backplane_window(whd_driver_t whd_driver, uint32_t addr,
+                                                              uint32_t *cur_base_addr)
+{
+    UNUSED_PARAMETER(whd_driver);
+    *cur_base_addr = addr;
+    return WHD_SUCCESS;
+}
+
+#endif /* PROTO_MSGBUF */
+
+static whd_result_t whd_bus_trace_replay_write_backplane_value(whd_driver_t whd_driver, uint32_t address,
+                                                               uint8_t register_length, uint32_t value)
+{
+    const whd_bus_trace_access_t *rec = whd_bus_trace_next_access(whd_driver, WHD_BUS_TRACE_OP_WRITE_BACKPLANE,
+                                                                  address);
+
+    UNUSED_PARAMETER(register_length);
+    UNUSED_PARAMETER(value);
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_read_backplane_value(whd_driver_t whd_driver, uint32_t address,
+                                                              uint8_t register_length, uint8_t *value)
+{
+    const whd_bus_trace_access_t *rec = whd_bus_trace_next_access(whd_driver, WHD_BUS_TRACE_OP_READ_BACKPLANE,
+                                                                  address);
+    uint32_t v = (rec != NULL) ? rec->value : 0;
+
+    whd_mem_memcpy(value, &v, (register_length < sizeof(v) ) ? register_length : sizeof(v) );
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_write_register_value(whd_driver_t whd_driver, whd_bus_function_t function,
+                                                              uint32_t address, uint8_t value_length, uint32_t value)
+{
+    const whd_bus_trace_access_t *rec = whd_bus_trace_next_access(whd_driver, WHD_BUS_TRACE_OP_WRITE_REGISTER,
+                                                                  address);
+
+    UNUSED_PARAMETER(function);
+    UNUSED_PARAMETER(value_length);
+    UNUSED_PARAMETER(value);
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_read_register_value(whd_driver_t whd_driver, whd_bus_function_t function,
+                                                             uint32_t address, uint8_t value_length, uint8_t *value)
+{
+    const whd_bus_trace_access_t *rec = whd_bus_trace_next_access(whd_driver, WHD_BUS_TRACE_OP_READ_REGISTER,
+                                                                  address);
+    uint32_t v = (rec != NULL) ? rec->value : 0;
+
+    UNUSED_PARAMETER(function);
+    whd_mem_memcpy(value, &v, (value_length < sizeof(v) ) ? value_length : sizeof(v) );
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_transfer_bytes(whd_driver_t whd_driver,
+                                                        whd_bus_transfer_direction_t direction,
+                                                        whd_bus_function_t function, uint32_t address, uint16_t size,
+                                                        whd_transfer_bytes_packet_t *data)
+{
+    uint16_t len = 0;
+    const uint8_t *payload = whd_bus_trace_next(whd_driver, WHD_BUS_TRACE_OP_TRANSFER_BYTES, &len);
+    const whd_bus_trace_transfer_t *rec = (const whd_bus_trace_transfer_t *)payload;
+    uint16_t data_len;
+
+    UNUSED_PARAMETER(function);
+    UNUSED_PARAMETER(address);
+    if ( (payload == NULL) || (len < sizeof(*rec) ) )
+    {
+        return WHD_SUCCESS;
+    }
+    if (direction == BUS_READ)
+    {
+        data_len = (uint16_t)(len - sizeof(*rec) );
+        whd_mem_memcpy(data->data, payload + sizeof(*rec), (data_len < size) ? data_len : size);
+    }
+    return rec->result;
+}
+
+static whd_result_t whd_bus_trace_replay_poke_wlan(whd_driver_t whd_driver)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_POKE_WLAN);
+
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_wakeup(whd_driver_t whd_driver)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_WAKEUP);
+
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_sleep(whd_driver_t whd_driver)
+{
+    const whd_bus_trace_value_t *rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_SLEEP);
+
+    return (rec != NULL) ? rec->result : WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_wait_for_wlan_event(whd_driver_t whd_driver,
+                                                             cy_semaphore_t *transceive_semaphore)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+    const whd_bus_trace_value_t *rec;
+
+    if (whd_bus_trace_replay_done(whd_driver) == WHD_TRUE)
+    {
+        if ( (trace->flags & WHD_BUS_TRACE_REPLAY_QUIT_AT_END) != 0 )
+        {
+            whd_driver->thread_info.thread_quit_flag = WHD_TRUE;
+            return WHD_SUCCESS;
+        }
+        /* Idle like a real bus with nothing pending */
+        return cy_rtos_get_semaphore(transceive_semaphore, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    }
+
+    rec = whd_bus_trace_next_value(whd_driver, WHD_BUS_TRACE_OP_WAIT_FOR_EVENT);
+    if (rec == NULL)
+    {
+        /* The thread calls this once per loop, so always make progress here */
+        whd_bus_trace_lock(trace);
+        if (trace->pos + sizeof(whd_bus_trace_record_t) <= trace->len)
+        {
+            trace->pos += sizeof(whd_bus_trace_record_t) +
+                          ( (const whd_bus_trace_record_t *)(trace->trace + trace->pos) )->len;
+            trace->stats.skipped++;
+        }
+        whd_bus_trace_unlock(trace);
+        return WHD_SUCCESS;
+    }
+
+    /* Wake-ups from the application are replayed as they happen, not as recorded */
+    (void)cy_rtos_get_semaphore(transceive_semaphore, 0, WHD_FALSE);
+    if (rec->value != 0)
+    {
+        whd_driver->thread_info.bus_interrupt = WHD_TRUE;
+    }
+    return rec->result;
+}
+
+static whd_bool_t whd_bus_trace_replay_use_status_report_scheme(whd_driver_t whd_driver)
+{
+    return ( (whd_driver->bus_trace->header.flags & WHD_BUS_TRACE_HDR_STATUS_REPORT) != 0 ) ? WHD_TRUE : WHD_FALSE;
+}
+
+static uint32_t whd_bus_trace_replay_get_max_transfer_size(whd_driver_t whd_driver)
+{
+    return whd_driver->bus_trace->header.max_transfer_size;
+}
+
+static uint8_t whd_bus_trace_replay_backplane_read_padd_size(whd_driver_t whd_driver)
+{
+    return whd_driver->bus_trace->header.backplane_read_padd_size;
+}
+
+static void whd_bus_trace_replay_init_stats(whd_driver_t whd_driver)
+{
+    whd_mem_memset(&whd_driver->bus_trace->stats, 0, sizeof(whd_driver->bus_trace->stats) );
+}
+
+static whd_result_t whd_bus_trace_replay_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
+{
+    whd_bus_trace_stats_t *stats = &whd_driver->bus_trace->stats;
+
+    WPRINT_MACRO( ("Bus trace replay: records %" PRIu32 " bytes %" PRIu32 " frames %" PRIu32 " skipped %" PRIu32
+                   " mismatches %" PRIu32 " rx_no_buffer %" PRIu32 "\n", stats->records, stats->bytes,
+                   stats->frames, stats->skipped, stats->mismatches, stats->rx_no_buffer) );
+    if (reset_after_print == WHD_TRUE)
+    {
+        whd_mem_memset(stats, 0, sizeof(*stats) );
+    }
+    return WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_reinit_stats(whd_driver_t whd_driver, whd_bool_t wake_from_firmware)
+{
+    UNUSED_PARAMETER(whd_driver);
+    UNUSED_PARAMETER(wake_from_firmware);
+    return WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_irq_enable(whd_driver_t whd_driver, whd_bool_t enable)
+{
+    UNUSED_PARAMETER(whd_driver);
+    UNUSED_PARAMETER(enable);
+    return WHD_SUCCESS;
+}
+
+static whd_result_t whd_bus_trace_replay_download_resource(whd_driver_t whd_driver, whd_resource_type_t resource,
+                                                           whd_bool_t direct_resource, uint32_t address,
+                                                           uint32_t image_size)
+{
+    UNUSED_PARAMETER(whd_driver);
+    UNUSED_PARAMETER(resource);
+    UNUSED_PARAMETER(direct_resource);
+    UNUSED_PARAMETER(address);
+    UNUSED_PARAMETER(image_size);
+    return WHD_SUCCESS;
+}
+
+#ifdef BLHS_SUPPORT
+static whd_result_t whd_bus_trace_replay_blhs(whd_driver_t whd_driver, whd_bus_blhs_stage_t stage)
+{
+    UNUSED_PARAMETER(whd_driver);
+    UNUSED_PARAMETER(stage);
+    return WHD_SUCCESS;
+}
+
+#endif /* BLHS_SUPPORT */
+
+whd_result_t whd_bus_trace_replay_start(whd_driver_t whd_driver, const uint8_t *trace_data, uint32_t len,
+                                        uint32_t flags)
+{
+    struct whd_bus_trace *trace;
+    whd_bus_info_t *bus_if;
+    uint16_t proto_flag = 0;
+
+#ifdef PROTO_MSGBUF
+    proto_flag = WHD_BUS_TRACE_HDR_MSGBUF;
+#endif /* PROTO_MSGBUF */
+
+    if ( (whd_driver == NULL) || (trace_data == NULL) || (len < sizeof(whd_bus_trace_file_header_t) ) ||
+         (whd_driver->bus_trace != NULL) )
+    {
+        return WHD_BADARG;
+    }
+
+    trace = (struct whd_bus_trace *)whd_mem_calloc(1, sizeof(struct whd_bus_trace) );
+    if (trace == NULL)
+    {
+        WPRINT_WHD_ERROR( ("Memory allocation failed for whd_bus_trace in %s\n", __FUNCTION__) );
+        return WHD_MALLOC_FAILURE;
+    }
+    whd_mem_memcpy(&trace->header, trace_data, sizeof(trace->header) );
+    if ( (trace->header.magic != WHD_BUS_TRACE_MAGIC) || (trace->header.version != WHD_BUS_TRACE_VERSION) ||
+         ( (trace->header.flags & WHD_BUS_TRACE_HDR_MSGBUF) != proto_flag ) )
+    {
+        WPRINT_WHD_ERROR( ("%s: not a bus trace for this protocol\n", __func__) );
+        whd_mem_free(trace);
+        return WHD_BADARG;
+    }
+    if ( (cy_rtos_init_semaphore(&trace->lock, 1, 0) != WHD_SUCCESS) ||
+         (cy_rtos_set_semaphore(&trace->lock, WHD_FALSE) != WHD_SUCCESS) )
+    {
+        whd_mem_free(trace);
+        return WHD_SEMAPHORE_ERROR;
+    }
+
+    trace->replay = WHD_TRUE;
+    trace->orig_bus_if = whd_driver->bus_if;
+    trace->trace = trace_data;
+    trace->len = len;
+    trace->pos = sizeof(whd_bus_trace_file_header_t);
+    trace->flags = flags;
+    trace->stats.bytes = sizeof(whd_bus_trace_file_header_t);
+    (void)cy_rtos_get_time(&trace->start_time);
+
+    bus_if = &trace->bus_if;
+    bus_if->whd_bus_init_fptr = whd_bus_trace_replay_success;
+    bus_if->whd_bus_deinit_fptr = whd_bus_trace_replay_success;
+    bus_if->whd_bus_ack_interrupt_fptr = whd_bus_trace_replay_ack_interrupt;
+    bus_if->whd_bus_send_buffer_fptr = whd_bus_trace_replay_send_buffer;
+    bus_if->whd_bus_wake_interrupt_present_fptr = whd_bus_trace_replay_wake_interrupt_present;
+    bus_if->whd_bus_packet_available_to_read_fptr = whd_bus_trace_replay_packet_available_to_read;
+    bus_if->whd_bus_read_frame_fptr = whd_bus_trace_replay_read_frame;
+#ifndef PROTO_MSGBUF
+    bus_if->whd_bus_set_backplane_window_fptr = whd_bus_trace_replay_set_backplane_window;
+#endif /* PROTO_MSGBUF */
+    bus_if->whd_bus_write_backplane_value_fptr = whd_bus_trace_replay_write_backplane_value;
+    bus_if->whd_bus_read_backplane_value_fptr = whd_bus_trace_replay_read_backplane_value;
+    bus_if->whd_bus_write_register_value_fptr = whd_bus_trace_replay_write_register_value;
+    bus_if->whd_bus_read_register_value_fptr = whd_bus_trace_replay_read_register_value;
+    bus_if->whd_bus_transfer_bytes_fptr = whd_bus_trace_replay_transfer_bytes;
+    bus_if->whd_bus_poke_wlan_fptr = whd_bus_trace_replay_poke_wlan;
+    bus_if->whd_bus_wakeup_fptr = whd_bus_trace_replay_wakeup;
+    bus_if->whd_bus_sleep_fptr = whd_bus_trace_replay_sleep;
+    bus_if->whd_bus_backplane_read_padd_size_fptr = whd_bus_trace_replay_backplane_read_padd_size;
+    bus_if->whd_bus_wait_for_wlan_event_fptr = whd_bus_trace_replay_wait_for_wlan_event;
+    bus_if->whd_bus_use_status_report_scheme_fptr = whd_bus_trace_replay_use_status_report_scheme;
+    bus_if->whd_bus_get_max_transfer_size_fptr = whd_bus_trace_replay_get_max_transfer_size;
+    bus_if->whd_bus_init_stats_fptr = whd_bus_trace_replay_init_stats;
+    bus_if->whd_bus_print_stats_fptr = whd_bus_trace_replay_print_stats;
+    bus_if->whd_bus_reinit_stats_fptr = whd_bus_trace_replay_reinit_stats;
+    bus_if->whd_bus_irq_register_fptr = whd_bus_trace_replay_success;
+    bus_if->whd_bus_irq_enable_fptr = whd_bus_trace_replay_irq_enable;
+    bus_if->whd_bus_download_resource_fptr = whd_bus_trace_replay_download_resource;
+#ifdef BLHS_SUPPORT
+    bus_if->whd_bus_blhs_fptr = whd_bus_trace_replay_blhs;
+#endif /* BLHS_SUPPORT */
+
+    whd_driver->bus_trace = trace;
+    whd_driver->bus_if = bus_if;
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_bus_trace_replay_stop(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace;
+
+    if ( (whd_driver == NULL) || (whd_driver->bus_trace == NULL) || (whd_driver->bus_trace->replay != WHD_TRUE) )
+    {
+        return WHD_BADARG;
+    }
+    trace = whd_driver->bus_trace;
+
+    whd_driver->bus_if = trace->orig_bus_if;
+    whd_driver->bus_trace = NULL;
+    (void)cy_rtos_deinit_semaphore(&trace->lock);
+    whd_mem_free(trace);
+
+    return WHD_SUCCESS;
+}
+
+whd_bool_t whd_bus_trace_replay_done(whd_driver_t whd_driver)
+{
+    struct whd_bus_trace *trace = whd_driver->bus_trace;
+
+    if ( (trace == NULL) || (trace->replay != WHD_TRUE) )
+    {
+        return WHD_FALSE;
+    }
+    return (trace->pos + sizeof(whd_bus_trace_record_t) > trace->len) ? WHD_TRUE : WHD_FALSE;
+}
+
+/******************************************************
+*             Common
+******************************************************/
+
+whd_result_t whd_bus_trace_get_stats(whd_driver_t whd_driver, whd_bus_trace_stats_t *stats)
+{
+    struct whd_bus_trace *trace;
+
+    if ( (whd_driver == NULL) || (stats == NULL) || (whd_driver->bus_trace == NULL) )
+    {
+        return WHD_BADARG;
+    }
+    trace = whd_driver->bus_trace;
+
+    whd_bus_trace_lock(trace);
+    *stats = trace->stats;
+    whd_bus_trace_unlock(trace);
+
+    return WHD_SUCCESS;
+}
+
+static void whd_bus_trace_lock(struct whd_bus_trace *trace)
+{
+    (void)cy_rtos_get_semaphore(&trace->lock, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+}
+
+static void whd_bus_trace_unlock(struct whd_bus_trace *trace)
+{
+    (void)cy_rtos_set_semaphore(&trace->lock, WHD_FALSE);
+}
+
+#endif /* WHD_BUS_TRACE */
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Bus transaction record and replay
+ *
+ *  Recording interposes on whd_driver->bus_if: every call is forwarded to the
+ *  real bus and a compact binary record of it (arguments, result, values read
+ *  and received frames) is handed to a caller supplied sink. Replay installs a
+ *  bus that answers from such a trace instead of the hardware, so the WHD
+ *  thread, SDPCM and CDC/BDC layers can be driven from a capture on a host.
+ *
+ *  Only built when WHD_BUS_TRACE is defined.
+ */
+
+#ifndef INCLUDED_WHD_BUS_TRACE_H_
+#define INCLUDED_WHD_BUS_TRACE_H_
+
+#include "whd.h"
+
+#ifdef WHD_BUS_TRACE
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#define WHD_BUS_TRACE_MAGIC                 (0x54444857)    /* "WHDT" */
+#define WHD_BUS_TRACE_VERSION               (1)
+
+/* Trace header flags */
+#define WHD_BUS_TRACE_HDR_MSGBUF            (0x0001)    /* Recorded by a PROTO_MSGBUF build */
+#define WHD_BUS_TRACE_HDR_STATUS_REPORT     (0x0002)    /* Bus used the status report scheme */
+
+/* Record flags */
+#define WHD_BUS_TRACE_REC_NESTED            (0x01)      /* Issued by the bus driver inside another bus call */
+#define WHD_BUS_TRACE_REC_TRUNCATED         (0x02)      /* Data was cut to fit the record */
+
+/* Replay flags */
+#define WHD_BUS_TRACE_REPLAY_TIMED          (0x0001)    /* Reproduce the recorded gaps between calls */
+#define WHD_BUS_TRACE_REPLAY_QUIT_AT_END    (0x0002)    /* Stop the WHD thread once the trace is consumed */
+
+/** Largest number of bytes of each transmitted frame kept in the trace */
+#define WHD_BUS_TRACE_TX_SNAP_MAX           (64)
+
+/** Number of records replay looks ahead to find the one a call expects */
+#define WHD_BUS_TRACE_RESYNC_WINDOW         (16)
+
+/******************************************************
+*                   Enumerations
+******************************************************/
+
+typedef enum
+{
+    WHD_BUS_TRACE_OP_ACK_INTERRUPT = 1,
+    WHD_BUS_TRACE_OP_SEND_BUFFER,
+    WHD_BUS_TRACE_OP_WAKE_INTERRUPT_PRESENT,
+    WHD_BUS_TRACE_OP_PACKET_AVAILABLE,
+    WHD_BUS_TRACE_OP_READ_FRAME,
+    WHD_BUS_TRACE_OP_WRITE_BACKPLANE,
+    WHD_BUS_TRACE_OP_READ_BACKPLANE,
+    WHD_BUS_TRACE_OP_WRITE_REGISTER,
+    WHD_BUS_TRACE_OP_READ_REGISTER,
+    WHD_BUS_TRACE_OP_TRANSFER_BYTES,
+    WHD_BUS_TRACE_OP_POKE_WLAN,
+    WHD_BUS_TRACE_OP_WAKEUP,
+    WHD_BUS_TRACE_OP_SLEEP,
+    WHD_BUS_TRACE_OP_WAIT_FOR_EVENT,
+} whd_bus_trace_op_t;
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+#pragma pack(1)
+/** Start of every trace; all fields are little endian */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;                 /* WHD_BUS_TRACE_HDR_* */
+    uint32_t time_unit_us;          /* Unit of whd_bus_trace_record_t::delta */
+    uint32_t max_transfer_size;
+    uint8_t backplane_read_padd_size;
+    uint8_t reserved[3];
+} whd_bus_trace_file_header_t;
+
+/** Header of each record, followed by len bytes of op specific payload */
+typedef struct
+{
+    uint8_t op;                     /* whd_bus_trace_op_t */
+    uint8_t flags;                  /* WHD_BUS_TRACE_REC_* */
+    uint16_t len;
+    uint32_t delta;                 /* Time since the previous record */
+} whd_bus_trace_record_t;
+
+/** Payload of the calls returning a single value; frame and TX bytes follow for
+ *  READ_FRAME and SEND_BUFFER, where value is the full buffer length */
+typedef struct
+{
+    uint32_t result;
+    uint32_t value;
+} whd_bus_trace_value_t;
+
+/** Payload of backplane and register accesses */
+typedef struct
+{
+    uint32_t result;
+    uint32_t address;
+    uint32_t value;
+    uint8_t function;
+    uint8_t length;
+} whd_bus_trace_access_t;
+
+/** Payload of transfer_bytes; the bytes read follow for BUS_READ */
+typedef struct
+{
+    uint32_t result;
+    uint32_t address;
+    uint16_t size;
+    uint8_t function;
+    uint8_t direction;
+} whd_bus_trace_transfer_t;
+#pragma pack()
+
+/** Sink for recorded bytes; returns 0 if all len bytes were accepted
+ *
+ *  Called with the trace lock held from whichever thread made the bus call, so
+ *  it must not block for long or call back into WHD.
+ */
+typedef int (*whd_bus_trace_write_t)(void *ctx, const uint8_t *data, uint32_t len);
+
+typedef struct
+{
+    whd_bus_trace_write_t write;
+    void *ctx;
+    uint32_t (*get_time_us)(void);  /* Optional, cy_rtos_get_time() milliseconds are used when NULL */
+    uint16_t tx_snap_len;           /* Bytes of each sent buffer to keep, up to WHD_BUS_TRACE_TX_SNAP_MAX */
+} whd_bus_trace_config_t;
+
+typedef struct
+{
+    uint32_t records;               /* Records written, or consumed by replay */
+    uint32_t bytes;                 /* Trace bytes written or consumed */
+    uint32_t frames;                /* Received frames recorded or delivered */
+    uint32_t sink_errors;           /* Records the sink refused */
+    uint32_t skipped;               /* Replay: records passed over to resynchronise */
+    uint32_t mismatches;            /* Replay: calls with no matching record, or a different TX length */
+    uint32_t rx_no_buffer;          /* Replay: frames dropped because no RX buffer was available */
+} whd_bus_trace_stats_t;
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Starts recording the bus calls of a driver
+ *
+ *  The bus must already be attached. The trace header is written
+ *  immediately; every later call through whd_driver->bus_if is recorded until
+ *  whd_bus_trace_record_stop() is called.
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param config      : Sink and options, copied
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_bus_trace_record_start(whd_driver_t whd_driver, const whd_bus_trace_config_t *config);
+
+/** Stops recording and restores the original bus
+ *
+ * @param whd_driver  : WHD driver instance
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_bus_trace_record_stop(whd_driver_t whd_driver);
+
+/** Replaces the bus of a driver with one answering from a recorded trace
+ *
+ *  Frames are copied into fresh RX buffers from whd_driver->buffer_if, sent
+ *  buffers are checked against the recorded length and released. When a call
+ *  does not match the next record, up to WHD_BUS_TRACE_RESYNC_WINDOW records
+ *  are skipped to find one that does. The trace must stay valid until
+ *  whd_bus_trace_replay_stop().
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param trace       : Trace, starting with whd_bus_trace_file_header_t
+ * @param len         : Length of the trace in bytes
+ * @param flags       : WHD_BUS_TRACE_REPLAY_*
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_bus_trace_replay_start(whd_driver_t whd_driver, const uint8_t *trace, uint32_t len,
+                                        uint32_t flags);
+
+/** Removes the replay bus and restores the bus that was attached before
+ *
+ * @param whd_driver  : WHD driver instance
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_bus_trace_replay_stop(whd_driver_t whd_driver);
+
+/** Reports whether replay has consumed the whole trace
+ *
+ * @param whd_driver  : WHD driver instance
+ *
+ * @return WHD_TRUE once every record has been consumed or skipped
+ */
+whd_bool_t whd_bus_trace_replay_done(whd_driver_t whd_driver);
+
+/** Copies the counters of the active recording or replay
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param stats       : Receives the counters
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if neither is active
+ */
+whd_result_t whd_bus_trace_get_stats(whd_driver_t whd_driver, whd_bus_trace_stats_t *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* WHD_BUS_TRACE */
+
+#endif /* INCLUDED_WHD_BUS_TRACE_H_ */
@@ -21,6 +21,7 @@
 #ifndef PROTO_MSGBUF
 #include "whd.h"
 #include "cyabs_rtos.h"
+#include "whd_lock.h"
 #include "whd_events_int.h"
 #include "whd_types_int.h"
 
@@ -101,7 +102,7 @@ typedef struct whd_cdc_info
 {
     /* Event list variables (Must be at the begining) */
     event_list_elem_t whd_event_list[WHD_EVENT_HANDLER_LIST_SIZE];
-    cy_semaphore_t event_list_mutex;
+    whd_lock_t event_list_mutex;
 
     /* IOCTL variables*/
     uint16_t requested_ioctl_id;
@@ -132,7 +133,7 @@ typedef struct whd_error_info
 {
     /* Event list variables */
     error_list_elem_t whd_event_list[WHD_EVENT_HANDLER_LIST_SIZE];
-    cy_semaphore_t event_list_mutex;
+    whd_lock_t event_list_mutex;
 } whd_error_info_t;
 #endif
 
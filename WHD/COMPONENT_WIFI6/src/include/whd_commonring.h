@@ -19,6 +19,7 @@
 #define INCLUDED_WHD_COMMONRING_H
 
 #include "cyabs_rtos.h"
+#include "whd_lock.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -33,6 +34,28 @@ extern "C"
 #define MAX(x, y) ( (x) > (y) ? (x) : (y) )
 #endif /* MAX */
 
+/* When whd_commonring_write_complete() publishes the write pointer and rings the doorbell.
+ * Items written since the last doorbell are held until first_pending of them are pending in a
+ * batch (max_pending for each later doorbell of the same batch), until the oldest has waited
+ * max_delay_ms, or until whd_commonring_flush() ends the batch. A zeroed policy rings on every
+ * write_complete, as a ring did before it had a policy.
+ */
+struct whd_commonring_db_policy
+{
+    uint16_t first_pending;     /* Items pending before the first doorbell of a batch */
+    uint16_t max_pending;       /* Items pending before each later doorbell of the batch */
+    uint32_t max_delay_ms;      /* Age of the oldest pending item before a doorbell, 0 for none */
+};
+
+struct whd_commonring_db_stats
+{
+    uint32_t items;             /* Items published to the device */
+    uint32_t doorbells;         /* Doorbells rung for them */
+    uint32_t threshold_bells;   /* ... because a count threshold was reached */
+    uint32_t deadline_bells;    /* ... because the oldest pending item ran out of time */
+    uint32_t flush_bells;       /* ... because the batch ended */
+};
+
 struct whd_commonring
 {
     uint16_t r_ptr;
@@ -51,11 +74,17 @@ struct whd_commonring
 
     void *cr_ctx;
 
-    cy_semaphore_t lock;
+    whd_lock_t lock;
     //unsigned long flags;
     uint8_t inited;
     uint8_t was_full;
 
+    struct whd_commonring_db_policy db_policy;
+    struct whd_commonring_db_stats db_stats;
+    uint16_t db_pending;        /* Items written and not yet published */
+    uint8_t db_in_batch;        /* A doorbell went out since the last flush */
+    cy_time_t db_first_ms;      /* Time the oldest pending item was written */
+
     //atomic_t outstanding_tx;
 };
 
@@ -74,6 +103,11 @@ void *whd_commonring_reserve_for_write(struct whd_commonring *commonring);
 void *whd_commonring_reserve_for_write_multiple(struct whd_commonring *commonring,
                                                 uint16_t n_items, uint16_t *alloced);
 int whd_commonring_write_complete(struct whd_commonring *commonring);
+int whd_commonring_flush(struct whd_commonring *commonring);
+void whd_commonring_set_db_policy(struct whd_commonring *commonring,
+                                  const struct whd_commonring_db_policy *policy);
+void whd_commonring_get_db_stats(struct whd_commonring *commonring,
+                                 struct whd_commonring_db_stats *stats, whd_bool_t reset);
 void whd_commonring_write_cancel(struct whd_commonring *commonring,
                                  uint16_t n_items);
 void *whd_commonring_get_read_ptr(struct whd_commonring *commonring,
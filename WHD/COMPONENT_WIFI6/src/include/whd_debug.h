@@ -130,6 +130,11 @@ extern "C"
 void whd_init_stats(whd_driver_t whd_driver);
 void whd_print_logbuffer(void);
 
+/* Print the deepest stack use of a thread and the peak depth of a queue, as far as the RTOS port
+ * tracks them (see CY_RTOS_HIGH_WATER in cyabs_rtos.h). Nothing is printed when it does not. */
+void whd_print_thread_stack_usage(const char *name, cy_thread_t *thread);
+void whd_print_queue_usage(const char *name, cy_queue_t *queue, uint32_t length);
+
 
 #ifdef WHD_LOGGING_BUFFER_ENABLE
 #define LOGGING_BUFFER_SIZE (4 * 1024)
@@ -169,6 +169,8 @@ typedef enum
     WLC_E_RRM = 141,                 /* RRM Event */
     WLC_E_ULP = 146,                 /* ULP entry event */
     WLC_E_TKO = 151,                 /* TCP Keep Alive Offload Event */
+    WLC_E_TWT_SETUP = 157,           /* TWT agreement set up or rejected */
+    WLC_E_TWT_TEARDOWN = 158,        /* TWT agreement torn down */
     WLC_E_EXT_AUTH_REQ = 187,        /* authentication request received */
     WLC_E_EXT_AUTH_FRAME_RX = 188,   /* authentication request received */
     WLC_E_MGMT_FRAME_TXSTATUS = 189, /* mgmt frame Tx complete */
@@ -456,6 +458,9 @@ typedef enum
     WHD_CSI_EVENT_ENTRY,
 #endif /* defined(COMPONENT_WLANSENSE) */
     WHD_ICMP_ECHO_REQ_EVENT_ENTRY,
+#ifdef WHD_TWT_TX_HOLD
+    WHD_TWT_EVENT_ENTRY,
+#endif /* WHD_TWT_TX_HOLD */
     WHD_EVENT_ENTRY_MAX
 } whd_event_entry_t;
 
@@ -29,6 +29,7 @@ extern "C"
 
 #define WHD_FLOWRING_HASHSIZE       16     /* has to be 2^x */
 #define WHD_FLOWRING_INVALID_ID     0xFFFFFFFF
+#define WHD_FLOWRING_INVALID_IFIDX  0xff
 
 enum proto_addr_mode
 {
@@ -35,6 +35,9 @@
 #if defined(COMPONENT_WLANSENSE)
 #include "whd_wlansense_core.h"
 #endif /* defined(COMPONENT_WLANSENSE) */
+#include "whd_pkt_trace.h"
+#include "whd_pm_policy.h"
+#include "whd_twt_tx.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -114,6 +117,9 @@ struct whd_driver
     /* Bus variables */
     struct whd_bus_info *bus_if;
     struct whd_bus_priv *bus_priv;
+#ifdef WHD_BUS_TRACE
+    struct whd_bus_trace *bus_trace;
+#endif /* WHD_BUS_TRACE */
     struct whd_bus_common_info *bus_common_info;
     struct whd_proto *proto;
     whd_bt_dev_t bt_dev;
@@ -136,6 +142,18 @@ struct whd_driver
     whd_chip_info_t chip_info;
 
     whd_stats_t whd_stats;
+#ifdef WHD_PKT_TRACE
+    struct whd_pkt_trace *pkt_trace;
+#endif /* WHD_PKT_TRACE */
+#ifdef WHD_PM_POLICY
+    struct whd_pm_policy *pm_policy;
+#endif /* WHD_PM_POLICY */
+#ifdef WHD_TWT_TX_HOLD
+    struct whd_twt_tx *twt_tx;
+#endif /* WHD_TWT_TX_HOLD */
+#if defined(COMPONENT_WLANSENSE)
+    struct whd_wlansense *wlansense;
+#endif /* defined(COMPONENT_WLANSENSE) */
     whd_country_code_t country;
 #ifdef WHD_IOCTL_LOG_ENABLE
     whd_ioctl_log_t whd_ioctl_log[WHD_IOCTL_LOG_SIZE];
@@ -155,6 +173,7 @@ struct whd_driver
 #endif
 
 #ifdef PROTO_MSGBUF
+    struct dma_pool *dma_pool;
     cy_timer_t rxbuf_update_timer;
     bool update_buffs;
     bool force_rx_read;
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Driver internal locks
+ *
+ *  Guards the driver's own queues and tables. Each lock is declared with the kind of section it
+ *  protects, and is mapped onto the cheapest primitive that is correct for that kind:
+ *
+ *  - WHD_LOCK_BLOCKING sections may wait while holding the lock (buffer allocation, IOCTLs,
+ *    nested locks). They use a cyabs_rtos mutex: a priority inheritance mutex on FreeRTOS and a
+ *    pthread mutex with an uncontended fast path in user space on the POSIX port.
+ *  - WHD_LOCK_SHORT sections only touch a few fields and never block. They use the same mutex by
+ *    default. On single core targets, building with WHD_LOCK_USE_CRITICAL_SECTION maps them onto
+ *    cy_rtos_scheduler_suspend()/resume() instead (vTaskSuspendAll() on FreeRTOS). That only stops
+ *    other threads; interrupts stay enabled, so an interrupt handler is not excluded and must not
+ *    touch what these locks protect.
+ *
+ *  Nothing may call into the RTOS, the network stack or print while holding a WHD_LOCK_SHORT lock.
+ *
+ *  With WHD_LOCK_STATS each lock counts acquisitions and contention and records wait and hold
+ *  times. Times come from WHD_LOCK_GET_TIME_US(), which defaults to the millisecond RTOS clock and
+ *  can be pointed at a cycle counter for finer resolution.
+ */
+
+#ifndef INCLUDED_WHD_LOCK_H_
+#define INCLUDED_WHD_LOCK_H_
+
+#include "cyabs_rtos.h"
+#include "whd.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#define WHD_LOCK_NAME_DEFAULT   "whd_lock"
+
+/******************************************************
+*                   Enumerations
+******************************************************/
+
+typedef enum
+{
+    WHD_LOCK_SHORT = 0,     /* A few instructions, never blocks while held */
+    WHD_LOCK_BLOCKING,      /* May block while held */
+} whd_lock_type_t;
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct
+{
+    uint32_t acquired;      /* Successful acquisitions */
+    uint32_t contended;     /* Acquisitions that found the lock taken and had to wait */
+    uint32_t timeouts;      /* Acquisitions that gave up */
+    uint32_t max_wait_us;
+    uint32_t max_hold_us;
+    uint64_t total_wait_us;
+    uint64_t total_hold_us;
+} whd_lock_stats_t;
+
+typedef struct whd_lock
+{
+    cy_mutex_t mutex;
+    whd_lock_type_t type;
+    whd_bool_t inited;
+#ifdef WHD_LOCK_STATS
+    const char *name;
+    uint32_t hold_start_us;
+    whd_lock_stats_t stats;
+#endif /* WHD_LOCK_STATS */
+} whd_lock_t;
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Initialises a lock in the released state
+ *
+ * @param lock  : Lock to initialise
+ * @param name  : Name used when printing statistics, kept by reference
+ * @param type  : Kind of section the lock protects
+ *
+ * @return WHD_SUCCESS or WHD_SEMAPHORE_ERROR
+ */
+whd_result_t whd_lock_init(whd_lock_t *lock, const char *name, whd_lock_type_t type);
+
+/** Frees the primitive behind a lock; the lock must not be held */
+whd_result_t whd_lock_deinit(whd_lock_t *lock);
+
+/** Acquires a lock
+ *
+ * @param lock        : Lock to acquire
+ * @param timeout_ms  : How long to wait, CY_RTOS_NEVER_TIMEOUT to wait forever.
+ *                      Ignored for WHD_LOCK_SHORT locks built with WHD_LOCK_USE_CRITICAL_SECTION.
+ *
+ * @return WHD_SUCCESS, or WHD_SEMAPHORE_ERROR if the lock was not acquired
+ */
+whd_result_t whd_lock_acquire(whd_lock_t *lock, uint32_t timeout_ms);
+
+/** Releases a lock held by the calling thread
+ *
+ * @return WHD_SUCCESS or WHD_SEMAPHORE_ERROR
+ */
+whd_result_t whd_lock_release(whd_lock_t *lock);
+
+#ifdef WHD_LOCK_STATS
+/** Copies the statistics of a lock */
+whd_result_t whd_lock_get_stats(whd_lock_t *lock, whd_lock_stats_t *stats);
+
+/** Prints the statistics of a lock on one line
+ *
+ * @param lock               : Lock to print
+ * @param reset_after_print  : Clear the statistics afterwards
+ */
+void whd_lock_print_stats(whd_lock_t *lock, whd_bool_t reset_after_print);
+#endif /* WHD_LOCK_STATS */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_LOCK_H_ */
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Driver memory arena
+ *
+ *  Built with WHD_MEM_ARENA, whd_mem_malloc(), whd_mem_calloc() and whd_mem_free() never use the
+ *  heap. whd_init() carves the arena passed in whd_init_config_t into fixed size classes, each a
+ *  free list of equal blocks, and an allocation takes a block from the smallest class that fits
+ *  and has one free. The rest of the arena is a bump region for the few allocations larger than
+ *  any class, such as the driver structure itself.
+ *
+ *  The bump region only serves the init phases. whd_wifi_on() seals the arena when it succeeds;
+ *  after that an allocation that no class can serve fails and is reported as an error, which is
+ *  how a runtime allocation that the classes were not sized for is detected. whd_wifi_off()
+ *  unseals it and hands back the bump space taken since whd_wifi_on() started, provided it has
+ *  all been freed, so that on/off cycles do not use the bump region up.
+ *
+ *  The allocator functions carry no driver handle, so there is one arena per build rather than
+ *  one per driver instance, and its seal and mark follow that driver's whd_wifi_on() and
+ *  whd_wifi_off(). The arena is therefore owned by one driver at a time: whd_init() of a second
+ *  driver fails with WHD_UNSUPPORTED, and the arena is only torn down by the owner's whd_deinit().
+ *  A second driver can be initialised once the first has been deinitialised.
+ */
+
+#ifndef INCLUDED_WHD_MEM_ARENA_H_
+#define INCLUDED_WHD_MEM_ARENA_H_
+
+#include <stddef.h>
+#include "whd.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef WHD_MEM_ARENA
+
+#ifdef WHD_USE_CUSTOM_MALLOC_IMPL
+#error "WHD_MEM_ARENA provides whd_mem_malloc() and cannot be combined with WHD_USE_CUSTOM_MALLOC_IMPL"
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#ifndef WHD_MEM_ARENA_MAX_CLASSES
+#define WHD_MEM_ARENA_MAX_CLASSES   (12)
+#endif
+
+/* Used when whd_init_config_t does not name any classes, about 21 KB */
+#ifndef WHD_MEM_ARENA_DEFAULT_CLASSES
+#define WHD_MEM_ARENA_DEFAULT_CLASSES \
+    { {32, 32}, {64, 32}, {128, 16}, {256, 16}, {512, 8}, {1024, 4}, {2048, 2} }
+#endif
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct
+{
+    uint32_t block_size;
+    uint32_t num_blocks;
+    uint32_t in_use;
+    uint32_t high_water;        /* Most blocks in use at once */
+    uint32_t overflow;          /* Requests that fitted but found the class empty */
+} whd_mem_arena_class_stats_t;
+
+typedef struct
+{
+    uint32_t num_classes;
+    whd_mem_arena_class_stats_t classes[WHD_MEM_ARENA_MAX_CLASSES];
+    uint32_t bump_size;
+    uint32_t bump_used;
+    uint32_t bump_high_water;
+    uint32_t bump_live;         /* Bump allocations not yet freed */
+    uint32_t failed;            /* Allocations that could not be served */
+    uint32_t failed_sealed;     /* ... of which after whd_wifi_on() */
+    uint32_t largest_failed;    /* Size of the largest failed request */
+} whd_mem_arena_stats_t;
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Carves an arena into its size classes and starts serving allocations from it
+ *
+ * @param arena        : Memory to carve, at least 8 byte aligned
+ * @param size         : Size of arena in bytes
+ * @param classes      : Size classes in increasing block size, NULL for WHD_MEM_ARENA_DEFAULT_CLASSES
+ * @param num_classes  : Number of entries in classes
+ *
+ * @return WHD_SUCCESS, WHD_BADARG if the classes are invalid, WHD_MALLOC_FAILURE if they do not
+ *         fit in the arena or WHD_UNSUPPORTED if the arena already serves a driver
+ */
+whd_result_t whd_mem_arena_init(void *arena, uint32_t size, const whd_mem_arena_class_t *classes,
+                                uint32_t num_classes);
+
+/** Stops serving allocations and reports blocks that were never freed */
+void whd_mem_arena_deinit(void);
+
+/** Marks the bump region; later bump allocations are given back by whd_mem_arena_rewind() */
+void whd_mem_arena_mark(void);
+
+/** Gives back the bump space taken since whd_mem_arena_mark(), if all of it has been freed */
+void whd_mem_arena_rewind(void);
+
+/** Seals or unseals the arena; once sealed an allocation that no class can serve is an error */
+void whd_mem_arena_seal(whd_bool_t sealed);
+
+/** Allocates from the arena, see whd_mem_malloc() */
+void *whd_mem_arena_alloc(size_t size);
+
+/** Returns memory from whd_mem_arena_alloc() to the arena */
+void whd_mem_arena_free(void *ptr);
+
+/** Copies the arena statistics */
+whd_result_t whd_mem_arena_get_stats(whd_mem_arena_stats_t *stats);
+
+/** Prints the arena statistics, one line per size class */
+void whd_mem_arena_print_stats(void);
+
+#endif /* WHD_MEM_ARENA */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_MEM_ARENA_H_ */
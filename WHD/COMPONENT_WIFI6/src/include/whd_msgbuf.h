@@ -24,6 +24,7 @@
 #include "whd_types_int.h"
 #include "whd_wlioctl.h"
 #include "whd_commonring.h"
+#include "whd_lock.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -97,8 +98,25 @@ extern "C"
 #define WHD_MSGBUF_PKT_FLAGS_FRAME_MASK         0x07
 #define WHD_MSGBUF_PKT_FLAGS_PRIO_SHIFT         5
 
+/* Doorbell policy of the TX flowrings: the first doorbell of a whd_msgbuf_txflow() batch goes
+ * out after CNT1 packets, later ones every CNT2 packets or once a packet has waited DELAY_MS.
+ * The batch end rings for the rest.
+ */
+#ifndef WHD_MSGBUF_TX_FLUSH_CNT1
 #define WHD_MSGBUF_TX_FLUSH_CNT1                32
+#endif
+#ifndef WHD_MSGBUF_TX_FLUSH_CNT2
 #define WHD_MSGBUF_TX_FLUSH_CNT2                96
+#endif
+#ifndef WHD_MSGBUF_TX_FLUSH_DELAY_MS
+#define WHD_MSGBUF_TX_FLUSH_DELAY_MS            2
+#endif
+/* Doorbell policy of the RX post ring: one doorbell per RX buffer refill, unless it posts more
+ * than this many buffers. The control submit ring rings for every message.
+ */
+#ifndef WHD_MSGBUF_RXPOST_FLUSH_CNT
+#define WHD_MSGBUF_RXPOST_FLUSH_CNT             32
+#endif
 #define WHD_MSGBUF_UPDATE_RX_PTR_THRS           48
 
 #define WHD_MAX_TXSTATUS_WAIT_RETRIES           10
@@ -144,7 +162,7 @@ typedef struct whd_error_info
 {
     /* Event list variables */
     error_list_elem_t whd_event_list[WHD_EVENT_HANDLER_LIST_SIZE];
-    cy_semaphore_t event_list_mutex;
+    whd_lock_t event_list_mutex;
 } whd_error_info_t;
 #endif
 
@@ -155,7 +173,7 @@ typedef struct whd_msgbuf_info
 {
     /* Event list variables (Must be at the begining) */
     event_list_elem_t whd_event_list[WHD_EVENT_HANDLER_LIST_SIZE];
-    cy_semaphore_t event_list_mutex;
+    whd_lock_t event_list_mutex;
 
     /* IOCTL variables*/
     cy_semaphore_t ioctl_mutex;
@@ -169,7 +187,7 @@ typedef struct whd_msgbuf_info
 typedef struct whd_msgbuftx_info
 {
     /* Packet send queue variables */
-    cy_semaphore_t send_queue_mutex;
+    whd_lock_t send_queue_mutex;
     whd_buffer_t send_queue_head;
     whd_buffer_t send_queue_tail;
     uint32_t npkt_in_q;
@@ -386,7 +404,7 @@ struct whd_msgbuf_pktids
     uint32_t array_size;
     uint32_t last_allocated_idx;
     struct whd_msgbuf_pktid *array;
-    cy_semaphore_t pktid_mutex;
+    whd_lock_t pktid_mutex;
 };
 
 struct whd_msgbuf
@@ -428,12 +446,20 @@ extern whd_result_t whd_msgbuf_ioctl_dequeue(struct whd_driver *whd_driver);
 extern uint32_t whd_msgbuf_process_rx_packet(struct whd_driver *dev);
 extern void whd_msgbuf_delete_flowring(struct whd_driver *drvr, uint16_t flowid);
 extern whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid);
-extern whd_result_t whd_get_high_priority_flowring(whd_driver_t whd_driver, uint32_t num_flowring, uint16_t *prio_ring_id);
+extern whd_result_t whd_get_high_priority_flowring(whd_driver_t whd_driver, uint32_t num_flowring, uint8_t held_acs,
+                                                   uint16_t *prio_ring_id);
 extern whd_result_t whd_msgbuf_txflow_dequeue(whd_driver_t whd_driver, whd_buffer_t *buffer, uint16_t flowid);
 extern whd_result_t whd_msgbuf_txflow_init(whd_msgbuftx_info_t *msgtx_info);
 extern whd_result_t whd_msgbuf_txflow_deinit(whd_msgbuftx_info_t *msgtx_info);
 extern whd_result_t whd_msgbuf_info_init(whd_driver_t whd_driver);
 extern void whd_msgbuf_info_deinit(whd_driver_t whd_driver);
+extern struct whd_msgbuf_pktids *whd_msgbuf_init_pktids(uint32_t nr_array_entries);
+extern int whd_msgbuf_alloc_pktid(struct whd_driver *whd_driver, struct whd_msgbuf_pktids *pktids,
+                                  whd_buffer_t skb, uint16_t data_offset, uint32_t *physaddr, uint32_t *idx);
+extern whd_buffer_t whd_msgbuf_get_pktid(struct whd_driver *whd_driver, struct whd_msgbuf_pktids *pktids,
+                                         uint32_t idx);
+
+extern void whd_msgbuf_print_db_stats(struct whd_driver *drvr, whd_bool_t reset_after_print);
 
 extern void whd_msgbuf_indicate_to_fill_buffers(cy_timer_callback_arg_t arg);
 extern void whd_msgbuf_rxbuf_fill_all(struct whd_msgbuf *msgbuf);
@@ -68,6 +68,9 @@ extern "C"
  *
  */
 whd_result_t whd_network_process_ethernet_data(whd_interface_t ifp, whd_buffer_t buffer);
+whd_result_t whd_network_process_ethernet_data_ext(whd_interface_t ifp, whd_buffer_t buffer, uint32_t rx_flags);
+void whd_network_tx_flow_control(whd_driver_t whd_driver, uint8_t bsscfgidx, whd_bool_t stop);
+void whd_network_rx_round_end(whd_driver_t whd_driver);
 #ifdef __cplusplus
 } /*extern "C" */
 #endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Per-packet latency tracing through the TX and RX pipeline
+ *
+ *  A sampled packet is timestamped at every stage boundary it crosses and the
+ *  time spent between two stages is added to a log2 histogram. Timestamps are
+ *  kept in a small table keyed by buffer handle rather than in the buffer, so
+ *  the headroom and bus header layout are unchanged.
+ *
+ *  Only built when WHD_PKT_TRACE is defined; WHD_PKT_TRACE_STAMP() compiles to
+ *  nothing otherwise.
+ */
+
+#ifndef INCLUDED_WHD_PKT_TRACE_H_
+#define INCLUDED_WHD_PKT_TRACE_H_
+
+#include "whd.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#ifndef WHD_PKT_TRACE_SLOTS
+#define WHD_PKT_TRACE_SLOTS             (8)         /* Sampled packets in flight at once */
+#endif
+
+#ifndef WHD_PKT_TRACE_STALE_US
+#define WHD_PKT_TRACE_STALE_US          (1000000)   /* Sample dropped if it has not completed by then */
+#endif
+
+/** Histogram bucket 0 counts latencies under 1us, bucket n those in [2^(n-1), 2^n) us */
+#define WHD_PKT_TRACE_BUCKETS           (20)
+
+/******************************************************
+*                   Enumerations
+******************************************************/
+
+/** Stage boundaries a packet is timestamped at */
+typedef enum
+{
+    WHD_PKT_STAGE_TX_SEND = 0,      /* Handed to whd_network_send_ethernet_data() */
+    WHD_PKT_STAGE_TX_ENQUEUE,       /* Added to an SDPCM AC queue or a flowring */
+    WHD_PKT_STAGE_TX_DEQUEUE,       /* Taken off the queue by the WHD thread */
+    WHD_PKT_STAGE_TX_DONE,          /* Bus transfer finished, or TX status received */
+    WHD_PKT_STAGE_RX_BUS_READ,      /* Data frame read from the bus, or RX completion received */
+    WHD_PKT_STAGE_RX_DECODE,        /* Protocol headers decoded */
+    WHD_PKT_STAGE_RX_NETIF,         /* Passed to the network stack */
+    WHD_PKT_STAGE_MAX
+} whd_pkt_stage_t;
+
+/** Intervals a histogram is kept for */
+typedef enum
+{
+    WHD_PKT_INTERVAL_TX_ENQUEUE = 0, /* TX_SEND to TX_ENQUEUE: protocol encode */
+    WHD_PKT_INTERVAL_TX_QUEUED,      /* TX_ENQUEUE to TX_DEQUEUE: queueing, credit and flow control waits */
+    WHD_PKT_INTERVAL_TX_BUS,         /* TX_DEQUEUE to TX_DONE: bus transfer or firmware completion */
+    WHD_PKT_INTERVAL_TX_TOTAL,       /* TX_SEND to TX_DONE */
+    WHD_PKT_INTERVAL_RX_DECODE,      /* RX_BUS_READ to RX_DECODE */
+    WHD_PKT_INTERVAL_RX_HANDOFF,     /* RX_DECODE to RX_NETIF */
+    WHD_PKT_INTERVAL_RX_TOTAL,       /* RX_BUS_READ to RX_NETIF */
+    WHD_PKT_INTERVAL_MAX
+} whd_pkt_interval_t;
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t buckets[WHD_PKT_TRACE_BUCKETS];
+} whd_pkt_trace_hist_t;
+
+typedef struct
+{
+    uint32_t tx_seen;               /* Data packets offered for sampling */
+    uint32_t rx_seen;               /* Data frames offered for sampling */
+    uint32_t sampled;               /* Samples started */
+    uint32_t completed;             /* Samples that reached TX_DONE or RX_NETIF */
+    uint32_t no_slot;               /* Samples skipped because every slot was in use */
+    uint32_t abandoned;             /* Samples dropped before completing (packet dropped or stale) */
+    whd_pkt_trace_hist_t hist[WHD_PKT_INTERVAL_MAX];
+} whd_pkt_trace_stats_t;
+
+/******************************************************
+*                      Macros
+******************************************************/
+#ifdef WHD_PKT_TRACE
+#define WHD_PKT_TRACE_STAMP(whd_driver, buffer, stage) \
+    do { if ( (whd_driver)->pkt_trace != NULL ){ whd_pkt_trace_stamp(whd_driver, buffer, stage); } } while (0)
+#define WHD_PKT_TRACE_CANCEL(whd_driver, buffer) \
+    do { if ( (whd_driver)->pkt_trace != NULL ){ whd_pkt_trace_cancel(whd_driver, buffer); } } while (0)
+#else
+#define WHD_PKT_TRACE_STAMP(whd_driver, buffer, stage)
+#define WHD_PKT_TRACE_CANCEL(whd_driver, buffer)
+#endif /* WHD_PKT_TRACE */
+
+#ifdef WHD_PKT_TRACE
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Starts sampling packet latencies
+ *
+ *  Can be called again to change the sampling rate; the statistics are kept.
+ *
+ * @param whd_driver    : WHD driver instance
+ * @param sample_every  : Sample one data packet in this many per direction, 0 stops sampling
+ * @param get_time_us   : Free-running microsecond clock. If NULL, cy_rtos_get_time() is used and
+ *                        latencies have millisecond resolution.
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_pkt_trace_enable(whd_driver_t whd_driver, uint32_t sample_every, uint32_t (*get_time_us)(void) );
+
+/** Copies the latency statistics
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param stats       : Receives the statistics
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if tracing was never enabled
+ */
+whd_result_t whd_pkt_trace_get_stats(whd_driver_t whd_driver, whd_pkt_trace_stats_t *stats);
+
+/** Prints the latency statistics, one histogram per interval
+ *
+ * @param whd_driver         : WHD driver instance
+ * @param reset_after_print  : Clear the statistics afterwards
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_pkt_trace_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print);
+
+/** Frees the tracing state; called from whd_deinit() */
+void whd_pkt_trace_deinit(whd_driver_t whd_driver);
+
+/** Records that a buffer crossed a stage boundary; use WHD_PKT_TRACE_STAMP() */
+void whd_pkt_trace_stamp(whd_driver_t whd_driver, whd_buffer_t buffer, whd_pkt_stage_t stage);
+
+/** Stops tracking a packet that was dropped; use WHD_PKT_TRACE_CANCEL() */
+void whd_pkt_trace_cancel(whd_driver_t whd_driver, whd_buffer_t buffer);
+
+#endif /* WHD_PKT_TRACE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_PKT_TRACE_H_ */
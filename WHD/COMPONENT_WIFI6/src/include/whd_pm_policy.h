@@ -0,0 +1,219 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Traffic-adaptive power save
+ *
+ *  The protocol layers count data packets and note the TX queue depth. A periodic work item on
+ *  a worker thread supplied by the application turns the counts into a packet rate and picks
+ *  one of a few levels, each a PM mode and, for PM2, a return-to-sleep delay. Moving up to a
+ *  busier level needs up_samples samples in a row above its enter threshold; moving down needs
+ *  down_samples samples in a row below the current level's exit threshold and goes one level at
+ *  a time, so short gaps in a transfer do not drop the link into a deeper power save mode.
+ *
+ *  The decision logic is the engine (whd_pm_policy_engine_*), which has no driver state and can
+ *  be fed a simulated traffic trace on the host.
+ *
+ *  Only built when WHD_PM_POLICY is defined; the counting macros compile to nothing otherwise.
+ */
+
+#ifndef INCLUDED_WHD_PM_POLICY_H_
+#define INCLUDED_WHD_PM_POLICY_H_
+
+#include "whd.h"
+#include "whd_types.h"
+#ifdef WHD_PM_POLICY
+#include "cy_worker_thread.h"
+#endif /* WHD_PM_POLICY */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+#define WHD_PM_POLICY_MAX_LEVELS        (4)
+
+/* Lowest power first: idle in PM1, light traffic in PM2 with a fast return to sleep, steady
+ * traffic in PM2 with the default delay and bulk transfers in PM0 */
+#ifndef WHD_PM_POLICY_DEFAULT_LEVELS
+#define WHD_PM_POLICY_DEFAULT_LEVELS \
+    { {PM1_POWERSAVE_MODE, 0, 0, 0, 0}, {PM2_POWERSAVE_MODE, 20, 5, 2, 0}, \
+      {PM2_POWERSAVE_MODE, 200, 50, 20, 0}, {NO_POWERSAVE_MODE, 0, 400, 150, 16} }
+#endif
+
+#ifndef WHD_PM_POLICY_DEFAULT_SAMPLE_MS
+#define WHD_PM_POLICY_DEFAULT_SAMPLE_MS     (100)
+#endif
+
+#ifndef WHD_PM_POLICY_DEFAULT_UP_SAMPLES
+#define WHD_PM_POLICY_DEFAULT_UP_SAMPLES    (2)
+#endif
+
+#ifndef WHD_PM_POLICY_DEFAULT_DOWN_SAMPLES
+#define WHD_PM_POLICY_DEFAULT_DOWN_SAMPLES  (10)
+#endif
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct
+{
+    uint8_t pm_mode;                /* NO_POWERSAVE_MODE, PM1_POWERSAVE_MODE or PM2_POWERSAVE_MODE */
+    uint16_t pm2_sleep_ret_ms;      /* Return-to-sleep delay in PM2 */
+    uint32_t enter_pps;             /* TX + RX packets per second that enter the level */
+    uint32_t exit_pps;              /* Rate below which the level is left, at most enter_pps */
+    uint32_t enter_queue_depth;     /* TX queue depth that also enters and holds the level, 0 for none */
+} whd_pm_policy_level_t;
+
+typedef struct
+{
+    uint32_t sample_ms;             /* Sampling period, 0 for WHD_PM_POLICY_DEFAULT_SAMPLE_MS */
+    uint32_t up_samples;            /* Samples in a row above a higher level before moving up */
+    uint32_t down_samples;          /* Samples in a row below the exit threshold before moving down */
+    uint32_t num_levels;            /* 0 for WHD_PM_POLICY_DEFAULT_LEVELS */
+    whd_pm_policy_level_t levels[WHD_PM_POLICY_MAX_LEVELS]; /* Increasing enter_pps; levels[0] is idle */
+} whd_pm_policy_config_t;
+
+typedef struct
+{
+    uint32_t level;                 /* Level chosen by the last sample */
+    uint32_t samples;
+    uint32_t transitions;           /* Level changes */
+    uint32_t entered[WHD_PM_POLICY_MAX_LEVELS];
+    uint32_t time_in_level_ms[WHD_PM_POLICY_MAX_LEVELS];
+    uint32_t apply_failed;          /* PM changes the firmware did not take; retried on the next sample */
+} whd_pm_policy_stats_t;
+
+typedef struct
+{
+    whd_pm_policy_config_t config;
+    uint32_t level;
+    uint32_t up_count;
+    uint32_t down_count;
+    uint32_t last_ms;
+    whd_pm_policy_stats_t stats;
+} whd_pm_policy_engine_t;
+
+/******************************************************
+*                      Macros
+******************************************************/
+#ifdef WHD_PM_POLICY
+#define WHD_PM_POLICY_TX(whd_driver, queue_depth) \
+    do { if ( (whd_driver)->pm_policy != NULL ){ whd_pm_policy_note_tx(whd_driver, queue_depth); } } while (0)
+#define WHD_PM_POLICY_RX(whd_driver) \
+    do { if ( (whd_driver)->pm_policy != NULL ){ whd_pm_policy_note_rx(whd_driver); } } while (0)
+#else
+#define WHD_PM_POLICY_TX(whd_driver, queue_depth)
+#define WHD_PM_POLICY_RX(whd_driver)
+#endif /* WHD_PM_POLICY */
+
+#ifdef WHD_PM_POLICY
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Starts the engine at level 0
+ *
+ * @param engine  : Engine state
+ * @param config  : Levels and hysteresis, NULL for the defaults. Zero fields take their defaults.
+ * @param now_ms  : Current time
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if the levels are not in increasing enter_pps order, an
+ *         exit_pps is above its enter_pps or a PM2 delay is out of range
+ */
+whd_result_t whd_pm_policy_engine_init(whd_pm_policy_engine_t *engine, const whd_pm_policy_config_t *config,
+                                       uint32_t now_ms);
+
+/** Feeds one sample to the engine
+ *
+ * @param engine           : Engine state
+ * @param now_ms           : Time of the sample
+ * @param packets          : Data packets sent and received since the previous sample
+ * @param max_queue_depth  : Deepest TX queue seen since the previous sample
+ *
+ * @return WHD_TRUE if the level changed; the new level is engine->level
+ */
+whd_bool_t whd_pm_policy_engine_sample(whd_pm_policy_engine_t *engine, uint32_t now_ms, uint32_t packets,
+                                       uint32_t max_queue_depth);
+
+/** Starts switching the power save mode of an interface with its traffic
+ *
+ *  The interface is put in level 0 straight away. While the policy runs the application should
+ *  not set the power save mode itself.
+ *
+ * @param ifp     : Interface whose PM mode is managed, normally the STA
+ * @param config  : Levels and hysteresis, NULL for the defaults
+ * @param worker  : Worker thread that runs the sampling work item and issues the PM ioctls
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_pm_policy_start(whd_interface_t ifp, const whd_pm_policy_config_t *config,
+                                 cy_worker_thread_info_t *worker);
+
+/** Stops the policy and leaves the interface in its current PM mode
+ *
+ *  A sample already running on the worker thread is not waited for.
+ *
+ * @param whd_driver  : WHD driver instance
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if the policy was never started
+ */
+whd_result_t whd_pm_policy_stop(whd_driver_t whd_driver);
+
+/** Copies the transition and time-in-level statistics
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param stats       : Receives the statistics
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if the policy was never started
+ */
+whd_result_t whd_pm_policy_get_stats(whd_driver_t whd_driver, whd_pm_policy_stats_t *stats);
+
+/** Prints the statistics, one line per level
+ *
+ * @param whd_driver         : WHD driver instance
+ * @param reset_after_print  : Clear the statistics afterwards; the current level is kept
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_pm_policy_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print);
+
+/** Stops the policy and frees its state; called from whd_deinit()
+ *
+ *  Waits until no thread of the worker can still be running a sample, so it must not be called
+ *  on that worker. The worker must either still be running or have been deleted already.
+ */
+void whd_pm_policy_deinit(whd_driver_t whd_driver);
+
+/** Counts a queued data packet; use WHD_PM_POLICY_TX() */
+void whd_pm_policy_note_tx(whd_driver_t whd_driver, uint32_t queue_depth);
+
+/** Counts a received data packet; use WHD_PM_POLICY_RX() */
+void whd_pm_policy_note_rx(whd_driver_t whd_driver);
+
+#endif /* WHD_PM_POLICY */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_PM_POLICY_H_ */
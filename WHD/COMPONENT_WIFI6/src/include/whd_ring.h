@@ -26,6 +26,7 @@
 #include "whd.h"
 #include "whd_commonring.h"
 #include "whd_msgbuf.h"
+#include "whd_ring_idx.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -190,6 +191,7 @@ struct whd_ram_shared_info
     void *ringupd;
     //ram_check dma_addr_t ringupd_dmahandle;
     uint32_t version_new;
+    struct whd_ring_idx_block host_idx;     /* Ring indices in host memory, buf is NULL when they are in TCM */
 };
 
 extern void whd_bus_handle_mb_data(whd_driver_t whd_driver, uint32_t d2h_mb_data);
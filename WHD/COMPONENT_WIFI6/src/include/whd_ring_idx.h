@@ -0,0 +1,116 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Ring read and write indices kept in host memory
+ *
+ *  Firmware that sets WHD_PCIE_SHARED_DMA_INDEX in the shared flags can keep the msgbuf ring
+ *  indices in a block of host memory instead of its TCM. The host writes the H2D write indices and
+ *  the D2H read indices into the block and the device DMAs them in; the device DMAs its H2D read
+ *  and D2H write indices out to it. Reading an index on the hot path is then a load from local
+ *  memory instead of a TCM access.
+ *
+ *  The block holds four arrays of one index per ring, in this order: H2D write, H2D read, D2H
+ *  write and D2H read. An index is 2 or 4 bytes wide, as the firmware asks
+ *  (WHD_PCIE_SHARED_DMA_2B_IDX).
+ *
+ *  The accessors do no cache maintenance: indices from both sides share cache lines, so
+ *  invalidating a line for a device index could drop a host index not yet written back. The
+ *  block comes from the DMA pool, which the platform maps uncached for the device like the ring
+ *  items, and volatile accesses are then enough. On targets with a data cache
+ *  whd_ring_idx_block_init() refuses a cacheable block, and the driver keeps the indices in TCM.
+ */
+
+#ifndef INCLUDED_WHD_RING_IDX_H
+#define INCLUDED_WHD_RING_IDX_H
+
+#include "whd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+
+typedef enum
+{
+    WHD_RING_IDX_H2D_W = 0,     /* Written by the host */
+    WHD_RING_IDX_H2D_R,         /* Written by the device */
+    WHD_RING_IDX_D2H_W,         /* Written by the device */
+    WHD_RING_IDX_D2H_R,         /* Written by the host */
+    WHD_RING_IDX_ARRAYS
+} whd_ring_idx_array_t;
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+struct whd_ring_idx_block
+{
+    uint8_t *buf;
+    uint32_t size;
+    uint8_t idx_sz;
+    uint16_t max_submissionrings;
+    uint16_t max_completionrings;
+};
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Bytes needed for the indices of the given rings
+ *
+ * @param idx_sz               : Width of one index, 2 or 4 bytes
+ * @param max_submissionrings  : H2D rings, the common ones and the flowrings
+ * @param max_completionrings  : D2H rings
+ *
+ * @return Block size, or 0 if idx_sz is not 2 or 4
+ */
+uint32_t whd_ring_idx_block_size(uint8_t idx_sz, uint16_t max_submissionrings, uint16_t max_completionrings);
+
+/** Lays the index arrays out over a zeroed buffer of whd_ring_idx_block_size() bytes
+ *
+ * @return WHD_SUCCESS, WHD_BADARG if buf is NULL or idx_sz is not 2 or 4, or WHD_UNSUPPORTED if
+ *         buf is cacheable on a target with a data cache
+ */
+whd_result_t whd_ring_idx_block_init(struct whd_ring_idx_block *block, void *buf, uint8_t idx_sz,
+                                     uint16_t max_submissionrings, uint16_t max_completionrings);
+
+/** Host address of one index, as stored in whd_ringbuf w_idx_addr and r_idx_addr
+ *
+ * @param block  : Index block
+ * @param array  : Which of the four arrays
+ * @param ring   : Ring number within the array, from 0
+ */
+uint32_t whd_ring_idx_addr(const struct whd_ring_idx_block *block, whd_ring_idx_array_t array, uint16_t ring);
+
+/** Host address of the start of one array, for the device's copy of the ring info */
+uint32_t whd_ring_idx_array_addr(const struct whd_ring_idx_block *block, whd_ring_idx_array_t array);
+
+/* whd_driver read_ptr and write_ptr accessors for indices in host memory */
+uint16_t whd_ring_idx_read16(whd_driver_t whd_driver, uint32_t addr);
+void whd_ring_idx_write16(whd_driver_t whd_driver, uint32_t addr, uint16_t value);
+uint16_t whd_ring_idx_read32(whd_driver_t whd_driver, uint32_t addr);
+void whd_ring_idx_write32(whd_driver_t whd_driver, uint32_t addr, uint16_t value);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_RING_IDX_H */
@@ -31,6 +31,7 @@
 #include "whd_network_types.h"
 #include "whd_types_int.h"
 #include "whd_cdc_bdc.h"
+#include "whd_lock.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -54,9 +55,39 @@ typedef enum
 #define BUS_HEADER_LEN  (12)
 #define IOCTL_OFFSET (sizeof(whd_buffer_header_t) + 12 + 16)
 
+/* 4 AC queues + 1 Control queue(IOVAR/IOCTLs) */
+#define WHD_SDPCM_NUM_QUEUES    (5)
+
+/* Interface sub-queues under each AC, indexed by bsscfgidx like whd_driver->iflist[] */
+#define WHD_SDPCM_IFQ_MAX       (3)
+
 /******************************************************
 *             Structures
 ******************************************************/
+
+/** TX queue counters of one interface, data packets only */
+typedef struct whd_sdpcm_ifq_stats
+{
+    uint32_t queued;        /**< Packets queued */
+    uint32_t sent;          /**< Packets taken for the bus */
+    uint32_t dropped;       /**< Packets dropped on a full AC sub-queue */
+    uint32_t flow_stops;    /**< Times the network stack was told to stop sending */
+    uint16_t depth;         /**< Packets queued now over all ACs */
+    uint16_t high_water;    /**< Deepest any AC sub-queue has been */
+} whd_sdpcm_ifq_stats_t;
+
+typedef struct whd_sdpcm_ifq
+{
+    whd_buffer_t head[WHD_SDPCM_NUM_QUEUES];
+    whd_buffer_t tail[WHD_SDPCM_NUM_QUEUES];
+    uint16_t npkt[WHD_SDPCM_NUM_QUEUES];
+    uint16_t limit;         /* Data packets per AC sub-queue */
+    uint8_t weight;         /* Packets per round-robin turn */
+    whd_bool_t stopped;     /* Network stack told to stop sending on this interface */
+    uint32_t flow_gen;      /* Bumped on every change of stopped */
+    whd_sdpcm_ifq_stats_t stats;
+} whd_sdpcm_ifq_t;
+
 typedef struct whd_sdpcm_info
 {
     /* Bus data credit variables */
@@ -65,10 +96,11 @@ typedef struct whd_sdpcm_info
 
 
     /* Packet send queue variables */
-    cy_semaphore_t send_queue_mutex;
-    whd_buffer_t send_queue_head[5];
-    whd_buffer_t send_queue_tail[5];
-    uint32_t npkt_in_q[5]; /** 4 AC queues + 1 Contol queue(IOVAR/IOCTLs) */
+    whd_lock_t send_queue_mutex;
+    whd_sdpcm_ifq_t ifq[WHD_SDPCM_IFQ_MAX];
+    uint8_t rr_ifq[WHD_SDPCM_NUM_QUEUES];    /* Sub-queue whose turn it is, per AC */
+    uint8_t rr_left[WHD_SDPCM_NUM_QUEUES];   /* Packets left in that turn */
+    uint32_t npkt_in_q[WHD_SDPCM_NUM_QUEUES];
     uint32_t totpkt_in_q;
 } whd_sdpcm_info_t;
 
@@ -113,6 +145,38 @@ extern void whd_update_host_interface_to_bss_index_mapping(whd_driver_t whd_driv
 extern whd_result_t whd_send_to_bus(whd_driver_t whd_driver, whd_buffer_t buffer,
                                     sdpcm_header_type_t header_type, uint8_t prio);
 
+/** Sets how an interface shares each AC with the other interfaces
+ *
+ *  Every AC serves its interface sub-queues round-robin, weight packets per turn. A data packet
+ *  for a sub-queue already holding limit packets is dropped. The network stack is told to stop
+ *  sending on the interface when one of its sub-queues fills, and to resume once all have drained
+ *  to half.
+ *
+ * @param ifp     : Interface
+ * @param weight  : Packets per turn, 0 for the default of 1
+ * @param limit   : Packets per AC sub-queue, 0 for the default
+ *
+ * @return WHD result code
+ */
+extern whd_result_t whd_sdpcm_set_ifq_params(whd_interface_t ifp, uint8_t weight, uint16_t limit);
+
+/** Gets the TX queue counters of an interface
+ *
+ * @param ifp     : Interface
+ * @param stats   : Filled with the counters
+ *
+ * @return WHD result code
+ */
+extern whd_result_t whd_sdpcm_get_ifq_stats(whd_interface_t ifp, whd_sdpcm_ifq_stats_t *stats);
+
+/** Prints the TX queue counters of every interface
+ *
+ * @param reset_after_print : WHD_TRUE to clear the counters afterwards
+ *
+ * @return WHD result code
+ */
+extern whd_result_t whd_sdpcm_print_ifq_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print);
+
 /******************************************************
 *             Global variables
 ******************************************************/
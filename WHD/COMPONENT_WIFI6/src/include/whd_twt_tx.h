@@ -0,0 +1,190 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  TWT service period aligned TX
+ *
+ *  While a TWT agreement is active the radio is only awake for the service periods (SP), so
+ *  frames handed to the firmware between them sit in its queues and may keep it from sleeping.
+ *  With the hold enabled the driver tracks the agreement from the WLC_E_TWT_SETUP and
+ *  WLC_E_TWT_TEARDOWN events and keeps non-urgent data in the host queues outside the SPs. A
+ *  timer wakes the WHD thread at the start of each SP, which then sends the held frames as one
+ *  burst. Control messages and the access categories in urgent_ac_mask are never held.
+ *
+ *  The firmware does not signal the start of an SP. The schedule carries the first wake time in
+ *  BSS TSF, so the host takes a TSF snapshot from application context (when the hold is enabled,
+ *  before every TWT setup or join request and on whd_twt_tx_hold_sync()) and maps the TSF onto
+ *  its own millisecond clock. The two clocks drift apart; call whd_twt_tx_hold_sync() now and
+ *  then on long-lived agreements. An agreement that arrives without a TSF snapshot, or with an
+ *  interval above max_interval_ms, is recorded but nothing is held for it.
+ *
+ *  Only one agreement, the last one set up, is tracked per driver.
+ *
+ *  Only built when WHD_TWT_TX_HOLD is defined; the hooks compile to nothing otherwise.
+ */
+
+#ifndef INCLUDED_WHD_TWT_TX_H_
+#define INCLUDED_WHD_TWT_TX_H_
+
+#include "whd.h"
+#include "whd_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************
+*                    Constants
+******************************************************/
+
+/* Access category bits for urgent_ac_mask and the held masks, in WMM ACI order */
+#define WHD_TWT_TX_AC_BE            (1u << 0)
+#define WHD_TWT_TX_AC_BK            (1u << 1)
+#define WHD_TWT_TX_AC_VI            (1u << 2)
+#define WHD_TWT_TX_AC_VO            (1u << 3)
+#define WHD_TWT_TX_AC_ALL           (0x0Fu)
+
+#ifndef WHD_TWT_TX_DEFAULT_URGENT_ACS
+#define WHD_TWT_TX_DEFAULT_URGENT_ACS       (WHD_TWT_TX_AC_VO)
+#endif
+
+/* Opens the window this much before the SP start, for clock drift and timer latency */
+#ifndef WHD_TWT_TX_DEFAULT_EARLY_MS
+#define WHD_TWT_TX_DEFAULT_EARLY_MS         (2)
+#endif
+
+/******************************************************
+*                    Structures
+******************************************************/
+
+typedef struct
+{
+    uint8_t urgent_ac_mask;         /* WHD_TWT_TX_AC_* sent at any time, 0 for WHD_TWT_TX_DEFAULT_URGENT_ACS */
+    uint32_t early_ms;              /* 0 for WHD_TWT_TX_DEFAULT_EARLY_MS */
+    uint32_t max_interval_ms;       /* Longer agreements are not held for, bounds the added latency; 0 for no limit */
+} whd_twt_tx_config_t;
+
+typedef struct
+{
+    whd_bool_t active;              /* An agreement is set up */
+    whd_bool_t holding;             /* Its schedule is aligned and traffic is held to it */
+    uint8_t flow_id;
+    uint32_t wake_interval_us;
+    uint32_t wake_duration_us;
+    uint32_t setups;                /* Accepted setup events */
+    uint32_t teardowns;
+    uint32_t not_aligned;           /* Setups without a TSF snapshot or with a too long interval */
+    uint32_t service_periods;       /* SP starts the WHD thread was woken for */
+    uint32_t held;                  /* Dequeue attempts that found only held data (SDPCM) */
+    uint32_t bypassed;              /* Urgent data packets sent outside an SP (SDPCM) */
+    uint32_t tsf_syncs;
+} whd_twt_tx_stats_t;
+
+/******************************************************
+*                      Macros
+******************************************************/
+#ifdef WHD_TWT_TX_HOLD
+/* Access categories the protocol layer must not send from right now */
+#define WHD_TWT_TX_HELD_ACS(whd_driver) \
+    ( ( (whd_driver)->twt_tx != NULL ) ? whd_twt_tx_held_acs(whd_driver) : 0u )
+#define WHD_TWT_TX_NOTE_HELD(whd_driver) \
+    do { if ( (whd_driver)->twt_tx != NULL ){ whd_twt_tx_note_held(whd_driver); } } while (0)
+#define WHD_TWT_TX_NOTE_BYPASS(whd_driver) \
+    do { if ( (whd_driver)->twt_tx != NULL ){ whd_twt_tx_note_bypass(whd_driver); } } while (0)
+#else
+#define WHD_TWT_TX_HELD_ACS(whd_driver) (0u)
+#define WHD_TWT_TX_NOTE_HELD(whd_driver)
+#define WHD_TWT_TX_NOTE_BYPASS(whd_driver)
+#endif /* WHD_TWT_TX_HOLD */
+
+#ifdef WHD_TWT_TX_HOLD
+
+/******************************************************
+*               Function Declarations
+******************************************************/
+
+/** Starts tracking TWT agreements on an interface and holding TX to their service periods
+ *
+ *  Registers for the TWT events and takes a first TSF snapshot. Enable the hold before
+ *  requesting the agreement, an agreement that is already set up is not picked up.
+ *
+ * @param ifp     : STA interface the agreements are made on
+ * @param config  : Urgent access categories and margins, NULL for the defaults
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_twt_tx_hold_enable(whd_interface_t ifp, const whd_twt_tx_config_t *config);
+
+/** Stops holding TX and releases anything held
+ *
+ * @param whd_driver  : WHD driver instance
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if the hold was never enabled
+ */
+whd_result_t whd_twt_tx_hold_disable(whd_driver_t whd_driver);
+
+/** Takes a new TSF snapshot and realigns the SP timer to it
+ *
+ *  Issues an iovar, so it cannot be called from the WHD thread or an event handler.
+ *
+ * @param ifp  : Interface the hold was enabled on
+ *
+ * @return WHD_SUCCESS, WHD_BADARG if the hold is not enabled, or the iovar error
+ */
+whd_result_t whd_twt_tx_hold_sync(whd_interface_t ifp);
+
+/** Forgets the current agreement and releases anything held; called from whd_wifi_leave() */
+void whd_twt_tx_hold_reset(whd_driver_t whd_driver);
+
+/** Copies the schedule and counters
+ *
+ * @param whd_driver  : WHD driver instance
+ * @param stats       : Receives the statistics
+ *
+ * @return WHD_SUCCESS, or WHD_BADARG if the hold was never enabled
+ */
+whd_result_t whd_twt_tx_get_stats(whd_driver_t whd_driver, whd_twt_tx_stats_t *stats);
+
+/** Prints the schedule and counters
+ *
+ * @param whd_driver         : WHD driver instance
+ * @param reset_after_print  : Clear the counters afterwards
+ *
+ * @return WHD_SUCCESS or error code
+ */
+whd_result_t whd_twt_tx_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print);
+
+/** Stops the SP timer and frees the hold state; called from whd_deinit() */
+void whd_twt_tx_deinit(whd_driver_t whd_driver);
+
+/** Returns the WHD_TWT_TX_AC_* held right now; use WHD_TWT_TX_HELD_ACS() */
+uint8_t whd_twt_tx_held_acs(whd_driver_t whd_driver);
+
+/** Counts a dequeue attempt that left only held data; use WHD_TWT_TX_NOTE_HELD() */
+void whd_twt_tx_note_held(whd_driver_t whd_driver);
+
+/** Counts an urgent data packet sent outside an SP; use WHD_TWT_TX_NOTE_BYPASS() */
+void whd_twt_tx_note_bypass(whd_driver_t whd_driver);
+
+#endif /* WHD_TWT_TX_HOLD */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INCLUDED_WHD_TWT_TX_H_ */
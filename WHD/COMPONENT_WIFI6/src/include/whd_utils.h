@@ -68,9 +68,10 @@ static const unsigned char aad[20] =  { 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe
 #define ARRAY_SIZE(a)                                 (sizeof(a) / sizeof(a[0]) )
 #endif
 #ifdef PROTO_MSGBUF
-uint32_t whd_dmapool_init(uint32_t memory_size);
-void* whd_dmapool_alloc( int size);
-void whd_dmapool_reset( void );
+uint32_t whd_dmapool_init(whd_driver_t whd_driver, uint32_t memory_size);
+void* whd_dmapool_alloc(whd_driver_t whd_driver, int size);
+void whd_dmapool_reset(whd_driver_t whd_driver);
+whd_result_t whd_dmapool_get_usage(whd_driver_t whd_driver, uint32_t *used, uint32_t *high_water, uint32_t *pool_size);
 #endif
 
 /** Searches for a specific WiFi Information Element in a byte array
@@ -295,6 +295,32 @@ typedef struct wl_twt_teardown
     uint8_t pad;
 } wl_twt_teardown_t;
 
+#define WL_TWT_SETUP_EVENT_VER      0u
+
+/* WLC_E_TWT_SETUP event data */
+typedef struct wl_twt_setup_event
+{
+    uint16_t version; /* structure version */
+    uint16_t length;  /* data length (starting after this field) */
+    uint8_t dialog;   /* dialog token */
+    uint8_t pad[3];
+    int32_t status;   /* 0 when the exchange completed, the result is in desc.setup_cmd */
+    wl_twt_sdesc_t desc; /* negotiated setup descriptor */
+} wl_twt_setup_event_t;
+
+#define WL_TWT_TEARDOWN_EVENT_VER   0u
+
+/* WLC_E_TWT_TEARDOWN event data */
+typedef struct wl_twt_teardown_event
+{
+    uint16_t version; /* structure version */
+    uint16_t length;  /* data length (starting after this field) */
+    uint8_t dialog;   /* dialog token */
+    uint8_t pad[3];
+    int32_t status;
+    wl_twt_teardesc_t teardesc; /* Teardown descriptor */
+} wl_twt_teardown_event_t;
+
 /* twt information descriptor */
 typedef struct wl_twt_infodesc
 {
@@ -1254,11 +1280,14 @@ typedef struct eventmsgs_ext
 #define IOVAR_STR_ARP_STATS              "arp_stats"
 #define IOVAR_STR_ARP_STATS_CLEAR        "arp_stats_clear"
 #define IOVAR_STR_TKO                    "tko"
+#define IOVAR_STR_TOE                    "toe"
+#define IOVAR_STR_TOE_OL                 "toe_ol"
 #define IOVAR_STR_ROAM_TIME_THRESH       "roam_time_thresh"
 
 #define IOVAR_WNM_MAXIDLE                "wnm_maxidle"
 #define IOVAR_STR_HE                     "he"
 #define IOVAR_STR_TWT                    "twt"
+#define IOVAR_STR_TSF                    "tsf"
 #define IOVAR_STR_OFFLOAD_CONFIG         "offload_config"
 #define IOVAR_STR_WSEC_INFO              "wsec_info"
 #define IOVAR_STR_EVENT_LOG              "event_log_tag_control"
@@ -40,6 +40,7 @@
 
 #define BDC_PROTO_VER                  (2)      /** Version number of BDC header */
 #define BDC_FLAG_VER_SHIFT             (4)      /** Number of bits to shift BDC version number in the flags field */
+#define BDC_FLAG_SUM_GOOD           (0x04)      /** Device checked the IP and TCP/UDP checksums of a received packet */
 #define BDC_FLAG2_IF_MASK           (0x0f)
 
 #ifdef BUS_ENC
@@ -526,13 +527,13 @@ void whd_cdc_bdc_info_deinit(whd_driver_t whd_driver)
     (void)cy_rtos_deinit_semaphore(&cdc_bdc_info->ioctl_mutex);
 
     /* Delete the event list management mutex */
-    (void)cy_rtos_deinit_semaphore(&cdc_bdc_info->event_list_mutex);
+    (void)whd_lock_deinit(&cdc_bdc_info->event_list_mutex);
 
     whd_driver->proto->pd = NULL;
     whd_mem_free(cdc_bdc_info);
 
     /* Delete the error list management mutex */
-    (void)cy_rtos_deinit_semaphore(&error_info->event_list_mutex);
+    (void)whd_lock_deinit(&error_info->event_list_mutex);
 }
 
 whd_result_t whd_cdc_bdc_info_init(whd_driver_t whd_driver)
@@ -564,33 +565,19 @@ whd_result_t whd_cdc_bdc_info_init(whd_driver_t whd_driver)
         return WHD_SEMAPHORE_ERROR;
     }
 
-    /* Create semaphore to protect event list management */
-    if (cy_rtos_init_semaphore(&cdc_bdc_info->event_list_mutex, 1, 0) != WHD_SUCCESS)
+    /* Create lock to protect event list management, handlers run under it */
+    if (whd_lock_init(&cdc_bdc_info->event_list_mutex, "event_list", WHD_LOCK_BLOCKING) != WHD_SUCCESS)
     {
         cy_rtos_deinit_semaphore(&cdc_bdc_info->ioctl_sleep);
         cy_rtos_deinit_semaphore(&cdc_bdc_info->ioctl_mutex);
         return WHD_SEMAPHORE_ERROR;
     }
-    if (cy_rtos_set_semaphore(&cdc_bdc_info->event_list_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        return WHD_SEMAPHORE_ERROR;
-    }
 
     /* Initialise the list of event handler functions */
     whd_mem_memset(cdc_bdc_info->whd_event_list, 0, sizeof(cdc_bdc_info->whd_event_list) );
 
-    /* Create semaphore to protect event list management */
-    if (cy_rtos_init_semaphore(&error_info->event_list_mutex, 1, 0) != WHD_SUCCESS)
-    {
-        return WHD_SEMAPHORE_ERROR;
-    }
-
-    if (cy_rtos_set_semaphore(&error_info->event_list_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        return WHD_SEMAPHORE_ERROR;
-    }
+    /* Create lock to protect error list management */
+    CHECK_RETURN(whd_lock_init(&error_info->event_list_mutex, "error_list", WHD_LOCK_BLOCKING) );
 
     /* Initialise the list of error handler functions */
     whd_mem_memset(error_info->whd_event_list, 0, sizeof(error_info->whd_event_list) );
@@ -760,7 +747,8 @@ void whd_process_bdc(whd_driver_t whd_driver, whd_buffer_t buffer)
     ifp = whd_driver->iflist[bssid_index];
 
     /* Send packet to bottom of network stack */
-    result = whd_network_process_ethernet_data(ifp, buffer);
+    result = whd_network_process_ethernet_data_ext(ifp, buffer,
+                                                   (bdc_header->flags & BDC_FLAG_SUM_GOOD) ? WHD_NETWORK_RX_CSUM_GOOD : 0);
     if (result != WHD_SUCCESS)
         WPRINT_WHD_ERROR( ("%s failed at %d \n", __func__, __LINE__) );
 }
@@ -887,7 +875,7 @@ void whd_process_bdc_event(whd_driver_t whd_driver, whd_buffer_t buffer, uint16_
     WHD_IOCTL_LOG_ADD_EVENT(whd_driver, whd_event->event_type, whd_event->status,
                             whd_event->reason);
 
-    if (cy_rtos_get_semaphore(&cdc_bdc_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    if (whd_lock_acquire(&cdc_bdc_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         WPRINT_WHD_DEBUG( ("Failed to obtain mutex for event list access!\n") );
         result = whd_buffer_release(whd_driver, buffer, WHD_NETWORK_RX);
@@ -928,9 +916,9 @@ void whd_process_bdc_event(whd_driver_t whd_driver, whd_buffer_t buffer, uint16_
         }
     }
 
-    result = cy_rtos_set_semaphore(&cdc_bdc_info->event_list_mutex, WHD_FALSE);
+    result = whd_lock_release(&cdc_bdc_info->event_list_mutex);
     if (result != WHD_SUCCESS)
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        WPRINT_WHD_ERROR( ("Error releasing lock in %s at %d \n", __func__, __LINE__) );
 
     WPRINT_WHD_DATA_LOG( ("Wcd:< Procd pkt 0x%08lX: Evnt %d (%d bytes)\n", (unsigned long)buffer,
                           (int)whd_event->event_type, size) );
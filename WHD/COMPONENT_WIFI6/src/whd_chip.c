@@ -115,6 +115,7 @@ whd_result_t whd_internal_info_init(whd_driver_t whd_driver)
     internal_info->console_addr = 0;
     internal_info->scan_result_callback = NULL;
     internal_info->whd_scan_result_ptr = NULL;
+    internal_info->scan_user_data = NULL;
     internal_info->active_join_mutex_initted = WHD_FALSE;
     internal_info->active_join_semaphore = NULL;
     internal_info->con_lastpos = 0;
@@ -137,6 +138,16 @@ whd_result_t whd_internal_info_init(whd_driver_t whd_driver)
 
 whd_result_t whd_internal_info_deinit(whd_driver_t whd_driver)
 {
+    whd_internal_info_t *internal_info = &whd_driver->internal_info;
+
+    /* A scan still running owns its user data until the final callback, which would never come now */
+    if (internal_info->scan_result_callback != NULL)
+    {
+        internal_info->scan_result_callback(NULL, internal_info->scan_user_data, WHD_SCAN_ABORTED);
+        internal_info->scan_result_callback = NULL;
+        internal_info->whd_scan_result_ptr = NULL;
+        internal_info->scan_user_data = NULL;
+    }
 #ifdef WHD_IOCTL_LOG_ENABLE
     /* Delete the whd_log mutex */
     (void)cy_rtos_deinit_semaphore(&whd_driver->whd_log_mutex);
@@ -23,6 +23,7 @@
 #include "whd_debug.h"
 #include "whd_commonring.h"
 #include "whd_types_int.h"
+#include "whd_utils.h"
 
 void whd_commonring_register_cb(struct whd_commonring *commonring,
                                 int (*cr_ring_bell)(void *ctx),
@@ -47,8 +48,8 @@ whd_result_t whd_commonring_config(struct whd_commonring *commonring, uint16_t d
     commonring->buf_addr = buf_addr;
     if (!commonring->inited)
     {
-        (void)cy_rtos_init_semaphore(&commonring->lock, 1, 0);
-        CHECK_RETURN(cy_rtos_set_semaphore(&commonring->lock, WHD_FALSE));
+        /* Held across buffer allocation and pktid allocation */
+        CHECK_RETURN(whd_lock_init(&commonring->lock, "commonring", WHD_LOCK_BLOCKING) );
         commonring->inited = true;
     }
     commonring->r_ptr = 0;
@@ -58,24 +59,39 @@ whd_result_t whd_commonring_config(struct whd_commonring *commonring, uint16_t d
     if (commonring->cr_write_wptr)
         commonring->cr_write_wptr(commonring->cr_ctx);
     commonring->f_ptr = 0;
+    commonring->db_pending = 0;
+    commonring->db_in_batch = false;
 
     return 0;
 }
 
+void whd_commonring_set_db_policy(struct whd_commonring *commonring,
+                                  const struct whd_commonring_db_policy *policy)
+{
+    commonring->db_policy = *policy;
+}
+
+void whd_commonring_get_db_stats(struct whd_commonring *commonring,
+                                 struct whd_commonring_db_stats *stats, whd_bool_t reset)
+{
+    *stats = commonring->db_stats;
+    if (reset == WHD_TRUE)
+        whd_mem_memset(&commonring->db_stats, 0, sizeof(commonring->db_stats) );
+}
+
 whd_result_t whd_commonring_lock(struct whd_commonring *commonring)
 {
     uint32_t result;
-    result = cy_rtos_get_semaphore(&commonring->lock, (uint32_t)10000,
-                                   WHD_FALSE);
+    result = whd_lock_acquire(&commonring->lock, (uint32_t)10000);
     return result;
 }
 
 void whd_commonring_unlock(struct whd_commonring *commonring)
 {
     uint32_t result;
-    result = cy_rtos_set_semaphore(&commonring->lock, WHD_FALSE);
+    result = whd_lock_release(&commonring->lock);
     if (result != WHD_SUCCESS)
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        WPRINT_WHD_ERROR( ("Error releasing lock in %s at %d \n", __func__, __LINE__) );
 }
 
 bool whd_commonring_write_available(struct whd_commonring *commonring)
@@ -202,11 +218,20 @@ again:
     return NULL;
 }
 
-int whd_commonring_write_complete(struct whd_commonring *commonring)
+/* f_ptr is the write pointer the device was last told about */
+static uint16_t whd_commonring_db_count(struct whd_commonring *commonring)
 {
-    if (commonring->f_ptr > commonring->w_ptr)
-        commonring->f_ptr = 0;
+    if (commonring->w_ptr >= commonring->f_ptr)
+        return commonring->w_ptr - commonring->f_ptr;
 
+    return commonring->depth - commonring->f_ptr + commonring->w_ptr;
+}
+
+static int whd_commonring_publish(struct whd_commonring *commonring)
+{
+    commonring->db_stats.items += commonring->db_pending;
+    commonring->db_stats.doorbells++;
+    commonring->db_pending = 0;
     commonring->f_ptr = commonring->w_ptr;
 
     if (commonring->cr_write_wptr)
@@ -217,6 +242,52 @@ int whd_commonring_write_complete(struct whd_commonring *commonring)
     return -1;
 }
 
+int whd_commonring_write_complete(struct whd_commonring *commonring)
+{
+    const struct whd_commonring_db_policy *policy = &commonring->db_policy;
+    uint16_t threshold;
+    cy_time_t now = 0;
+
+    if (policy->max_delay_ms != 0)
+    {
+        (void)cy_rtos_get_time(&now);
+        if (commonring->db_pending == 0)
+            commonring->db_first_ms = now;
+    }
+
+    commonring->db_pending = whd_commonring_db_count(commonring);
+    if (commonring->db_pending == 0)
+        return 0;
+
+    threshold = (commonring->db_in_batch) ? policy->max_pending : policy->first_pending;
+    if (commonring->db_pending >= threshold)
+    {
+        commonring->db_stats.threshold_bells++;
+        commonring->db_in_batch = true;
+        return whd_commonring_publish(commonring);
+    }
+
+    if ( (policy->max_delay_ms != 0) && ( (uint32_t)(now - commonring->db_first_ms) >= policy->max_delay_ms ) )
+    {
+        commonring->db_stats.deadline_bells++;
+        commonring->db_in_batch = true;
+        return whd_commonring_publish(commonring);
+    }
+
+    return 0;
+}
+
+int whd_commonring_flush(struct whd_commonring *commonring)
+{
+    commonring->db_in_batch = false;
+    commonring->db_pending = whd_commonring_db_count(commonring);
+    if (commonring->db_pending == 0)
+        return 0;
+
+    commonring->db_stats.flush_bells++;
+    return whd_commonring_publish(commonring);
+}
+
 void whd_commonring_write_cancel(struct whd_commonring *commonring,
                                  uint16_t n_items)
 {
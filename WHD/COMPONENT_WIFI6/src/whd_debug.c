@@ -18,6 +18,14 @@
 #include "whd_debug.h"
 #include "whd_int.h"
 #include "bus_protocols/whd_bus_protocol_interface.h"
+#include "whd_mem_arena.h"
+#ifdef WHD_LOCK_STATS
+#include "whd_lock.h"
+#ifdef PROTO_MSGBUF
+#include "whd_msgbuf.h"
+#include "whd_ring.h"
+#endif /* PROTO_MSGBUF */
+#endif /* WHD_LOCK_STATS */
 
 /******************************************************
 *             Constants
@@ -57,5 +65,77 @@ whd_result_t whd_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_pri
     }
 
     CHECK_RETURN(whd_bus_print_stats(whd_driver, reset_after_print) );
+#ifndef PROTO_MSGBUF
+    CHECK_RETURN(whd_sdpcm_print_ifq_stats(whd_driver, reset_after_print) );
+#endif /* PROTO_MSGBUF */
+#ifdef WHD_PKT_TRACE
+    if (whd_driver->pkt_trace != NULL)
+    {
+        CHECK_RETURN(whd_pkt_trace_print_stats(whd_driver, reset_after_print) );
+    }
+#endif /* WHD_PKT_TRACE */
+#ifdef WHD_PM_POLICY
+    if (whd_driver->pm_policy != NULL)
+    {
+        CHECK_RETURN(whd_pm_policy_print_stats(whd_driver, reset_after_print) );
+    }
+#endif /* WHD_PM_POLICY */
+#ifdef WHD_TWT_TX_HOLD
+    if (whd_driver->twt_tx != NULL)
+    {
+        CHECK_RETURN(whd_twt_tx_print_stats(whd_driver, reset_after_print) );
+    }
+#endif /* WHD_TWT_TX_HOLD */
+#ifdef WHD_LOCK_STATS
+#ifndef PROTO_MSGBUF
+    whd_lock_print_stats(&whd_driver->sdpcm_info.send_queue_mutex, reset_after_print);
+#else
+    if (whd_driver->msgbuf != NULL)
+    {
+        whd_lock_print_stats(&whd_driver->msgbuf->tx_pktids->pktid_mutex, reset_after_print);
+        whd_lock_print_stats(&whd_driver->msgbuf->rx_pktids->pktid_mutex, reset_after_print);
+        whd_lock_print_stats(&whd_driver->msgbuf->commonrings[WHD_H2D_MSGRING_CONTROL_SUBMIT]->lock,
+                             reset_after_print);
+    }
+#endif /* PROTO_MSGBUF */
+#endif /* WHD_LOCK_STATS */
+#ifdef WHD_MEM_ARENA
+    whd_mem_arena_print_stats();
+#endif /* WHD_MEM_ARENA */
+    if (whd_driver->thread_info.whd_inited == WHD_TRUE)
+    {
+        whd_print_thread_stack_usage("WHD thread", &whd_driver->thread_info.whd_thread);
+    }
+#ifdef PROTO_MSGBUF
+    {
+        uint32_t used, high_water, pool_size;
+
+        if (whd_dmapool_get_usage(whd_driver, &used, &high_water, &pool_size) == WHD_SUCCESS)
+        {
+            WPRINT_MACRO( ("DMA pool: used:%" PRIu32 ", max used:%" PRIu32 " of %" PRIu32 " bytes\n",
+                           used, high_water, pool_size) );
+        }
+    }
+#endif /* PROTO_MSGBUF */
     return WHD_SUCCESS;
 }
+
+void whd_print_thread_stack_usage(const char *name, cy_thread_t *thread)
+{
+    uint32_t stack_size, max_used;
+
+    if (cy_rtos_thread_get_stack_usage(thread, &stack_size, &max_used) == CY_RSLT_SUCCESS)
+    {
+        WPRINT_MACRO( ("%s stack: max used:%" PRIu32 " of %" PRIu32 " bytes\n", name, max_used, stack_size) );
+    }
+}
+
+void whd_print_queue_usage(const char *name, cy_queue_t *queue, uint32_t length)
+{
+    size_t high_water;
+
+    if (cy_rtos_queue_get_high_water(queue, &high_water) == CY_RSLT_SUCCESS)
+    {
+        WPRINT_MACRO( ("%s queue: max depth:%" PRIu32 " of %" PRIu32 "\n", name, (uint32_t)high_water, length) );
+    }
+}
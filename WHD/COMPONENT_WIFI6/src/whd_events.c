@@ -25,6 +25,7 @@
 #include "whd_buffer_api.h"
 #include "whd_proto.h"
 #include "whd_utils.h"
+#include "whd_lock.h"
 
 /******************************************************
 *        Constants
@@ -40,7 +41,7 @@ typedef struct whd_event_info
 {
     /* Event list variables */
     event_list_elem_t whd_event_list[WHD_EVENT_HANDLER_LIST_SIZE];
-    cy_semaphore_t event_list_mutex;
+    whd_lock_t event_list_mutex;
 } whd_event_info_t;
 
 /******************************************************
@@ -210,13 +211,13 @@ whd_result_t whd_set_error_handler_locally(whd_driver_t whd_driver, const uint8_
             {
                 handler_func = error_info->whd_event_list[i].handler;
                 handler_user_data = error_info->whd_event_list[i].handler_user_data;
-                res = cy_rtos_get_semaphore(&error_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+                res = whd_lock_acquire(&error_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT);
                 if (res != WHD_SUCCESS)
                 {
                     return res;
                 }
                 handler_func(whd_driver, error_nums, NULL, handler_user_data);
-                CHECK_RETURN(cy_rtos_set_semaphore(&error_info->event_list_mutex, WHD_FALSE) );
+                CHECK_RETURN(whd_lock_release(&error_info->event_list_mutex) );
                 return WHD_SUCCESS;
             }
         }
@@ -378,7 +379,7 @@ whd_result_t whd_management_set_event_handler(whd_interface_t ifp, const whd_eve
     }
 
     /* Acquire mutex preventing multiple threads accessing the handler at the same time */
-    res = cy_rtos_get_semaphore(&event_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    res = whd_lock_acquire(&event_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT);
     if (res != WHD_SUCCESS)
     {
         return res;
@@ -429,14 +430,14 @@ whd_result_t whd_management_set_event_handler(whd_interface_t ifp, const whd_eve
      * we get event_list_mutex -> ioctl_mutex, make sure we didn't have any thread, having ioctl_mutex -> event_list_mutex path.
      * Otherwise it may cause deadlock
      */
-    CHECK_RETURN(cy_rtos_set_semaphore(&event_info->event_list_mutex, WHD_FALSE) );
+    CHECK_RETURN(whd_lock_release(&event_info->event_list_mutex) );
 
     /* The wlan chip can sleep from now on */
     WHD_WLAN_LET_SLEEP(whd_driver);
     return WHD_SUCCESS;
 
 set_event_handler_exit:
-    CHECK_RETURN(cy_rtos_set_semaphore(&event_info->event_list_mutex, WHD_FALSE) );
+    CHECK_RETURN(whd_lock_release(&event_info->event_list_mutex) );
     return res;
 }
 
@@ -473,7 +474,7 @@ whd_result_t whd_wifi_set_event_handler(whd_interface_t ifp, const uint32_t *eve
     }
 
     /* Acquire mutex preventing multiple threads accessing the handler at the same time */
-    res = cy_rtos_get_semaphore(&event_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    res = whd_lock_acquire(&event_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT);
     if (res != WHD_SUCCESS)
     {
         return res;
@@ -524,14 +525,14 @@ whd_result_t whd_wifi_set_event_handler(whd_interface_t ifp, const uint32_t *eve
      * we get event_list_mutex -> ioctl_mutex, make sure we didn't have any thread, having ioctl_mutex -> event_list_mutex path.
      * Otherwise it may cause deadlock
      */
-    CHECK_RETURN(cy_rtos_set_semaphore(&event_info->event_list_mutex, WHD_FALSE) );
+    CHECK_RETURN(whd_lock_release(&event_info->event_list_mutex) );
 
     /* The wlan chip can sleep from now on */
     WHD_WLAN_LET_SLEEP(whd_driver);
     return WHD_SUCCESS;
 
 set_event_handler_exit:
-    CHECK_RETURN(cy_rtos_set_semaphore(&event_info->event_list_mutex, WHD_FALSE) );
+    CHECK_RETURN(whd_lock_release(&event_info->event_list_mutex) );
     return res;
 }
 
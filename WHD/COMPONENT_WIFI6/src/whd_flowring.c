@@ -22,7 +22,6 @@
 
 #define WHD_FLOWRING_HIGH           1024
 #define WHD_FLOWRING_LOW            (WHD_FLOWRING_HIGH - 256)
-#define WHD_FLOWRING_INVALID_IFIDX  0xff
 
 #define WHD_FLOWRING_HASH_AP(da, fifo, ifidx) (da[5] * 2 + fifo + ifidx * 16)
 #define WHD_FLOWRING_HASH_STA(fifo, ifidx)    (fifo + ifidx * 16)
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Driver internal locks, see whd_lock.h
+ */
+
+#include "whd_lock.h"
+#include "whd_debug.h"
+#include "whd_utils.h"
+
+/******************************************************
+*                      Macros
+******************************************************/
+#ifdef WHD_LOCK_STATS
+#ifndef WHD_LOCK_GET_TIME_US
+#define WHD_LOCK_GET_TIME_US()  whd_lock_time_us()
+#endif
+#endif /* WHD_LOCK_STATS */
+
+#ifdef WHD_LOCK_USE_CRITICAL_SECTION
+#define WHD_LOCK_IS_CRITICAL_SECTION(lock)  ( (lock)->type == WHD_LOCK_SHORT )
+#else
+#define WHD_LOCK_IS_CRITICAL_SECTION(lock)  (0)
+#endif
+
+/******************************************************
+*             Static Functions
+******************************************************/
+#ifdef WHD_LOCK_STATS
+static uint32_t whd_lock_time_us(void)
+{
+    cy_time_t now = 0;
+
+    (void)cy_rtos_get_time(&now);
+    return (uint32_t)now * 1000;
+}
+
+static void whd_lock_stats_acquired(whd_lock_t *lock, uint32_t wait_start_us, whd_bool_t contended)
+{
+    uint32_t now = WHD_LOCK_GET_TIME_US();
+
+    /* Called with the lock held, so the statistics need no further protection */
+    lock->stats.acquired++;
+    if (contended == WHD_TRUE)
+    {
+        uint32_t wait = now - wait_start_us;
+
+        lock->stats.contended++;
+        lock->stats.total_wait_us += wait;
+        if (wait > lock->stats.max_wait_us)
+        {
+            lock->stats.max_wait_us = wait;
+        }
+    }
+    lock->hold_start_us = now;
+}
+
+static void whd_lock_stats_released(whd_lock_t *lock)
+{
+    uint32_t hold = WHD_LOCK_GET_TIME_US() - lock->hold_start_us;
+
+    lock->stats.total_hold_us += hold;
+    if (hold > lock->stats.max_hold_us)
+    {
+        lock->stats.max_hold_us = hold;
+    }
+}
+
+#endif /* WHD_LOCK_STATS */
+
+/******************************************************
+*             Function definitions
+******************************************************/
+
+whd_result_t whd_lock_init(whd_lock_t *lock, const char *name, whd_lock_type_t type)
+{
+    if (lock == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    whd_mem_memset(lock, 0, sizeof(*lock) );
+    lock->type = type;
+#ifdef WHD_LOCK_STATS
+    lock->name = (name != NULL) ? name : WHD_LOCK_NAME_DEFAULT;
+#else
+    (void)name;
+#endif /* WHD_LOCK_STATS */
+
+    if (!WHD_LOCK_IS_CRITICAL_SECTION(lock) )
+    {
+        if (cy_rtos_init_mutex2(&lock->mutex, false) != CY_RSLT_SUCCESS)
+        {
+            WPRINT_WHD_ERROR( ("Could not create lock %s\n", (name != NULL) ? name : WHD_LOCK_NAME_DEFAULT) );
+            return WHD_SEMAPHORE_ERROR;
+        }
+    }
+    lock->inited = WHD_TRUE;
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_lock_deinit(whd_lock_t *lock)
+{
+    if ( (lock == NULL) || (lock->inited != WHD_TRUE) )
+    {
+        return WHD_BADARG;
+    }
+
+    lock->inited = WHD_FALSE;
+    if (!WHD_LOCK_IS_CRITICAL_SECTION(lock) )
+    {
+        if (cy_rtos_deinit_mutex(&lock->mutex) != CY_RSLT_SUCCESS)
+        {
+            return WHD_SEMAPHORE_ERROR;
+        }
+    }
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_lock_acquire(whd_lock_t *lock, uint32_t timeout_ms)
+{
+#ifdef WHD_LOCK_STATS
+    uint32_t wait_start_us;
+#endif /* WHD_LOCK_STATS */
+
+    if (WHD_LOCK_IS_CRITICAL_SECTION(lock) )
+    {
+        (void)timeout_ms;
+        if (cy_rtos_scheduler_suspend() != CY_RSLT_SUCCESS)
+        {
+            return WHD_SEMAPHORE_ERROR;
+        }
+#ifdef WHD_LOCK_STATS
+        whd_lock_stats_acquired(lock, 0, WHD_FALSE);
+#endif /* WHD_LOCK_STATS */
+        return WHD_SUCCESS;
+    }
+
+#ifdef WHD_LOCK_STATS
+    /* Try first so that waiting for the lock can be told apart and counted as contention */
+    if (cy_rtos_get_mutex(&lock->mutex, 0) == CY_RSLT_SUCCESS)
+    {
+        whd_lock_stats_acquired(lock, 0, WHD_FALSE);
+        return WHD_SUCCESS;
+    }
+    if (timeout_ms == 0)
+    {
+        lock->stats.timeouts++;    /* Not under the lock, may undercount */
+        return WHD_SEMAPHORE_ERROR;
+    }
+    wait_start_us = WHD_LOCK_GET_TIME_US();
+#endif /* WHD_LOCK_STATS */
+
+    if (cy_rtos_get_mutex(&lock->mutex, timeout_ms) != CY_RSLT_SUCCESS)
+    {
+#ifdef WHD_LOCK_STATS
+        lock->stats.timeouts++;
+#endif /* WHD_LOCK_STATS */
+        return WHD_SEMAPHORE_ERROR;
+    }
+
+#ifdef WHD_LOCK_STATS
+    whd_lock_stats_acquired(lock, wait_start_us, WHD_TRUE);
+#endif /* WHD_LOCK_STATS */
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_lock_release(whd_lock_t *lock)
+{
+#ifdef WHD_LOCK_STATS
+    whd_lock_stats_released(lock);
+#endif /* WHD_LOCK_STATS */
+
+    if (WHD_LOCK_IS_CRITICAL_SECTION(lock) )
+    {
+        return (cy_rtos_scheduler_resume() == CY_RSLT_SUCCESS) ? WHD_SUCCESS : WHD_SEMAPHORE_ERROR;
+    }
+
+    return (cy_rtos_set_mutex(&lock->mutex) == CY_RSLT_SUCCESS) ? WHD_SUCCESS : WHD_SEMAPHORE_ERROR;
+}
+
+#ifdef WHD_LOCK_STATS
+static whd_result_t whd_lock_snapshot(whd_lock_t *lock, whd_lock_stats_t *stats, whd_bool_t reset)
+{
+    if ( (lock == NULL) || (stats == NULL) || (lock->inited != WHD_TRUE) )
+    {
+        return WHD_BADARG;
+    }
+
+    /* The snapshot's own acquisition is counted like any other */
+    CHECK_RETURN(whd_lock_acquire(lock, CY_RTOS_NEVER_TIMEOUT) );
+    whd_mem_memcpy(stats, &lock->stats, sizeof(*stats) );
+    if (reset == WHD_TRUE)
+    {
+        whd_mem_memset(&lock->stats, 0, sizeof(lock->stats) );
+    }
+    CHECK_RETURN(whd_lock_release(lock) );
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_lock_get_stats(whd_lock_t *lock, whd_lock_stats_t *stats)
+{
+    return whd_lock_snapshot(lock, stats, WHD_FALSE);
+}
+
+void whd_lock_print_stats(whd_lock_t *lock, whd_bool_t reset_after_print)
+{
+    whd_lock_stats_t stats;
+
+    if (whd_lock_snapshot(lock, &stats, reset_after_print) != WHD_SUCCESS)
+    {
+        return;
+    }
+
+    WPRINT_MACRO( ("%s: acquired:%" PRIu32 ", contended:%" PRIu32 ", timeouts:%" PRIu32
+                   ", wait avg:%" PRIu32 "us max:%" PRIu32 "us, hold avg:%" PRIu32 "us max:%" PRIu32 "us\n",
+                   lock->name, stats.acquired, stats.contended, stats.timeouts,
+                   (stats.contended != 0) ? (uint32_t)(stats.total_wait_us / stats.contended) : 0,
+                   stats.max_wait_us,
+                   (stats.acquired != 0) ? (uint32_t)(stats.total_hold_us / stats.acquired) : 0,
+                   stats.max_hold_us) );
+}
+
+#endif /* WHD_LOCK_STATS */
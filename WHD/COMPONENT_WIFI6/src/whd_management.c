@@ -37,6 +37,7 @@
 #include "whd_types_int.h"
 #include "whd_chip_constants.h"
 #include "whd_proto.h"
+#include "whd_mem_arena.h"
 #if defined(COMPONENT_WLANSENSE)
 #include "whd_wlansense_core.h"
 #endif /* defined(COMPONENT_WLANSENSE) */
@@ -222,6 +223,12 @@ whd_result_t whd_init(whd_driver_t *whd_driver_ptr, whd_init_config_t *whd_init_
         return WHD_WLAN_BUFTOOSHORT;
     }
 
+#ifdef WHD_MEM_ARENA
+    CHECK_RETURN(whd_mem_arena_init(whd_init_config->mem_arena, whd_init_config->mem_arena_size,
+                                    whd_init_config->mem_arena_classes,
+                                    whd_init_config->mem_arena_num_classes) );
+#endif /* WHD_MEM_ARENA */
+
     if ( (whd_drv = (whd_driver_t)whd_mem_malloc(sizeof(struct whd_driver) ) ) != NULL )
     {
         whd_mem_memset(whd_drv, 0, sizeof(struct whd_driver) );
@@ -239,7 +246,7 @@ whd_result_t whd_init(whd_driver_t *whd_driver_ptr, whd_init_config_t *whd_init_
 #ifdef PROTO_MSGBUF
         /* Initialize pool for WLAN M2M DMA to access, WHD has to request pool memory
            and open the access for WLAN through APIs(Secure Call in BTFW)*/
-        whd_dmapool_init(DMA_ALLOC_SIZE);
+        whd_dmapool_init(whd_drv, DMA_ALLOC_SIZE);
 #endif
 
         whd_drv->bus_gspi_32bit = WHD_FALSE;
@@ -251,6 +258,9 @@ whd_result_t whd_init(whd_driver_t *whd_driver_ptr, whd_init_config_t *whd_init_
     }
     else
     {
+#ifdef WHD_MEM_ARENA
+        whd_mem_arena_deinit();
+#endif /* WHD_MEM_ARENA */
         return WHD_MALLOC_FAILURE;
     }
     return WHD_SUCCESS;
@@ -279,6 +289,10 @@ whd_result_t whd_deinit(whd_interface_t ifp)
         return WHD_WLAN_NOTDOWN;
     }
 
+#if defined(COMPONENT_WLANSENSE)
+    whd_wlansense_deinit(whd_driver);
+#endif /* defined(COMPONENT_WLANSENSE) */
+
     for (i = 0; i < WHD_INTERFACE_MAX; i++)
     {
         if (whd_driver->iflist[i] != NULL)
@@ -295,12 +309,24 @@ whd_result_t whd_deinit(whd_interface_t ifp)
     }
 
 #ifdef PROTO_MSGBUF
-    whd_dmapool_reset();
+    whd_dmapool_reset(whd_driver);
 #endif
 
+#ifdef WHD_PKT_TRACE
+    whd_pkt_trace_deinit(whd_driver);
+#endif /* WHD_PKT_TRACE */
+#ifdef WHD_PM_POLICY
+    whd_pm_policy_deinit(whd_driver);
+#endif /* WHD_PM_POLICY */
+#ifdef WHD_TWT_TX_HOLD
+    whd_twt_tx_deinit(whd_driver);
+#endif /* WHD_TWT_TX_HOLD */
     whd_internal_info_deinit(whd_driver);
     whd_bus_common_info_deinit(whd_driver);
     whd_mem_free(whd_driver);
+#ifdef WHD_MEM_ARENA
+    whd_mem_arena_deinit();
+#endif /* WHD_MEM_ARENA */
 
     return WHD_SUCCESS;
 }
@@ -413,6 +439,11 @@ whd_result_t whd_wifi_on(whd_driver_t whd_driver, whd_interface_t *ifpp)
 
     whd_init_stats(whd_driver);
 
+#ifdef WHD_MEM_ARENA
+    /* Large allocations from here on are given back by whd_wifi_off() */
+    whd_mem_arena_mark();
+#endif /* WHD_MEM_ARENA */
+
     retval = whd_management_wifi_platform_init(whd_driver, whd_driver->country, WHD_FALSE);
     if (retval != WHD_SUCCESS)
     {
@@ -623,6 +654,11 @@ whd_result_t whd_wifi_on(whd_driver_t whd_driver, whd_interface_t *ifpp)
     whd_pds_unlock_sleep(whd_driver);
 #endif /* defined(COMPONENT_CAT5) && !defined(WHD_DISABLE_PDS) */
 
+#ifdef WHD_MEM_ARENA
+    /* Initialisation is done, from here on every allocation must come from a size class */
+    whd_mem_arena_seal(WHD_TRUE);
+#endif /* WHD_MEM_ARENA */
+
     return WHD_SUCCESS;
 }
 
@@ -650,6 +686,10 @@ whd_result_t whd_wifi_off(whd_interface_t ifp)
         return WHD_SUCCESS;
     }
 
+#ifdef WHD_MEM_ARENA
+    whd_mem_arena_seal(WHD_FALSE);
+#endif /* WHD_MEM_ARENA */
+
     /* Set wlc down before turning off the device */
     CHECK_RETURN(whd_wifi_set_ioctl_buffer(ifp, WLC_DOWN, NULL, 0) );
     whd_driver->internal_info.whd_wlan_status.state = WLAN_DOWN;
@@ -675,6 +715,10 @@ whd_result_t whd_wifi_off(whd_interface_t ifp)
     cy_rtos_deinit_mutex(&whd_driver->whd_hm_tx_lock);
 #endif
 
+#ifdef WHD_MEM_ARENA
+    whd_mem_arena_rewind();
+#endif /* WHD_MEM_ARENA */
+
     whd_driver->internal_info.whd_wlan_status.state = WLAN_OFF;
     return WHD_SUCCESS;
 }
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Driver memory arena, see whd_mem_arena.h
+ */
+
+#include "whd_mem_arena.h"
+#include "whd_debug.h"
+#include "whd_lock.h"
+#include "whd_utils.h"
+
+#ifdef WHD_MEM_ARENA
+
+/******************************************************
+*                      Macros
+******************************************************/
+#define WHD_MEM_ARENA_ALIGN         (8U)
+#define WHD_MEM_ARENA_ROUND_UP(x)   ( ( (x) + WHD_MEM_ARENA_ALIGN - 1U ) & ~(uintptr_t)(WHD_MEM_ARENA_ALIGN - 1U) )
+
+/******************************************************
+*                    Structures
+******************************************************/
+typedef struct
+{
+    uint8_t *start;
+    uint8_t *end;
+    void *free_list;            /* Each free block holds the address of the next one */
+    whd_mem_arena_class_stats_t stats;
+} whd_mem_arena_class_state_t;
+
+typedef struct
+{
+    whd_bool_t inited;
+    whd_bool_t sealed;
+    whd_lock_t lock;
+    uint32_t num_classes;
+    whd_mem_arena_class_state_t classes[WHD_MEM_ARENA_MAX_CLASSES];
+    uint8_t *bump_start;
+    uint8_t *bump_top;
+    uint8_t *bump_end;
+    uint8_t *mark_top;
+    uint32_t mark_live;
+    uint32_t bump_high_water;
+    uint32_t bump_live;
+    uint32_t failed;
+    uint32_t failed_sealed;
+    uint32_t largest_failed;
+} whd_mem_arena_t;
+
+/******************************************************
+*               Variables Definitions
+******************************************************/
+static whd_mem_arena_t whd_mem_arena;
+static const whd_mem_arena_class_t whd_mem_arena_default_classes[] = WHD_MEM_ARENA_DEFAULT_CLASSES;
+
+/******************************************************
+*             Function definitions
+******************************************************/
+
+whd_result_t whd_mem_arena_init(void *arena, uint32_t size, const whd_mem_arena_class_t *classes,
+                                uint32_t num_classes)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+    uint8_t *cursor;
+    uint8_t *end;
+    uint32_t block_size, prev_size = 0;
+    uint32_t i, b;
+
+    if (a->inited == WHD_TRUE)
+    {
+        /* The arena belongs to the driver that set it up until that driver's whd_deinit() */
+        WPRINT_WHD_ERROR( ("Memory arena already serves a driver, only one driver can use it\n") );
+        return WHD_UNSUPPORTED;
+    }
+    if (arena == NULL)
+    {
+        return WHD_BADARG;
+    }
+    if (classes == NULL)
+    {
+        classes = whd_mem_arena_default_classes;
+        num_classes = sizeof(whd_mem_arena_default_classes) / sizeof(whd_mem_arena_default_classes[0]);
+    }
+    if ( (num_classes == 0) || (num_classes > WHD_MEM_ARENA_MAX_CLASSES) )
+    {
+        WPRINT_WHD_ERROR( ("Memory arena needs 1 to %d size classes\n", WHD_MEM_ARENA_MAX_CLASSES) );
+        return WHD_BADARG;
+    }
+
+    whd_mem_memset(a, 0, sizeof(*a) );
+    cursor = (uint8_t *)WHD_MEM_ARENA_ROUND_UP( (uintptr_t)arena );
+    end = (uint8_t *)arena + size;
+    if (end < cursor)
+    {
+        return WHD_BADARG;
+    }
+
+    for (i = 0; i < num_classes; i++)
+    {
+        block_size = WHD_MEM_ARENA_ROUND_UP(classes[i].block_size);
+        if (block_size < sizeof(void *) )
+        {
+            block_size = WHD_MEM_ARENA_ROUND_UP(sizeof(void *) );
+        }
+        if (block_size <= prev_size)
+        {
+            WPRINT_WHD_ERROR( ("Memory arena classes must grow, class %" PRIu32 " does not\n", i) );
+            return WHD_BADARG;
+        }
+        if ( (uint32_t)(end - cursor) / block_size < classes[i].num_blocks )
+        {
+            WPRINT_WHD_ERROR( ("Memory arena of %" PRIu32 " bytes is too small for its size classes\n", size) );
+            return WHD_MALLOC_FAILURE;
+        }
+        prev_size = block_size;
+
+        a->classes[i].start = cursor;
+        for (b = 0; b < classes[i].num_blocks; b++)
+        {
+            *(void **)cursor = a->classes[i].free_list;
+            a->classes[i].free_list = cursor;
+            cursor += block_size;
+        }
+        a->classes[i].end = cursor;
+        a->classes[i].stats.block_size = block_size;
+        a->classes[i].stats.num_blocks = classes[i].num_blocks;
+    }
+    a->num_classes = num_classes;
+
+    a->bump_start = cursor;
+    a->bump_top = cursor;
+    a->bump_end = end;
+    a->mark_top = cursor;
+
+    CHECK_RETURN(whd_lock_init(&a->lock, "mem_arena", WHD_LOCK_SHORT) );
+    a->inited = WHD_TRUE;
+
+    return WHD_SUCCESS;
+}
+
+void whd_mem_arena_deinit(void)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+    uint32_t i;
+
+    if (a->inited != WHD_TRUE)
+    {
+        return;
+    }
+    a->inited = WHD_FALSE;
+
+    for (i = 0; i < a->num_classes; i++)
+    {
+        if (a->classes[i].stats.in_use != 0)
+        {
+            WPRINT_WHD_ERROR( ("Memory arena: %" PRIu32 " blocks of %" PRIu32 " bytes never freed\n",
+                               a->classes[i].stats.in_use, a->classes[i].stats.block_size) );
+        }
+    }
+    if (a->bump_live != 0)
+    {
+        WPRINT_WHD_ERROR( ("Memory arena: %" PRIu32 " large allocations never freed\n", a->bump_live) );
+    }
+    (void)whd_lock_deinit(&a->lock);
+}
+
+void whd_mem_arena_mark(void)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+
+    if (a->inited != WHD_TRUE)
+    {
+        return;
+    }
+    (void)whd_lock_acquire(&a->lock, CY_RTOS_NEVER_TIMEOUT);
+    a->mark_top = a->bump_top;
+    a->mark_live = a->bump_live;
+    (void)whd_lock_release(&a->lock);
+}
+
+void whd_mem_arena_rewind(void)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+    uint32_t live;
+
+    if (a->inited != WHD_TRUE)
+    {
+        return;
+    }
+    (void)whd_lock_acquire(&a->lock, CY_RTOS_NEVER_TIMEOUT);
+    live = a->bump_live - a->mark_live;
+    if (live == 0)
+    {
+        a->bump_top = a->mark_top;
+    }
+    (void)whd_lock_release(&a->lock);
+
+    if (live != 0)
+    {
+        WPRINT_WHD_ERROR( ("Memory arena: %" PRIu32 " large allocations still live, not rewound\n", live) );
+    }
+}
+
+void whd_mem_arena_seal(whd_bool_t sealed)
+{
+    whd_mem_arena.sealed = sealed;
+}
+
+void *whd_mem_arena_alloc(size_t size)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+    whd_mem_arena_class_state_t *cls;
+    whd_bool_t fitted = WHD_FALSE;
+    void *ptr = NULL;
+    uint32_t i;
+
+    if (a->inited != WHD_TRUE)
+    {
+        WPRINT_WHD_ERROR( ("Memory arena: allocation of %u bytes before whd_init\n", (unsigned int)size) );
+        return NULL;
+    }
+
+    (void)whd_lock_acquire(&a->lock, CY_RTOS_NEVER_TIMEOUT);
+    for (i = 0; i < a->num_classes; i++)
+    {
+        cls = &a->classes[i];
+        if (size > cls->stats.block_size)
+        {
+            continue;
+        }
+        if (cls->free_list != NULL)
+        {
+            ptr = cls->free_list;
+            cls->free_list = *(void **)ptr;
+            cls->stats.in_use++;
+            if (cls->stats.in_use > cls->stats.high_water)
+            {
+                cls->stats.high_water = cls->stats.in_use;
+            }
+            break;
+        }
+        if (fitted == WHD_FALSE)
+        {
+            /* Counted once, against the class the request belongs to */
+            cls->stats.overflow++;
+            fitted = WHD_TRUE;
+        }
+    }
+
+    if ( (ptr == NULL) && (a->sealed != WHD_TRUE) &&
+         (WHD_MEM_ARENA_ROUND_UP(size) <= (size_t)(a->bump_end - a->bump_top) ) )
+    {
+        ptr = a->bump_top;
+        a->bump_top += WHD_MEM_ARENA_ROUND_UP(size);
+        a->bump_live++;
+        if ( (uint32_t)(a->bump_top - a->bump_start) > a->bump_high_water )
+        {
+            a->bump_high_water = (uint32_t)(a->bump_top - a->bump_start);
+        }
+    }
+
+    if (ptr == NULL)
+    {
+        a->failed++;
+        if (a->sealed == WHD_TRUE)
+        {
+            a->failed_sealed++;
+        }
+        if (size > a->largest_failed)
+        {
+            a->largest_failed = (uint32_t)size;
+        }
+    }
+    (void)whd_lock_release(&a->lock);
+
+    if (ptr == NULL)
+    {
+        WPRINT_WHD_ERROR( ("Memory arena: no block for %u bytes%s\n", (unsigned int)size,
+                           (a->sealed == WHD_TRUE) ? " after init" : "") );
+    }
+    return ptr;
+}
+
+void whd_mem_arena_free(void *ptr)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+    whd_mem_arena_class_state_t *cls;
+    whd_bool_t found = WHD_FALSE;
+    uint32_t i;
+
+    if ( (ptr == NULL) || (a->inited != WHD_TRUE) )
+    {
+        return;
+    }
+
+    (void)whd_lock_acquire(&a->lock, CY_RTOS_NEVER_TIMEOUT);
+    for (i = 0; i < a->num_classes; i++)
+    {
+        cls = &a->classes[i];
+        if ( ( (uint8_t *)ptr >= cls->start ) && ( (uint8_t *)ptr < cls->end ) )
+        {
+            *(void **)ptr = cls->free_list;
+            cls->free_list = ptr;
+            cls->stats.in_use--;
+            found = WHD_TRUE;
+            break;
+        }
+    }
+    if ( (found == WHD_FALSE) && ( (uint8_t *)ptr >= a->bump_start ) && ( (uint8_t *)ptr < a->bump_top ) )
+    {
+        /* Given back as a whole by whd_mem_arena_rewind() */
+        a->bump_live--;
+        found = WHD_TRUE;
+    }
+    (void)whd_lock_release(&a->lock);
+
+    if (found == WHD_FALSE)
+    {
+        WPRINT_WHD_ERROR( ("Memory arena: freeing %p, which it does not own\n", ptr) );
+    }
+}
+
+whd_result_t whd_mem_arena_get_stats(whd_mem_arena_stats_t *stats)
+{
+    whd_mem_arena_t *a = &whd_mem_arena;
+    uint32_t i;
+
+    if ( (stats == NULL) || (a->inited != WHD_TRUE) )
+    {
+        return WHD_BADARG;
+    }
+
+    (void)whd_lock_acquire(&a->lock, CY_RTOS_NEVER_TIMEOUT);
+    stats->num_classes = a->num_classes;
+    for (i = 0; i < a->num_classes; i++)
+    {
+        stats->classes[i] = a->classes[i].stats;
+    }
+    stats->bump_size = (uint32_t)(a->bump_end - a->bump_start);
+    stats->bump_used = (uint32_t)(a->bump_top - a->bump_start);
+    stats->bump_high_water = a->bump_high_water;
+    stats->bump_live = a->bump_live;
+    stats->failed = a->failed;
+    stats->failed_sealed = a->failed_sealed;
+    stats->largest_failed = a->largest_failed;
+    (void)whd_lock_release(&a->lock);
+
+    return WHD_SUCCESS;
+}
+
+void whd_mem_arena_print_stats(void)
+{
+    whd_mem_arena_stats_t stats;
+    uint32_t i;
+
+    if (whd_mem_arena_get_stats(&stats) != WHD_SUCCESS)
+    {
+        return;
+    }
+
+    WPRINT_MACRO( ("Memory arena.. large:%" PRIu32 "/%" PRIu32 " bytes (max %" PRIu32 "), failed:%" PRIu32
+                   " (after init %" PRIu32 ", largest %" PRIu32 " bytes)\n",
+                   stats.bump_used, stats.bump_size, stats.bump_high_water, stats.failed,
+                   stats.failed_sealed, stats.largest_failed) );
+    for (i = 0; i < stats.num_classes; i++)
+    {
+        WPRINT_MACRO( ("  %" PRIu32 "B x %" PRIu32 ": in use:%" PRIu32 ", max:%" PRIu32 ", overflow:%" PRIu32 "\n",
+                       stats.classes[i].block_size, stats.classes[i].num_blocks, stats.classes[i].in_use,
+                       stats.classes[i].high_water, stats.classes[i].overflow) );
+    }
+}
+
+#endif /* WHD_MEM_ARENA */
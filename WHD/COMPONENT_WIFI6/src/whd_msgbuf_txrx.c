@@ -51,6 +51,14 @@ static const uint8_t dscp_to_wmm_qos[] =
   7, 7, 7, 7, 7, 7, 7,                                          /* 57 - 63 */
 };
 
+/* Doorbell policy per ring type: control messages are rung at once, RX buffer posts once per
+ * refill and TX packets once per batch, see WHD_MSGBUF_TX_FLUSH_CNT1 */
+static const struct whd_commonring_db_policy control_db_policy = { 1, 1, 0 };
+static const struct whd_commonring_db_policy rxpost_db_policy =
+{ WHD_MSGBUF_RXPOST_FLUSH_CNT, WHD_MSGBUF_RXPOST_FLUSH_CNT, 0 };
+static const struct whd_commonring_db_policy flowring_db_policy =
+{ WHD_MSGBUF_TX_FLUSH_CNT1, WHD_MSGBUF_TX_FLUSH_CNT2, WHD_MSGBUF_TX_FLUSH_DELAY_MS };
+
 static void whd_msgbuf_update_rxbufpost_count(struct whd_msgbuf *msgbuf, uint16_t rxcnt);
 static void whd_msgbuf_rxbuf_ioctlresp_post(struct whd_msgbuf *msgbuf);
 static void whd_msgbuf_set_next_buffer_in_queue(whd_driver_t whd_driver, whd_buffer_t buffer, whd_buffer_t prev_buffer);
@@ -103,17 +111,17 @@ static void whd_msgbuf_release_pktids(struct whd_driver *whd_driver, struct whd_
 {
     if (msgbuf->rx_pktids)
     {
-        (void)cy_rtos_deinit_semaphore(&msgbuf->rx_pktids->pktid_mutex);
+        (void)whd_lock_deinit(&msgbuf->rx_pktids->pktid_mutex);
         whd_msgbuf_release_array(whd_driver, msgbuf->rx_pktids, WHD_NETWORK_RX);
     }
     if (msgbuf->tx_pktids)
     {
-        (void)cy_rtos_deinit_semaphore(&msgbuf->tx_pktids->pktid_mutex);
+        (void)whd_lock_deinit(&msgbuf->tx_pktids->pktid_mutex);
         whd_msgbuf_release_array(whd_driver, msgbuf->tx_pktids, WHD_NETWORK_TX);
     }
 }
 
-static int
+int
 whd_msgbuf_alloc_pktid(struct whd_driver *whd_driver,
                        struct whd_msgbuf_pktids *pktids,
                        whd_buffer_t skb, uint16_t data_offset,
@@ -129,7 +137,7 @@ whd_msgbuf_alloc_pktid(struct whd_driver *whd_driver,
 
     count = 0;
     /* Acquire mutex which prevents race condition on pktid->allocated */
-    (void)cy_rtos_get_semaphore(&pktids->pktid_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    (void)whd_lock_acquire(&pktids->pktid_mutex, CY_RTOS_NEVER_TIMEOUT);
     do
     {
         (*idx)++;
@@ -143,7 +151,7 @@ whd_msgbuf_alloc_pktid(struct whd_driver *whd_driver,
         count++;
     } while (count < pktids->array_size);
     /* Ignore return - not much can be done about failure */
-    (void)cy_rtos_set_semaphore(&pktids->pktid_mutex, WHD_FALSE);
+    (void)whd_lock_release(&pktids->pktid_mutex);
 
     if (count == pktids->array_size)
         return WHD_WLAN_NOMEM;
@@ -157,7 +165,7 @@ whd_msgbuf_alloc_pktid(struct whd_driver *whd_driver,
     return WHD_SUCCESS;
 }
 
-static whd_buffer_t
+whd_buffer_t
 whd_msgbuf_get_pktid(struct whd_driver *whd_driver, struct whd_msgbuf_pktids *pktids,
                      uint32_t idx)
 {
@@ -172,22 +180,20 @@ whd_msgbuf_get_pktid(struct whd_driver *whd_driver, struct whd_msgbuf_pktids *pk
     }
 
     /* Acquire mutex which prevents race condition on pktid->allocated */
-    (void)cy_rtos_get_semaphore(&pktids->pktid_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    (void)whd_lock_acquire(&pktids->pktid_mutex, CY_RTOS_NEVER_TIMEOUT);
     if (pktids->array[idx].allocated == 1)
     {
         pktid = &pktids->array[idx];
         skb = pktid->skb;
         pktid->allocated = 0;
         /* Ignore return - not much can be done about failure */
-        (void)cy_rtos_set_semaphore(&pktids->pktid_mutex, WHD_FALSE);
+        (void)whd_lock_release(&pktids->pktid_mutex);
         return skb;
     }
-    else
-    {
-        WPRINT_WHD_ERROR( ("Invalid packet id %u (not in use)\n", (unsigned int)idx) );
-    }
     /* Ignore return - not much can be done about failure */
-    (void)cy_rtos_set_semaphore(&pktids->pktid_mutex, WHD_FALSE);
+    (void)whd_lock_release(&pktids->pktid_mutex);
+
+    WPRINT_WHD_ERROR( ("Invalid packet id %u (not in use)\n", (unsigned int)idx) );
 
     return NULL;
 }
@@ -846,7 +852,7 @@ static void whd_msgbuf_process_event_buffer(whd_driver_t whd_driver, whd_buffer_
     WHD_IOCTL_LOG_ADD_EVENT(whd_driver, whd_event->event_type, whd_event->status,
                             whd_event->reason);
 
-    if (cy_rtos_get_semaphore(&msgbuf_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    if (whd_lock_acquire(&msgbuf_info->event_list_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         WPRINT_WHD_ERROR( ("Failed to obtain mutex for event list access!\n") );
         return;
@@ -884,9 +890,9 @@ static void whd_msgbuf_process_event_buffer(whd_driver_t whd_driver, whd_buffer_
         }
     }
 
-    result = cy_rtos_set_semaphore(&msgbuf_info->event_list_mutex, WHD_FALSE);
+    result = whd_lock_release(&msgbuf_info->event_list_mutex);
     if (result != WHD_SUCCESS)
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        WPRINT_WHD_ERROR( ("Error releasing lock in %s at %d \n", __func__, __LINE__) );
 
     WPRINT_WHD_DATA_LOG( ("Wcd:< Procd pkt 0x%08lX: Evnt %d (%d bytes)\n", (unsigned long)buffer,
                           (int)whd_event->event_type, size) );
@@ -953,6 +959,7 @@ whd_msgbuf_process_txstatus(struct whd_msgbuf *msgbuf, void *buf)
     flowid -= WHD_H2D_MSGRING_FLOWRING_IDSTART;
     idx = dtoh32(tx_status->msg.request_ptr) - 1;
     skb = whd_msgbuf_get_pktid(drvr, msgbuf->tx_pktids, idx);
+    WHD_PKT_TRACE_STAMP(drvr, skb, WHD_PKT_STAGE_TX_DONE);
     WPRINT_WHD_DEBUG( ("%s - tx_status - %d for FlowID is %d, skb:0x%lu\n", __func__, tx_status->compl_hdr.status,
                        flowid, (uint32_t)skb) );
 
@@ -991,6 +998,7 @@ whd_msgbuf_process_rx_complete(struct whd_msgbuf *msgbuf, void *buf)
         skb = whd_msgbuf_get_pktid(drvr, msgbuf->rx_pktids, idx);
         if (!skb)
             return;
+        WHD_PKT_TRACE_STAMP(drvr, skb, WHD_PKT_STAGE_RX_BUS_READ);
 
         if (data_offset)
             (void)whd_buffer_add_remove_at_front(drvr, &skb, data_offset);
@@ -998,6 +1006,8 @@ whd_msgbuf_process_rx_complete(struct whd_msgbuf *msgbuf, void *buf)
             (void)whd_buffer_add_remove_at_front(drvr, &skb, msgbuf->rx_dataoffset);
 
         (void)whd_buffer_set_size(drvr, skb, buflen);
+        WHD_PKT_TRACE_STAMP(drvr, skb, WHD_PKT_STAGE_RX_DECODE);
+        WHD_PM_POLICY_RX(drvr);
 
         WPRINT_WHD_DEBUG( ("%s : buflen is %d , skb is 0x%lx\n", __func__, buflen, (uint32_t)skb) );
 
@@ -1217,8 +1227,9 @@ static whd_result_t whd_msgbuf_txflow_reinsert(struct whd_flowring *flow, uint16
     struct whd_driver *drvr = flow->dev;
     whd_msgbuftx_info_t *msgtx_info = &ring->txflow_queue;
     whd_result_t result;
+    whd_bool_t queue_corrupt = WHD_FALSE;
 
-    if (cy_rtos_get_semaphore(&msgtx_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    if (whd_lock_acquire(&msgtx_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         /* Could not obtain mutex */
         /* Fatal error */
@@ -1240,20 +1251,23 @@ static whd_result_t whd_msgbuf_txflow_reinsert(struct whd_flowring *flow, uint16
     }
     else
     {
-        WPRINT_WHD_ERROR( ("Error here %s at %d, head: 0x%x, tail: 0x%x\n", __func__, __LINE__,
-                           (unsigned int)msgtx_info->send_queue_head, (unsigned int)msgtx_info->send_queue_tail) );
+        queue_corrupt = WHD_TRUE;
     }
     msgtx_info->npkt_in_q++;
 
-    result = cy_rtos_set_semaphore(&msgtx_info->send_queue_mutex, WHD_FALSE);
+    result = whd_lock_release(&msgtx_info->send_queue_mutex);
 
     if (result != WHD_SUCCESS)
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        WPRINT_WHD_ERROR( ("Error releasing lock in %s at %d \n", __func__, __LINE__) );
+    if (queue_corrupt == WHD_TRUE)
+        WPRINT_WHD_ERROR( ("Error here %s at %d, head: NULL, tail: 0x%x\n", __func__, __LINE__,
+                           (unsigned int)msgtx_info->send_queue_tail) );
 
     return WHD_SUCCESS;
 }
 
-whd_result_t whd_get_high_priority_flowring(whd_driver_t whd_driver, uint32_t num_flowring, uint16_t *prio_ring_id)
+whd_result_t whd_get_high_priority_flowring(whd_driver_t whd_driver, uint32_t num_flowring, uint8_t held_acs,
+                                            uint16_t *prio_ring_id)
 {
     struct whd_msgbuf *msgbuf = whd_driver->msgbuf;
     struct whd_flowring *flow = msgbuf->flow;
@@ -1265,6 +1279,11 @@ whd_result_t whd_get_high_priority_flowring(whd_driver_t whd_driver, uint32_t nu
         {
             struct whd_flowring_ring *ring = flow->rings[i];
 
+            /* A held ring keeps its flow_map bit and is served once the TWT service period starts */
+            if ( (held_acs & (1u << ring->ac_prio) ) != 0 )
+            {
+                continue;
+            }
             if (compare <= ring->ac_prio)
             {
                 compare = ring->ac_prio;
@@ -1291,7 +1310,6 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
     void *ret_ptr;
     struct msgbuf_tx_msghdr *tx_msghdr;
     uint32_t address;
-    uint32_t count;
     uint32_t physaddr;
     uint32_t pktid;
     whd_buffer_t skb;
@@ -1307,7 +1325,6 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
 
     //whd_commonring_lock(commonring);	//to be fixed
 
-    count = WHD_MSGBUF_TX_FLUSH_CNT2 - WHD_MSGBUF_TX_FLUSH_CNT1;
     while (whd_flowring_qlen(flow, flowid) )
     {
         result = whd_msgbuf_txflow_dequeue(drvr, &skb, flowid);
@@ -1316,6 +1333,7 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
             WPRINT_WHD_ERROR( ("No SKB, but qlen %u\n", (unsigned int)whd_flowring_qlen(flow, flowid) ) );
             break;
         }
+        WHD_PKT_TRACE_STAMP(drvr, skb, WHD_PKT_STAGE_TX_DEQUEUE);
         CHECK_RETURN(whd_buffer_add_remove_at_front(drvr, &skb, (int32_t)(sizeof(whd_buffer_header_t)) ) );
 
         if (whd_msgbuf_alloc_pktid(drvr, msgbuf->tx_pktids, skb, WHD_ETHERNET_SIZE,
@@ -1339,7 +1357,6 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
         }
         WPRINT_WHD_DATA_LOG( ("Wcd:> Sending pkt 0x%08lX\n", (unsigned long)skb) );
         WHD_STATS_INCREMENT_VARIABLE(drvr, tx_total);
-        count++;
 
         tx_msghdr = (struct msgbuf_tx_msghdr *)ret_ptr;
 
@@ -1357,15 +1374,12 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
         tx_msghdr->metadata_buf_len = 0;
         tx_msghdr->metadata_buf_addr.high_addr = 0;
         tx_msghdr->metadata_buf_addr.low_addr = 0;
-        if (count >= WHD_MSGBUF_TX_FLUSH_CNT2)
-        {
-            whd_commonring_write_complete(commonring);
-            count = 0;
-        }
-    }
 
-    if (count)
+        /* The ring's doorbell policy decides whether this packet is published yet */
         whd_commonring_write_complete(commonring);
+    }
+
+    whd_commonring_flush(commonring);
     //whd_commonring_unlock(commonring);	//to be fixed
 
     return result;
@@ -1373,16 +1387,8 @@ whd_result_t whd_msgbuf_txflow(struct whd_driver *drvr, uint16_t flowid)
 
 whd_result_t whd_msgbuf_txflow_init(whd_msgbuftx_info_t *msgtx_info)
 {
-    /* Create the msgbuf tx packet queue semaphore */
-    if (cy_rtos_init_semaphore(&msgtx_info->send_queue_mutex, 1, 0) != WHD_SUCCESS)
-    {
-        return WHD_SEMAPHORE_ERROR;
-    }
-    if (cy_rtos_set_semaphore(&msgtx_info->send_queue_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        return WHD_SEMAPHORE_ERROR;
-    }
+    /* Create the msgbuf tx packet queue lock */
+    CHECK_RETURN(whd_lock_init(&msgtx_info->send_queue_mutex, "flowring_send_queue", WHD_LOCK_SHORT) );
 
     msgtx_info->send_queue_head = (whd_buffer_t)NULL;
     msgtx_info->send_queue_tail = (whd_buffer_t)NULL;
@@ -1397,8 +1403,8 @@ whd_result_t whd_msgbuf_txflow_deinit(whd_msgbuftx_info_t *msgtx_info)
     msgtx_info->send_queue_tail = (whd_buffer_t)NULL;
     msgtx_info->npkt_in_q = 0;
 
-    /* Delete the msgbuf tx packet queue semaphore */
-    if (cy_rtos_deinit_semaphore(&msgtx_info->send_queue_mutex) != WHD_SUCCESS)
+    /* Delete the msgbuf tx packet queue lock */
+    if (whd_lock_deinit(&msgtx_info->send_queue_mutex) != WHD_SUCCESS)
     {
         return WHD_SEMAPHORE_ERROR;
     }
@@ -1455,7 +1461,8 @@ whd_result_t whd_msgbuf_txflow_dequeue(whd_driver_t whd_driver, whd_buffer_t *bu
     }
 
     /* There is a packet waiting to be sent - send it then fix up queue and release packet */
-    if (cy_rtos_get_semaphore(&msgtx_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    WPRINT_WHD_DEBUG( ("Dequeuing --- \n") );
+    if (whd_lock_acquire(&msgtx_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         /* Could not obtain mutex, push back the flow control semaphore */
         WPRINT_WHD_ERROR( ("Error manipulating a semaphore, %s failed at %d \n", __func__, __LINE__) );
@@ -1463,7 +1470,6 @@ whd_result_t whd_msgbuf_txflow_dequeue(whd_driver_t whd_driver, whd_buffer_t *bu
     }
 
     /* Pop the head off and set the new send_queue head */
-    WPRINT_WHD_DEBUG( ("Dequeuing --- \n") );
     *buffer = msgtx_info->send_queue_head;
     msgtx_info->send_queue_head = whd_msgbuf_get_next_buffer_in_queue(whd_driver, *buffer);
 
@@ -1472,14 +1478,14 @@ whd_result_t whd_msgbuf_txflow_dequeue(whd_driver_t whd_driver, whd_buffer_t *bu
         msgtx_info->send_queue_tail = NULL;
     }
 
-    WPRINT_WHD_DEBUG(("Dequeue --> send_queue_head - %p\n", *buffer));
     msgtx_info->npkt_in_q--;
 
-    result = cy_rtos_set_semaphore(&msgtx_info->send_queue_mutex, WHD_FALSE);
+    result = whd_lock_release(&msgtx_info->send_queue_mutex);
+    WPRINT_WHD_DEBUG(("Dequeue --> send_queue_head - %p\n", *buffer));
 
     if (result != WHD_SUCCESS)
     {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        WPRINT_WHD_ERROR( ("Error releasing lock in %s at %d \n", __func__, __LINE__) );
     }
 
     return WHD_SUCCESS;
@@ -1501,7 +1507,12 @@ static whd_result_t whd_msgbuf_txflow_enqueue(whd_driver_t whd_driver, whd_buffe
     data = whd_buffer_get_current_piece_data_pointer(whd_driver, buffer);
     CHECK_PACKET_NULL(data, WHD_NO_REGISTER_FUNCTION_POINTER);
 
-    if (cy_rtos_get_semaphore(&msgtx_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    WPRINT_WHD_DEBUG(("Enqueuing +++ \n"));
+    /* Done before locking, the queue lock may be a critical section */
+    WHD_PKT_TRACE_STAMP(whd_driver, buffer, WHD_PKT_STAGE_TX_ENQUEUE);
+    CHECK_RETURN(whd_buffer_add_remove_at_front(whd_driver, &buffer, -(int)(sizeof(whd_buffer_header_t)) ) );
+
+    if (whd_lock_acquire(&msgtx_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         /* Could not obtain mutex */
         /* Fatal error */
@@ -1515,8 +1526,6 @@ static whd_result_t whd_msgbuf_txflow_enqueue(whd_driver_t whd_driver, whd_buffe
     /* Set the ac priority for flowring to queue the packet based on prioritization */
     ring->ac_prio = whd_flowring_prio2fifo[msgbuf->priority];
 
-    WPRINT_WHD_DEBUG(("Enqueuing +++ \n"));
-    CHECK_RETURN(whd_buffer_add_remove_at_front(whd_driver, &buffer, -(int)(sizeof(whd_buffer_header_t)) ) );
     whd_msgbuf_set_next_buffer_in_queue(whd_driver, NULL, buffer);
     if (msgtx_info->send_queue_tail != NULL)
     {
@@ -1529,13 +1538,14 @@ static whd_result_t whd_msgbuf_txflow_enqueue(whd_driver_t whd_driver, whd_buffe
         msgtx_info->send_queue_head = buffer;
     }
 
-    WPRINT_WHD_DEBUG(("Enqueue <-- send_queue_head - %p\n", msgtx_info->send_queue_head));
     msgtx_info->npkt_in_q++;
+    WHD_PM_POLICY_TX(whd_driver, msgtx_info->npkt_in_q);
 
-    result = cy_rtos_set_semaphore(&msgtx_info->send_queue_mutex, WHD_FALSE);
+    result = whd_lock_release(&msgtx_info->send_queue_mutex);
+    WPRINT_WHD_DEBUG(("Enqueue <-- send_queue_head - %p\n", buffer));
 
     if (result != WHD_SUCCESS)
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        WPRINT_WHD_ERROR( ("Error releasing lock in %s at %d \n", __func__, __LINE__) );
 
     return WHD_SUCCESS;
 }
@@ -1558,7 +1568,7 @@ whd_msgbuf_flowring_create_worker(struct whd_msgbuf *msgbuf, struct whd_msgbuf_w
      * allocation for same flowid again and again */
     if (msgbuf->flowring_handle[flowid] == (uint32_t)NULL)
     {
-        msgbuf->flowring_handle[flowid] = (uint32_t)whd_dmapool_alloc(flow_sz);
+        msgbuf->flowring_handle[flowid] = (uint32_t)whd_dmapool_alloc(msgbuf->drvr, flow_sz);
     }
 
     if (!(msgbuf->flowring_handle[flowid]) )
@@ -1818,6 +1828,7 @@ whd_msgbuf_rxbuf_data_fill(struct whd_msgbuf *msgbuf)
         msgbuf->rxbufpost += retcount;
         fillbufs -= retcount;
     }
+    whd_commonring_flush(msgbuf->commonrings[WHD_H2D_MSGRING_RXPOST_SUBMIT]);
 
     if (msgbuf->rxbufpost == WHD_MSGBUF_RXBUFPOST_THRESHOLD)
     {
@@ -1939,7 +1950,7 @@ static void whd_msgbuf_rxbuf_event_post(struct whd_msgbuf *msgbuf)
     msgbuf->cur_eventbuf += count;
 }
 
-static struct whd_msgbuf_pktids *
+struct whd_msgbuf_pktids *
 whd_msgbuf_init_pktids(uint32_t nr_array_entries)
 {
     struct whd_msgbuf_pktid *array;
@@ -2046,6 +2057,8 @@ static whd_result_t whd_msgbuf_attach(struct whd_driver *whd_driver)
     /* hook the commonrings in the main msgbuf structure. */
     for (i = 0; i < WHD_NROF_COMMON_MSGRINGS; i++)
         msgbuf->commonrings[i] = &whd_driver->ram_shared->commonrings[i]->commonring;
+    whd_commonring_set_db_policy(msgbuf->commonrings[WHD_H2D_MSGRING_CONTROL_SUBMIT], &control_db_policy);
+    whd_commonring_set_db_policy(msgbuf->commonrings[WHD_H2D_MSGRING_RXPOST_SUBMIT], &rxpost_db_policy);
 
     WPRINT_WHD_DEBUG( ("msgbuf commonring pointer is 0x%lx \n", (uint32_t)msgbuf->commonrings) );
 
@@ -2065,7 +2078,10 @@ static whd_result_t whd_msgbuf_attach(struct whd_driver *whd_driver)
     }
 
     for (i = 0; i < whd_driver->ram_shared->max_flowrings; i++)
+    {
         flowrings[i] = &whd_driver->ram_shared->flowrings[i].commonring;
+        whd_commonring_set_db_policy(flowrings[i], &flowring_db_policy);
+    }
 
     msgbuf->flowrings = flowrings;
     msgbuf->rx_dataoffset = whd_driver->ram_shared->rx_dataoffset;
@@ -2079,25 +2095,15 @@ static whd_result_t whd_msgbuf_attach(struct whd_driver *whd_driver)
     if (!msgbuf->tx_pktids)
         goto fail;
     /* Create the mutex protecting the packet send queue */
-    if (cy_rtos_init_semaphore(&msgbuf->tx_pktids->pktid_mutex, 1, 0) != WHD_SUCCESS)
+    if (whd_lock_init(&msgbuf->tx_pktids->pktid_mutex, "tx_pktids", WHD_LOCK_SHORT) != WHD_SUCCESS)
         goto fail;
-    if (cy_rtos_set_semaphore(&msgbuf->tx_pktids->pktid_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        goto fail;
-    }
 
     msgbuf->rx_pktids = whd_msgbuf_init_pktids(NR_RX_PKTIDS);
     if (!msgbuf->rx_pktids)
         goto fail;
     /* Create the mutex protecting the packet send queue */
-    if (cy_rtos_init_semaphore(&msgbuf->rx_pktids->pktid_mutex, 1, 0) != WHD_SUCCESS)
+    if (whd_lock_init(&msgbuf->rx_pktids->pktid_mutex, "rx_pktids", WHD_LOCK_SHORT) != WHD_SUCCESS)
         goto fail;
-    if (cy_rtos_set_semaphore(&msgbuf->rx_pktids->pktid_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        goto fail;
-    }
 
     msgbuf->flow = whd_flowring_attach(whd_driver, whd_driver->ram_shared->max_flowrings);
     if (!msgbuf->flow)
@@ -2155,7 +2161,7 @@ void whd_msgbuf_info_deinit(whd_driver_t whd_driver)
     (void)cy_rtos_deinit_semaphore(&msgbuf_info->ioctl_mutex);
 
     /* Delete the event list management mutex */
-    (void)cy_rtos_deinit_semaphore(&msgbuf_info->event_list_mutex);
+    (void)whd_lock_deinit(&msgbuf_info->event_list_mutex);
 
     whd_msgbuf_detach(whd_driver);
 
@@ -2163,7 +2169,7 @@ void whd_msgbuf_info_deinit(whd_driver_t whd_driver)
     whd_mem_free(msgbuf_info);
 
     /* Delete the error list management mutex */
-    (void)cy_rtos_deinit_semaphore(&error_info->event_list_mutex);
+    (void)whd_lock_deinit(&error_info->event_list_mutex);
 }
 
 whd_result_t whd_msgbuf_info_init(whd_driver_t whd_driver)
@@ -2195,33 +2201,19 @@ whd_result_t whd_msgbuf_info_init(whd_driver_t whd_driver)
         return WHD_SEMAPHORE_ERROR;
     }
 
-    /* Create semaphore to protect event list management */
-    if (cy_rtos_init_semaphore(&msgbuf_info->event_list_mutex, 1, 0) != WHD_SUCCESS)
+    /* Create lock to protect event list management, handlers run under it */
+    if (whd_lock_init(&msgbuf_info->event_list_mutex, "event_list", WHD_LOCK_BLOCKING) != WHD_SUCCESS)
     {
         cy_rtos_deinit_semaphore(&msgbuf_info->ioctl_sleep);
         cy_rtos_deinit_semaphore(&msgbuf_info->ioctl_mutex);
         return WHD_SEMAPHORE_ERROR;
     }
-    if (cy_rtos_set_semaphore(&msgbuf_info->event_list_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        return WHD_SEMAPHORE_ERROR;
-    }
 
     /* Initialise the list of event handler functions */
     whd_mem_memset(msgbuf_info->whd_event_list, 0, sizeof(msgbuf_info->whd_event_list) );
 
-    /* Create semaphore to protect event list management */
-    if (cy_rtos_init_semaphore(&error_info->event_list_mutex, 1, 0) != WHD_SUCCESS)
-    {
-        return WHD_SEMAPHORE_ERROR;
-    }
-
-    if (cy_rtos_set_semaphore(&error_info->event_list_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        return WHD_SEMAPHORE_ERROR;
-    }
+    /* Create lock to protect error list management */
+    CHECK_RETURN(whd_lock_init(&error_info->event_list_mutex, "error_list", WHD_LOCK_BLOCKING) );
 
     /* Initialise the list of error handler functions */
     whd_mem_memset(error_info->whd_event_list, 0, sizeof(error_info->whd_event_list) );
@@ -2301,4 +2293,43 @@ void whd_wifi_rxbuf_fill_timer_stop(whd_driver_t whd_driver)
     cy_rtos_timer_stop(&whd_driver->rxbuf_update_timer);
 }
 
+static void whd_msgbuf_print_ring_db_stats(const char *name, const struct whd_commonring_db_stats *stats)
+{
+    uint32_t per_100 = (stats->items != 0) ? (stats->doorbells * 100) / stats->items : 0;
+
+    WPRINT_MACRO( ("%s: items:%" PRIu32 ", doorbells:%" PRIu32 " (%" PRIu32 " per 100 items), threshold:%" PRIu32
+                   ", deadline:%" PRIu32 ", flush:%" PRIu32 "\n",
+                   name, stats->items, stats->doorbells, per_100, stats->threshold_bells, stats->deadline_bells,
+                   stats->flush_bells) );
+}
+
+void whd_msgbuf_print_db_stats(struct whd_driver *drvr, whd_bool_t reset_after_print)
+{
+    struct whd_msgbuf *msgbuf = drvr->msgbuf;
+    struct whd_commonring_db_stats stats;
+    struct whd_commonring_db_stats flowring_stats;
+    uint16_t i;
+
+    if (msgbuf == NULL)
+        return;
+
+    WPRINT_MACRO( ("Doorbell Stats.. \n") );
+    whd_commonring_get_db_stats(msgbuf->commonrings[WHD_H2D_MSGRING_CONTROL_SUBMIT], &stats, reset_after_print);
+    whd_msgbuf_print_ring_db_stats("control", &stats);
+    whd_commonring_get_db_stats(msgbuf->commonrings[WHD_H2D_MSGRING_RXPOST_SUBMIT], &stats, reset_after_print);
+    whd_msgbuf_print_ring_db_stats("rxpost", &stats);
+
+    whd_mem_memset(&flowring_stats, 0, sizeof(flowring_stats) );
+    for (i = 0; i < msgbuf->max_flowrings; i++)
+    {
+        whd_commonring_get_db_stats(msgbuf->flowrings[i], &stats, reset_after_print);
+        flowring_stats.items += stats.items;
+        flowring_stats.doorbells += stats.doorbells;
+        flowring_stats.threshold_bells += stats.threshold_bells;
+        flowring_stats.deadline_bells += stats.deadline_bells;
+        flowring_stats.flush_bells += stats.flush_bells;
+    }
+    whd_msgbuf_print_ring_db_stats("flowrings", &flowring_stats);
+}
+
 #endif /* PROTO_MSGBUF */
@@ -70,10 +70,30 @@
  *
  */
 whd_result_t whd_network_process_ethernet_data(whd_interface_t ifp, whd_buffer_t buffer)
+{
+    return whd_network_process_ethernet_data_ext(ifp, buffer, 0);
+}
+
+/** Passes a received packet to the network stack, with what the device reported about it
+ *
+ *  @param rx_flags  : WHD_NETWORK_RX_* flags, dropped if the network stack has no
+ *                     whd_network_process_ethernet_data_ext()
+ *
+ */
+whd_result_t whd_network_process_ethernet_data_ext(whd_interface_t ifp, whd_buffer_t buffer, uint32_t rx_flags)
 {
     whd_driver_t whd_driver = ifp->whd_driver;
-    if (whd_driver->network_if->whd_network_process_ethernet_data)
+    if (whd_driver->network_if->whd_network_process_ethernet_data_ext)
     {
+        /* Stamped first: once handed over, the stack may already have freed and reused the buffer */
+        WHD_PKT_TRACE_STAMP(whd_driver, buffer, WHD_PKT_STAGE_RX_NETIF);
+        whd_driver->network_if->whd_network_process_ethernet_data_ext(ifp, buffer, rx_flags);
+        return WHD_SUCCESS;
+    }
+    else if (whd_driver->network_if->whd_network_process_ethernet_data)
+    {
+        /* Stamped first: once handed over, the stack may already have freed and reused the buffer */
+        WHD_PKT_TRACE_STAMP(whd_driver, buffer, WHD_PKT_STAGE_RX_NETIF);
         whd_driver->network_if->whd_network_process_ethernet_data(ifp, buffer);
         return WHD_SUCCESS;
     }
@@ -84,6 +104,48 @@ whd_result_t whd_network_process_ethernet_data(whd_interface_t ifp, whd_buffer_t
     return WHD_WLAN_NOFUNCTION;
 }
 
+/** Tells the network stack to stop or resume sending on one interface
+ *
+ *  @param bsscfgidx : Index of the interface in whd_driver->iflist
+ *  @param stop      : WHD_TRUE to stop sending, WHD_FALSE to resume
+ *
+ */
+void whd_network_tx_flow_control(whd_driver_t whd_driver, uint8_t bsscfgidx, whd_bool_t stop)
+{
+    whd_interface_t ifp;
+
+    if ( (bsscfgidx >= WHD_INTERFACE_MAX) || (whd_driver->network_if == NULL) ||
+         (whd_driver->network_if->whd_network_tx_flow_control == NULL) )
+    {
+        return;
+    }
+    ifp = whd_driver->iflist[bsscfgidx];
+    if (ifp != NULL)
+    {
+        whd_driver->network_if->whd_network_tx_flow_control(ifp, stop);
+    }
+}
+
+/** Tells the network stack that a round of received packets has ended, on every interface
+ *
+ */
+void whd_network_rx_round_end(whd_driver_t whd_driver)
+{
+    uint8_t i;
+
+    if ( (whd_driver->network_if == NULL) || (whd_driver->network_if->whd_network_rx_round_end == NULL) )
+    {
+        return;
+    }
+    for (i = 0; i < WHD_INTERFACE_MAX; i++)
+    {
+        if (whd_driver->iflist[i] != NULL)
+        {
+            whd_driver->network_if->whd_network_rx_round_end(whd_driver->iflist[i]);
+        }
+    }
+}
+
 /** Sends a data packet.
  *
  * @param buffer  : The ethernet packet buffer to be sent
@@ -93,6 +155,7 @@ whd_result_t whd_network_process_ethernet_data(whd_interface_t ifp, whd_buffer_t
  */
 whd_result_t whd_network_send_ethernet_data(whd_interface_t ifp, whd_buffer_t buffer)
 {
+    WHD_PKT_TRACE_STAMP(ifp->whd_driver, buffer, WHD_PKT_STAGE_TX_SEND);
 #ifdef COMPONENT_SDIO_HM
     whd_result_t status;
     cy_rtos_get_mutex(&ifp->whd_driver->whd_hm_tx_lock, CY_RTOS_NEVER_TIMEOUT);
@@ -0,0 +1,374 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Per-packet latency tracing
+ *
+ *  Unsampled packets cost one pointer test per stage, plus a counter at the
+ *  two stages where sampling is decided. Only sampled packets take the lock.
+ */
+
+#ifdef WHD_PKT_TRACE
+
+#include "cyabs_rtos.h"
+#include "whd_pkt_trace.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_debug.h"
+#include "whd_lock.h"
+
+/******************************************************
+*             Structures
+******************************************************/
+
+typedef struct
+{
+    whd_buffer_t buffer;            /* NULL when the slot is free */
+    whd_bool_t rx;
+    uint32_t start_us;
+    uint32_t last_us;
+} whd_pkt_trace_slot_t;
+
+struct whd_pkt_trace
+{
+    whd_lock_t lock;
+    uint32_t (*get_time_us)(void);
+    uint32_t sample_every;
+    uint32_t tx_countdown;
+    uint32_t rx_countdown;
+    volatile uint32_t active;       /* Slots in use */
+    whd_pkt_trace_slot_t slots[WHD_PKT_TRACE_SLOTS];
+    whd_pkt_trace_stats_t stats;
+};
+
+/******************************************************
+*             Static Variables
+******************************************************/
+
+/* Interval ending at each stage; the first stage of each direction has none */
+static const int8_t whd_pkt_stage_interval[WHD_PKT_STAGE_MAX] =
+{
+    [WHD_PKT_STAGE_TX_SEND]     = -1,
+    [WHD_PKT_STAGE_TX_ENQUEUE]  = WHD_PKT_INTERVAL_TX_ENQUEUE,
+    [WHD_PKT_STAGE_TX_DEQUEUE]  = WHD_PKT_INTERVAL_TX_QUEUED,
+    [WHD_PKT_STAGE_TX_DONE]     = WHD_PKT_INTERVAL_TX_BUS,
+    [WHD_PKT_STAGE_RX_BUS_READ] = -1,
+    [WHD_PKT_STAGE_RX_DECODE]   = WHD_PKT_INTERVAL_RX_DECODE,
+    [WHD_PKT_STAGE_RX_NETIF]    = WHD_PKT_INTERVAL_RX_HANDOFF,
+};
+
+static const char *const whd_pkt_interval_name[WHD_PKT_INTERVAL_MAX] =
+{
+    "tx_enqueue", "tx_queued", "tx_bus", "tx_total", "rx_decode", "rx_handoff", "rx_total"
+};
+
+/******************************************************
+*             Static Functions
+******************************************************/
+
+static uint32_t whd_pkt_trace_now(struct whd_pkt_trace *trace)
+{
+    cy_time_t now;
+
+    if (trace->get_time_us != NULL)
+    {
+        return trace->get_time_us();
+    }
+    (void)cy_rtos_get_time(&now);
+    return (uint32_t)now * 1000;
+}
+
+static void whd_pkt_trace_hist_add(whd_pkt_trace_hist_t *hist, uint32_t us)
+{
+    uint32_t bucket = 0;
+
+    /* Stops at the last bucket, which also takes everything larger, so the shift stays below 32 */
+    while ( (bucket < WHD_PKT_TRACE_BUCKETS - 1) && ( (us >> bucket) != 0 ) )
+    {
+        bucket++;
+    }
+    hist->buckets[bucket]++;
+    hist->count++;
+    hist->total_us += us;
+    if (us > hist->max_us)
+    {
+        hist->max_us = us;
+    }
+}
+
+/* Matches the direction too: a handle can be freed by the stack and reused for TX before RX has finished with it */
+static whd_pkt_trace_slot_t *whd_pkt_trace_find(struct whd_pkt_trace *trace, whd_buffer_t buffer, whd_bool_t rx)
+{
+    uint32_t i;
+
+    for (i = 0; i < WHD_PKT_TRACE_SLOTS; i++)
+    {
+        if ( (trace->slots[i].buffer == buffer) && ( (buffer == NULL) || (trace->slots[i].rx == rx) ) )
+        {
+            return &trace->slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void whd_pkt_trace_release_slot(struct whd_pkt_trace *trace, whd_pkt_trace_slot_t *slot)
+{
+    slot->buffer = NULL;
+    trace->active--;
+}
+
+/* Claims a slot, recycling it if the handle is still tracked from a packet that was dropped */
+static void whd_pkt_trace_start(struct whd_pkt_trace *trace, whd_buffer_t buffer, whd_bool_t rx, uint32_t now)
+{
+    whd_pkt_trace_slot_t *slot = whd_pkt_trace_find(trace, buffer, rx);
+    uint32_t i;
+
+    if (slot != NULL)
+    {
+        trace->stats.abandoned++;
+        whd_pkt_trace_release_slot(trace, slot);
+    }
+    for (i = 0; i < WHD_PKT_TRACE_SLOTS; i++)
+    {
+        if ( (trace->slots[i].buffer != NULL) &&
+             ( (uint32_t)(now - trace->slots[i].start_us) > WHD_PKT_TRACE_STALE_US ) )
+        {
+            trace->stats.abandoned++;
+            whd_pkt_trace_release_slot(trace, &trace->slots[i]);
+        }
+    }
+
+    slot = whd_pkt_trace_find(trace, NULL, rx);
+    if (slot == NULL)
+    {
+        trace->stats.no_slot++;
+        return;
+    }
+    slot->buffer = buffer;
+    slot->rx = rx;
+    slot->start_us = now;
+    slot->last_us = now;
+    trace->active++;
+    trace->stats.sampled++;
+}
+
+/******************************************************
+*             Global Functions
+******************************************************/
+
+void whd_pkt_trace_stamp(whd_driver_t whd_driver, whd_buffer_t buffer, whd_pkt_stage_t stage)
+{
+    struct whd_pkt_trace *trace = whd_driver->pkt_trace;
+    whd_pkt_trace_slot_t *slot;
+    uint32_t *countdown = NULL;
+    whd_bool_t rx = (stage >= WHD_PKT_STAGE_RX_BUS_READ) ? WHD_TRUE : WHD_FALSE;
+    uint32_t now, us;
+    int8_t interval;
+
+    if (stage == WHD_PKT_STAGE_TX_SEND)
+    {
+        trace->stats.tx_seen++;
+        countdown = &trace->tx_countdown;
+    }
+    else if (stage == WHD_PKT_STAGE_RX_BUS_READ)
+    {
+        trace->stats.rx_seen++;
+        countdown = &trace->rx_countdown;
+    }
+
+    if (countdown != NULL)
+    {
+        /* Counters are updated without the lock, so the rate is approximate when several threads transmit */
+        if ( (trace->sample_every == 0) || (--(*countdown) != 0) )
+        {
+            return;
+        }
+        *countdown = trace->sample_every;
+    }
+    else if (trace->active == 0)
+    {
+        return;
+    }
+
+    (void)whd_lock_acquire(&trace->lock, CY_RTOS_NEVER_TIMEOUT);
+    now = whd_pkt_trace_now(trace);
+    if (countdown != NULL)
+    {
+        whd_pkt_trace_start(trace, buffer, rx, now);
+    }
+    else if ( (slot = whd_pkt_trace_find(trace, buffer, rx) ) != NULL )
+    {
+        interval = whd_pkt_stage_interval[stage];
+        us = now - slot->last_us;
+        whd_pkt_trace_hist_add(&trace->stats.hist[interval], us);
+        slot->last_us = now;
+
+        if ( (stage == WHD_PKT_STAGE_TX_DONE) || (stage == WHD_PKT_STAGE_RX_NETIF) )
+        {
+            whd_pkt_trace_hist_add(&trace->stats.hist[(stage == WHD_PKT_STAGE_TX_DONE) ?
+                                                      WHD_PKT_INTERVAL_TX_TOTAL : WHD_PKT_INTERVAL_RX_TOTAL],
+                                   now - slot->start_us);
+            trace->stats.completed++;
+            whd_pkt_trace_release_slot(trace, slot);
+        }
+    }
+    (void)whd_lock_release(&trace->lock);
+}
+
+void whd_pkt_trace_cancel(whd_driver_t whd_driver, whd_buffer_t buffer)
+{
+    struct whd_pkt_trace *trace = whd_driver->pkt_trace;
+    whd_pkt_trace_slot_t *slot;
+
+    if (trace->active == 0)
+    {
+        return;
+    }
+    (void)whd_lock_acquire(&trace->lock, CY_RTOS_NEVER_TIMEOUT);
+    slot = whd_pkt_trace_find(trace, buffer, WHD_TRUE);
+    if (slot == NULL)
+    {
+        slot = whd_pkt_trace_find(trace, buffer, WHD_FALSE);
+    }
+    if (slot != NULL)
+    {
+        whd_pkt_trace_release_slot(trace, slot);
+    }
+    (void)whd_lock_release(&trace->lock);
+}
+
+whd_result_t whd_pkt_trace_enable(whd_driver_t whd_driver, uint32_t sample_every, uint32_t (*get_time_us)(void) )
+{
+    struct whd_pkt_trace *trace;
+
+    CHECK_DRIVER_NULL(whd_driver);
+
+    trace = whd_driver->pkt_trace;
+    if (trace == NULL)
+    {
+        trace = (struct whd_pkt_trace *)whd_mem_calloc(1, sizeof(struct whd_pkt_trace) );
+        if (trace == NULL)
+        {
+            WPRINT_WHD_ERROR( ("Memory allocation failed for whd_pkt_trace in %s\n", __FUNCTION__) );
+            return WHD_MALLOC_FAILURE;
+        }
+        if (whd_lock_init(&trace->lock, "pkt_trace", WHD_LOCK_SHORT) != WHD_SUCCESS)
+        {
+            whd_mem_free(trace);
+            return WHD_SEMAPHORE_ERROR;
+        }
+    }
+
+    (void)whd_lock_acquire(&trace->lock, CY_RTOS_NEVER_TIMEOUT);
+    trace->get_time_us = get_time_us;
+    trace->sample_every = sample_every;
+    trace->tx_countdown = sample_every;
+    trace->rx_countdown = sample_every;
+    (void)whd_lock_release(&trace->lock);
+
+    /* Published last: the stamp macro only tests this pointer */
+    whd_driver->pkt_trace = trace;
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_pkt_trace_get_stats(whd_driver_t whd_driver, whd_pkt_trace_stats_t *stats)
+{
+    struct whd_pkt_trace *trace;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    trace = whd_driver->pkt_trace;
+    if ( (trace == NULL) || (stats == NULL) )
+    {
+        return WHD_BADARG;
+    }
+
+    (void)whd_lock_acquire(&trace->lock, CY_RTOS_NEVER_TIMEOUT);
+    whd_mem_memcpy(stats, &trace->stats, sizeof(*stats) );
+    (void)whd_lock_release(&trace->lock);
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_pkt_trace_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
+{
+    whd_pkt_trace_stats_t *stats;
+    whd_pkt_trace_hist_t *hist;
+    uint32_t i, b;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    if (whd_driver->pkt_trace == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    /* Printed from a snapshot so the lock is not held across console output */
+    stats = (whd_pkt_trace_stats_t *)whd_mem_malloc(sizeof(*stats) );
+    if (stats == NULL)
+    {
+        return WHD_MALLOC_FAILURE;
+    }
+    (void)whd_pkt_trace_get_stats(whd_driver, stats);
+
+    WPRINT_MACRO( ("Packet latency.. \n"
+                   "tx_seen:%" PRIu32 ", rx_seen:%" PRIu32 ", sampled:%" PRIu32 ", completed:%" PRIu32
+                   ", no_slot:%" PRIu32 ", abandoned:%" PRIu32 "\n",
+                   stats->tx_seen, stats->rx_seen, stats->sampled, stats->completed, stats->no_slot,
+                   stats->abandoned) );
+    for (i = 0; i < WHD_PKT_INTERVAL_MAX; i++)
+    {
+        hist = &stats->hist[i];
+        if (hist->count == 0)
+        {
+            continue;
+        }
+        WPRINT_MACRO( ("%s n:%" PRIu32 " avg:%" PRIu32 "us max:%" PRIu32 "us\n", whd_pkt_interval_name[i],
+                       hist->count, (uint32_t)(hist->total_us / hist->count), hist->max_us) );
+        for (b = 0; b < WHD_PKT_TRACE_BUCKETS; b++)
+        {
+            if (hist->buckets[b] != 0)
+            {
+                WPRINT_MACRO( ("  <%" PRIu32 "us:%" PRIu32 "\n", (uint32_t)1 << b, hist->buckets[b]) );
+            }
+        }
+    }
+    whd_mem_free(stats);
+
+    if (reset_after_print == WHD_TRUE)
+    {
+        (void)whd_lock_acquire(&whd_driver->pkt_trace->lock, CY_RTOS_NEVER_TIMEOUT);
+        whd_mem_memset(&whd_driver->pkt_trace->stats, 0, sizeof(whd_driver->pkt_trace->stats) );
+        (void)whd_lock_release(&whd_driver->pkt_trace->lock);
+    }
+
+    return WHD_SUCCESS;
+}
+
+void whd_pkt_trace_deinit(whd_driver_t whd_driver)
+{
+    struct whd_pkt_trace *trace = whd_driver->pkt_trace;
+
+    if (trace == NULL)
+    {
+        return;
+    }
+    whd_driver->pkt_trace = NULL;
+    (void)whd_lock_deinit(&trace->lock);
+    whd_mem_free(trace);
+}
+
+#endif /* WHD_PKT_TRACE */
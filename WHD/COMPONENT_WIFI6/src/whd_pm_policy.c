@@ -0,0 +1,554 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Traffic-adaptive power save
+ *
+ *  The packet counters are bumped without a lock from the TX callers and the WHD thread. A lost
+ *  increment only shifts a rate estimate by one packet, which the hysteresis absorbs.
+ */
+
+#ifdef WHD_PM_POLICY
+
+#include "cyabs_rtos.h"
+#include "whd_pm_policy.h"
+#include "whd_int.h"
+#include "whd_utils.h"
+#include "whd_debug.h"
+#include "whd_lock.h"
+#include "whd_wifi_api.h"
+
+/******************************************************
+*             Constants
+******************************************************/
+
+/* Same limits as whd_wifi_enable_powersave_with_throughput() */
+#define WHD_PM_POLICY_SLEEP_RET_MIN     (10)
+#define WHD_PM_POLICY_SLEEP_RET_MAX     (2000)
+
+#define WHD_PM_POLICY_LEVEL_NONE        (0xFFFFFFFF)
+
+/******************************************************
+*             Structures
+******************************************************/
+
+struct whd_pm_policy
+{
+    whd_lock_t lock;                /* Guards engine against the stats readers */
+    whd_interface_t ifp;
+    cy_worker_thread_info_t *worker;
+    cy_worker_thread_work_t work;
+    whd_bool_t running;
+    volatile uint32_t tx_packets;
+    volatile uint32_t rx_packets;
+    volatile uint32_t queue_depth_max;
+    uint32_t last_tx_packets;
+    uint32_t last_rx_packets;
+    uint32_t applied_level;         /* Level the interface is in, WHD_PM_POLICY_LEVEL_NONE before the first */
+    whd_pm_policy_engine_t engine;
+};
+
+/* Parks every thread of a worker, see whd_pm_policy_deinit() */
+typedef struct
+{
+    cy_semaphore_t parked;
+    cy_semaphore_t release;
+    cy_semaphore_t left;
+} whd_pm_policy_flush_t;
+
+/******************************************************
+*             Static Variables
+******************************************************/
+
+static const whd_pm_policy_level_t whd_pm_policy_default_levels[] = WHD_PM_POLICY_DEFAULT_LEVELS;
+
+static const char *const whd_pm_mode_name[] = { "PM0", "PM1", "PM2" };
+
+/******************************************************
+*             Engine
+******************************************************/
+
+whd_result_t whd_pm_policy_engine_init(whd_pm_policy_engine_t *engine, const whd_pm_policy_config_t *config,
+                                       uint32_t now_ms)
+{
+    whd_pm_policy_config_t *cfg;
+    whd_pm_policy_level_t *level;
+    uint32_t i;
+
+    if (engine == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    whd_mem_memset(engine, 0, sizeof(*engine) );
+    cfg = &engine->config;
+    if (config != NULL)
+    {
+        whd_mem_memcpy(cfg, config, sizeof(*cfg) );
+    }
+    if (cfg->sample_ms == 0)
+    {
+        cfg->sample_ms = WHD_PM_POLICY_DEFAULT_SAMPLE_MS;
+    }
+    if (cfg->up_samples == 0)
+    {
+        cfg->up_samples = WHD_PM_POLICY_DEFAULT_UP_SAMPLES;
+    }
+    if (cfg->down_samples == 0)
+    {
+        cfg->down_samples = WHD_PM_POLICY_DEFAULT_DOWN_SAMPLES;
+    }
+    if (cfg->num_levels == 0)
+    {
+        cfg->num_levels = ARRAY_SIZE(whd_pm_policy_default_levels);
+        whd_mem_memcpy(cfg->levels, whd_pm_policy_default_levels, sizeof(whd_pm_policy_default_levels) );
+    }
+    if (cfg->num_levels > WHD_PM_POLICY_MAX_LEVELS)
+    {
+        return WHD_BADARG;
+    }
+
+    for (i = 0; i < cfg->num_levels; i++)
+    {
+        level = &cfg->levels[i];
+        if ( (level->pm_mode > PM2_POWERSAVE_MODE) || (level->exit_pps > level->enter_pps) )
+        {
+            return WHD_BADARG;
+        }
+        if ( (level->pm_mode == PM2_POWERSAVE_MODE) &&
+             ( (level->pm2_sleep_ret_ms < WHD_PM_POLICY_SLEEP_RET_MIN) ||
+               (level->pm2_sleep_ret_ms > WHD_PM_POLICY_SLEEP_RET_MAX) ) )
+        {
+            return WHD_BADARG;
+        }
+        if ( (i > 0) && (level->enter_pps <= cfg->levels[i - 1].enter_pps) )
+        {
+            return WHD_BADARG;
+        }
+    }
+
+    engine->last_ms = now_ms;
+    engine->stats.entered[0] = 1;
+
+    return WHD_SUCCESS;
+}
+
+/* Level l is wanted by a sample if its rate or queue threshold is reached */
+static whd_bool_t whd_pm_policy_level_wanted(const whd_pm_policy_level_t *level, uint32_t pps,
+                                             uint32_t queue_depth)
+{
+    if (pps >= level->enter_pps)
+    {
+        return WHD_TRUE;
+    }
+    return ( (level->enter_queue_depth != 0) && (queue_depth >= level->enter_queue_depth) ) ? WHD_TRUE : WHD_FALSE;
+}
+
+whd_bool_t whd_pm_policy_engine_sample(whd_pm_policy_engine_t *engine, uint32_t now_ms, uint32_t packets,
+                                       uint32_t max_queue_depth)
+{
+    whd_pm_policy_config_t *cfg = &engine->config;
+    const whd_pm_policy_level_t *current = &cfg->levels[engine->level];
+    uint32_t elapsed = now_ms - engine->last_ms;
+    uint32_t target = engine->level;
+    uint32_t pps;
+    uint32_t i;
+
+    engine->last_ms = now_ms;
+    engine->stats.time_in_level_ms[engine->level] += elapsed;
+    engine->stats.samples++;
+
+    /* A late or early sample is still a rate over the time it covers */
+    if (elapsed == 0)
+    {
+        elapsed = cfg->sample_ms;
+    }
+    pps = (uint32_t)( ( (uint64_t)packets * 1000) / elapsed );
+
+    for (i = engine->level + 1; i < cfg->num_levels; i++)
+    {
+        if (whd_pm_policy_level_wanted(&cfg->levels[i], pps, max_queue_depth) == WHD_TRUE)
+        {
+            target = i;
+        }
+    }
+
+    if (target > engine->level)
+    {
+        engine->down_count = 0;
+        if (++engine->up_count < cfg->up_samples)
+        {
+            return WHD_FALSE;
+        }
+    }
+    else if ( (engine->level > 0) && (pps < current->exit_pps) &&
+              ( (current->enter_queue_depth == 0) || (max_queue_depth < current->enter_queue_depth) ) )
+    {
+        engine->up_count = 0;
+        if (++engine->down_count < cfg->down_samples)
+        {
+            return WHD_FALSE;
+        }
+        /* Down one level at a time so a lull in a transfer stops short of the deepest mode */
+        target = engine->level - 1;
+    }
+    else
+    {
+        engine->up_count = 0;
+        engine->down_count = 0;
+        return WHD_FALSE;
+    }
+
+    engine->up_count = 0;
+    engine->down_count = 0;
+    engine->level = target;
+    engine->stats.level = target;
+    engine->stats.transitions++;
+    engine->stats.entered[target]++;
+
+    return WHD_TRUE;
+}
+
+/******************************************************
+*             Driver side
+******************************************************/
+
+static whd_result_t whd_pm_policy_apply(struct whd_pm_policy *policy, const whd_pm_policy_level_t *level)
+{
+    switch (level->pm_mode)
+    {
+        case NO_POWERSAVE_MODE:
+            return whd_wifi_disable_powersave(policy->ifp);
+        case PM1_POWERSAVE_MODE:
+            return whd_wifi_enable_powersave(policy->ifp);
+        default:
+            return whd_wifi_enable_powersave_with_throughput(policy->ifp, level->pm2_sleep_ret_ms);
+    }
+}
+
+/* Runs on the worker thread every sample_ms; the PM ioctls cannot be issued from the WHD thread */
+static void whd_pm_policy_work(void *arg)
+{
+    struct whd_pm_policy *policy = (struct whd_pm_policy *)arg;
+    uint32_t tx_packets = policy->tx_packets;
+    uint32_t rx_packets = policy->rx_packets;
+    uint32_t queue_depth = policy->queue_depth_max;
+    whd_pm_policy_level_t level;
+    uint32_t level_index;
+    cy_time_t now;
+
+    policy->queue_depth_max = 0;
+    (void)cy_rtos_get_time(&now);
+    (void)whd_lock_acquire(&policy->lock, CY_RTOS_NEVER_TIMEOUT);
+    if (policy->running != WHD_TRUE)
+    {
+        (void)whd_lock_release(&policy->lock);
+        return;
+    }
+    (void)whd_pm_policy_engine_sample(&policy->engine, (uint32_t)now,
+                                      (tx_packets - policy->last_tx_packets) +
+                                      (rx_packets - policy->last_rx_packets), queue_depth);
+    level_index = policy->engine.level;
+    level = policy->engine.config.levels[level_index];
+    (void)whd_lock_release(&policy->lock);
+    policy->last_tx_packets = tx_packets;
+    policy->last_rx_packets = rx_packets;
+
+    if (level_index == policy->applied_level)
+    {
+        return;
+    }
+
+    if (whd_pm_policy_apply(policy, &level) != WHD_SUCCESS)
+    {
+        (void)whd_lock_acquire(&policy->lock, CY_RTOS_NEVER_TIMEOUT);
+        policy->engine.stats.apply_failed++;
+        (void)whd_lock_release(&policy->lock);
+        return;
+    }
+    WPRINT_WHD_DEBUG( ("PM policy: level %" PRIu32 " (%s, sleep_ret %u ms) at %" PRIu32 " ms\n", level_index,
+                       whd_pm_mode_name[level.pm_mode], level.pm2_sleep_ret_ms, (uint32_t)now) );
+    policy->applied_level = level_index;
+}
+
+whd_result_t whd_pm_policy_start(whd_interface_t ifp, const whd_pm_policy_config_t *config,
+                                 cy_worker_thread_info_t *worker)
+{
+    struct whd_pm_policy *policy;
+    whd_driver_t whd_driver;
+    cy_time_t now;
+    whd_result_t result;
+
+    CHECK_IFP_NULL(ifp);
+    whd_driver = ifp->whd_driver;
+    CHECK_DRIVER_NULL(whd_driver);
+    if (worker == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    policy = whd_driver->pm_policy;
+    if (policy == NULL)
+    {
+        policy = (struct whd_pm_policy *)whd_mem_calloc(1, sizeof(struct whd_pm_policy) );
+        if (policy == NULL)
+        {
+            WPRINT_WHD_ERROR( ("Memory allocation failed for whd_pm_policy in %s\n", __FUNCTION__) );
+            return WHD_MALLOC_FAILURE;
+        }
+        if (whd_lock_init(&policy->lock, "pm_policy", WHD_LOCK_SHORT) != WHD_SUCCESS)
+        {
+            whd_mem_free(policy);
+            return WHD_SEMAPHORE_ERROR;
+        }
+        cy_worker_thread_work_init(&policy->work, whd_pm_policy_work, policy);
+        /* Published once and kept until whd_deinit(); the counting macros only test this pointer */
+        whd_driver->pm_policy = policy;
+    }
+    else if (policy->running == WHD_TRUE)
+    {
+        return WHD_PENDING;
+    }
+
+    (void)cy_rtos_get_time(&now);
+    (void)whd_lock_acquire(&policy->lock, CY_RTOS_NEVER_TIMEOUT);
+    result = whd_pm_policy_engine_init(&policy->engine, config, (uint32_t)now);
+    (void)whd_lock_release(&policy->lock);
+    if (result != WHD_SUCCESS)
+    {
+        return result;
+    }
+
+    policy->ifp = ifp;
+    policy->worker = worker;
+    policy->last_tx_packets = policy->tx_packets;
+    policy->last_rx_packets = policy->rx_packets;
+    policy->queue_depth_max = 0;
+
+    CHECK_RETURN(whd_pm_policy_apply(policy, &policy->engine.config.levels[0]) );
+    policy->applied_level = 0;
+    policy->running = WHD_TRUE;
+
+    if (cy_worker_thread_work_enqueue_delayed(worker, &policy->work, policy->engine.config.sample_ms,
+                                              policy->engine.config.sample_ms) != CY_RSLT_SUCCESS)
+    {
+        policy->running = WHD_FALSE;
+        WPRINT_WHD_ERROR( ("Could not schedule the PM policy work in %s\n", __FUNCTION__) );
+        return WHD_QUEUE_ERROR;
+    }
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_pm_policy_stop(whd_driver_t whd_driver)
+{
+    struct whd_pm_policy *policy;
+    whd_bool_t was_running;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    policy = whd_driver->pm_policy;
+    if (policy == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    /* A sample that takes the lock after this one returns without touching the interface */
+    (void)whd_lock_acquire(&policy->lock, CY_RTOS_NEVER_TIMEOUT);
+    was_running = policy->running;
+    policy->running = WHD_FALSE;
+    (void)whd_lock_release(&policy->lock);
+    if (was_running == WHD_TRUE)
+    {
+        (void)cy_worker_thread_work_cancel(policy->worker, &policy->work);
+    }
+    policy->applied_level = WHD_PM_POLICY_LEVEL_NONE;
+
+    return WHD_SUCCESS;
+}
+
+void whd_pm_policy_note_tx(whd_driver_t whd_driver, uint32_t queue_depth)
+{
+    struct whd_pm_policy *policy = whd_driver->pm_policy;
+
+    policy->tx_packets++;
+    if (queue_depth > policy->queue_depth_max)
+    {
+        policy->queue_depth_max = queue_depth;
+    }
+}
+
+void whd_pm_policy_note_rx(whd_driver_t whd_driver)
+{
+    whd_driver->pm_policy->rx_packets++;
+}
+
+whd_result_t whd_pm_policy_get_stats(whd_driver_t whd_driver, whd_pm_policy_stats_t *stats)
+{
+    struct whd_pm_policy *policy;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    policy = whd_driver->pm_policy;
+    if ( (policy == NULL) || (stats == NULL) )
+    {
+        return WHD_BADARG;
+    }
+
+    (void)whd_lock_acquire(&policy->lock, CY_RTOS_NEVER_TIMEOUT);
+    whd_mem_memcpy(stats, &policy->engine.stats, sizeof(*stats) );
+    (void)whd_lock_release(&policy->lock);
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_pm_policy_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
+{
+    struct whd_pm_policy *policy;
+    whd_pm_policy_stats_t stats;
+    const whd_pm_policy_level_t *level;
+    uint32_t level_index;
+    uint32_t i;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    policy = whd_driver->pm_policy;
+    if (policy == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    /* Printed from a snapshot so the lock is not held across console output */
+    CHECK_RETURN(whd_pm_policy_get_stats(whd_driver, &stats) );
+
+    WPRINT_MACRO( ("PM policy.. %s\n"
+                   "level:%" PRIu32 ", samples:%" PRIu32 ", transitions:%" PRIu32 ", apply_failed:%" PRIu32 "\n",
+                   (policy->running == WHD_TRUE) ? "running" : "stopped", stats.level, stats.samples,
+                   stats.transitions, stats.apply_failed) );
+    for (i = 0; i < policy->engine.config.num_levels; i++)
+    {
+        level = &policy->engine.config.levels[i];
+        WPRINT_MACRO( ("  %" PRIu32 " %s/%u: entered:%" PRIu32 ", time:%" PRIu32 " ms\n", i,
+                       whd_pm_mode_name[level->pm_mode], level->pm2_sleep_ret_ms, stats.entered[i],
+                       stats.time_in_level_ms[i]) );
+    }
+
+    if (reset_after_print == WHD_TRUE)
+    {
+        (void)whd_lock_acquire(&policy->lock, CY_RTOS_NEVER_TIMEOUT);
+        level_index = policy->engine.stats.level;
+        whd_mem_memset(&policy->engine.stats, 0, sizeof(policy->engine.stats) );
+        policy->engine.stats.level = level_index;
+        (void)whd_lock_release(&policy->lock);
+    }
+
+    return WHD_SUCCESS;
+}
+
+static void whd_pm_policy_flush_work(void *arg)
+{
+    whd_pm_policy_flush_t *flush = (whd_pm_policy_flush_t *)arg;
+
+    (void)cy_rtos_set_semaphore(&flush->parked, WHD_FALSE);
+    (void)cy_rtos_get_semaphore(&flush->release, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    (void)cy_rtos_set_semaphore(&flush->left, WHD_FALSE);
+}
+
+static void whd_pm_policy_free(struct whd_pm_policy *policy)
+{
+    (void)whd_lock_deinit(&policy->lock);
+    whd_mem_free(policy);
+}
+
+void whd_pm_policy_deinit(whd_driver_t whd_driver)
+{
+    struct whd_pm_policy *policy = whd_driver->pm_policy;
+    cy_worker_thread_info_t *worker;
+    whd_pm_policy_flush_t flush;
+    uint32_t threads;
+    uint32_t parked = 0;
+    uint32_t i;
+    cy_rslt_t result;
+
+    if (policy == NULL)
+    {
+        return;
+    }
+    (void)whd_pm_policy_stop(whd_driver);
+    whd_driver->pm_policy = NULL;
+
+    /* Never scheduled, or the worker was deleted first and took the work item with it */
+    worker = policy->worker;
+    if ( (worker == NULL) || (worker->state == CY_WORKER_THREAD_INVALID) )
+    {
+        whd_pm_policy_free(policy);
+        return;
+    }
+
+    /* Cancelling neither waits for a sample that is running nor takes one off the queue, so a
+     * parking item is queued for every thread of the worker behind them. Once all the threads
+     * are parked, none can be in or get to whd_pm_policy_work() any more. */
+    threads = worker->num_threads;
+    if ( (cy_rtos_init_semaphore(&flush.parked, threads, 0) != WHD_SUCCESS) ||
+         (cy_rtos_init_semaphore(&flush.release, threads, 0) != WHD_SUCCESS) ||
+         (cy_rtos_init_semaphore(&flush.left, threads, 0) != WHD_SUCCESS) )
+    {
+        WPRINT_WHD_ERROR( ("Could not wait for the PM policy work in %s, its state is not freed\n", __FUNCTION__) );
+        return;
+    }
+    while (parked < threads)
+    {
+        result = cy_worker_thread_enqueue(worker, whd_pm_policy_flush_work, &flush);
+        if (result == CY_RSLT_SUCCESS)
+        {
+            parked++;
+        }
+        else if (result == CY_WORKER_THREAD_ERR_THREAD_INVALID)
+        {
+            break;
+        }
+        else
+        {
+            /* Queue full, the threads not parked yet are draining it */
+            (void)cy_rtos_delay_milliseconds(1);
+        }
+    }
+    for (i = 0; i < parked; i++)
+    {
+        (void)cy_rtos_get_semaphore(&flush.parked, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    }
+
+    if (parked == threads)
+    {
+        whd_pm_policy_free(policy);
+    }
+    else
+    {
+        WPRINT_WHD_ERROR( ("Worker deleted during %s, the PM policy state is not freed\n", __FUNCTION__) );
+    }
+
+    for (i = 0; i < parked; i++)
+    {
+        (void)cy_rtos_set_semaphore(&flush.release, WHD_FALSE);
+    }
+    for (i = 0; i < parked; i++)
+    {
+        (void)cy_rtos_get_semaphore(&flush.left, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE);
+    }
+    (void)cy_rtos_deinit_semaphore(&flush.parked);
+    (void)cy_rtos_deinit_semaphore(&flush.release);
+    (void)cy_rtos_deinit_semaphore(&flush.left);
+}
+
+#endif /* WHD_PM_POLICY */
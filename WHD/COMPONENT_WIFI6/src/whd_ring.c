@@ -41,10 +41,13 @@ static int whd_ring_mb_ring_bell(void *ctx)
 {
     WPRINT_WHD_DEBUG( ("RINGING !!!\n") );
 
-    /* Any arbitrary value will do, lets use 1 */
-#ifndef GCI_SECURE_ACCESS
     struct whd_ringbuf *ring = (struct whd_ringbuf *)ctx;
     whd_driver_t whd_driver = ring->whd_drv;
+
+    whd_bus_oci_note_doorbell(whd_driver);
+
+    /* Any arbitrary value will do, lets use 1 */
+#ifndef GCI_SECURE_ACCESS
     CHECK_RETURN(whd_bus_write_backplane_value(whd_driver, (uint32_t)GCI_BT2WL_DB0_REG, 4, 0x01) );
 #else
     CHECK_RETURN(whd_hw_generateBt2WlDbInterruptApi(0, 0x01));
@@ -130,6 +133,44 @@ static void whd_write_tcm32(whd_driver_t whd_driver, uint32_t mem_offset, uint32
     REG32(TRANS_ADDR(address) ) = value;
 }
 
+/* Puts the ring indices in a block of host memory and tells the device where each array is */
+static whd_result_t whd_ring_host_idx_init(whd_driver_t whd_driver, uint16_t max_submissionrings,
+                                           uint16_t max_completionrings)
+{
+    struct whd_ring_idx_block *block = &whd_driver->ram_shared->host_idx;
+    uint32_t ring_info_addr = whd_driver->ram_shared->ring_info_addr;
+    uint32_t size;
+    void *buf;
+
+    size = whd_ring_idx_block_size(whd_driver->dma_index_sz, max_submissionrings, max_completionrings);
+    if (size == 0)
+        return WHD_BADARG;
+
+    /* From the DMA pool like the rings themselves, it is released with them at deinit */
+    buf = whd_dmapool_alloc(whd_driver, (int)size);
+    if (buf == NULL)
+        return WHD_MALLOC_FAILURE;
+    whd_mem_memset(buf, 0, size);
+
+    CHECK_RETURN(whd_ring_idx_block_init(block, buf, whd_driver->dma_index_sz, max_submissionrings,
+                                         max_completionrings) );
+
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, h2d_w_idx_hostaddr),
+                    whd_ring_idx_array_addr(block, WHD_RING_IDX_H2D_W) );
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, h2d_w_idx_hostaddr) + 4, 0);
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, h2d_r_idx_hostaddr),
+                    whd_ring_idx_array_addr(block, WHD_RING_IDX_H2D_R) );
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, h2d_r_idx_hostaddr) + 4, 0);
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, d2h_w_idx_hostaddr),
+                    whd_ring_idx_array_addr(block, WHD_RING_IDX_D2H_W) );
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, d2h_w_idx_hostaddr) + 4, 0);
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, d2h_r_idx_hostaddr),
+                    whd_ring_idx_array_addr(block, WHD_RING_IDX_D2H_R) );
+    whd_write_tcm32(whd_driver, ring_info_addr + offsetof(struct whd_dhi_ringinfo, d2h_r_idx_hostaddr) + 4, 0);
+
+    return WHD_SUCCESS;
+}
+
 void whd_bus_handle_mb_data(whd_driver_t whd_driver, uint32_t d2h_mb_data)
 {
 
@@ -147,6 +188,7 @@ void whd_bus_handle_mb_data(whd_driver_t whd_driver, uint32_t d2h_mb_data)
     {
         WPRINT_WHD_DEBUG( ("D2H_MB_DATA: D3 ACK\n") );
         whd_driver->ack_d2h_suspend = 1;
+        whd_bus_oci_note_d3_ack(whd_driver);
     }
 
     if (d2h_mb_data & WHD_D2H_DEV_FWHALT)
@@ -179,6 +221,9 @@ whd_result_t whd_bus_suspend(whd_driver_t whd_driver)
 whd_result_t whd_bus_resume(whd_driver_t whd_driver)
 {
     whd_result_t result = WHD_SUCCESS;
+    cy_time_t start_ms = 0;
+
+    (void)cy_rtos_time_get(&start_ms);
 
     /* Check register “BT2WL Clock Request and Status Register (Offset 0x6A4)”
      * if ALP or HT not available on WLAN backplane then set ALPAvailRequest (AQ) before accessing the TCM.
@@ -205,6 +250,7 @@ whd_result_t whd_bus_resume(whd_driver_t whd_driver)
         whd_driver->ack_d2h_suspend = WHD_FALSE;
         /* If Resume from Host, send H1D DB1 to "WLAN FW" */
         WPRINT_WHD_INFO( ("Notify Firmware about HOST READY!!! \n") );
+        whd_bus_oci_note_doorbell(whd_driver);
 #ifndef GCI_SECURE_ACCESS
         result = whd_bus_write_backplane_value(whd_driver, (uint32_t)GCI_BT2WL_DB1_REG, 4, WHD_H2D_INFORM_HOSTRDY);
 #else
@@ -214,6 +260,7 @@ whd_result_t whd_bus_resume(whd_driver_t whd_driver)
         {
             WPRINT_WHD_ERROR( ("whd_bus_write_backplane_value failed in %s at %d \n", __func__, __LINE__) );
         }
+        whd_bus_oci_note_resume(whd_driver, (uint32_t)start_ms);
     }
 
     return WHD_SUCCESS;
@@ -237,7 +284,7 @@ static struct whd_ringbuf *whd_allocate_ring_and_handle(whd_driver_t whd_driver,
     size = whd_ring_max_item[ring_id] * ring_itemsize_array[ring_id];
 
     WPRINT_WHD_DEBUG( ("Allocate Ring Handle: %s\n", __func__) );
-    ring_handle = whd_dmapool_alloc(size);
+    ring_handle = whd_dmapool_alloc(whd_driver, size);
 
     if(ring_handle == NULL)
         return NULL;
@@ -360,6 +407,41 @@ uint32_t whd_bus_m2m_ring_init(whd_driver_t whd_driver)
         return WHD_WLAN_BADARG;
     }
 
+    if (whd_driver->dma_index_sz != 0)
+    {
+        /* Every flowring walked below needs an index, whatever max_submissionrings says */
+        result = whd_ring_host_idx_init(whd_driver,
+                                        MAX_OF(max_submissionrings, max_flowrings + WHD_NROF_H2D_COMMON_MSGRINGS),
+                                        max_completionrings);
+        if (result == WHD_SUCCESS)
+        {
+            struct whd_ring_idx_block *block = &whd_driver->ram_shared->host_idx;
+
+            d2h_w_idx_ptr = whd_ring_idx_array_addr(block, WHD_RING_IDX_D2H_W);
+            d2h_r_idx_ptr = whd_ring_idx_array_addr(block, WHD_RING_IDX_D2H_R);
+            h2d_w_idx_ptr = whd_ring_idx_array_addr(block, WHD_RING_IDX_H2D_W);
+            h2d_r_idx_ptr = whd_ring_idx_array_addr(block, WHD_RING_IDX_H2D_R);
+            idx_offset = whd_driver->dma_index_sz;
+            if (idx_offset == sizeof(uint16_t) )
+            {
+                whd_driver->write_ptr = whd_ring_idx_write16;
+                whd_driver->read_ptr = whd_ring_idx_read16;
+            }
+            else
+            {
+                whd_driver->write_ptr = whd_ring_idx_write32;
+                whd_driver->read_ptr = whd_ring_idx_read32;
+            }
+            WPRINT_WHD_INFO( ("Using host memory indices, %u bytes each\n", (unsigned int)idx_offset) );
+        }
+        else
+        {
+            /* The device keeps using its TCM copy as long as the host addresses stay zero */
+            WPRINT_WHD_ERROR( ("Host memory indices not available (%" PRIu32 "), using TCM indices\n", result) );
+            whd_driver->dma_index_sz = 0;
+        }
+    }
+
     if (whd_driver->dma_index_sz == 0)
     {
         d2h_w_idx_ptr = dtoh32(ringinfo.d2h_w_idx_ptr);
@@ -373,10 +455,6 @@ uint32_t whd_bus_m2m_ring_init(whd_driver_t whd_driver)
         WPRINT_WHD_DEBUG( ("d2h_w_idx_ptr - 0x%lx, d2h_r_idx_ptr - 0x%lx \n", d2h_w_idx_ptr, d2h_r_idx_ptr) );
         WPRINT_WHD_DEBUG( ("h2d_w_idx_ptr - 0x%lx, h2d_r_idx_ptr - 0x%lx \n", h2d_w_idx_ptr, h2d_r_idx_ptr) );
     }
-    else
-    {
-        WPRINT_WHD_ERROR( ("Host Indices Support is NOT IMPLEMENTED!!! \n") );
-    }
 
     ring_mem_ptr = dtoh32(ringinfo.ringmem);
 
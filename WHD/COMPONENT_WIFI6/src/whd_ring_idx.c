@@ -0,0 +1,121 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  Layout of and access to the ring indices kept in host memory
+ */
+#ifdef PROTO_MSGBUF
+
+#include "cybsp.h"
+#include "whd_ring_idx.h"
+#include "whd_utils.h"
+#include "whd_debug.h"
+
+/******************************************************
+*             Function definitions
+******************************************************/
+
+uint32_t whd_ring_idx_block_size(uint8_t idx_sz, uint16_t max_submissionrings, uint16_t max_completionrings)
+{
+    if ( (idx_sz != sizeof(uint16_t) ) && (idx_sz != sizeof(uint32_t) ) )
+    {
+        return 0;
+    }
+
+    /* A write and a read index for every ring */
+    return 2 * idx_sz * ( (uint32_t)max_submissionrings + max_completionrings );
+}
+
+whd_result_t whd_ring_idx_block_init(struct whd_ring_idx_block *block, void *buf, uint8_t idx_sz,
+                                     uint16_t max_submissionrings, uint16_t max_completionrings)
+{
+    uint32_t size = whd_ring_idx_block_size(idx_sz, max_submissionrings, max_completionrings);
+
+    if ( (block == NULL) || (buf == NULL) || (size == 0) )
+    {
+        return WHD_BADARG;
+    }
+#if !defined (CY_DISABLE_XMC7000_DATA_CACHE) && defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    /* The accessors would read stale device indices from the cache */
+    if (Cy_Syslib_IsMemCacheable(MPU, (uint32_t)(uintptr_t)buf, size) )
+    {
+        WPRINT_WHD_ERROR( ("Ring index block is cacheable\n") );
+        return WHD_UNSUPPORTED;
+    }
+#endif
+
+    block->buf = (uint8_t *)buf;
+    block->size = size;
+    block->idx_sz = idx_sz;
+    block->max_submissionrings = max_submissionrings;
+    block->max_completionrings = max_completionrings;
+
+    return WHD_SUCCESS;
+}
+
+uint32_t whd_ring_idx_array_addr(const struct whd_ring_idx_block *block, whd_ring_idx_array_t array)
+{
+    uint32_t offset;
+
+    switch (array)
+    {
+        case WHD_RING_IDX_H2D_W:
+            offset = 0;
+            break;
+        case WHD_RING_IDX_H2D_R:
+            offset = block->max_submissionrings;
+            break;
+        case WHD_RING_IDX_D2H_W:
+            offset = 2 * (uint32_t)block->max_submissionrings;
+            break;
+        case WHD_RING_IDX_D2H_R:
+        default:
+            offset = 2 * (uint32_t)block->max_submissionrings + block->max_completionrings;
+            break;
+    }
+
+    return (uint32_t)(uintptr_t)(block->buf + offset * block->idx_sz);
+}
+
+uint32_t whd_ring_idx_addr(const struct whd_ring_idx_block *block, whd_ring_idx_array_t array, uint16_t ring)
+{
+    return whd_ring_idx_array_addr(block, array) + (uint32_t)ring * block->idx_sz;
+}
+
+/* The device DMAs into the block behind the compiler's back, so every access goes to memory; the
+ * block is uncached (see whd_ring_idx.h), so that memory is what the device sees */
+uint16_t whd_ring_idx_read16(whd_driver_t whd_driver, uint32_t addr)
+{
+    return *(volatile uint16_t *)(uintptr_t)addr;
+}
+
+void whd_ring_idx_write16(whd_driver_t whd_driver, uint32_t addr, uint16_t value)
+{
+    *(volatile uint16_t *)(uintptr_t)addr = value;
+}
+
+uint16_t whd_ring_idx_read32(whd_driver_t whd_driver, uint32_t addr)
+{
+    return (uint16_t)*(volatile uint32_t *)(uintptr_t)addr;
+}
+
+void whd_ring_idx_write32(whd_driver_t whd_driver, uint32_t addr, uint16_t value)
+{
+    *(volatile uint32_t *)(uintptr_t)addr = value;
+}
+
+#endif /* PROTO_MSGBUF */
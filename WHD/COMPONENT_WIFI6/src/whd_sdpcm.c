@@ -62,6 +62,10 @@
 #define MAX_WMM_AC     4
 #define AC_QUEUE_SIZE  64
 
+#if WHD_SDPCM_IFQ_MAX != WHD_INTERFACE_MAX
+#error "WHD_SDPCM_IFQ_MAX must match WHD_INTERFACE_MAX"
+#endif
+
 /******************************************************
 *             Macros
 ******************************************************/
@@ -156,6 +160,10 @@ typedef struct bcm_event
  */
 static const uint8_t prio_to_ac[9] = {1, 0, 0, 1, 2, 2, 3, 3, 4};
 
+/** Data AC queue to the WHD_TWT_TX_AC_* bit that holds it */
+static const uint8_t ac_to_twt_ac[MAX_WMM_AC] =
+{ WHD_TWT_TX_AC_BK, WHD_TWT_TX_AC_BE, WHD_TWT_TX_AC_VI, WHD_TWT_TX_AC_VO };
+
 /******************************************************
 *             SDPCM Logging
 *
@@ -214,6 +222,11 @@ static void add_sdpcm_log_entry(sdpcm_log_direction_t dir, sdpcm_log_type_t type
 static whd_buffer_t  whd_sdpcm_get_next_buffer_in_queue(whd_driver_t whd_driver, whd_buffer_t buffer);
 static void            whd_sdpcm_set_next_buffer_in_queue(whd_driver_t whd_driver, whd_buffer_t buffer,
                                                           whd_buffer_t prev_buffer);
+static uint8_t         whd_sdpcm_get_ifq_index(whd_driver_t whd_driver, whd_buffer_t buffer,
+                                               sdpcm_header_type_t header_type);
+static whd_buffer_t    whd_sdpcm_dequeue_ac(whd_driver_t whd_driver, int ac, uint8_t *ifq_index);
+static void            whd_sdpcm_report_flow(whd_driver_t whd_driver, uint8_t ifq_index, whd_bool_t stop,
+                                             uint32_t flow_gen);
 extern void whd_wifi_log_event(whd_driver_t whd_driver, const whd_event_header_t *event_header,
                                const uint8_t *event_data);
 /******************************************************
@@ -233,23 +246,22 @@ whd_result_t whd_sdpcm_init(whd_driver_t whd_driver)
 {
     whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
     int ac;
+    int i;
 
-    /* Create the sdpcm packet queue semaphore */
-    if (cy_rtos_init_semaphore(&sdpcm_info->send_queue_mutex, 1, 0) != WHD_SUCCESS)
-    {
-        return WHD_SEMAPHORE_ERROR;
-    }
-    if (cy_rtos_set_semaphore(&sdpcm_info->send_queue_mutex, WHD_FALSE) != WHD_SUCCESS)
-    {
-        WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
-        return WHD_SEMAPHORE_ERROR;
-    }
+    /* Create the sdpcm packet queue lock */
+    CHECK_RETURN(whd_lock_init(&sdpcm_info->send_queue_mutex, "sdpcm_send_queue", WHD_LOCK_SHORT) );
 
     /* Packet send queue variables */
+    whd_mem_memset(sdpcm_info->ifq, 0, sizeof(sdpcm_info->ifq) );
+    for (i = 0; i < WHD_SDPCM_IFQ_MAX; i++)
+    {
+        sdpcm_info->ifq[i].limit = AC_QUEUE_SIZE;
+        sdpcm_info->ifq[i].weight = 1;
+    }
     for (ac = 0; ac <= MAX_WMM_AC; ac++)
     {
-        sdpcm_info->send_queue_head[ac] = (whd_buffer_t)NULL;
-        sdpcm_info->send_queue_tail[ac] = (whd_buffer_t)NULL;
+        sdpcm_info->rr_ifq[ac] = 0;
+        sdpcm_info->rr_left[ac] = 0;
         sdpcm_info->npkt_in_q[ac] = 0;
     }
     sdpcm_info->totpkt_in_q = 0;
@@ -277,25 +289,38 @@ void whd_sdpcm_bus_vars_init(whd_driver_t whd_driver)
 void whd_sdpcm_quit(whd_driver_t whd_driver)
 {
     whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
+    whd_sdpcm_ifq_t *ifq;
     whd_result_t result;
     int ac;
+    int i;
 
     /* Delete the SDPCM queue mutex */
-    (void)cy_rtos_deinit_semaphore(&sdpcm_info->send_queue_mutex);    /* Ignore return - not much can be done about failure */
+    (void)whd_lock_deinit(&sdpcm_info->send_queue_mutex);    /* Ignore return - not much can be done about failure */
 
     /* Free any left over packets in the queue */
     for (ac = 0; ac <= MAX_WMM_AC; ac++)
     {
-        while (sdpcm_info->send_queue_head[ac] != NULL)
+        for (i = 0; i < WHD_SDPCM_IFQ_MAX; i++)
         {
-            whd_buffer_t buf = whd_sdpcm_get_next_buffer_in_queue(whd_driver, sdpcm_info->send_queue_head[ac]);
-            result = whd_buffer_release(whd_driver, sdpcm_info->send_queue_head[ac], WHD_NETWORK_TX);
-            if (result != WHD_SUCCESS)
-                WPRINT_WHD_ERROR( ("buffer release failed in %s at %d \n", __func__, __LINE__) );
-            sdpcm_info->send_queue_head[ac] = buf;
+            ifq = &sdpcm_info->ifq[i];
+            while (ifq->head[ac] != NULL)
+            {
+                whd_buffer_t buf = whd_sdpcm_get_next_buffer_in_queue(whd_driver, ifq->head[ac]);
+                result = whd_buffer_release(whd_driver, ifq->head[ac], WHD_NETWORK_TX);
+                if (result != WHD_SUCCESS)
+                    WPRINT_WHD_ERROR( ("buffer release failed in %s at %d \n", __func__, __LINE__) );
+                ifq->head[ac] = buf;
+            }
+            ifq->tail[ac] = NULL;
+            ifq->npkt[ac] = 0;
         }
         sdpcm_info->npkt_in_q[ac] = 0;
     }
+    for (i = 0; i < WHD_SDPCM_IFQ_MAX; i++)
+    {
+        sdpcm_info->ifq[i].stopped = WHD_FALSE;
+        sdpcm_info->ifq[i].flow_gen++;
+    }
     sdpcm_info->totpkt_in_q = 0;
 }
 
@@ -432,11 +457,16 @@ void whd_sdpcm_process_rx_packet(whd_driver_t whd_driver, whd_buffer_t buffer)
                 break;
             }
 
+            /* Only data frames are offered for sampling, so control and events do not use up the rate */
+            WHD_PKT_TRACE_STAMP(whd_driver, buffer, WHD_PKT_STAGE_RX_BUS_READ);
+
             /* Move SDPCM header and Buffer header to pass onto next layer */
             whd_buffer_add_remove_at_front(whd_driver, &buffer,
                                            (int32_t)(sizeof(whd_buffer_header_t) +
                                                      sdpcm_header.sw_header.header_length) );
 
+            WHD_PKT_TRACE_STAMP(whd_driver, buffer, WHD_PKT_STAGE_RX_DECODE);
+            WHD_PM_POLICY_RX(whd_driver);
             whd_process_bdc(whd_driver, buffer);
 
         }
@@ -444,7 +474,6 @@ void whd_sdpcm_process_rx_packet(whd_driver_t whd_driver, whd_buffer_t buffer)
 
         case ASYNCEVENT_HEADER:
         {
-
             /* Move SDPCM header and Buffer header to pass onto next layer */
             whd_buffer_add_remove_at_front(whd_driver, &buffer,
                                            (int32_t)(sizeof(whd_buffer_header_t) +
@@ -465,11 +494,30 @@ void whd_sdpcm_process_rx_packet(whd_driver_t whd_driver, whd_buffer_t buffer)
 
 whd_bool_t whd_sdpcm_has_tx_packet(whd_driver_t whd_driver)
 {
-    if (whd_driver->sdpcm_info.totpkt_in_q > 0)
+    whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
+    uint8_t held_acs;
+    int ac;
+
+    if (sdpcm_info->totpkt_in_q == 0)
+    {
+        return WHD_FALSE;
+    }
+
+    held_acs = WHD_TWT_TX_HELD_ACS(whd_driver);
+    if ( (held_acs == 0) || (sdpcm_info->npkt_in_q[MAX_WMM_AC] > 0) )
     {
         return WHD_TRUE;
     }
 
+    /* Held data does not count, the bus would otherwise poll for it until the service period */
+    for (ac = 0; ac < MAX_WMM_AC; ac++)
+    {
+        if ( (sdpcm_info->npkt_in_q[ac] > 0) && ( (held_acs & ac_to_twt_ac[ac]) == 0 ) )
+        {
+            return WHD_TRUE;
+        }
+    }
+
     return WHD_FALSE;
 }
 
@@ -478,8 +526,14 @@ whd_result_t whd_sdpcm_get_packet_to_send(whd_driver_t whd_driver, whd_buffer_t
     bus_common_header_t *packet;
     sdpcm_header_t sdpcm_header;
     whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
+    whd_sdpcm_ifq_t *ifq;
+    whd_bool_t resume = WHD_FALSE;
     whd_result_t result;
+    uint32_t flow_gen = 0;
+    uint8_t held_acs;
+    uint8_t ifq_index;
     int ac;
+    int i;
 
     if (sdpcm_info->totpkt_in_q <= 0)
     {
@@ -501,8 +555,11 @@ whd_result_t whd_sdpcm_get_packet_to_send(whd_driver_t whd_driver, whd_buffer_t
         return WHD_NO_CREDITS;
     }
 
+    /* Outside a TWT service period only control and urgent data go out; read before locking */
+    held_acs = WHD_TWT_TX_HELD_ACS(whd_driver);
+
     /* There is a packet waiting to be sent - send it then fix up queue and release packet */
-    if (cy_rtos_get_semaphore(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    if (whd_lock_acquire(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         /* Could not obtain mutex, push back the flow control semaphore */
         WPRINT_WHD_ERROR( ("Error manipulating a semaphore, %s failed at %d \n", __func__, __LINE__) );
@@ -511,30 +568,62 @@ whd_result_t whd_sdpcm_get_packet_to_send(whd_driver_t whd_driver, whd_buffer_t
 
     for (ac = MAX_WMM_AC; ac >= 0; ac--)
     {
-        if (sdpcm_info->send_queue_head[ac] != NULL)
+        if ( (sdpcm_info->npkt_in_q[ac] > 0) &&
+             ( (ac == MAX_WMM_AC) || ( (held_acs & ac_to_twt_ac[ac]) == 0 ) ) )
         {
             break;
         }
     }
     if (ac < 0)
     {
+        (void)whd_lock_release(&sdpcm_info->send_queue_mutex);
+        if (held_acs != 0)
+        {
+            WHD_TWT_TX_NOTE_HELD(whd_driver);
+            return WHD_NO_PACKET_TO_SEND;
+        }
         WPRINT_WHD_ERROR( ("NO pkt available in queue, %s failed at %d\n", __func__, __LINE__) );
         return WHD_NO_PACKET_TO_SEND;
     }
-    /* Pop the head off and set the new send_queue head */
-    *buffer = sdpcm_info->send_queue_head[ac];
-    sdpcm_info->send_queue_head[ac] = whd_sdpcm_get_next_buffer_in_queue(whd_driver, *buffer);
-    if (sdpcm_info->send_queue_head[ac] == NULL)
+    *buffer = whd_sdpcm_dequeue_ac(whd_driver, ac, &ifq_index);
+    ifq = &sdpcm_info->ifq[ifq_index];
+    if (ac != MAX_WMM_AC)
     {
-        sdpcm_info->send_queue_tail[ac] = NULL;
+        ifq->stats.sent++;
     }
-    sdpcm_info->npkt_in_q[ac]--;
-    sdpcm_info->totpkt_in_q--;
-    result = cy_rtos_set_semaphore(&sdpcm_info->send_queue_mutex, WHD_FALSE);
+
+    /* Resume the interface once every one of its sub-queues is back to half */
+    if (ifq->stopped == WHD_TRUE)
+    {
+        resume = WHD_TRUE;
+        for (i = 0; i < MAX_WMM_AC; i++)
+        {
+            if (ifq->npkt[i] > ifq->limit / 2)
+            {
+                resume = WHD_FALSE;
+                break;
+            }
+        }
+        if (resume == WHD_TRUE)
+        {
+            ifq->stopped = WHD_FALSE;
+            flow_gen = ++ifq->flow_gen;
+        }
+    }
+    result = whd_lock_release(&sdpcm_info->send_queue_mutex);
     if (result != WHD_SUCCESS)
     {
         WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
     }
+    if (resume == WHD_TRUE)
+    {
+        whd_sdpcm_report_flow(whd_driver, ifq_index, WHD_FALSE, flow_gen);
+    }
+    WHD_PKT_TRACE_STAMP(whd_driver, *buffer, WHD_PKT_STAGE_TX_DEQUEUE);
+    if ( (held_acs != 0) && (ac != MAX_WMM_AC) )
+    {
+        WHD_TWT_TX_NOTE_BYPASS(whd_driver);
+    }
 
     /* Set the sequence number */
     packet = (bus_common_header_t *)whd_buffer_get_current_piece_data_pointer(whd_driver, *buffer);
@@ -583,7 +672,11 @@ whd_result_t whd_send_to_bus(whd_driver_t whd_driver, whd_buffer_t buffer,
         (bus_common_header_t *)whd_buffer_get_current_piece_data_pointer(whd_driver, buffer);
     sdpcm_header_t sdpcm_header;
     whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
+    whd_sdpcm_ifq_t *ifq;
+    whd_bool_t stop = WHD_FALSE;
     whd_result_t result;
+    uint32_t flow_gen = 0;
+    uint8_t ifq_index;
     int ac;
 
 #ifdef CYCFG_ULP_SUPPORT_ENABLED
@@ -615,8 +708,13 @@ whd_result_t whd_send_to_bus(whd_driver_t whd_driver, whd_buffer_t buffer,
                         whd_buffer_get_current_piece_size(whd_driver, buffer),
                         (char *)data);
 
+    ifq_index = whd_sdpcm_get_ifq_index(whd_driver, buffer, header_type);
+    ifq = &sdpcm_info->ifq[ifq_index];
+
     /* Add the length of the SDPCM header and pass "down" */
-    if (cy_rtos_get_semaphore(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT, WHD_FALSE) != WHD_SUCCESS)
+    /* Stamped before locking; the queue lock may be a critical section */
+    WHD_PKT_TRACE_STAMP(whd_driver, buffer, WHD_PKT_STAGE_TX_ENQUEUE);
+    if (whd_lock_acquire(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
     {
         /* Could not obtain mutex */
         /* Fatal error */
@@ -633,47 +731,251 @@ whd_result_t whd_send_to_bus(whd_driver_t whd_driver, whd_buffer_t buffer,
     }
     ac = prio_to_ac[prio];
 
-    if ( (header_type == DATA_HEADER) && (sdpcm_info->npkt_in_q[ac] > AC_QUEUE_SIZE) )
+    if ( (header_type == DATA_HEADER) && (ifq->npkt[ac] >= ifq->limit) )
     {
-        result = whd_buffer_release(whd_driver, buffer, WHD_NETWORK_TX);
+        ifq->stats.dropped++;
+        result = whd_lock_release(&sdpcm_info->send_queue_mutex);
         if (result != WHD_SUCCESS)
         {
-            WPRINT_WHD_ERROR( ("buffer release failed in %s at %d \n", __func__, __LINE__) );
+            WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
         }
-        result = cy_rtos_set_semaphore(&sdpcm_info->send_queue_mutex, WHD_FALSE);
+        /* Released outside the lock, it calls back into the network stack */
+        WHD_PKT_TRACE_CANCEL(whd_driver, buffer);
+        result = whd_buffer_release(whd_driver, buffer, WHD_NETWORK_TX);
         if (result != WHD_SUCCESS)
         {
-            WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+            WPRINT_WHD_ERROR( ("buffer release failed in %s at %d \n", __func__, __LINE__) );
         }
         whd_thread_notify(whd_driver);
         return WHD_BUFFER_ALLOC_FAIL;
     }
 
     whd_sdpcm_set_next_buffer_in_queue(whd_driver, NULL, buffer);
-    if (sdpcm_info->send_queue_tail[ac] != NULL)
+    if (ifq->tail[ac] != NULL)
     {
-        whd_sdpcm_set_next_buffer_in_queue(whd_driver, buffer, sdpcm_info->send_queue_tail[ac]);
+        whd_sdpcm_set_next_buffer_in_queue(whd_driver, buffer, ifq->tail[ac]);
     }
-    sdpcm_info->send_queue_tail[ac] = buffer;
-    if (sdpcm_info->send_queue_head[ac] == NULL)
+    ifq->tail[ac] = buffer;
+    if (ifq->head[ac] == NULL)
     {
-        sdpcm_info->send_queue_head[ac] = buffer;
+        ifq->head[ac] = buffer;
     }
+    ifq->npkt[ac]++;
     sdpcm_info->npkt_in_q[ac]++;
     sdpcm_info->totpkt_in_q++;
-    result = cy_rtos_set_semaphore(&sdpcm_info->send_queue_mutex, WHD_FALSE);
+    if (header_type == DATA_HEADER)
+    {
+        ifq->stats.queued++;
+        if (ifq->npkt[ac] > ifq->stats.high_water)
+        {
+            ifq->stats.high_water = ifq->npkt[ac];
+        }
+        /* Stop the interface before its next packet would be dropped */
+        if ( (ifq->npkt[ac] >= ifq->limit) && (ifq->stopped == WHD_FALSE) )
+        {
+            ifq->stopped = WHD_TRUE;
+            flow_gen = ++ifq->flow_gen;
+            ifq->stats.flow_stops++;
+            stop = WHD_TRUE;
+        }
+        WHD_PM_POLICY_TX(whd_driver, sdpcm_info->totpkt_in_q);
+    }
+    result = whd_lock_release(&sdpcm_info->send_queue_mutex);
     if (result != WHD_SUCCESS)
         WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
 
+    if (stop == WHD_TRUE)
+    {
+        whd_sdpcm_report_flow(whd_driver, ifq_index, WHD_TRUE, flow_gen);
+    }
     whd_thread_notify(whd_driver);
 
     return WHD_SUCCESS;
 }
 
+whd_result_t whd_sdpcm_set_ifq_params(whd_interface_t ifp, uint8_t weight, uint16_t limit)
+{
+    whd_sdpcm_info_t *sdpcm_info;
+    whd_sdpcm_ifq_t *ifq;
+
+    CHECK_IFP_NULL(ifp);
+    if (ifp->bsscfgidx >= WHD_SDPCM_IFQ_MAX)
+    {
+        return WHD_UNKNOWN_INTERFACE;
+    }
+    sdpcm_info = &ifp->whd_driver->sdpcm_info;
+    ifq = &sdpcm_info->ifq[ifp->bsscfgidx];
+
+    if (whd_lock_acquire(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
+    {
+        return WHD_SEMAPHORE_ERROR;
+    }
+    ifq->weight = (weight == 0) ? 1 : weight;
+    ifq->limit = (limit == 0) ? AC_QUEUE_SIZE : limit;
+    return whd_lock_release(&sdpcm_info->send_queue_mutex);
+}
+
+whd_result_t whd_sdpcm_get_ifq_stats(whd_interface_t ifp, whd_sdpcm_ifq_stats_t *stats)
+{
+    whd_sdpcm_info_t *sdpcm_info;
+    whd_sdpcm_ifq_t *ifq;
+    int ac;
+
+    CHECK_IFP_NULL(ifp);
+    if (stats == NULL)
+    {
+        return WHD_BADARG;
+    }
+    if (ifp->bsscfgidx >= WHD_SDPCM_IFQ_MAX)
+    {
+        return WHD_UNKNOWN_INTERFACE;
+    }
+    sdpcm_info = &ifp->whd_driver->sdpcm_info;
+    ifq = &sdpcm_info->ifq[ifp->bsscfgidx];
+
+    if (whd_lock_acquire(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
+    {
+        return WHD_SEMAPHORE_ERROR;
+    }
+    *stats = ifq->stats;
+    stats->depth = 0;
+    for (ac = 0; ac < MAX_WMM_AC; ac++)
+    {
+        stats->depth = (uint16_t)(stats->depth + ifq->npkt[ac]);
+    }
+    return whd_lock_release(&sdpcm_info->send_queue_mutex);
+}
+
+whd_result_t whd_sdpcm_print_ifq_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
+{
+    whd_sdpcm_info_t *sdpcm_info;
+    whd_sdpcm_ifq_stats_t stats;
+    int i;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    sdpcm_info = &whd_driver->sdpcm_info;
+
+    for (i = 0; i < WHD_SDPCM_IFQ_MAX; i++)
+    {
+        if (whd_driver->iflist[i] == NULL)
+        {
+            continue;
+        }
+        /* Printed from a snapshot so the lock is not held across console output */
+        CHECK_RETURN(whd_sdpcm_get_ifq_stats(whd_driver->iflist[i], &stats) );
+        WPRINT_MACRO( ("TX queue %s.. weight:%u, limit:%u, depth:%u, high_water:%u\n"
+                       "queued:%" PRIu32 ", sent:%" PRIu32 ", dropped:%" PRIu32 ", flow_stops:%" PRIu32 "\n",
+                       whd_driver->iflist[i]->if_name, sdpcm_info->ifq[i].weight, sdpcm_info->ifq[i].limit,
+                       stats.depth, stats.high_water, stats.queued, stats.sent, stats.dropped,
+                       stats.flow_stops) );
+
+        if (reset_after_print == WHD_TRUE)
+        {
+            (void)whd_lock_acquire(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT);
+            whd_mem_memset(&sdpcm_info->ifq[i].stats, 0, sizeof(sdpcm_info->ifq[i].stats) );
+            (void)whd_lock_release(&sdpcm_info->send_queue_mutex);
+        }
+    }
+    return WHD_SUCCESS;
+}
+
 /******************************************************
 *             Static Functions
 ******************************************************/
 
+/* Data frames carry the interface in the BDC header written by whd_cdc_tx_queue_data() */
+static uint8_t whd_sdpcm_get_ifq_index(whd_driver_t whd_driver, whd_buffer_t buffer,
+                                       sdpcm_header_type_t header_type)
+{
+    data_header_t *packet;
+    uint8_t index;
+
+    if (header_type != DATA_HEADER)
+    {
+        return 0;
+    }
+    packet = (data_header_t *)whd_buffer_get_current_piece_data_pointer(whd_driver, buffer);
+    index = (uint8_t)(packet->bdc_header.flags2 & BDC_FLAG2_IF_MASK);
+    return (index < WHD_SDPCM_IFQ_MAX) ? index : 0;
+}
+
+/* Tells the network stack to stop or resume an interface, outside send_queue_mutex. A sender and the
+ * WHD thread can change stopped one after the other and then call out in the opposite order, so
+ * the call is repeated with the latest state until flow_gen shows no change since the last one. */
+static void whd_sdpcm_report_flow(whd_driver_t whd_driver, uint8_t ifq_index, whd_bool_t stop, uint32_t flow_gen)
+{
+    whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
+    whd_sdpcm_ifq_t *ifq = &sdpcm_info->ifq[ifq_index];
+    whd_bool_t done = WHD_FALSE;
+
+    while (done == WHD_FALSE)
+    {
+        whd_network_tx_flow_control(whd_driver, ifq_index, stop);
+        if (whd_lock_acquire(&sdpcm_info->send_queue_mutex, CY_RTOS_NEVER_TIMEOUT) != WHD_SUCCESS)
+        {
+            WPRINT_WHD_ERROR( ("Error manipulating a semaphore, %s failed at %d \n", __func__, __LINE__) );
+            return;
+        }
+        if (ifq->flow_gen == flow_gen)
+        {
+            done = WHD_TRUE;
+        }
+        else
+        {
+            flow_gen = ifq->flow_gen;
+            stop = ifq->stopped;
+        }
+        if (whd_lock_release(&sdpcm_info->send_queue_mutex) != WHD_SUCCESS)
+        {
+            WPRINT_WHD_ERROR( ("Error setting semaphore in %s at %d \n", __func__, __LINE__) );
+        }
+    }
+}
+
+/** Pops the next packet of an AC, serving its interface sub-queues round-robin
+ *
+ *  The interface whose turn it is keeps it for weight packets or until its sub-queue empties.
+ *  Must be called with send_queue_mutex held and a packet queued in the AC.
+ */
+static whd_buffer_t whd_sdpcm_dequeue_ac(whd_driver_t whd_driver, int ac, uint8_t *ifq_index)
+{
+    whd_sdpcm_info_t *sdpcm_info = &whd_driver->sdpcm_info;
+    whd_sdpcm_ifq_t *ifq;
+    whd_buffer_t buffer;
+    uint8_t index = sdpcm_info->rr_ifq[ac];
+    int i;
+
+    if ( (sdpcm_info->rr_left[ac] == 0) || (sdpcm_info->ifq[index].head[ac] == NULL) )
+    {
+        for (i = 0; i < WHD_SDPCM_IFQ_MAX; i++)
+        {
+            index = (uint8_t)( (index + 1) % WHD_SDPCM_IFQ_MAX );
+            if (sdpcm_info->ifq[index].head[ac] != NULL)
+            {
+                break;
+            }
+        }
+        sdpcm_info->rr_ifq[ac] = index;
+        sdpcm_info->rr_left[ac] = sdpcm_info->ifq[index].weight;
+    }
+    sdpcm_info->rr_left[ac]--;
+
+    /* Pop the head off and set the new send_queue head */
+    ifq = &sdpcm_info->ifq[index];
+    buffer = ifq->head[ac];
+    ifq->head[ac] = whd_sdpcm_get_next_buffer_in_queue(whd_driver, buffer);
+    if (ifq->head[ac] == NULL)
+    {
+        ifq->tail[ac] = NULL;
+    }
+    ifq->npkt[ac]--;
+    sdpcm_info->npkt_in_q[ac]--;
+    sdpcm_info->totpkt_in_q--;
+
+    *ifq_index = index;
+    return buffer;
+}
+
 static whd_buffer_t whd_sdpcm_get_next_buffer_in_queue(whd_driver_t whd_driver, whd_buffer_t buffer)
 {
     whd_buffer_header_t *packet = (whd_buffer_header_t *)whd_buffer_get_current_piece_data_pointer(whd_driver, buffer);
@@ -41,6 +41,7 @@
 #include "whd_int.h"
 #include "whd_chip.h"
 #include "whd_poll.h"
+#include "whd_network_if.h"
 #ifndef PROTO_MSGBUF
 #include "whd_sdpcm.h"
 #else
@@ -154,12 +155,15 @@ int8_t whd_thread_send_one_packet(whd_driver_t whd_driver)
         return 0;
     }
 
+    /* The bus has released the buffer, the handle is only used as the trace key */
+    WHD_PKT_TRACE_STAMP(whd_driver, tmp_buf_hnd, WHD_PKT_STAGE_TX_DONE);
     WHD_STATS_INCREMENT_VARIABLE(whd_driver, tx_total);
 
     return (int8_t)1;
 #else
     uint16_t local_id = 0;
     uint16_t prio_ring = 0;
+    uint8_t held_acs;
 
     /* Prefer to IOCTL Data than Tx Data */
     if (whd_driver->msgbuf->ioctl_queue)
@@ -169,9 +173,12 @@ int8_t whd_thread_send_one_packet(whd_driver_t whd_driver)
         DELAYED_BUS_RELEASE_SCHEDULE(whd_driver, WHD_TRUE);
     }
 
+    /* Outside a TWT service period only the urgent flowrings are served */
+    held_acs = WHD_TWT_TX_HELD_ACS(whd_driver);
     for (local_id = 0; local_id < whd_driver->msgbuf->current_flowring_count; local_id++)
     {
-        result = whd_get_high_priority_flowring(whd_driver, whd_driver->msgbuf->current_flowring_count, &prio_ring);
+        result = whd_get_high_priority_flowring(whd_driver, whd_driver->msgbuf->current_flowring_count, held_acs,
+                                                &prio_ring);
 
         if (result == WHD_SUCCESS)
         {
@@ -246,6 +253,7 @@ int8_t whd_thread_poll_all(whd_driver_t whd_driver)
     int8_t result = 0;
     result |= whd_thread_send_one_packet(whd_driver);
     result |= whd_thread_receive_one_packet(whd_driver);
+    whd_network_rx_round_end(whd_driver);
     return result;
 }
 
@@ -359,6 +367,7 @@ static void whd_thread_func(cy_thread_arg_t thread_input)
                     rx_status = whd_thread_receive_one_packet(whd_driver);
                     rx_cnt++;
                 } while (rx_status != 0 && rx_cnt < WHD_THREAD_RX_BOUND);
+                whd_network_rx_round_end(whd_driver);
                 bus_fail = 0;
             }
             else
@@ -0,0 +1,525 @@
+/*
+ * Copyright 2025, Cypress Semiconductor Corporation (an Infineon company)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  TWT service period aligned TX
+ *
+ *  The schedule is kept in microseconds relative to the last TSF snapshot: sp_phase_us is the
+ *  offset of an SP start from the snapshot, reduced modulo the wake interval. Interval values
+ *  such as 8192 * 1024 us are not whole milliseconds, so nothing is rounded to the host clock
+ *  until the timer is armed.
+ *
+ *  The schedule is written by the event handler on the WHD thread and by the application
+ *  through the sync, and read by the WHD thread and the SP timer; a WHD_LOCK_SHORT lock guards
+ *  it. The held and bypassed counters are only bumped on the WHD thread.
+ */
+
+#ifdef WHD_TWT_TX_HOLD
+
+#include "cyabs_rtos.h"
+#include "whd_twt_tx.h"
+#include "whd_int.h"
+#include "whd_events_int.h"
+#include "whd_endian.h"
+#include "whd_utils.h"
+#include "whd_debug.h"
+#include "whd_lock.h"
+#include "whd_thread.h"
+#include "whd_types_int.h"
+#include "whd_wlioctl.h"
+
+/******************************************************
+*             Structures
+******************************************************/
+
+struct whd_twt_tx
+{
+    whd_lock_t lock;                /* Guards the schedule and stats */
+    whd_interface_t ifp;
+    whd_bool_t enabled;
+    whd_twt_tx_config_t config;
+    cy_timer_t sp_timer;            /* Fires when an SP window opens */
+    whd_bool_t tsf_valid;
+    uint64_t tsf_us;                /* Last TSF snapshot */
+    cy_time_t tsf_host_ms;          /* Host time of the snapshot */
+    uint64_t wake_time_us;          /* First wake time of the agreement in TSF, 0 if not given */
+    uint64_t sp_phase_us;           /* An SP start, relative to the snapshot, below the interval */
+    whd_twt_tx_stats_t stats;
+};
+
+/******************************************************
+*             Static Variables
+******************************************************/
+
+static const whd_event_num_t whd_twt_tx_events[] = { WLC_E_TWT_SETUP, WLC_E_TWT_TEARDOWN, WLC_E_NONE };
+
+/******************************************************
+*             Schedule
+******************************************************/
+
+/* Works out whether traffic can be held to the agreement; called with the lock held */
+static void whd_twt_tx_align(struct whd_twt_tx *twt)
+{
+    uint64_t interval_us = twt->stats.wake_interval_us;
+    uint64_t offset_us;
+
+    twt->stats.holding = WHD_FALSE;
+    if ( (twt->stats.active != WHD_TRUE) || (twt->tsf_valid != WHD_TRUE) || (twt->wake_time_us == 0) ||
+         (interval_us < 1000) )
+    {
+        return;
+    }
+    if ( (twt->config.max_interval_ms != 0) && (interval_us > (uint64_t)twt->config.max_interval_ms * 1000) )
+    {
+        return;
+    }
+    /* An SP that covers the whole interval leaves nothing to hold */
+    if ( (uint64_t)twt->stats.wake_duration_us + (uint64_t)twt->config.early_ms * 1000 >= interval_us )
+    {
+        return;
+    }
+
+    if (twt->wake_time_us >= twt->tsf_us)
+    {
+        offset_us = (twt->wake_time_us - twt->tsf_us) % interval_us;
+    }
+    else
+    {
+        offset_us = (interval_us - ( (twt->tsf_us - twt->wake_time_us) % interval_us ) ) % interval_us;
+    }
+    twt->sp_phase_us = offset_us;
+    twt->stats.holding = WHD_TRUE;
+}
+
+/* Returns WHD_TRUE inside an SP window and the time until the next window opens; called with
+ * the lock held on an aligned schedule */
+static whd_bool_t whd_twt_tx_in_window(const struct whd_twt_tx *twt, cy_time_t now, uint32_t *next_open_ms)
+{
+    uint64_t interval_us = twt->stats.wake_interval_us;
+    uint64_t early_us = (uint64_t)twt->config.early_ms * 1000;
+    uint64_t elapsed_us = (uint64_t)(uint32_t)(now - twt->tsf_host_ms) * 1000;
+    uint64_t since_start_us = (elapsed_us + interval_us - twt->sp_phase_us) % interval_us;
+    uint64_t to_open_us;
+
+    if (since_start_us + early_us >= interval_us)
+    {
+        /* In the early part of the next window */
+        to_open_us = interval_us - since_start_us + interval_us - early_us;
+    }
+    else
+    {
+        to_open_us = interval_us - since_start_us - early_us;
+    }
+    if (next_open_ms != NULL)
+    {
+        /* Rounded up so the timer does not fire just before the window */
+        *next_open_ms = (uint32_t)( (to_open_us + 999) / 1000 );
+    }
+
+    return ( (since_start_us + early_us >= interval_us) ||
+             (since_start_us < twt->stats.wake_duration_us) ) ? WHD_TRUE : WHD_FALSE;
+}
+
+/* Arms the SP timer for the next window, or stops it; called without the lock */
+static void whd_twt_tx_rearm(struct whd_twt_tx *twt)
+{
+    uint32_t next_open_ms = 0;
+    whd_bool_t holding;
+    cy_time_t now;
+
+    (void)cy_rtos_get_time(&now);
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    holding = ( (twt->enabled == WHD_TRUE) && (twt->stats.holding == WHD_TRUE) ) ? WHD_TRUE : WHD_FALSE;
+    if (holding == WHD_TRUE)
+    {
+        (void)whd_twt_tx_in_window(twt, now, &next_open_ms);
+    }
+    (void)whd_lock_release(&twt->lock);
+
+    if (holding == WHD_TRUE)
+    {
+        (void)cy_rtos_timer_start(&twt->sp_timer, (next_open_ms > 0) ? next_open_ms : 1);
+    }
+    else
+    {
+        (void)cy_rtos_timer_stop(&twt->sp_timer);
+    }
+}
+
+/* Runs in the timer context when an SP window opens; the WHD thread sends the held burst */
+static void whd_twt_tx_sp_start(cy_timer_callback_arg_t arg)
+{
+    whd_driver_t whd_driver = (whd_driver_t)arg;
+    struct whd_twt_tx *twt = whd_driver->twt_tx;
+
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    twt->stats.service_periods++;
+    (void)whd_lock_release(&twt->lock);
+
+    whd_thread_notify(whd_driver);
+    whd_twt_tx_rearm(twt);
+}
+
+static whd_result_t whd_twt_tx_read_tsf(struct whd_twt_tx *twt)
+{
+    uint32_t tsf[2];
+    cy_time_t before, after;
+
+    (void)cy_rtos_get_time(&before);
+    CHECK_RETURN(whd_wifi_get_iovar_buffer(twt->ifp, IOVAR_STR_TSF, (uint8_t *)tsf, sizeof(tsf) ) );
+    (void)cy_rtos_get_time(&after);
+
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    twt->tsf_us = ( (uint64_t)dtoh32(tsf[1]) << 32 ) | dtoh32(tsf[0]);
+    /* The firmware read the TSF somewhere within the round trip */
+    twt->tsf_host_ms = before + (cy_time_t)( (after - before) / 2 );
+    twt->tsf_valid = WHD_TRUE;
+    twt->stats.tsf_syncs++;
+    whd_twt_tx_align(twt);
+    (void)whd_lock_release(&twt->lock);
+
+    return WHD_SUCCESS;
+}
+
+/******************************************************
+*             Events
+******************************************************/
+
+/* Runs on the WHD thread; no iovars, the schedule is aligned to the last snapshot */
+static void *whd_twt_tx_event_handler(whd_interface_t ifp, const whd_event_header_t *event_header,
+                                      const uint8_t *event_data, void *handler_user_data)
+{
+    whd_driver_t whd_driver = ifp->whd_driver;
+    struct whd_twt_tx *twt = whd_driver->twt_tx;
+    const wl_twt_setup_event_t *setup;
+    const wl_twt_teardown_event_t *teardown;
+
+    if ( (twt == NULL) || (twt->enabled != WHD_TRUE) || (event_data == NULL) ||
+         (event_header->status != WLC_E_STATUS_SUCCESS) )
+    {
+        return handler_user_data;
+    }
+
+    if (event_header->event_type == WLC_E_TWT_SETUP)
+    {
+        setup = (const wl_twt_setup_event_t *)event_data;
+        if ( (event_header->datalen < sizeof(wl_twt_setup_event_t) ) ||
+             (dtoh16(setup->version) != WL_TWT_SETUP_EVENT_VER) || (setup->status != 0) ||
+             (setup->desc.setup_cmd != TWT_SETUP_CMD_ACCEPT_TWT) )
+        {
+            WPRINT_WHD_DEBUG( ("TWT hold: setup not accepted\n") );
+            return handler_user_data;
+        }
+
+        (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+        twt->stats.active = WHD_TRUE;
+        twt->stats.flow_id = setup->desc.flow_id;
+        twt->stats.wake_interval_us = dtoh32(setup->desc.wake_int);
+        twt->stats.wake_duration_us = dtoh32(setup->desc.wake_dur);
+        twt->wake_time_us = ( (uint64_t)dtoh32(setup->desc.wake_time_h) << 32 ) | dtoh32(setup->desc.wake_time_l);
+        twt->stats.setups++;
+        whd_twt_tx_align(twt);
+        if (twt->stats.holding != WHD_TRUE)
+        {
+            twt->stats.not_aligned++;
+        }
+        (void)whd_lock_release(&twt->lock);
+    }
+    else if (event_header->event_type == WLC_E_TWT_TEARDOWN)
+    {
+        teardown = (const wl_twt_teardown_event_t *)event_data;
+        if ( (event_header->datalen < sizeof(wl_twt_teardown_event_t) ) ||
+             (dtoh16(teardown->version) != WL_TWT_TEARDOWN_EVENT_VER) )
+        {
+            return handler_user_data;
+        }
+
+        (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+        if ( (teardown->teardesc.alltwt != 0) || (teardown->teardesc.flow_id == twt->stats.flow_id) )
+        {
+            twt->stats.active = WHD_FALSE;
+            twt->stats.holding = WHD_FALSE;
+            twt->stats.teardowns++;
+        }
+        (void)whd_lock_release(&twt->lock);
+    }
+
+    whd_twt_tx_rearm(twt);
+    /* Anything held goes out now if the hold was lifted */
+    whd_thread_notify(whd_driver);
+
+    return handler_user_data;
+}
+
+/******************************************************
+*             Driver side
+******************************************************/
+
+whd_result_t whd_twt_tx_hold_enable(whd_interface_t ifp, const whd_twt_tx_config_t *config)
+{
+    struct whd_twt_tx *twt;
+    whd_driver_t whd_driver;
+    uint16_t event_entry = WHD_EVENT_NOT_REGISTERED;
+
+    CHECK_IFP_NULL(ifp);
+    whd_driver = ifp->whd_driver;
+    CHECK_DRIVER_NULL(whd_driver);
+
+    twt = whd_driver->twt_tx;
+    if (twt == NULL)
+    {
+        twt = (struct whd_twt_tx *)whd_mem_calloc(1, sizeof(struct whd_twt_tx) );
+        if (twt == NULL)
+        {
+            WPRINT_WHD_ERROR( ("Memory allocation failed for whd_twt_tx in %s\n", __FUNCTION__) );
+            return WHD_MALLOC_FAILURE;
+        }
+        if (whd_lock_init(&twt->lock, "twt_tx", WHD_LOCK_SHORT) != WHD_SUCCESS)
+        {
+            whd_mem_free(twt);
+            return WHD_SEMAPHORE_ERROR;
+        }
+        if (cy_rtos_timer_init(&twt->sp_timer, CY_TIMER_TYPE_ONCE, whd_twt_tx_sp_start,
+                               (cy_timer_callback_arg_t)whd_driver) != CY_RSLT_SUCCESS)
+        {
+            (void)whd_lock_deinit(&twt->lock);
+            whd_mem_free(twt);
+            return WHD_TIMEOUT;
+        }
+        /* Published once and kept until whd_deinit(); the dequeue hooks only test this pointer */
+        whd_driver->twt_tx = twt;
+    }
+    else if (twt->enabled == WHD_TRUE)
+    {
+        return WHD_PENDING;
+    }
+
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    if (config != NULL)
+    {
+        twt->config = *config;
+    }
+    else
+    {
+        whd_mem_memset(&twt->config, 0, sizeof(twt->config) );
+    }
+    if (twt->config.urgent_ac_mask == 0)
+    {
+        twt->config.urgent_ac_mask = WHD_TWT_TX_DEFAULT_URGENT_ACS;
+    }
+    if (twt->config.early_ms == 0)
+    {
+        twt->config.early_ms = WHD_TWT_TX_DEFAULT_EARLY_MS;
+    }
+    twt->ifp = ifp;
+    twt->stats.active = WHD_FALSE;
+    twt->stats.holding = WHD_FALSE;
+    twt->tsf_valid = WHD_FALSE;
+    (void)whd_lock_release(&twt->lock);
+
+    if (ifp->event_reg_list[WHD_TWT_EVENT_ENTRY] != WHD_EVENT_NOT_REGISTERED)
+    {
+        (void)whd_wifi_deregister_event_handler(ifp, ifp->event_reg_list[WHD_TWT_EVENT_ENTRY]);
+        ifp->event_reg_list[WHD_TWT_EVENT_ENTRY] = WHD_EVENT_NOT_REGISTERED;
+    }
+    CHECK_RETURN(whd_management_set_event_handler(ifp, whd_twt_tx_events, whd_twt_tx_event_handler, NULL,
+                                                  &event_entry) );
+    if (event_entry >= WHD_MAX_EVENT_SUBSCRIPTION)
+    {
+        WPRINT_WHD_ERROR( ("TWT events registration failed in function %s and line %d\n", __func__, __LINE__) );
+        return WHD_UNFINISHED;
+    }
+    ifp->event_reg_list[WHD_TWT_EVENT_ENTRY] = (uint8_t)event_entry;
+    twt->enabled = WHD_TRUE;
+
+    /* Not associated yet is fine, the setup request takes another snapshot */
+    if (whd_twt_tx_read_tsf(twt) != WHD_SUCCESS)
+    {
+        WPRINT_WHD_DEBUG( ("TWT hold: no TSF yet\n") );
+    }
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_twt_tx_hold_disable(whd_driver_t whd_driver)
+{
+    struct whd_twt_tx *twt;
+    whd_interface_t ifp;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    twt = whd_driver->twt_tx;
+    if (twt == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    twt->enabled = WHD_FALSE;
+    twt->stats.holding = WHD_FALSE;
+    ifp = twt->ifp;
+    (void)whd_lock_release(&twt->lock);
+
+    (void)cy_rtos_timer_stop(&twt->sp_timer);
+    if ( (ifp != NULL) && (ifp->event_reg_list[WHD_TWT_EVENT_ENTRY] != WHD_EVENT_NOT_REGISTERED) )
+    {
+        (void)whd_wifi_deregister_event_handler(ifp, ifp->event_reg_list[WHD_TWT_EVENT_ENTRY]);
+        ifp->event_reg_list[WHD_TWT_EVENT_ENTRY] = WHD_EVENT_NOT_REGISTERED;
+    }
+    whd_thread_notify(whd_driver);
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_twt_tx_hold_sync(whd_interface_t ifp)
+{
+    struct whd_twt_tx *twt;
+
+    CHECK_IFP_NULL(ifp);
+    CHECK_DRIVER_NULL(ifp->whd_driver);
+    twt = ifp->whd_driver->twt_tx;
+    if ( (twt == NULL) || (twt->enabled != WHD_TRUE) || (twt->ifp != ifp) )
+    {
+        return WHD_BADARG;
+    }
+
+    CHECK_RETURN(whd_twt_tx_read_tsf(twt) );
+    whd_twt_tx_rearm(twt);
+
+    return WHD_SUCCESS;
+}
+
+void whd_twt_tx_hold_reset(whd_driver_t whd_driver)
+{
+    struct whd_twt_tx *twt = whd_driver->twt_tx;
+
+    if (twt == NULL)
+    {
+        return;
+    }
+
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    twt->stats.active = WHD_FALSE;
+    twt->stats.holding = WHD_FALSE;
+    twt->tsf_valid = WHD_FALSE;
+    (void)whd_lock_release(&twt->lock);
+
+    (void)cy_rtos_timer_stop(&twt->sp_timer);
+    whd_thread_notify(whd_driver);
+}
+
+uint8_t whd_twt_tx_held_acs(whd_driver_t whd_driver)
+{
+    struct whd_twt_tx *twt = whd_driver->twt_tx;
+    uint8_t held = 0;
+    cy_time_t now;
+
+    (void)cy_rtos_get_time(&now);
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    if ( (twt->enabled == WHD_TRUE) && (twt->stats.holding == WHD_TRUE) &&
+         (whd_twt_tx_in_window(twt, now, NULL) != WHD_TRUE) )
+    {
+        held = (uint8_t)(WHD_TWT_TX_AC_ALL & ~twt->config.urgent_ac_mask);
+    }
+    (void)whd_lock_release(&twt->lock);
+
+    return held;
+}
+
+void whd_twt_tx_note_held(whd_driver_t whd_driver)
+{
+    whd_driver->twt_tx->stats.held++;
+}
+
+void whd_twt_tx_note_bypass(whd_driver_t whd_driver)
+{
+    whd_driver->twt_tx->stats.bypassed++;
+}
+
+whd_result_t whd_twt_tx_get_stats(whd_driver_t whd_driver, whd_twt_tx_stats_t *stats)
+{
+    struct whd_twt_tx *twt;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    twt = whd_driver->twt_tx;
+    if ( (twt == NULL) || (stats == NULL) )
+    {
+        return WHD_BADARG;
+    }
+
+    (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+    whd_mem_memcpy(stats, &twt->stats, sizeof(*stats) );
+    (void)whd_lock_release(&twt->lock);
+
+    return WHD_SUCCESS;
+}
+
+whd_result_t whd_twt_tx_print_stats(whd_driver_t whd_driver, whd_bool_t reset_after_print)
+{
+    struct whd_twt_tx *twt;
+    whd_twt_tx_stats_t stats;
+
+    CHECK_DRIVER_NULL(whd_driver);
+    twt = whd_driver->twt_tx;
+    if (twt == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    /* Printed from a snapshot so the lock is not held across console output */
+    CHECK_RETURN(whd_twt_tx_get_stats(whd_driver, &stats) );
+
+    WPRINT_MACRO( ("TWT TX hold.. %s, agreement:%s, flow:%u, interval:%" PRIu32 " us, duration:%" PRIu32 " us\n"
+                   "setups:%" PRIu32 ", teardowns:%" PRIu32 ", not_aligned:%" PRIu32 ", tsf_syncs:%" PRIu32
+                   ", service_periods:%" PRIu32 ", held:%" PRIu32 ", bypassed:%" PRIu32 "\n",
+                   (twt->enabled == WHD_TRUE) ? "enabled" : "disabled",
+                   (stats.holding == WHD_TRUE) ? "holding" : (stats.active == WHD_TRUE) ? "not aligned" : "none",
+                   stats.flow_id, stats.wake_interval_us, stats.wake_duration_us, stats.setups, stats.teardowns,
+                   stats.not_aligned, stats.tsf_syncs, stats.service_periods, stats.held, stats.bypassed) );
+
+    if (reset_after_print == WHD_TRUE)
+    {
+        (void)whd_lock_acquire(&twt->lock, CY_RTOS_NEVER_TIMEOUT);
+        twt->stats.setups = 0;
+        twt->stats.teardowns = 0;
+        twt->stats.not_aligned = 0;
+        twt->stats.tsf_syncs = 0;
+        twt->stats.service_periods = 0;
+        twt->stats.held = 0;
+        twt->stats.bypassed = 0;
+        (void)whd_lock_release(&twt->lock);
+    }
+
+    return WHD_SUCCESS;
+}
+
+void whd_twt_tx_deinit(whd_driver_t whd_driver)
+{
+    struct whd_twt_tx *twt = whd_driver->twt_tx;
+
+    if (twt == NULL)
+    {
+        return;
+    }
+    /* The interfaces are gone by now, their event registrations went with the driver's table */
+    (void)cy_rtos_timer_stop(&twt->sp_timer);
+    whd_driver->twt_tx = NULL;
+    (void)cy_rtos_timer_deinit(&twt->sp_timer);
+    (void)whd_lock_deinit(&twt->lock);
+    whd_mem_free(twt);
+}
+
+#endif /* WHD_TWT_TX_HOLD */
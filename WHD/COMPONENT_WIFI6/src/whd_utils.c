@@ -27,6 +27,7 @@
 #include "whd_endian.h"
 #include "whd_int.h"
 #include "whd_wlioctl.h"
+#include "whd_mem_arena.h"
 
 #define UNSIGNED_CHAR_TO_CHAR(uch) ( (uch)& 0x7f )
 
@@ -38,59 +39,116 @@
 #define WPA_OUI_TYPE1                     "\x00\x50\xF2\x01"   /** WPA OUI */
 
 #ifdef PROTO_MSGBUF
+/* Pool memory is permanent and cannot be given back, so pools released by whd_deinit() stay on
+ * this list and are handed to the next driver that needs one of at least their size. The list and
+ * the owner fields are shared by every driver, so they are only read and changed with the
+ * scheduler suspended; pool memory is allocated and opened outside that section. */
 typedef struct dma_pool
 {
+    struct dma_pool *next;
+    whd_driver_t owner;     /* NULL while the pool is free for another driver */
     int offset;
     int poolsize;
+    int high_water;     /* Largest offset reached since init */
     uint8_t big_buffer[0];
 }dma_pool;
 
-dma_pool *pool_mem;
+static dma_pool *dma_pool_list;
 
-uint32_t whd_dmapool_init(uint32_t memory_size)
+uint32_t whd_dmapool_init(whd_driver_t whd_driver, uint32_t memory_size)
 {
-    /* If pool is created already, no need to re-create it again */
-    if(pool_mem == NULL)
-        pool_mem = (dma_pool*)whd_hw_allocatePermanentApi(memory_size);
-    else
+    dma_pool *pool;
+
+    /* If the driver has a pool already, no need to re-create it again */
+    if (whd_driver->dma_pool != NULL)
         return 0;
 
-    if (pool_mem == NULL)
-      return -1;
+    cy_rtos_scheduler_suspend();
+    for (pool = dma_pool_list; pool != NULL; pool = pool->next)
+    {
+        if ((pool->owner == NULL) && (pool->poolsize >= (int)(memory_size - sizeof(dma_pool))))
+            break;
+    }
+    if (pool != NULL)
+        pool->owner = whd_driver;
+    cy_rtos_scheduler_resume();
+
+    if (pool == NULL)
+    {
+        pool = (dma_pool*)whd_hw_allocatePermanentApi(memory_size);
+        if (pool == NULL)
+          return -1;
 
-    WPRINT_WHD_DEBUG(("WHD allocated %lu bytes for DMA pool\n", memory_size));
+        WPRINT_WHD_DEBUG(("WHD allocated %lu bytes for DMA pool\n", memory_size));
 
-    pool_mem->offset = 0;
-    pool_mem->poolsize = memory_size - (sizeof(dma_pool));
+        pool->poolsize = memory_size - (sizeof(dma_pool));
 
 #ifndef COMPONENT_SDIO_HM
-    if (!whd_hw_openDeviceAccessApi(WHD_HW_DEVICE_WLAN, pool_mem->big_buffer, pool_mem->poolsize, 0 ))
-       return -1;
+        if (!whd_hw_openDeviceAccessApi(WHD_HW_DEVICE_WLAN, pool->big_buffer, pool->poolsize, 0 ))
+           return -1;
 #else
-    if (!whd_hw_openDeviceAccessApi(WHD_HW_DEVICE_SDIO_AND_WLAN, pool_mem->big_buffer, pool_mem->poolsize, 0 ))
-       return -1;
+        if (!whd_hw_openDeviceAccessApi(WHD_HW_DEVICE_SDIO_AND_WLAN, pool->big_buffer, pool->poolsize, 0 ))
+           return -1;
 #endif /* COMPONENT_SDIO_HM */
 
+        pool->owner = whd_driver;
+        cy_rtos_scheduler_suspend();
+        pool->next = dma_pool_list;
+        dma_pool_list = pool;
+        cy_rtos_scheduler_resume();
+    }
+
+    pool->offset = 0;
+    pool->high_water = 0;
+    whd_driver->dma_pool = pool;
+
     return 0;
 }
 
-void* whd_dmapool_alloc( int size)
+void* whd_dmapool_alloc(whd_driver_t whd_driver, int size)
 {
+    dma_pool *pool = whd_driver->dma_pool;
     uint8_t* allocbuf;
 
-    if ((pool_mem->offset + size) >= pool_mem->poolsize)
+    if ((pool == NULL) || ((pool->offset + size) >= pool->poolsize))
      return NULL;
 
-    allocbuf = pool_mem->big_buffer + pool_mem->offset;
-    pool_mem->offset += size;
+    allocbuf = pool->big_buffer + pool->offset;
+    pool->offset += size;
+    if (pool->offset > pool->high_water)
+        pool->high_water = pool->offset;
 
     return allocbuf;
 }
 
-void whd_dmapool_reset( void )
+whd_result_t whd_dmapool_get_usage(whd_driver_t whd_driver, uint32_t *used, uint32_t *high_water, uint32_t *pool_size)
 {
-    /* Reset the pool offset to point to start address of pool, as free is not available */
-    pool_mem->offset = 0;
+    dma_pool *pool = whd_driver->dma_pool;
+
+    if (pool == NULL)
+        return WHD_UNFINISHED;
+
+    *used = (uint32_t)pool->offset;
+    *high_water = (uint32_t)pool->high_water;
+    *pool_size = (uint32_t)pool->poolsize;
+
+    return WHD_SUCCESS;
+}
+
+void whd_dmapool_reset(whd_driver_t whd_driver)
+{
+    dma_pool *pool = whd_driver->dma_pool;
+
+    if (pool == NULL)
+        return;
+
+    /* Reset the pool offset to point to start address of pool, as free is not available, and
+     * leave the pool for the next driver */
+    pool->offset = 0;
+    cy_rtos_scheduler_suspend();
+    pool->owner = NULL;
+    cy_rtos_scheduler_resume();
+    whd_driver->dma_pool = NULL;
     return;
 }
 #endif
@@ -340,6 +398,8 @@ const char *whd_event_to_string(whd_event_num_t value)
         CASE_RETURN(WLC_E_TX_STAT_ERROR)
         CASE_RETURN(WLC_E_BCMC_CREDIT_SUPPORT)
         CASE_RETURN(WLC_E_PSTA_PRIMARY_INTF_IND)
+        CASE_RETURN(WLC_E_TWT_SETUP)
+        CASE_RETURN(WLC_E_TWT_TEARDOWN)
 #if defined(COMPONENT_WLANSENSE)
         CASE_RETURN(WLC_E_CSI_ENABLE)
         CASE_RETURN(WLC_E_CSI_DATA)
@@ -1263,17 +1323,40 @@ inline void whd_mem_memset (void *buf, int val, size_t len)
 
 inline void *whd_mem_malloc (size_t size)
 {
+#ifdef WHD_MEM_ARENA
+    return whd_mem_arena_alloc(size);
+#else
     return malloc(size);
+#endif
 }
 
 inline void *whd_mem_calloc(size_t nitems, size_t size)
 {
+#ifdef WHD_MEM_ARENA
+    void *ptr;
+
+    if ( (size != 0) && (nitems > SIZE_MAX / size) )
+    {
+        return NULL;
+    }
+    ptr = whd_mem_arena_alloc(nitems * size);
+    if (ptr != NULL)
+    {
+        whd_mem_memset(ptr, 0, nitems * size);
+    }
+    return ptr;
+#else
     return calloc(nitems, size);
+#endif
 }
 
 inline void whd_mem_free(void *ptr)
 {
+#ifdef WHD_MEM_ARENA
+    whd_mem_arena_free(ptr);
+#else
     free(ptr);
+#endif
 }
 
 #endif /* ifndef WHD_USE_CUSTOM_MALLOC_IMPL */
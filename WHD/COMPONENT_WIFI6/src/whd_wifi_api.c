@@ -142,6 +142,14 @@ typedef struct
 
 #pragma pack()
 
+typedef struct
+{
+    whd_driver_t whd_driver;
+    whd_scan_compact_result_callback_t callback;
+    void *user_data;
+    whd_scan_result_t scratch;  /* Each BSS is parsed here, then reported compactly */
+} whd_scan_compact_userdata_t;
+
 /******************************************************
 *             Static Variables
 ******************************************************/
@@ -2422,6 +2430,11 @@ whd_result_t whd_wifi_leave(whd_interface_t ifp)
         ifp->event_reg_list[WHD_JOIN_EVENT_ENTRY] = WHD_EVENT_NOT_REGISTERED;
     }
 
+#ifdef WHD_TWT_TX_HOLD
+    /* The firmware drops its TWT agreements with the association, without a teardown event */
+    whd_twt_tx_hold_reset(whd_driver);
+#endif /* WHD_TWT_TX_HOLD */
+
     /* Disassociate from AP */
     result = whd_wifi_set_ioctl_buffer(ifp, WLC_DISASSOC, NULL, 0);
 
@@ -3270,6 +3283,7 @@ whd_result_t whd_wifi_scan(whd_interface_t ifp,
 
     whd_driver->internal_info.scan_result_callback = callback;
     whd_driver->internal_info.whd_scan_result_ptr = result_ptr;
+    whd_driver->internal_info.scan_user_data = user_data;
 
     /* Send the Incremental Scan IOVAR message - blocks until the response is received */
 
@@ -3278,6 +3292,137 @@ whd_result_t whd_wifi_scan(whd_interface_t ifp,
     return WHD_SUCCESS;
 }
 
+static void whd_scan_compact_handler(whd_scan_result_t **result_ptr, void *user_data, whd_scan_status_t status)
+{
+    whd_scan_compact_userdata_t *scan_userdata = (whd_scan_compact_userdata_t *)user_data;
+    uint32_t record_buffer[(WHD_SCAN_COMPACT_RESULT_MAX_LEN + 3) / 4];
+    whd_scan_compact_result_t *record = (whd_scan_compact_result_t *)record_buffer;
+    whd_scan_result_t *current_result;
+    uint8_t *bitmap;
+    uint8_t opclass;
+    uint32_t i;
+
+    /* finished scan, either successfully or through an abort */
+    if (status != WHD_SCAN_INCOMPLETE)
+    {
+        scan_userdata->callback(NULL, NULL, 0, scan_userdata->user_data, status);
+        /* The scratch result goes away with the user data */
+        scan_userdata->whd_driver->internal_info.whd_scan_result_ptr = NULL;
+        whd_mem_free(scan_userdata);
+        return;
+    }
+
+    current_result = *result_ptr;
+    whd_mem_memset(record, 0, WHD_SCAN_COMPACT_RESULT_MAX_LEN);
+
+    whd_mem_memcpy(record->BSSID.octet, current_result->BSSID.octet, sizeof(record->BSSID.octet) );
+    record->signal_strength = current_result->signal_strength;
+    record->max_data_rate = current_result->max_data_rate;
+    record->security = current_result->security;
+    record->bss_type = (uint8_t)current_result->bss_type;
+    record->channel = current_result->channel;
+    record->band = (uint8_t)current_result->band;
+    record->ccode[0] = current_result->ccode[0];
+    record->ccode[1] = current_result->ccode[1];
+    record->flags = current_result->flags;
+    record->current_operating_class = current_result->current_operating_class;
+
+    record->ssid_length = (uint8_t)MIN_OF(current_result->SSID.length, SSID_NAME_SIZE);
+    whd_mem_memcpy(record->data, current_result->SSID.value, record->ssid_length);
+
+    /* num_supported_operating_classes is the IE length, which also counts the current operating class.
+     * The list itself ends at the first delimiter (0 or 130). */
+    bitmap = &record->data[record->ssid_length];
+    for (i = 0; i + 1 < current_result->num_supported_operating_classes; i++)
+    {
+        opclass = current_result->supported_operating_classes[i];
+        if ( (opclass == 0) || (opclass == 130) )
+        {
+            break;
+        }
+        bitmap[opclass / 8] |= (uint8_t)(1 << (opclass % 8) );
+        if (record->opclass_bitmap_len < (opclass / 8) + 1)
+        {
+            record->opclass_bitmap_len = (uint8_t)( (opclass / 8) + 1 );
+        }
+    }
+    record->record_length = (uint16_t)(offsetof(whd_scan_compact_result_t, data) + record->ssid_length +
+                                       record->opclass_bitmap_len);
+
+    scan_userdata->callback(record, current_result->ie_ptr, current_result->ie_len, scan_userdata->user_data,
+                            WHD_SCAN_INCOMPLETE);
+}
+
+whd_result_t whd_wifi_scan_compact(whd_interface_t ifp,
+                                   whd_scan_type_t scan_type,
+                                   whd_bss_type_t bss_type,
+                                   const whd_ssid_t *optional_ssid,
+                                   const whd_mac_t *optional_mac,
+                                   const uint16_t *optional_channel_list,
+                                   const whd_scan_extended_params_t *optional_extended_params,
+                                   whd_scan_compact_result_callback_t callback,
+                                   void *user_data)
+{
+    whd_scan_compact_userdata_t *scan_userdata;
+    whd_driver_t whd_driver;
+    whd_result_t result;
+
+    CHECK_IFP_NULL(ifp);
+    whd_driver = ifp->whd_driver;
+    CHECK_DRIVER_NULL(whd_driver)
+
+    if (callback == NULL)
+    {
+        return WHD_BADARG;
+    }
+
+    /* The running scan owns its user data until its final callback */
+    if (whd_driver->internal_info.scan_result_callback == whd_scan_compact_handler)
+    {
+        return WHD_PENDING;
+    }
+
+    scan_userdata = (whd_scan_compact_userdata_t *)whd_mem_malloc(sizeof(whd_scan_compact_userdata_t) );
+    if (scan_userdata == NULL)
+    {
+        return WHD_MALLOC_FAILURE;
+    }
+    whd_mem_memset(scan_userdata, 0, sizeof(whd_scan_compact_userdata_t) );
+    scan_userdata->whd_driver = whd_driver;
+    scan_userdata->callback = callback;
+    scan_userdata->user_data = user_data;
+
+    result = whd_wifi_scan(ifp, scan_type, bss_type, optional_ssid, optional_mac, optional_channel_list,
+                           optional_extended_params, whd_scan_compact_handler, &scan_userdata->scratch,
+                           scan_userdata);
+    if (result != WHD_SUCCESS)
+    {
+        /* whd_wifi_scan() may have installed the handler before failing */
+        if (whd_driver->internal_info.scan_result_callback == whd_scan_compact_handler)
+        {
+            whd_driver->internal_info.scan_result_callback = NULL;
+            whd_driver->internal_info.whd_scan_result_ptr = NULL;
+            whd_driver->internal_info.scan_user_data = NULL;
+        }
+        whd_mem_free(scan_userdata);
+    }
+
+    return result;
+}
+
+whd_bool_t whd_scan_compact_result_has_opclass(const whd_scan_compact_result_t *result, uint8_t operating_class)
+{
+    const uint8_t *bitmap;
+
+    if ( (result == NULL) || ( (operating_class / 8) >= result->opclass_bitmap_len ) )
+    {
+        return WHD_FALSE;
+    }
+
+    bitmap = &result->data[result->ssid_length];
+    return ( (bitmap[operating_class / 8] & (1 << (operating_class % 8) ) ) != 0 ) ? WHD_TRUE : WHD_FALSE;
+}
+
 whd_result_t whd_wifi_stop_scan(whd_interface_t ifp)
 {
     whd_buffer_t buffer;
@@ -4347,6 +4492,10 @@ whd_result_t whd_wifi_itwt_setup(whd_interface_t ifp, whd_itwt_setup_params_t *t
         itwt_setup.desc.wake_time_h = twt_params->wake_time_h;
         itwt_setup.desc.wake_time_l = twt_params->wake_time_l;
     }
+#ifdef WHD_TWT_TX_HOLD
+    /* Fresh TSF reference for the schedule the setup event will carry; fails if the hold is off */
+    (void)whd_twt_tx_hold_sync(ifp);
+#endif /* WHD_TWT_TX_HOLD */
     twt_iovar = (whd_xtlv_t *)whd_proto_get_iovar_buffer(whd_driver, &buffer, sizeof(wl_twt_setup_t) + 4,
                                                          IOVAR_STR_TWT);
     CHECK_IOCTL_BUFFER (twt_iovar);
@@ -4385,6 +4534,10 @@ whd_result_t whd_wifi_btwt_join(whd_interface_t ifp, whd_btwt_join_params_t *twt
     btwt_setup.desc.wake_dur = twt_params->wake_duration * 256;
     btwt_setup.desc.wake_int = twt_params->mantissa * (1 << twt_params->exponent);
     btwt_setup.desc.bid = twt_params->bid;
+#ifdef WHD_TWT_TX_HOLD
+    /* Fresh TSF reference for the schedule the setup event will carry; fails if the hold is off */
+    (void)whd_twt_tx_hold_sync(ifp);
+#endif /* WHD_TWT_TX_HOLD */
 
     twt_iovar = (whd_xtlv_t *)whd_proto_get_iovar_buffer(whd_driver, &buffer, sizeof(wl_twt_setup_t) + 4,
                                                          IOVAR_STR_TWT);
@@ -5707,6 +5860,13 @@ whd_wifi_clear_packet_filter_stats(whd_interface_t ifp, uint32_t filter_id)
     RETURN_WITH_ASSERT(whd_wifi_set_iovar_value(ifp, IOVAR_STR_PKT_FILTER_CLEAR_STATS, (uint32_t)filter_id) );
 }
 
+whd_result_t
+whd_pf_set_packet_filter_mode(whd_interface_t ifp, whd_packet_filter_mode_t mode)
+{
+    CHECK_IFP_NULL(ifp);
+    RETURN_WITH_ASSERT(whd_wifi_set_iovar_value(ifp, IOVAR_STR_PKT_FILTER_MODE, (uint32_t)mode) );
+}
+
 whd_result_t
 whd_pf_get_packet_filter_mask_and_pattern(whd_interface_t ifp, uint8_t filter_id, uint32_t max_size, uint8_t *mask,
                                           uint8_t *pattern, uint32_t *size_out)
@@ -5989,16 +6149,21 @@ whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *wh
         return result;
     }
     tko = (wl_tko_t *)whd_buffer_get_current_piece_data_pointer(whd_driver, response);
+    if (tko == NULL)
+    {
+        CHECK_RETURN(whd_buffer_release(whd_driver, response, WHD_NETWORK_TX) );
+        return WHD_BUFFER_ALLOC_FAIL;
+    }
     tko->subcmd_id = dtoh16(tko->subcmd_id);
     tko->len = dtoh16(tko->len);
 
     if (tko->subcmd_id  != WL_TKO_SUBCMD_CONNECT)
     {
         WPRINT_WHD_ERROR( ("%s: IOVAR returned garbage!\n", __func__) );
-        return WHD_BADARG;
+        result = WHD_BADARG;
     }
     connect = (wl_tko_connect_t *)tko->data;
-    if (tko->len >= sizeof(*connect) )
+    if ( (result == WHD_SUCCESS) && (tko->len >= sizeof(*connect) ) )
     {
         connect->local_port = dtoh16(connect->local_port);
         connect->remote_port = dtoh16(connect->remote_port);
@@ -6007,9 +6172,9 @@ whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *wh
         if (connect->ip_addr_type != 0)
         {
             WPRINT_WHD_ERROR( ("%s: Address type not IPV4\n", __func__) );
-            return WHD_BADARG;
+            result = WHD_BADARG;
         }
-        if (connect->ip_addr_type == 0)
+        else
         {
             /* IPv4 */
             uint16_t mylen;
@@ -6017,18 +6182,85 @@ whd_tko_get_FW_connect(whd_interface_t ifp, uint8_t index, whd_tko_connect_t *wh
             if (buflen < mylen)
             {
                 WPRINT_WHD_ERROR( ("%s: Buf len (%d) too small , need %d\n", __func__, buflen, mylen) );
-                return WHD_BADARG;
+                result = WHD_BADARG;
+            }
+            else
+            {
+                /*
+                 * Assumes whd_tko_connect_t and wl_tko_connect_t are the same.
+                 * If/when they become different (due to different FW versions, etc) than
+                 * this may have to be copied field by field instead.
+                 */
+                whd_mem_memcpy(whd_connect, connect, MIN_OF(mylen, buflen) );
             }
-
-            /*
-             * Assumes whd_tko_connect_t and wl_tko_connect_t are the same.
-             * If/when they become different (due to different FW versions, etc) than
-             * this may have to be copied field by field instead.
-             */
-            whd_mem_memcpy(whd_connect, connect, MIN_OF(mylen, buflen) );
         }
     }
-    return WHD_SUCCESS;
+    CHECK_RETURN(whd_buffer_release(whd_driver, response, WHD_NETWORK_TX) );
+    return result;
+}
+
+/* Exercise SET of wl_tko_connect_t IOVAR */
+/* Program one TCP connection into the index given in whd_connect */
+whd_result_t
+whd_tko_set_FW_connect(whd_interface_t ifp, const whd_tko_connect_t *whd_connect, uint16_t buflen)
+{
+    uint32_t len = 0;
+    uint16_t connect_len;
+    uint8_t *data = NULL;
+    wl_tko_t *tko = NULL;
+    wl_tko_connect_t *connect = NULL;
+    whd_buffer_t buffer;
+    whd_driver_t whd_driver;
+    whd_result_t result;
+    CHECK_IFP_NULL(ifp);
+
+    whd_driver = ifp->whd_driver;
+    CHECK_DRIVER_NULL(whd_driver);
+
+    if (whd_connect == NULL)
+    {
+        return WHD_BADARG;
+    }
+    connect_len = (uint16_t)(offsetof(wl_tko_connect_t, data) +
+                             (whd_connect->ip_addr_type == 0 ? 2 * IPV4_ADDR_LEN : 2 * IPV6_ADDR_LEN) +
+                             whd_connect->request_len + whd_connect->response_len);
+    if ( (buflen < connect_len) ||
+         (TKO_DATA_OFFSET + connect_len > WHD_PAYLOAD_MTU - strlen(IOVAR_STR_TKO) - 1) )
+    {
+        WPRINT_WHD_ERROR( ("%s: Bad connect length %d, buffer %d\n", __func__, connect_len, buflen) );
+        return WHD_BADARG;
+    }
+
+    len = (uint32_t)(TKO_DATA_OFFSET + connect_len);
+    data = (uint8_t * )whd_proto_get_iovar_buffer(whd_driver, &buffer, (uint16_t)len, IOVAR_STR_TKO);
+    CHECK_IOCTL_BUFFER(data);
+
+    tko = (wl_tko_t *)data;
+
+    tko->subcmd_id = WL_TKO_SUBCMD_CONNECT;
+    tko->len = TKO_DATA_OFFSET;
+
+    connect = (wl_tko_connect_t *)tko->data;
+    whd_mem_memcpy(connect, whd_connect, connect_len);
+    connect->local_port = htod16(connect->local_port);
+    connect->remote_port = htod16(connect->remote_port);
+    connect->local_seq = htod32(connect->local_seq);
+    connect->remote_seq = htod32(connect->remote_seq);
+    connect->request_len = htod16(connect->request_len);
+    connect->response_len = htod16(connect->response_len);
+
+    tko->len += connect_len;
+
+    tko->subcmd_id = htod16(tko->subcmd_id);
+    tko->len = htod16(tko->len);
+
+    /* invoke SET iovar */
+    result = whd_proto_set_iovar(ifp, buffer, NULL);
+    if (result != WHD_SUCCESS)
+    {
+        WPRINT_WHD_ERROR( ("%s: tko connect %d FAILED\n", __func__, whd_connect->index) );
+    }
+    return result;
 }
 
 whd_result_t
@@ -6076,6 +6308,49 @@ whd_tko_toggle(whd_interface_t ifp, whd_bool_t enable)
     return result;
 }
 
+whd_result_t
+whd_toe_set(whd_interface_t ifp, uint32_t ol_flags)
+{
+    whd_result_t result;
+    CHECK_IFP_NULL(ifp);
+
+    if (ol_flags != 0)
+    {
+        result = whd_wifi_set_iovar_value(ifp, IOVAR_STR_TOE_OL, ol_flags);
+        if (result != WHD_SUCCESS)
+        {
+            WPRINT_WHD_INFO( ("%s: toe_ol 0x%" PRIx32 " not supported\n", __func__, ol_flags) );
+            return result;
+        }
+    }
+    result = whd_wifi_set_iovar_value(ifp, IOVAR_STR_TOE, (ol_flags != 0) ? 1 : 0);
+    if (result != WHD_SUCCESS)
+    {
+        WPRINT_WHD_INFO( ("%s: toe %s FAILED\n", __func__, (ol_flags != 0) ? "enable" : "disable") );
+    }
+    return result;
+}
+
+whd_result_t
+whd_toe_get(whd_interface_t ifp, uint32_t *ol_flags)
+{
+    uint32_t enabled = 0;
+    whd_result_t result;
+    CHECK_IFP_NULL(ifp);
+
+    if (ol_flags == NULL)
+    {
+        return WHD_BADARG;
+    }
+    *ol_flags = 0;
+    result = whd_wifi_get_iovar_value(ifp, IOVAR_STR_TOE, &enabled);
+    if ( (result != WHD_SUCCESS) || (enabled == 0) )
+    {
+        return result;
+    }
+    return whd_wifi_get_iovar_value(ifp, IOVAR_STR_TOE_OL, ol_flags);
+}
+
 static whd_result_t
 whd_tko_autoenab(whd_interface_t ifp, whd_bool_t enable)
 {